@@ -335,7 +335,10 @@ struct CM_DEVICE_CREATE_BUFFER_ALIAS_PARAM
 #endif
 
 #if MDF_PROFILER_ENABLED
-#define INSERT_PROFILER_RECORD()     CmTimer Time(__FUNCTION__ )
+// The function name is interned once per call site
+#define INSERT_PROFILER_RECORD()                                                        \
+    static const uint32_t cmProfilerFunctionId = CmTimer::GetFunctionId(__FUNCTION__);  \
+    CmTimer Time(__FUNCTION__, cmProfilerFunctionId)
 #else
 #define INSERT_PROFILER_RECORD()
 #endif
@@ -22,21 +22,104 @@
 #include "cm_perf_statistics.h"
 #include "cm_mem.h"
 #include "cm_sdk_provider.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 
 #if MDF_PROFILER_ENABLED
 
-CmPerfStatistics::CmPerfStatistics()
+// Cleared when the profiler is destroyed, so that threads exiting later do
+// not touch the freed profiles
+static std::atomic<bool> gCmPerfStatisticsAlive(false);
+
+//!
+//! \brief    Hands the profile back to the profiler when its thread exits
+//!
+struct CmThreadProfileSlot
 {
+    ApiThreadProfile *profile = nullptr;
 
-    m_apiCallRecordCount  = 0;
-    m_apiCallFile         = nullptr;
+    ~CmThreadProfileSlot()
+    {
+        if (profile && gCmPerfStatisticsAlive.load(std::memory_order_acquire))
+        {
+            profile->inUse.store(false, std::memory_order_release);
+        }
+    }
+};
+
+static thread_local CmThreadProfileSlot tCmThreadProfile;
+
+//! Index of the log-linear bucket of a duration: values below 2^SUB_BITS get
+//! their own bucket, larger ones are split in 2^SUB_BITS buckets per power of two
+static inline uint32_t GetHistogramBucket(uint64_t ticks)
+{
+    if (ticks < (1ULL << CM_PROFILER_HISTOGRAM_SUB_BITS))
+    {
+        return (uint32_t)ticks;
+    }
+
+    uint32_t msb = 0;
+    for (uint32_t shift = 32; shift > 0; shift >>= 1)
+    {
+        if (ticks >> (msb + shift))
+        {
+            msb += shift;
+        }
+    }
+
+    uint32_t sub = (uint32_t)(ticks >> (msb - CM_PROFILER_HISTOGRAM_SUB_BITS)) & ((1 << CM_PROFILER_HISTOGRAM_SUB_BITS) - 1);
+    return ((msb - CM_PROFILER_HISTOGRAM_SUB_BITS + 1) << CM_PROFILER_HISTOGRAM_SUB_BITS) | sub;
+}
+
+//! Middle of the range of durations covered by a bucket
+static inline double GetHistogramBucketValue(uint32_t bucket)
+{
+    if (bucket < (1 << CM_PROFILER_HISTOGRAM_SUB_BITS))
+    {
+        return bucket;
+    }
+
+    uint32_t msb   = (bucket >> CM_PROFILER_HISTOGRAM_SUB_BITS) + CM_PROFILER_HISTOGRAM_SUB_BITS - 1;
+    uint32_t sub   = bucket & ((1 << CM_PROFILER_HISTOGRAM_SUB_BITS) - 1);
+    double   width = (double)(1ULL << (msb - CM_PROFILER_HISTOGRAM_SUB_BITS));
+    return ((1 << CM_PROFILER_HISTOGRAM_SUB_BITS) + sub) * width + width / 2;
+}
+
+//! Duration below which the given fraction of the calls fall
+static uint64_t GetHistogramPercentile(const ApiLatencyHistogram &histogram, double fraction)
+{
+    uint64_t target = (uint64_t)(fraction * (histogram.callTimes - 1)) + 1;
+    uint64_t count  = 0;
+
+    for (uint32_t i = 0; i < CM_PROFILER_HISTOGRAM_BUCKETS; i++)
+    {
+        count += histogram.buckets[i];
+        if (count >= target)
+        {
+            return std::min((uint64_t)GetHistogramBucketValue(i), histogram.maxTicks);
+        }
+    }
+
+    return histogram.maxTicks;
+}
+
+CmPerfStatistics::CmPerfStatistics()
+{
+    m_functionCount = 0;
+    for (uint32_t i = 0; i < CM_PROFILER_MAX_FUNCTIONS; i++)
+    {
+        m_functionNames[i] = nullptr;
+    }
+    m_functionNames[CM_PROFILER_MAX_FUNCTIONS - 1] = "Others";
 
-    m_perfStatisticFile   = nullptr;
-    m_perfStatisticCount = 0;
-    
     m_profilerOn      = false;
+    m_traceOn         = false;
     m_profilerLevel    = CM_RT_PERF_LOG_LEVEL_DEFAULT;
 
+    QueryPerformanceFrequency(&m_frequency);
+    QueryPerformanceCounter(&m_baseTime);
 
     GetProfilerLevel(); // get profiler level from env variable "CM_RT_PERF_LOG"
 
@@ -45,142 +128,327 @@ CmPerfStatistics::CmPerfStatistics()
         EventRegisterMDF_PROVIDER();
     }
 
+    gCmPerfStatisticsAlive.store(true, std::memory_order_release);
 }
 
 CmPerfStatistics::~CmPerfStatistics()
 {
-    DumpApiCallRecords();
+    gCmPerfStatisticsAlive.store(false, std::memory_order_release);
+
+    std::vector<ApiCallRecord> records;
+    MergeApiCallRecords(records);
+
+    DumpApiCallRecords(records);
+
+    DumpChromeTrace(records);
 
     DumpPerfStatisticRecords();
+
+    for (ApiThreadProfile *profile : m_threadProfiles)
+    {
+        for (uint32_t i = 0; i < CM_PROFILER_MAX_FUNCTIONS; i++)
+        {
+            CmSafeRelease(profile->histograms[i]);
+        }
+        CmSafeDeleteArray(profile->records);
+        CmSafeRelease(profile);
+    }
+    m_threadProfiles.clear();
 }
 
 void CmPerfStatistics::GetProfilerLevel()
 {   // Enabled Profiler in Debug Mode
     m_profilerLevel = CM_RT_PERF_LOG_LEVEL_RECORDS;
     m_profilerOn   = true;
+    m_traceOn      = (getenv(CM_PROFILER_TRACE_ENV) != nullptr);
     return;
 }
 
-//! Insert API Call Records Into m_apiCallRecords Array and Update Perf Statistic Array accordingly
-void CmPerfStatistics::InsertApiCallRecord(char *functionName, float time, LARGE_INTEGER start, LARGE_INTEGER end)
+uint32_t CmPerfStatistics::GetFunctionId(const char *functionName)
+{
+    CLock locker(m_criticalSectionOnFunctions);
+
+    for (uint32_t index = 0; index < m_functionCount; index++)
+    {
+        if (!strcmp(functionName, m_functionNames[index]))
+        {
+            return index;
+        }
+    }
+
+    if (m_functionCount == CM_PROFILER_MAX_FUNCTIONS - 1)
+    {
+        return CM_PROFILER_MAX_FUNCTIONS - 1;
+    }
+
+    m_functionNames[m_functionCount] = functionName;
+    return m_functionCount++;
+}
+
+ApiThreadProfile *CmPerfStatistics::GetThreadProfile()
 {
-    CLock locker(m_criticalSectionOnApiCallRecords);
+    ApiThreadProfile *profile = tCmThreadProfile.profile;
 
-    ApiCallRecord *pRecords = new ApiCallRecord ;
+    if (profile)
+    {
+        return profile;
+    }
+
+    CLock locker(m_criticalSectionOnThreadProfiles);
+
+    // Take over the profile of an exited thread, its data is kept
+    for (ApiThreadProfile *retired : m_threadProfiles)
+    {
+        bool expected = false;
+        if (retired->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        {
+            tCmThreadProfile.profile = retired;
+            return retired;
+        }
+    }
 
-    pRecords->startTime = start;
-    pRecords->endTime   = end;
-    pRecords->duration   = time;
+    profile = new (std::nothrow) ApiThreadProfile;
+    if (profile == nullptr)
+    {
+        return nullptr;
+    }
 
-    CM_STRCPY(pRecords->functionName, MSG_STRING_SIZE, functionName);
+    profile->threadIndex    = (uint32_t)m_threadProfiles.size();
+    profile->inUse.store(true, std::memory_order_relaxed);
+    profile->recordCount.store(0, std::memory_order_relaxed);
+    profile->droppedRecords = 0;
+    profile->records        = nullptr;
+    for (uint32_t i = 0; i < CM_PROFILER_MAX_FUNCTIONS; i++)
+    {
+        profile->histograms[i] = nullptr;
+    }
 
-    m_apiCallRecords.push_back(pRecords);
-    m_apiCallRecordCount++; 
+    if (m_profilerLevel >= CM_RT_PERF_LOG_LEVEL_RECORDS || m_traceOn)
+    {
+        profile->records = new (std::nothrow) ApiCallRecord[CM_PROFILER_EVENTS_PER_THREAD];
+    }
 
-    InsertPerfStatistic(pRecords);
+    m_threadProfiles.push_back(profile);
+    tCmThreadProfile.profile = profile;
 
+    return profile;
 }
 
-//Update Perf Statistic Array 
-void CmPerfStatistics::InsertPerfStatistic(ApiCallRecord *record)
+//! Insert API Call Records into the profile of the calling thread
+void CmPerfStatistics::InsertApiCallRecord(uint32_t functionId, LARGE_INTEGER start, LARGE_INTEGER end)
 {
-    uint32_t index = 0;
-    
-    for( index = 0 ; index < m_perfStatisticCount ; index ++)
+    ApiThreadProfile *profile = GetThreadProfile();
+    if (profile == nullptr || functionId >= CM_PROFILER_MAX_FUNCTIONS)
+    {
+        return;
+    }
+
+    ApiLatencyHistogram *histogram = profile->histograms[functionId];
+    if (histogram == nullptr)
     {
-        ApiPerfStatistic *pPerfStatisticRecords = m_perfStatisticRecords[index];
-        if(pPerfStatisticRecords != nullptr)
+        histogram = new (std::nothrow) ApiLatencyHistogram();
+        if (histogram == nullptr)
         {
-            if(!strcmp(record->functionName, pPerfStatisticRecords->functionName))
-            { // existing
-               pPerfStatisticRecords->callTimes ++ ;
-               pPerfStatisticRecords->time += record->duration;
+            return;
+        }
+        profile->histograms[functionId] = histogram;
+    }
 
-               //Update statistic records
-               m_perfStatisticRecords[index] = pPerfStatisticRecords;
+    uint64_t ticks = (uint64_t)(end.QuadPart - start.QuadPart);
+    histogram->callTimes++;
+    histogram->totalTicks += ticks;
+    histogram->maxTicks    = std::max(histogram->maxTicks, ticks);
+    histogram->buckets[GetHistogramBucket(ticks)]++;
 
-               break;
-            }
+    if (profile->records)
+    {
+        uint32_t count = profile->recordCount.load(std::memory_order_relaxed);
+        if (count < CM_PROFILER_EVENTS_PER_THREAD)
+        {
+            ApiCallRecord &record = profile->records[count];
+            record.functionId  = functionId;
+            record.threadIndex = profile->threadIndex;
+            record.startTime   = start;
+            record.endTime     = end;
+            profile->recordCount.store(count + 1, std::memory_order_release);
+        }
+        else
+        {
+            profile->droppedRecords++;
         }
     }
+}
 
-    if(index == m_perfStatisticCount)
-    { // record does not exist, create new entry
-        ApiPerfStatistic *pPerfStatisticRecords = new ApiPerfStatistic;
-        CM_STRCPY(pPerfStatisticRecords->functionName, MSG_STRING_SIZE, record->functionName);
-
-        pPerfStatisticRecords->callTimes = 1;
-        pPerfStatisticRecords->time       = record->duration;
+void CmPerfStatistics::MergeApiCallRecords(std::vector<ApiCallRecord> &records)
+{
+    CLock locker(m_criticalSectionOnThreadProfiles);
 
-        m_perfStatisticRecords.push_back(pPerfStatisticRecords);
-        m_perfStatisticCount ++;
+    for (ApiThreadProfile *profile : m_threadProfiles)
+    {
+        if (profile->records)
+        {
+            uint32_t count = profile->recordCount.load(std::memory_order_acquire);
+            records.insert(records.end(), profile->records, profile->records + count);
+        }
     }
 
-    return ;
+    std::stable_sort(records.begin(), records.end(),
+        [](const ApiCallRecord &a, const ApiCallRecord &b) { return a.startTime.QuadPart < b.startTime.QuadPart; });
 }
 
-//Dump APICall Records and Release m_apiCallRecords Array
-void CmPerfStatistics::DumpApiCallRecords()
+float CmPerfStatistics::TicksToMs(uint64_t ticks)
 {
-    if(!m_profilerOn)
+    return (float)((double)ticks * 1000.0 / (double)m_frequency.QuadPart);
+}
+
+//Dump APICall Records
+void CmPerfStatistics::DumpApiCallRecords(std::vector<ApiCallRecord> &records)
+{
+    FILE *apiCallFile = nullptr;
+
+    if(!m_profilerOn || m_profilerLevel < CM_RT_PERF_LOG_LEVEL_RECORDS)
     {
         return ;
     }
     
-    CM_FOPEN(m_apiCallFile, "CmPerfLog.csv", "wb");
-    if(! m_apiCallFile )
+    CM_FOPEN(apiCallFile, "CmPerfLog.csv", "wb");
+    if(! apiCallFile )
     {
         fprintf(stdout, "Fail to create file CmPerfLog.csv \n ");
         return ;
     }
-    fprintf(m_apiCallFile,  "%-40s %s \t %s \t %s \n", "FunctionName", "StartTime", "EndTime", "Duration");
+    fprintf(apiCallFile,  "%-40s %s \t %s \t %s \n", "FunctionName", "StartTime", "EndTime", "Duration");
 
-    for(uint32_t i=0 ; i< m_apiCallRecordCount ; i++)
+    for (const ApiCallRecord &record : records)
     {
-        ApiCallRecord *pRecords = m_apiCallRecords[i];
-
-        fprintf(m_apiCallFile,  "%-40s  %lld \t %lld \t %fms \n", pRecords->functionName, 
-           pRecords->startTime.QuadPart, pRecords->endTime.QuadPart, pRecords->duration);
+        fprintf(apiCallFile,  "%-40s  %lld \t %lld \t %fms \n", m_functionNames[record.functionId],
+           (long long)record.startTime.QuadPart, (long long)record.endTime.QuadPart,
+           TicksToMs(record.endTime.QuadPart - record.startTime.QuadPart));
+    }
 
-        CmSafeRelease(pRecords);
+    uint64_t dropped = 0;
+    for (ApiThreadProfile *profile : m_threadProfiles)
+    {
+        dropped += profile->droppedRecords;
+    }
+    if (dropped)
+    {
+        fprintf(apiCallFile, "# %llu records not logged, per thread limit is %d\n",
+           (unsigned long long)dropped, CM_PROFILER_EVENTS_PER_THREAD);
     }
-    
-    m_apiCallRecords.clear();
 
-    fclose(m_apiCallFile);
-    
+    fclose(apiCallFile);
 }
 
-//Dump Perf Statistic Records and Release m_perfStatisticRecords Array
+//Merge the per thread histograms and dump Perf Statistic Records
 void CmPerfStatistics::DumpPerfStatisticRecords()
 {
+    FILE *perfStatisticFile = nullptr;
+
     if(!m_profilerOn)
     {
         return ;
     }
     
-    CM_FOPEN(m_perfStatisticFile, "CmPerfStatistics.txt","wb");
-    if(!m_perfStatisticFile )
+    CM_FOPEN(perfStatisticFile, "CmPerfStatistics.txt","wb");
+    if(!perfStatisticFile )
     {
         fprintf(stdout, "Fail to create file CmPerfStatistics.txt \n ");
         return ;
     }
-    fprintf(m_perfStatisticFile,  "%-40s %s \t %s \n", "FunctionName", "Total Time(ms)", "Called Times");
+    fprintf(perfStatisticFile,  "%-40s %s \t %s \t %s \t %s \t %s \n", "FunctionName", "Total Time(ms)", "Called Times",
+        "P50(ms)", "P99(ms)", "Max(ms)");
 
-    for(uint32_t i=0 ; i< m_perfStatisticCount; i++)
+    ApiLatencyHistogram *merged = new (std::nothrow) ApiLatencyHistogram;
+    if (merged == nullptr)
     {
-        ApiPerfStatistic *pPerfStatisticRecords = m_perfStatisticRecords[i];
+        fclose(perfStatisticFile);
+        return;
+    }
 
-        fprintf(m_perfStatisticFile,  "%-40s %fms \t %d \n", pPerfStatisticRecords->functionName, 
-           pPerfStatisticRecords->time, pPerfStatisticRecords->callTimes);
+    for (uint32_t id = 0; id < CM_PROFILER_MAX_FUNCTIONS; id++)
+    {
+        *merged = ApiLatencyHistogram();
 
-        CmSafeRelease(pPerfStatisticRecords);
+        for (ApiThreadProfile *profile : m_threadProfiles)
+        {
+            const ApiLatencyHistogram *histogram = profile->histograms[id];
+            if (histogram == nullptr)
+            {
+                continue;
+            }
+            merged->callTimes  += histogram->callTimes;
+            merged->totalTicks += histogram->totalTicks;
+            merged->maxTicks    = std::max(merged->maxTicks, histogram->maxTicks);
+            for (uint32_t i = 0; i < CM_PROFILER_HISTOGRAM_BUCKETS; i++)
+            {
+                merged->buckets[i] += histogram->buckets[i];
+            }
+        }
+
+        if (merged->callTimes == 0)
+        {
+            continue;
+        }
+
+        ApiPerfStatistic statistic;
+        statistic.functionName = m_functionNames[id];
+        statistic.time         = TicksToMs(merged->totalTicks);
+        statistic.callTimes    = (uint32_t)merged->callTimes;
+        statistic.p50          = TicksToMs(GetHistogramPercentile(*merged, 0.5));
+        statistic.p99          = TicksToMs(GetHistogramPercentile(*merged, 0.99));
+        statistic.max          = TicksToMs(merged->maxTicks);
+
+        fprintf(perfStatisticFile,  "%-40s %fms \t %d \t %fms \t %fms \t %fms \n", statistic.functionName,
+           statistic.time, statistic.callTimes, statistic.p50, statistic.p99, statistic.max);
     }
-    
-    m_perfStatisticRecords.clear();
 
-    fclose(m_perfStatisticFile);
-    
+    CmSafeRelease(merged);
+
+    fclose(perfStatisticFile);
+}
+
+//Dump the API calls as complete events of the Chrome trace event format
+void CmPerfStatistics::DumpChromeTrace(std::vector<ApiCallRecord> &records)
+{
+    FILE *traceFile = nullptr;
+
+    if(!m_profilerOn || !m_traceOn)
+    {
+        return ;
+    }
+
+    CM_FOPEN(traceFile, "CmPerfTrace.json", "wb");
+    if(!traceFile )
+    {
+        fprintf(stdout, "Fail to create file CmPerfTrace.json \n ");
+        return ;
+    }
+
+    double usPerTick = 1000000.0 / (double)m_frequency.QuadPart;
+
+    const char *separator = "";
+
+    fprintf(traceFile, "{\"traceEvents\":[");
+    for (size_t i = 0; i < m_threadProfiles.size(); i++)
+    {
+        fprintf(traceFile, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"CM thread %u\"}}",
+            separator, (uint32_t)i, (uint32_t)i);
+        separator = ",";
+    }
+    for (const ApiCallRecord &record : records)
+    {
+        fprintf(traceFile, "%s\n{\"name\":\"%s\",\"cat\":\"cmrt\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            separator,
+            m_functionNames[record.functionId],
+            record.threadIndex,
+            (double)(record.startTime.QuadPart - m_baseTime.QuadPart) * usPerTick,
+            (double)(record.endTime.QuadPart - record.startTime.QuadPart) * usPerTick);
+        separator = ",";
+    }
+    fprintf(traceFile, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    fclose(traceFile);
 }
 
 bool CmPerfStatistics::IsProfilerOn()
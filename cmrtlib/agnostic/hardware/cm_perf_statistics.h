@@ -22,6 +22,7 @@
 #ifndef CMRTLIB_AGNOSTIC_HARDWARE_CM_PERF_STATISTICS_H_
 #define CMRTLIB_AGNOSTIC_HARDWARE_CM_PERF_STATISTICS_H_
 
+#include <atomic>
 #include <vector>
 #include <cstdio>
 #include "cm_def_hw.h"
@@ -33,19 +34,55 @@
 #define MSG_STRING_SIZE 256
 #define INIT_ARRAY_ZIE  256
 
+#define CM_PROFILER_MAX_FUNCTIONS           MAX_RECORD_NUM  // last id collects the functions beyond the limit
+#define CM_PROFILER_EVENTS_PER_THREAD       16384           // call records kept per thread for CmPerfLog.csv and the trace
+#define CM_PROFILER_HISTOGRAM_SUB_BITS      4               // 16 linear sub-buckets per power of two, ~6% error
+#define CM_PROFILER_HISTOGRAM_BUCKETS       ((64 - CM_PROFILER_HISTOGRAM_SUB_BITS + 1) << CM_PROFILER_HISTOGRAM_SUB_BITS)
+#define CM_PROFILER_TRACE_ENV               "CM_RT_PERF_TRACE"  // set to dump CmPerfTrace.json
+
 struct ApiPerfStatistic
 {
-    char  functionName[MSG_STRING_SIZE];       // function name
-    float time;                                 // accumulative api duration
-    uint32_t callTimes;                           // called times
+    const char *functionName;                   // function name
+    float       time;                           // accumulative api duration
+    uint32_t    callTimes;                      // called times
+    float       p50;                            // median duration
+    float       p99;                            // 99th percentile duration
+    float       max;                            // longest duration
 };
 
 struct ApiCallRecord
 {
-    char  functionName[MSG_STRING_SIZE];       // function name
-    LARGE_INTEGER  startTime;                  // start time
-    LARGE_INTEGER  endTime;                    // end time
-    float          duration;                    // duration
+    uint32_t       functionId;                  // interned function name
+    uint32_t       threadIndex;                 // index of the recording thread
+    LARGE_INTEGER  startTime;                   // start time
+    LARGE_INTEGER  endTime;                     // end time
+};
+
+//!
+//! \brief    Log-linear histogram of the durations of one function on one thread
+//!
+struct ApiLatencyHistogram
+{
+    uint64_t callTimes;
+    uint64_t totalTicks;
+    uint64_t maxTicks;
+    uint32_t buckets[CM_PROFILER_HISTOGRAM_BUCKETS];
+};
+
+//!
+//! \brief    Profiling data owned by one thread
+//! \details  Only the owning thread writes to it, so recording takes no lock.
+//!           It is kept until the profiler is destroyed and handed over to the
+//!           next new thread once its owner exits.
+//!
+struct ApiThreadProfile
+{
+    uint32_t                threadIndex;
+    std::atomic<bool>       inUse;
+    std::atomic<uint32_t>   recordCount;
+    uint64_t                droppedRecords;
+    ApiCallRecord          *records;                                    // CM_PROFILER_EVENTS_PER_THREAD entries, nullptr if not recorded
+    ApiLatencyHistogram    *histograms[CM_PROFILER_MAX_FUNCTIONS];      // allocated on the first call of each function
 };
 
 enum PerfLogLevel
@@ -62,26 +99,28 @@ public:
     ~CmPerfStatistics();
 
     //!
-    //! \brief    Insert API call record 
-    //! \details  Insert API call record which contains function name, start time, end and duration.
+    //! \brief    Get the id of a function name
+    //! \details  Called once per profiled call site, the id indexes the per thread
+    //!           histograms so that recording needs no string compare.
     //! \param    [in] functionName
-    //!           pointer to function name's string
-    //! \param    [in] time
-    //!           function's duration
+    //!           pointer to function name's string, must stay valid until the
+    //!           profiler is destroyed
+    //! \retval   id of the function
+    //!
+    uint32_t GetFunctionId(const char *functionName);
+
+    //!
+    //! \brief    Insert API call record 
+    //! \details  Insert API call record into the buffers of the calling thread.
+    //!           Lock free except for the first call of each thread.
+    //! \param    [in] functionId
+    //!           id returned by GetFunctionId
     //! \param    [in] start
     //!           function's start time
     //! \param    [in] end
     //!           function's end time
     //!
-    void InsertApiCallRecord(char *functionName, float time, LARGE_INTEGER start, LARGE_INTEGER end);
-
-    //!
-    //! \brief    Insert API call record into performace statistic record
-    //! \details  Insert API call record into performace statistic record.
-    //! \param    [in] pRecords
-    //!           pointer to API call record
-    //!
-    void InsertPerfStatistic(ApiCallRecord *records);
+    void InsertApiCallRecord(uint32_t functionId, LARGE_INTEGER start, LARGE_INTEGER end);
 
     //!
     //! \brief    Check if this profiler on or not
@@ -99,33 +138,52 @@ private:
     //!
     void GetProfilerLevel(); 
 
+    //!
+    //! \brief    Get the profile of the calling thread, creating it if needed
+    //!
+    ApiThreadProfile *GetThreadProfile();
+
+    //!
+    //! \brief    Merge the call records of all threads ordered by start time
+    //!
+    void MergeApiCallRecords(std::vector<ApiCallRecord> &records);
+
     //!
     //! \brief    Dump API call records into file
     //! \details  Dump API call records into file, 
     //!           "CmPerfLog.csv" under app's location.
     //!
-    void DumpApiCallRecords();
+    void DumpApiCallRecords(std::vector<ApiCallRecord> &records);
 
     //!
     //! \brief    Dump API call statistic records into file
     //! \details  Dump API call statistic records into file, 
-    //!           "CmPerfStatistics" under app's location.
+    //!           "CmPerfStatistics.txt" under app's location.
     //!
     void DumpPerfStatisticRecords();
 
-    CSync           m_criticalSectionOnApiCallRecords;
-    uint32_t        m_apiCallRecordCount;
-    FILE           *m_apiCallFile;
+    //!
+    //! \brief    Dump API call records as a Chrome trace
+    //! \details  Dump API call records into "CmPerfTrace.json" under app's
+    //!           location, viewable in chrome://tracing.
+    //!
+    void DumpChromeTrace(std::vector<ApiCallRecord> &records);
+
+    float TicksToMs(uint64_t ticks);
+
+    CSync           m_criticalSectionOnFunctions;
+    const char     *m_functionNames[CM_PROFILER_MAX_FUNCTIONS];
+    uint32_t        m_functionCount;
 
-    CSync           m_criticalSectionOnPerfStatisticRecords;
-    FILE           *m_perfStatisticFile;
-    uint32_t        m_perfStatisticCount;
+    CSync           m_criticalSectionOnThreadProfiles;
+    std::vector<ApiThreadProfile*>   m_threadProfiles;  // one entry per thread ever recorded
 
-    std::vector<ApiCallRecord*>      m_apiCallRecords;  // array to store api call records 
-    std::vector<ApiPerfStatistic*>   m_perfStatisticRecords; // array to store perf statistic information
+    LARGE_INTEGER   m_frequency;
+    LARGE_INTEGER   m_baseTime;
 
     PerfLogLevel m_profilerLevel; // profiler level
     bool m_profilerOn;   // profiler on or off
+    bool m_traceOn;      // dump a chrome trace
 };
 
 #endif
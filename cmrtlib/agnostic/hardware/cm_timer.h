@@ -32,30 +32,34 @@
 class CmTimer
 {
 public:
-    CmTimer(const char *functionName);
+    CmTimer(const char *functionName, uint32_t functionId);
 
     ~CmTimer();
 
+    //!
+    //! \brief    Get the profiler id of a function name
+    //! \param    [in] functionName
+    //!           pointer to a string with static storage duration
+    //! \retval   id to pass to the constructor
+    //!
+    static uint32_t GetFunctionId(const char *functionName);
+
 private:
     void Start();
 
     void Stop();
 
-    float GetTimeinMs();
-
     void InsertEventStartFlag();
 
     void InsertEventEndFlag();
 
-    uint64_t m_cycles;
-
     LARGE_INTEGER m_start;
 
     LARGE_INTEGER m_end;
 
-    LARGE_INTEGER m_freq;
-
     char *m_funcName;
+
+    uint32_t m_funcId;
 };
 
 #endif  // #if MDF_PROFILER_ENABLED
@@ -0,0 +1,396 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cm_perf_statistics.h"
+#include "cm_mem.h"
+
+#if MDF_PROFILER_ENABLED
+
+#define CM_ULT_PROFILER_THREADS         12
+#define CM_ULT_PROFILER_WAVES           2       // the second wave takes over the profiles of the first
+#define CM_ULT_PROFILER_CALLS           12000   // per thread and wave, two waves overflow the call records
+#define CM_ULT_PROFILER_FUNCTIONS       5
+#define CM_ULT_PROFILER_CALL_SPACING    100000  // ticks between the starts of two calls of a thread
+
+static const char *gCmUltFunctionNames[CM_ULT_PROFILER_FUNCTIONS] =
+{
+    "CreateKernel", "Enqueue", "CreateSurface2D", "WriteSurface", "ReadSurface"
+};
+
+//! Synthetic duration of a call, spread over a few powers of two
+static uint64_t GetCallTicks(uint32_t thread, uint32_t call)
+{
+    uint32_t function = call % CM_ULT_PROFILER_FUNCTIONS;
+    return 1000 * (function + 1) + ((call * 7919ULL + thread * 104729ULL) % 50000);
+}
+
+//! Duration below which the given fraction of the calls fall, ranked as the profiler does
+static uint64_t GetExactPercentile(const std::vector<uint64_t> &sortedTicks, double fraction)
+{
+    return sortedTicks[(size_t)(fraction * (sortedTicks.size() - 1))];
+}
+
+//! Holds the calling thread until all the threads of the run got there
+static void WaitForAllThreads(std::atomic<uint32_t> &arrived)
+{
+    arrived.fetch_add(1);
+    while (arrived.load() < CM_ULT_PROFILER_THREADS)
+    {
+        std::this_thread::yield();
+    }
+}
+
+static std::vector<std::string> ReadLines(const char *name)
+{
+    std::vector<std::string> lines;
+    FILE                     *file = fopen(name, "rb");
+    char                     line[1024];
+
+    if (file == nullptr)
+    {
+        return lines;
+    }
+    while (fgets(line, sizeof(line), file))
+    {
+        lines.push_back(line);
+    }
+    fclose(file);
+    return lines;
+}
+
+static size_t CountOccurrences(const std::vector<std::string> &lines, const char *pattern)
+{
+    size_t count = 0;
+    for (const std::string &line : lines)
+    {
+        for (size_t pos = line.find(pattern); pos != std::string::npos; pos = line.find(pattern, pos + 1))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+//!
+//! \brief    Runs each test in its own directory, the profiler dumps into the working directory
+//!
+class CmPerfStatisticsTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char directory[] = "/tmp/cmrt_ult_XXXXXX";
+
+        ASSERT_NE(getcwd(m_previousDirectory, sizeof(m_previousDirectory)), nullptr);
+        ASSERT_NE(mkdtemp(directory), nullptr);
+        m_directory = directory;
+        ASSERT_EQ(chdir(directory), 0);
+    }
+
+    void TearDown() override
+    {
+        unsetenv(CM_PROFILER_TRACE_ENV);
+        remove("CmPerfLog.csv");
+        remove("CmPerfStatistics.txt");
+        remove("CmPerfTrace.json");
+        EXPECT_EQ(chdir(m_previousDirectory), 0);
+        rmdir(m_directory.c_str());
+    }
+
+    char        m_previousDirectory[1024];
+    std::string m_directory;
+};
+
+//!
+//! \brief    Twelve threads in two waves record into one profiler
+//! \details  Checks the merged counts, totals, max and percentiles of CmPerfStatistics.txt
+//!           against the recorded durations, the records kept in CmPerfLog.csv and the
+//!           trace events, and that the second wave reused the profiles of the first.
+//!
+TEST_F(CmPerfStatisticsTest, TwelveThreadsMergeExactly)
+{
+    LARGE_INTEGER frequency;
+    ASSERT_EQ(QueryPerformanceFrequency(&frequency), 0);
+    ASSERT_EQ(setenv(CM_PROFILER_TRACE_ENV, "1", 1), 0);
+
+    {
+        CmPerfStatistics profiler;
+        uint32_t         functionIds[CM_ULT_PROFILER_FUNCTIONS];
+
+        ASSERT_TRUE(profiler.IsProfilerOn());
+        for (uint32_t f = 0; f < CM_ULT_PROFILER_FUNCTIONS; f++)
+        {
+            functionIds[f] = profiler.GetFunctionId(gCmUltFunctionNames[f]);
+        }
+        for (uint32_t f = 0; f < CM_ULT_PROFILER_FUNCTIONS; f++)
+        {
+            EXPECT_EQ(profiler.GetFunctionId(gCmUltFunctionNames[f]), functionIds[f]);
+        }
+
+        for (uint32_t wave = 0; wave < CM_ULT_PROFILER_WAVES; wave++)
+        {
+            std::vector<std::thread> threads;
+            std::atomic<uint32_t>    started(0);
+            std::atomic<uint32_t>    finished(0);
+            for (uint32_t t = 0; t < CM_ULT_PROFILER_THREADS; t++)
+            {
+                threads.emplace_back([&profiler, &functionIds, &started, &finished, wave, t]()
+                {
+                    WaitForAllThreads(started);
+                    for (uint32_t call = 0; call < CM_ULT_PROFILER_CALLS; call++)
+                    {
+                        uint32_t      index = wave * CM_ULT_PROFILER_CALLS + call;
+                        LARGE_INTEGER start, end;
+
+                        start.QuadPart = (int64_t)index * CM_ULT_PROFILER_CALL_SPACING;
+                        end.QuadPart   = start.QuadPart + GetCallTicks(t, index);
+                        profiler.InsertApiCallRecord(functionIds[call % CM_ULT_PROFILER_FUNCTIONS], start, end);
+                    }
+
+                    // Keep the profile until all threads of the wave recorded
+                    WaitForAllThreads(finished);
+                });
+            }
+            for (std::thread &thread : threads)
+            {
+                thread.join();
+            }
+        }
+    }
+
+    // Statistics
+    std::vector<std::string> statistics = ReadLines("CmPerfStatistics.txt");
+    ASSERT_EQ(statistics.size(), 1u + CM_ULT_PROFILER_FUNCTIONS);
+
+    for (uint32_t f = 0; f < CM_ULT_PROFILER_FUNCTIONS; f++)
+    {
+        std::vector<uint64_t> ticks;
+        double                totalMs = 0;
+        for (uint32_t t = 0; t < CM_ULT_PROFILER_THREADS; t++)
+        {
+            for (uint32_t index = f; index < CM_ULT_PROFILER_WAVES * CM_ULT_PROFILER_CALLS; index += CM_ULT_PROFILER_FUNCTIONS)
+            {
+                ticks.push_back(GetCallTicks(t, index));
+                totalMs += GetCallTicks(t, index) * 1000.0 / frequency.QuadPart;
+            }
+        }
+        std::sort(ticks.begin(), ticks.end());
+
+        char     name[256];
+        float    time, p50, p99, max;
+        uint32_t callTimes;
+        ASSERT_EQ(sscanf(statistics[1 + f].c_str(), "%255s %fms %u %fms %fms %fms", name, &time, &callTimes, &p50, &p99, &max), 6)
+            << statistics[1 + f];
+
+        EXPECT_STREQ(name, gCmUltFunctionNames[f]);
+        EXPECT_EQ(callTimes, ticks.size());
+        EXPECT_NEAR(time, totalMs, totalMs * 1e-4);
+        EXPECT_NEAR(max, ticks.back() * 1000.0 / frequency.QuadPart, 1e-5);
+
+        // A bucket spans 1/16 of its power of two
+        double expectedP50 = GetExactPercentile(ticks, 0.5) * 1000.0 / frequency.QuadPart;
+        double expectedP99 = GetExactPercentile(ticks, 0.99) * 1000.0 / frequency.QuadPart;
+        EXPECT_NEAR(p50, expectedP50, expectedP50 / 16 + 1e-5);
+        EXPECT_NEAR(p99, expectedP99, expectedP99 / 16 + 1e-5);
+    }
+
+    // Call records, the buffer of each profile keeps its first calls
+    uint32_t                 callsPerProfile = CM_ULT_PROFILER_WAVES * CM_ULT_PROFILER_CALLS;
+    uint64_t                 kept            = (uint64_t)CM_ULT_PROFILER_THREADS * std::min(callsPerProfile, (uint32_t)CM_PROFILER_EVENTS_PER_THREAD);
+    uint64_t                 dropped         = (uint64_t)CM_ULT_PROFILER_THREADS * CM_ULT_PROFILER_WAVES * CM_ULT_PROFILER_CALLS - kept;
+    unsigned long long       reported        = 0;
+    std::vector<std::string> log             = ReadLines("CmPerfLog.csv");
+
+    ASSERT_GE(log.size(), 2u);
+    ASSERT_EQ(sscanf(log.back().c_str(), "# %llu records not logged", &reported), 1) << log.back();
+    EXPECT_EQ(reported, dropped);
+    EXPECT_EQ(log.size(), 2 + kept);
+
+    long long previousStart = 0;
+    for (size_t i = 1; i + 1 < log.size(); i++)
+    {
+        char      name[256];
+        long long start, end;
+        ASSERT_EQ(sscanf(log[i].c_str(), "%255s %lld %lld", name, &start, &end), 3) << log[i];
+        ASSERT_GE(start, previousStart);
+        previousStart = start;
+    }
+
+    // Trace, one track per profile
+    std::vector<std::string> trace = ReadLines("CmPerfTrace.json");
+    ASSERT_FALSE(trace.empty());
+    EXPECT_EQ(trace.front().compare(0, strlen("{\"traceEvents\":["), "{\"traceEvents\":["), 0);
+    EXPECT_EQ(trace.back(), "],\"displayTimeUnit\":\"ms\"}\n");
+    EXPECT_EQ(CountOccurrences(trace, "\"ph\":\"M\""), (size_t)CM_ULT_PROFILER_THREADS);
+    EXPECT_EQ(CountOccurrences(trace, "\"ph\":\"X\""), kept);
+}
+
+//!
+//! \brief    Profiler before the per thread profiles, kept to measure the overhead against
+//! \details  One lock around a heap allocated record per call and a strcmp scan for the
+//!           statistic of the function, as CmPerfStatistics did.
+//!
+class CmUltLockedProfiler
+{
+public:
+    ~CmUltLockedProfiler()
+    {
+        for (Record *record : m_records)
+        {
+            CmSafeRelease(record);
+        }
+        for (Statistic *statistic : m_statistics)
+        {
+            CmSafeRelease(statistic);
+        }
+    }
+
+    void InsertApiCallRecord(const char *functionName, float time, LARGE_INTEGER start, LARGE_INTEGER end)
+    {
+        CLock locker(m_criticalSection);
+
+        Record *record = new Record;
+        record->startTime = start;
+        record->endTime   = end;
+        record->duration  = time;
+        strncpy(record->functionName, functionName, MSG_STRING_SIZE - 1);
+        record->functionName[MSG_STRING_SIZE - 1] = '\0';
+        m_records.push_back(record);
+
+        for (Statistic *statistic : m_statistics)
+        {
+            if (!strcmp(record->functionName, statistic->functionName))
+            {
+                statistic->callTimes++;
+                statistic->time += time;
+                return;
+            }
+        }
+
+        Statistic *statistic = new Statistic;
+        strcpy(statistic->functionName, record->functionName);
+        statistic->callTimes = 1;
+        statistic->time      = time;
+        m_statistics.push_back(statistic);
+    }
+
+private:
+    struct Record
+    {
+        char          functionName[MSG_STRING_SIZE];
+        LARGE_INTEGER startTime;
+        LARGE_INTEGER endTime;
+        float         duration;
+    };
+
+    struct Statistic
+    {
+        char     functionName[MSG_STRING_SIZE];
+        float    time;
+        uint32_t callTimes;
+    };
+
+    CSync                   m_criticalSection;
+    std::vector<Record*>    m_records;
+    std::vector<Statistic*> m_statistics;
+};
+
+//! Nanoseconds per profiled call when all threads record the same calls
+template <typename Record>
+static double MeasureCallOverhead(Record record)
+{
+    std::vector<std::thread> threads;
+    std::atomic<uint32_t>    started(0);
+    auto                     begin = std::chrono::steady_clock::now();
+
+    for (uint32_t t = 0; t < CM_ULT_PROFILER_THREADS; t++)
+    {
+        threads.emplace_back([&record, &started]()
+        {
+            WaitForAllThreads(started);
+            for (uint32_t call = 0; call < CM_ULT_PROFILER_CALLS; call++)
+            {
+                LARGE_INTEGER start, end;
+                QueryPerformanceCounter(&start);
+                QueryPerformanceCounter(&end);
+                record(call % CM_ULT_PROFILER_FUNCTIONS, start, end);
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+    return (double)elapsed.count() / CM_ULT_PROFILER_CALLS;
+}
+
+//!
+//! \brief    Overhead of a profiled call on twelve threads, locked profiler against the current one
+//! \details  Reported as properties of the test, timings are not asserted.
+//!
+TEST_F(CmPerfStatisticsTest, TwelveThreadOverhead)
+{
+    LARGE_INTEGER frequency;
+    ASSERT_EQ(QueryPerformanceFrequency(&frequency), 0);
+
+    double lockedNs = 0;
+    {
+        CmUltLockedProfiler locked;
+        lockedNs = MeasureCallOverhead([&locked, &frequency](uint32_t function, LARGE_INTEGER start, LARGE_INTEGER end)
+        {
+            float time = (float)((end.QuadPart - start.QuadPart) * 1000.0 / frequency.QuadPart);
+            locked.InsertApiCallRecord(gCmUltFunctionNames[function], time, start, end);
+        });
+    }
+
+    double perThreadNs = 0;
+    {
+        CmPerfStatistics profiler;
+        uint32_t         functionIds[CM_ULT_PROFILER_FUNCTIONS];
+        for (uint32_t f = 0; f < CM_ULT_PROFILER_FUNCTIONS; f++)
+        {
+            functionIds[f] = profiler.GetFunctionId(gCmUltFunctionNames[f]);
+        }
+        perThreadNs = MeasureCallOverhead([&profiler, &functionIds](uint32_t function, LARGE_INTEGER start, LARGE_INTEGER end)
+        {
+            profiler.InsertApiCallRecord(functionIds[function], start, end);
+        });
+    }
+
+    RecordProperty("LockedNsPerCall", std::to_string(lockedNs));
+    RecordProperty("PerThreadNsPerCall", std::to_string(perThreadNs));
+    printf("%u threads, ns per call of all threads: locked %.1f, per thread %.1f\n",
+        CM_ULT_PROFILER_THREADS, lockedNs, perThreadNs);
+}
+
+#endif  // #if MDF_PROFILER_ENABLED
@@ -661,6 +661,7 @@ typedef struct _CM_KERNEL_INFO
     bool blNoBarrier;       //Indicate if the barrier is used in kernel: true means no barrier used, false means barrier is used.
 
     FINALIZER_INFO *jitInfo;
+    bool jitBinaryFromCache;   //jitBinaryCode was loaded from the jit cache, not allocated by the jitter
     
     uint32_t variable_count;
     gen_var_info_t *variables;
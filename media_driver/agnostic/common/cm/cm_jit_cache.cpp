@@ -0,0 +1,289 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//!
+//! \file      cm_jit_cache.cpp
+//! \brief     Contains Class CmJitCache definitions
+//!
+
+#include "cm_jit_cache.h"
+
+#include "cm_mem.h"
+
+#define CM_JIT_CACHE_SEED_0     0x9E3779B97F4A7C15ULL
+#define CM_JIT_CACHE_SEED_1     0xC2B2AE3D27D4EB4FULL
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Get the process wide jit cache
+//| Returns:    Pointer to the jit cache, never nullptr.
+//*-----------------------------------------------------------------------------
+CmJitCache *CmJitCache::GetInstance()
+{
+    static CmJitCache jitCache;
+    return &jitCache;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Constructor of CmJitCache
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+CmJitCache::CmJitCache():
+    m_enabled(false),
+    m_maxSize(0),
+    m_estimatedSize(0)
+{
+    m_enabled = GetConfiguration(m_directory, m_maxSize);
+    if (m_enabled)
+    {
+        m_estimatedSize = Trim();
+    }
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    64-bit MurmurHash2 (MurmurHash64A) of a memory block
+//| Returns:    Hash value.
+//*-----------------------------------------------------------------------------
+uint64_t CmJitCache::Hash(const void *data, size_t size, uint64_t seed)
+{
+    const uint64_t m = 0xC6A4A7935BD1E995ULL;
+    const int r = 47;
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint64_t h = seed ^ (size * m);
+
+    size_t blockCount = size / sizeof(uint64_t);
+    for (size_t i = 0; i < blockCount; i++)
+    {
+        uint64_t k;
+        memcpy(&k, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    const uint8_t *tail = bytes + blockCount * sizeof(uint64_t);
+    size_t tailSize = size & 7;
+    if (tailSize)
+    {
+        for (size_t i = tailSize; i > 0; i--)
+        {
+            h ^= (uint64_t)tail[i - 1] << (8 * (i - 1));
+        }
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Chain a memory block into both lanes of a key
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::HashAppend(CM_JIT_CACHE_KEY &key, const void *data, size_t size)
+{
+    key.hash[0] = Hash(data, size, key.hash[0]);
+    key.hash[1] = Hash(data, size, key.hash[1]);
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Compute the part of the key shared by all kernels of a program
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::ComputeProgramKey(
+    const void *cisaCode,
+    uint32_t cisaCodeSize,
+    const char *platform,
+    uint32_t cisaMajorVersion,
+    uint32_t cisaMinorVersion,
+    uint32_t jitMajorVersion,
+    uint32_t jitMinorVersion,
+    int numJitFlags,
+    const char **jitFlags,
+    CM_JIT_CACHE_KEY &programKey)
+{
+    uint32_t versions[5] = {CM_JIT_CACHE_VERSION,
+                            cisaMajorVersion,
+                            cisaMinorVersion,
+                            jitMajorVersion,
+                            jitMinorVersion};
+
+    programKey.hash[0] = CM_JIT_CACHE_SEED_0;
+    programKey.hash[1] = CM_JIT_CACHE_SEED_1;
+
+    HashAppend(programKey, versions, sizeof(versions));
+    HashAppend(programKey, cisaCode, cisaCodeSize);
+
+    // String lengths are hashed as well so that different splits of the
+    // same characters do not collide
+    const char *platformName = platform ? platform : "";
+    size_t length = strlen(platformName);
+    HashAppend(programKey, &length, sizeof(length));
+    HashAppend(programKey, platformName, length);
+
+    for (int i = 0; i < numJitFlags; i++)
+    {
+        const char *flag = jitFlags[i] ? jitFlags[i] : "";
+        length = strlen(flag);
+        HashAppend(programKey, &length, sizeof(length));
+        HashAppend(programKey, flag, length);
+    }
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Compute the key of a kernel from the key of its program
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::ComputeKernelKey(
+    const CM_JIT_CACHE_KEY &programKey,
+    const char *kernelName,
+    CM_JIT_CACHE_KEY &kernelKey)
+{
+    kernelKey = programKey;
+    HashAppend(kernelKey, kernelName, strnlen(kernelName, CM_MAX_KERNEL_NAME_SIZE_IN_BYTE));
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Get the file name of a cache entry
+//| Returns:    Full path of the entry.
+//*-----------------------------------------------------------------------------
+std::string CmJitCache::GetEntryPath(const CM_JIT_CACHE_KEY &key)
+{
+    char name[64];
+    MOS_SecureStringPrint(name, sizeof(name), sizeof(name), "%016llx%016llx" CM_JIT_CACHE_FILE_EXTENSION,
+                          (unsigned long long)key.hash[0], (unsigned long long)key.hash[1]);
+    return m_directory + "/" + name;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Look up a kernel in the cache
+//| Returns:    CM_SUCCESS on hit, CM_FAILURE otherwise.
+//*-----------------------------------------------------------------------------
+int32_t CmJitCache::Load(
+    const CM_JIT_CACHE_KEY &key,
+    uint8_t *&binary,
+    uint32_t &binarySize,
+    FINALIZER_INFO *jitInfo)
+{
+    binary = nullptr;
+    binarySize = 0;
+    if (!m_enabled)
+    {
+        return CM_FAILURE;
+    }
+
+    std::string path = GetEntryPath(key);
+    std::vector<uint8_t> data;
+    if (ReadEntry(path, data) != CM_SUCCESS || data.size() < sizeof(CM_JIT_CACHE_ENTRY_HEADER))
+    {
+        return CM_FAILURE;
+    }
+
+    // Reject anything that does not exactly match what Store writes, a
+    // truncated or stale entry just behaves like a miss
+    CM_JIT_CACHE_ENTRY_HEADER header;
+    CmFastMemCopy(&header, data.data(), sizeof(header));
+    const uint8_t *payload = data.data() + sizeof(header);
+    if (header.magic != CM_JIT_CACHE_MAGIC ||
+        header.version != CM_JIT_CACHE_VERSION ||
+        header.key.hash[0] != key.hash[0] ||
+        header.key.hash[1] != key.hash[1] ||
+        header.binarySize == 0 ||
+        header.binarySize != data.size() - sizeof(header) ||
+        header.binaryHash != Hash(payload, header.binarySize, CM_JIT_CACHE_SEED_0))
+    {
+        CM_NORMALMESSAGE("Invalid jit cache entry %s.", path.c_str());
+        return CM_FAILURE;
+    }
+
+    binary = MOS_NewArray(uint8_t, header.binarySize);
+    if (binary == nullptr)
+    {
+        return CM_OUT_OF_HOST_MEMORY;
+    }
+    CmFastMemCopy(binary, payload, header.binarySize);
+    binarySize = header.binarySize;
+
+    jitInfo->isSpill = (header.isSpill != 0);
+    jitInfo->numGRFUsed = header.numGRFUsed;
+    jitInfo->numAsmCount = header.numAsmCount;
+    jitInfo->spillMemUsed = header.spillMemUsed;
+    jitInfo->genDebugInfo = nullptr;
+    jitInfo->genDebugInfoSize = 0;
+    jitInfo->numFlagSpillStore = header.numFlagSpillStore;
+    jitInfo->numFlagSpillLoad = header.numFlagSpillLoad;
+    jitInfo->usesBarrier = (header.usesBarrier != 0);
+    jitInfo->BBNum = 0;
+    jitInfo->BBInfo = nullptr;
+    jitInfo->numGRFSpillFill = header.numGRFSpillFill;
+
+    TouchEntry(path);
+    return CM_SUCCESS;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Add a kernel to the cache
+//| Returns:    CM_SUCCESS if the entry was written.
+//*-----------------------------------------------------------------------------
+int32_t CmJitCache::Store(
+    const CM_JIT_CACHE_KEY &key,
+    const void *binary,
+    uint32_t binarySize,
+    const FINALIZER_INFO *jitInfo)
+{
+    if (!m_enabled || binary == nullptr || binarySize == 0 ||
+        sizeof(CM_JIT_CACHE_ENTRY_HEADER) + binarySize > m_maxSize)
+    {
+        return CM_FAILURE;
+    }
+
+    CM_JIT_CACHE_ENTRY_HEADER header;
+    CmSafeMemSet(&header, 0, sizeof(header));
+    header.magic = CM_JIT_CACHE_MAGIC;
+    header.version = CM_JIT_CACHE_VERSION;
+    header.key = key;
+    header.binaryHash = Hash(binary, binarySize, CM_JIT_CACHE_SEED_0);
+    header.binarySize = binarySize;
+    header.isSpill = jitInfo->isSpill;
+    header.numGRFUsed = jitInfo->numGRFUsed;
+    header.numAsmCount = jitInfo->numAsmCount;
+    header.spillMemUsed = jitInfo->spillMemUsed;
+    header.numFlagSpillStore = jitInfo->numFlagSpillStore;
+    header.numFlagSpillLoad = jitInfo->numFlagSpillLoad;
+    header.usesBarrier = jitInfo->usesBarrier;
+    header.numGRFSpillFill = jitInfo->numGRFSpillFill;
+
+    std::vector<uint8_t> data(sizeof(header) + binarySize);
+    CmFastMemCopy(data.data(), &header, sizeof(header));
+    CmFastMemCopy(data.data() + sizeof(header), binary, binarySize);
+
+    int32_t result = WriteEntry(GetEntryPath(key), data);
+    if (result == CM_SUCCESS && (m_estimatedSize += data.size()) > m_maxSize)
+    {
+        // Entries written by other processes are only accounted here
+        m_estimatedSize = Trim();
+    }
+    return result;
+}
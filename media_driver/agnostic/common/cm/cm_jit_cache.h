@@ -0,0 +1,167 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//!
+//! \file      cm_jit_cache.h
+//! \brief     Contains Class CmJitCache definitions
+//! \details   Optional on-disk cache of the jitter output. Entries are keyed by a
+//!            128-bit hash of the kernel ISA, the jitter options, the platform and
+//!            stepping, the ISA version and the jitter version, so any change in the
+//!            compile inputs or in the jitter library misses the cache. The cache is
+//!            enabled by pointing CM_JIT_CACHE_DIR to a writable directory.
+//!
+#pragma once
+
+#include "cm_def.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+#define CM_JIT_CACHE_MAGIC                  0x434A4D43  // "CMJC"
+#define CM_JIT_CACHE_VERSION                1
+#define CM_JIT_CACHE_DEFAULT_MAX_SIZE_MB    256
+#define CM_JIT_CACHE_TRIM_PERCENT           90          // Trim down to this percentage of the max size
+#define CM_JIT_CACHE_FILE_EXTENSION         ".cmjit"
+
+namespace CMRT_UMD
+{
+
+//*-----------------------------------------------------------------------------
+//! Key of a cache entry
+//*-----------------------------------------------------------------------------
+struct CM_JIT_CACHE_KEY
+{
+    uint64_t hash[2];
+};
+
+//*-----------------------------------------------------------------------------
+//! Layout of a cache entry file, followed by the kernel binary
+//*-----------------------------------------------------------------------------
+struct CM_JIT_CACHE_ENTRY_HEADER
+{
+    uint32_t magic;
+    uint32_t version;
+    CM_JIT_CACHE_KEY key;
+    uint64_t binaryHash;
+    uint32_t binarySize;
+
+    // FINALIZER_INFO fields used by the runtime. The debug info is never cached.
+    uint32_t isSpill;
+    int32_t numGRFUsed;
+    int32_t numAsmCount;
+    uint32_t spillMemUsed;
+    uint32_t numFlagSpillStore;
+    uint32_t numFlagSpillLoad;
+    uint32_t usesBarrier;
+    uint32_t numGRFSpillFill;
+    uint32_t reserved;
+};
+
+//*-----------------------------------------------------------------------------
+//! Process wide on-disk cache of jitted kernels, shared by all CmProgramRT.
+//! Entries are written atomically so several processes can share a directory.
+//! The directory is kept under its size budget by removing the least recently
+//! used entries.
+//*-----------------------------------------------------------------------------
+class CmJitCache
+{
+public:
+    static CmJitCache *GetInstance();
+
+    bool IsEnabled() { return m_enabled; }
+
+    //!
+    //! \brief    Compute the part of the key shared by all kernels of a program
+    //!
+    static void ComputeProgramKey(const void *cisaCode,
+                                  uint32_t cisaCodeSize,
+                                  const char *platform,
+                                  uint32_t cisaMajorVersion,
+                                  uint32_t cisaMinorVersion,
+                                  uint32_t jitMajorVersion,
+                                  uint32_t jitMinorVersion,
+                                  int numJitFlags,
+                                  const char **jitFlags,
+                                  CM_JIT_CACHE_KEY &programKey);
+
+    //!
+    //! \brief    Compute the key of a kernel from the key of its program
+    //!
+    static void ComputeKernelKey(const CM_JIT_CACHE_KEY &programKey,
+                                 const char *kernelName,
+                                 CM_JIT_CACHE_KEY &kernelKey);
+
+    //!
+    //! \brief    Look up a kernel in the cache
+    //! \details  On success binary is allocated with MOS_NewArray and must be
+    //!           released with MosSafeDeleteArray. The cached FINALIZER_INFO fields
+    //!           are written to jitInfo, the other fields are left untouched.
+    //! \return   CM_SUCCESS on hit, CM_FAILURE on miss or invalid entry
+    //!
+    int32_t Load(const CM_JIT_CACHE_KEY &key,
+                 uint8_t *&binary,
+                 uint32_t &binarySize,
+                 FINALIZER_INFO *jitInfo);
+
+    //!
+    //! \brief    Add a kernel to the cache and trim the cache if needed
+    //!
+    int32_t Store(const CM_JIT_CACHE_KEY &key,
+                  const void *binary,
+                  uint32_t binarySize,
+                  const FINALIZER_INFO *jitInfo);
+
+protected:
+    CmJitCache();
+    ~CmJitCache() {}
+
+    static uint64_t Hash(const void *data, size_t size, uint64_t seed);
+
+    static void HashAppend(CM_JIT_CACHE_KEY &key, const void *data, size_t size);
+
+    std::string GetEntryPath(const CM_JIT_CACHE_KEY &key);
+
+    // OS specific, see cm_jit_cache_os.cpp
+    static bool GetConfiguration(std::string &directory, uint64_t &maxSize);
+
+    static int32_t ReadEntry(const std::string &path, std::vector<uint8_t> &data);
+
+    static int32_t WriteEntry(const std::string &path, const std::vector<uint8_t> &data);
+
+    static void TouchEntry(const std::string &path);
+
+    //!
+    //! \brief    Remove the least recently used entries until the cache fits its budget
+    //! \return   Size of the cache after trimming
+    //!
+    uint64_t Trim();
+
+    bool m_enabled;
+    std::string m_directory;
+    uint64_t m_maxSize;
+    std::atomic<uint64_t> m_estimatedSize;  // Directory is only scanned when this exceeds m_maxSize
+
+private:
+    CmJitCache(const CmJitCache& other);
+    CmJitCache& operator=(const CmJitCache& other);
+};
+}; //namespace
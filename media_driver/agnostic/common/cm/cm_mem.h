@@ -30,6 +30,7 @@
 #include <emmintrin.h>
 #include "cm_debug.h"
 #include "mos_utilities.h"
+#include "mos_mem_copy.h"
 
 
 enum CPU_INSTRUCTION_LEVEL
@@ -71,11 +72,6 @@ inline void CmFastMemCopyWC( void* dst,   const void* src, const size_t bytes );
 inline void CmFastMemCopyFromWC( void* dst, const void* src, const size_t bytes, CPU_INSTRUCTION_LEVEL cpuInstructionLevel );
 
 inline void Prefetch( const void* ptr );
-inline void FastMemCopy_SSE2( void* dst,  void* src, const size_t doubleQuadWords );
-
-inline void FastMemCopy_SSE2_movntdq_movdqa( void* dst,  void* src,  const size_t doubleQuadWords );
-inline void FastMemCopy_SSE2_movdqu_movdqa( void* dst,   void* src,  const size_t doubleQuadWords );
-inline void FastMemCopy_SSE2_movntdq_movdqu( void* dst, const void* src, const size_t doubleQuadWords);
 
 
 /*****************************************************************************\
@@ -167,11 +163,7 @@ Description:
 \*****************************************************************************/
 inline void CmDwordMemSet( void* dst, const uint32_t data, const size_t bytes )
 {
-    uint32_t *ptr = reinterpret_cast<uint32_t*>( dst );
-    uint32_t size_in_dwords = (uint32_t)(bytes >> 2); // divide by 4 byte to dword
-    uint32_t *maxPtr = ptr + size_in_dwords;
-    while(ptr < maxPtr)
-        *ptr++ = data;
+    MOS_FastMemFill32( dst, data, bytes, MOS_MEMCOPY_DEFAULT );
 }
 
 /*****************************************************************************\
@@ -368,266 +360,12 @@ inline void* Align( void* const ptr, const size_t alignment )
     return (void*)( ( ((size_t)ptr) + alignment-1 ) & ~( alignment-1 ) );
 }
 
-/*****************************************************************************\
-Inline Function:
-    FastMemCopy_SSE2_movntdq_movdqa
-
-Description:
-    Intel C++ Compiler Memory Copy function using Streaming SIMD Extensions 2
-
-Input:
-    dst - 16-byte aligned pointer to destination buffer
-    src - 16-byte aligned pointer to source buffer
-    doubleQuadWords - number of DoubleQuadWords to copy
-\*****************************************************************************/
-inline void FastMemCopy_SSE2_movntdq_movdqa(
-    void* dst,
-    void* src, 
-    const size_t doubleQuadWords )
-{
-    CM_ASSERT( IsAligned( dst, sizeof(DQWORD) ) );
-    CM_ASSERT( IsAligned( src, sizeof(DQWORD) ) );
-
-    const size_t DoubleQuadWordsPerPrefetch = sizeof(PREFETCH) / sizeof(DQWORD);
-
-    // Prefetch the src data
-    Prefetch( (uint8_t*)src );
-    Prefetch( (uint8_t*)src + sizeof(PREFETCH) );
-
-    // Convert to SSE2 registers
-    __m128i* dst128i = (__m128i*)dst;
-    __m128i* src128i = (__m128i*)src;
-
-    size_t count = doubleQuadWords;
-
-    // Copies a cacheline per loop iteration
-    while( count >= DoubleQuadWordsPerPrefetch )
-    {
-        Prefetch( (uint8_t*)src128i + 2 * sizeof(PREFETCH) );
-
-        count -= DoubleQuadWordsPerPrefetch;
-
-        // Copy cacheline of data
-        for( size_t i = 0; i < DoubleQuadWordsPerPrefetch; i++ )
-        {
-            _mm_stream_si128( dst128i++,
-                _mm_load_si128( src128i++ ) );
-        }
-    }
-
-    // Copy DQWORD if not cacheline multiple
-    while( count-- )
-    {
-        _mm_stream_si128( dst128i++,
-            _mm_load_si128( src128i++ ) );
-    }
-}
-
-/*****************************************************************************\
-Inline Function:
-    FastMemCopy_SSE2_movdqu_movdqa
-
-Description:
-    Intel C++ Compiler Memory Copy function using Streaming SIMD Extensions 2
-
-Input:
-    dst - pointer to destination buffer
-    src - 16-byte aligned pointer to source buffer
-    doubleQuadWords - number of DoubleQuadWords to copy
-\*****************************************************************************/
-inline void FastMemCopy_SSE2_movdqu_movdqa(
-    void* dst, 
-    void* src, 
-    const size_t doubleQuadWords )
-{
-    CM_ASSERT( IsAligned( src, sizeof(DQWORD) ) );
-
-    const size_t DoubleQuadWordsPerPrefetch = sizeof(PREFETCH) / sizeof(DQWORD);
-
-    // Prefetch the src data
-    Prefetch( (uint8_t*)src );
-    Prefetch( (uint8_t*)src + sizeof(PREFETCH) );
-
-    // Convert to SSE2 registers
-    __m128i* dst128i = (__m128i*)dst;
-    __m128i* src128i = (__m128i*)src;
-
-    size_t count = doubleQuadWords;
-
-    // Copies a cacheline per loop iteration
-    while( count >= DoubleQuadWordsPerPrefetch )
-    {
-        Prefetch( (uint8_t*)src128i + 2 * sizeof(PREFETCH) );
-
-        count -= DoubleQuadWordsPerPrefetch;
-
-        // Copy cacheline of data
-        for( size_t i = 0; i < DoubleQuadWordsPerPrefetch; i++ )
-        {
-            _mm_storeu_si128( dst128i++,
-                _mm_load_si128( src128i++ ) );
-        }
-    }
-
-    // Copy DQWORD if not cacheline multiple
-    while( count-- )
-    {
-        _mm_storeu_si128( dst128i++,
-            _mm_load_si128( src128i++ ) );
-    }
-}
-
-/*****************************************************************************\
-Inline Function:
-    FastMemCopy_SSE2_movntdq_movdqu
-
-Description:
-    Intel C++ Compiler Memory Copy function using Streaming SIMD Extensions 2
-
-Input:
-    dst - 16-byte aligned pointer to destination buffer
-    src - pointer to source buffer
-    doubleQuadWords - number of DoubleQuadWords to copy
-\*****************************************************************************/
-inline void FastMemCopy_SSE2_movntdq_movdqu(
-    void* dst, 
-    const void* src, 
-    const size_t doubleQuadWords )
-{
-    CM_ASSERT( IsAligned( dst, sizeof(DQWORD) ) );
-
-    const size_t DoubleQuadWordsPerPrefetch = sizeof(PREFETCH) / sizeof(DQWORD);
-
-    // Prefetch the src data
-    Prefetch( (uint8_t*)src );
-    Prefetch( (uint8_t*)src + sizeof(PREFETCH) );
-
-    // Convert to SSE2 registers
-    __m128i* dst128i = (__m128i*)dst;
-    __m128i* src128i = (__m128i*)src;
-
-    size_t count = doubleQuadWords;
-
-    // Copies a cacheline per loop iteration
-    while( count >= DoubleQuadWordsPerPrefetch )
-    {
-        Prefetch( (uint8_t*)src128i + 2 * sizeof(PREFETCH) );
-
-        count -= DoubleQuadWordsPerPrefetch;
-
-        // Copy cacheline of data
-        for( size_t i = 0; i < DoubleQuadWordsPerPrefetch; i++ )
-        {
-            _mm_stream_si128( dst128i++,
-                _mm_loadu_si128( src128i++ ) );
-        }
-    }
-
-    // Copy DQWORD if not cacheline multiple
-    while( count-- )
-    {
-        _mm_stream_si128( dst128i++,
-            _mm_loadu_si128( src128i++ ) );
-    }
-}
-
-/*****************************************************************************\
-Inline Function:
-    FastMemCopy_SSE2_movdqu_movdqu
-
-Description:
-    Intel C++ Compiler Memory Copy function using Streaming SIMD Extensions 2
-
-Input:
-    dst - pointer to destination buffer
-    src - pointer to source buffer
-    doubleQuadWords - number of DoubleQuadWords to copy
-\*****************************************************************************/
-inline void FastMemCopy_SSE2_movdqu_movdqu(
-    void* dst, 
-    const void* src, 
-    const size_t doubleQuadWords )
-{
-    const size_t DoubleQuadWordsPerPrefetch = sizeof(PREFETCH) / sizeof(DQWORD);
-
-    // Prefetch the src data
-    Prefetch( (uint8_t*)src );
-    Prefetch( (uint8_t*)src + sizeof(PREFETCH) );
-
-    // Convert to SSE2 registers
-    __m128i* dst128i = (__m128i*)dst;
-    __m128i* src128i = (__m128i*)src;
-
-    size_t count = doubleQuadWords;
-
-    // Copies a cacheline per loop iteration
-    while( count >= DoubleQuadWordsPerPrefetch )
-    {
-        Prefetch( (uint8_t*)src128i + 2 * sizeof(PREFETCH) );
-
-        count -= DoubleQuadWordsPerPrefetch;
-
-        // Copy cacheline of data
-        for( size_t i = 0; i < DoubleQuadWordsPerPrefetch; i++ )
-        {
-            _mm_storeu_si128( dst128i++,
-                _mm_loadu_si128( src128i++ ) );
-        }
-    }
-
-    // Copy DQWORD if not cacheline multiple
-    while( count-- )
-    {
-        _mm_storeu_si128( dst128i++,
-            _mm_loadu_si128( src128i++ ) );
-    }
-}
-
-/*****************************************************************************\
-Inline Function:
-    FastMemCopy_SSE2
-
-Description:
-    Intel C++ Compiler Memory Copy function using Streaming SIMD Extensions 2
-
-Input:
-    dst - pointer to destination buffer
-    src - pointer to source buffer
-    doubleQuadWords - number of DoubleQuadWords to copy
-\*****************************************************************************/
-inline void FastMemCopy_SSE2(
-    void* dst, 
-    void* src, 
-    const size_t doubleQuadWords )
-{
-    // Determine if the source and destination addresses are 128-bit aligned
-    const bool isDstDoubleQuadWordAligned = IsAligned( dst, sizeof(DQWORD) );
-    const bool isSrcDoubleQuadWordAligned = IsAligned( src, sizeof(DQWORD) );
-
-    if( isSrcDoubleQuadWordAligned && isDstDoubleQuadWordAligned )
-    {
-        FastMemCopy_SSE2_movntdq_movdqa( dst, src, doubleQuadWords );
-    }
-    else if( isDstDoubleQuadWordAligned )
-    {
-        FastMemCopy_SSE2_movntdq_movdqu( dst, src, doubleQuadWords );
-    }
-    else if( isSrcDoubleQuadWordAligned )
-    {
-        FastMemCopy_SSE2_movdqu_movdqa( dst, src, doubleQuadWords );
-    }
-    else // if( !isSrcDoubleQuadWordAligned && !isDstDoubleQuadWordAligned )
-    {
-        FastMemCopy_SSE2_movdqu_movdqu( dst, src, doubleQuadWords );
-    }
-}
-
 /*****************************************************************************\
 Inline Function:
     CmFastMemCopy
 
 Description:
-    Intel C++ Compiler Memory Copy function for large amounts of data
+    Memory Copy function for large amounts of data
 
 Input:
     dst - pointer to destination buffer
@@ -636,30 +374,7 @@ Input:
 \*****************************************************************************/
 inline void CmFastMemCopy( void* dst, const   void* src, const size_t bytes )
 {
-
-    // Cache pointers to memory
-    uint8_t *p_dst = (uint8_t*)dst;
-    uint8_t *p_src = (uint8_t*)src;
-
-    size_t count = bytes;
-
-    // Get the number of DQWORDs to be copied
-    const size_t doubleQuadWords = count / sizeof(DQWORD);
-
-    if( doubleQuadWords )
-    {
-        FastMemCopy_SSE2( p_dst, p_src, doubleQuadWords );
-
-        p_dst += doubleQuadWords * sizeof(DQWORD);
-        p_src += doubleQuadWords * sizeof(DQWORD);
-        count -= doubleQuadWords * sizeof(DQWORD);
-    }
-
-    // Copy remaining uint8_t(s)
-    if( count )
-    {
-        MOS_SecureMemcpy( p_dst, count, p_src, count );
-    }
+    MOS_FastMemCopy( dst, src, bytes, MOS_MEMCOPY_DEFAULT );
 }
 
 
@@ -668,8 +383,8 @@ Inline Function:
 CmFastMemCopyWC
 
 Description:
-Intel C++ Compiler Memory Copy function for large amounts of data, just now prefetch
-compared with FastMemCopyWC. It is the same as the FastMemCopyWC_NoPf in CMRT@APP.
+Memory Copy function for large amounts of data, the destination is written
+with non-temporal stores.
 
 Input:
 dst - pointer to write-combined destination buffer
@@ -678,60 +393,7 @@ bytes - number of bytes to copy
 \*****************************************************************************/
 inline void CmFastMemCopyWC( void* dst,   const void* src, const size_t bytes )
 {
-  // Cache pointers to memory
-  uint8_t *p_dst = (uint8_t*)dst;
-  uint8_t *p_src = (uint8_t*)src;
-
-  size_t count = bytes;
-
-  if( count >= sizeof(DQWORD) )
-  {
-    const size_t doubleQuadwordAlignBytes =
-      GetAlignmentOffset( p_dst, sizeof(DQWORD) );
-
-    // The destination pointer should be 128-bit aligned
-    if( doubleQuadwordAlignBytes )
-    {
-      MOS_SecureMemcpy( p_dst, doubleQuadwordAlignBytes,p_src, doubleQuadwordAlignBytes );
-
-      p_dst += doubleQuadwordAlignBytes;
-      p_src += doubleQuadwordAlignBytes;
-      count -= doubleQuadwordAlignBytes;
-    }
-
-    // Get the number of DQWORDs to be copied
-    const size_t doubleQuadWords = count / sizeof(DQWORD);
-
-    if( doubleQuadWords )
-    {
-      // Determine if the source and destination addresses are
-      // 128-bit aligned
-      CM_ASSERT( IsAligned( p_dst, sizeof(DQWORD) ) );
-
-      const bool isSrcDoubleQuadWordAligned =
-        IsAligned( p_src, sizeof(DQWORD) );
-
-      if( isSrcDoubleQuadWordAligned )
-      {
-        FastMemCopy_SSE2_movntdq_movdqa( p_dst, p_src,
-          doubleQuadWords );
-      }
-      else
-      {
-        FastMemCopy_SSE2_movntdq_movdqu( p_dst, p_src,
-          doubleQuadWords );
-      }
-
-      p_dst += doubleQuadWords * sizeof(DQWORD);
-      p_src += doubleQuadWords * sizeof(DQWORD);
-      count -= doubleQuadWords * sizeof(DQWORD);
-    }
-  }
-
-  // Copy remaining uint8_t(s)
-  if( count )
-  {
-    MOS_SecureMemcpy( p_dst, count, p_src, count );
-  }
+    MOS_FastMemCopy( dst, src, bytes, MOS_MEMCOPY_DST_UNCACHED );
 }
 
+
@@ -28,6 +28,7 @@
 
 #include "cm_device_rt.h"
 #include "cm_hal.h"
+#include "cm_jit_cache.h"
 
 #if USE_EXTENSION_CODE
 #include "cm_hw_debugger.h"
@@ -197,6 +198,11 @@ int32_t CmProgramRT::Initialize( void* pCISACode, const uint32_t uiCISACodeSize,
 
     char* pFlagStepInfo = nullptr;
 
+    CmJitCache *pJitCache = CmJitCache::GetInstance();
+    bool bUseJitCache = false;
+    CM_JIT_CACHE_KEY programKey;
+    CmSafeMemSet(&programKey, 0, sizeof(programKey));
+
     if( options )
     {
         size_t length = strnlen( options, CM_MAX_OPTION_SIZE_IN_BYTE );
@@ -366,6 +372,18 @@ int32_t CmProgramRT::Initialize( void* pCISACode, const uint32_t uiCISACodeSize,
                 return CM_OUT_OF_HOST_MEMORY;
             }
         }
+
+        // The cache does not keep the debug info, so it is bypassed when the
+        // kernels are debugged or instrumented
+        bUseJitCache = pJitCache->IsEnabled() && !m_IsHwDebugEnabled;
+#if USE_EXTENSION_CODE
+        bUseJitCache = bUseJitCache && !(m_pCmDev->CheckGTPinEnabled() && !bLoadingGPUCopyKernel);
+#endif
+        if (bUseJitCache)
+        {
+            CmJitCache::ComputeProgramKey(pCISACode, uiCISACodeSize, platform, m_CISA_majorVersion, m_CISA_minorVersion,
+                                          jitMajor, jitMinor, numJitFlags, jitFlags, programKey);
+        }
     }
 
     if (bUseVisaApi)
@@ -596,19 +614,38 @@ int32_t CmProgramRT::Initialize( void* pCISACode, const uint32_t uiCISACodeSize,
             }
             CmSafeMemSet( jitProfInfo, 0, CM_JIT_PROF_INFO_SIZE );
 
+            CM_JIT_CACHE_KEY kernelKey;
+            bool bJitCacheHit = false;
+            if (bUseJitCache)
+            {
+                uint8_t *pCachedBinary = nullptr;
+                CmJitCache::ComputeKernelKey(programKey, pKernInfo->kernelName, kernelKey);
+                if (pJitCache->Load(kernelKey, pCachedBinary, jitBinarySize, jitProfInfo) == CM_SUCCESS)
+                {
+                    jitBinary = pCachedBinary;
+                    bJitCacheHit = true;
+                }
+            }
 
-            result = m_fJITCompile( pKernInfo->kernelName, (uint8_t*)pCISACode, uiCISACodeSize,
-                                    jitBinary, jitBinarySize, platform, m_CISA_majorVersion, m_CISA_minorVersion, numJitFlags, jitFlags, errorMsg, jitProfInfo );
-           
-
-            //if error code returned or error message not nullptr
-            if(result != CM_SUCCESS)// || errorMsg[0])
+            if (!bJitCacheHit)
             {
-                CM_NORMALMESSAGE("%s.", errorMsg);
-                free(errorMsg);
-                CmSafeDelete(pKernInfo);
-                hr = CM_JIT_COMPILE_FAILURE;
-                goto finish;
+                result = m_fJITCompile( pKernInfo->kernelName, (uint8_t*)pCISACode, uiCISACodeSize,
+                                        jitBinary, jitBinarySize, platform, m_CISA_majorVersion, m_CISA_minorVersion, numJitFlags, jitFlags, errorMsg, jitProfInfo );
+
+                //if error code returned or error message not nullptr
+                if(result != CM_SUCCESS)// || errorMsg[0])
+                {
+                    CM_NORMALMESSAGE("%s.", errorMsg);
+                    free(errorMsg);
+                    CmSafeDelete(pKernInfo);
+                    hr = CM_JIT_COMPILE_FAILURE;
+                    goto finish;
+                }
+
+                if (bUseJitCache)
+                {
+                    pJitCache->Store(kernelKey, jitBinary, jitBinarySize, jitProfInfo);
+                }
             }
 
             // if spill code exists and scrach space disabled, return error to user
@@ -624,6 +661,7 @@ int32_t CmProgramRT::Initialize( void* pCISACode, const uint32_t uiCISACodeSize,
             pKernInfo->jitBinaryCode = jitBinary;
             pKernInfo->jitBinarySize = jitBinarySize;
             pKernInfo->jitInfo = jitProfInfo;
+            pKernInfo->jitBinaryFromCache = bJitCacheHit;
 
 #if USE_EXTENSION_CODE
             if ( m_IsHwDebugEnabled )
@@ -847,7 +885,17 @@ uint32_t CmProgramRT::ReleaseKernelInfo(uint32_t index)
                 if(m_IsJitterEnabled)
                 {
                     if(pKernelInfo && pKernelInfo->jitBinaryCode)
-                        m_fFreeBlock(pKernelInfo->jitBinaryCode);
+                    {
+                        if (pKernelInfo->jitBinaryFromCache)
+                        {
+                            uint8_t *pCachedBinary = (uint8_t *)pKernelInfo->jitBinaryCode;
+                            MosSafeDeleteArray(pCachedBinary);
+                        }
+                        else
+                        {
+                            m_fFreeBlock(pKernelInfo->jitBinaryCode);
+                        }
+                    }
                     if(pKernelInfo && pKernelInfo->jitInfo)
                         free(pKernelInfo->jitInfo);
                 }
@@ -213,7 +213,6 @@ CM_RT_API int32_t CmSurface2DRT::WriteSurface( const unsigned char* pSysMem, CmE
     uint32_t        updatedHeight   = 0;
     uint32_t        size            = 0;
     uint32_t        pitch           = 0;
-    uint32_t        row             = 0;
     UNUSED(sysMemSize);
 
     if(pSysMem == nullptr)
@@ -261,20 +260,8 @@ CM_RT_API int32_t CmSurface2DRT::WriteSurface( const unsigned char* pSysMem, CmE
 
     size = m_Width * sizePerPixel;
     pitch = m_Pitch;
-    if(pitch != size)
-    {
-        for (row = 0; row < updatedHeight; row ++)
-        {
-            CmFastMemCopyWC(pDst, pSurf, size);
-
-            pSurf += size;
-            pDst += pitch;
-        }
-    }
-    else
-    {
-        CmFastMemCopyWC(pDst, pSurf, pitch * updatedHeight);
-    }
+    MOS_FastMemCopy2D(pDst, pitch, pSurf, size, size, updatedHeight,
+                      MOS_MEMCOPY_DST_UNCACHED | MOS_MEMCOPY_PARALLEL);
 
     //Unlock Surface2D
     inParam.pData = nullptr;
@@ -396,7 +383,6 @@ CM_RT_API int32_t CmSurface2DRT::ReadSurface( unsigned char* pSysMem, CmEvent* p
     uint32_t        updatedHeight   = 0;
     uint32_t        widthInByte     = 0;
     uint32_t        pitch           = 0;
-    uint32_t        row             = 0;
     UNUSED(sysMemSize);
 
     if(pSysMem == nullptr)
@@ -444,19 +430,8 @@ CM_RT_API int32_t CmSurface2DRT::ReadSurface( unsigned char* pSysMem, CmEvent* p
 
     widthInByte = m_Width * sizePerPixel;
     pitch = m_Pitch;
-    if (pitch != widthInByte)
-    {
-        for (row = 0; row < updatedHeight; row ++)
-        {
-            CmFastMemCopyFromWC(pDst, pSurf, widthInByte, GetCpuInstructionLevel());
-            pSurf += pitch;
-            pDst += widthInByte;
-        }
-    }
-    else
-    {
-        CmFastMemCopyFromWC(pDst, pSurf, pitch * updatedHeight, GetCpuInstructionLevel());
-    }
+    MOS_FastMemCopy2D(pDst, widthInByte, pSurf, pitch, widthInByte, updatedHeight,
+                      MOS_MEMCOPY_SRC_UNCACHED | MOS_MEMCOPY_PARALLEL);
 
     //Unlock
     inParam.pData = nullptr;
@@ -497,7 +472,6 @@ CM_RT_API int32_t CmSurface2DRT::WriteSurfaceStride( const unsigned char* pSysMe
     uint32_t        updatedHeight   = 0;
     uint32_t        widthInByte     = 0;
     uint32_t        pitch           = 0;
-    uint32_t        row             = 0;
     UNUSED(sysMemSize);
 
     if(pSysMem == nullptr)
@@ -546,19 +520,8 @@ CM_RT_API int32_t CmSurface2DRT::WriteSurfaceStride( const unsigned char* pSysMe
 
     widthInByte = m_Width * sizePerPixel;
     pitch = m_Pitch;
-    if ((pitch != widthInByte) || (stride != pitch))
-    {
-        for (row = 0; row < updatedHeight; row ++)
-        {
-            CmFastMemCopyWC(pDst, pSrc, widthInByte);
-            pSrc += stride;
-            pDst += pitch;
-        }
-    }
-    else
-    {
-        CmFastMemCopyWC(pDst, pSrc, pitch * updatedHeight);
-    }
+    MOS_FastMemCopy2D(pDst, pitch, pSrc, stride, widthInByte, updatedHeight,
+                      MOS_MEMCOPY_DST_UNCACHED | MOS_MEMCOPY_PARALLEL);
 
     //Unlock Surface2D
     inParam.pData = nullptr; //Set pData to Null to differentiate route from app or cmrt@umd
@@ -670,12 +633,9 @@ CM_RT_API int32_t CmSurface2DRT::ReadSurfaceFullStride( unsigned char* pSysMem,
 
     if( m_Format == CM_SURFACE_FORMAT_NV12)
     {
-        for( uint32_t i=0 ; i< m_Height ; i++)
-        { // Y plane
-          CmFastMemCopyFromWC(pDst, pSrc, m_Width, GetCpuInstructionLevel());
-          pSrc  += m_Pitch;
-          pDst  += iWidthStride;
-        }
+        // Y plane
+        MOS_FastMemCopy2D(pDst, iWidthStride, pSrc, m_Pitch, m_Width, m_Height,
+                          MOS_MEMCOPY_SRC_UNCACHED | MOS_MEMCOPY_PARALLEL);
 
         pSrc  = ( uint8_t *)(inParam.pData) + m_Height * m_Pitch;
         pDst  = ( uint8_t *)pSysMem + iWidthStride * iHeightStride;
@@ -683,30 +643,15 @@ CM_RT_API int32_t CmSurface2DRT::ReadSurfaceFullStride( unsigned char* pSysMem,
         //To support NV12 format with odd height here.
         //if original height is even, the UV plane's height is set as m_Height/2, which equals to (m_Height+1)/2 
         //if original height is odd, the UV plane's height is set as roundup(m_Height/2), which equals to (m_Height+1)/2 too
-        for (uint32_t i = 0; i< (m_Height + 1) / 2; i++)
-        { // UV plane
-          CmFastMemCopyFromWC(pDst, pSrc, m_Width, GetCpuInstructionLevel());
-          pSrc  += m_Pitch;
-          pDst  += iWidthStride;
-        }
+        // UV plane
+        MOS_FastMemCopy2D(pDst, iWidthStride, pSrc, m_Pitch, m_Width, (m_Height + 1) / 2,
+                          MOS_MEMCOPY_SRC_UNCACHED | MOS_MEMCOPY_PARALLEL);
     }
     else
     {
         uint32_t size = m_Width * sizePerPixel;
-        uint32_t pitch = m_Pitch;
-        if((pitch != size)||(iWidthStride != size))
-        {
-           for (uint32_t i=0; i < updatedHeight; i++)
-           {
-              CmFastMemCopyFromWC(pDst, pSrc, size, GetCpuInstructionLevel());
-              pSrc  += pitch;
-              pDst  += iWidthStride;
-           }
-         }
-         else
-         {
-             CmFastMemCopyFromWC(pDst, pSrc, pitch * updatedHeight, GetCpuInstructionLevel());
-         }
+        MOS_FastMemCopy2D(pDst, iWidthStride, pSrc, m_Pitch, size, updatedHeight,
+                          MOS_MEMCOPY_SRC_UNCACHED | MOS_MEMCOPY_PARALLEL);
     }
 
     //Unlock
@@ -785,12 +730,9 @@ CM_RT_API int32_t CmSurface2DRT::WriteSurfaceFullStride( const unsigned char* pS
 
     if( m_Format == CM_SURFACE_FORMAT_NV12)
     {
-        for( uint32_t i=0 ; i< m_Height ; i++)
-        { // Y plane
-          CmFastMemCopyFromWC(pDst, pSrc, m_Width, GetCpuInstructionLevel());
-          pSrc  += iWidthStride ;
-          pDst  += m_Pitch;
-        }
+        // Y plane
+        MOS_FastMemCopy2D(pDst, m_Pitch, pSrc, iWidthStride, m_Width, m_Height,
+                          MOS_MEMCOPY_DST_UNCACHED | MOS_MEMCOPY_PARALLEL);
 
         pDst  = ( uint8_t *)(inParam.pData) + m_Height * m_Pitch;
         pSrc  = ( uint8_t *)pSysMem + iWidthStride * iHeightStride;
@@ -798,30 +740,15 @@ CM_RT_API int32_t CmSurface2DRT::WriteSurfaceFullStride( const unsigned char* pS
         //To support NV12 format with odd height here.
         //if original height is even, the UV plane's height is set as m_Height/2, which equals to (m_Height+1)/2 
         //if original height is odd, the UV plane's height is set as roundup(m_Height/2), which equals to (m_Height+1)/2 too
-        for( uint32_t i=0 ; i< ( m_Height + 1) /2 ; i++)
-        { // UV plane
-          CmFastMemCopyFromWC(pDst, pSrc, m_Width, GetCpuInstructionLevel());
-          pSrc  += iWidthStride ;
-          pDst  += m_Pitch;
-        }
+        // UV plane
+        MOS_FastMemCopy2D(pDst, m_Pitch, pSrc, iWidthStride, m_Width, (m_Height + 1) / 2,
+                          MOS_MEMCOPY_DST_UNCACHED | MOS_MEMCOPY_PARALLEL);
     }
     else
     {
         uint32_t size = m_Width * sizePerPixel;
-        uint32_t pitch = m_Pitch;
-        if((pitch != size)||(iWidthStride != pitch))
-        {
-            for (uint32_t i=0; i < updatedHeight; i++)
-            {
-                CmFastMemCopyWC(pDst, pSrc, size);
-                pSrc += iWidthStride;
-                pDst += pitch;
-            }
-        }
-        else
-        {
-            CmFastMemCopyWC(pDst, pSrc, pitch * updatedHeight);
-        }
+        MOS_FastMemCopy2D(pDst, m_Pitch, pSrc, iWidthStride, size, updatedHeight,
+                          MOS_MEMCOPY_DST_UNCACHED | MOS_MEMCOPY_PARALLEL);
     }
 
     //Unlock Surface2D
@@ -1181,19 +1108,8 @@ void CmSurface2DRT::DumpContent(uint32_t kernelNumber, int32_t taskId, uint32_t
         return;
     pDst = (uint8_t *)&surface[0];
     pSurf = (uint8_t *)(inParam.pData);
-    if (m_Pitch != widthInByte)
-    {
-        for (uint32_t row = 0; row < updatedHeight; row++)
-        {
-            CmFastMemCopyFromWC(pDst, pSurf, widthInByte, GetCpuInstructionLevel());
-            pSurf += m_Pitch;
-            pDst += widthInByte;
-        }
-    }
-    else
-    {
-        CmFastMemCopyFromWC((unsigned char *)&surface[0], pSurf, m_Pitch * updatedHeight, GetCpuInstructionLevel());
-    }
+    MOS_FastMemCopy2D(pDst, widthInByte, pSurf, m_Pitch, widthInByte, updatedHeight,
+                      MOS_MEMCOPY_SRC_UNCACHED);
     inParam.pData = nullptr; 
     pCmData->pCmHalState->pfnUnlock2DResource(pCmData->pCmHalState, &inParam);
 
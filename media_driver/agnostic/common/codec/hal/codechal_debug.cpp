@@ -30,6 +30,7 @@
 #include "codechal_hw.h"
 #include "codechal_common.h"
 #include "codechal_common_vp9.h"
+#include "mos_dump_service.h"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
@@ -43,6 +44,8 @@ CodechalDebugInterface::CodechalDebugInterface()
 }
 CodechalDebugInterface::~CodechalDebugInterface()
 {
+    MOS_DumpService_Flush();
+
     if (nullptr != m_configMgr)
     {
         MOS_Delete(m_configMgr);
@@ -413,6 +416,7 @@ MOS_STATUS CodechalDebugInterface::DumpYUVSurface(
     lockFlags.ReadOnly = 1;
 
     uint8_t *surfBaseAddr = (uint8_t *)pOsInterface->pfnLockResource(pOsInterface, &surface->OsResource, &lockFlags);
+    CODECHAL_DEBUG_CHK_NULL(surfBaseAddr);
 
     surfBaseAddr += surface->dwOffset + surface->YPlaneOffset.iYOffset * surface->dwPitch;
     uint8_t *data   = surfBaseAddr;
@@ -451,34 +455,17 @@ MOS_STATUS CodechalDebugInterface::DumpYUVSurface(
         height /= 2;
     }
 
-    const char *funcName = CodecFunction == CODECHAL_FUNCTION_DECODE ? "_DEC" : "_ENC";
-    std::string bufName  = std::string(surfName) + "_w[" + std::to_string(width) + "]_h[" + std::to_string(height) + "]_p[" + std::to_string(pitch) + "]";
-
-    const char *filePath = CreateFileName(funcName, bufName.c_str(), CodechalDbgExtType::yuv);
-
-    std::ofstream ofs(filePath, std::ios_base::out | std::ios_base::binary);
-    if (ofs.fail())
-    {
-        return MOS_STATUS_UNKNOWN;
-    }
-
-    // write luma data to file
-    for (uint32_t h = 0; h < height; h++)
-    {
-        ofs.write((char* )data, width);
-        data += pitch;
-    }
-
+    uint32_t chromaHeight = height;
     switch (surface->Format)
     {
     case Format_NV12:
-        height >>= 1;
+        chromaHeight >>= 1;
         break;
     case  Format_Y416:
     case  Format_AYUV:
     case  Format_AUYV:
     case  Format_Y410: //444 10bit
-        height *= 2;
+        chromaHeight *= 2;
         break;
     case  Format_YUY2:
     case  Format_YUYV:
@@ -489,24 +476,44 @@ MOS_STATUS CodechalDebugInterface::DumpYUVSurface(
     case  Format_Y210: //422 10bit
         break;
     default:
-        height = 0;
+        chromaHeight = 0;
         break;
     }
 
+    const char *funcName = CodecFunction == CODECHAL_FUNCTION_DECODE ? "_DEC" : "_ENC";
+    std::string bufName  = std::string(surfName) + "_w[" + std::to_string(width) + "]_h[" + std::to_string(height) + "]_p[" + std::to_string(pitch) + "]";
+
+    const char *filePath = CreateFileName(funcName, bufName.c_str(), CodechalDbgExtType::yuv);
+
+    // Snapshot the planes so that the surface can be unlocked before the file is
+    // written. A null snapshot means the dump pool is full and the frame is dropped.
+    uint32_t dumpSize = width * (height + chromaHeight);
+    uint8_t *dumpData = (uint8_t *)MOS_DumpService_AllocBuffer(dumpSize);
+    uint8_t *dst      = dumpData;
+
+    // copy luma data
+    for (uint32_t h = 0; dst && h < height; h++)
+    {
+        MOS_SecureMemcpy(dst, width, data, width);
+        dst  += width;
+        data += pitch;
+    }
+
     data = surfBaseAddr + surface->UPlaneOffset.iLockSurfaceOffset;
 
-    // write chroma data to file
-    for (uint32_t h = 0; h < height; h++)
+    // copy chroma data
+    for (uint32_t h = 0; dst && h < chromaHeight; h++)
     {
-        ofs.write((char*)data, width);
+        MOS_SecureMemcpy(dst, width, data, width);
+        dst  += width;
         data += pitch;
     }
 
-    ofs.close();
+    pOsInterface->pfnUnlockResource(pOsInterface, &surface->OsResource);
 
-    if (surfBaseAddr)
+    if (dumpData)
     {
-        pOsInterface->pfnUnlockResource(pOsInterface, &surface->OsResource);
+        return MOS_DumpService_Submit(filePath, dumpData, dumpSize, MOS_DUMP_FORMAT_BINARY, false);
     }
 
     return MOS_STATUS_SUCCESS;
@@ -1063,22 +1070,12 @@ MOS_STATUS CodechalDebugInterface::DumpBufferInBinary(uint8_t *data, uint32_t si
 {
     CODECHAL_DEBUG_CHK_NULL(data);
 
-    const char *filePath = m_outputFileName.c_str();
-
     if (size == 0)
     {
         return MOS_STATUS_UNKNOWN;
     }
 
-    std::ofstream ofs(filePath, std::ios_base::out | std::ios_base::binary);
-    if (ofs.fail())
-    {
-        return MOS_STATUS_UNKNOWN;
-    }
-
-    ofs.write((char*)data, size);
-    ofs.close();
-    return MOS_STATUS_SUCCESS;
+    return MOS_DumpService_WriteFile(m_outputFileName.c_str(), data, size, MOS_DUMP_FORMAT_BINARY);
 }
 
 MOS_STATUS CodechalDebugInterface::Dump2DBufferInBinary(
@@ -1089,70 +1086,25 @@ MOS_STATUS CodechalDebugInterface::Dump2DBufferInBinary(
 {
     CODECHAL_DEBUG_CHK_NULL(data);
 
-    const char *filePath = m_outputFileName.c_str();
-
     if (width == 0 || height == 0 || pitch == 0)
     {
         return MOS_STATUS_UNKNOWN;
     }
 
-    std::ofstream ofs(filePath, std::ios_base::out | std::ios_base::binary);
-    if (ofs.fail())
-    {
-        return MOS_STATUS_UNKNOWN;
-    }
-
-    for (uint32_t h = 0; h < height; h++)
-    {
-        ofs.write((char*)data, width);
-        data += pitch;
-    }
-
-    ofs.close();
-    return MOS_STATUS_SUCCESS;
+    return MOS_DumpService_Write2D(m_outputFileName.c_str(), data, width, height, pitch);
 }
 
 MOS_STATUS CodechalDebugInterface::DumpBufferInHexDwords(uint8_t *data, uint32_t size)
 {
     CODECHAL_DEBUG_CHK_NULL(data);
 
-    const char *filePath = m_outputFileName.c_str();
-
     if (size == 0)
     {
         return MOS_STATUS_UNKNOWN;
     }
 
-    std::ofstream ofs(filePath);
-
-    if (ofs.fail())
-    {
-        return MOS_STATUS_UNKNOWN;
-    }
-
-    uint32_t dwordSize  = size / sizeof(uint32_t);
-    uint32_t remainSize = size % sizeof(uint32_t);
-
-    uint32_t *dwordData = (uint32_t *)data;
-    uint32_t  i;
-    for (i = 0; i < dwordSize; i++)
-    {
-        ofs << std::hex << std::setw(8) << std::setfill('0') << +dwordData[i] << " ";
-        if (i % 4 == 3)
-        {
-            ofs << std::endl;
-        }
-    }
-
-    if (remainSize > 0)
-    {
-        uint32_t lastWord = dwordData[i] & (0xFFFFFFFF << ((8 - remainSize * 2) * 4));
-        ofs << std::hex << std::setw(8) << std::setfill('0') << +lastWord << std::endl;
-    }
-
-    ofs.close();
-
-    return MOS_STATUS_SUCCESS;
+    // The text is formatted by the dump service thread
+    return MOS_DumpService_WriteFile(m_outputFileName.c_str(), data, size, MOS_DUMP_FORMAT_HEX_DWORDS);
 }
 
 #endif  // USE_CODECHAL_DEBUG_TOOL
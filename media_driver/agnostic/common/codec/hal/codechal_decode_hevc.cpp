@@ -29,6 +29,7 @@
 #include "codechal_secure_decode.h"
 #include "codechal_cenc_decode.h"
 #include "codechal_decode_hevc.h"
+#include "codechal_decode_slice_batch.h"
 #include "codechal_mmc_decode_hevc.h"
 #include "codechal_decode_nv12top010.h"
 #include "media_interfaces_nv12top010.h"
@@ -102,6 +103,12 @@ MOS_STATUS CodechalDecodeHevc::AllocateResources_FixedSizes()
                 "Failed to allocate Dmem Buffer.");
         }
     }
+    else
+    {
+        // Second level batch buffers for long format frames with many slices
+        m_sliceBatch = MOS_New(CodechalDecodeSliceBatch, m_hwInterface);
+        CODECHAL_DECODE_CHK_NULL_RETURN(m_sliceBatch);
+    }
 
     return eStatus;
 }
@@ -2100,6 +2107,29 @@ MOS_STATUS CodechalDecodeHevc::SendSliceLongFormat(
     return eStatus;
 }
 
+MOS_STATUS CodechalDecodeHevc::SendSliceLongFormatTask(
+    void                            *context,
+    uint32_t                        index,
+    PMOS_COMMAND_BUFFER             cmdBuffer)
+{
+    CodechalDecodeHevc *hevcState = (CodechalDecodeHevc *)context;
+
+    CODECHAL_DECODE_CHK_NULL_RETURN(hevcState);
+
+    MHW_VDBOX_HEVC_SLICE_STATE hevcSliceState;
+    MOS_ZeroMemory(&hevcSliceState, sizeof(hevcSliceState));
+    hevcSliceState.presDataBuffer               = hevcState->bCopyDataBufferInUse ? &hevcState->resCopyDataBuffer : &hevcState->resDataBuffer;
+    hevcSliceState.pHevcPicParams               = hevcState->pHevcPicParams;
+    hevcSliceState.ppHevcRefList                = hevcState->pHevcRefList;
+    hevcSliceState.pRefIdxMapping               = &hevcState->RefIdxMapping[0];
+    hevcSliceState.pHevcSliceParams             = hevcState->pHevcSliceParams + index;
+    hevcSliceState.dwLength                     = hevcSliceState.pHevcSliceParams->slice_data_size;
+    hevcSliceState.dwSliceIndex                 = index;
+    hevcSliceState.bLastSlice                   = (index == (hevcState->u32NumSlices - 1));
+
+    return hevcState->SendSliceLongFormat(cmdBuffer, &hevcSliceState);
+}
+
 MOS_STATUS CodechalDecodeHevc::DecodePrimitiveLevel()
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
@@ -2169,6 +2199,17 @@ MOS_STATUS CodechalDecodeHevc::DecodePrimitiveLevel()
                 &secondLevelBatchBuffer));
         }
     }
+    else if (!bShortFormatInUse && m_secureDecoder == nullptr &&
+        m_sliceBatch && m_sliceBatch->IsEnabled(u32NumSlices))
+    {
+        // Frames with many slices have their slice commands prepared in parallel in a second level batch
+        CODECHAL_DECODE_CHK_STATUS_RETURN(m_sliceBatch->Execute(
+            cmdBufferInUse,
+            u32NumSlices,
+            m_standardDecodeSizeNeeded,
+            SendSliceLongFormatTask,
+            this));
+    }
     else
     {
         // Setup static slice state parameters
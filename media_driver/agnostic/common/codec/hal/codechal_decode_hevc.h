@@ -386,6 +386,25 @@ public:
         PMOS_COMMAND_BUFFER             cmdBuffer,
         PMHW_VDBOX_HEVC_SLICE_STATE     hevcSliceState);
 
+    //!
+    //! \brief    Send long format Slice level commands of one slice of the frame
+    //! \details  Called by the slice batch tasks, possibly from several threads at once
+    //!
+    //! \param    [in] context
+    //!           Pointer to the HEVC decoder
+    //! \param    [in] index
+    //!           Index of the slice
+    //! \param    [out] cmdBuffer
+    //!           Pointer to Command buffer
+    //!
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    static MOS_STATUS   SendSliceLongFormatTask (
+        void                            *context,
+        uint32_t                        index,
+        PMOS_COMMAND_BUFFER             cmdBuffer);
+
     //!
     //! \brief    Determine Decode Phase
     //! \details  Determine decode phase in hevc decode
@@ -0,0 +1,235 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//!
+//! \file     codechal_decode_slice_batch.cpp
+//! \brief    Implements the second level batch buffer that slice commands are prepared in.
+//!
+
+#include "codechal_decoder.h"
+#include "codechal_decode_slice_batch.h"
+#include "mos_task_pool.h"
+
+CodechalDecodeSliceBatch::CodechalDecodeSliceBatch(CodechalHwInterface *hwInterface)
+{
+    CODECHAL_DECODE_FUNCTION_ENTER;
+
+    MOS_ZeroMemory(m_batchBuffers, sizeof(m_batchBuffers));
+
+    m_hwInterface = hwInterface;
+    if (m_hwInterface)
+    {
+        m_osInterface = m_hwInterface->GetOsInterface();
+        m_miInterface = m_hwInterface->GetMiInterface();
+    }
+}
+
+CodechalDecodeSliceBatch::~CodechalDecodeSliceBatch()
+{
+    CODECHAL_DECODE_FUNCTION_ENTER;
+
+    for (uint32_t i = 0; i < CODECHAL_DECODE_SLICE_BATCH_NUM_BUFFERS; i++)
+    {
+        if (!Mos_ResourceIsNull(&m_batchBuffers[i].OsResource))
+        {
+            Mhw_FreeBb(m_osInterface, &m_batchBuffers[i], nullptr);
+        }
+    }
+
+    MOS_FreeMemory(m_regions);
+}
+
+bool CodechalDecodeSliceBatch::IsEnabled(uint32_t numSlices)
+{
+    if (numSlices < CODECHAL_DECODE_SLICE_BATCH_MIN_SLICES ||
+        m_osInterface == nullptr ||
+        m_miInterface == nullptr ||
+        MOS_TaskPool_GetThreadCount() < 2)
+    {
+        return false;
+    }
+
+    // Protection commands are not known to be safe to build outside of the submitting thread
+    if (m_osInterface->osCpInterface && m_osInterface->osCpInterface->IsCpEnabled())
+    {
+        return false;
+    }
+
+    return true;
+}
+
+MOS_STATUS CodechalDecodeSliceBatch::Reserve(uint32_t size, uint32_t numRegions)
+{
+    CODECHAL_DECODE_FUNCTION_ENTER;
+
+    if (numRegions > m_regionsAllocated)
+    {
+        MOS_FreeMemory(m_regions);
+        m_regionsAllocated = 0;
+
+        m_regions = (Region *)MOS_AllocAndZeroMemory(numRegions * sizeof(Region));
+        CODECHAL_DECODE_CHK_NULL_RETURN(m_regions);
+        m_regionsAllocated = numRegions;
+    }
+
+    PMHW_BATCH_BUFFER batchBuffer = &m_batchBuffers[m_currBatchBuffer];
+    if (!Mos_ResourceIsNull(&batchBuffer->OsResource) && batchBuffer->iSize >= (int32_t)size)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    if (!Mos_ResourceIsNull(&batchBuffer->OsResource))
+    {
+        Mhw_FreeBb(m_osInterface, batchBuffer, nullptr);
+    }
+
+    MOS_ZeroMemory(batchBuffer, sizeof(MHW_BATCH_BUFFER));
+    CODECHAL_DECODE_CHK_STATUS_RETURN(Mhw_AllocateBb(
+        m_osInterface,
+        batchBuffer,
+        nullptr,
+        MOS_ALIGN_CEIL(size, CODECHAL_PAGE_SIZE)));
+    batchBuffer->bSecondLevel = true;
+
+    return MOS_STATUS_SUCCESS;
+}
+
+void CodechalDecodeSliceBatch::SendRegion(void *context, uint32_t index)
+{
+    CodechalDecodeSliceBatch *sliceBatch = (CodechalDecodeSliceBatch *)context;
+    Region                   *region     = &sliceBatch->m_regions[index];
+
+    // The region is the whole command buffer as far as the MHW commands are concerned
+    MOS_COMMAND_BUFFER cmdBuffer;
+    MOS_ZeroMemory(&cmdBuffer, sizeof(cmdBuffer));
+    cmdBuffer.pCmdBase   = (uint32_t *)(sliceBatch->m_data + region->offset);
+    cmdBuffer.pCmdPtr    = cmdBuffer.pCmdBase;
+    cmdBuffer.iOffset    = 0;
+    cmdBuffer.iRemaining = (int32_t)region->size;
+
+    region->status = MOS_STATUS_SUCCESS;
+    for (uint32_t i = 0; i < region->numSlices; i++)
+    {
+        region->status = sliceBatch->m_sendSlice(
+            sliceBatch->m_context,
+            region->firstSlice + i,
+            &cmdBuffer);
+        if (region->status != MOS_STATUS_SUCCESS)
+        {
+            break;
+        }
+    }
+
+    region->used = (uint32_t)cmdBuffer.iOffset;
+}
+
+MOS_STATUS CodechalDecodeSliceBatch::Execute(
+    PMOS_COMMAND_BUFFER             cmdBuffer,
+    uint32_t                        numSlices,
+    uint32_t                        maxSliceSize,
+    PFN_CODECHAL_DECODE_SEND_SLICE  sendSlice,
+    void                            *context)
+{
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+    CODECHAL_DECODE_FUNCTION_ENTER;
+
+    CODECHAL_DECODE_CHK_NULL_RETURN(cmdBuffer);
+    CODECHAL_DECODE_CHK_NULL_RETURN(sendSlice);
+    CODECHAL_DECODE_CHK_NULL_RETURN(m_osInterface);
+    CODECHAL_DECODE_CHK_NULL_RETURN(m_miInterface);
+
+    if (numSlices == 0)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    // The layout only depends on the slice count, every region but the last holds the same number of slices
+    uint32_t batchEndSize = m_hwInterface->m_sizeOfCmdBatchBufferEnd;
+    uint32_t numRegions   = MOS_ROUNDUP_DIVIDE(numSlices, CODECHAL_DECODE_SLICE_BATCH_SLICES_PER_REGION);
+    uint32_t regionPitch  = MOS_ALIGN_CEIL(
+        CODECHAL_DECODE_SLICE_BATCH_SLICES_PER_REGION * maxSliceSize + batchEndSize,
+        MHW_CACHELINE_SIZE);
+    uint32_t lastSlices   = numSlices - (numRegions - 1) * CODECHAL_DECODE_SLICE_BATCH_SLICES_PER_REGION;
+    uint32_t totalSize    = (numRegions - 1) * regionPitch + lastSlices * maxSliceSize + batchEndSize;
+
+    CODECHAL_DECODE_CHK_STATUS_RETURN(Reserve(totalSize, numRegions));
+
+    for (uint32_t i = 0; i < numRegions; i++)
+    {
+        Region *region     = &m_regions[i];
+        region->firstSlice = i * CODECHAL_DECODE_SLICE_BATCH_SLICES_PER_REGION;
+        region->numSlices  = (i == numRegions - 1) ? lastSlices : CODECHAL_DECODE_SLICE_BATCH_SLICES_PER_REGION;
+        region->offset     = i * regionPitch;
+        region->size       = region->numSlices * maxSliceSize;
+        region->used       = 0;
+        region->status     = MOS_STATUS_UNKNOWN;
+    }
+
+    PMHW_BATCH_BUFFER batchBuffer = &m_batchBuffers[m_currBatchBuffer];
+    CODECHAL_DECODE_CHK_STATUS_RETURN(Mhw_LockBb(m_osInterface, batchBuffer));
+
+    m_data      = batchBuffer->pData;
+    m_sendSlice = sendSlice;
+    m_context   = context;
+
+    eStatus = MOS_TaskPool_Run(SendRegion, this, numRegions, MOS_TaskPool_GetThreadCount());
+
+    m_data      = nullptr;
+    m_sendSlice = nullptr;
+    m_context   = nullptr;
+
+    // Report the failure of the earliest slice, as the serial path would
+    for (uint32_t i = 0; i < numRegions && eStatus == MOS_STATUS_SUCCESS; i++)
+    {
+        eStatus = m_regions[i].status;
+    }
+
+    for (uint32_t i = 0; i < numRegions && eStatus == MOS_STATUS_SUCCESS; i++)
+    {
+        batchBuffer->iCurrent   = (int32_t)(m_regions[i].offset + m_regions[i].used);
+        batchBuffer->iRemaining = batchBuffer->iSize - batchBuffer->iCurrent;
+        eStatus = m_miInterface->AddMiBatchBufferEnd(nullptr, batchBuffer);
+    }
+
+    MOS_STATUS unlockStatus = Mhw_UnlockBb(m_osInterface, batchBuffer, true);
+    if (eStatus == MOS_STATUS_SUCCESS)
+    {
+        eStatus = unlockStatus;
+    }
+    CODECHAL_DECODE_CHK_STATUS_RETURN(eStatus);
+
+    for (uint32_t i = 0; i < numRegions; i++)
+    {
+        batchBuffer->dwOffset = m_regions[i].offset;
+        eStatus = m_miInterface->AddMiBatchBufferStartCmd(cmdBuffer, batchBuffer);
+        if (eStatus != MOS_STATUS_SUCCESS)
+        {
+            break;
+        }
+    }
+    batchBuffer->dwOffset = 0;
+
+    m_currBatchBuffer = (m_currBatchBuffer + 1) % CODECHAL_DECODE_SLICE_BATCH_NUM_BUFFERS;
+
+    return eStatus;
+}
@@ -0,0 +1,152 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//!
+//! \file     codechal_decode_slice_batch.h
+//! \brief    Defines the second level batch buffer that slice commands are prepared in.
+//! \details  Slice level commands of frames with many slices are written by the MOS task pool,
+//!           each task owning a fixed region of the batch buffer sized from the slice count.
+//!           The primary command buffer calls every region in slice order, so the commands
+//!           seen by the GPU do not depend on the number of threads or their scheduling.
+//!           Used by HEVC long format decode, whose slice commands the short format path
+//!           already runs from a second level batch. AVC slice commands stay in the
+//!           primary buffer.
+//!
+
+#ifndef __CODECHAL_DECODE_SLICE_BATCH_H__
+#define __CODECHAL_DECODE_SLICE_BATCH_H__
+
+#include "codechal_hw.h"
+
+#define CODECHAL_DECODE_SLICE_BATCH_NUM_BUFFERS         4       //!< Batch buffers used in turn by consecutive frames
+#define CODECHAL_DECODE_SLICE_BATCH_MIN_SLICES          32      //!< Frames with fewer slices add their commands to the primary buffer
+#define CODECHAL_DECODE_SLICE_BATCH_SLICES_PER_REGION   16      //!< Slices written by one task
+
+//!
+//! \brief    Add the commands of one slice
+//! \param    [in] context
+//!           Context passed to CodechalDecodeSliceBatch::Execute
+//! \param    [in] index
+//!           Index of the slice in the batch
+//! \param    [in,out] cmdBuffer
+//!           Region of the batch buffer to add the commands to
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if success, else fail reason
+//!
+typedef MOS_STATUS (*PFN_CODECHAL_DECODE_SEND_SLICE)(
+    void                *context,
+    uint32_t            index,
+    PMOS_COMMAND_BUFFER cmdBuffer);
+
+//!
+//! \class CodechalDecodeSliceBatch
+//! \brief Second level batch buffers filled with slice commands by several threads
+//!
+class CodechalDecodeSliceBatch
+{
+public:
+    //!
+    //! \brief    Constructor
+    //! \param    [in] hwInterface
+    //!           Hardware interface
+    //!
+    CodechalDecodeSliceBatch(CodechalHwInterface *hwInterface);
+
+    //!
+    //! \brief    Destructor
+    //!
+    ~CodechalDecodeSliceBatch();
+
+    //!
+    //! \brief    Check whether the slices of a frame should be prepared in parallel
+    //! \details  Few slices, a single thread or protected content keep the commands in
+    //!           the primary buffer
+    //! \param    [in] numSlices
+    //!           Number of slices to send
+    //! \return   bool
+    //!           true if Execute should be used
+    //!
+    bool IsEnabled(uint32_t numSlices);
+
+    //!
+    //! \brief    Prepare the slice commands and call them from the primary buffer
+    //! \param    [in,out] cmdBuffer
+    //!           Primary command buffer, receives one MI_BATCH_BUFFER_START per region
+    //! \param    [in] numSlices
+    //!           Number of slices to send
+    //! \param    [in] maxSliceSize
+    //!           Upper bound of the command size of one slice
+    //! \param    [in] sendSlice
+    //!           Callback adding the commands of one slice, called from several threads
+    //! \param    [in] context
+    //!           Context passed to sendSlice
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else the first failure in slice order
+    //!
+    MOS_STATUS Execute(
+        PMOS_COMMAND_BUFFER             cmdBuffer,
+        uint32_t                        numSlices,
+        uint32_t                        maxSliceSize,
+        PFN_CODECHAL_DECODE_SEND_SLICE  sendSlice,
+        void                            *context);
+
+private:
+    //!
+    //! \brief    Slices of one task and where their commands go
+    //!
+    struct Region
+    {
+        uint32_t    firstSlice;
+        uint32_t    numSlices;
+        uint32_t    offset;                 //!< Offset of the region in the batch buffer
+        uint32_t    size;                   //!< Bytes available for the slice commands
+        uint32_t    used;                   //!< Bytes written by the task
+        MOS_STATUS  status;
+    };
+
+    //!
+    //! \brief    Task pool callback writing the slices of one region
+    //!
+    static void SendRegion(void *context, uint32_t index);
+
+    //!
+    //! \brief    Make sure the current batch buffer and region array are large enough
+    //!
+    MOS_STATUS Reserve(uint32_t size, uint32_t numRegions);
+
+    CodechalHwInterface             *m_hwInterface  = nullptr;
+    PMOS_INTERFACE                  m_osInterface   = nullptr;
+    MhwMiInterface                  *m_miInterface  = nullptr;
+
+    MHW_BATCH_BUFFER                m_batchBuffers[CODECHAL_DECODE_SLICE_BATCH_NUM_BUFFERS];
+    uint32_t                        m_currBatchBuffer = 0;
+
+    Region                          *m_regions      = nullptr;
+    uint32_t                        m_regionsAllocated = 0;
+
+    // Valid during Execute
+    uint8_t                         *m_data         = nullptr;
+    PFN_CODECHAL_DECODE_SEND_SLICE  m_sendSlice     = nullptr;
+    void                            *m_context      = nullptr;
+};
+
+#endif  // __CODECHAL_DECODE_SLICE_BATCH_H__
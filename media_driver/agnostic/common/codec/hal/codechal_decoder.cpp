@@ -28,6 +28,7 @@
 #include "codechal_decoder.h"
 #include "codechal_secure_decode.h"
 #include "codechal_cenc_decode.h"
+#include "codechal_decode_slice_batch.h"
 #include "mos_solo_generic.h"
 # include "codechal_debug.h"
 
@@ -598,6 +599,9 @@ CodechalDecode::~CodechalDecode()
     MOS_Delete(m_secureDecoder);
     m_secureDecoder = nullptr;
 
+    MOS_Delete(m_sliceBatch);
+    m_sliceBatch = nullptr;
+
     if (m_mmc)
     {
         MOS_Delete(m_mmc);
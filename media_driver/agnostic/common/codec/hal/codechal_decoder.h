@@ -38,6 +38,7 @@
 
 class CodechalSecureDecode;
 class CodechalCencDecode;
+class CodechalDecodeSliceBatch;
 
 //------------------------------------------------------------------------------
 // Macros specific to MOS_CODEC_SUBCOMP_DECODE sub-comp
@@ -906,6 +907,9 @@ protected:
     //! \brief Security Decode
     CodechalSecureDecode        *m_secureDecoder    = nullptr;
 
+    //! \brief Second level batch buffers for slice commands prepared in parallel
+    CodechalDecodeSliceBatch    *m_sliceBatch       = nullptr;
+
     //! \brief WA table
     MEDIA_WA_TABLE              *m_waTable           = nullptr;
     //! \brief SKU table
@@ -1625,6 +1625,8 @@ MOS_STATUS CodechalEncodeMpeg2::FreeEncResources()
         }
     }
 
+    FreeMbObjectCaches();
+
     return eStatus;
 
 }
@@ -3245,164 +3247,339 @@ MOS_STATUS CodechalEncodeMpeg2::EncodeBrcInitResetKernel()
     return eStatus;
 }
 
-MOS_STATUS CodechalEncodeMpeg2::SendMediaObjectsBB(
-    PMHW_BATCH_BUFFER batchBuffer,
-    bool mbEncIFrameDistEnabled)
+MOS_STATUS CodechalEncodeMpeg2::GetMbWalkMap(
+    uint16_t    widthInMb,
+    uint16_t    heightInMb,
+    uint32_t    walkingPattern,
+    uint16_t    **mbOffset)
 {
     MOS_STATUS  eStatus = MOS_STATUS_SUCCESS;
 
     CODECHAL_ENCODE_FUNCTION_ENTER;
 
-    uint16_t frameFieldHeightInMb;
-    uint16_t widthInMb;
-    uint32_t numSlice;
-    bool bDistortionCalc;
-    if(mbEncIFrameDistEnabled)
-    {
-        frameFieldHeightInMb = (uint16_t)m_downscaledFrameFieldHeightInMb4x;
-        widthInMb = (uint16_t)m_downscaledWidthInMb4x;
-        numSlice  = 1;
-        bDistortionCalc = true;
-    }
-    else
-    {
-        frameFieldHeightInMb = m_frameFieldHeightInMb;
-        widthInMb = m_picWidthInMb;
-        numSlice  = m_numSlices;
-        bDistortionCalc = false;
-    }
-    uint32_t numObjs = frameFieldHeightInMb * widthInMb;
-    uint16_t *mBOffset = nullptr;
+    CODECHAL_ENCODE_CHK_NULL_RETURN(mbOffset);
 
-    // use Mb Walker
-    mBOffset = (uint16_t *)MOS_AllocAndZeroMemory(numObjs * sizeof(uint16_t));
-    if (!mBOffset)
+    // Look the map up, the slot to replace is an empty one or else the least recently used
+    CodechalEncodeMpeg2MbWalkMap *walkMap = nullptr;
+    for (uint32_t i = 0; i < CODECHAL_ENCODE_MPEG2_MB_WALK_CACHE_SIZE; i++)
     {
-        CODECHAL_ENCODE_ASSERT(false);
-        MOS_ZeroMemory(
-            batchBuffer->pData,
-            batchBuffer->iCurrent + batchBuffer->iRemaining);
-        eStatus = MOS_STATUS_NO_SPACE;
-        return eStatus;
-    }
+        CodechalEncodeMpeg2MbWalkMap *entry = &m_mbWalkMaps[i];
+        if (entry->m_mbOffset                       &&
+            entry->m_widthInMb      == widthInMb    &&
+            entry->m_heightInMb     == heightInMb   &&
+            entry->m_walkingPattern == walkingPattern)
+        {
+            entry->m_lastUse = m_mbObjectCacheTick;
+            *mbOffset        = entry->m_mbOffset;
+            return eStatus;
+        }
 
-    uint32_t walkingPattern = 0;
-    if (m_pictureCodingType == I_TYPE )
-    {
-        walkingPattern = codechalHorizontalRasterScan;
-    }
-    else if (m_pictureCodingType == P_TYPE)
-    {
-        walkingPattern = codechalHorizontal45DegreeScan;
-    }
-    else // B_TYPE
-    {
-        walkingPattern = codechalVerticalRasterScan;
+        if (walkMap == nullptr ||
+            (walkMap->m_mbOffset && (entry->m_mbOffset == nullptr || entry->m_lastUse < walkMap->m_lastUse)))
+        {
+            walkMap = entry;
+        }
     }
+
+    uint32_t numObjs = widthInMb * heightInMb;
+
+    MOS_FreeMemory(walkMap->m_mbOffset);
+    walkMap->m_mbOffset = (uint16_t *)MOS_AllocAndZeroMemory(numObjs * sizeof(uint16_t));
+    CODECHAL_ENCODE_CHK_NULL_RETURN(walkMap->m_mbOffset);
+
     switch (walkingPattern)
     {
     case codechalHorizontal45DegreeScan:
-        CodecHalEncode_MBWalker_45(widthInMb, frameFieldHeightInMb, mBOffset);
+        CodecHalEncode_MBWalker_45(widthInMb, heightInMb, walkMap->m_mbOffset);
         break;
     case codechalHorizontalRasterScan:
-        CodecHalEncode_MBWalker_RasterScan(widthInMb, frameFieldHeightInMb, mBOffset);
+        CodecHalEncode_MBWalker_RasterScan(widthInMb, heightInMb, walkMap->m_mbOffset);
         break;
     case codechalVerticalRasterScan:
-        CodecHalEncode_MBWalker_VerticalScan(widthInMb, frameFieldHeightInMb, mBOffset);
+        CodecHalEncode_MBWalker_VerticalScan(widthInMb, heightInMb, walkMap->m_mbOffset);
         break;
     default:
+        MOS_FreeMemory(walkMap->m_mbOffset);
+        walkMap->m_mbOffset = nullptr;
         eStatus = MOS_STATUS_UNKNOWN;
-        MOS_FreeMemory(mBOffset);
-        return eStatus;;
-        break;
+        return eStatus;
     }
 
-    auto slcData = m_slcData;
-    auto slcParams = m_sliceParams;
-    auto slcRecord = (SliceRecord *)MOS_AllocAndZeroMemory(sizeof(SliceRecord)* (numObjs));
-    if (!slcRecord)
+    walkMap->m_widthInMb        = widthInMb;
+    walkMap->m_heightInMb       = heightInMb;
+    walkMap->m_walkingPattern   = walkingPattern;
+    walkMap->m_lastUse          = m_mbObjectCacheTick;
+    *mbOffset                   = walkMap->m_mbOffset;
+
+    return eStatus;
+}
+
+MOS_STATUS CodechalEncodeMpeg2::GetMbSliceRecords(
+    bool                                distortionCalc,
+    uint16_t                            widthInMb,
+    uint16_t                            heightInMb,
+    uint32_t                            numSlice,
+    CodechalEncodeMpeg2MbSliceRecords   **records)
+{
+    MOS_STATUS  eStatus = MOS_STATUS_SUCCESS;
+
+    CODECHAL_ENCODE_FUNCTION_ENTER;
+
+    CODECHAL_ENCODE_CHK_NULL_RETURN(records);
+
+    auto     cache       = &m_mbSliceRecords[distortionCalc ? 1 : 0];
+    bool     withRecords = (m_codecFunction != CODECHAL_FUNCTION_ENC);
+    // The distortion pass always is one slice over the whole picture
+    uint32_t layoutSize  = (withRecords && !distortionCalc) ? numSlice * 2 : 0;
+    uint32_t numObjs     = widthInMb * heightInMb;
+
+    if (layoutSize)
+    {
+        CODECHAL_ENCODE_CHK_NULL_RETURN(m_sliceParams);
+        CODECHAL_ENCODE_CHK_NULL_RETURN(m_slcData);
+    }
+
+    bool match = cache->m_slcRecord                &&
+                 cache->m_widthInMb   == widthInMb  &&
+                 cache->m_heightInMb  == heightInMb &&
+                 cache->m_withRecords == withRecords &&
+                 cache->m_numSlices   == numSlice;
+    for (uint32_t i = 0; match && i < layoutSize / 2; i++)
+    {
+        match = cache->m_sliceLayout[2 * i]     == m_sliceParams[i].m_numMbsForSlice &&
+                cache->m_sliceLayout[2 * i + 1] == (uint32_t)(m_slcData[i].SliceGroup & (SLICE_GROUP_START | SLICE_GROUP_END));
+    }
+
+    if (match)
     {
-        MOS_FreeMemory(mBOffset);
-        eStatus = MOS_STATUS_NO_SPACE;
+        *records = cache;
         return eStatus;
     }
 
-    int32_t mbX, mbY;
+    if (cache->m_numRecords != numObjs)
+    {
+        MOS_FreeMemory(cache->m_slcRecord);
+        cache->m_slcRecord  = (SliceRecord *)MOS_AllocMemory(sizeof(SliceRecord) * numObjs);
+        cache->m_numRecords = cache->m_slcRecord ? numObjs : 0;
+        CODECHAL_ENCODE_CHK_NULL_RETURN(cache->m_slcRecord);
+    }
+    if (cache->m_layoutAllocated < layoutSize)
+    {
+        MOS_FreeMemory(cache->m_sliceLayout);
+        cache->m_sliceLayout     = (uint32_t *)MOS_AllocMemory(sizeof(uint32_t) * layoutSize);
+        cache->m_layoutAllocated = cache->m_sliceLayout ? layoutSize : 0;
+        if (cache->m_sliceLayout == nullptr)
+        {
+            // Leave no stale records that could match the next frame
+            MOS_FreeMemory(cache->m_slcRecord);
+            cache->m_slcRecord  = nullptr;
+            cache->m_numRecords = 0;
+            return MOS_STATUS_NO_SPACE;
+        }
+    }
 
-    if (m_codecFunction != CODECHAL_FUNCTION_ENC)
+    auto slcRecord = cache->m_slcRecord;
+    MOS_ZeroMemory(slcRecord, sizeof(SliceRecord) * numObjs);
+
+    if (withRecords)
     {
-        uint32_t numMbsForSlice;
-        int32_t numMbLeftInRow;
+        auto     slcData   = m_slcData;
+        auto     slcParams = m_sliceParams;
+        uint32_t written   = 0;
+
         // Populate slcRecord lookup table
-        auto pSlcRecordStart = slcRecord;
         for (uint32_t i = 0; i < numSlice; i++)
         {
-            if (bDistortionCalc)
-            {
-                mbY = 0;
-                mbX = 0;
-                numMbLeftInRow = widthInMb;
-                numMbsForSlice = widthInMb * frameFieldHeightInMb;
-            }
-            else
-            {
-                mbY = slcParams->m_firstMbX;
-                mbX = slcParams->m_firstMbX;
-                numMbLeftInRow = widthInMb - mbX;
-                numMbsForSlice = slcParams->m_numMbsForSlice;
-            }
+            uint32_t numMbsForSlice = distortionCalc ? numObjs : slcParams->m_numMbsForSlice;
 
             // make sure enough memory is allocated
             CODECHAL_ENCODE_ASSERT((numMbsForSlice * numSlice) <= numObjs);
 
-            for (uint32_t j = 0; j < numMbsForSlice; j++)
+            for (uint32_t j = 0; j < numMbsForSlice && written < numObjs; j++)
             {
                 if (j == 0)
                 {
                     slcRecord->DW1.m_firstMbInSlice = 0x40;
-                    slcRecord->DW1.m_firstMbInSliceGroup = (bDistortionCalc || (slcData->SliceGroup & SLICE_GROUP_START)) ? 0x01 : 0;
+                    slcRecord->DW1.m_firstMbInSliceGroup = (distortionCalc || (slcData->SliceGroup & SLICE_GROUP_START)) ? 0x01 : 0;
                 }
                 if (j == numMbsForSlice - 1)
                 {
                     slcRecord->DW1.m_lastMbInSlice = 0x80;
-                    if (bDistortionCalc || (slcData->SliceGroup & SLICE_GROUP_END))
+                    if (distortionCalc || (slcData->SliceGroup & SLICE_GROUP_END))
                     {
                         slcRecord->DW1.m_lastMbInSliceGroup = 0x04;
                         slcRecord->DW2.m_value = 0x05000000;
                     }
                 }
-                mbX++;
                 slcRecord++;
-                numMbLeftInRow --;
-                if (numMbLeftInRow  <= 0)
-                {
-                    mbX = 0;
-                    mbY++;
-                    numMbLeftInRow = widthInMb;
-                }
+                written++;
+            }
+
+            if (!distortionCalc)
+            {
+                cache->m_sliceLayout[2 * i]     = slcParams->m_numMbsForSlice;
+                cache->m_sliceLayout[2 * i + 1] = slcData->SliceGroup & (SLICE_GROUP_START | SLICE_GROUP_END);
             }
             slcParams++;
             slcData++;
         }
+    }
+
+    cache->m_widthInMb      = widthInMb;
+    cache->m_heightInMb     = heightInMb;
+    cache->m_withRecords    = withRecords;
+    cache->m_numSlices      = numSlice;
+    // 0 is never used, it is the generation of an empty batch slot
+    if (++m_mbSliceRecordsGeneration == 0)
+    {
+        m_mbSliceRecordsGeneration++;
+    }
+    cache->m_generation     = m_mbSliceRecordsGeneration;
+    *records                = cache;
+
+    return eStatus;
+}
+
+void CodechalEncodeMpeg2::FreeMbObjectCaches()
+{
+    for (uint32_t i = 0; i < CODECHAL_ENCODE_MPEG2_MB_WALK_CACHE_SIZE; i++)
+    {
+        MOS_FreeMemory(m_mbWalkMaps[i].m_mbOffset);
+        m_mbWalkMaps[i] = CodechalEncodeMpeg2MbWalkMap();
+    }
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        MOS_FreeMemory(m_mbSliceRecords[i].m_sliceLayout);
+        MOS_FreeMemory(m_mbSliceRecords[i].m_slcRecord);
+        m_mbSliceRecords[i] = CodechalEncodeMpeg2MbSliceRecords();
+    }
+
+    for (uint32_t i = 0; i < CODECHAL_ENCODE_MPEG2_MB_OBJECT_CACHE_SIZE; i++)
+    {
+        MOS_FreeMemory(m_mbObjectBatches[i].m_cmds);
+        m_mbObjectBatches[i] = CodechalEncodeMpeg2MbObjectBatch();
+    }
+}
+
+MOS_STATUS CodechalEncodeMpeg2::SendMediaObjectsBB(
+    PMHW_BATCH_BUFFER batchBuffer,
+    bool mbEncIFrameDistEnabled)
+{
+    MOS_STATUS  eStatus = MOS_STATUS_SUCCESS;
+
+    CODECHAL_ENCODE_FUNCTION_ENTER;
+
+    CODECHAL_ENCODE_CHK_NULL_RETURN(batchBuffer);
+
+    uint16_t frameFieldHeightInMb;
+    uint16_t widthInMb;
+    uint32_t numSlice;
+    bool bDistortionCalc;
+    if(mbEncIFrameDistEnabled)
+    {
+        frameFieldHeightInMb = (uint16_t)m_downscaledFrameFieldHeightInMb4x;
+        widthInMb = (uint16_t)m_downscaledWidthInMb4x;
+        numSlice  = 1;
+        bDistortionCalc = true;
+    }
+    else
+    {
+        frameFieldHeightInMb = m_frameFieldHeightInMb;
+        widthInMb = m_picWidthInMb;
+        numSlice  = m_numSlices;
+        bDistortionCalc = false;
+    }
+    uint32_t numObjs = frameFieldHeightInMb * widthInMb;
+
+    uint32_t walkingPattern = 0;
+    if (m_pictureCodingType == I_TYPE )
+    {
+        walkingPattern = codechalHorizontalRasterScan;
+    }
+    else if (m_pictureCodingType == P_TYPE)
+    {
+        walkingPattern = codechalHorizontal45DegreeScan;
+    }
+    else // B_TYPE
+    {
+        walkingPattern = codechalVerticalRasterScan;
+    }
+    bool scoreboardEnable = (m_pictureCodingType == I_TYPE) ? false : m_useHwScoreboard;
+
+    m_mbObjectCacheTick++;
+
+    CodechalEncodeMpeg2MbSliceRecords *records = nullptr;
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(GetMbSliceRecords(
+        bDistortionCalc,
+        widthInMb,
+        frameFieldHeightInMb,
+        numSlice,
+        &records));
+
+    // The MEDIA_OBJECT commands depend only on the walk, the slice records and the
+    // scoreboard setup, none of them carries a per frame field or a resource address
+    CodechalEncodeMpeg2MbObjectBatch *mbObjects = nullptr;
+    for (uint32_t i = 0; i < CODECHAL_ENCODE_MPEG2_MB_OBJECT_CACHE_SIZE; i++)
+    {
+        CodechalEncodeMpeg2MbObjectBatch *entry = &m_mbObjectBatches[i];
+        if (entry->m_cmdsSize                                        &&
+            entry->m_widthInMb          == widthInMb                 &&
+            entry->m_heightInMb         == frameFieldHeightInMb      &&
+            entry->m_walkingPattern     == walkingPattern            &&
+            entry->m_scoreboardEnable   == scoreboardEnable          &&
+            entry->m_halfSliceSelect    == m_halfSliceSelect         &&
+            entry->m_recordsGeneration  == records->m_generation)
+        {
+            entry->m_lastUse = m_mbObjectCacheTick;
+            CODECHAL_ENCODE_CHK_STATUS_RETURN(Mhw_AddCommandBB(
+                batchBuffer,
+                entry->m_cmds,
+                entry->m_cmdsSize));
+
+            return m_miInterface->AddMiBatchBufferEnd(nullptr, batchBuffer);
+        }
+
+        if (mbObjects == nullptr ||
+            (mbObjects->m_cmdsSize && (entry->m_cmdsSize == 0 || entry->m_lastUse < mbObjects->m_lastUse)))
+        {
+            mbObjects = entry;
+        }
+    }
 
-        slcRecord = pSlcRecordStart;
+    // use Mb Walker
+    uint16_t *mBOffset = nullptr;
+    eStatus = GetMbWalkMap(widthInMb, frameFieldHeightInMb, walkingPattern, &mBOffset);
+    if (eStatus != MOS_STATUS_SUCCESS)
+    {
+        CODECHAL_ENCODE_ASSERT(false);
+        if (batchBuffer->pData)
+        {
+            MOS_ZeroMemory(
+                batchBuffer->pData,
+                batchBuffer->iCurrent + batchBuffer->iRemaining);
+        }
+        return eStatus;
     }
 
+    auto slcRecord = records->m_slcRecord;
+
     MHW_MEDIA_OBJECT_PARAMS mediaObjectParams;
     MOS_ZeroMemory(&mediaObjectParams, sizeof(mediaObjectParams));
-    mediaObjectParams.VfeScoreboard.ScoreboardEnable    =
-        (m_pictureCodingType == I_TYPE )? false:m_useHwScoreboard;;
+    mediaObjectParams.VfeScoreboard.ScoreboardEnable    = scoreboardEnable;
     mediaObjectParams.dwHalfSliceDestinationSelect      = m_halfSliceSelect;
     MediaObjectInlineDataMpeg2  mediaObjectInlineData;
     MOS_ZeroMemory(&mediaObjectInlineData, sizeof(mediaObjectInlineData));
     mediaObjectParams.pInlineData                       = &mediaObjectInlineData;
     mediaObjectParams.dwInlineDataSize                  = sizeof(mediaObjectInlineData);
 
+    int32_t cmdsStart = batchBuffer->iCurrent;
+
     for (uint32_t i = 0; i < numObjs; i++)
     {
         uint32_t mbOffset = mBOffset[i];
-        mbX = mbOffset % widthInMb;
-        mbY = mbOffset / widthInMb;
+        int32_t mbX = mbOffset % widthInMb;
+        int32_t mbY = mbOffset / widthInMb;
         uint32_t idx = mbX + (mbY * widthInMb);
 
         mediaObjectParams.VfeScoreboard.Value[0] = mbX;
@@ -3426,31 +3603,44 @@ MOS_STATUS CodechalEncodeMpeg2::SendMediaObjectsBB(
             break;
         }
 
-        eStatus = m_hwInterface->GetRenderInterface()->AddMediaObject(
+        CODECHAL_ENCODE_CHK_STATUS_RETURN(m_hwInterface->GetRenderInterface()->AddMediaObject(
             nullptr,
             batchBuffer,
-            &mediaObjectParams);
-        if (eStatus != MOS_STATUS_SUCCESS)
-        {
-            MOS_FreeMemory(mBOffset);
-            MOS_FreeMemory(slcRecord);
-            return eStatus;
-        }
+            &mediaObjectParams));
+    }
+
+    // Keep the commands for the next frames with the same inputs, a failed allocation only costs the replay
+    uint32_t cmdsSize = (uint32_t)(batchBuffer->iCurrent - cmdsStart);
+    if (mbObjects->m_cmdsAllocated < cmdsSize)
+    {
+        MOS_FreeMemory(mbObjects->m_cmds);
+        mbObjects->m_cmds          = (uint8_t *)MOS_AllocMemory(cmdsSize);
+        mbObjects->m_cmdsAllocated = mbObjects->m_cmds ? cmdsSize : 0;
+    }
+    if (mbObjects->m_cmds && cmdsSize)
+    {
+        MOS_SecureMemcpy(mbObjects->m_cmds, cmdsSize, batchBuffer->pData + cmdsStart, cmdsSize);
+        mbObjects->m_cmdsSize           = cmdsSize;
+        mbObjects->m_widthInMb          = widthInMb;
+        mbObjects->m_heightInMb         = frameFieldHeightInMb;
+        mbObjects->m_walkingPattern     = walkingPattern;
+        mbObjects->m_scoreboardEnable   = scoreboardEnable;
+        mbObjects->m_halfSliceSelect    = m_halfSliceSelect;
+        mbObjects->m_recordsGeneration  = records->m_generation;
+        mbObjects->m_lastUse            = m_mbObjectCacheTick;
+    }
+    else
+    {
+        mbObjects->m_cmdsSize = 0;
     }
 
     eStatus = m_miInterface->AddMiBatchBufferEnd(
         nullptr,
         batchBuffer);
 
-    if (eStatus != MOS_STATUS_SUCCESS)
-    {
-        MOS_FreeMemory(mBOffset);
-        MOS_FreeMemory(slcRecord);
-        return eStatus;
-    }
-
     return eStatus;
 }
+
 MOS_STATUS CodechalEncodeMpeg2::EncodeMbEncKernel(bool mbEncIFrameDistEnabled)
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
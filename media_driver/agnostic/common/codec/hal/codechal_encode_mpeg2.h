@@ -30,6 +30,58 @@
 #include "codechal_encoder_base.h"
 
 class CodechalKernelHme;
+struct SliceRecord;
+
+#define CODECHAL_ENCODE_MPEG2_MB_WALK_CACHE_SIZE       6   //!< Three walking patterns for the frame and the 4x downscaled picture
+#define CODECHAL_ENCODE_MPEG2_MB_OBJECT_CACHE_SIZE     6   //!< MEDIA_OBJECT batches kept for replay
+
+//!
+//! \struct   CodechalEncodeMpeg2MbWalkMap
+//! \brief    MB dispatch order of one picture size and walking pattern
+//!
+struct CodechalEncodeMpeg2MbWalkMap
+{
+    uint16_t    m_widthInMb         = 0;
+    uint16_t    m_heightInMb        = 0;
+    uint32_t    m_walkingPattern    = 0;
+    uint32_t    m_lastUse           = 0;
+    uint16_t   *m_mbOffset          = nullptr;   //!< Raster index of the n-th dispatched MB
+};
+
+//!
+//! \struct   CodechalEncodeMpeg2MbSliceRecords
+//! \brief    Slice record of every MB for one slice layout
+//!
+struct CodechalEncodeMpeg2MbSliceRecords
+{
+    uint16_t     m_widthInMb        = 0;
+    uint16_t     m_heightInMb       = 0;
+    bool         m_withRecords      = false;     //!< Records are left zero for ENC only
+    uint32_t     m_numSlices        = 0;
+    uint32_t    *m_sliceLayout      = nullptr;   //!< MB count and slice group flags of each slice
+    uint32_t     m_layoutAllocated  = 0;
+    SliceRecord *m_slcRecord        = nullptr;
+    uint32_t     m_numRecords       = 0;
+    uint32_t     m_generation       = 0;         //!< Changes each time the records are rebuilt
+};
+
+//!
+//! \struct   CodechalEncodeMpeg2MbObjectBatch
+//! \brief    MEDIA_OBJECT commands of an MbEnc batch, replayed while their inputs are unchanged
+//!
+struct CodechalEncodeMpeg2MbObjectBatch
+{
+    uint16_t    m_widthInMb         = 0;
+    uint16_t    m_heightInMb        = 0;
+    uint32_t    m_walkingPattern    = 0;
+    bool        m_scoreboardEnable  = false;
+    uint32_t    m_halfSliceSelect   = 0;
+    uint32_t    m_recordsGeneration = 0;         //!< Generation of the slice records the commands were built from
+    uint32_t    m_lastUse           = 0;
+    uint8_t    *m_cmds              = nullptr;
+    uint32_t    m_cmdsSize          = 0;
+    uint32_t    m_cmdsAllocated     = 0;
+};
 
 //!
 //! \class   CodechalEncodeMpeg2
@@ -470,6 +522,60 @@ protected:
         PMHW_BATCH_BUFFER  batchBuffer,
         bool mbEncIFrameDistEnabled);
 
+    //!
+    //! \brief    Get the MB dispatch order of a walking pattern
+    //! \details  The order is built on first use and cached per picture size
+    //!
+    //! \param    [in]  widthInMb
+    //!           Picture width in MB
+    //! \param    [in]  heightInMb
+    //!           Frame or field height in MB
+    //! \param    [in]  walkingPattern
+    //!           codechalHorizontal45DegreeScan, codechalHorizontalRasterScan or codechalVerticalRasterScan
+    //! \param    [out] mbOffset
+    //!           Raster index of each dispatched MB, owned by the cache
+    //!
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS GetMbWalkMap(
+        uint16_t    widthInMb,
+        uint16_t    heightInMb,
+        uint32_t    walkingPattern,
+        uint16_t    **mbOffset);
+
+    //!
+    //! \brief    Get the slice record of every MB
+    //! \details  The records are rebuilt only when the picture size or slice layout changes
+    //!
+    //! \param    [in]  distortionCalc
+    //!           Records for the I-frame distortion pass, a single slice over the downscaled picture
+    //! \param    [in]  widthInMb
+    //!           Picture width in MB
+    //! \param    [in]  heightInMb
+    //!           Frame or field height in MB
+    //! \param    [in]  numSlice
+    //!           Number of slices
+    //! \param    [out] records
+    //!           Cached records
+    //!
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS GetMbSliceRecords(
+        bool                                distortionCalc,
+        uint16_t                            widthInMb,
+        uint16_t                            heightInMb,
+        uint32_t                            numSlice,
+        CodechalEncodeMpeg2MbSliceRecords   **records);
+
+    //!
+    //! \brief    Free the MB walk, slice record and MEDIA_OBJECT caches
+    //!
+    //! \return   void
+    //!
+    void FreeMbObjectCaches();
+
     //!
     //! \brief    Top level function for invoking MBenc kernel
     //!
@@ -734,6 +840,11 @@ protected:
     uint32_t                               m_prevMBCodeIdx = 0;                                 //!< Previous MB Code index                                                                                    // MbEnc
     MHW_KERNEL_STATE                       m_mbEncKernelStates[mbEncKernelIdxNum];              //!< MbEnc kernel state
     BindingTableMbEnc                      m_mbEncBindingTable;                                 //!< MbEnc binding table
+    CodechalEncodeMpeg2MbWalkMap           m_mbWalkMaps[CODECHAL_ENCODE_MPEG2_MB_WALK_CACHE_SIZE];       //!< MB walk cache
+    CodechalEncodeMpeg2MbSliceRecords      m_mbSliceRecords[2];                                 //!< Slice records of the frame and of the I-frame distortion pass
+    CodechalEncodeMpeg2MbObjectBatch       m_mbObjectBatches[CODECHAL_ENCODE_MPEG2_MB_OBJECT_CACHE_SIZE]; //!< MEDIA_OBJECT batch cache
+    uint32_t                               m_mbObjectCacheTick = 0;                             //!< Use counter of the MB caches
+    uint32_t                               m_mbSliceRecordsGeneration = 0;                      //!< Last slice records generation
 
     // ME
     CodechalKernelHme                      *m_hmeKernel = nullptr;                              //!< ME kernel object
@@ -477,22 +477,14 @@ MOS_STATUS CodechalVdencHevcState::SetupBRCROIStreamIn(PMOS_RESOURCE streamIn, P
     CODECHAL_ENCODE_CHK_NULL_RETURN(streamIn);
     CODECHAL_ENCODE_CHK_NULL_RETURN(deltaQpBuffer);
 
-    MOS_LOCK_PARAMS lockFlags;
-    MOS_ZeroMemory(&lockFlags, sizeof(MOS_LOCK_PARAMS));
-    lockFlags.WriteOnly = true;
-
-    PDeltaQpForROI deltaQpData = (PDeltaQpForROI)m_osInterface->pfnLockResource(
-        m_osInterface,
-        deltaQpBuffer,
-        &lockFlags);
-    CODECHAL_ENCODE_CHK_NULL_RETURN(deltaQpData);
-
     uint32_t streamInWidth = (MOS_ALIGN_CEIL(m_frameWidth, 64) / 32);
     uint32_t streamInHeight = (MOS_ALIGN_CEIL(m_frameHeight, 64) / 32);
     uint32_t deltaQpBufWidth = (MOS_ALIGN_CEIL(m_frameWidth, 32) / 32);
     uint32_t deltaQpBufHeight = (MOS_ALIGN_CEIL(m_frameHeight, 32) / 32);
     bool cu64Align = true;
 
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(InitStreamInMap(streamInWidth, streamInHeight));
+
     for (int32_t i = pHevcPicParams->NumROI - 1; i >= 0; i--)
     {
         //Check if the region is with in the borders
@@ -506,31 +498,47 @@ MOS_STATUS CodechalVdencHevcState::SetupBRCROIStreamIn(PMOS_RESOURCE streamIn, P
         {
             cu64Align = false;
         }
+    }
 
-        for (uint16_t Y = top; Y < bottom; Y++)
-            for (uint16_t X = left; X < right; X++)
-            {
-                uint32_t offset = streamInWidth * Y;
-                uint32_t yOffset = 0;
-                uint32_t xOffset = 2 * X;
+    MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminDataParams;
+    MOS_ZeroMemory(&streaminDataParams, sizeof(streaminDataParams));
+    SetStreaminParamsPerTu(&streaminDataParams, (cu64Align) ? 3 : 2);
 
-                //Calculate X Y offset for the zig zag scan with in each 64x64 LCU
-                //dwOffset gives the 64 LCU row
-                if (Y % 2)
-                {
-                    offset = streamInWidth * (Y - 1);
-                    yOffset = 2;
-                }
+    // The delta QP and stream-in writes only depend on the ROIs and the per frame parameters, skip them if nothing changed
+    if (m_brcRoiStreamIn.valid &&
+        m_brcRoiStreamIn.numCus == streamInWidth * streamInHeight &&
+        m_brcRoiStreamIn.numRoi == pHevcPicParams->NumROI &&
+        !memcmp(m_brcRoiStreamIn.roi, pHevcPicParams->ROI, pHevcPicParams->NumROI * sizeof(CODEC_ROI)) &&
+        !memcmp(&m_brcRoiStreamIn.streamInParams, &streaminDataParams, sizeof(streaminDataParams)))
+    {
+        return eStatus;
+    }
 
-                if (X % 2)
-                {
-                    xOffset = (2 * X) - 1;
-                }
+    MOS_LOCK_PARAMS lockFlags;
+    MOS_ZeroMemory(&lockFlags, sizeof(MOS_LOCK_PARAMS));
+    lockFlags.WriteOnly = true;
 
-                uint32_t xyOffset = xOffset + yOffset;
+    PDeltaQpForROI deltaQpData = (PDeltaQpForROI)m_osInterface->pfnLockResource(
+        m_osInterface,
+        deltaQpBuffer,
+        &lockFlags);
+    CODECHAL_ENCODE_CHK_NULL_RETURN(deltaQpData);
 
-                (deltaQpData + (offset + xyOffset))->iDeltaQp = pHevcPicParams->ROI[i].PriorityLevelOrDQp;
+    for (int32_t i = pHevcPicParams->NumROI - 1; i >= 0; i--)
+    {
+        uint16_t top = (uint16_t)CodecHal_Clip3(0, (deltaQpBufHeight - 1), pHevcPicParams->ROI[i].Top);
+        uint16_t bottom = (uint16_t)CodecHal_Clip3(0, (deltaQpBufHeight - 1), pHevcPicParams->ROI[i].Bottom) + 1;
+        uint16_t left = (uint16_t)CodecHal_Clip3(0, (deltaQpBufWidth - 1), pHevcPicParams->ROI[i].Left);
+        uint16_t right = (uint16_t)CodecHal_Clip3(0, (deltaQpBufWidth - 1), pHevcPicParams->ROI[i].Right) + 1;
+
+        for (uint16_t y = top; y < bottom; y++)
+        {
+            const uint32_t *cuOffset = m_streamInZigZagLut + y * streamInWidth;
+            for (uint16_t x = left; x < right; x++)
+            {
+                (deltaQpData + cuOffset[x])->iDeltaQp = pHevcPicParams->ROI[i].PriorityLevelOrDQp;
             }
+        }
     }
 
     m_osInterface->pfnUnlockResource(
@@ -543,29 +551,6 @@ MOS_STATUS CodechalVdencHevcState::SetupBRCROIStreamIn(PMOS_RESOURCE streamIn, P
         &lockFlags);
     CODECHAL_ENCODE_CHK_NULL_RETURN(data);
 
-    MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminDataParams;
-    MOS_ZeroMemory(&streaminDataParams, sizeof(streaminDataParams));
-    streaminDataParams.maxTuSize = 3;    //Maximum TU Size allowed, restriction to be set to 3
-    streaminDataParams.maxCuSize = (cu64Align) ? 3 : 2;
-    switch (pHevcSeqParams->TargetUsage)
-    {
-    case 1:
-    case 4:
-        streaminDataParams.numMergeCandidateCu64x64 = 4;
-        streaminDataParams.numMergeCandidateCu32x32 = 3;
-        streaminDataParams.numMergeCandidateCu16x16 = 2;
-        streaminDataParams.numMergeCandidateCu8x8   = 1;
-        streaminDataParams.numImePredictors         = m_imgStateImePredictors;
-        break;
-    case 7:
-        streaminDataParams.numMergeCandidateCu64x64 = 2;
-        streaminDataParams.numMergeCandidateCu32x32 = 2;
-        streaminDataParams.numMergeCandidateCu16x16 = 2;
-        streaminDataParams.numMergeCandidateCu8x8   = 0;
-        streaminDataParams.numImePredictors         = 4;
-        break;
-    }
-
     int32_t streamInNumCUs = streamInWidth * streamInHeight;
     for (auto i = 0; i < streamInNumCUs; i++)
     {
@@ -576,6 +561,12 @@ MOS_STATUS CodechalVdencHevcState::SetupBRCROIStreamIn(PMOS_RESOURCE streamIn, P
         m_osInterface,
         streamIn);
 
+    m_brcRoiStreamIn.valid          = true;
+    m_brcRoiStreamIn.numCus         = streamInNumCUs;
+    m_brcRoiStreamIn.numRoi         = pHevcPicParams->NumROI;
+    m_brcRoiStreamIn.streamInParams = streaminDataParams;
+    MOS_SecureMemcpy(m_brcRoiStreamIn.roi, sizeof(m_brcRoiStreamIn.roi), pHevcPicParams->ROI, pHevcPicParams->NumROI * sizeof(CODEC_ROI));
+
     return eStatus;
 }
 
@@ -644,40 +635,41 @@ MOS_STATUS CodechalVdencHevcState::SetupROIStreamIn(PMOS_RESOURCE streamIn)
 
     CODECHAL_ENCODE_CHK_NULL_RETURN(streamIn);
 
-    MOS_LOCK_PARAMS lockFlags;
-    MOS_ZeroMemory(&lockFlags, sizeof(MOS_LOCK_PARAMS));
-    lockFlags.WriteOnly = true;
-
-    uint8_t* data = (uint8_t*)m_osInterface->pfnLockResource(
-        m_osInterface,
-        streamIn,
-        &lockFlags);
-    CODECHAL_ENCODE_CHK_NULL_RETURN(data);
-
     uint32_t streamInWidth = (MOS_ALIGN_CEIL(m_frameWidth, 64) / 32);
     uint32_t streamInHeight = (MOS_ALIGN_CEIL(m_frameHeight, 64) / 32);
-    int32_t streamInNumCUs = streamInWidth * streamInHeight;
-
-    MOS_ZeroMemory(data, streamInNumCUs * 64);
 
-    MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminDataParams;
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(InitStreamInMap(streamInWidth, streamInHeight));
 
-    //ROI higher priority for smaller index.
+    //Check if all the sides of ROI regions are aligned to 64CU
     bool cu64Align = true;
     for (int32_t i = pHevcPicParams->NumROI - 1; i >= 0; i--)
     {
-
-        //Check if the region is with in the borders
         uint16_t top = (uint16_t)CodecHal_Clip3(0, (streamInHeight - 1), pHevcPicParams->ROI[i].Top);
         uint16_t bottom = (uint16_t)CodecHal_Clip3(0, (streamInHeight - 1), pHevcPicParams->ROI[i].Bottom) + 1;
         uint16_t left = (uint16_t)CodecHal_Clip3(0, (streamInWidth - 1), pHevcPicParams->ROI[i].Left);
         uint16_t right = (uint16_t)CodecHal_Clip3(0, (streamInWidth - 1), pHevcPicParams->ROI[i].Right) + 1;
 
-        //Check if all the sides of ROI regions are aligned to 64CU
         if ((top % 2 == 1) || (bottom % 2 == 1) || (left % 2 == 1) || (right % 2 == 1))
         {
             cu64Align = false;
         }
+    }
+
+    MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminDataParams;
+    MOS_ZeroMemory(&streaminDataParams, sizeof(streaminDataParams));
+    SetStreaminParamsPerTu(&streaminDataParams, (cu64Align) ? 3 : 2);
+
+    // CUs outside of all ROIs only carry the per frame settings
+    AddStreamInRecord(nullptr, &streaminDataParams);
+
+    //ROI higher priority for smaller index.
+    for (int32_t i = pHevcPicParams->NumROI - 1; i >= 0; i--)
+    {
+        //Check if the region is with in the borders
+        uint16_t top = (uint16_t)CodecHal_Clip3(0, (streamInHeight - 1), pHevcPicParams->ROI[i].Top);
+        uint16_t bottom = (uint16_t)CodecHal_Clip3(0, (streamInHeight - 1), pHevcPicParams->ROI[i].Bottom) + 1;
+        uint16_t left = (uint16_t)CodecHal_Clip3(0, (streamInWidth - 1), pHevcPicParams->ROI[i].Left);
+        uint16_t right = (uint16_t)CodecHal_Clip3(0, (streamInWidth - 1), pHevcPicParams->ROI[i].Right) + 1;
 
         // For native ROI, determine Region ID based on distinct delta Qps and set ROI control
         uint32_t roiCtrl = 0;
@@ -698,77 +690,50 @@ MOS_STATUS CodechalVdencHevcState::SetupROIStreamIn(PMOS_RESOURCE streamIn)
         // Calculate ForceQp
         int8_t forceQp = (int8_t)CodecHal_Clip3(0, 51, pHevcPicParams->QpY + pHevcPicParams->ROI[i].PriorityLevelOrDQp + pHevcSliceParams->slice_qp_delta);
 
-        for (uint16_t Y = top; Y < bottom; Y++)
+        MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS roiDataParams;
+        MOS_ZeroMemory(&roiDataParams, sizeof(roiDataParams));
+        roiDataParams.setQpRoiCtrl = true;
+        if (m_vdencNativeROIEnabled)
         {
-            for (uint16_t X = left; X < right; X++)
-            {
-                uint32_t offset = streamInWidth * Y;
-                uint32_t yOffset = 0;
-                uint32_t xOffset = 2 * X;
-
-                //Calculate X Y offset for the zig zag scan with in each 64x64 LCU
-                //dwOffset gives the 64 LCU row
-                if (Y % 2)
-                {
-                    offset = streamInWidth * (Y - 1);
-                    yOffset = 2;
-                }
+            roiDataParams.roiCtrl = (uint8_t)roiCtrl;
+        }
+        else
+        {
+            roiDataParams.forceQp = forceQp;
+        }
 
-                if (X % 2)
-                {
-                    xOffset = (2 * X) - 1;
-                }
+        StreamInMapRegion(streamInWidth, top, bottom, left, right, AddStreamInRecord(&roiDataParams, &streaminDataParams));
+    }
 
-                uint32_t xyOffset = xOffset + yOffset;
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(WriteStreamInMap(streamIn, &m_streamInMap[m_currRecycledBufIdx]));
 
-                MOS_ZeroMemory(&streaminDataParams, sizeof(streaminDataParams));
-                streaminDataParams.setQpRoiCtrl = true;
-                if (m_vdencNativeROIEnabled)
-                {
-                    streaminDataParams.roiCtrl = (uint8_t)roiCtrl;
-                    SetStreaminDataPerLcu(&streaminDataParams, data + (offset + xyOffset) * 64);
-                }
-                else
-                {
-                    streaminDataParams.forceQp = forceQp;
-                    SetStreaminDataPerLcu(&streaminDataParams, data + (offset + xyOffset) * 64);
-                }
-            }
-        }
-    }
+    return eStatus;
+}
 
-    MOS_ZeroMemory(&streaminDataParams, sizeof(streaminDataParams));
-    streaminDataParams.maxTuSize = 3;    //Maximum TU Size allowed, restriction to be set to 3
-    streaminDataParams.maxCuSize = (cu64Align) ? 3 : 2;
+void CodechalVdencHevcState::SetStreaminParamsPerTu(
+    PMHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminParams,
+    uint8_t maxcu)
+{
+    streaminParams->maxTuSize = 3;    //Maximum TU Size allowed, restriction to be set to 3
+    streaminParams->maxCuSize = maxcu;
     switch (pHevcSeqParams->TargetUsage)
     {
     case 1:
     case 4:
-        streaminDataParams.numMergeCandidateCu64x64 = 4;
-        streaminDataParams.numMergeCandidateCu32x32 = 3;
-        streaminDataParams.numMergeCandidateCu16x16 = 2;
-        streaminDataParams.numMergeCandidateCu8x8   = 1;
-        streaminDataParams.numImePredictors         = m_imgStateImePredictors;
+        streaminParams->numMergeCandidateCu64x64 = 4;
+        streaminParams->numMergeCandidateCu32x32 = 3;
+        streaminParams->numMergeCandidateCu16x16 = 2;
+        streaminParams->numMergeCandidateCu8x8   = 1;
+        streaminParams->numImePredictors         = m_imgStateImePredictors;
         break;
     case 7:
-        streaminDataParams.numMergeCandidateCu64x64 = 2;
-        streaminDataParams.numMergeCandidateCu32x32 = 2;
-        streaminDataParams.numMergeCandidateCu16x16 = 2;
-        streaminDataParams.numMergeCandidateCu8x8   = 0;
-        streaminDataParams.numImePredictors         = 4;
+        streaminParams->numMergeCandidateCu64x64 = 2;
+        streaminParams->numMergeCandidateCu32x32 = 2;
+        streaminParams->numMergeCandidateCu16x16 = 2;
+        streaminParams->numMergeCandidateCu8x8   = 0;
+        streaminParams->numImePredictors         = 4;
         break;
     }
-
-    for (auto i = 0; i < streamInNumCUs; i++)
-    {
-        SetStreaminDataPerLcu(&streaminDataParams, data + (i * 64));
-    }
-
-    m_osInterface->pfnUnlockResource(
-        m_osInterface,
-        streamIn);
-
-    return eStatus;
 }
 
 void CodechalVdencHevcState::StreaminSetDirtyRectRegion(
@@ -777,50 +742,16 @@ void CodechalVdencHevcState::StreaminSetDirtyRectRegion(
     uint32_t bottom,
     uint32_t left,
     uint32_t right,
-    uint8_t  maxcu,
-    void* streaminData)
+    uint8_t  maxcu)
 {
     CODECHAL_ENCODE_FUNCTION_ENTER;
 
-    uint8_t* data = (uint8_t*)streaminData;
-
     MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminDataParams;
     MOS_ZeroMemory(&streaminDataParams, sizeof(streaminDataParams));
-    streaminDataParams.maxTuSize = 3;
-    streaminDataParams.maxCuSize = maxcu;
+    SetStreaminParamsPerTu(&streaminDataParams, maxcu);
     streaminDataParams.puTypeCtrl = 0;
 
-    switch (pHevcSeqParams->TargetUsage)
-    {
-    case 1:
-    case 4:
-        streaminDataParams.numMergeCandidateCu64x64 = 4;
-        streaminDataParams.numMergeCandidateCu32x32 = 3;
-        streaminDataParams.numMergeCandidateCu16x16 = 2;
-        streaminDataParams.numMergeCandidateCu8x8 = 1;
-        streaminDataParams.numImePredictors = m_imgStateImePredictors;
-        break;
-    case 7:
-        streaminDataParams.numMergeCandidateCu64x64 = 2;
-        streaminDataParams.numMergeCandidateCu32x32 = 2;
-        streaminDataParams.numMergeCandidateCu16x16 = 2;
-        streaminDataParams.numMergeCandidateCu8x8 = 0;
-        streaminDataParams.numImePredictors = 4;
-        break;
-    }
-
-    for (uint32_t y = top; y < bottom; y++)
-    {
-        for (uint32_t x = left; x < right; x++)
-        {
-            //Calculate X Y for the zig zag scan
-            uint32_t offset = 0;
-            uint32_t xyOffset = 0;
-            StreaminZigZagToLinearMap(streamInWidth, x, y, &offset, &xyOffset);
-
-            SetStreaminDataPerLcu(&streaminDataParams, data + (offset + xyOffset) * 64);
-        }
-    }
+    StreamInMapRegion(streamInWidth, top, bottom, left, right, AddStreamInRecord(nullptr, &streaminDataParams));
 }
 
 void CodechalVdencHevcState::StreaminZigZagToLinearMap(
@@ -857,13 +788,10 @@ void CodechalVdencHevcState::StreaminSetBorderNon64AlignStaticRegion(
     uint32_t top,
     uint32_t bottom,
     uint32_t left,
-    uint32_t right,
-    void* streaminData)
+    uint32_t right)
 {
     CODECHAL_ENCODE_FUNCTION_ENTER;
 
-    uint8_t* data = (uint8_t*)streaminData;
-
     MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminDataParams;
     MOS_ZeroMemory(&streaminDataParams, sizeof(streaminDataParams));
     streaminDataParams.maxTuSize = 3;
@@ -875,18 +803,174 @@ void CodechalVdencHevcState::StreaminSetBorderNon64AlignStaticRegion(
     streaminDataParams.numImePredictors = 0;
     streaminDataParams.puTypeCtrl = 0xff; //Force MV
 
+    StreamInMapRegion(streamInWidth, top, bottom, left, right, AddStreamInRecord(nullptr, &streaminDataParams));
+}
+
+MOS_STATUS CodechalVdencHevcState::InitStreamInMap(
+    uint32_t streamInWidth,
+    uint32_t streamInHeight)
+{
+    CODECHAL_ENCODE_FUNCTION_ENTER;
+
+    uint32_t numCus = streamInWidth * streamInHeight;
+
+    // The zig zag offsets only depend on the resolution, rebuild them when it changes
+    if (m_streamInZigZagLut == nullptr || m_streamInLutWidth != streamInWidth || m_streamInLutHeight != streamInHeight)
+    {
+        MOS_FreeMemory(m_streamInZigZagLut);
+        m_streamInZigZagLut = (uint32_t *)MOS_AllocMemory(numCus * sizeof(uint32_t));
+        CODECHAL_ENCODE_CHK_NULL_RETURN(m_streamInZigZagLut);
+
+        for (uint32_t y = 0; y < streamInHeight; y++)
+        {
+            for (uint32_t x = 0; x < streamInWidth; x++)
+            {
+                uint32_t offset = 0;
+                uint32_t xyOffset = 0;
+                StreaminZigZagToLinearMap(streamInWidth, x, y, &offset, &xyOffset);
+                m_streamInZigZagLut[y * streamInWidth + x] = offset + xyOffset;
+            }
+        }
+        m_streamInLutWidth  = streamInWidth;
+        m_streamInLutHeight = streamInHeight;
+    }
+
+    if (m_streamInMapNew.cuRecord == nullptr || m_streamInMapNew.numCus != numCus)
+    {
+        MOS_FreeMemory(m_streamInMapNew.cuRecord);
+        m_streamInMapNew.cuRecord = (uint8_t *)MOS_AllocMemory(numCus);
+        CODECHAL_ENCODE_CHK_NULL_RETURN(m_streamInMapNew.cuRecord);
+        m_streamInMapNew.numCus = numCus;
+    }
+
+    // Every CU starts with the first record added
+    MOS_ZeroMemory(m_streamInMapNew.cuRecord, numCus);
+    m_streamInMapNew.numRecords = 0;
+    m_streamInMapNew.valid      = false;
+
+    return MOS_STATUS_SUCCESS;
+}
+
+uint8_t CodechalVdencHevcState::AddStreamInRecord(
+    PMHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS roiParams,
+    PMHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminParams)
+{
+    CODECHAL_ENCODE_FUNCTION_ENTER;
+
+    // Build the record the same way it used to be written to a cleared surface
+    uint8_t record[CODECHAL_CACHELINE_SIZE];
+    MOS_ZeroMemory(record, sizeof(record));
+    if (roiParams)
+    {
+        SetStreaminDataPerLcu(roiParams, record);
+    }
+    SetStreaminDataPerLcu(streaminParams, record);
+
+    uint32_t i;
+    for (i = 0; i < m_streamInMapNew.numRecords; i++)
+    {
+        if (!memcmp(m_streamInMapNew.records[i], record, sizeof(record)))
+        {
+            return (uint8_t)i;
+        }
+    }
+
+    // Regions can share a record, the table only runs out if every ROI needs its own one
+    CODECHAL_ENCODE_ASSERT(i < CODECHAL_VDENC_HEVC_MAX_STREAMIN_RECORDS);
+    i = MOS_MIN(i, CODECHAL_VDENC_HEVC_MAX_STREAMIN_RECORDS - 1);
+
+    MOS_SecureMemcpy(m_streamInMapNew.records[i], sizeof(record), record, sizeof(record));
+    m_streamInMapNew.numRecords = i + 1;
+
+    return (uint8_t)i;
+}
+
+void CodechalVdencHevcState::StreamInMapRegion(
+    uint32_t streamInWidth,
+    uint32_t top,
+    uint32_t bottom,
+    uint32_t left,
+    uint32_t right,
+    uint8_t  record)
+{
+    CODECHAL_ENCODE_FUNCTION_ENTER;
+
+    uint8_t *cuRecord = m_streamInMapNew.cuRecord;
     for (uint32_t y = top; y < bottom; y++)
     {
+        const uint32_t *cuOffset = m_streamInZigZagLut + y * streamInWidth;
         for (uint32_t x = left; x < right; x++)
         {
-            //Calculate X Y for the zig zag scan
-            uint32_t offset = 0;
-            uint32_t xyOffset = 0;
-            StreaminZigZagToLinearMap(streamInWidth, x, y, &offset, &xyOffset);
+            cuRecord[cuOffset[x]] = record;
+        }
+    }
+}
+
+MOS_STATUS CodechalVdencHevcState::WriteStreamInMap(
+    PMOS_RESOURCE streamIn,
+    CodechalVdencHevcStreamInMap *lastMap)
+{
+    CODECHAL_ENCODE_FUNCTION_ENTER;
+
+    CODECHAL_ENCODE_CHK_NULL_RETURN(streamIn);
+    CODECHAL_ENCODE_CHK_NULL_RETURN(lastMap);
+
+    CodechalVdencHevcStreamInMap *newMap = &m_streamInMapNew;
+    uint32_t numCus = newMap->numCus;
+    uint32_t firstCu = 0;
+    bool incremental = lastMap->valid && lastMap->numCus == numCus;
+
+    // A CU only needs to be written if its record bytes differ from the ones already in the buffer
+    bool recordChanged[CODECHAL_VDENC_HEVC_MAX_STREAMIN_RECORDS][CODECHAL_VDENC_HEVC_MAX_STREAMIN_RECORDS];
+    if (incremental)
+    {
+        for (uint32_t i = 0; i < lastMap->numRecords; i++)
+        {
+            for (uint32_t j = 0; j < newMap->numRecords; j++)
+            {
+                recordChanged[i][j] = memcmp(lastMap->records[i], newMap->records[j], CODECHAL_CACHELINE_SIZE) != 0;
+            }
+        }
+
+        while (firstCu < numCus && !recordChanged[lastMap->cuRecord[firstCu]][newMap->cuRecord[firstCu]])
+        {
+            firstCu++;
+        }
+    }
+
+    if (firstCu < numCus)
+    {
+        MOS_LOCK_PARAMS lockFlags;
+        MOS_ZeroMemory(&lockFlags, sizeof(MOS_LOCK_PARAMS));
+        lockFlags.WriteOnly = true;
+
+        uint8_t *data = (uint8_t *)m_osInterface->pfnLockResource(
+            m_osInterface,
+            streamIn,
+            &lockFlags);
+        CODECHAL_ENCODE_CHK_NULL_RETURN(data);
 
-            SetStreaminDataPerLcu(&streaminDataParams, data + (offset + xyOffset) * 64);
+        for (uint32_t i = firstCu; i < numCus; i++)
+        {
+            uint8_t record = newMap->cuRecord[i];
+            if (!incremental || recordChanged[lastMap->cuRecord[i]][record])
+            {
+                MOS_SecureMemcpy(data + i * CODECHAL_CACHELINE_SIZE, CODECHAL_CACHELINE_SIZE, newMap->records[record], CODECHAL_CACHELINE_SIZE);
+            }
         }
+
+        m_osInterface->pfnUnlockResource(
+            m_osInterface,
+            streamIn);
     }
+
+    // The new map now reflects the buffer, recycle the old one for the next frame
+    newMap->valid = true;
+    CodechalVdencHevcStreamInMap tmpMap = *lastMap;
+    *lastMap = *newMap;
+    *newMap  = tmpMap;
+
+    return MOS_STATUS_SUCCESS;
 }
 
 MOS_STATUS CodechalVdencHevcState::SetupDirtyRectStreamIn(PMOS_RESOURCE streamIn)
@@ -897,21 +981,10 @@ MOS_STATUS CodechalVdencHevcState::SetupDirtyRectStreamIn(PMOS_RESOURCE streamIn
 
     CODECHAL_ENCODE_CHK_NULL_RETURN(streamIn);
 
-    MOS_LOCK_PARAMS lockFlags;
-    MOS_ZeroMemory(&lockFlags, sizeof(MOS_LOCK_PARAMS));
-    lockFlags.WriteOnly = true;
-
-    uint8_t* data = (uint8_t*)m_osInterface->pfnLockResource(
-        m_osInterface,
-        streamIn,
-        &lockFlags);
-    CODECHAL_ENCODE_CHK_NULL_RETURN(data);
-
     uint32_t streamInWidth = (MOS_ALIGN_CEIL(m_frameWidth, 64) / 32);
     uint32_t streamInHeight = (MOS_ALIGN_CEIL(m_frameHeight, 64) / 32);
-    int32_t streamInNumCUs = streamInWidth * streamInHeight;
 
-    MOS_ZeroMemory(data, streamInNumCUs * 64);
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(InitStreamInMap(streamInWidth, streamInHeight));
 
     MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminDataParams;
     MOS_ZeroMemory(&streaminDataParams, sizeof(streaminDataParams));
@@ -924,10 +997,8 @@ MOS_STATUS CodechalVdencHevcState::SetupDirtyRectStreamIn(PMOS_RESOURCE streamIn
     streaminDataParams.numMergeCandidateCu16x16 = 0;
     streaminDataParams.numMergeCandidateCu8x8 = 0;
 
-    for (auto i = 0; i < streamInNumCUs; i++)
-    {
-        SetStreaminDataPerLcu(&streaminDataParams, data + (i * 64));
-    }
+    // CUs outside of all dirty rectangles
+    AddStreamInRecord(nullptr, &streaminDataParams);
 
     for (int i = pHevcPicParams->NumDirtyRects - 1; i >= 0; i--)
     {
@@ -950,14 +1021,14 @@ MOS_STATUS CodechalVdencHevcState::SetupDirtyRectStreamIn(PMOS_RESOURCE streamIn
             auto border_left = left;
             auto border_right = right;
 
-            StreaminSetDirtyRectRegion(streamInWidth, border_top, border_bottom, border_left, border_right, 2, data);
+            StreaminSetDirtyRectRegion(streamInWidth, border_top, border_bottom, border_left, border_right, 2);
 
             border_top = top - 1;
             border_bottom = top;
             border_left = (left % 2 != 0) ? left - 1 : left;
             border_right = (right % 2 != 0) ? right + 1 : right;
 
-            StreaminSetBorderNon64AlignStaticRegion(streamInWidth, border_top, border_bottom, border_left, border_right, data);
+            StreaminSetBorderNon64AlignStaticRegion(streamInWidth, border_top, border_bottom, border_left, border_right);
 
             dirtyrect_top = top + 1;
         }
@@ -969,14 +1040,14 @@ MOS_STATUS CodechalVdencHevcState::SetupDirtyRectStreamIn(PMOS_RESOURCE streamIn
             auto border_left = left;
             auto border_right = right;
 
-            StreaminSetDirtyRectRegion(streamInWidth, border_top, border_bottom, border_left, border_right, 2, data);
+            StreaminSetDirtyRectRegion(streamInWidth, border_top, border_bottom, border_left, border_right, 2);
 
             border_top = bottom;
             border_bottom = bottom + 1;
             border_left = (left % 2 != 0) ? left - 1 : left;
             border_right = (right % 2 != 0) ? right + 1 : right;
 
-            StreaminSetBorderNon64AlignStaticRegion(streamInWidth, border_top, border_bottom, border_left, border_right, data);
+            StreaminSetBorderNon64AlignStaticRegion(streamInWidth, border_top, border_bottom, border_left, border_right);
 
             dirtyrect_bottom = bottom - 1;
         }
@@ -988,14 +1059,14 @@ MOS_STATUS CodechalVdencHevcState::SetupDirtyRectStreamIn(PMOS_RESOURCE streamIn
             auto border_left = left;
             auto border_right = left + 1;
 
-            StreaminSetDirtyRectRegion(streamInWidth, border_top, border_bottom, border_left, border_right, 2, data);
+            StreaminSetDirtyRectRegion(streamInWidth, border_top, border_bottom, border_left, border_right, 2);
 
             border_top = (top % 2 != 0) ? top - 1 : top;
             border_bottom = (bottom % 2 != 0) ? bottom + 1 : bottom;
             border_left = left - 1;
             border_right = left;
 
-            StreaminSetBorderNon64AlignStaticRegion(streamInWidth, border_top, border_bottom, border_left, border_right, data);
+            StreaminSetBorderNon64AlignStaticRegion(streamInWidth, border_top, border_bottom, border_left, border_right);
 
             dirtyrect_left = left + 1;
         }
@@ -1007,23 +1078,21 @@ MOS_STATUS CodechalVdencHevcState::SetupDirtyRectStreamIn(PMOS_RESOURCE streamIn
             auto border_left = right - 1;
             auto border_right = right;
 
-            StreaminSetDirtyRectRegion(streamInWidth, border_top, border_bottom, border_left, border_right, 2, data);
+            StreaminSetDirtyRectRegion(streamInWidth, border_top, border_bottom, border_left, border_right, 2);
 
             border_top = (top % 2 != 0) ? top - 1 : top;
             border_bottom = (bottom % 2 != 0) ? bottom + 1 : bottom;
             border_left = right;
             border_right = right + 1;
 
-            StreaminSetBorderNon64AlignStaticRegion(streamInWidth, border_top, border_bottom, border_left, border_right, data);
+            StreaminSetBorderNon64AlignStaticRegion(streamInWidth, border_top, border_bottom, border_left, border_right);
             dirtyrect_right = right - 1;
         }
 
-        StreaminSetDirtyRectRegion(streamInWidth, dirtyrect_top, dirtyrect_bottom, dirtyrect_left, dirtyrect_right, 3, data);
+        StreaminSetDirtyRectRegion(streamInWidth, dirtyrect_top, dirtyrect_bottom, dirtyrect_left, dirtyrect_right, 3);
     }
 
-    m_osInterface->pfnUnlockResource(
-        m_osInterface,
-        streamIn);
+    CODECHAL_ENCODE_CHK_STATUS_RETURN(WriteStreamInMap(streamIn, &m_streamInMap[m_currRecycledBufIdx]));
 
     return eStatus;
 }
@@ -2562,6 +2631,16 @@ MOS_STATUS CodechalVdencHevcState::FreeEncResources()
 
     MOS_Delete(hucCmdInitializer);
 
+    for (auto i = 0; i < CODECHAL_ENCODE_RECYCLED_BUFFER_NUM; i++)
+    {
+        MOS_FreeMemory(m_streamInMap[i].cuRecord);
+        m_streamInMap[i].cuRecord = nullptr;
+    }
+    MOS_FreeMemory(m_streamInMapNew.cuRecord);
+    m_streamInMapNew.cuRecord = nullptr;
+    MOS_FreeMemory(m_streamInZigZagLut);
+    m_streamInZigZagLut = nullptr;
+
     return MOS_STATUS_SUCCESS;
 }
 
@@ -50,6 +50,22 @@ struct DeltaQpForROI
 
 using PDeltaQpForROI = DeltaQpForROI*;
 
+#define CODECHAL_VDENC_HEVC_MAX_STREAMIN_RECORDS (CODECHAL_ENCODE_HEVC_MAX_NUM_ROI + 1)
+
+//! This struct describes the content of a stream-in buffer
+/*!
+Each 32x32 CU refers to one of a few distinct 64 byte stream-in records, CUs are
+kept in stream-in buffer order so the map can be compared with the one last written.
+*/
+struct CodechalVdencHevcStreamInMap
+{
+    uint8_t     *cuRecord = nullptr;        //!< Record index of each CU in stream-in buffer order
+    uint32_t    numCus = 0;                 //!< Number of CUs in the map
+    uint32_t    numRecords = 0;             //!< Number of distinct records
+    uint8_t     records[CODECHAL_VDENC_HEVC_MAX_STREAMIN_RECORDS][CODECHAL_CACHELINE_SIZE];  //!< Distinct stream-in records
+    bool        valid = false;              //!< Map matches the buffer content
+};
+
 //!  HEVC VDEnc encoder base class 
 /*!
 This class defines the base class for HEVC VDEnc encoder, it includes 
@@ -128,7 +144,23 @@ public:
     uint8_t                                 m_maxNumNativeROI = ENCODE_VDENC_HEVC_MAX_STREAMINROI_G10;  //!< Number of native ROI supported by VDEnc HW
     uint8_t                                 m_imgStateImePredictors = 8;                       //!< Number of predictors for IME
 
+    // Stream-in
+    CodechalVdencHevcStreamInMap            m_streamInMap[CODECHAL_ENCODE_RECYCLED_BUFFER_NUM];  //!< Map last written to each stream-in buffer
+    CodechalVdencHevcStreamInMap            m_streamInMapNew;                                  //!< Map of the current frame
+    uint32_t                               *m_streamInZigZagLut = nullptr;                     //!< Stream-in buffer index of each CU in raster order
+    uint32_t                                m_streamInLutWidth = 0;                            //!< Width in CUs the zig zag LUT was built for
+    uint32_t                                m_streamInLutHeight = 0;                           //!< Height in CUs the zig zag LUT was built for
+
     // BRC
+    struct BrcRoiStreamIn
+    {
+        bool                                    valid = false;
+        uint32_t                                numCus = 0;
+        uint8_t                                 numRoi = 0;
+        CODEC_ROI                               roi[CODECHAL_ENCODE_HEVC_MAX_NUM_ROI];
+        MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS   streamInParams;
+    };
+    BrcRoiStreamIn                          m_brcRoiStreamIn;                                  //!< ROIs last written to the delta QP and input ROI stream-in buffers
     HevcVdencBrcBuffers                     m_vdencBrcBuffers;                                 //!< VDEnc Brc buffers
     MOS_RESOURCE                            m_dataFromPicsBuffer;                              //!< Data Buffer of Current and Reference Pictures for Weighted Prediction
     MOS_RESOURCE                            m_vdencDeltaQpBuffer;                              //!< VDEnc delta QP buffer
@@ -213,12 +245,10 @@ public:
     virtual MOS_STATUS SetupDirtyRectStreamIn(PMOS_RESOURCE streamIn);
 
     //!
-    //! \brief    Setup stream-in surface for a dirty rectangle
+    //! \brief    Setup stream-in map for a dirty rectangle
     //!
     //! \param    [in] streamInWidth, top, bottom, left, right, maxcu
     //!                streamInWidth, dirtyRect corner locations, maxCuSize
-    //!           [out] streaminData
-    //!                 pointer to streaminData
     //!
     //! \return   void
     //!
@@ -228,8 +258,7 @@ public:
         uint32_t bottom,
         uint32_t left,
         uint32_t right,
-        uint8_t  maxcu,
-        void* streaminData);
+        uint8_t  maxcu);
 
     //!
     //! \brief    Calculate X/Y offsets for zigzag scan within 64 LCU
@@ -249,22 +278,97 @@ public:
         uint32_t* xyOffset);
 
     //!
-    //! \brief    Setup stream-in for border of non-64 aligned region
+    //! \brief    Setup stream-in map for border of non-64 aligned region
     //!
     //! \param    [in] streamInWidth, top, bottom, left, right
     //!                streamInWidth, dirtyRect corner locations
-    //!           [out] streaminData
-    //!                 pointer to streaminData
     //!
     //! \return   void
     //!
     virtual void StreaminSetBorderNon64AlignStaticRegion(
+        uint32_t streamInWidth,
+        uint32_t top,
+        uint32_t bottom,
+        uint32_t left,
+        uint32_t right);
+
+    //!
+    //! \brief    Set the stream-in merge candidates and IME predictors for the target usage
+    //!
+    //! \param    [out] streaminParams
+    //!                 params to write into stream in surface
+    //!           [in] maxcu
+    //!                maxCuSize
+    //!
+    //! \return   void
+    //!
+    void SetStreaminParamsPerTu(
+        PMHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminParams,
+        uint8_t maxcu);
+
+    //!
+    //! \brief    Start the stream-in map of the current frame
+    //!
+    //! \details  Rebuilds the zig zag LUT when the resolution changes, all CUs refer to the first record added
+    //!
+    //! \param    [in] streamInWidth, streamInHeight
+    //!                stream-in size in 32x32 CUs
+    //!
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS InitStreamInMap(
+        uint32_t streamInWidth,
+        uint32_t streamInHeight);
+
+    //!
+    //! \brief    Add a stream-in record to the map of the current frame
+    //!
+    //! \param    [in] roiParams
+    //!                QP/ROI control params, can be nullptr
+    //!           [in] streaminParams
+    //!                CU size, merge and IME params
+    //!
+    //! \return   uint8_t
+    //!           index of the record, records with the same content share an index
+    //!
+    uint8_t AddStreamInRecord(
+        PMHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS roiParams,
+        PMHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS streaminParams);
+
+    //!
+    //! \brief    Set a region of the stream-in map of the current frame to a record
+    //!
+    //! \param    [in] streamInWidth, top, bottom, left, right, record
+    //!                streamInWidth, region corner locations, record index
+    //!
+    //! \return   void
+    //!
+    void StreamInMapRegion(
         uint32_t streamInWidth,
         uint32_t top,
         uint32_t bottom,
         uint32_t left,
         uint32_t right,
-        void* streaminData);
+        uint8_t  record);
+
+    //!
+    //! \brief    Write the stream-in map of the current frame to a stream-in buffer
+    //!
+    //! \details  Only the CUs that differ from the map last written to the buffer are written,
+    //!           the buffer is not locked if there are none
+    //!
+    //! \param    [in] streamIn
+    //!                Pointer to stream-in resource
+    //!           [in,out] lastMap
+    //!                Map last written to the stream-in resource
+    //!
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS WriteStreamInMap(
+        PMOS_RESOURCE streamIn,
+        CodechalVdencHevcStreamInMap *lastMap);
 
     //!
     //! \brief    Write out stream-in data for each LCU
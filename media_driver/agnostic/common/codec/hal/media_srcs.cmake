@@ -56,11 +56,13 @@ endif()
 #decode
 set(TMP_2_SOURCES_
     ${CMAKE_CURRENT_LIST_DIR}/codechal_decode_nv12top010.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/codechal_decode_slice_batch.cpp
     ${CMAKE_CURRENT_LIST_DIR}/codechal_decoder.cpp
 )
 
 set(TMP_2_HEADERS_
     ${CMAKE_CURRENT_LIST_DIR}/codechal_decode_nv12top010.h
+    ${CMAKE_CURRENT_LIST_DIR}/codechal_decode_slice_batch.h
     ${CMAKE_CURRENT_LIST_DIR}/codechal_decoder.h
 )
 if(${Decode_Processing_Supported} STREQUAL "yes")
@@ -139,12 +139,9 @@ public:
             return MOS_STATUS_NULL_POINTER;
         }
 
-        typename TMiCmds::MI_NOOP_CMD cmd;
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(
-            cmdBuffer,
-            batchBuffer,
-            &cmd,
-            cmd.byteSize));
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMiCmds::MI_NOOP_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -185,12 +182,9 @@ public:
             MHW_MI_CHK_STATUS(m_cpInterface->AddEpilog(m_osInterface, cmdBuffer));
         }
 
-        typename TMiCmds::MI_BATCH_BUFFER_END_CMD cmd;
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(
-            cmdBuffer,
-            batchBuffer,
-            &cmd,
-            cmd.byteSize));
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMiCmds::MI_BATCH_BUFFER_END_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         if (!cmdBuffer) // Don't need BB not nullptr chk b/c if both are nullptr it won't get this far
         {
@@ -224,12 +218,9 @@ public:
             MHW_MI_CHK_STATUS(m_cpInterface->AddEpilog(m_osInterface, cmdBuffer));
         }
 
-        typename TMiCmds::MI_BATCH_BUFFER_END_CMD cmd;
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(
-            cmdBuffer,
-            batchBuffer,
-            &cmd,
-            cmd.byteSize));
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMiCmds::MI_BATCH_BUFFER_END_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         if (!cmdBuffer) // Don't need BB not nullptr chk b/c if both are nullptr it won't get this far
         {
@@ -251,12 +242,13 @@ public:
         MHW_MI_CHK_NULL(params);
         MHW_MI_CHK_NULL(params->pOsResource);
 
-        typename TMiCmds::MI_STORE_DATA_IMM_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_STORE_DATA_IMM_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         MHW_RESOURCE_PARAMS                 resourceParams;
         MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
         resourceParams.presResource     = params->pOsResource;
         resourceParams.dwOffset         = params->dwResourceOffset;
-        resourceParams.pdwCmd           = cmd.DW1_2.Value;
+        resourceParams.pdwCmd           = cmd->DW1_2.Value;
         resourceParams.dwLocationInCmd  = 1;
         resourceParams.dwLsbNum         = MHW_COMMON_MI_STORE_DATA_DW_SHIFT;
         resourceParams.HwCommandType    = MOS_MI_STORE_DATA_IMM;
@@ -267,14 +259,14 @@ public:
             cmdBuffer,
             &resourceParams));
 
-        cmd.DW0.UseGlobalGtt = IsGlobalGttInUse();
+        cmd->DW0.UseGlobalGtt = IsGlobalGttInUse();
         // Force single DW write, driver never writes a QW
-        cmd.DW0.StoreQword = 0;
-        cmd.DW0.DwordLength--;
+        cmd->DW0.StoreQword = 0;
+        cmd->DW0.DwordLength--;
 
-        cmd.DW3.DataDword0 = params->dwValue;
+        cmd->DW3.DataDword0 = params->dwValue;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -288,25 +280,26 @@ public:
         MHW_MI_CHK_NULL(cmdBuffer);
         MHW_MI_CHK_NULL(params);
 
-        typename TMiCmds::MI_FLUSH_DW_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_FLUSH_DW_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         // set the protection bit based on CP status
-        MHW_MI_CHK_STATUS(m_cpInterface->SetProtectionSettingsForMiFlushDw(m_osInterface, &cmd));
+        MHW_MI_CHK_STATUS(m_cpInterface->SetProtectionSettingsForMiFlushDw(m_osInterface, cmd));
 
-        cmd.DW0.VideoPipelineCacheInvalidate    = params->bVideoPipelineCacheInvalidate;
-        cmd.DW0.PostSyncOperation               = cmd.POST_SYNC_OPERATION_NOWRITE;
-        cmd.DW3_4.Value[0]                      = params->dwDataDW1;
+        cmd->DW0.VideoPipelineCacheInvalidate    = params->bVideoPipelineCacheInvalidate;
+        cmd->DW0.PostSyncOperation               = cmd->POST_SYNC_OPERATION_NOWRITE;
+        cmd->DW3_4.Value[0]                      = params->dwDataDW1;
 
         if (params->pOsResource)
         {
-            cmd.DW0.PostSyncOperation           = cmd.POST_SYNC_OPERATION_WRITEIMMEDIATEDATA;
-            cmd.DW1_2.DestinationAddressType    = UseGlobalGtt.m_vcs;
+            cmd->DW0.PostSyncOperation           = cmd->POST_SYNC_OPERATION_WRITEIMMEDIATEDATA;
+            cmd->DW1_2.DestinationAddressType    = UseGlobalGtt.m_vcs;
 
             MHW_RESOURCE_PARAMS resourceParams;
             MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
             resourceParams.presResource     = params->pOsResource;
             resourceParams.dwOffset         = params->dwResourceOffset;
-            resourceParams.pdwCmd           = cmd.DW1_2.Value;
+            resourceParams.pdwCmd           = cmd->DW1_2.Value;
             resourceParams.dwLocationInCmd  = 1;
             resourceParams.dwLsbNum         = MHW_COMMON_MI_FLUSH_DW_SHIFT;
             resourceParams.HwCommandType    = MOS_MI_FLUSH_DW;
@@ -320,19 +313,19 @@ public:
 
         if (params->postSyncOperation)
         {
-            cmd.DW0.PostSyncOperation = params->postSyncOperation;
+            cmd->DW0.PostSyncOperation = params->postSyncOperation;
         }
 
         if (params->dwDataDW2 || params->bQWordEnable)
         {
-            cmd.DW3_4.Value[1] = params->dwDataDW2;
+            cmd->DW3_4.Value[1] = params->dwDataDW2;
         }
         else
         {
-            cmd.DW0.DwordLength--;
+            cmd->DW0.DwordLength--;
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -348,15 +341,16 @@ public:
         MHW_MI_CHK_NULL(params->presSrc);
         MHW_MI_CHK_NULL(params->presDst);
 
-        typename TMiCmds::MI_COPY_MEM_MEM_CMD cmd;
-        cmd.DW0.UseGlobalGttDestination = IsGlobalGttInUse();
-        cmd.DW0.UseGlobalGttSource      = IsGlobalGttInUse();
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_COPY_MEM_MEM_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        cmd->DW0.UseGlobalGttDestination = IsGlobalGttInUse();
+        cmd->DW0.UseGlobalGttSource      = IsGlobalGttInUse();
 
         MHW_RESOURCE_PARAMS resourceParams;
         MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
         resourceParams.presResource     = params->presDst;
         resourceParams.dwOffset         = params->dwDstOffset;
-        resourceParams.pdwCmd           = cmd.DW1_2.Value;
+        resourceParams.pdwCmd           = cmd->DW1_2.Value;
         resourceParams.dwLocationInCmd  = 1;
         resourceParams.dwLsbNum         = MHW_COMMON_MI_GENERAL_SHIFT;
         resourceParams.HwCommandType    = MOS_MI_COPY_MEM_MEM;
@@ -370,7 +364,7 @@ public:
         MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
         resourceParams.presResource     = params->presSrc;
         resourceParams.dwOffset         = params->dwSrcOffset;
-        resourceParams.pdwCmd           = cmd.DW3_4.Value;
+        resourceParams.pdwCmd           = cmd->DW3_4.Value;
         resourceParams.dwLocationInCmd  = 3;
         resourceParams.dwLsbNum         = MHW_COMMON_MI_GENERAL_SHIFT;
         resourceParams.HwCommandType    = MOS_MI_COPY_MEM_MEM;
@@ -381,7 +375,7 @@ public:
             cmdBuffer,
             &resourceParams));
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -396,12 +390,13 @@ public:
         MHW_MI_CHK_NULL(params);
         MHW_MI_CHK_NULL(params->presStoreBuffer);
 
-        typename TMiCmds::MI_STORE_REGISTER_MEM_CMD  cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_STORE_REGISTER_MEM_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         MHW_RESOURCE_PARAMS                 resourceParams;
         MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
         resourceParams.presResource     = params->presStoreBuffer;
         resourceParams.dwOffset         = params->dwOffset;
-        resourceParams.pdwCmd           = cmd.DW2_3.Value;
+        resourceParams.pdwCmd           = cmd->DW2_3.Value;
         resourceParams.dwLocationInCmd  = 2;
         resourceParams.dwLsbNum         = MHW_COMMON_MI_GENERAL_SHIFT;
         resourceParams.HwCommandType    = MOS_MI_STORE_REGISTER_MEM;
@@ -412,10 +407,10 @@ public:
             cmdBuffer,
             &resourceParams));
 
-        cmd.DW0.UseGlobalGtt = IsGlobalGttInUse();
-        cmd.DW1.RegisterAddress = params->dwRegister >> 2;
+        cmd->DW0.UseGlobalGtt = IsGlobalGttInUse();
+        cmd->DW1.RegisterAddress = params->dwRegister >> 2;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -430,12 +425,13 @@ public:
         MHW_MI_CHK_NULL(params);
         MHW_MI_CHK_NULL(params->presStoreBuffer);
 
-        typename TMiCmds::MI_LOAD_REGISTER_MEM_CMD   cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_LOAD_REGISTER_MEM_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         MHW_RESOURCE_PARAMS                 resourceParams;
         MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
         resourceParams.presResource     = params->presStoreBuffer;
         resourceParams.dwOffset         = params->dwOffset;
-        resourceParams.pdwCmd           = cmd.DW2_3.Value;
+        resourceParams.pdwCmd           = cmd->DW2_3.Value;
         resourceParams.dwLocationInCmd  = 2;
         resourceParams.dwLsbNum         = MHW_COMMON_MI_GENERAL_SHIFT;
         resourceParams.HwCommandType    = MOS_MI_LOAD_REGISTER_MEM;
@@ -446,10 +442,10 @@ public:
             cmdBuffer,
             &resourceParams));
 
-        cmd.DW0.UseGlobalGtt    = IsGlobalGttInUse();
-        cmd.DW1.RegisterAddress = params->dwRegister >> 2;
+        cmd->DW0.UseGlobalGtt    = IsGlobalGttInUse();
+        cmd->DW1.RegisterAddress = params->dwRegister >> 2;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -463,11 +459,12 @@ public:
         MHW_MI_CHK_NULL(cmdBuffer);
         MHW_MI_CHK_NULL(params);
 
-        typename TMiCmds::MI_LOAD_REGISTER_IMM_CMD cmd;
-        cmd.DW1.RegisterOffset = params->dwRegister >> 2;
-        cmd.DW2.DataDword = params->dwData;
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_LOAD_REGISTER_IMM_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        cmd->DW1.RegisterOffset = params->dwRegister >> 2;
+        cmd->DW2.DataDword = params->dwData;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -481,11 +478,12 @@ public:
         MHW_MI_CHK_NULL(cmdBuffer);
         MHW_MI_CHK_NULL(params);
 
-        typename TMiCmds::MI_LOAD_REGISTER_REG_CMD cmd;
-        cmd.DW1.SourceRegisterAddress = params->dwSrcRegister >> 2;
-        cmd.DW2.DestinationRegisterAddress = params->dwDstRegister >> 2;
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_LOAD_REGISTER_REG_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        cmd->DW1.SourceRegisterAddress = params->dwSrcRegister >> 2;
+        cmd->DW2.DestinationRegisterAddress = params->dwDstRegister >> 2;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -505,10 +503,11 @@ public:
             return MOS_STATUS_INVALID_PARAMETER;
         }
 
-        typename TMiCmds::MI_MATH_CMD cmd;
-        cmd.DW0.DwordLength = params->dwNumAluParams - 1;
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_MATH_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        cmd->DW0.DwordLength = params->dwNumAluParams - 1;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         MHW_MI_CHK_STATUS(Mos_AddCommand(
             cmdBuffer,
@@ -526,9 +525,10 @@ public:
 
         MHW_MI_CHK_NULL(cmdBuffer);
 
-        typename TMiCmds::MI_SET_PREDICATE_CMD cmd;
-        cmd.DW0.PredicateEnable = enableFlag;
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_SET_PREDICATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        cmd->DW0.PredicateEnable = enableFlag;
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -543,12 +543,13 @@ public:
         MHW_MI_CHK_NULL(params);
         MHW_MI_CHK_NULL(params->pOsResource);
 
-        typename TMiCmds::MI_ATOMIC_CMD  cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_ATOMIC_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         MHW_RESOURCE_PARAMS     resourceParams;
         MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
         resourceParams.presResource = params->pOsResource;
         resourceParams.dwOffset = params->dwResourceOffset;
-        resourceParams.pdwCmd = &(cmd.DW1.Value);
+        resourceParams.pdwCmd = &(cmd->DW1.Value);
         resourceParams.dwLocationInCmd = 1;
         resourceParams.dwLsbNum = MHW_COMMON_MI_GENERAL_SHIFT;
         resourceParams.HwCommandType = MOS_MI_ATOMIC;
@@ -559,20 +560,20 @@ public:
             cmdBuffer,
             &resourceParams));
 
-        cmd.DW0.DwordLength = params->bInlineData ? 1 : 9;
-        cmd.DW0.MemoryType = IsGlobalGttInUse();
-        cmd.DW0.ReturnDataControl = params->bReturnData;
+        cmd->DW0.DwordLength = params->bInlineData ? 1 : 9;
+        cmd->DW0.MemoryType = IsGlobalGttInUse();
+        cmd->DW0.ReturnDataControl = params->bReturnData;
         if (params->dwDataSize == sizeof(uint32_t))
         {
-            cmd.DW0.DataSize = cmd.DATA_SIZE_DWORD;
+            cmd->DW0.DataSize = cmd->DATA_SIZE_DWORD;
         }
         else if (params->dwDataSize == sizeof(uint64_t))
         {
-            cmd.DW0.DataSize = cmd.DATA_SIZE_QWORD;
+            cmd->DW0.DataSize = cmd->DATA_SIZE_QWORD;
         }
         else if (params->dwDataSize == sizeof(uint64_t)* 2)
         {
-            cmd.DW0.DataSize = cmd.DATA_SIZE_OCTWORD;
+            cmd->DW0.DataSize = cmd->DATA_SIZE_OCTWORD;
         }
         else
         {
@@ -580,44 +581,44 @@ public:
             return MOS_STATUS_INVALID_PARAMETER;
         }
 
-        if (cmd.DW0.DataSize == cmd.DATA_SIZE_QWORD)
+        if (cmd->DW0.DataSize == cmd->DATA_SIZE_QWORD)
         {
-            cmd.DW0.AtomicOpcode = atomicQword;
+            cmd->DW0.AtomicOpcode = atomicQword;
         }
-        else if (cmd.DW0.DataSize == cmd.DATA_SIZE_OCTWORD)
+        else if (cmd->DW0.DataSize == cmd->DATA_SIZE_OCTWORD)
         {
             if (params->Operation != MHW_MI_ATOMIC_CMP)
             {
                 MHW_ASSERTMESSAGE("An OCTWORD may only be used in the case of a compare operation!");
                 return MOS_STATUS_INVALID_PARAMETER;
             }
-            cmd.DW0.AtomicOpcode = atomicOctword;
+            cmd->DW0.AtomicOpcode = atomicOctword;
         }
-        cmd.DW0.AtomicOpcode = CreateMiAtomicOpcode(
-            cmd.DW0.AtomicOpcode,
+        cmd->DW0.AtomicOpcode = CreateMiAtomicOpcode(
+            cmd->DW0.AtomicOpcode,
             params->Operation);
-        if (cmd.DW0.AtomicOpcode == atomicInvalid)
+        if (cmd->DW0.AtomicOpcode == atomicInvalid)
         {
             MHW_ASSERTMESSAGE("No MI_ATOMIC opcode could be generated");
             return MOS_STATUS_INVALID_PARAMETER;
         }
 
-        cmd.DW0.InlineData = params->bInlineData;
-        cmd.DW0.DwordLength = params->bInlineData ? 9 : 1;
+        cmd->DW0.InlineData = params->bInlineData;
+        cmd->DW0.DwordLength = params->bInlineData ? 9 : 1;
 
         if (params->bInlineData)
         {
-            cmd.DW3.Operand1DataDword0 = params->dwOperand1Data[0];
-            cmd.DW4.Operand2DataDword0 = params->dwOperand2Data[0];
-            cmd.DW5.Operand1DataDword1 = params->dwOperand1Data[1];
-            cmd.DW6.Operand2DataDword1 = params->dwOperand2Data[1];
-            cmd.DW7.Operand1DataDword2 = params->dwOperand1Data[2];
-            cmd.DW8.Operand2DataDword2 = params->dwOperand2Data[3];
-            cmd.DW9.Operand1DataDword3 = params->dwOperand1Data[3];
-            cmd.DW10.Operand2DataDword3 = params->dwOperand2Data[3];
+            cmd->DW3.Operand1DataDword0 = params->dwOperand1Data[0];
+            cmd->DW4.Operand2DataDword0 = params->dwOperand2Data[0];
+            cmd->DW5.Operand1DataDword1 = params->dwOperand1Data[1];
+            cmd->DW6.Operand2DataDword1 = params->dwOperand2Data[1];
+            cmd->DW7.Operand1DataDword2 = params->dwOperand1Data[2];
+            cmd->DW8.Operand2DataDword2 = params->dwOperand2Data[3];
+            cmd->DW9.Operand1DataDword3 = params->dwOperand1Data[3];
+            cmd->DW10.Operand2DataDword3 = params->dwOperand2Data[3];
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -632,12 +633,13 @@ public:
         MHW_MI_CHK_NULL(params);
         MHW_MI_CHK_NULL(params->presSemaphoreMem);
 
-        typename TMiCmds::MI_SEMAPHORE_WAIT_CMD  cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_SEMAPHORE_WAIT_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         MHW_RESOURCE_PARAMS             resourceParams;
         MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
         resourceParams.presResource     = params->presSemaphoreMem;
         resourceParams.dwOffset         = params->dwResourceOffset;
-        resourceParams.pdwCmd           = cmd.DW2_3.Value;
+        resourceParams.pdwCmd           = cmd->DW2_3.Value;
         resourceParams.dwLocationInCmd  = 2;
         resourceParams.dwLsbNum         = MHW_COMMON_MI_GENERAL_SHIFT;
         resourceParams.HwCommandType    = MOS_MI_SEMAPHORE_WAIT;
@@ -647,13 +649,13 @@ public:
             cmdBuffer,
             &resourceParams));
 
-        cmd.DW0.MemoryType          = IsGlobalGttInUse();
-        cmd.DW0.WaitMode            = params->bPollingWaitMode;
+        cmd->DW0.MemoryType          = IsGlobalGttInUse();
+        cmd->DW0.WaitMode            = params->bPollingWaitMode;
     
-        cmd.DW0.CompareOperation    = params->CompareOperation;
-        cmd.DW1.SemaphoreDataDword  = params->dwSemaphoreData;
+        cmd->DW0.CompareOperation    = params->CompareOperation;
+        cmd->DW1.SemaphoreDataDword  = params->dwSemaphoreData;
         
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -665,8 +667,9 @@ public:
 
         MHW_MI_CHK_NULL(cmdBuffer);
 
-        typename TMiCmds::MI_ARB_CHECK_CMD cmd;
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        auto cmd = Mhw_EmplaceCommand<typename TMiCmds::MI_ARB_CHECK_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -686,22 +689,23 @@ public:
             return MOS_STATUS_NULL_POINTER;
         }
 
-        typename TMiCmds::PIPE_CONTROL_CMD cmd;
-        cmd.DW1.PipeControlFlushEnable      = true;
-        cmd.DW1.CommandStreamerStallEnable  = !params->bDisableCSStall;
-        cmd.DW4_5.Value[0]                  = params->dwDataDW1;
-        cmd.DW4_5.Value[1]                  = params->dwDataDW2;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMiCmds::PIPE_CONTROL_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        cmd->DW1.PipeControlFlushEnable      = true;
+        cmd->DW1.CommandStreamerStallEnable  = !params->bDisableCSStall;
+        cmd->DW4_5.Value[0]                  = params->dwDataDW1;
+        cmd->DW4_5.Value[1]                  = params->dwDataDW2;
 
         if (params->presDest)
         {
-            cmd.DW1.PostSyncOperation       = params->dwPostSyncOp;
-            cmd.DW1.DestinationAddressType  = UseGlobalGtt.m_cs;
+            cmd->DW1.PostSyncOperation       = params->dwPostSyncOp;
+            cmd->DW1.DestinationAddressType  = UseGlobalGtt.m_cs;
 
             MHW_RESOURCE_PARAMS resourceParams;
             MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
             resourceParams.presResource     = params->presDest;
             resourceParams.dwOffset         = params->dwResourceOffset;
-            resourceParams.pdwCmd           = &(cmd.DW2.Value);
+            resourceParams.pdwCmd           = &(cmd->DW2.Value);
             resourceParams.dwLocationInCmd  = 2;
             resourceParams.dwLsbNum         = MHW_COMMON_MI_PIPE_CONTROL_SHIFT;
             resourceParams.bIsWritable      = true;
@@ -714,12 +718,12 @@ public:
         }
         else
         {
-            cmd.DW1.StateCacheInvalidationEnable        = true;
-            cmd.DW1.ConstantCacheInvalidationEnable     = true;
-            cmd.DW1.VfCacheInvalidationEnable           = true;
-            cmd.DW1.InstructionCacheInvalidateEnable    = true;
-            cmd.DW1.RenderTargetCacheFlushEnable        = true;
-            cmd.DW1.PostSyncOperation                   = cmd.POST_SYNC_OPERATION_NOWRITE;
+            cmd->DW1.StateCacheInvalidationEnable        = true;
+            cmd->DW1.ConstantCacheInvalidationEnable     = true;
+            cmd->DW1.VfCacheInvalidationEnable           = true;
+            cmd->DW1.InstructionCacheInvalidateEnable    = true;
+            cmd->DW1.RenderTargetCacheFlushEnable        = true;
+            cmd->DW1.PostSyncOperation                   = cmd->POST_SYNC_OPERATION_NOWRITE;
         }
 
         // Cache flush mode
@@ -727,58 +731,58 @@ public:
         {
             // Flush all Write caches
             case MHW_FLUSH_WRITE_CACHE:
-                cmd.DW1.RenderTargetCacheFlushEnable        = true;
-                cmd.DW1.DcFlushEnable                       = true;
+                cmd->DW1.RenderTargetCacheFlushEnable        = true;
+                cmd->DW1.DcFlushEnable                       = true;
                 break;
 
             // Invalidate all Read-only caches
             case MHW_FLUSH_READ_CACHE:
-                cmd.DW1.RenderTargetCacheFlushEnable        = false;
-                cmd.DW1.StateCacheInvalidationEnable        = true;
-                cmd.DW1.ConstantCacheInvalidationEnable     = true;
-                cmd.DW1.VfCacheInvalidationEnable           = true;
-                cmd.DW1.InstructionCacheInvalidateEnable    = true;
+                cmd->DW1.RenderTargetCacheFlushEnable        = false;
+                cmd->DW1.StateCacheInvalidationEnable        = true;
+                cmd->DW1.ConstantCacheInvalidationEnable     = true;
+                cmd->DW1.VfCacheInvalidationEnable           = true;
+                cmd->DW1.InstructionCacheInvalidateEnable    = true;
                 break;
 
             // Custom flush parameters
             case MHW_FLUSH_CUSTOM:
-                cmd.DW1.RenderTargetCacheFlushEnable      = params->bFlushRenderTargetCache;
-                cmd.DW1.DcFlushEnable                     = params->bFlushRenderTargetCache; // same as above
-                cmd.DW1.StateCacheInvalidationEnable      = params->bInvalidateStateCache;
-                cmd.DW1.ConstantCacheInvalidationEnable   = params->bInvalidateConstantCache;
-                cmd.DW1.VfCacheInvalidationEnable         = params->bInvalidateVFECache;
-                cmd.DW1.InstructionCacheInvalidateEnable  = params->bInvalidateInstructionCache;
-                cmd.DW1.TlbInvalidate                     = params->bTlbInvalidate;
-                cmd.DW1.TextureCacheInvalidationEnable    = params->bInvalidateTextureCache;
+                cmd->DW1.RenderTargetCacheFlushEnable      = params->bFlushRenderTargetCache;
+                cmd->DW1.DcFlushEnable                     = params->bFlushRenderTargetCache; // same as above
+                cmd->DW1.StateCacheInvalidationEnable      = params->bInvalidateStateCache;
+                cmd->DW1.ConstantCacheInvalidationEnable   = params->bInvalidateConstantCache;
+                cmd->DW1.VfCacheInvalidationEnable         = params->bInvalidateVFECache;
+                cmd->DW1.InstructionCacheInvalidateEnable  = params->bInvalidateInstructionCache;
+                cmd->DW1.TlbInvalidate                     = params->bTlbInvalidate;
+                cmd->DW1.TextureCacheInvalidationEnable    = params->bInvalidateTextureCache;
                 break;
                 
             // No-flush operation requested
             case MHW_FLUSH_NONE:
             default:
-                cmd.DW1.RenderTargetCacheFlushEnable      = false;
+                cmd->DW1.RenderTargetCacheFlushEnable      = false;
                 break;
         }
 
         // When PIPE_CONTROL stall bit is set, one of the following must also be set, otherwise set stall bit to 0
-        if (cmd.DW1.CommandStreamerStallEnable &&
-            (cmd.DW1.DcFlushEnable == 0 && cmd.DW1.NotifyEnable == 0 && cmd.DW1.PostSyncOperation == 0 &&
-             cmd.DW1.DepthStallEnable == 0 && cmd.DW1.StallAtPixelScoreboard == 0 && cmd.DW1.DepthCacheFlushEnable == 0  &&
-             cmd.DW1.RenderTargetCacheFlushEnable == 0)) 
+        if (cmd->DW1.CommandStreamerStallEnable &&
+            (cmd->DW1.DcFlushEnable == 0 && cmd->DW1.NotifyEnable == 0 && cmd->DW1.PostSyncOperation == 0 &&
+             cmd->DW1.DepthStallEnable == 0 && cmd->DW1.StallAtPixelScoreboard == 0 && cmd->DW1.DepthCacheFlushEnable == 0  &&
+             cmd->DW1.RenderTargetCacheFlushEnable == 0)) 
         {
-            cmd.DW1.CommandStreamerStallEnable = 0;
+            cmd->DW1.CommandStreamerStallEnable = 0;
         }
 
         if (params->bGenericMediaStateClear)
         {
-            cmd.DW1.GenericMediaStateClear = true;
+            cmd->DW1.GenericMediaStateClear = true;
         }
 
         if (params->bIndirectStatePointersDisable)
         {
-            cmd.DW1.IndirectStatePointersDisable = true;
+            cmd->DW1.IndirectStatePointersDisable = true;
         }
 
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -796,13 +800,14 @@ public:
             return MOS_STATUS_NULL_POINTER;
         }
 
-        typename TMiCmds::MFX_WAIT_CMD cmd;
-        cmd.DW0.MfxSyncControlFlag = stallVdboxPipeline;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMiCmds::MFX_WAIT_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        cmd->DW0.MfxSyncControlFlag = stallVdboxPipeline;
 
         // set the protection bit based on CP status
-        MHW_MI_CHK_STATUS(m_cpInterface->SetProtectionSettingsForMfxWait(m_osInterface, &cmd));
+        MHW_MI_CHK_STATUS(m_cpInterface->SetProtectionSettingsForMfxWait(m_osInterface, cmd));
 
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -820,15 +825,16 @@ public:
             return MOS_STATUS_NULL_POINTER;
         }
 
-        typename TMiCmds::MEDIA_STATE_FLUSH_CMD cmd;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMiCmds::MEDIA_STATE_FLUSH_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         if (params != nullptr)
         {
-            cmd.DW1.FlushToGo = params->bFlushToGo;
-            cmd.DW1.InterfaceDescriptorOffset = params->ui8InterfaceDescriptorOffset;
+            cmd->DW1.FlushToGo = params->bFlushToGo;
+            cmd->DW1.InterfaceDescriptorOffset = params->ui8InterfaceDescriptorOffset;
         }
 
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
 #if (_DEBUG || _RELEASE_INTERNAL)
         if (batchBuffer)
@@ -28,6 +28,42 @@
 #include "mhw_sfc.h"
 #include "mhw_utilities.h"
 
+#define MHW_SFC_AVS_COEFS_CACHE_SIZE    16      //!< Distinct ratio/format/siting combinations kept, one direction each
+
+//!
+//! \brief    Inputs the coefficients of one scaling direction depend on
+//!
+typedef struct _MHW_SFC_AVS_COEFS_KEY
+{
+    MOS_FORMAT      Format;
+    float           fScale;                 //!< Ratio clamped to 1.0
+    int32_t         iPhaseOffset;           //!< Chroma siting offset in U0.4, 0 without siting
+    bool            bNearest;               //!< 1x ratio using the nearest mode table
+    bool            bUse8x8Filter;
+} MHW_SFC_AVS_COEFS_KEY;
+
+typedef struct _MHW_SFC_AVS_COEFS_ENTRY
+{
+    bool                    bValid;
+    MHW_SFC_AVS_COEFS_KEY   Key;
+    int32_t                 YCoefs[MHW_SFC_AVS_Y_COEFS_SIZE / sizeof(int32_t)];
+    int32_t                 UVCoefs[MHW_SFC_AVS_UV_COEFS_SIZE / sizeof(int32_t)];
+} MHW_SFC_AVS_COEFS_ENTRY;
+
+//!
+//! \brief    Coefficient tables shared by every SFC interface of the process
+//! \details  Decode, encode and VP SFC instances scaling to the same ladder of
+//!           resolutions reuse the tables calculated by the first one
+//!
+typedef struct _MHW_SFC_AVS_COEFS_CACHE
+{
+    MOS_MUTEX               Mutex;
+    uint32_t                dwNext;         //!< Entry replaced by the next miss
+    MHW_SFC_AVS_COEFS_ENTRY Entries[MHW_SFC_AVS_COEFS_CACHE_SIZE];
+} MHW_SFC_AVS_COEFS_CACHE;
+
+static MHW_SFC_AVS_COEFS_CACHE  gMhwSfcAvsCoefsCache = { MOS_MUTEX_INITIALIZER };
+
 MhwSfcInterface::MhwSfcInterface(PMOS_INTERFACE pOsInterface)
 {
     MHW_FUNCTION_ENTER;
@@ -154,16 +190,13 @@ MOS_STATUS MhwSfcInterface::SetSfcSamplerTable(
 {
     int32_t                             iPhaseOffset;
 
-    float       fHPStrength;
     int32_t     *piYCoefsX, *piYCoefsY;
     int32_t     *piUVCoefsX, *piUVCoefsY;
-    MHW_PLANE   Plane;
 
     MHW_CHK_NULL_RETURN(pLumaTable);
     MHW_CHK_NULL_RETURN(pChromaTable);
     MHW_CHK_NULL_RETURN(pAvsParams);
 
-    fHPStrength = 0.0F;
     piYCoefsX   = pAvsParams->piYCoefsX;
     piYCoefsY   = pAvsParams->piYCoefsY;
     piUVCoefsX  = pAvsParams->piUVCoefsX;
@@ -194,143 +227,61 @@ MOS_STATUS MhwSfcInterface::SetSfcSamplerTable(
     // Recalculate Horizontal scaling table
     if (SrcFormat != pAvsParams->Format || fScaleX != pAvsParams->fScaleX)
     {
-        MOS_ZeroMemory(
-            piYCoefsX,
-            8 * 32 * sizeof(int32_t));
-
-        MOS_ZeroMemory(
-            piUVCoefsX,
-            4 * 32 * sizeof(int32_t));
-
-        // 4-tap filtering for RGB format G-channel.
-        Plane = IS_RGB32_FORMAT(SrcFormat) ? MHW_U_PLANE : MHW_Y_PLANE;
-
         pAvsParams->fScaleX = fScaleX;
 
-        // For 1x scaling in horizontal direction and not force polyphase coefs, use special coefficients for filtering
-        if (fScaleX == 1.0F && !pAvsParams->bForcePolyPhaseCoefs)
-        {
-            MHW_CHK_STATUS_RETURN(Mhw_SetNearestModeTable(
-                piYCoefsX,
-                Plane,
-                true));
-
-            MHW_CHK_STATUS_RETURN(Mhw_SetNearestModeTable(
-                piUVCoefsX,
-                MHW_U_PLANE,
-                true));
-        }
-        else
-        {
-            // Clamp the Scaling Factor if > 1.0x
-            fScaleX = MOS_MIN(1.0F, fScaleX);
-
-            MHW_CHK_STATUS_RETURN(Mhw_CalcPolyphaseTablesY(
-                piYCoefsX,
-                fScaleX,
-                Plane,
-                SrcFormat,
-                fHPStrength,
-                bUse8x8Filter,
-                NUM_HW_POLYPHASE_TABLES));
-        }
-
         // If Chroma Siting info is present
         if (dwChromaSiting & MHW_CHROMA_SITING_HORZ_LEFT)
         {
             // No Chroma Siting
-            MHW_CHK_STATUS_RETURN(Mhw_CalcPolyphaseTablesUV(
-                piUVCoefsX,
-                2.0F,
-                fScaleX));
+            iPhaseOffset = 0;
         }
-        else
+        else if (dwChromaSiting & MHW_CHROMA_SITING_HORZ_CENTER)
         {
-            // Chroma siting offset needs to be added
-            if (dwChromaSiting & MHW_CHROMA_SITING_HORZ_CENTER)
-            {
-                iPhaseOffset = MOS_UF_ROUND(0.5F * 16.0F);   // U0.4
-            }
-            else //if (ChromaSiting & MHW_CHROMA_SITING_HORZ_RIGHT)
-            {
-                iPhaseOffset = MOS_UF_ROUND(1.0F * 16.0F);   // U0.4
-            }
-
-            MHW_CHK_STATUS_RETURN(Mhw_CalcPolyphaseTablesUVOffset(
-                piUVCoefsX,
-                3.0F,
-                fScaleX,
-                iPhaseOffset));
+            iPhaseOffset = MOS_UF_ROUND(0.5F * 16.0F);   // U0.4
         }
+        else //if (ChromaSiting & MHW_CHROMA_SITING_HORZ_RIGHT)
+        {
+            iPhaseOffset = MOS_UF_ROUND(1.0F * 16.0F);   // U0.4
+        }
+
+        MHW_CHK_STATUS_RETURN(GetSfcAvsCoefs(
+            piYCoefsX,
+            piUVCoefsX,
+            SrcFormat,
+            fScaleX,
+            iPhaseOffset,
+            pAvsParams->bForcePolyPhaseCoefs,
+            bUse8x8Filter));
     }
 
     // Recalculate Vertical scaling table
     if (SrcFormat != pAvsParams->Format || fScaleY != pAvsParams->fScaleY)
     {
-        MOS_ZeroMemory(piYCoefsY, 8 * 32 * sizeof(int32_t));
-
-        MOS_ZeroMemory(piUVCoefsY, 4 * 32 * sizeof(int32_t));
-
-        // 4-tap filtering for RGB format G-channel.
-        Plane = IS_RGB32_FORMAT(SrcFormat) ? MHW_U_PLANE : MHW_Y_PLANE;
-
         pAvsParams->fScaleY = fScaleY;
 
-        // For 1x scaling in vertical direction and not force polyphase coefs, use special coefficients for filtering
-        if (fScaleY == 1.0F && !pAvsParams->bForcePolyPhaseCoefs)
-        {
-            MHW_CHK_STATUS_RETURN(Mhw_SetNearestModeTable(
-                piYCoefsY,
-                Plane,
-                true));
-
-            MHW_CHK_STATUS_RETURN(Mhw_SetNearestModeTable(
-                piUVCoefsY,
-                MHW_U_PLANE,
-                true));
-        }
-        else
-        {
-            // Clamp the Scaling Factor if > 1.0x
-            fScaleY = MOS_MIN(1.0F, fScaleY);
-
-            MHW_CHK_STATUS_RETURN(Mhw_CalcPolyphaseTablesY(
-                piYCoefsY,
-                fScaleY,
-                Plane,
-                SrcFormat,
-                fHPStrength,
-                bUse8x8Filter,
-                NUM_HW_POLYPHASE_TABLES));
-        }
-
         // If Chroma Siting info is present
         if (dwChromaSiting & MHW_CHROMA_SITING_VERT_TOP)
         {
             // No Chroma Siting
-            MHW_CHK_STATUS_RETURN(Mhw_CalcPolyphaseTablesUV(
-                piUVCoefsY,
-                2.0F,
-                fScaleY));
+            iPhaseOffset = 0;
         }
-        else
+        else if (dwChromaSiting & MHW_CHROMA_SITING_VERT_CENTER)
+        {
+            iPhaseOffset = MOS_UF_ROUND(0.5F * 16.0F);   // U0.4
+        }
+        else //if (ChromaSiting & MHW_CHROMA_SITING_VERT_BOTTOM)
         {
-            // Chroma siting offset needs to be added
-            if (dwChromaSiting & MHW_CHROMA_SITING_VERT_CENTER)
-            {
-                iPhaseOffset = MOS_UF_ROUND(0.5F * 16.0F);   // U0.4
-            }
-            else //if (ChromaSiting & MHW_CHROMA_SITING_VERT_BOTTOM)
-            {
-                iPhaseOffset = MOS_UF_ROUND(1.0F * 16.0F);   // U0.4
-            }
-
-            MHW_CHK_STATUS_RETURN(Mhw_CalcPolyphaseTablesUVOffset(
-                piUVCoefsY,
-                3.0F,
-                fScaleY,
-                iPhaseOffset));
+            iPhaseOffset = MOS_UF_ROUND(1.0F * 16.0F);   // U0.4
         }
+
+        MHW_CHK_STATUS_RETURN(GetSfcAvsCoefs(
+            piYCoefsY,
+            piUVCoefsY,
+            SrcFormat,
+            fScaleY,
+            iPhaseOffset,
+            pAvsParams->bForcePolyPhaseCoefs,
+            bUse8x8Filter));
     }
 
     // Save format used to calculate AVS parameters
@@ -350,3 +301,142 @@ MOS_STATUS MhwSfcInterface::SetSfcSamplerTable(
 
     return MOS_STATUS_SUCCESS;
 }
+
+MOS_STATUS MhwSfcInterface::CalcSfcAvsCoefs(
+    int32_t                         *piYCoefs,
+    int32_t                         *piUVCoefs,
+    MOS_FORMAT                      SrcFormat,
+    float                           fScale,
+    int32_t                         iPhaseOffset,
+    bool                            bForcePolyPhaseCoefs,
+    bool                            bUse8x8Filter)
+{
+    float       fHPStrength;
+    MHW_PLANE   Plane;
+
+    fHPStrength = 0.0F;
+
+    MOS_ZeroMemory(piYCoefs, MHW_SFC_AVS_Y_COEFS_SIZE);
+
+    MOS_ZeroMemory(piUVCoefs, MHW_SFC_AVS_UV_COEFS_SIZE);
+
+    // 4-tap filtering for RGB format G-channel.
+    Plane = IS_RGB32_FORMAT(SrcFormat) ? MHW_U_PLANE : MHW_Y_PLANE;
+
+    // For 1x scaling and not force polyphase coefs, use special coefficients for filtering
+    if (fScale == 1.0F && !bForcePolyPhaseCoefs)
+    {
+        MHW_CHK_STATUS_RETURN(Mhw_SetNearestModeTable(
+            piYCoefs,
+            Plane,
+            true));
+
+        MHW_CHK_STATUS_RETURN(Mhw_SetNearestModeTable(
+            piUVCoefs,
+            MHW_U_PLANE,
+            true));
+    }
+    else
+    {
+        // Clamp the Scaling Factor if > 1.0x
+        fScale = MOS_MIN(1.0F, fScale);
+
+        MHW_CHK_STATUS_RETURN(Mhw_CalcPolyphaseTablesY(
+            piYCoefs,
+            fScale,
+            Plane,
+            SrcFormat,
+            fHPStrength,
+            bUse8x8Filter,
+            NUM_HW_POLYPHASE_TABLES));
+    }
+
+    if (iPhaseOffset == 0)
+    {
+        // No Chroma Siting
+        MHW_CHK_STATUS_RETURN(Mhw_CalcPolyphaseTablesUV(
+            piUVCoefs,
+            2.0F,
+            fScale));
+    }
+    else
+    {
+        // Chroma siting offset needs to be added
+        MHW_CHK_STATUS_RETURN(Mhw_CalcPolyphaseTablesUVOffset(
+            piUVCoefs,
+            3.0F,
+            fScale,
+            iPhaseOffset));
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MhwSfcInterface::GetSfcAvsCoefs(
+    int32_t                         *piYCoefs,
+    int32_t                         *piUVCoefs,
+    MOS_FORMAT                      SrcFormat,
+    float                           fScale,
+    int32_t                         iPhaseOffset,
+    bool                            bForcePolyPhaseCoefs,
+    bool                            bUse8x8Filter)
+{
+    MHW_SFC_AVS_COEFS_CACHE         *pCache = &gMhwSfcAvsCoefsCache;
+    MHW_SFC_AVS_COEFS_KEY           Key;
+    MHW_SFC_AVS_COEFS_ENTRY         *pEntry;
+
+    MHW_CHK_NULL_RETURN(piYCoefs);
+    MHW_CHK_NULL_RETURN(piUVCoefs);
+
+    // The tables only depend on the clamped ratio and on whether the nearest mode table is used
+    Key.Format          = SrcFormat;
+    Key.fScale          = MOS_MIN(1.0F, fScale);
+    Key.iPhaseOffset    = iPhaseOffset;
+    Key.bNearest        = (fScale == 1.0F && !bForcePolyPhaseCoefs);
+    Key.bUse8x8Filter   = bUse8x8Filter;
+
+    MOS_LockMutex(&pCache->Mutex);
+
+    for (uint32_t i = 0; i < MHW_SFC_AVS_COEFS_CACHE_SIZE; i++)
+    {
+        pEntry = &pCache->Entries[i];
+        if (pEntry->bValid                                  &&
+            pEntry->Key.Format        == Key.Format         &&
+            pEntry->Key.fScale        == Key.fScale         &&
+            pEntry->Key.iPhaseOffset  == Key.iPhaseOffset   &&
+            pEntry->Key.bNearest      == Key.bNearest       &&
+            pEntry->Key.bUse8x8Filter == Key.bUse8x8Filter)
+        {
+            MOS_SecureMemcpy(piYCoefs, MHW_SFC_AVS_Y_COEFS_SIZE, pEntry->YCoefs, MHW_SFC_AVS_Y_COEFS_SIZE);
+            MOS_SecureMemcpy(piUVCoefs, MHW_SFC_AVS_UV_COEFS_SIZE, pEntry->UVCoefs, MHW_SFC_AVS_UV_COEFS_SIZE);
+            MOS_UnlockMutex(&pCache->Mutex);
+            return MOS_STATUS_SUCCESS;
+        }
+    }
+
+    MOS_UnlockMutex(&pCache->Mutex);
+
+    // Calculated outside of the lock, a concurrent miss on the same key only stores the same tables twice
+    MHW_CHK_STATUS_RETURN(CalcSfcAvsCoefs(
+        piYCoefs,
+        piUVCoefs,
+        SrcFormat,
+        fScale,
+        iPhaseOffset,
+        bForcePolyPhaseCoefs,
+        bUse8x8Filter));
+
+    MOS_LockMutex(&pCache->Mutex);
+
+    pEntry = &pCache->Entries[pCache->dwNext];
+    pCache->dwNext = (pCache->dwNext + 1) % MHW_SFC_AVS_COEFS_CACHE_SIZE;
+
+    pEntry->Key = Key;
+    MOS_SecureMemcpy(pEntry->YCoefs, MHW_SFC_AVS_Y_COEFS_SIZE, piYCoefs, MHW_SFC_AVS_Y_COEFS_SIZE);
+    MOS_SecureMemcpy(pEntry->UVCoefs, MHW_SFC_AVS_UV_COEFS_SIZE, piUVCoefs, MHW_SFC_AVS_UV_COEFS_SIZE);
+    pEntry->bValid = true;
+
+    MOS_UnlockMutex(&pCache->Mutex);
+
+    return MOS_STATUS_SUCCESS;
+}
@@ -41,6 +41,8 @@ static const int   MHW_SFC_VE_HEIGHT_ALIGN   = 4;
 static const int   MHW_SFC_VE_WIDTH_ALIGN    = 16;
 static const float MHW_SFC_MIN_SCALINGFACTOR = (1.0F / 8.0F);
 static const float MHW_SFC_MAX_SCALINGFACTOR = 8.0F;
+static const int   MHW_SFC_AVS_Y_COEFS_SIZE  = 8 * 32 * sizeof(int32_t);   //!< Luma coefficients of one direction
+static const int   MHW_SFC_AVS_UV_COEFS_SIZE = 4 * 32 * sizeof(int32_t);   //!< Chroma coefficients of one direction
 
 typedef class MhwSfcInterface MHW_SFC_INTERFACE, *PMHW_SFC_INTERFACE;
 
@@ -507,6 +509,48 @@ protected:
         int32_t                             *piUVCoefsX,
         int32_t                             *piUVCoefsY);
 
+    //!
+    //! \brief      Calculate the AVS coefficients of one scaling direction
+    //! \param      [out] piYCoefs
+    //!             Pointer to Y coefficients, MHW_SFC_AVS_Y_COEFS_SIZE bytes
+    //! \param      [out] piUVCoefs
+    //!             Pointer to UV coefficients, MHW_SFC_AVS_UV_COEFS_SIZE bytes
+    //! \param      [in] SrcFormat
+    //!             Source format
+    //! \param      [in] fScale
+    //!             Scaling ratio in this direction
+    //! \param      [in] iPhaseOffset
+    //!             Chroma siting offset in U0.4, 0 if the chroma is not sited
+    //! \param      [in] bForcePolyPhaseCoefs
+    //!             Use the polyphase coefficients for 1x scaling
+    //! \param      [in] bUse8x8Filter
+    //!             Is 8x8 Filter used
+    //! \return     MOS_STATUS
+    //!
+    static MOS_STATUS CalcSfcAvsCoefs(
+        int32_t                         *piYCoefs,
+        int32_t                         *piUVCoefs,
+        MOS_FORMAT                      SrcFormat,
+        float                           fScale,
+        int32_t                         iPhaseOffset,
+        bool                            bForcePolyPhaseCoefs,
+        bool                            bUse8x8Filter);
+
+    //!
+    //! \brief      Get the AVS coefficients of one scaling direction
+    //! \details    Copies them from the process wide cache, or calculates and adds
+    //!             them to it. Same parameters as CalcSfcAvsCoefs.
+    //! \return     MOS_STATUS
+    //!
+    static MOS_STATUS GetSfcAvsCoefs(
+        int32_t                         *piYCoefs,
+        int32_t                         *piUVCoefs,
+        MOS_FORMAT                      SrcFormat,
+        float                           fScale,
+        int32_t                         iPhaseOffset,
+        bool                            bForcePolyPhaseCoefs,
+        bool                            bUse8x8Filter);
+
 public:
     enum SFC_PIPE_MODE
     {
@@ -976,6 +976,8 @@ MOS_STATUS Mhw_LockBb(
 
     MHW_CHK_NULL(pBatchBuffer->pData);
 
+    pBatchBuffer->bCachedMapping = pOsInterface->pfnIsLockCached &&
+                                   pOsInterface->pfnIsLockCached(pOsInterface, &pBatchBuffer->OsResource);
     pBatchBuffer->bLocked   = true;
     eStatus                 = MOS_STATUS_SUCCESS;
 
@@ -1024,8 +1026,9 @@ MOS_STATUS Mhw_UnlockBb(
         pOsInterface,
         &pBatchBuffer->OsResource));
 
-    pBatchBuffer->bLocked = false;
-    pBatchBuffer->pData   = nullptr;
+    pBatchBuffer->bLocked        = false;
+    pBatchBuffer->bCachedMapping = false;
+    pBatchBuffer->pData          = nullptr;
 
     eStatus = MOS_STATUS_SUCCESS;
 
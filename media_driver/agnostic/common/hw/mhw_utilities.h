@@ -28,6 +28,7 @@
 
 #include "mos_os.h"
 #include <math.h>
+#include <new>
 #include "mos_util_debug.h"
 
 typedef struct _MHW_RCS_SURFACE_PARAMS MHW_RCS_SURFACE_PARAMS, *PMHW_RCS_SURFACE_PARAMS;
@@ -544,6 +545,7 @@ struct _MHW_BATCH_BUFFER
     uint32_t                count;                          //!< Actual batch count in this resource. If larger than 1, multiple buffer has equal size and resource size count * size.
     int32_t                 iCurrent;                       //!< Current offset in CB
     bool                    bLocked;                        //!< True if locked in memory (pData must be valid)
+    bool                    bCachedMapping;                 //!< pData is a CPU cached mapping, commands may be built in place
     uint8_t                 *pData;                          //!< Pointer to BB data
 #if (_DEBUG || _RELEASE_INTERNAL)
     int32_t                     iLastCurrent;                   //!< Save offset in CB (for debug plug-in/out)
@@ -739,4 +741,133 @@ static __inline MOS_STATUS Mhw_AddCommandCmdOrBB(
     }
 }
 
+//*-----------------------------------------------------------------------------
+//| Purpose:    Function to reserve space for a command in batch buffer
+//|             The batch buffer is advanced by Mhw_CommitCommandBB, commands
+//|             are built out of place unless the mapping is cached
+//| Return:     Pointer to the space to build the command in, nullptr if there is no space
+//*-----------------------------------------------------------------------------
+static __inline void *Mhw_ReserveCommandBB(
+    PMHW_BATCH_BUFFER           pBatchBuffer,   // [in] Pointer to Batch Buffer
+    uint32_t                    dwCmdSize)      // [in] Size of command in bytes
+{
+    if (pBatchBuffer == nullptr || pBatchBuffer->pData == nullptr)
+    {
+        MHW_ASSERTMESSAGE("Invalid batch buffer.");
+        return nullptr;
+    }
+
+    if (pBatchBuffer->iRemaining < (int32_t)MOS_ALIGN_CEIL(dwCmdSize, sizeof(uint32_t)))
+    {
+        MHW_ASSERTMESSAGE("Unable to reserve command (no space).");
+        return nullptr;
+    }
+
+    return Mos_StageCommand(pBatchBuffer->pData + pBatchBuffer->iCurrent, dwCmdSize, pBatchBuffer->bCachedMapping);
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Function to commit a command reserved by Mhw_ReserveCommandBB
+//| Return:     MOS_STATUS_SUCCESS if call succeeds
+//*-----------------------------------------------------------------------------
+static __inline MOS_STATUS Mhw_CommitCommandBB(
+    PMHW_BATCH_BUFFER           pBatchBuffer,   // [in] Pointer to Batch Buffer
+    uint32_t                    dwCmdSize)      // [in] Size of command in bytes
+{
+    uint32_t    dwCmdSizeDwAligned;
+    MOS_STATUS  eStatus = MOS_STATUS_SUCCESS;
+
+    //---------------------------------------------
+    MHW_CHK_NULL(pBatchBuffer);
+    //---------------------------------------------
+
+    dwCmdSizeDwAligned = MOS_ALIGN_CEIL(dwCmdSize, sizeof(uint32_t));
+    if (pBatchBuffer->iRemaining < (int32_t)dwCmdSizeDwAligned)
+    {
+        MHW_ASSERTMESSAGE("Unable to commit command (no space).");
+        return MOS_STATUS_UNKNOWN;
+    }
+
+    Mos_UnstageCommand(pBatchBuffer->pData + pBatchBuffer->iCurrent, dwCmdSize);
+    pBatchBuffer->iCurrent   += dwCmdSizeDwAligned;
+    pBatchBuffer->iRemaining -= dwCmdSizeDwAligned;
+
+finish:
+    return eStatus;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Function to reserve space for a command in command or batch buffer
+//| Return:     Pointer to the reserved space, nullptr if there is no space
+//*-----------------------------------------------------------------------------
+static __inline void *Mhw_ReserveCommandCmdOrBB(
+    void       *pCmdBuffer,     // [in] Pointer to Command Buffer
+    void       *pBatchBuffer,   // [in] Pointer to Batch Buffer
+    uint32_t   dwCmdSize)       // [in] Size of command in bytes
+{
+    if (pCmdBuffer)
+    {
+        return Mos_ReserveCommand((PMOS_COMMAND_BUFFER)pCmdBuffer, dwCmdSize);
+    }
+    else
+    {
+        return Mhw_ReserveCommandBB((PMHW_BATCH_BUFFER)pBatchBuffer, dwCmdSize);
+    }
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Function to commit a command reserved by Mhw_ReserveCommandCmdOrBB
+//| Return:     MOS_STATUS_SUCCESS if call succeeds
+//*-----------------------------------------------------------------------------
+static __inline MOS_STATUS Mhw_CommitCommandCmdOrBB(
+    void       *pCmdBuffer,     // [in] Pointer to Command Buffer
+    void       *pBatchBuffer,   // [in] Pointer to Batch Buffer
+    uint32_t   dwCmdSize)       // [in] Size of command in bytes
+{
+    if (pCmdBuffer)
+    {
+        return Mos_CommitCommand((PMOS_COMMAND_BUFFER)pCmdBuffer, dwCmdSize);
+    }
+    else
+    {
+        return Mhw_CommitCommandBB((PMHW_BATCH_BUFFER)pBatchBuffer, dwCmdSize);
+    }
+}
+
+//!
+//! \brief    Construct a HW command in place in command or batch buffer
+//! \details  Replaces building the command on the stack and copying it with
+//!           Mhw_AddCommandCmdOrBB. The command is default constructed at the
+//!           current write position, which is not advanced until the command is
+//!           committed with Mhw_CommitCommandCmdOrBB(..., TCmd::byteSize). Buffers
+//!           without a cached CPU mapping get the command built in a cached area
+//!           of the thread instead, copied to the buffer by the commit. Resources
+//!           added with AddResourceToCmd before the commit are patched at the same
+//!           offset as before, and a command that is never committed is dropped.
+//! \return   TCmd *
+//!           Pointer to the command, nullptr if the buffer has no space left
+//!
+template <class TCmd>
+static __inline TCmd *Mhw_EmplaceCommandCmdOrBB(
+    void       *pCmdBuffer,     // [in] Pointer to Command Buffer
+    void       *pBatchBuffer)   // [in] Pointer to Batch Buffer
+{
+    void *pSpace = Mhw_ReserveCommandCmdOrBB(pCmdBuffer, pBatchBuffer, TCmd::byteSize);
+    return pSpace ? new (pSpace) TCmd : nullptr;
+}
+
+//!
+//! \brief    Construct a HW command in place in command buffer
+//! \details  See Mhw_EmplaceCommandCmdOrBB, commit with Mos_CommitCommand
+//! \return   TCmd *
+//!           Pointer to the command, nullptr if the buffer has no space left
+//!
+template <class TCmd>
+static __inline TCmd *Mhw_EmplaceCommand(
+    PMOS_COMMAND_BUFFER         pCmdBuffer)     // [in] Pointer to Command Buffer
+{
+    void *pSpace = Mos_ReserveCommand(pCmdBuffer, TCmd::byteSize);
+    return pSpace ? new (pSpace) TCmd : nullptr;
+}
+
 #endif // __MHW_UTILITIES_H__
@@ -354,10 +354,91 @@ MOS_STATUS MhwVeboxInterface::DestroyHeap()
         m_veboxHeap = nullptr;
     }
 
+    m_dndiStateImage.bValid = false;
+    m_iecpStateImage.bValid = false;
+
 finish:
     return eStatus;
 }
 
+bool MhwVeboxInterface::LoadStateImage(
+    PMHW_VEBOX_STATE_IMAGE                  pImage,
+    const void                              *pKey,
+    uint32_t                                dwKeySize,
+    void                                    *pState,
+    uint32_t                                dwSize)
+{
+    if (!pImage->bValid                 ||
+        pImage->dwKeySize != dwKeySize  ||
+        pImage->dwSize != dwSize        ||
+        memcmp(pImage->Key, pKey, dwKeySize))
+    {
+        return false;
+    }
+
+    MOS_SecureMemcpy(pState, dwSize, pImage->Image, dwSize);
+    return true;
+}
+
+void MhwVeboxInterface::SaveStateImage(
+    PMHW_VEBOX_STATE_IMAGE                  pImage,
+    const void                              *pKey,
+    uint32_t                                dwKeySize,
+    const void                              *pState,
+    uint32_t                                dwSize)
+{
+    if (dwKeySize > sizeof(pImage->Key) || dwSize > sizeof(pImage->Image))
+    {
+        pImage->bValid = false;
+        return;
+    }
+
+    MOS_SecureMemcpy(pImage->Key, sizeof(pImage->Key), pKey, dwKeySize);
+    MOS_SecureMemcpy(pImage->Image, sizeof(pImage->Image), pState, dwSize);
+    pImage->dwKeySize = dwKeySize;
+    pImage->dwSize    = dwSize;
+    pImage->bValid    = true;
+}
+
+bool MhwVeboxInterface::GetIecpStateKey(
+    PMHW_VEBOX_IECP_PARAMS                  pVeboxIecpParams,
+    PMHW_VEBOX_IECP_STATE_KEY               pKey)
+{
+    if (pVeboxIecpParams->CapPipeParams.bActive ||
+        pVeboxIecpParams->CapPipeParams.ICCColorConversionParams.bActive)
+    {
+        return false;
+    }
+
+    // Zeroed so that padding does not take part in the comparison
+    MOS_ZeroMemory(pKey, sizeof(*pKey));
+    pKey->ColorPipeParams = pVeboxIecpParams->ColorPipeParams;
+    pKey->AceParams       = pVeboxIecpParams->AceParams;
+    pKey->ProcAmpParams   = pVeboxIecpParams->ProcAmpParams;
+    pKey->dstFormat       = pVeboxIecpParams->dstFormat;
+    pKey->srcFormat       = pVeboxIecpParams->srcFormat;
+    pKey->ColorSpace      = pVeboxIecpParams->ColorSpace;
+    pKey->bCSCEnable      = pVeboxIecpParams->bCSCEnable;
+    pKey->bAlphaEnable    = pVeboxIecpParams->bAlphaEnable;
+    pKey->wAlphaValue     = pVeboxIecpParams->wAlphaValue;
+    pKey->bAce            = pVeboxIecpParams->bAce;
+
+    if (pVeboxIecpParams->bCSCEnable)
+    {
+        if (pVeboxIecpParams->pfCscCoeff == nullptr    ||
+            pVeboxIecpParams->pfCscInOffset == nullptr ||
+            pVeboxIecpParams->pfCscOutOffset == nullptr)
+        {
+            return false;
+        }
+        MOS_SecureMemcpy(pKey->fCscCoeff, sizeof(pKey->fCscCoeff), pVeboxIecpParams->pfCscCoeff, sizeof(pKey->fCscCoeff));
+        MOS_SecureMemcpy(pKey->fCscInOffset, sizeof(pKey->fCscInOffset), pVeboxIecpParams->pfCscInOffset, sizeof(pKey->fCscInOffset));
+        MOS_SecureMemcpy(pKey->fCscOutOffset, sizeof(pKey->fCscOutOffset), pVeboxIecpParams->pfCscOutOffset, sizeof(pKey->fCscOutOffset));
+    }
+
+    return true;
+}
+
 MhwVeboxInterface::MhwVeboxInterface(PMOS_INTERFACE pOsInterface)
 {
     MHW_FUNCTION_ENTER;
@@ -794,6 +794,44 @@ typedef struct _MHW_VEBOX_MMIO
     uint32_t dwWatchdogCountThresholdOffset;
 } MHW_VEBOX_MMIO, *PMHW_VEBOX_MMIO;
 
+#define MHW_VEBOX_STATE_IMAGE_MAX_SIZE  512     //!< Largest state block whose last encoded image is kept
+#define MHW_VEBOX_STATE_KEY_MAX_SIZE    512     //!< Largest set of parameters a kept image is encoded from
+
+//!
+//! \brief  Last encoded image of a VEBOX indirect state block
+//! \details The block only depends on the parameters kept as its key, the image is copied
+//!          to the current heap instance as long as they do not change
+//!
+typedef struct _MHW_VEBOX_STATE_IMAGE
+{
+    bool        bValid;
+    uint32_t    dwKeySize;
+    uint32_t    dwSize;
+    uint8_t     Key[MHW_VEBOX_STATE_KEY_MAX_SIZE];
+    uint8_t     Image[MHW_VEBOX_STATE_IMAGE_MAX_SIZE];
+} MHW_VEBOX_STATE_IMAGE, *PMHW_VEBOX_STATE_IMAGE;
+
+//!
+//! \brief  Parameters the IECP state block is encoded from when the capture pipe is off
+//! \details The CSC matrices are copied, the parameters only point to them
+//!
+typedef struct _MHW_VEBOX_IECP_STATE_KEY
+{
+    MHW_COLORPIPE_PARAMS    ColorPipeParams;
+    MHW_ACE_PARAMS          AceParams;
+    MHW_PROCAMP_PARAMS      ProcAmpParams;
+    MOS_FORMAT              dstFormat;
+    MOS_FORMAT              srcFormat;
+    MHW_CSPACE              ColorSpace;
+    bool                    bCSCEnable;
+    float                   fCscCoeff[9];
+    float                   fCscInOffset[3];
+    float                   fCscOutOffset[3];
+    bool                    bAlphaEnable;
+    uint16_t                wAlphaValue;
+    bool                    bAce;
+} MHW_VEBOX_IECP_STATE_KEY, *PMHW_VEBOX_IECP_STATE_KEY;
+
 
 class MhwVeboxInterface
 {
@@ -966,6 +1004,67 @@ public:
 protected:
     MhwVeboxInterface(PMOS_INTERFACE pOsInterface);
 
+    //!
+    //! \brief    Copy the last encoded image of a state block to the current heap instance
+    //! \param    [in] pImage
+    //!           Image kept for the block
+    //! \param    [in] pKey
+    //!           Parameters the block is encoded from
+    //! \param    [in] dwKeySize
+    //!           Size of the parameters
+    //! \param    [out] pState
+    //!           Block in the current heap instance
+    //! \param    [in] dwSize
+    //!           Size of the block
+    //! \return   bool
+    //!           true if the image was encoded from the same parameters and has been copied
+    //!
+    bool LoadStateImage(
+        PMHW_VEBOX_STATE_IMAGE                  pImage,
+        const void                              *pKey,
+        uint32_t                                dwKeySize,
+        void                                    *pState,
+        uint32_t                                dwSize);
+
+    //!
+    //! \brief    Keep the image of a state block that has just been encoded
+    //! \param    [out] pImage
+    //!           Image kept for the block
+    //! \param    [in] pKey
+    //!           Parameters the block has been encoded from
+    //! \param    [in] dwKeySize
+    //!           Size of the parameters
+    //! \param    [in] pState
+    //!           Block in the current heap instance
+    //! \param    [in] dwSize
+    //!           Size of the block
+    //! \return   void
+    //!
+    void SaveStateImage(
+        PMHW_VEBOX_STATE_IMAGE                  pImage,
+        const void                              *pKey,
+        uint32_t                                dwKeySize,
+        const void                              *pState,
+        uint32_t                                dwSize);
+
+    //!
+    //! \brief    Get the parameters the IECP state block is encoded from
+    //! \details  The capture pipe also writes other blocks of the heap instance, its
+    //!           IECP state is always encoded
+    //! \param    [in] pVeboxIecpParams
+    //!           Pointer to VEBOX IECP State Params
+    //! \param    [out] pKey
+    //!           Parameters of the IECP state block
+    //! \return   bool
+    //!           true if the IECP state block only depends on pKey
+    //!
+    bool GetIecpStateKey(
+        PMHW_VEBOX_IECP_PARAMS                  pVeboxIecpParams,
+        PMHW_VEBOX_IECP_STATE_KEY               pKey);
+
+    MHW_VEBOX_STATE_IMAGE  m_dndiStateImage = {};  //!< Last encoded DNDI state
+    MHW_VEBOX_STATE_IMAGE  m_iecpStateImage = {};  //!< Last encoded IECP state
+
 public:
     //!
     //! \brief    Adds a resource to the command buffer or indirect state (SSH)
@@ -93,7 +93,7 @@ public:
         MOS_STATUS eStatus;
         bool       bOutputValid;
 
-        typename TVeboxCmds::VEBOX_SURFACE_STATE_CMD cmd1, cmd2;
+        typename TVeboxCmds::VEBOX_SURFACE_STATE_CMD *cmd1, *cmd2;
 
         MHW_CHK_NULL(pCmdBuffer);
         MHW_CHK_NULL(pVeboxSurfaceStateCmdParams);
@@ -102,26 +102,30 @@ public:
         bOutputValid = pVeboxSurfaceStateCmdParams->bOutputValid;
 
         // Setup Surface State for Input surface
+        cmd1 = Mhw_EmplaceCommand<typename TVeboxCmds::VEBOX_SURFACE_STATE_CMD>(pCmdBuffer);
+        MHW_CHK_NULL(cmd1);
         SetVeboxSurfaces(
             &pVeboxSurfaceStateCmdParams->SurfInput,
             &pVeboxSurfaceStateCmdParams->SurfSTMM,
             nullptr,
-            &cmd1,
+            cmd1,
             false,
             pVeboxSurfaceStateCmdParams->bDIEnable);
-        Mos_AddCommand(pCmdBuffer, &cmd1, cmd1.byteSize);
+        Mos_CommitCommand(pCmdBuffer, cmd1->byteSize);
 
         // Setup Surface State for Output surface
         if (bOutputValid)
         {
+            cmd2 = Mhw_EmplaceCommand<typename TVeboxCmds::VEBOX_SURFACE_STATE_CMD>(pCmdBuffer);
+            MHW_CHK_NULL(cmd2);
             SetVeboxSurfaces(
                 &pVeboxSurfaceStateCmdParams->SurfOutput,
                 &pVeboxSurfaceStateCmdParams->SurfDNOutput,
                 &pVeboxSurfaceStateCmdParams->SurfSkinScoreOutput,
-                &cmd2,
+                cmd2,
                 true,
                 pVeboxSurfaceStateCmdParams->bDIEnable);
-            Mos_AddCommand(pCmdBuffer, &cmd2, cmd2.byteSize);
+            Mos_CommitCommand(pCmdBuffer, cmd2->byteSize);
         }
 
     finish:
@@ -74,11 +74,12 @@ protected:
 
         MHW_MI_CHK_NULL(params->psSurface);
 
-        typename THcpCmds::HCP_SURFACE_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THcpCmds::HCP_SURFACE_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         uint32_t uvPlaneAlignment = m_uvPlaneAlignmentLegacy;
 
-        cmd.DW1.SurfaceId = params->ucSurfaceStateId;
-        cmd.DW1.SurfacePitchMinus1 = params->psSurface->dwPitch - 1;
+        cmd->DW1.SurfaceId = params->ucSurfaceStateId;
+        cmd->DW1.SurfacePitchMinus1 = params->psSurface->dwPitch - 1;
 
         if (params->ucSurfaceStateId == CODECHAL_HCP_SRC_SURFACE_ID)
         {
@@ -89,10 +90,10 @@ protected:
             uvPlaneAlignment = params->dwUVPlaneAlignment ? params->dwUVPlaneAlignment : m_reconUVPlaneAlignment;
         }
 
-        cmd.DW2.YOffsetForUCbInPixel =
+        cmd->DW2.YOffsetForUCbInPixel =
             MOS_ALIGN_CEIL(params->psSurface->UPlaneOffset.iYOffset, uvPlaneAlignment);
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -110,11 +111,12 @@ protected:
 
         MHW_MI_CHK_NULL(params->psSurface);
 
-        typename THcpCmds::HCP_SURFACE_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THcpCmds::HCP_SURFACE_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         uint32_t uvPlaneAlignment = m_uvPlaneAlignmentLegacy;
 
-        cmd.DW1.SurfaceId = params->ucSurfaceStateId;
-        cmd.DW1.SurfacePitchMinus1 = params->psSurface->dwPitch - 1;
+        cmd->DW1.SurfaceId = params->ucSurfaceStateId;
+        cmd->DW1.SurfacePitchMinus1 = params->psSurface->dwPitch - 1;
 
         if (params->ucSurfaceStateId == CODECHAL_HCP_SRC_SURFACE_ID)
         {
@@ -125,10 +127,10 @@ protected:
             uvPlaneAlignment = params->dwUVPlaneAlignment ? params->dwUVPlaneAlignment : m_reconUVPlaneAlignment;
         }
 
-        cmd.DW2.YOffsetForUCbInPixel =
+        cmd->DW2.YOffsetForUCbInPixel =
             MOS_ALIGN_CEIL(params->psSurface->UPlaneOffset.iYOffset, uvPlaneAlignment);
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -144,7 +146,8 @@ protected:
         MHW_MI_CHK_NULL(params);
 
         MHW_RESOURCE_PARAMS resourceParams;
-        typename THcpCmds::HCP_IND_OBJ_BASE_ADDR_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THcpCmds::HCP_IND_OBJ_BASE_ADDR_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
         resourceParams.dwLsbNum = MHW_VDBOX_HCP_UPPER_BOUND_STATE_SHIFT;
@@ -155,12 +158,12 @@ protected:
         {
             MHW_MI_CHK_NULL(params->presDataBuffer);
 
-            cmd.DW3.MemoryObjectControlState =
+            cmd->DW3.MemoryObjectControlState =
                 m_cacheabilitySettings[MOS_CODEC_RESOURCE_USAGE_MFX_INDIRECT_BITSTREAM_OBJECT_DECODE].Value;
 
             resourceParams.presResource = params->presDataBuffer;
             resourceParams.dwOffset = params->dwDataOffset;
-            resourceParams.pdwCmd = cmd.DW1_2.Value;
+            resourceParams.pdwCmd = cmd->DW1_2.Value;
             resourceParams.dwLocationInCmd = 1;
             resourceParams.dwSize = params->dwDataSize;
             resourceParams.bIsWritable = false;
@@ -174,7 +177,7 @@ protected:
                 &resourceParams));
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -291,57 +294,58 @@ protected:
         MHW_MI_CHK_NULL(params);
         MHW_MI_CHK_NULL(params->pHevcPicParams);
 
-        typename THcpCmds::HCP_PIC_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THcpCmds::HCP_PIC_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         auto hevcPicParams = params->pHevcPicParams;
 
-        cmd.DW1.Framewidthinmincbminus1 = hevcPicParams->PicWidthInMinCbsY - 1;
-        cmd.DW1.Frameheightinmincbminus1 = hevcPicParams->PicHeightInMinCbsY - 1;
+        cmd->DW1.Framewidthinmincbminus1 = hevcPicParams->PicWidthInMinCbsY - 1;
+        cmd->DW1.Frameheightinmincbminus1 = hevcPicParams->PicHeightInMinCbsY - 1;
 
-        cmd.DW2.Mincusize = (hevcPicParams->log2_min_luma_coding_block_size_minus3) & 0x3;
-        cmd.DW2.CtbsizeLcusize = (hevcPicParams->log2_diff_max_min_luma_coding_block_size
+        cmd->DW2.Mincusize = (hevcPicParams->log2_min_luma_coding_block_size_minus3) & 0x3;
+        cmd->DW2.CtbsizeLcusize = (hevcPicParams->log2_diff_max_min_luma_coding_block_size
             + hevcPicParams->log2_min_luma_coding_block_size_minus3) & 0x3;
-        cmd.DW2.Maxtusize = (hevcPicParams->log2_diff_max_min_transform_block_size
+        cmd->DW2.Maxtusize = (hevcPicParams->log2_diff_max_min_transform_block_size
             + hevcPicParams->log2_min_transform_block_size_minus2) & 0x3;
-        cmd.DW2.Mintusize = (hevcPicParams->log2_min_transform_block_size_minus2) & 0x3;
-        cmd.DW2.Minpcmsize = (hevcPicParams->log2_min_pcm_luma_coding_block_size_minus3) & 0x3;
-        cmd.DW2.Maxpcmsize = (hevcPicParams->log2_diff_max_min_pcm_luma_coding_block_size
+        cmd->DW2.Mintusize = (hevcPicParams->log2_min_transform_block_size_minus2) & 0x3;
+        cmd->DW2.Minpcmsize = (hevcPicParams->log2_min_pcm_luma_coding_block_size_minus3) & 0x3;
+        cmd->DW2.Maxpcmsize = (hevcPicParams->log2_diff_max_min_pcm_luma_coding_block_size
             + hevcPicParams->log2_min_pcm_luma_coding_block_size_minus3) & 0x3;
 
         // As per HW requirement, CurPicIsI and ColPicIsI should be set to either both correct or both zero
         // Since driver doesn't know Collocated_Ref_Idx for SF, and cannot get accurate CurPicIsI for both LF/SF
         // Have to make ColPicIsI = CurPicIsI = 0 for both LF/SF
-        cmd.DW3.Colpicisi = 0;
-        cmd.DW3.Curpicisi = 0;
-
-        cmd.DW4.SampleAdaptiveOffsetEnabledFlag = hevcPicParams->sample_adaptive_offset_enabled_flag;
-        cmd.DW4.PcmEnabledFlag = hevcPicParams->pcm_enabled_flag;
-        cmd.DW4.CuQpDeltaEnabledFlag = hevcPicParams->cu_qp_delta_enabled_flag;
-        cmd.DW4.DiffCuQpDeltaDepthOrNamedAsMaxDqpDepth = hevcPicParams->diff_cu_qp_delta_depth;
-        cmd.DW4.PcmLoopFilterDisableFlag = hevcPicParams->pcm_loop_filter_disabled_flag;
-        cmd.DW4.ConstrainedIntraPredFlag = hevcPicParams->constrained_intra_pred_flag;
-        cmd.DW4.Log2ParallelMergeLevelMinus2 = hevcPicParams->log2_parallel_merge_level_minus2;
-        cmd.DW4.SignDataHidingFlag = hevcPicParams->sign_data_hiding_enabled_flag;
-        cmd.DW4.LoopFilterAcrossTilesEnabledFlag = hevcPicParams->loop_filter_across_tiles_enabled_flag;
-        cmd.DW4.EntropyCodingSyncEnabledFlag = hevcPicParams->entropy_coding_sync_enabled_flag;
-        cmd.DW4.TilesEnabledFlag = hevcPicParams->tiles_enabled_flag;
-        cmd.DW4.WeightedPredFlag = hevcPicParams->weighted_pred_flag;
-        cmd.DW4.WeightedBipredFlag = hevcPicParams->weighted_bipred_flag;
-        cmd.DW4.Fieldpic = (hevcPicParams->RefFieldPicFlag >> 15) & 0x01;
-        cmd.DW4.Bottomfield = ((hevcPicParams->RefBottomFieldFlag >> 15) & 0x01) ? 0 : 1;
-        cmd.DW4.TransformSkipEnabledFlag = hevcPicParams->transform_skip_enabled_flag;
-        cmd.DW4.AmpEnabledFlag = hevcPicParams->amp_enabled_flag;
-        cmd.DW4.TransquantBypassEnableFlag = hevcPicParams->transquant_bypass_enabled_flag;
-        cmd.DW4.StrongIntraSmoothingEnableFlag = hevcPicParams->strong_intra_smoothing_enabled_flag;
-
-        cmd.DW5.PicCbQpOffset = hevcPicParams->pps_cb_qp_offset & 0x1f;
-        cmd.DW5.PicCrQpOffset = hevcPicParams->pps_cr_qp_offset & 0x1f;
-        cmd.DW5.MaxTransformHierarchyDepthIntraOrNamedAsTuMaxDepthIntra = hevcPicParams->max_transform_hierarchy_depth_intra & 0x7;
-        cmd.DW5.MaxTransformHierarchyDepthInterOrNamedAsTuMaxDepthInter = hevcPicParams->max_transform_hierarchy_depth_inter & 0x7;
-        cmd.DW5.PcmSampleBitDepthChromaMinus1 = hevcPicParams->pcm_sample_bit_depth_chroma_minus1;
-        cmd.DW5.PcmSampleBitDepthLumaMinus1 = hevcPicParams->pcm_sample_bit_depth_luma_minus1;
-
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        cmd->DW3.Colpicisi = 0;
+        cmd->DW3.Curpicisi = 0;
+
+        cmd->DW4.SampleAdaptiveOffsetEnabledFlag = hevcPicParams->sample_adaptive_offset_enabled_flag;
+        cmd->DW4.PcmEnabledFlag = hevcPicParams->pcm_enabled_flag;
+        cmd->DW4.CuQpDeltaEnabledFlag = hevcPicParams->cu_qp_delta_enabled_flag;
+        cmd->DW4.DiffCuQpDeltaDepthOrNamedAsMaxDqpDepth = hevcPicParams->diff_cu_qp_delta_depth;
+        cmd->DW4.PcmLoopFilterDisableFlag = hevcPicParams->pcm_loop_filter_disabled_flag;
+        cmd->DW4.ConstrainedIntraPredFlag = hevcPicParams->constrained_intra_pred_flag;
+        cmd->DW4.Log2ParallelMergeLevelMinus2 = hevcPicParams->log2_parallel_merge_level_minus2;
+        cmd->DW4.SignDataHidingFlag = hevcPicParams->sign_data_hiding_enabled_flag;
+        cmd->DW4.LoopFilterAcrossTilesEnabledFlag = hevcPicParams->loop_filter_across_tiles_enabled_flag;
+        cmd->DW4.EntropyCodingSyncEnabledFlag = hevcPicParams->entropy_coding_sync_enabled_flag;
+        cmd->DW4.TilesEnabledFlag = hevcPicParams->tiles_enabled_flag;
+        cmd->DW4.WeightedPredFlag = hevcPicParams->weighted_pred_flag;
+        cmd->DW4.WeightedBipredFlag = hevcPicParams->weighted_bipred_flag;
+        cmd->DW4.Fieldpic = (hevcPicParams->RefFieldPicFlag >> 15) & 0x01;
+        cmd->DW4.Bottomfield = ((hevcPicParams->RefBottomFieldFlag >> 15) & 0x01) ? 0 : 1;
+        cmd->DW4.TransformSkipEnabledFlag = hevcPicParams->transform_skip_enabled_flag;
+        cmd->DW4.AmpEnabledFlag = hevcPicParams->amp_enabled_flag;
+        cmd->DW4.TransquantBypassEnableFlag = hevcPicParams->transquant_bypass_enabled_flag;
+        cmd->DW4.StrongIntraSmoothingEnableFlag = hevcPicParams->strong_intra_smoothing_enabled_flag;
+
+        cmd->DW5.PicCbQpOffset = hevcPicParams->pps_cb_qp_offset & 0x1f;
+        cmd->DW5.PicCrQpOffset = hevcPicParams->pps_cr_qp_offset & 0x1f;
+        cmd->DW5.MaxTransformHierarchyDepthIntraOrNamedAsTuMaxDepthIntra = hevcPicParams->max_transform_hierarchy_depth_intra & 0x7;
+        cmd->DW5.MaxTransformHierarchyDepthInterOrNamedAsTuMaxDepthInter = hevcPicParams->max_transform_hierarchy_depth_inter & 0x7;
+        cmd->DW5.PcmSampleBitDepthChromaMinus1 = hevcPicParams->pcm_sample_bit_depth_chroma_minus1;
+        cmd->DW5.PcmSampleBitDepthLumaMinus1 = hevcPicParams->pcm_sample_bit_depth_luma_minus1;
+
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -354,12 +358,13 @@ protected:
 
         MHW_FUNCTION_ENTER;
 
-        typename THcpCmds::HCP_BSD_OBJECT_CMD   cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THcpCmds::HCP_BSD_OBJECT_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
-        cmd.DW1.IndirectBsdDataLength = params->dwBsdDataLength;
-        cmd.DW2.IndirectDataStartAddress = params->dwBsdDataStartOffset;
+        cmd->DW1.IndirectBsdDataLength = params->dwBsdDataLength;
+        cmd->DW2.IndirectDataStartAddress = params->dwBsdDataStartOffset;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -372,7 +377,8 @@ protected:
 
         MHW_FUNCTION_ENTER;
 
-        typename THcpCmds::HCP_TILE_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THcpCmds::HCP_TILE_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
        
         MHW_MI_CHK_NULL(params);
         MHW_MI_CHK_NULL(params->pTileColWidth);
@@ -385,33 +391,33 @@ protected:
         MHW_ASSERT(hevcPicParams->num_tile_rows_minus1 < HEVC_NUM_MAX_TILE_ROW);
         MHW_ASSERT(hevcPicParams->num_tile_columns_minus1 < HEVC_NUM_MAX_TILE_COLUMN);
 
-        cmd.DW1.Numtilecolumnsminus1 = hevcPicParams->num_tile_columns_minus1;
-        cmd.DW1.Numtilerowsminus1 = hevcPicParams->num_tile_rows_minus1;
+        cmd->DW1.Numtilecolumnsminus1 = hevcPicParams->num_tile_columns_minus1;
+        cmd->DW1.Numtilerowsminus1 = hevcPicParams->num_tile_rows_minus1;
 
         for (uint8_t i = 0; i < 5; i++)
         {
-            cmd.ColumnPositionInCtb[i].DW0.Ctbcolposll = colCumulativeValue;
+            cmd->ColumnPositionInCtb[i].DW0.Ctbcolposll = colCumulativeValue;
             if ((4 * i) == hevcPicParams->num_tile_columns_minus1)
             {
                 break;
             }
 
             colCumulativeValue += params->pTileColWidth[4 * i];
-            cmd.ColumnPositionInCtb[i].DW0.Ctbcolposlh = colCumulativeValue;
+            cmd->ColumnPositionInCtb[i].DW0.Ctbcolposlh = colCumulativeValue;
             if ((4 * i + 1) == hevcPicParams->num_tile_columns_minus1)
             {
                 break;
             }
 
             colCumulativeValue += params->pTileColWidth[4 * i + 1];
-            cmd.ColumnPositionInCtb[i].DW0.Ctbcolposhl = colCumulativeValue;
+            cmd->ColumnPositionInCtb[i].DW0.Ctbcolposhl = colCumulativeValue;
             if ((4 * i + 2) == hevcPicParams->num_tile_columns_minus1)
             {
                 break;
             }
 
             colCumulativeValue += params->pTileColWidth[4 * i + 2];
-            cmd.ColumnPositionInCtb[i].DW0.Ctbcolposhh = colCumulativeValue;
+            cmd->ColumnPositionInCtb[i].DW0.Ctbcolposhh = colCumulativeValue;
             if ((4 * i + 3) == hevcPicParams->num_tile_columns_minus1)
             {
                 break;
@@ -422,28 +428,28 @@ protected:
 
         for (uint8_t i = 0; i < 5; i++)
         {
-            cmd.RowPositionInCtb[i].DW0.Ctbrowposll = rowCumulativeValue;
+            cmd->RowPositionInCtb[i].DW0.Ctbrowposll = rowCumulativeValue;
             if ((4 * i) == hevcPicParams->num_tile_rows_minus1)
             {
                 break;
             }
 
             rowCumulativeValue += params->pTileRowHeight[4 * i];
-            cmd.RowPositionInCtb[i].DW0.Ctbrowposlh = rowCumulativeValue;
+            cmd->RowPositionInCtb[i].DW0.Ctbrowposlh = rowCumulativeValue;
             if ((4 * i + 1) == hevcPicParams->num_tile_rows_minus1)
             {
                 break;
             }
 
             rowCumulativeValue += params->pTileRowHeight[4 * i + 1];
-            cmd.RowPositionInCtb[i].DW0.Ctbrowposhl = rowCumulativeValue;
+            cmd->RowPositionInCtb[i].DW0.Ctbrowposhl = rowCumulativeValue;
             if ((4 * i + 2) == hevcPicParams->num_tile_rows_minus1)
             {
                 break;
             }
 
             rowCumulativeValue += params->pTileRowHeight[4 * i + 2];
-            cmd.RowPositionInCtb[i].DW0.Ctbrowposhh = rowCumulativeValue;
+            cmd->RowPositionInCtb[i].DW0.Ctbrowposhh = rowCumulativeValue;
             if ((4 * i + 3) == hevcPicParams->num_tile_rows_minus1)
             {
                 break;
@@ -454,17 +460,17 @@ protected:
 
         if (hevcPicParams->num_tile_rows_minus1 == 20)
         {
-            cmd.DW12.CtbRowPositionOfTileRow20 = rowCumulativeValue;
+            cmd->DW12.CtbRowPositionOfTileRow20 = rowCumulativeValue;
         }
 
         if (hevcPicParams->num_tile_rows_minus1 == 21)
         {
-            cmd.DW12.CtbRowPositionOfTileRow20 = rowCumulativeValue;
+            cmd->DW12.CtbRowPositionOfTileRow20 = rowCumulativeValue;
             rowCumulativeValue += params->pTileRowHeight[20];
-            cmd.DW12.CtbRowPositionOfTileRow21 = rowCumulativeValue;
+            cmd->DW12.CtbRowPositionOfTileRow21 = rowCumulativeValue;
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -482,10 +488,11 @@ protected:
 
         MHW_ASSERT(params->CurrPic.FrameIdx != 0x7F);
 
-        typename THcpCmds::HCP_REF_IDX_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename THcpCmds::HCP_REF_IDX_STATE_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
-        cmd.DW1.Refpiclistnum = params->ucList;
-        cmd.DW1.NumRefIdxLRefpiclistnumActiveMinus1 = params->ucNumRefForList - 1;
+        cmd->DW1.Refpiclistnum = params->ucList;
+        cmd->DW1.NumRefIdxLRefpiclistnumActiveMinus1 = params->ucNumRefForList - 1;
 
         for (uint8_t i = 0; i < params->ucNumRefForList; i++)
         {
@@ -494,26 +501,26 @@ protected:
             {
                 MHW_ASSERT(*(params->pRefIdxMapping + refFrameIDx) >= 0);
 
-                cmd.HcpRefValue[i].DW0.ListEntryLxReferencePictureFrameIdRefaddr07 = *(params->pRefIdxMapping + refFrameIDx);
+                cmd->HcpRefValue[i].DW0.ListEntryLxReferencePictureFrameIdRefaddr07 = *(params->pRefIdxMapping + refFrameIDx);
                 int32_t pocDiff = params->poc_curr_pic - params->poc_list[refFrameIDx];
-                cmd.HcpRefValue[i].DW0.ReferencePictureTbValue = CodecHal_Clip3(-128, 127, pocDiff);
-                cmd.HcpRefValue[i].DW0.Longtermreference = CodecHal_PictureIsLongTermRef(params->ppHevcRefList[params->CurrPic.FrameIdx]->RefList[refFrameIDx]);
-                cmd.HcpRefValue[i].DW0.FieldPicFlag = (params->RefFieldPicFlag >> refFrameIDx) & 0x01;
-                cmd.HcpRefValue[i].DW0.BottomFieldFlag = ((params->RefBottomFieldFlag >> refFrameIDx) & 0x01) ? 0 : 1;
+                cmd->HcpRefValue[i].DW0.ReferencePictureTbValue = CodecHal_Clip3(-128, 127, pocDiff);
+                cmd->HcpRefValue[i].DW0.Longtermreference = CodecHal_PictureIsLongTermRef(params->ppHevcRefList[params->CurrPic.FrameIdx]->RefList[refFrameIDx]);
+                cmd->HcpRefValue[i].DW0.FieldPicFlag = (params->RefFieldPicFlag >> refFrameIDx) & 0x01;
+                cmd->HcpRefValue[i].DW0.BottomFieldFlag = ((params->RefBottomFieldFlag >> refFrameIDx) & 0x01) ? 0 : 1;
             }
             else
             {
-                cmd.HcpRefValue[i].DW0.ListEntryLxReferencePictureFrameIdRefaddr07 = 0;
-                cmd.HcpRefValue[i].DW0.ReferencePictureTbValue = 0;
-                cmd.HcpRefValue[i].DW0.Longtermreference = false;
-                cmd.HcpRefValue[i].DW0.FieldPicFlag = 0;
-                cmd.HcpRefValue[i].DW0.BottomFieldFlag = 0;
+                cmd->HcpRefValue[i].DW0.ListEntryLxReferencePictureFrameIdRefaddr07 = 0;
+                cmd->HcpRefValue[i].DW0.ReferencePictureTbValue = 0;
+                cmd->HcpRefValue[i].DW0.Longtermreference = false;
+                cmd->HcpRefValue[i].DW0.FieldPicFlag = 0;
+                cmd->HcpRefValue[i].DW0.BottomFieldFlag = 0;
             }
         }
 
         for (uint8_t i = (uint8_t)params->ucNumRefForList; i < 16; i++)
         {
-            cmd.HcpRefValue[i].DW0.Value = 0x00;
+            cmd->HcpRefValue[i].DW0.Value = 0x00;
         }
 
         if (cmdBuffer == nullptr && batchBuffer == nullptr)
@@ -521,7 +528,7 @@ protected:
             MHW_ASSERTMESSAGE("There was no valid buffer to add the HW command to.");
         }
 
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -537,35 +544,36 @@ protected:
 
         MHW_MI_CHK_NULL(params);
 
-        typename THcpCmds::HCP_WEIGHTOFFSET_STATE_CMD       cmd;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename THcpCmds::HCP_WEIGHTOFFSET_STATE_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
         uint8_t i = 0;
 
-        cmd.DW1.Refpiclistnum = i = params->ucList;
+        cmd->DW1.Refpiclistnum = i = params->ucList;
 
         // Luma
         for (uint8_t refIdx = 0; refIdx < CODEC_MAX_NUM_REF_FRAME_HEVC; refIdx++)
         {
-            cmd.HevcLumaWeightOffsetWrite[refIdx].DW0.DeltaLumaWeightLxI = params->LumaWeights[i][refIdx];
-            cmd.HevcLumaWeightOffsetWrite[refIdx].DW0.LumaOffsetLxI = params->LumaOffsets[i][refIdx];
+            cmd->HevcLumaWeightOffsetWrite[refIdx].DW0.DeltaLumaWeightLxI = params->LumaWeights[i][refIdx];
+            cmd->HevcLumaWeightOffsetWrite[refIdx].DW0.LumaOffsetLxI = params->LumaOffsets[i][refIdx];
         }
 
         // Chroma
         for (uint8_t refIdx = 0; refIdx < CODEC_MAX_NUM_REF_FRAME_HEVC; refIdx++)
         {
-            cmd.HevcChromaWeightOffsetWrite[refIdx].DW0.DeltaChromaWeightLxI0 = params->ChromaWeights[i][refIdx][0];
-            cmd.HevcChromaWeightOffsetWrite[refIdx].DW0.ChromaoffsetlxI0 = params->ChromaOffsets[i][refIdx][0];
-            cmd.HevcChromaWeightOffsetWrite[refIdx].DW0.DeltaChromaWeightLxI1 = params->ChromaWeights[i][refIdx][1];
-            cmd.HevcChromaWeightOffsetWrite[refIdx].DW0.ChromaoffsetlxI1 = params->ChromaOffsets[i][refIdx][1];
+            cmd->HevcChromaWeightOffsetWrite[refIdx].DW0.DeltaChromaWeightLxI0 = params->ChromaWeights[i][refIdx][0];
+            cmd->HevcChromaWeightOffsetWrite[refIdx].DW0.ChromaoffsetlxI0 = params->ChromaOffsets[i][refIdx][0];
+            cmd->HevcChromaWeightOffsetWrite[refIdx].DW0.DeltaChromaWeightLxI1 = params->ChromaWeights[i][refIdx][1];
+            cmd->HevcChromaWeightOffsetWrite[refIdx].DW0.ChromaoffsetlxI1 = params->ChromaOffsets[i][refIdx][1];
         }
 
-        //cmd.DW2[15] and cmd.DW18[15] not be used
+        //cmd->DW2[15] and cmd->DW18[15] not be used
 
         if (cmdBuffer == nullptr && batchBuffer == nullptr)
         {
             MHW_ASSERTMESSAGE("There was no valid buffer to add the HW command to.");
         }
 
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -580,7 +588,8 @@ protected:
 
         MHW_MI_CHK_NULL(hevcSliceState);
 
-        typename THcpCmds::HCP_SLICE_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THcpCmds::HCP_SLICE_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         auto hevcSliceParams = hevcSliceState->pHevcSliceParams;
         auto hevcPicParams = hevcSliceState->pHevcPicParams;
@@ -595,45 +604,45 @@ protected:
         // If first slice doesn't starts from (0,0), that means this is error bitstream.
         if (hevcSliceState->dwSliceIndex == 0)
         {
-            cmd.DW1.SlicestartctbxOrSliceStartLcuXEncoder = 0;
-            cmd.DW1.SlicestartctbyOrSliceStartLcuYEncoder = 0;
+            cmd->DW1.SlicestartctbxOrSliceStartLcuXEncoder = 0;
+            cmd->DW1.SlicestartctbyOrSliceStartLcuYEncoder = 0;
         }
         else
         {
-            cmd.DW1.SlicestartctbxOrSliceStartLcuXEncoder = hevcSliceParams->slice_segment_address % widthInCtb;
-            cmd.DW1.SlicestartctbyOrSliceStartLcuYEncoder = hevcSliceParams->slice_segment_address / widthInCtb;
+            cmd->DW1.SlicestartctbxOrSliceStartLcuXEncoder = hevcSliceParams->slice_segment_address % widthInCtb;
+            cmd->DW1.SlicestartctbyOrSliceStartLcuYEncoder = hevcSliceParams->slice_segment_address / widthInCtb;
         }
 
         if (hevcSliceState->bLastSlice)
         {
-            cmd.DW2.NextslicestartctbxOrNextSliceStartLcuXEncoder = 0;
-            cmd.DW2.NextslicestartctbyOrNextSliceStartLcuYEncoder = 0;
+            cmd->DW2.NextslicestartctbxOrNextSliceStartLcuXEncoder = 0;
+            cmd->DW2.NextslicestartctbyOrNextSliceStartLcuYEncoder = 0;
         }
         else
         {
-            cmd.DW2.NextslicestartctbxOrNextSliceStartLcuXEncoder = (hevcSliceParams + 1)->slice_segment_address % widthInCtb;
-            cmd.DW2.NextslicestartctbyOrNextSliceStartLcuYEncoder = (hevcSliceParams + 1)->slice_segment_address / widthInCtb;
+            cmd->DW2.NextslicestartctbxOrNextSliceStartLcuXEncoder = (hevcSliceParams + 1)->slice_segment_address % widthInCtb;
+            cmd->DW2.NextslicestartctbyOrNextSliceStartLcuYEncoder = (hevcSliceParams + 1)->slice_segment_address / widthInCtb;
         }
 
-        cmd.DW3.SliceType = hevcSliceParams->LongSliceFlags.fields.slice_type;
-        cmd.DW3.Lastsliceofpic = hevcSliceState->bLastSlice;
-        cmd.DW3.DependentSliceFlag = hevcSliceParams->LongSliceFlags.fields.dependent_slice_segment_flag;
-        cmd.DW3.SliceTemporalMvpEnableFlag = hevcSliceParams->LongSliceFlags.fields.slice_temporal_mvp_enabled_flag;
-        cmd.DW3.SliceCbQpOffset = hevcSliceParams->slice_cb_qp_offset;
-        cmd.DW3.SliceCrQpOffset = hevcSliceParams->slice_cr_qp_offset;
+        cmd->DW3.SliceType = hevcSliceParams->LongSliceFlags.fields.slice_type;
+        cmd->DW3.Lastsliceofpic = hevcSliceState->bLastSlice;
+        cmd->DW3.DependentSliceFlag = hevcSliceParams->LongSliceFlags.fields.dependent_slice_segment_flag;
+        cmd->DW3.SliceTemporalMvpEnableFlag = hevcSliceParams->LongSliceFlags.fields.slice_temporal_mvp_enabled_flag;
+        cmd->DW3.SliceCbQpOffset = hevcSliceParams->slice_cb_qp_offset;
+        cmd->DW3.SliceCrQpOffset = hevcSliceParams->slice_cr_qp_offset;
 
-        cmd.DW4.SliceHeaderDisableDeblockingFilterFlag = hevcSliceParams->LongSliceFlags.fields.slice_deblocking_filter_disabled_flag;
-        cmd.DW4.SliceTcOffsetDiv2OrFinalTcOffsetDiv2Encoder = hevcSliceParams->slice_tc_offset_div2;
-        cmd.DW4.SliceBetaOffsetDiv2OrFinalBetaOffsetDiv2Encoder = hevcSliceParams->slice_beta_offset_div2;
-        cmd.DW4.SliceLoopFilterAcrossSlicesEnabledFlag = hevcSliceParams->LongSliceFlags.fields.slice_loop_filter_across_slices_enabled_flag;
-        cmd.DW4.SliceSaoChromaFlag = hevcSliceParams->LongSliceFlags.fields.slice_sao_chroma_flag;
-        cmd.DW4.SliceSaoLumaFlag = hevcSliceParams->LongSliceFlags.fields.slice_sao_luma_flag;
-        cmd.DW4.MvdL1ZeroFlag = hevcSliceParams->LongSliceFlags.fields.mvd_l1_zero_flag;
+        cmd->DW4.SliceHeaderDisableDeblockingFilterFlag = hevcSliceParams->LongSliceFlags.fields.slice_deblocking_filter_disabled_flag;
+        cmd->DW4.SliceTcOffsetDiv2OrFinalTcOffsetDiv2Encoder = hevcSliceParams->slice_tc_offset_div2;
+        cmd->DW4.SliceBetaOffsetDiv2OrFinalBetaOffsetDiv2Encoder = hevcSliceParams->slice_beta_offset_div2;
+        cmd->DW4.SliceLoopFilterAcrossSlicesEnabledFlag = hevcSliceParams->LongSliceFlags.fields.slice_loop_filter_across_slices_enabled_flag;
+        cmd->DW4.SliceSaoChromaFlag = hevcSliceParams->LongSliceFlags.fields.slice_sao_chroma_flag;
+        cmd->DW4.SliceSaoLumaFlag = hevcSliceParams->LongSliceFlags.fields.slice_sao_luma_flag;
+        cmd->DW4.MvdL1ZeroFlag = hevcSliceParams->LongSliceFlags.fields.mvd_l1_zero_flag;
 
         uint32_t  numNegativePic = 0;
         uint32_t  numPositivePic = 0;
 
-        if (hevcSliceParams->LongSliceFlags.fields.slice_type != cmd.SLICE_TYPE_I_SLICE)
+        if (hevcSliceParams->LongSliceFlags.fields.slice_type != cmd->SLICE_TYPE_I_SLICE)
         {
             for (uint8_t i = 0; i < hevcSliceParams->num_ref_idx_l0_active_minus1 + 1; i++)
             {
@@ -650,7 +659,7 @@ protected:
             numNegativePic = 0;
         }
 
-        if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd.SLICE_TYPE_B_SLICE)
+        if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd->SLICE_TYPE_B_SLICE)
         {
             for (uint8_t i = 0; i < hevcSliceParams->num_ref_idx_l1_active_minus1 + 1; i++)
             {
@@ -670,18 +679,18 @@ protected:
         if ((numNegativePic == (hevcSliceParams->num_ref_idx_l0_active_minus1 + 1)) &&
             (numPositivePic == 0))
         {
-            cmd.DW4.Islowdelay = 1;
+            cmd->DW4.Islowdelay = 1;
         }
         else
         {
-            cmd.DW4.Islowdelay = 0;
+            cmd->DW4.Islowdelay = 0;
         }
 
-        cmd.DW4.CollocatedFromL0Flag = hevcSliceParams->LongSliceFlags.fields.collocated_from_l0_flag;
-        cmd.DW4.Chromalog2Weightdenom = hevcSliceParams->luma_log2_weight_denom + hevcSliceParams->delta_chroma_log2_weight_denom;
-        cmd.DW4.LumaLog2WeightDenom = hevcSliceParams->luma_log2_weight_denom;
-        cmd.DW4.CabacInitFlag = hevcSliceParams->LongSliceFlags.fields.cabac_init_flag;
-        cmd.DW4.Maxmergeidx = 5 - hevcSliceParams->five_minus_max_num_merge_cand - 1;
+        cmd->DW4.CollocatedFromL0Flag = hevcSliceParams->LongSliceFlags.fields.collocated_from_l0_flag;
+        cmd->DW4.Chromalog2Weightdenom = hevcSliceParams->luma_log2_weight_denom + hevcSliceParams->delta_chroma_log2_weight_denom;
+        cmd->DW4.LumaLog2WeightDenom = hevcSliceParams->luma_log2_weight_denom;
+        cmd->DW4.CabacInitFlag = hevcSliceParams->LongSliceFlags.fields.cabac_init_flag;
+        cmd->DW4.Maxmergeidx = 5 - hevcSliceParams->five_minus_max_num_merge_cand - 1;
 
         uint8_t collocatedRefIndex, collocatedFrameIdx, collocatedFromL0Flag;
 
@@ -691,28 +700,28 @@ protected:
             collocatedRefIndex = hevcSliceParams->collocated_ref_idx;
             collocatedFrameIdx = 0;
             collocatedFromL0Flag = hevcSliceParams->LongSliceFlags.fields.collocated_from_l0_flag;
-            if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd.SLICE_TYPE_P_SLICE)
+            if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd->SLICE_TYPE_P_SLICE)
             {
                 collocatedFrameIdx = hevcSliceParams->RefPicList[0][collocatedRefIndex].FrameIdx;
             }
-            else if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd.SLICE_TYPE_B_SLICE)
+            else if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd->SLICE_TYPE_B_SLICE)
             {
                 collocatedFrameIdx = hevcSliceParams->RefPicList[!collocatedFromL0Flag][collocatedRefIndex].FrameIdx;
             }
 
-            if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd.SLICE_TYPE_I_SLICE)
+            if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd->SLICE_TYPE_I_SLICE)
             {
-                cmd.DW4.Collocatedrefidx = 0;
+                cmd->DW4.Collocatedrefidx = 0;
             }
             else
             {
                 MHW_ASSERT(*(hevcSliceState->pRefIdxMapping + collocatedFrameIdx) >= 0);
-                cmd.DW4.Collocatedrefidx = *(hevcSliceState->pRefIdxMapping + collocatedFrameIdx);
+                cmd->DW4.Collocatedrefidx = *(hevcSliceState->pRefIdxMapping + collocatedFrameIdx);
             }
         }
         else
         {
-            cmd.DW4.Collocatedrefidx = 0;
+            cmd->DW4.Collocatedrefidx = 0;
         }
 
         static uint8_t  ucFirstInterSliceCollocatedFrameIdx;
@@ -729,25 +738,25 @@ protected:
         }
 
         if ((!bFinishFirstInterSlice) &&
-            (hevcSliceParams->LongSliceFlags.fields.slice_type != cmd.SLICE_TYPE_I_SLICE) &&
+            (hevcSliceParams->LongSliceFlags.fields.slice_type != cmd->SLICE_TYPE_I_SLICE) &&
             (hevcSliceParams->LongSliceFlags.fields.slice_temporal_mvp_enabled_flag == 1))
         {
-            ucFirstInterSliceCollocatedFrameIdx = cmd.DW4.Collocatedrefidx;
-            ucFirstInterSliceCollocatedFromL0Flag = cmd.DW4.CollocatedFromL0Flag;
+            ucFirstInterSliceCollocatedFrameIdx = cmd->DW4.Collocatedrefidx;
+            ucFirstInterSliceCollocatedFromL0Flag = cmd->DW4.CollocatedFromL0Flag;
             bFinishFirstInterSlice = true;
         }
 
         if (bFinishFirstInterSlice &&
-            ((hevcSliceParams->LongSliceFlags.fields.slice_type == cmd.SLICE_TYPE_I_SLICE) ||
+            ((hevcSliceParams->LongSliceFlags.fields.slice_type == cmd->SLICE_TYPE_I_SLICE) ||
                 (hevcSliceParams->LongSliceFlags.fields.slice_temporal_mvp_enabled_flag == 0)))
         {
-            cmd.DW4.Collocatedrefidx = ucFirstInterSliceCollocatedFrameIdx;
-            cmd.DW4.CollocatedFromL0Flag = ucFirstInterSliceCollocatedFromL0Flag;
+            cmd->DW4.Collocatedrefidx = ucFirstInterSliceCollocatedFrameIdx;
+            cmd->DW4.CollocatedFromL0Flag = ucFirstInterSliceCollocatedFromL0Flag;
         }
 
-        cmd.DW5.Sliceheaderlength = hevcSliceParams->ByteOffsetToSliceData;
+        cmd->DW5.Sliceheaderlength = hevcSliceParams->ByteOffsetToSliceData;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -762,7 +771,8 @@ protected:
 
         MHW_MI_CHK_NULL(hevcSliceState);
 
-        typename THcpCmds::HCP_SLICE_STATE_CMD      cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THcpCmds::HCP_SLICE_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         auto hevcSliceParams = hevcSliceState->pHevcSliceParams;
         auto hevcPicParams = hevcSliceState->pHevcPicParams;
@@ -777,46 +787,46 @@ protected:
         // If first slice doesn't starts from (0,0), that means this is error bitstream.
         if (hevcSliceState->dwSliceIndex == 0)
         {
-            cmd.DW1.SlicestartctbxOrSliceStartLcuXEncoder = 0;
-            cmd.DW1.SlicestartctbyOrSliceStartLcuYEncoder = 0;
+            cmd->DW1.SlicestartctbxOrSliceStartLcuXEncoder = 0;
+            cmd->DW1.SlicestartctbyOrSliceStartLcuYEncoder = 0;
         }
         else
         {
-            cmd.DW1.SlicestartctbxOrSliceStartLcuXEncoder = hevcSliceParams->slice_segment_address % widthInCtb;
-            cmd.DW1.SlicestartctbyOrSliceStartLcuYEncoder = hevcSliceParams->slice_segment_address / widthInCtb;
+            cmd->DW1.SlicestartctbxOrSliceStartLcuXEncoder = hevcSliceParams->slice_segment_address % widthInCtb;
+            cmd->DW1.SlicestartctbyOrSliceStartLcuYEncoder = hevcSliceParams->slice_segment_address / widthInCtb;
         }
 
         if (hevcSliceState->bLastSlice)
         {
-            cmd.DW2.NextslicestartctbxOrNextSliceStartLcuXEncoder = 0;
-            cmd.DW2.NextslicestartctbyOrNextSliceStartLcuYEncoder = 0;
+            cmd->DW2.NextslicestartctbxOrNextSliceStartLcuXEncoder = 0;
+            cmd->DW2.NextslicestartctbyOrNextSliceStartLcuYEncoder = 0;
         }
         else
         {
-            cmd.DW2.NextslicestartctbxOrNextSliceStartLcuXEncoder = (hevcSliceParams + 1)->slice_segment_address % widthInCtb;
-            cmd.DW2.NextslicestartctbyOrNextSliceStartLcuYEncoder = (hevcSliceParams + 1)->slice_segment_address / widthInCtb;
+            cmd->DW2.NextslicestartctbxOrNextSliceStartLcuXEncoder = (hevcSliceParams + 1)->slice_segment_address % widthInCtb;
+            cmd->DW2.NextslicestartctbyOrNextSliceStartLcuYEncoder = (hevcSliceParams + 1)->slice_segment_address / widthInCtb;
         }
 
-        cmd.DW3.SliceType = hevcSliceParams->LongSliceFlags.fields.slice_type;
-        cmd.DW3.Lastsliceofpic = hevcSliceState->bLastSlice;
-        cmd.DW3.DependentSliceFlag = hevcSliceParams->LongSliceFlags.fields.dependent_slice_segment_flag;
-        cmd.DW3.SliceTemporalMvpEnableFlag = hevcSliceParams->LongSliceFlags.fields.slice_temporal_mvp_enabled_flag;
-        cmd.DW3.Sliceqp = hevcSliceParams->slice_qp_delta + hevcPicParams->init_qp_minus26 + 26;
-        cmd.DW3.SliceCbQpOffset = hevcSliceParams->slice_cb_qp_offset;
-        cmd.DW3.SliceCrQpOffset = hevcSliceParams->slice_cr_qp_offset;
+        cmd->DW3.SliceType = hevcSliceParams->LongSliceFlags.fields.slice_type;
+        cmd->DW3.Lastsliceofpic = hevcSliceState->bLastSlice;
+        cmd->DW3.DependentSliceFlag = hevcSliceParams->LongSliceFlags.fields.dependent_slice_segment_flag;
+        cmd->DW3.SliceTemporalMvpEnableFlag = hevcSliceParams->LongSliceFlags.fields.slice_temporal_mvp_enabled_flag;
+        cmd->DW3.Sliceqp = hevcSliceParams->slice_qp_delta + hevcPicParams->init_qp_minus26 + 26;
+        cmd->DW3.SliceCbQpOffset = hevcSliceParams->slice_cb_qp_offset;
+        cmd->DW3.SliceCrQpOffset = hevcSliceParams->slice_cr_qp_offset;
 
-        cmd.DW4.SliceHeaderDisableDeblockingFilterFlag = hevcSliceParams->LongSliceFlags.fields.slice_deblocking_filter_disabled_flag;
-        cmd.DW4.SliceTcOffsetDiv2OrFinalTcOffsetDiv2Encoder = hevcSliceParams->slice_tc_offset_div2;
-        cmd.DW4.SliceBetaOffsetDiv2OrFinalBetaOffsetDiv2Encoder = hevcSliceParams->slice_beta_offset_div2;
-        cmd.DW4.SliceLoopFilterAcrossSlicesEnabledFlag = hevcSliceParams->LongSliceFlags.fields.slice_loop_filter_across_slices_enabled_flag;
-        cmd.DW4.SliceSaoChromaFlag = hevcSliceParams->LongSliceFlags.fields.slice_sao_chroma_flag;
-        cmd.DW4.SliceSaoLumaFlag = hevcSliceParams->LongSliceFlags.fields.slice_sao_luma_flag;
-        cmd.DW4.MvdL1ZeroFlag = hevcSliceParams->LongSliceFlags.fields.mvd_l1_zero_flag;
+        cmd->DW4.SliceHeaderDisableDeblockingFilterFlag = hevcSliceParams->LongSliceFlags.fields.slice_deblocking_filter_disabled_flag;
+        cmd->DW4.SliceTcOffsetDiv2OrFinalTcOffsetDiv2Encoder = hevcSliceParams->slice_tc_offset_div2;
+        cmd->DW4.SliceBetaOffsetDiv2OrFinalBetaOffsetDiv2Encoder = hevcSliceParams->slice_beta_offset_div2;
+        cmd->DW4.SliceLoopFilterAcrossSlicesEnabledFlag = hevcSliceParams->LongSliceFlags.fields.slice_loop_filter_across_slices_enabled_flag;
+        cmd->DW4.SliceSaoChromaFlag = hevcSliceParams->LongSliceFlags.fields.slice_sao_chroma_flag;
+        cmd->DW4.SliceSaoLumaFlag = hevcSliceParams->LongSliceFlags.fields.slice_sao_luma_flag;
+        cmd->DW4.MvdL1ZeroFlag = hevcSliceParams->LongSliceFlags.fields.mvd_l1_zero_flag;
 
         uint32_t  numNegativePic = 0;
         uint32_t  numPositivePic = 0;
 
-        if (hevcSliceParams->LongSliceFlags.fields.slice_type != cmd.SLICE_TYPE_I_SLICE)
+        if (hevcSliceParams->LongSliceFlags.fields.slice_type != cmd->SLICE_TYPE_I_SLICE)
         {
             for (uint8_t i = 0; i < hevcSliceParams->num_ref_idx_l0_active_minus1 + 1; i++)
             {
@@ -833,7 +843,7 @@ protected:
             numNegativePic = 0;
         }
 
-        if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd.SLICE_TYPE_B_SLICE)
+        if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd->SLICE_TYPE_B_SLICE)
         {
             for (uint8_t i = 0; i < hevcSliceParams->num_ref_idx_l1_active_minus1 + 1; i++)
             {
@@ -853,18 +863,18 @@ protected:
         if ((numNegativePic == (hevcSliceParams->num_ref_idx_l0_active_minus1 + 1)) &&
             (numPositivePic == 0))
         {
-            cmd.DW4.Islowdelay = 1;
+            cmd->DW4.Islowdelay = 1;
         }
         else
         {
-            cmd.DW4.Islowdelay = 0;
+            cmd->DW4.Islowdelay = 0;
         }
 
-        cmd.DW4.CollocatedFromL0Flag = hevcSliceParams->LongSliceFlags.fields.collocated_from_l0_flag;
-        cmd.DW4.Chromalog2Weightdenom = hevcSliceParams->luma_log2_weight_denom + hevcSliceParams->delta_chroma_log2_weight_denom;
-        cmd.DW4.LumaLog2WeightDenom = hevcSliceParams->luma_log2_weight_denom;
-        cmd.DW4.CabacInitFlag = hevcSliceParams->LongSliceFlags.fields.cabac_init_flag;
-        cmd.DW4.Maxmergeidx = 5 - hevcSliceParams->five_minus_max_num_merge_cand - 1;
+        cmd->DW4.CollocatedFromL0Flag = hevcSliceParams->LongSliceFlags.fields.collocated_from_l0_flag;
+        cmd->DW4.Chromalog2Weightdenom = hevcSliceParams->luma_log2_weight_denom + hevcSliceParams->delta_chroma_log2_weight_denom;
+        cmd->DW4.LumaLog2WeightDenom = hevcSliceParams->luma_log2_weight_denom;
+        cmd->DW4.CabacInitFlag = hevcSliceParams->LongSliceFlags.fields.cabac_init_flag;
+        cmd->DW4.Maxmergeidx = 5 - hevcSliceParams->five_minus_max_num_merge_cand - 1;
 
         uint8_t   collocatedRefIndex, collocatedFrameIdx, collocatedFromL0Flag;
 
@@ -874,28 +884,28 @@ protected:
             collocatedRefIndex = hevcSliceParams->collocated_ref_idx;
             collocatedFrameIdx = 0;
             collocatedFromL0Flag = hevcSliceParams->LongSliceFlags.fields.collocated_from_l0_flag;
-            if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd.SLICE_TYPE_P_SLICE)
+            if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd->SLICE_TYPE_P_SLICE)
             {
                 collocatedFrameIdx = hevcSliceParams->RefPicList[0][collocatedRefIndex].FrameIdx;
             }
-            else if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd.SLICE_TYPE_B_SLICE)
+            else if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd->SLICE_TYPE_B_SLICE)
             {
                 collocatedFrameIdx = hevcSliceParams->RefPicList[!collocatedFromL0Flag][collocatedRefIndex].FrameIdx;
             }
 
-            if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd.SLICE_TYPE_I_SLICE)
+            if (hevcSliceParams->LongSliceFlags.fields.slice_type == cmd->SLICE_TYPE_I_SLICE)
             {
-                cmd.DW4.Collocatedrefidx = 0;
+                cmd->DW4.Collocatedrefidx = 0;
             }
             else
             {
                 MHW_ASSERT(*(hevcSliceState->pRefIdxMapping + collocatedFrameIdx) >= 0);
-                cmd.DW4.Collocatedrefidx = *(hevcSliceState->pRefIdxMapping + collocatedFrameIdx);
+                cmd->DW4.Collocatedrefidx = *(hevcSliceState->pRefIdxMapping + collocatedFrameIdx);
             }
         }
         else
         {
-            cmd.DW4.Collocatedrefidx = 0;
+            cmd->DW4.Collocatedrefidx = 0;
         }
 
         static uint8_t   ucFirstInterSliceCollocatedFrameIdx;
@@ -912,25 +922,25 @@ protected:
         }
 
         if ((!bFinishFirstInterSlice) &&
-            (hevcSliceParams->LongSliceFlags.fields.slice_type != cmd.SLICE_TYPE_I_SLICE) &&
+            (hevcSliceParams->LongSliceFlags.fields.slice_type != cmd->SLICE_TYPE_I_SLICE) &&
             (hevcSliceParams->LongSliceFlags.fields.slice_temporal_mvp_enabled_flag == 1))
         {
-            ucFirstInterSliceCollocatedFrameIdx = cmd.DW4.Collocatedrefidx;
-            ucFirstInterSliceCollocatedFromL0Flag = cmd.DW4.CollocatedFromL0Flag;
+            ucFirstInterSliceCollocatedFrameIdx = cmd->DW4.Collocatedrefidx;
+            ucFirstInterSliceCollocatedFromL0Flag = cmd->DW4.CollocatedFromL0Flag;
             bFinishFirstInterSlice = true;
         }
 
         if (bFinishFirstInterSlice &&
-            ((hevcSliceParams->LongSliceFlags.fields.slice_type == cmd.SLICE_TYPE_I_SLICE) ||
+            ((hevcSliceParams->LongSliceFlags.fields.slice_type == cmd->SLICE_TYPE_I_SLICE) ||
                 (hevcSliceParams->LongSliceFlags.fields.slice_temporal_mvp_enabled_flag == 0)))
         {
-            cmd.DW4.Collocatedrefidx = ucFirstInterSliceCollocatedFrameIdx;
-            cmd.DW4.CollocatedFromL0Flag = ucFirstInterSliceCollocatedFromL0Flag;
+            cmd->DW4.Collocatedrefidx = ucFirstInterSliceCollocatedFrameIdx;
+            cmd->DW4.CollocatedFromL0Flag = ucFirstInterSliceCollocatedFromL0Flag;
         }
 
-        cmd.DW5.Sliceheaderlength = hevcSliceParams->ByteOffsetToSliceData;
+        cmd->DW5.Sliceheaderlength = hevcSliceParams->ByteOffsetToSliceData;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -260,17 +260,18 @@ protected:
         MHW_MI_CHK_NULL(cmdBuffer);
         MHW_MI_CHK_NULL(params);
 
-        typename THucCmds::HUC_PIPE_MODE_SELECT_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THucCmds::HUC_PIPE_MODE_SELECT_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         if (!params->disableProtectionSetting)
         {
-            m_cpInterface->SetProtectionSettingsForHucPipeModeSelect((uint32_t*)&cmd);
+            m_cpInterface->SetProtectionSettingsForHucPipeModeSelect((uint32_t*)cmd);
         }
 
-        cmd.DW1.IndirectStreamOutEnable = params->bStreamOutEnabled;
-        cmd.DW2.MediaSoftResetCounterPer1000Clocks = params->dwMediaSoftResetCounterValue;
+        cmd->DW1.IndirectStreamOutEnable = params->bStreamOutEnabled;
+        cmd->DW2.MediaSoftResetCounterPer1000Clocks = params->dwMediaSoftResetCounterValue;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -282,11 +283,12 @@ protected:
         MHW_MI_CHK_NULL(cmdBuffer);
         MHW_MI_CHK_NULL(params);
 
-        typename THucCmds::HUC_IMEM_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THucCmds::HUC_IMEM_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
-        cmd.DW4.HucFirmwareDescriptor = params->dwKernelDescriptor;
+        cmd->DW4.HucFirmwareDescriptor = params->dwKernelDescriptor;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -304,13 +306,14 @@ protected:
         resourceParams.dwLsbNum = MHW_VDBOX_HUC_GENERAL_STATE_SHIFT;
         resourceParams.HwCommandType = MOS_HUC_DMEM;
 
-        typename THucCmds::HUC_DMEM_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THucCmds::HUC_DMEM_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         if (params->presHucDataSource)
         {
             resourceParams.presResource = params->presHucDataSource;
             resourceParams.dwOffset = 0;
-            resourceParams.pdwCmd = (cmd.HucDataSourceBaseAddress[0].DW0_1.Value);
+            resourceParams.pdwCmd = (cmd->HucDataSourceBaseAddress[0].DW0_1.Value);
             resourceParams.dwLocationInCmd = 1;
             resourceParams.bIsWritable = FALSE;
 
@@ -320,13 +323,13 @@ protected:
                 &resourceParams));
 
             // set HuC data destination address
-            cmd.DW4.HucDataDestinationBaseAddress = params->dwDmemOffset >> MHW_VDBOX_HUC_GENERAL_STATE_SHIFT;
+            cmd->DW4.HucDataDestinationBaseAddress = params->dwDmemOffset >> MHW_VDBOX_HUC_GENERAL_STATE_SHIFT;
 
             // set data length
-            cmd.DW5.HucDataLength = params->dwDataLength >> MHW_VDBOX_HUC_GENERAL_STATE_SHIFT;
+            cmd->DW5.HucDataLength = params->dwDataLength >> MHW_VDBOX_HUC_GENERAL_STATE_SHIFT;
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -345,18 +348,19 @@ protected:
         resourceParams.dwLsbNum = MHW_VDBOX_HUC_UPPER_BOUND_STATE_SHIFT;
         resourceParams.HwCommandType = MOS_HUC_VIRTUAL_ADDR;
 
-        typename THucCmds::HUC_VIRTUAL_ADDR_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THucCmds::HUC_VIRTUAL_ADDR_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         for (int i = 0; i < 16; i++)
         {
             if (params->regionParams[i].presRegion)
             {
-                cmd.HucVirtualAddressRegion[i].DW2.MemoryObjectControlState = 
+                cmd->HucVirtualAddressRegion[i].DW2.MemoryObjectControlState = 
                     m_cacheabilitySettings[MOS_CODEC_RESOURCE_USAGE_HUC_VIRTUAL_ADDR_REGION_BUFFER_CODEC].Value;
                 resourceParams.presResource = params->regionParams[i].presRegion;
                 resourceParams.dwOffset = params->regionParams[i].dwOffset;
                 resourceParams.bIsWritable = params->regionParams[i].isWritable;
-                resourceParams.pdwCmd = cmd.HucVirtualAddressRegion[i].HucSurfaceBaseAddressVirtualaddrregion015[0].DW0_1.Value;
+                resourceParams.pdwCmd = cmd->HucVirtualAddressRegion[i].HucSurfaceBaseAddressVirtualaddrregion015[0].DW0_1.Value;
                 resourceParams.dwLocationInCmd = 1 + (i * 3);
 
                 MHW_MI_CHK_STATUS(AddResourceToCmd(
@@ -365,7 +369,7 @@ protected:
                     &resourceParams));
             }
         }
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -385,13 +389,14 @@ protected:
         resourceParams.dwUpperBoundLocationOffsetFromCmd = 3;
         resourceParams.HwCommandType = MOS_HUC_IND_OBJ_BASE_ADDR;
 
-        typename THucCmds::HUC_IND_OBJ_BASE_ADDR_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THucCmds::HUC_IND_OBJ_BASE_ADDR_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         if (params->presDataBuffer)
         {
             resourceParams.presResource = params->presDataBuffer;
             resourceParams.dwOffset = params->dwDataOffset;
-            resourceParams.pdwCmd = (cmd.DW1_2.Value);
+            resourceParams.pdwCmd = (cmd->DW1_2.Value);
             resourceParams.dwLocationInCmd = 1;
             resourceParams.bIsWritable = FALSE;
             resourceParams.dwSize = params->dwDataSize;
@@ -407,7 +412,7 @@ protected:
             // base address of the stream out buffer
             resourceParams.presResource = params->presStreamOutObjectBuffer;
             resourceParams.dwOffset = params->dwStreamOutObjectOffset;
-            resourceParams.pdwCmd = (cmd.DW6_7.Value);
+            resourceParams.pdwCmd = (cmd->DW6_7.Value);
             resourceParams.dwLocationInCmd = 6;
             resourceParams.bIsWritable = TRUE;
             resourceParams.dwSize = params->dwStreamOutObjectSize;
@@ -418,7 +423,7 @@ protected:
                 &resourceParams));
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -430,22 +435,23 @@ protected:
         MHW_MI_CHK_NULL(cmdBuffer);
         MHW_MI_CHK_NULL(params);
 
-        typename THucCmds::HUC_STREAM_OBJECT_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THucCmds::HUC_STREAM_OBJECT_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
-        cmd.DW1.IndirectStreamInDataLength = params->dwIndStreamInLength;
-        cmd.DW2.IndirectStreamInStartAddress = params->dwIndStreamInStartAddrOffset;
-        cmd.DW2.HucProcessing = params->bHucProcessing;
-        cmd.DW3.IndirectStreamOutStartAddress = params->dwIndStreamOutStartAddrOffset;
-        cmd.DW4.HucBitstreamEnable = params->bStreamInEnable;
-        cmd.DW4.StreamOut = params->bStreamOutEnable;
-        cmd.DW4.EmulationPreventionByteRemoval = params->bEmulPreventionByteRemoval;
-        cmd.DW4.StartCodeSearchEngine = params->bStartCodeSearchEngine;
-        cmd.DW4.Drmlengthmode = params->bLengthModeEnabled;
-        cmd.DW4.StartCodeByte2 = params->ucStartCodeByte2;
-        cmd.DW4.StartCodeByte1 = params->ucStartCodeByte1;
-        cmd.DW4.StartCodeByte0 = params->ucStartCodeByte0;
+        cmd->DW1.IndirectStreamInDataLength = params->dwIndStreamInLength;
+        cmd->DW2.IndirectStreamInStartAddress = params->dwIndStreamInStartAddrOffset;
+        cmd->DW2.HucProcessing = params->bHucProcessing;
+        cmd->DW3.IndirectStreamOutStartAddress = params->dwIndStreamOutStartAddrOffset;
+        cmd->DW4.HucBitstreamEnable = params->bStreamInEnable;
+        cmd->DW4.StreamOut = params->bStreamOutEnable;
+        cmd->DW4.EmulationPreventionByteRemoval = params->bEmulPreventionByteRemoval;
+        cmd->DW4.StartCodeSearchEngine = params->bStartCodeSearchEngine;
+        cmd->DW4.Drmlengthmode = params->bLengthModeEnabled;
+        cmd->DW4.StartCodeByte2 = params->ucStartCodeByte2;
+        cmd->DW4.StartCodeByte1 = params->ucStartCodeByte1;
+        cmd->DW4.StartCodeByte0 = params->ucStartCodeByte0;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
@@ -456,12 +462,13 @@ protected:
     {
         MHW_MI_CHK_NULL(cmdBuffer);
 
-        typename THucCmds::HUC_START_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename THucCmds::HUC_START_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         // set last stream object or not
-        cmd.DW1.Laststreamobject = (lastStreamObject != 0);
+        cmd->DW1.Laststreamobject = (lastStreamObject != 0);
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, cmd.byteSize));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return MOS_STATUS_SUCCESS;
     }
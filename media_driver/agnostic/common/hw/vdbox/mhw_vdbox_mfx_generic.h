@@ -68,26 +68,27 @@ protected:
         MHW_MI_CHK_NULL(params);
         MHW_MI_CHK_NULL(params->pAvcPicIdx);
 
-        typename TMfxCmds::MFD_AVC_PICID_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFD_AVC_PICID_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
-        cmd.DW1.PictureidRemappingDisable = 1;
+        cmd->DW1.PictureidRemappingDisable = 1;
         if (params->bPicIdRemappingInUse)
         {
             uint32_t j = 0;
-            cmd.DW1.PictureidRemappingDisable = 0;
+            cmd->DW1.PictureidRemappingDisable = 0;
 
             for (auto i = 0; i < (CODEC_MAX_NUM_REF_FRAME / 2); i++)
             {
-                cmd.Pictureidlist1616Bits[i] = avcPicidDefault;
+                cmd->Pictureidlist1616Bits[i] = avcPicidDefault;
 
                 if (params->pAvcPicIdx[j++].bValid)
                 {
-                    cmd.Pictureidlist1616Bits[i] = (cmd.Pictureidlist1616Bits[i] & 0xffff0000) | params->pAvcPicIdx[j - 1].ucPicIdx;
+                    cmd->Pictureidlist1616Bits[i] = (cmd->Pictureidlist1616Bits[i] & 0xffff0000) | params->pAvcPicIdx[j - 1].ucPicIdx;
                 }
 
                 if (params->pAvcPicIdx[j++].bValid)
                 {
-                    cmd.Pictureidlist1616Bits[i] = (cmd.Pictureidlist1616Bits[i] & 0x0000ffff) | (params->pAvcPicIdx[j - 1].ucPicIdx << 16);
+                    cmd->Pictureidlist1616Bits[i] = (cmd->Pictureidlist1616Bits[i] & 0x0000ffff) | (params->pAvcPicIdx[j - 1].ucPicIdx << 16);
                 }
             }
         }
@@ -95,11 +96,11 @@ protected:
         {
             for (auto i = 0; i < (CODEC_MAX_NUM_REF_FRAME / 2); i++)
             {
-                cmd.Pictureidlist1616Bits[i] = avcPicidDisabled;
+                cmd->Pictureidlist1616Bits[i] = avcPicidDisabled;
             }
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -396,12 +397,13 @@ protected:
             return MOS_STATUS_INVALID_PARAMETER;
         }
 
-        typename TMfxCmds::MFX_AVC_REF_IDX_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMfxCmds::MFX_AVC_REF_IDX_STATE_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         auto avcRefList = params->ppAvcRefList;
-        AvcRefListWrite *cmdAvcRefListWrite = (AvcRefListWrite *)&(cmd.ReferenceListEntry);
+        AvcRefListWrite *cmdAvcRefListWrite = (AvcRefListWrite *)&(cmd->ReferenceListEntry);
 
-        cmd.DW1.RefpiclistSelect = params->uiList;
+        cmd->DW1.RefpiclistSelect = params->uiList;
 
         uint8_t picIDOneOnOneMapping = 0;
         for (uint32_t i = 0; i < params->uiNumRefForList; i++)
@@ -443,7 +445,7 @@ protected:
             cmdAvcRefListWrite->UC[i].value = 0x80;
         }
 
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -465,22 +467,23 @@ protected:
             return MOS_STATUS_INVALID_PARAMETER;
         }
 
-        typename TMfxCmds::MFX_AVC_WEIGHTOFFSET_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMfxCmds::MFX_AVC_WEIGHTOFFSET_STATE_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
-        cmd.DW1.WeightAndOffsetSelect = params->uiList;
+        cmd->DW1.WeightAndOffsetSelect = params->uiList;
 
         //The correct explicit calculation (like in Cantiga)
         for (auto i = 0; i < CODEC_MAX_NUM_REF_FIELD; i++)
         {
-            cmd.Weightoffset[3 * i] = params->Weights[params->uiList][i][0][0] & 0xFFFF; // Y weight
-            cmd.Weightoffset[3 * i] |= (params->Weights[params->uiList][i][0][1] & 0xFFFF) << 16; // Y offset
-            cmd.Weightoffset[3 * i + 1] = params->Weights[params->uiList][i][1][0] & 0xFFFF; // Cb weight
-            cmd.Weightoffset[3 * i + 1] |= (params->Weights[params->uiList][i][1][1] & 0xFFFF) << 16; // Cb offset
-            cmd.Weightoffset[3 * i + 2] = params->Weights[params->uiList][i][2][0] & 0xFFFF; // Cr weight
-            cmd.Weightoffset[3 * i + 2] |= (params->Weights[params->uiList][i][2][1] & 0xFFFF) << 16; // Cr offset
+            cmd->Weightoffset[3 * i] = params->Weights[params->uiList][i][0][0] & 0xFFFF; // Y weight
+            cmd->Weightoffset[3 * i] |= (params->Weights[params->uiList][i][0][1] & 0xFFFF) << 16; // Y offset
+            cmd->Weightoffset[3 * i + 1] = params->Weights[params->uiList][i][1][0] & 0xFFFF; // Cb weight
+            cmd->Weightoffset[3 * i + 1] |= (params->Weights[params->uiList][i][1][1] & 0xFFFF) << 16; // Cb offset
+            cmd->Weightoffset[3 * i + 2] = params->Weights[params->uiList][i][2][0] & 0xFFFF; // Cr weight
+            cmd->Weightoffset[3 * i + 2] |= (params->Weights[params->uiList][i][2][1] & 0xFFFF) << 16; // Cr offset
         }
 
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -502,40 +505,41 @@ protected:
             return MOS_STATUS_INVALID_PARAMETER;
         }
 
-        typename TMfxCmds::MFX_AVC_WEIGHTOFFSET_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMfxCmds::MFX_AVC_WEIGHTOFFSET_STATE_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
-        cmd.DW1.WeightAndOffsetSelect = params->uiList;
+        cmd->DW1.WeightAndOffsetSelect = params->uiList;
 
         for (uint32_t i = 0; i < params->uiNumRefForList; i++)
         {
             if (params->uiLumaWeightFlag & (1 << i))
             {
-                cmd.Weightoffset[3 * i] = params->Weights[params->uiList][i][0][0] & 0xFFFF; // Y weight
-                cmd.Weightoffset[3 * i] |= (params->Weights[params->uiList][i][0][1] & 0xFFFF) << 16; // Y offset
+                cmd->Weightoffset[3 * i] = params->Weights[params->uiList][i][0][0] & 0xFFFF; // Y weight
+                cmd->Weightoffset[3 * i] |= (params->Weights[params->uiList][i][0][1] & 0xFFFF) << 16; // Y offset
             }
             else
             {
-                cmd.Weightoffset[3 * i] = 1 << (params->uiLumaLogWeightDenom); // Y weight
-                cmd.Weightoffset[3 * i] = cmd.Weightoffset[3 * i] | (0 << 16); // Y offset
+                cmd->Weightoffset[3 * i] = 1 << (params->uiLumaLogWeightDenom); // Y weight
+                cmd->Weightoffset[3 * i] = cmd->Weightoffset[3 * i] | (0 << 16); // Y offset
             }
 
             if (params->uiChromaWeightFlag & (1 << i))
             {
-                cmd.Weightoffset[3 * i + 1] = params->Weights[params->uiList][i][1][0] & 0xFFFF; // Cb weight
-                cmd.Weightoffset[3 * i + 1] |= (params->Weights[params->uiList][i][1][1] & 0xFFFF) << 16; // Cb offset
-                cmd.Weightoffset[3 * i + 2] = params->Weights[params->uiList][i][2][0] & 0xFFFF; // Cr weight
-                cmd.Weightoffset[3 * i + 2] |= (params->Weights[params->uiList][i][2][1] & 0xFFFF) << 16; // Cr offset
+                cmd->Weightoffset[3 * i + 1] = params->Weights[params->uiList][i][1][0] & 0xFFFF; // Cb weight
+                cmd->Weightoffset[3 * i + 1] |= (params->Weights[params->uiList][i][1][1] & 0xFFFF) << 16; // Cb offset
+                cmd->Weightoffset[3 * i + 2] = params->Weights[params->uiList][i][2][0] & 0xFFFF; // Cr weight
+                cmd->Weightoffset[3 * i + 2] |= (params->Weights[params->uiList][i][2][1] & 0xFFFF) << 16; // Cr offset
             }
             else
             {
-                cmd.Weightoffset[3 * i + 1] = 1 << (params->uiChromaLogWeightDenom); // Cb  weight
-                cmd.Weightoffset[3 * i + 1] = cmd.Weightoffset[3 * i + 1] | (0 << 16); // Cb offset
-                cmd.Weightoffset[3 * i + 2] = 1 << (params->uiChromaLogWeightDenom); // Cr  weight
-                cmd.Weightoffset[3 * i + 2] = cmd.Weightoffset[3 * i + 2] | (0 << 16); // Cr offset
+                cmd->Weightoffset[3 * i + 1] = 1 << (params->uiChromaLogWeightDenom); // Cb  weight
+                cmd->Weightoffset[3 * i + 1] = cmd->Weightoffset[3 * i + 1] | (0 << 16); // Cb offset
+                cmd->Weightoffset[3 * i + 2] = 1 << (params->uiChromaLogWeightDenom); // Cr  weight
+                cmd->Weightoffset[3 * i + 2] = cmd->Weightoffset[3 * i + 2] | (0 << 16); // Cr offset
             }
         }
 
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -574,72 +578,73 @@ protected:
             frameFieldHeightInMb);
 
         auto sliceParams = avcSliceState->pAvcSliceParams;
-        typename TMfxCmds::MFX_AVC_SLICE_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMfxCmds::MFX_AVC_SLICE_STATE_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         // Set MFX_AVC_SLICE_STATE_CMD
-        cmd.DW1.SliceType = m_AvcBsdSliceType[sliceParams->slice_type];
-        cmd.DW2.Log2WeightDenomChroma = sliceParams->chroma_log2_weight_denom;
-        cmd.DW2.Log2WeightDenomLuma = sliceParams->luma_log2_weight_denom;
-        cmd.DW3.WeightedPredictionIndicator = 0;
-        cmd.DW3.DisableDeblockingFilterIndicator = avcSliceState->ucDisableDeblockingFilterIdc;
-        cmd.DW3.CabacInitIdc10 = sliceParams->cabac_init_idc;
-        cmd.DW3.SliceQuantizationParameter = 26 + picParams->pic_init_qp_minus26 + sliceParams->slice_qp_delta;
-        cmd.DW3.SliceBetaOffsetDiv2 = avcSliceState->ucSliceBetaOffsetDiv2;
-        cmd.DW3.SliceAlphaC0OffsetDiv2 = avcSliceState->ucSliceAlphaC0OffsetDiv2;
+        cmd->DW1.SliceType = m_AvcBsdSliceType[sliceParams->slice_type];
+        cmd->DW2.Log2WeightDenomChroma = sliceParams->chroma_log2_weight_denom;
+        cmd->DW2.Log2WeightDenomLuma = sliceParams->luma_log2_weight_denom;
+        cmd->DW3.WeightedPredictionIndicator = 0;
+        cmd->DW3.DisableDeblockingFilterIndicator = avcSliceState->ucDisableDeblockingFilterIdc;
+        cmd->DW3.CabacInitIdc10 = sliceParams->cabac_init_idc;
+        cmd->DW3.SliceQuantizationParameter = 26 + picParams->pic_init_qp_minus26 + sliceParams->slice_qp_delta;
+        cmd->DW3.SliceBetaOffsetDiv2 = avcSliceState->ucSliceBetaOffsetDiv2;
+        cmd->DW3.SliceAlphaC0OffsetDiv2 = avcSliceState->ucSliceAlphaC0OffsetDiv2;
 
         auto widthInMb = picParams->pic_width_in_mbs_minus1 + 1;
         if (avcSliceState->bPhantomSlice)
         {
-            cmd.DW4.SliceStartMbNum = widthInMb * frameFieldHeightInMb;
-            cmd.DW4.SliceVerticalPosition = frameFieldHeightInMb;
-            cmd.DW4.SliceHorizontalPosition = widthInMb;
+            cmd->DW4.SliceStartMbNum = widthInMb * frameFieldHeightInMb;
+            cmd->DW4.SliceVerticalPosition = frameFieldHeightInMb;
+            cmd->DW4.SliceHorizontalPosition = widthInMb;
         }
         else
         {
-            cmd.DW4.SliceStartMbNum = sliceParams->first_mb_in_slice * mbaffMultiplier;
-            cmd.DW4.SliceVerticalPosition = (sliceParams->first_mb_in_slice / widthInMb) * mbaffMultiplier;
-            cmd.DW4.SliceHorizontalPosition = sliceParams->first_mb_in_slice % widthInMb;
+            cmd->DW4.SliceStartMbNum = sliceParams->first_mb_in_slice * mbaffMultiplier;
+            cmd->DW4.SliceVerticalPosition = (sliceParams->first_mb_in_slice / widthInMb) * mbaffMultiplier;
+            cmd->DW4.SliceHorizontalPosition = sliceParams->first_mb_in_slice % widthInMb;
         }
 
         if (avcSliceState->bLastSlice)
         {
-            cmd.DW5.NextSliceVerticalPosition = frameFieldHeightInMb;
-            cmd.DW5.NextSliceHorizontalPosition = 0;
+            cmd->DW5.NextSliceVerticalPosition = frameFieldHeightInMb;
+            cmd->DW5.NextSliceHorizontalPosition = 0;
         }
         else
         {
-            cmd.DW5.NextSliceVerticalPosition = (sliceParams->first_mb_in_next_slice / widthInMb) * mbaffMultiplier;
-            cmd.DW5.NextSliceHorizontalPosition = sliceParams->first_mb_in_next_slice % widthInMb;
+            cmd->DW5.NextSliceVerticalPosition = (sliceParams->first_mb_in_next_slice / widthInMb) * mbaffMultiplier;
+            cmd->DW5.NextSliceHorizontalPosition = sliceParams->first_mb_in_next_slice % widthInMb;
         }
 
-        cmd.DW6.IsLastSlice = avcSliceState->bLastSlice;
+        cmd->DW6.IsLastSlice = avcSliceState->bLastSlice;
 
-        cmd.DW9.Roundintra = 5;
-        cmd.DW9.Roundintraenable = 1;
-        cmd.DW9.Roundinter = 2;
+        cmd->DW9.Roundintra = 5;
+        cmd->DW9.Roundintraenable = 1;
+        cmd->DW9.Roundinter = 2;
 
         if (IsAvcPSlice(sliceParams->slice_type))
         {
-            cmd.DW2.NumberOfReferencePicturesInInterPredictionList0 = sliceParams->num_ref_idx_l0_active_minus1 + 1;
-            cmd.DW3.WeightedPredictionIndicator = picParams->pic_fields.weighted_pred_flag;
+            cmd->DW2.NumberOfReferencePicturesInInterPredictionList0 = sliceParams->num_ref_idx_l0_active_minus1 + 1;
+            cmd->DW3.WeightedPredictionIndicator = picParams->pic_fields.weighted_pred_flag;
         }
         else if (IsAvcBSlice(sliceParams->slice_type))
         {
-            cmd.DW2.NumberOfReferencePicturesInInterPredictionList1 = sliceParams->num_ref_idx_l1_active_minus1 + 1;
-            cmd.DW2.NumberOfReferencePicturesInInterPredictionList0 = sliceParams->num_ref_idx_l0_active_minus1 + 1;
-            cmd.DW3.WeightedPredictionIndicator = picParams->pic_fields.weighted_bipred_idc;
-            cmd.DW3.DirectPredictionType = sliceParams->direct_spatial_mv_pred_flag;
+            cmd->DW2.NumberOfReferencePicturesInInterPredictionList1 = sliceParams->num_ref_idx_l1_active_minus1 + 1;
+            cmd->DW2.NumberOfReferencePicturesInInterPredictionList0 = sliceParams->num_ref_idx_l0_active_minus1 + 1;
+            cmd->DW3.WeightedPredictionIndicator = picParams->pic_fields.weighted_bipred_idc;
+            cmd->DW3.DirectPredictionType = sliceParams->direct_spatial_mv_pred_flag;
 
             // Set MFX_AVC_WEIGHTOFFSET_STATE_CMD_G6
             if (picParams->pic_fields.weighted_bipred_idc != 1)
             {
                 // luma/chroma_log2_weight_denoms need to be set to default value in the case of implicit mode
-                cmd.DW2.Log2WeightDenomChroma = m_log2WeightDenomDefault;
-                cmd.DW2.Log2WeightDenomLuma = m_log2WeightDenomDefault;
+                cmd->DW2.Log2WeightDenomChroma = m_log2WeightDenomDefault;
+                cmd->DW2.Log2WeightDenomLuma = m_log2WeightDenomDefault;
             }
         }
 
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -673,58 +678,59 @@ protected:
         bool mbaffFrameFlag = seqParams->mb_adaptive_frame_field_flag ? true : false;
         uint32_t startMbNum = sliceParams->first_mb_in_slice * (1 + mbaffFrameFlag);
 
-        typename TMfxCmds::MFX_AVC_SLICE_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMfxCmds::MFX_AVC_SLICE_STATE_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         //DW1
-        cmd.DW1.SliceType = Slice_Type[sliceParams->slice_type];
+        cmd->DW1.SliceType = Slice_Type[sliceParams->slice_type];
         //DW2
-        cmd.DW2.Log2WeightDenomLuma = sliceParams->luma_log2_weight_denom;
-        cmd.DW2.Log2WeightDenomChroma = sliceParams->chroma_log2_weight_denom;
-        cmd.DW2.NumberOfReferencePicturesInInterPredictionList0 = 0;
-        cmd.DW2.NumberOfReferencePicturesInInterPredictionList1 = 0;
+        cmd->DW2.Log2WeightDenomLuma = sliceParams->luma_log2_weight_denom;
+        cmd->DW2.Log2WeightDenomChroma = sliceParams->chroma_log2_weight_denom;
+        cmd->DW2.NumberOfReferencePicturesInInterPredictionList0 = 0;
+        cmd->DW2.NumberOfReferencePicturesInInterPredictionList1 = 0;
         //DW3
-        cmd.DW3.SliceAlphaC0OffsetDiv2 = sliceParams->slice_alpha_c0_offset_div2;
-        cmd.DW3.SliceBetaOffsetDiv2 = sliceParams->slice_beta_offset_div2;
-        cmd.DW3.SliceQuantizationParameter = 26 + picParams->pic_init_qp_minus26 + sliceParams->slice_qp_delta;
-        cmd.DW3.CabacInitIdc10 = sliceParams->cabac_init_idc;
-        cmd.DW3.DisableDeblockingFilterIndicator = sliceParams->disable_deblocking_filter_idc;
-        cmd.DW3.DirectPredictionType =
+        cmd->DW3.SliceAlphaC0OffsetDiv2 = sliceParams->slice_alpha_c0_offset_div2;
+        cmd->DW3.SliceBetaOffsetDiv2 = sliceParams->slice_beta_offset_div2;
+        cmd->DW3.SliceQuantizationParameter = 26 + picParams->pic_init_qp_minus26 + sliceParams->slice_qp_delta;
+        cmd->DW3.CabacInitIdc10 = sliceParams->cabac_init_idc;
+        cmd->DW3.DisableDeblockingFilterIndicator = sliceParams->disable_deblocking_filter_idc;
+        cmd->DW3.DirectPredictionType =
             IsAvcBSlice(sliceParams->slice_type) ? sliceParams->direct_spatial_mv_pred_flag : 0;
-        cmd.DW3.WeightedPredictionIndicator = DEFAULT_WEIGHTED_INTER_PRED_MODE;
+        cmd->DW3.WeightedPredictionIndicator = DEFAULT_WEIGHTED_INTER_PRED_MODE;
         //DW4
-        cmd.DW4.SliceHorizontalPosition = startMbNum % widthInMb;
-        cmd.DW4.SliceVerticalPosition = startMbNum / widthInMb;
+        cmd->DW4.SliceHorizontalPosition = startMbNum % widthInMb;
+        cmd->DW4.SliceVerticalPosition = startMbNum / widthInMb;
         //DW5
-        cmd.DW5.NextSliceHorizontalPosition = (startMbNum + sliceParams->NumMbsForSlice) % widthInMb;
-        cmd.DW5.NextSliceVerticalPosition = (startMbNum + sliceParams->NumMbsForSlice) / widthInMb;
+        cmd->DW5.NextSliceHorizontalPosition = (startMbNum + sliceParams->NumMbsForSlice) % widthInMb;
+        cmd->DW5.NextSliceVerticalPosition = (startMbNum + sliceParams->NumMbsForSlice) / widthInMb;
         //DW6
-        cmd.DW6.StreamId10 = 0;
-        cmd.DW6.SliceId30 = sliceParams->slice_id;
-        cmd.DW6.Cabaczerowordinsertionenable = (seqParams->RateControlMethod == RATECONTROL_CQP) ? 0 : 1;;
-        cmd.DW6.Emulationbytesliceinsertenable = 1;
-        cmd.DW6.IsLastSlice =
+        cmd->DW6.StreamId10 = 0;
+        cmd->DW6.SliceId30 = sliceParams->slice_id;
+        cmd->DW6.Cabaczerowordinsertionenable = (seqParams->RateControlMethod == RATECONTROL_CQP) ? 0 : 1;;
+        cmd->DW6.Emulationbytesliceinsertenable = 1;
+        cmd->DW6.IsLastSlice =
             (startMbNum + sliceParams->NumMbsForSlice) >= (uint32_t)(widthInMb * frameFieldHeightInMb);
         // Driver only programs 1st slice state, VDENC will detect the last slice 
         if (avcSliceState->bVdencInUse)
         {
-            cmd.DW6.TailInsertionPresentInBitstream = avcSliceState->bVdencNoTailInsertion ?
+            cmd->DW6.TailInsertionPresentInBitstream = avcSliceState->bVdencNoTailInsertion ?
                 0 : (picParams->bLastPicInSeq || picParams->bLastPicInStream);
         }
         else
         {
-            cmd.DW6.TailInsertionPresentInBitstream = (picParams->bLastPicInSeq || picParams->bLastPicInStream) && cmd.DW6.IsLastSlice;
+            cmd->DW6.TailInsertionPresentInBitstream = (picParams->bLastPicInSeq || picParams->bLastPicInStream) && cmd->DW6.IsLastSlice;
         }
-        cmd.DW6.SlicedataInsertionPresentInBitstream = 1;
-        cmd.DW6.HeaderInsertionPresentInBitstream = 1;
-        cmd.DW6.MbTypeSkipConversionDisable = 0;
-        cmd.DW6.MbTypeDirectConversionDisable = 0;
-        cmd.DW6.RateControlCounterEnable = (avcSliceState->bBrcEnabled && (!avcSliceState->bFirstPass));
+        cmd->DW6.SlicedataInsertionPresentInBitstream = 1;
+        cmd->DW6.HeaderInsertionPresentInBitstream = 1;
+        cmd->DW6.MbTypeSkipConversionDisable = 0;
+        cmd->DW6.MbTypeDirectConversionDisable = 0;
+        cmd->DW6.RateControlCounterEnable = (avcSliceState->bBrcEnabled && (!avcSliceState->bFirstPass));
 
-        if (cmd.DW6.RateControlCounterEnable == true)
+        if (cmd->DW6.RateControlCounterEnable == true)
         {
             // These fields are valid only when RateControlCounterEnable = 1
-            cmd.DW6.RcPanicType = 1;    // CBP Panic
-            cmd.DW6.RcPanicEnable =
+            cmd->DW6.RcPanicType = 1;    // CBP Panic
+            cmd->DW6.RcPanicEnable =
                 (avcSliceState->bRCPanicEnable &&
                 (seqParams->RateControlMethod != RATECONTROL_AVBR) &&
                     (seqParams->RateControlMethod != RATECONTROL_IWD_VBR) &&
@@ -732,41 +738,41 @@ protected:
                     (seqParams->RateControlMethod != RATECONTROL_VCM) &&
                     (seqParams->RateControlMethod != RATECONTROL_CQP) &&
                     avcSliceState->bLastPass);    // Enable only in the last pass
-            cmd.DW6.RcStableTolerance = 0;
-            cmd.DW6.RcTriggleMode = 2;    // Loose Rate Control
-            cmd.DW6.Resetratecontrolcounter = !startMbNum;
+            cmd->DW6.RcStableTolerance = 0;
+            cmd->DW6.RcTriggleMode = 2;    // Loose Rate Control
+            cmd->DW6.Resetratecontrolcounter = !startMbNum;
         }
 
-        cmd.DW9.Roundinter = 2;
+        cmd->DW9.Roundinter = 2;
 
         if (IsAvcPSlice(sliceParams->slice_type))
         {
-            cmd.DW2.NumberOfReferencePicturesInInterPredictionList0 = sliceParams->num_ref_idx_l0_active_minus1_from_DDI + 1;
-            cmd.DW3.WeightedPredictionIndicator = picParams->weighted_pred_flag;
+            cmd->DW2.NumberOfReferencePicturesInInterPredictionList0 = sliceParams->num_ref_idx_l0_active_minus1_from_DDI + 1;
+            cmd->DW3.WeightedPredictionIndicator = picParams->weighted_pred_flag;
 
-            cmd.DW9.Roundinterenable = avcSliceState->bRoundingInterEnable;
-            cmd.DW9.Roundinter = avcSliceState->dwRoundingValue;
+            cmd->DW9.Roundinterenable = avcSliceState->bRoundingInterEnable;
+            cmd->DW9.Roundinter = avcSliceState->dwRoundingValue;
         }
         else if (IsAvcBSlice(sliceParams->slice_type))
         {
-            cmd.DW2.NumberOfReferencePicturesInInterPredictionList1 = sliceParams->num_ref_idx_l1_active_minus1_from_DDI + 1;
-            cmd.DW2.NumberOfReferencePicturesInInterPredictionList0 = sliceParams->num_ref_idx_l0_active_minus1_from_DDI + 1;
-            cmd.DW3.WeightedPredictionIndicator = picParams->weighted_bipred_idc;
+            cmd->DW2.NumberOfReferencePicturesInInterPredictionList1 = sliceParams->num_ref_idx_l1_active_minus1_from_DDI + 1;
+            cmd->DW2.NumberOfReferencePicturesInInterPredictionList0 = sliceParams->num_ref_idx_l0_active_minus1_from_DDI + 1;
+            cmd->DW3.WeightedPredictionIndicator = picParams->weighted_bipred_idc;
             if (picParams->weighted_bipred_idc == IMPLICIT_WEIGHTED_INTER_PRED_MODE)
             {
                 // SNB requirement
-                cmd.DW2.Log2WeightDenomLuma = 5;
-                cmd.DW2.Log2WeightDenomChroma = 5;
+                cmd->DW2.Log2WeightDenomLuma = 5;
+                cmd->DW2.Log2WeightDenomChroma = 5;
             }
 
-            cmd.DW9.Roundinterenable = avcSliceState->bRoundingInterEnable;
-            cmd.DW9.Roundinter = avcSliceState->dwRoundingValue;
+            cmd->DW9.Roundinterenable = avcSliceState->bRoundingInterEnable;
+            cmd->DW9.Roundinter = avcSliceState->dwRoundingValue;
         }
 
-        cmd.DW9.Roundintra = avcSliceState->dwRoundingIntraValue;
-        cmd.DW9.Roundintraenable = 1;
+        cmd->DW9.Roundintra = avcSliceState->dwRoundingIntraValue;
+        cmd->DW9.Roundintraenable = 1;
    
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -807,16 +813,17 @@ protected:
             longTermFrame |= (((uint16_t)longTermFrameFlag) << frameID);
         }
 
-        typename TMfxCmds::MFD_AVC_DPB_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFD_AVC_DPB_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
-        cmd.DW1.NonExistingframeFlag161Bit = nonExistingFrameFlags;
-        cmd.DW1.LongtermframeFlag161Bit = longTermFrame;
-        cmd.DW2.Value = usedForRef;
+        cmd->DW1.NonExistingframeFlag161Bit = nonExistingFrameFlags;
+        cmd->DW1.LongtermframeFlag161Bit = longTermFrame;
+        cmd->DW2.Value = usedForRef;
 
         for (auto i = 0, j = 0; i < 8; i++, j++)
         {
-            cmd.Ltstframenumlist1616Bits[i] = (refFrameOrder[j++] & 0xFFFF); //FirstEntry
-            cmd.Ltstframenumlist1616Bits[i] = cmd.Ltstframenumlist1616Bits[i] | ((refFrameOrder[j] & 0xFFFF) << 16);    //SecondEntry
+            cmd->Ltstframenumlist1616Bits[i] = (refFrameOrder[j++] & 0xFFFF); //FirstEntry
+            cmd->Ltstframenumlist1616Bits[i] = cmd->Ltstframenumlist1616Bits[i] | ((refFrameOrder[j] & 0xFFFF) << 16);    //SecondEntry
         }
 
         auto mvcExtPicParams = params->pMvcExtPicParams;
@@ -824,45 +831,45 @@ protected:
         {
             for (auto i = 0, j = 0; i < (CODEC_MAX_NUM_REF_FRAME / 2); i++, j++)
             {
-                cmd.Viewidlist1616Bits[i] = mvcExtPicParams->ViewIDList[j++];
-                cmd.Viewidlist1616Bits[i] = cmd.Viewidlist1616Bits[i] | (mvcExtPicParams->ViewIDList[j] << 16);
+                cmd->Viewidlist1616Bits[i] = mvcExtPicParams->ViewIDList[j++];
+                cmd->Viewidlist1616Bits[i] = cmd->Viewidlist1616Bits[i] | (mvcExtPicParams->ViewIDList[j] << 16);
             }
 
             for (auto i = 0, j = 0; i < (CODEC_MAX_NUM_REF_FRAME / 4); i++, j++)
             {
-                cmd.Vieworderlistl0168Bits[i] = GetViewOrder(params, j++, LIST_0); //FirstEntry
-                cmd.Vieworderlistl0168Bits[i] = cmd.Vieworderlistl0168Bits[i] | (GetViewOrder(params, j++, LIST_0) << 8);  //SecondEntry
-                cmd.Vieworderlistl0168Bits[i] = cmd.Vieworderlistl0168Bits[i] | (GetViewOrder(params, j++, LIST_0) << 16); //ThirdEntry
-                cmd.Vieworderlistl0168Bits[i] = cmd.Vieworderlistl0168Bits[i] | (GetViewOrder(params, j, LIST_0) << 24);   //FourthEntry
+                cmd->Vieworderlistl0168Bits[i] = GetViewOrder(params, j++, LIST_0); //FirstEntry
+                cmd->Vieworderlistl0168Bits[i] = cmd->Vieworderlistl0168Bits[i] | (GetViewOrder(params, j++, LIST_0) << 8);  //SecondEntry
+                cmd->Vieworderlistl0168Bits[i] = cmd->Vieworderlistl0168Bits[i] | (GetViewOrder(params, j++, LIST_0) << 16); //ThirdEntry
+                cmd->Vieworderlistl0168Bits[i] = cmd->Vieworderlistl0168Bits[i] | (GetViewOrder(params, j, LIST_0) << 24);   //FourthEntry
             }
 
             for (auto i = 0, j = 0; i < (CODEC_MAX_NUM_REF_FRAME / 4); i++, j++)
             {
-                cmd.Vieworderlistl1168Bits[i] = GetViewOrder(params, j++, LIST_1); //FirstEntry
-                cmd.Vieworderlistl1168Bits[i] = cmd.Vieworderlistl1168Bits[i] | (GetViewOrder(params, j++, LIST_1) << 8); //SecondEntry
-                cmd.Vieworderlistl1168Bits[i] = cmd.Vieworderlistl1168Bits[i] | (GetViewOrder(params, j++, LIST_1) << 16); //ThirdEntry
-                cmd.Vieworderlistl1168Bits[i] = cmd.Vieworderlistl1168Bits[i] | (GetViewOrder(params, j, LIST_1) << 24); //FourthEntry
+                cmd->Vieworderlistl1168Bits[i] = GetViewOrder(params, j++, LIST_1); //FirstEntry
+                cmd->Vieworderlistl1168Bits[i] = cmd->Vieworderlistl1168Bits[i] | (GetViewOrder(params, j++, LIST_1) << 8); //SecondEntry
+                cmd->Vieworderlistl1168Bits[i] = cmd->Vieworderlistl1168Bits[i] | (GetViewOrder(params, j++, LIST_1) << 16); //ThirdEntry
+                cmd->Vieworderlistl1168Bits[i] = cmd->Vieworderlistl1168Bits[i] | (GetViewOrder(params, j, LIST_1) << 24); //FourthEntry
             }
         }
         else
         {
             for (auto i = 0, j = 0; i < (CODEC_MAX_NUM_REF_FRAME / 2); i++, j++)
             {
-                cmd.Viewidlist1616Bits[i] = 0;
+                cmd->Viewidlist1616Bits[i] = 0;
             }
 
             for (auto i = 0, j = 0; i < (CODEC_MAX_NUM_REF_FRAME / 4); i++, j++)
             {
-                cmd.Vieworderlistl0168Bits[i] = 0; //FirstEntry
+                cmd->Vieworderlistl0168Bits[i] = 0; //FirstEntry
             }
 
             for (auto i = 0, j = 0; i < (CODEC_MAX_NUM_REF_FRAME / 4); i++, j++)
             {
-                cmd.Vieworderlistl1168Bits[i] = 0; //FirstEntry
+                cmd->Vieworderlistl1168Bits[i] = 0; //FirstEntry
             }
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -936,36 +943,37 @@ protected:
         MHW_MI_CHK_NULL(params);
         MHW_MI_CHK_NULL(params->pMpeg2PicParams);
        
-        typename TMfxCmds::MFX_MPEG2_PIC_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFX_MPEG2_PIC_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         auto picParams = params->pMpeg2PicParams;
 
-        cmd.DW1.ScanOrder = picParams->W0.m_scanOrder;
-        cmd.DW1.IntraVlcFormat = picParams->W0.m_intraVlcFormat;
-        cmd.DW1.QuantizerScaleType = picParams->W0.m_quantizerScaleType;
-        cmd.DW1.ConcealmentMotionVectorFlag = picParams->W0.m_concealmentMVFlag;
-        cmd.DW1.FramePredictionFrameDct = picParams->W0.m_frameDctPrediction;
-        cmd.DW1.TffTopFieldFirst = (CodecHal_PictureIsFrame(picParams->m_currPic)) ?
+        cmd->DW1.ScanOrder = picParams->W0.m_scanOrder;
+        cmd->DW1.IntraVlcFormat = picParams->W0.m_intraVlcFormat;
+        cmd->DW1.QuantizerScaleType = picParams->W0.m_quantizerScaleType;
+        cmd->DW1.ConcealmentMotionVectorFlag = picParams->W0.m_concealmentMVFlag;
+        cmd->DW1.FramePredictionFrameDct = picParams->W0.m_frameDctPrediction;
+        cmd->DW1.TffTopFieldFirst = (CodecHal_PictureIsFrame(picParams->m_currPic)) ?
             picParams->W0.m_topFieldFirst : picParams->m_topFieldFirst;
 
-        cmd.DW1.PictureStructure = (CodecHal_PictureIsFrame(picParams->m_currPic)) ?
+        cmd->DW1.PictureStructure = (CodecHal_PictureIsFrame(picParams->m_currPic)) ?
             mpeg2Vc1Frame : (CodecHal_PictureIsTopField(picParams->m_currPic)) ?
             mpeg2Vc1TopField : mpeg2Vc1BottomField;
-        cmd.DW1.IntraDcPrecision = picParams->W0.m_intraDCPrecision;
-        cmd.DW1.FCode00 = picParams->W1.m_fcode00;
-        cmd.DW1.FCode01 = picParams->W1.m_fcode01;
-        cmd.DW1.FCode10 = picParams->W1.m_fcode10;
-        cmd.DW1.FCode11 = picParams->W1.m_fcode11;
+        cmd->DW1.IntraDcPrecision = picParams->W0.m_intraDCPrecision;
+        cmd->DW1.FCode00 = picParams->W1.m_fcode00;
+        cmd->DW1.FCode01 = picParams->W1.m_fcode01;
+        cmd->DW1.FCode10 = picParams->W1.m_fcode10;
+        cmd->DW1.FCode11 = picParams->W1.m_fcode11;
 
-        cmd.DW2.PictureCodingType = picParams->m_pictureCodingType;
+        cmd->DW2.PictureCodingType = picParams->m_pictureCodingType;
 
         if (params->Mode == CODECHAL_DECODE_MODE_MPEG2VLD)
         {
-            cmd.DW2.ISliceConcealmentMode = params->dwMPEG2ISliceConcealmentMode;
-            cmd.DW2.PBSliceConcealmentMode = params->dwMPEG2PBSliceConcealmentMode;
-            cmd.DW2.PBSlicePredictedBidirMotionTypeOverrideBiDirectionMvTypeOverride = params->dwMPEG2PBSlicePredBiDirMVTypeOverride;
-            cmd.DW2.PBSlicePredictedMotionVectorOverrideFinalMvValueOverride = params->dwMPEG2PBSlicePredMVOverride;
+            cmd->DW2.ISliceConcealmentMode = params->dwMPEG2ISliceConcealmentMode;
+            cmd->DW2.PBSliceConcealmentMode = params->dwMPEG2PBSliceConcealmentMode;
+            cmd->DW2.PBSlicePredictedBidirMotionTypeOverrideBiDirectionMvTypeOverride = params->dwMPEG2PBSlicePredBiDirMVTypeOverride;
+            cmd->DW2.PBSlicePredictedMotionVectorOverrideFinalMvValueOverride = params->dwMPEG2PBSlicePredMVOverride;
 
-            cmd.DW3.SliceConcealmentDisableBit = 1;
+            cmd->DW3.SliceConcealmentDisableBit = 1;
         }
 
         uint16_t widthInMbs =
@@ -976,24 +984,24 @@ protected:
             (picParams->m_verticalSize + CODECHAL_MACROBLOCK_HEIGHT - 1) /
             CODECHAL_MACROBLOCK_HEIGHT;
 
-        cmd.DW3.Framewidthinmbsminus170PictureWidthInMacroblocks = widthInMbs - 1;
-        cmd.DW3.Frameheightinmbsminus170PictureHeightInMacroblocks = (CodecHal_PictureIsField(picParams->m_currPic)) ?
+        cmd->DW3.Framewidthinmbsminus170PictureWidthInMacroblocks = widthInMbs - 1;
+        cmd->DW3.Frameheightinmbsminus170PictureHeightInMacroblocks = (CodecHal_PictureIsField(picParams->m_currPic)) ?
             ((heightInMbs * 2) - 1) : heightInMbs - 1;
 
         if (params->bDeblockingEnabled)
         {
-            cmd.DW3.Reserved120 = 9;
+            cmd->DW3.Reserved120 = 9;
         }
 
-        cmd.DW4.Roundintradc = 3;
-        cmd.DW4.Roundinterdc = 1;
-        cmd.DW4.Roundintraac = 5;
-        cmd.DW4.Roundinterac = 1;
+        cmd->DW4.Roundintradc = 3;
+        cmd->DW4.Roundinterdc = 1;
+        cmd->DW4.Roundintraac = 5;
+        cmd->DW4.Roundinterac = 1;
 
-        cmd.DW6.Intrambmaxsize = 0xfff;
-        cmd.DW6.Intermbmaxsize = 0xfff;
+        cmd->DW6.Intrambmaxsize = 0xfff;
+        cmd->DW6.Intermbmaxsize = 0xfff;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -1010,51 +1018,52 @@ protected:
         MHW_MI_CHK_NULL(params);
         MHW_MI_CHK_NULL(params->pEncodeMpeg2PicParams);
 
-        typename TMfxCmds::MFX_MPEG2_PIC_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFX_MPEG2_PIC_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         auto picParams = params->pEncodeMpeg2PicParams;
 
-        cmd.DW1.ScanOrder = picParams->m_alternateScan;
-        cmd.DW1.IntraVlcFormat = picParams->m_intraVlcFormat;
-        cmd.DW1.QuantizerScaleType = picParams->m_qscaleType;
-        cmd.DW1.ConcealmentMotionVectorFlag = picParams->m_concealmentMotionVectors;
-        cmd.DW1.FramePredictionFrameDct = picParams->m_framePredFrameDCT;
-        cmd.DW1.TffTopFieldFirst = !picParams->m_interleavedFieldBFF;
-        cmd.DW1.PictureStructure = (CodecHal_PictureIsFrame(picParams->m_currOriginalPic)) ?
+        cmd->DW1.ScanOrder = picParams->m_alternateScan;
+        cmd->DW1.IntraVlcFormat = picParams->m_intraVlcFormat;
+        cmd->DW1.QuantizerScaleType = picParams->m_qscaleType;
+        cmd->DW1.ConcealmentMotionVectorFlag = picParams->m_concealmentMotionVectors;
+        cmd->DW1.FramePredictionFrameDct = picParams->m_framePredFrameDCT;
+        cmd->DW1.TffTopFieldFirst = !picParams->m_interleavedFieldBFF;
+        cmd->DW1.PictureStructure = (CodecHal_PictureIsFrame(picParams->m_currOriginalPic)) ?
             mpeg2Vc1Frame : (CodecHal_PictureIsTopField(picParams->m_currOriginalPic)) ?
             mpeg2Vc1TopField : mpeg2Vc1BottomField;
-        cmd.DW1.IntraDcPrecision = picParams->m_intraDCprecision;
+        cmd->DW1.IntraDcPrecision = picParams->m_intraDCprecision;
         if (picParams->m_pictureCodingType == I_TYPE)
         {
-            cmd.DW1.FCode00 = 0xf;
-            cmd.DW1.FCode01 = 0xf;
+            cmd->DW1.FCode00 = 0xf;
+            cmd->DW1.FCode01 = 0xf;
         }
         else
         {
-            cmd.DW1.FCode00 = picParams->m_fcode00;
-            cmd.DW1.FCode01 = picParams->m_fcode01;
+            cmd->DW1.FCode00 = picParams->m_fcode00;
+            cmd->DW1.FCode01 = picParams->m_fcode01;
         }
-        cmd.DW1.FCode10 = picParams->m_fcode10;
-        cmd.DW1.FCode11 = picParams->m_fcode11;
+        cmd->DW1.FCode10 = picParams->m_fcode10;
+        cmd->DW1.FCode11 = picParams->m_fcode11;
 
-        cmd.DW2.PictureCodingType = picParams->m_pictureCodingType;
-        cmd.DW2.LoadslicepointerflagLoadbitstreampointerperslice = 0; // Do not reload bitstream pointer for each slice
+        cmd->DW2.PictureCodingType = picParams->m_pictureCodingType;
+        cmd->DW2.LoadslicepointerflagLoadbitstreampointerperslice = 0; // Do not reload bitstream pointer for each slice
 
-        cmd.DW3.Framewidthinmbsminus170PictureWidthInMacroblocks = params->wPicWidthInMb - 1;
-        cmd.DW3.Frameheightinmbsminus170PictureHeightInMacroblocks = params->wPicHeightInMb - 1;
+        cmd->DW3.Framewidthinmbsminus170PictureWidthInMacroblocks = params->wPicWidthInMb - 1;
+        cmd->DW3.Frameheightinmbsminus170PictureHeightInMacroblocks = params->wPicHeightInMb - 1;
 
-        cmd.DW4.Roundintradc = 3;
-        cmd.DW4.Roundinterdc = 1;
-        cmd.DW4.Roundintraac = 5;
-        cmd.DW4.Roundinterac = 1;
-        cmd.DW4.Mbstatenabled = 0;
+        cmd->DW4.Roundintradc = 3;
+        cmd->DW4.Roundinterdc = 1;
+        cmd->DW4.Roundintraac = 5;
+        cmd->DW4.Roundinterac = 1;
+        cmd->DW4.Mbstatenabled = 0;
 
-        cmd.DW5.Mbratecontrolmask = 0;
-        cmd.DW5.Framesizecontrolmask = 0; // Disable first for PAK pass, used when MacroblockStatEnable is 1
+        cmd->DW5.Mbratecontrolmask = 0;
+        cmd->DW5.Framesizecontrolmask = 0; // Disable first for PAK pass, used when MacroblockStatEnable is 1
 
-        cmd.DW6.Intrambmaxsize = 0xfff;
-        cmd.DW6.Intermbmaxsize = 0xfff;
+        cmd->DW6.Intrambmaxsize = 0xfff;
+        cmd->DW6.Intermbmaxsize = 0xfff;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -1077,34 +1086,35 @@ protected:
             return MOS_STATUS_INVALID_PARAMETER;
         }
 
-        typename TMfxCmds::MFD_MPEG2_BSD_OBJECT_CMD  cmd;
+        auto cmd = Mhw_EmplaceCommandCmdOrBB<typename TMfxCmds::MFD_MPEG2_BSD_OBJECT_CMD>(cmdBuffer, batchBuffer);
+        MHW_MI_CHK_NULL(cmd);
         auto sliceParams = params->pMpeg2SliceParams;
 
         uint32_t endMb = params->dwSliceStartMbOffset + sliceParams->m_numMbsForSlice;
         uint32_t slcLocation = (uint32_t)(sliceParams->m_sliceDataOffset + params->dwOffset);
 
-        cmd.DW1.IndirectBsdDataLength = params->dwLength;
-        cmd.DW2.IndirectDataStartAddress = slcLocation;
-        cmd.DW3.FirstMacroblockBitOffset = (sliceParams->m_macroblockOffset & 0x0007);
+        cmd->DW1.IndirectBsdDataLength = params->dwLength;
+        cmd->DW2.IndirectDataStartAddress = slcLocation;
+        cmd->DW3.FirstMacroblockBitOffset = (sliceParams->m_macroblockOffset & 0x0007);
 
-        cmd.DW3.IsLastMb = cmd.DW3.LastPicSlice = params->bLastSlice;
-        cmd.DW3.Reserved100 =
+        cmd->DW3.IsLastMb = cmd->DW3.LastPicSlice = params->bLastSlice;
+        cmd->DW3.Reserved100 =
             ((endMb / params->wPicWidthInMb) != sliceParams->m_sliceVerticalPosition) ? 1 : 0;
 
-        cmd.DW3.MacroblockCount = sliceParams->m_numMbsForSlice;
-        cmd.DW3.SliceHorizontalPosition = sliceParams->m_sliceHorizontalPosition;
-        cmd.DW3.SliceVerticalPosition = sliceParams->m_sliceVerticalPosition;
-        cmd.DW4.QuantizerScaleCode = sliceParams->m_quantiserScaleCode;
+        cmd->DW3.MacroblockCount = sliceParams->m_numMbsForSlice;
+        cmd->DW3.SliceHorizontalPosition = sliceParams->m_sliceHorizontalPosition;
+        cmd->DW3.SliceVerticalPosition = sliceParams->m_sliceVerticalPosition;
+        cmd->DW4.QuantizerScaleCode = sliceParams->m_quantiserScaleCode;
 
-        if (cmd.DW3.IsLastMb)
+        if (cmd->DW3.IsLastMb)
         {
-            cmd.DW4.NextSliceHorizontalPosition = 0;
-            cmd.DW4.NextSliceVerticalPosition = params->wPicHeightInMb;
+            cmd->DW4.NextSliceHorizontalPosition = 0;
+            cmd->DW4.NextSliceVerticalPosition = params->wPicHeightInMb;
         }
         else
         {
-            cmd.DW4.NextSliceHorizontalPosition = endMb % params->wPicWidthInMb;
-            cmd.DW4.NextSliceVerticalPosition = endMb / params->wPicWidthInMb;
+            cmd->DW4.NextSliceHorizontalPosition = endMb % params->wPicWidthInMb;
+            cmd->DW4.NextSliceVerticalPosition = endMb / params->wPicWidthInMb;
         }
 
         uint32_t offset = ((sliceParams->m_macroblockOffset & 0x0000fff8) >> 3); // #of bytes of header data in bitstream buffer (before video data)
@@ -1119,7 +1129,7 @@ protected:
             batchBuffer,
             &sliceInfoParam);
       
-        MHW_MI_CHK_STATUS(Mhw_AddCommandCmdOrBB(cmdBuffer, batchBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mhw_CommitCommandCmdOrBB(cmdBuffer, batchBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -1216,26 +1226,27 @@ protected:
         auto seqParams = mpeg2SliceState->pEncodeMpeg2SeqParams;
         auto slcData = mpeg2SliceState->pSlcData;
 
-        typename TMfxCmds::MFC_MPEG2_SLICEGROUP_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFC_MPEG2_SLICEGROUP_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
-        cmd.DW1.Streamid10EncoderOnly = 0;
-        cmd.DW1.Sliceid30EncoderOnly = 0;
-        cmd.DW1.Intrasliceflag = 1;
-        cmd.DW1.Intraslice = sliceParams->m_intraSlice;
-        cmd.DW1.Firstslicehdrdisabled = 0;
-        cmd.DW1.TailpresentflagTailInsertionPresentInBitstreamEncoderOnly =
+        cmd->DW1.Streamid10EncoderOnly = 0;
+        cmd->DW1.Sliceid30EncoderOnly = 0;
+        cmd->DW1.Intrasliceflag = 1;
+        cmd->DW1.Intraslice = sliceParams->m_intraSlice;
+        cmd->DW1.Firstslicehdrdisabled = 0;
+        cmd->DW1.TailpresentflagTailInsertionPresentInBitstreamEncoderOnly =
             (picParams->m_lastPicInStream && (slcData->SliceGroup & SLICE_GROUP_LAST));
-        cmd.DW1.SlicedataPresentflagSlicedataInsertionPresentInBitstreamEncoderOnly = 1;
-        cmd.DW1.HeaderpresentflagHeaderInsertionPresentInBitstreamEncoderOnly = 1;
-        cmd.DW1.BitstreamoutputflagCompressedBitstreamOutputDisableFlagEncoderOnly = 0;
-        cmd.DW1.Islastslicegrp = (slcData->SliceGroup & SLICE_GROUP_LAST) ? 1 : 0;
-        cmd.DW1.SkipconvdisabledMbTypeSkipConversionDisableEncoderOnly = sliceParams->m_intraSlice; // Disable for I slice
-
-        cmd.DW1.MbratectrlflagRatecontrolcounterenableEncoderOnly = (mpeg2SliceState->bBrcEnabled && (!mpeg2SliceState->bFirstPass));
-        cmd.DW1.MbratectrlresetResetratecontrolcounterEncoderOnly = 1;
-        cmd.DW1.RatectrlpanictypeRcPanicTypeEncoderOnly = 1; // CBP type
-        cmd.DW1.MbratectrlmodeRcTriggleModeEncoderOnly = 2; // Loose Rate Control Mode
-        cmd.DW1.RatectrlpanicflagRcPanicEnableEncoderOnly =
+        cmd->DW1.SlicedataPresentflagSlicedataInsertionPresentInBitstreamEncoderOnly = 1;
+        cmd->DW1.HeaderpresentflagHeaderInsertionPresentInBitstreamEncoderOnly = 1;
+        cmd->DW1.BitstreamoutputflagCompressedBitstreamOutputDisableFlagEncoderOnly = 0;
+        cmd->DW1.Islastslicegrp = (slcData->SliceGroup & SLICE_GROUP_LAST) ? 1 : 0;
+        cmd->DW1.SkipconvdisabledMbTypeSkipConversionDisableEncoderOnly = sliceParams->m_intraSlice; // Disable for I slice
+
+        cmd->DW1.MbratectrlflagRatecontrolcounterenableEncoderOnly = (mpeg2SliceState->bBrcEnabled && (!mpeg2SliceState->bFirstPass));
+        cmd->DW1.MbratectrlresetResetratecontrolcounterEncoderOnly = 1;
+        cmd->DW1.RatectrlpanictypeRcPanicTypeEncoderOnly = 1; // CBP type
+        cmd->DW1.MbratectrlmodeRcTriggleModeEncoderOnly = 2; // Loose Rate Control Mode
+        cmd->DW1.RatectrlpanicflagRcPanicEnableEncoderOnly =
             (mpeg2SliceState->bRCPanicEnable &&
             (seqParams->m_rateControlMethod != RATECONTROL_AVBR) &&
                 (seqParams->m_rateControlMethod != RATECONTROL_IWD_VBR) &&
@@ -1244,18 +1255,18 @@ protected:
                 (seqParams->m_rateControlMethod != RATECONTROL_CQP) &&
                 mpeg2SliceState->bLastPass);    // Enable only in the last pass
 
-        cmd.DW2.FirstmbxcntAlsoCurrstarthorzpos = sliceParams->m_firstMbX;
-        cmd.DW2.FirstmbycntAlsoCurrstartvertpos = sliceParams->m_firstMbY;
-        cmd.DW2.NextsgmbxcntAlsoNextstarthorzpos = slcData->NextSgMbXCnt;
-        cmd.DW2.NextsgmbycntAlsoNextstartvertpos = slcData->NextSgMbYCnt;
+        cmd->DW2.FirstmbxcntAlsoCurrstarthorzpos = sliceParams->m_firstMbX;
+        cmd->DW2.FirstmbycntAlsoCurrstartvertpos = sliceParams->m_firstMbY;
+        cmd->DW2.NextsgmbxcntAlsoNextstarthorzpos = slcData->NextSgMbXCnt;
+        cmd->DW2.NextsgmbycntAlsoNextstartvertpos = slcData->NextSgMbYCnt;
 
-        cmd.DW3.Slicegroupqp = sliceParams->m_quantiserScaleCode;
-        cmd.DW3.Slicegroupskip = 0; // MBZ for MPEG2
+        cmd->DW3.Slicegroupqp = sliceParams->m_quantiserScaleCode;
+        cmd->DW3.Slicegroupskip = 0; // MBZ for MPEG2
 
         // H/W should use this start addr only for the first slice, since LoadSlicePointerFlag = 0 in PIC_STATE
-        cmd.DW4.BitstreamoffsetIndirectPakBseDataStartAddressWrite = 0;
+        cmd->DW4.BitstreamoffsetIndirectPakBseDataStartAddressWrite = 0;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -1467,8 +1478,9 @@ protected:
             }
         }
 
-        typename TMfxCmds::MFX_VC1_PRED_PIPE_STATE_CMD cmd;
-        cmd.DW1.ReferenceFrameBoundaryReplicationMode = refBoundaryReplicationMode.BY0.value;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFX_VC1_PRED_PIPE_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
+        cmd->DW1.ReferenceFrameBoundaryReplicationMode = refBoundaryReplicationMode.BY0.value;
 
         uint32_t fwdDoubleIcEnable = 0, fwdSingleIcEnable = 0;
         uint32_t bwdDoubleIcEnable = 0, bwdSingleIcEnable = 0;
@@ -1484,12 +1496,12 @@ protected:
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP))
                     {
                         fwdDoubleIcEnable = TOP_FIELD;
-                        cmd.DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                        cmd.DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                        cmd->DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                        cmd->DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
                         // IC values for the bottom out of bound pixels (replicated lines of the last
                         // line of top field)
-                        cmd.DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                        cmd.DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                        cmd->DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                        cmd->DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
 
                         MOS_BIT_ON(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP_2);
                         icField++;
@@ -1499,10 +1511,10 @@ protected:
                         fwdDoubleIcEnable = BOTTOM_FIELD;
                         // IC values for the top out of bound pixels (replicated lines of the first
                         // line of bottom field)
-                        cmd.DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                        cmd.DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
-                        cmd.DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                        cmd.DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                        cmd->DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                        cmd->DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                        cmd->DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                        cmd->DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
 
                         MOS_BIT_ON(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP_2);
                         icField++;
@@ -1514,18 +1526,18 @@ protected:
                     MOS_BIT_ON(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_FRAME_COMP);
 
                     fwdSingleIcEnable = TOP_FIELD | BOTTOM_FIELD;
-                    cmd.DW2.Lumscale1SingleFwd = lumaScale;
-                    cmd.DW2.Lumshift1SingleFwd = lumaShift;
+                    cmd->DW2.Lumscale1SingleFwd = lumaScale;
+                    cmd->DW2.Lumshift1SingleFwd = lumaShift;
 
-                    cmd.DW2.Lumscale2SingleFwd = lumaScale;
-                    cmd.DW2.Lumshift2SingleFwd = lumaShift;
+                    cmd->DW2.Lumscale2SingleFwd = lumaScale;
+                    cmd->DW2.Lumshift2SingleFwd = lumaShift;
 
                     // Set double backward values for top and bottom out of bound pixels
                     bwdDoubleIcEnable = TOP_FIELD | BOTTOM_FIELD;
-                    cmd.DW5.Lumscale1DoubleBwd = lumaScale;
-                    cmd.DW5.Lumshift1DoubleBwd = lumaShift;
-                    cmd.DW5.Lumscale2DoubleBwd = lumaScale;
-                    cmd.DW5.Lumshift2DoubleBwd = lumaShift;
+                    cmd->DW5.Lumscale1DoubleBwd = lumaScale;
+                    cmd->DW5.Lumshift1DoubleBwd = lumaShift;
+                    cmd->DW5.Lumscale2DoubleBwd = lumaScale;
+                    cmd->DW5.Lumshift2DoubleBwd = lumaShift;
 
                     // Save IC
                     fwdRefParams->Vc1IcValues[icField].wICCScale1 =
@@ -1538,8 +1550,8 @@ protected:
                     // special case for interlaced field references when no IC is indicated
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP))
                     {
-                        cmd.DW2.Lumscale1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                        cmd.DW2.Lumshift1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                        cmd->DW2.Lumscale1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                        cmd->DW2.Lumshift1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
 
                         fwdSingleIcEnable = TOP_FIELD;
                         icField++;
@@ -1547,8 +1559,8 @@ protected:
 
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP))
                     {
-                        cmd.DW2.Lumscale2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                        cmd.DW2.Lumshift2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                        cmd->DW2.Lumscale2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                        cmd->DW2.Lumshift2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
 
                         fwdSingleIcEnable |= BOTTOM_FIELD;
                         icField++;
@@ -1562,22 +1574,22 @@ protected:
                 if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP_2))
                 {
                     fwdDoubleIcEnable = TOP_FIELD;
-                    cmd.DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                    cmd.DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                    cmd->DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                    cmd->DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
                     // IC values for the bottom out of bound pixels (replicated lines of the last 
                     // line of top field)
-                    cmd.DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                    cmd.DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                    cmd->DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                    cmd->DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
                 }
                 if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP_2))
                 {
                     fwdDoubleIcEnable |= BOTTOM_FIELD;
                     // IC values for the top out of bound pixels (replicated lines of the first 
                     // line of bottom field)
-                    cmd.DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                    cmd.DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
-                    cmd.DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                    cmd.DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                    cmd->DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                    cmd->DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                    cmd->DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                    cmd->DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
                 }
                 if (fwdDoubleIcEnable)
                 {
@@ -1587,14 +1599,14 @@ protected:
                 if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP))
                 {
                     fwdSingleIcEnable = TOP_FIELD;
-                    cmd.DW2.Lumscale1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                    cmd.DW2.Lumshift1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                    cmd->DW2.Lumscale1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                    cmd->DW2.Lumshift1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
                 }
                 if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP))
                 {
                     fwdSingleIcEnable |= BOTTOM_FIELD;
-                    cmd.DW2.Lumscale2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                    cmd.DW2.Lumshift2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                    cmd->DW2.Lumscale2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                    cmd->DW2.Lumshift2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
                 }
 
                 // If the reference picture is interlaced field, set double backward values for top
@@ -1602,10 +1614,10 @@ protected:
                 if (fwdSingleIcEnable == (TOP_FIELD | BOTTOM_FIELD))
                 {
                     bwdDoubleIcEnable = TOP_FIELD | BOTTOM_FIELD;
-                    cmd.DW5.Lumscale1DoubleBwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                    cmd.DW5.Lumshift1DoubleBwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
-                    cmd.DW5.Lumscale2DoubleBwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                    cmd.DW5.Lumshift2DoubleBwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                    cmd->DW5.Lumscale1DoubleBwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                    cmd->DW5.Lumshift1DoubleBwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                    cmd->DW5.Lumscale2DoubleBwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                    cmd->DW5.Lumshift2DoubleBwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
                 }
 
                 // Backward reference IC
@@ -1613,14 +1625,14 @@ protected:
                 if (MOS_IS_BIT_SET(bwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP))
                 {
                     bwdSingleIcEnable = TOP_FIELD;
-                    cmd.DW4.Lumscale1SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCScale1;
-                    cmd.DW4.Lumshift1SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                    cmd->DW4.Lumscale1SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCScale1;
+                    cmd->DW4.Lumshift1SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCShiftL1;
                 }
                 else if (MOS_IS_BIT_SET(bwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP))
                 {
                     bwdSingleIcEnable = BOTTOM_FIELD;
-                    cmd.DW4.Lumscale2SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCScale2;
-                    cmd.DW4.Lumshift2SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                    cmd->DW4.Lumscale2SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCScale2;
+                    cmd->DW4.Lumshift2SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCShiftL2;
                 }
             }
         }
@@ -1646,8 +1658,8 @@ protected:
                     // No IC for top field
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP))
                     {
-                        cmd.DW2.Lumscale1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                        cmd.DW2.Lumshift1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                        cmd->DW2.Lumscale1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                        cmd->DW2.Lumshift1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
                         fwdSingleIcEnable |= TOP_FIELD;
                     }
                     else
@@ -1658,14 +1670,14 @@ protected:
                 else
                 {
                     // IC for top field is enabled
-                    cmd.DW2.Lumscale1SingleFwd = lumaScale;
-                    cmd.DW2.Lumshift1SingleFwd = lumaShift;
+                    cmd->DW2.Lumscale1SingleFwd = lumaScale;
+                    cmd->DW2.Lumshift1SingleFwd = lumaShift;
 
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP))
                     {
                         fwdDoubleIcEnable = TOP_FIELD;
-                        cmd.DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                        cmd.DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                        cmd->DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                        cmd->DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
 
                         MOS_BIT_ON(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP_2);
                         icField++;
@@ -1685,15 +1697,15 @@ protected:
                         if (!CodecHal_PictureIsField((params->ppVc1RefList[vc1PicParams->ForwardRefIdx])->RefPic) &&
                             (CodecHal_PictureIsBottomField(vc1PicParams->CurrPic) && isSecondField))
                         {
-                            cmd.DW5.Lumscale1DoubleBwd =
+                            cmd->DW5.Lumscale1DoubleBwd =
                                 (params->ppVc1RefList[vc1PicParams->ForwardRefIdx])->Vc1IcValues[icField].wICCScale1;
-                            cmd.DW5.Lumshift1DoubleBwd =
+                            cmd->DW5.Lumshift1DoubleBwd =
                                 (params->ppVc1RefList[vc1PicParams->ForwardRefIdx])->Vc1IcValues[icField].wICCShiftL1;
                         }
                         else
                         {
-                            cmd.DW5.Lumscale1DoubleBwd = lumaScale;
-                            cmd.DW5.Lumshift1DoubleBwd = lumaShift;
+                            cmd->DW5.Lumscale1DoubleBwd = lumaScale;
+                            cmd->DW5.Lumshift1DoubleBwd = lumaShift;
                         }
                     }
 
@@ -1722,8 +1734,8 @@ protected:
 
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP))
                     {
-                        cmd.DW2.Lumscale2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                        cmd.DW2.Lumshift2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                        cmd->DW2.Lumscale2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                        cmd->DW2.Lumshift2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
                         fwdSingleIcEnable |= BOTTOM_FIELD;
                     }
                     else
@@ -1734,14 +1746,14 @@ protected:
                 else
                 {
                     // IC is on
-                    cmd.DW2.Lumscale2SingleFwd = lumaScale;
-                    cmd.DW2.Lumshift2SingleFwd = lumaShift;
+                    cmd->DW2.Lumscale2SingleFwd = lumaScale;
+                    cmd->DW2.Lumshift2SingleFwd = lumaShift;
 
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP))
                     {
                         fwdDoubleIcEnable |= BOTTOM_FIELD;
-                        cmd.DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                        cmd.DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                        cmd->DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                        cmd->DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
 
                         MOS_BIT_ON(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP_2);
                         icField++;
@@ -1761,15 +1773,15 @@ protected:
                         if (!CodecHal_PictureIsField((params->ppVc1RefList[vc1PicParams->ForwardRefIdx])->RefPic) &&
                             (CodecHal_PictureIsTopField(vc1PicParams->CurrPic) && isSecondField))
                         {
-                            cmd.DW5.Lumscale2DoubleBwd =
+                            cmd->DW5.Lumscale2DoubleBwd =
                                 (params->ppVc1RefList[vc1PicParams->ForwardRefIdx])->Vc1IcValues[icField].wICCScale2;
-                            cmd.DW5.Lumshift2DoubleBwd =
+                            cmd->DW5.Lumshift2DoubleBwd =
                                 (params->ppVc1RefList[vc1PicParams->ForwardRefIdx])->Vc1IcValues[icField].wICCShiftL2;
                         }
                         else
                         {
-                            cmd.DW5.Lumscale2DoubleBwd = lumaScale;
-                            cmd.DW5.Lumshift2DoubleBwd = lumaShift;
+                            cmd->DW5.Lumscale2DoubleBwd = lumaScale;
+                            cmd->DW5.Lumshift2DoubleBwd = lumaShift;
                         }
                     }
 
@@ -1785,16 +1797,16 @@ protected:
                 {
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP_2))
                     {
-                        cmd.DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                        cmd.DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                        cmd->DW3.Lumscale1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                        cmd->DW3.Lumshift1DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
                         fwdDoubleIcEnable = TOP_FIELD;
                         icField++;
                     }
 
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP))
                     {
-                        cmd.DW2.Lumscale1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
-                        cmd.DW2.Lumshift1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                        cmd->DW2.Lumscale1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale1;
+                        cmd->DW2.Lumshift1SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL1;
                         fwdSingleIcEnable = TOP_FIELD;
                     }
                 }
@@ -1804,15 +1816,15 @@ protected:
                     icField = 0;
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP_2))
                     {
-                        cmd.DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                        cmd.DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                        cmd->DW3.Lumscale2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                        cmd->DW3.Lumshift2DoubleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
                         fwdDoubleIcEnable |= BOTTOM_FIELD;
                         icField++;
                     }
                     if (MOS_IS_BIT_SET(fwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP))
                     {
-                        cmd.DW2.Lumscale2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
-                        cmd.DW2.Lumshift2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                        cmd->DW2.Lumscale2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCScale2;
+                        cmd->DW2.Lumshift2SingleFwd = fwdRefParams->Vc1IcValues[icField].wICCShiftL2;
                         fwdSingleIcEnable |= BOTTOM_FIELD;
                     }
                 }
@@ -1821,26 +1833,26 @@ protected:
                 icField = 0;
                 if (MOS_IS_BIT_SET(bwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_TOP_FIELD_COMP))
                 {
-                    cmd.DW4.Lumscale1SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCScale1;
-                    cmd.DW4.Lumshift1SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCShiftL1;
+                    cmd->DW4.Lumscale1SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCScale1;
+                    cmd->DW4.Lumshift1SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCShiftL1;
                     bwdSingleIcEnable = TOP_FIELD;
                 }
 
                 if (MOS_IS_BIT_SET(bwdRefParams->dwRefSurfaceFlags, CODECHAL_VC1_BOT_FIELD_COMP))
                 {
-                    cmd.DW4.Lumscale2SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCScale2;
-                    cmd.DW4.Lumshift2SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCShiftL2;
+                    cmd->DW4.Lumscale2SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCScale2;
+                    cmd->DW4.Lumshift2SingleBwd = bwdRefParams->Vc1IcValues[icField].wICCShiftL2;
                     bwdSingleIcEnable |= BOTTOM_FIELD;
                 }
             }
         }
 
-        cmd.DW1.VinIntensitycompDoubleFwden = fwdDoubleIcEnable;
-        cmd.DW1.VinIntensitycompDoubleBwden = bwdDoubleIcEnable;
-        cmd.DW1.VinIntensitycompSingleFwden = fwdSingleIcEnable;
-        cmd.DW1.VinIntensitycompSingleBwden = bwdSingleIcEnable;
+        cmd->DW1.VinIntensitycompDoubleFwden = fwdDoubleIcEnable;
+        cmd->DW1.VinIntensitycompDoubleBwden = bwdDoubleIcEnable;
+        cmd->DW1.VinIntensitycompSingleFwden = fwdSingleIcEnable;
+        cmd->DW1.VinIntensitycompSingleBwden = bwdSingleIcEnable;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -1895,17 +1907,18 @@ protected:
         auto destParams = vc1PicState->ppVc1RefList[vc1PicParams->CurrPic.FrameIdx];
         auto fwdRefParams = vc1PicState->ppVc1RefList[vc1PicParams->ForwardRefIdx];
 
-        typename TMfxCmds::MFD_VC1_LONG_PIC_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFD_VC1_LONG_PIC_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
-        cmd.DW1.Picturewidthinmbsminus1PictureWidthMinus1InMacroblocks = widthInMbs - 1;
-        cmd.DW1.Pictureheightinmbsminus1PictureHeightMinus1InMacroblocks = frameFieldHeightInMb - 1;
+        cmd->DW1.Picturewidthinmbsminus1PictureWidthMinus1InMacroblocks = widthInMbs - 1;
+        cmd->DW1.Pictureheightinmbsminus1PictureHeightMinus1InMacroblocks = frameFieldHeightInMb - 1;
 
-        cmd.DW2.Vc1Profile = vc1PicParams->sequence_fields.AdvancedProfileFlag;
-        cmd.DW2.Secondfield = !vc1PicParams->picture_fields.is_first_field;
-        cmd.DW2.OverlapSmoothingEnableFlag = vc1PicParams->sequence_fields.overlap;
-        cmd.DW2.LoopfilterEnableFlag = vc1PicParams->entrypoint_fields.loopfilter;
-        cmd.DW2.InterpolationRounderContro = vc1PicParams->rounding_control;
-        cmd.DW2.MotionVectorMode = (vc1PicParams->mv_fields.MvMode & 0x9);
+        cmd->DW2.Vc1Profile = vc1PicParams->sequence_fields.AdvancedProfileFlag;
+        cmd->DW2.Secondfield = !vc1PicParams->picture_fields.is_first_field;
+        cmd->DW2.OverlapSmoothingEnableFlag = vc1PicParams->sequence_fields.overlap;
+        cmd->DW2.LoopfilterEnableFlag = vc1PicParams->entrypoint_fields.loopfilter;
+        cmd->DW2.InterpolationRounderContro = vc1PicParams->rounding_control;
+        cmd->DW2.MotionVectorMode = (vc1PicParams->mv_fields.MvMode & 0x9);
 
         // Simple and Main profile dynamic range adjustment
         if ((!vc1PicParams->sequence_fields.AdvancedProfileFlag) && isPPicture)
@@ -1913,100 +1926,100 @@ protected:
             if ((destParams->dwRefSurfaceFlags & CODECHAL_WMV9_RANGE_ADJUSTMENT) &&
                 !(fwdRefParams->dwRefSurfaceFlags & CODECHAL_WMV9_RANGE_ADJUSTMENT))
             {
-                cmd.DW2.RangereductionEnable = 1;
-                cmd.DW2.Rangereductionscale = 0;
+                cmd->DW2.RangereductionEnable = 1;
+                cmd->DW2.Rangereductionscale = 0;
             }
             else if (!(destParams->dwRefSurfaceFlags & CODECHAL_WMV9_RANGE_ADJUSTMENT) &&
                 (fwdRefParams->dwRefSurfaceFlags & CODECHAL_WMV9_RANGE_ADJUSTMENT))
             {
-                cmd.DW2.RangereductionEnable = 1;
-                cmd.DW2.Rangereductionscale = 1;
+                cmd->DW2.RangereductionEnable = 1;
+                cmd->DW2.Rangereductionscale = 1;
             }
         }
 
-        cmd.DW3.PquantPictureQuantizationValue = vc1PicParams->pic_quantizer_fields.pic_quantizer_scale;
+        cmd->DW3.PquantPictureQuantizationValue = vc1PicParams->pic_quantizer_fields.pic_quantizer_scale;
 
         if (vc1PicState->Mode == CODECHAL_DECODE_MODE_VC1IT)
         {
             if (isIPicture || isBIPicture)
             {
-                cmd.DW3.PictypePictureType = vc1IFrame; // 0 = I or I/I
+                cmd->DW3.PictypePictureType = vc1IFrame; // 0 = I or I/I
             }
             else if (isPPicture)
             {
-                cmd.DW3.PictypePictureType = isFramePicture ? (uint32_t)vc1PFrame: (uint32_t)vc1PPField;
+                cmd->DW3.PictypePictureType = isFramePicture ? (uint32_t)vc1PFrame: (uint32_t)vc1PPField;
             }
             else if (isBPicture)
             {
-                cmd.DW3.PictypePictureType = isFramePicture ? (uint32_t)vc1BFrame: (uint32_t)vc1BBField;
+                cmd->DW3.PictypePictureType = isFramePicture ? (uint32_t)vc1BFrame: (uint32_t)vc1BBField;
             }
 
             if (isFramePicture)
             {
-                cmd.DW3.FcmFrameCodingMode = (vc1PicParams->CurrPic.PicFlags == PICTURE_INTERLACED_FRAME);
+                cmd->DW3.FcmFrameCodingMode = (vc1PicParams->CurrPic.PicFlags == PICTURE_INTERLACED_FRAME);
             }
             else
             {
-                cmd.DW3.FcmFrameCodingMode = (vc1PicParams->picture_fields.top_field_first) ? vc1TffFrame : vc1BffFrame;
+                cmd->DW3.FcmFrameCodingMode = (vc1PicParams->picture_fields.top_field_first) ? vc1TffFrame : vc1BffFrame;
             }
 
-            cmd.DW4.FastuvmcflagFastUvMotionCompensationFlag = (vc1PicParams->mv_fields.MvMode & 0x1);
-            cmd.DW4.Pquantuniform = 1; // uniform
-            cmd.DW2.Implicitquantizer = 1; // implicit
+            cmd->DW4.FastuvmcflagFastUvMotionCompensationFlag = (vc1PicParams->mv_fields.MvMode & 0x1);
+            cmd->DW4.Pquantuniform = 1; // uniform
+            cmd->DW2.Implicitquantizer = 1; // implicit
         }
         else // CODECHAL_DECODE_MODE_VC1VLD
         {
-            cmd.DW2.Syncmarker = vc1PicParams->sequence_fields.syncmarker;
-            cmd.DW2.Implicitquantizer = (vc1PicParams->pic_quantizer_fields.quantizer == vc1QuantizerImplicit);
+            cmd->DW2.Syncmarker = vc1PicParams->sequence_fields.syncmarker;
+            cmd->DW2.Implicitquantizer = (vc1PicParams->pic_quantizer_fields.quantizer == vc1QuantizerImplicit);
             if (isBPicture &&
                 (CodecHal_PictureIsBottomField(vc1PicParams->CurrPic) ?
                     vc1PicState->bPrevOddAnchorPictureIsP : vc1PicState->bPrevEvenAnchorPictureIsP)) // OR if I not before B in decoding order
             {
-                cmd.DW2.Dmvsurfacevalid = true;
+                cmd->DW2.Dmvsurfacevalid = true;
             }
 
             if (vc1PicParams->raw_coding.bitplane_present)
             {
-                cmd.DW2.BitplaneBufferPitchMinus1 = (widthInMbs - 1) >> 1;
+                cmd->DW2.BitplaneBufferPitchMinus1 = (widthInMbs - 1) >> 1;
             }
 
-            cmd.DW3.Bscalefactor = vc1PicParams->ScaleFactor;
-            cmd.DW3.AltpquantAlternativePictureQuantizationValue = vc1PicParams->pic_quantizer_fields.alt_pic_quantizer;
-            cmd.DW3.FcmFrameCodingMode = vc1PicParams->picture_fields.frame_coding_mode;
-            cmd.DW3.PictypePictureType = vc1PicParams->picture_fields.picture_type;
-            cmd.DW3.Condover = vc1PicParams->conditional_overlap_flag;
+            cmd->DW3.Bscalefactor = vc1PicParams->ScaleFactor;
+            cmd->DW3.AltpquantAlternativePictureQuantizationValue = vc1PicParams->pic_quantizer_fields.alt_pic_quantizer;
+            cmd->DW3.FcmFrameCodingMode = vc1PicParams->picture_fields.frame_coding_mode;
+            cmd->DW3.PictypePictureType = vc1PicParams->picture_fields.picture_type;
+            cmd->DW3.Condover = vc1PicParams->conditional_overlap_flag;
 
-            cmd.DW4.Pquantuniform = vc1PicParams->pic_quantizer_fields.pic_quantizer_type;
-            cmd.DW4.Halfqp = vc1PicParams->pic_quantizer_fields.half_qp;
-            cmd.DW4.AltpquantconfigAlternativePictureQuantizationConfiguration = vc1PicParams->pic_quantizer_fields.AltPQuantConfig;
-            cmd.DW4.AltpquantedgemaskAlternativePictureQuantizationEdgeMask = vc1PicParams->pic_quantizer_fields.AltPQuantEdgeMask;
+            cmd->DW4.Pquantuniform = vc1PicParams->pic_quantizer_fields.pic_quantizer_type;
+            cmd->DW4.Halfqp = vc1PicParams->pic_quantizer_fields.half_qp;
+            cmd->DW4.AltpquantconfigAlternativePictureQuantizationConfiguration = vc1PicParams->pic_quantizer_fields.AltPQuantConfig;
+            cmd->DW4.AltpquantedgemaskAlternativePictureQuantizationEdgeMask = vc1PicParams->pic_quantizer_fields.AltPQuantEdgeMask;
 
             // AltPQuant parameters must be set to 0 for I or BI pictures in simple/main profile
             if (!vc1PicParams->sequence_fields.AdvancedProfileFlag && (isIPicture || isBIPicture))
             {
-                cmd.DW4.AltpquantconfigAlternativePictureQuantizationConfiguration = 0;
-                cmd.DW4.AltpquantedgemaskAlternativePictureQuantizationEdgeMask = 0;
-                cmd.DW3.AltpquantAlternativePictureQuantizationValue = 0;
+                cmd->DW4.AltpquantconfigAlternativePictureQuantizationConfiguration = 0;
+                cmd->DW4.AltpquantedgemaskAlternativePictureQuantizationEdgeMask = 0;
+                cmd->DW3.AltpquantAlternativePictureQuantizationValue = 0;
             }
 
-            cmd.DW4.ExtendedmvrangeExtendedMotionVectorRangeFlag = vc1PicParams->mv_fields.extended_mv_range;
-            cmd.DW4.ExtendeddmvrangeExtendedDifferentialMotionVectorRangeFlag = vc1PicParams->mv_fields.extended_dmv_range;
-            cmd.DW4.FwdrefdistReferenceDistance = vc1PicParams->reference_fields.reference_distance;
-            cmd.DW4.BwdrefdistReferenceDistance = vc1PicParams->reference_fields.BwdReferenceDistance;
+            cmd->DW4.ExtendedmvrangeExtendedMotionVectorRangeFlag = vc1PicParams->mv_fields.extended_mv_range;
+            cmd->DW4.ExtendeddmvrangeExtendedDifferentialMotionVectorRangeFlag = vc1PicParams->mv_fields.extended_dmv_range;
+            cmd->DW4.FwdrefdistReferenceDistance = vc1PicParams->reference_fields.reference_distance;
+            cmd->DW4.BwdrefdistReferenceDistance = vc1PicParams->reference_fields.BwdReferenceDistance;
 
             if (!isFramePicture && isBPicture)
             {
                 // For B field pictures, NumberOfReferencePictures is always 2 (i.e. set to 1).
-                cmd.DW4.NumrefNumberOfReferences = 1;
+                cmd->DW4.NumrefNumberOfReferences = 1;
             }
             else
             {
-                cmd.DW4.NumrefNumberOfReferences = vc1PicParams->reference_fields.num_reference_pictures;
+                cmd->DW4.NumrefNumberOfReferences = vc1PicParams->reference_fields.num_reference_pictures;
             }
 
             if (isPPicture &&
                 CodecHal_PictureIsField(vc1PicParams->CurrPic) &&
-                (cmd.DW4.NumrefNumberOfReferences == 0))
+                (cmd->DW4.NumrefNumberOfReferences == 0))
             {
                 // Derive polarity of the reference field: Top = 0, Bottom = 1
                 if (vc1PicParams->reference_fields.reference_field_pic_indicator == 0)
@@ -2015,12 +2028,12 @@ protected:
                     if (vc1PicParams->picture_fields.is_first_field)
                     {
                         // Reference frame
-                        cmd.DW4.ReffieldpicpolarityReferenceFieldPicturePolarity = vc1PicState->wPrevAnchorPictureTFF;
+                        cmd->DW4.ReffieldpicpolarityReferenceFieldPicturePolarity = vc1PicState->wPrevAnchorPictureTFF;
                     }
                     else
                     {
                         // Same frame
-                        cmd.DW4.ReffieldpicpolarityReferenceFieldPicturePolarity = !vc1PicParams->picture_fields.top_field_first;
+                        cmd->DW4.ReffieldpicpolarityReferenceFieldPicturePolarity = !vc1PicParams->picture_fields.top_field_first;
                     }
                 }
                 else
@@ -2029,70 +2042,70 @@ protected:
                     if (vc1PicParams->picture_fields.is_first_field)
                     {
                         // First field of reference frame
-                        cmd.DW4.ReffieldpicpolarityReferenceFieldPicturePolarity = !vc1PicState->wPrevAnchorPictureTFF;
+                        cmd->DW4.ReffieldpicpolarityReferenceFieldPicturePolarity = !vc1PicState->wPrevAnchorPictureTFF;
                     }
                     else
                     {
                         // Second field of reference frame
-                        cmd.DW4.ReffieldpicpolarityReferenceFieldPicturePolarity = vc1PicState->wPrevAnchorPictureTFF;
+                        cmd->DW4.ReffieldpicpolarityReferenceFieldPicturePolarity = vc1PicState->wPrevAnchorPictureTFF;
                     }
                 }
             }
 
-            cmd.DW4.FastuvmcflagFastUvMotionCompensationFlag = vc1PicParams->fast_uvmc_flag;
-            cmd.DW4.FourmvswitchFourMotionVectorSwitch = vc1PicParams->mv_fields.four_mv_switch;
-            cmd.DW4.UnifiedmvmodeUnifiedMotionVectorMode = vc1PicParams->mv_fields.UnifiedMvMode;
+            cmd->DW4.FastuvmcflagFastUvMotionCompensationFlag = vc1PicParams->fast_uvmc_flag;
+            cmd->DW4.FourmvswitchFourMotionVectorSwitch = vc1PicParams->mv_fields.four_mv_switch;
+            cmd->DW4.UnifiedmvmodeUnifiedMotionVectorMode = vc1PicParams->mv_fields.UnifiedMvMode;
 
             // If bitplane is present (BitplanePresentFlag == 1) update the "raw" bitplane
             // flags. If bitplane is not present leave all "raw" flags to their initialized
             // value which is all bitplanes are present "raw".
-            cmd.DW5.BitplanepresentflagBitplaneBufferPresentFlag = vc1PicParams->raw_coding.bitplane_present;
+            cmd->DW5.BitplanepresentflagBitplaneBufferPresentFlag = vc1PicParams->raw_coding.bitplane_present;
 
-            cmd.DW5.Fieldtxraw = vc1RawMode;
-            cmd.DW5.Acpredraw = vc1RawMode;
-            cmd.DW5.Overflagsraw = vc1RawMode;
-            cmd.DW5.Directmbraw = vc1RawMode;
-            cmd.DW5.Skipmbraw = vc1RawMode;
-            cmd.DW5.Mvtypembraw = vc1RawMode;
-            cmd.DW5.Forwardmbraw = vc1RawMode;
+            cmd->DW5.Fieldtxraw = vc1RawMode;
+            cmd->DW5.Acpredraw = vc1RawMode;
+            cmd->DW5.Overflagsraw = vc1RawMode;
+            cmd->DW5.Directmbraw = vc1RawMode;
+            cmd->DW5.Skipmbraw = vc1RawMode;
+            cmd->DW5.Mvtypembraw = vc1RawMode;
+            cmd->DW5.Forwardmbraw = vc1RawMode;
 
             if (vc1PicParams->raw_coding.bitplane_present)
             {
-                cmd.DW5.Fieldtxraw = vc1PicParams->raw_coding.field_tx;
-                cmd.DW5.Acpredraw = vc1PicParams->raw_coding.ac_pred;
-                cmd.DW5.Overflagsraw = vc1PicParams->raw_coding.overflags;
-                cmd.DW5.Directmbraw = vc1PicParams->raw_coding.direct_mb;
-                cmd.DW5.Skipmbraw = vc1PicParams->raw_coding.skip_mb;
-                cmd.DW5.Mvtypembraw = vc1PicParams->raw_coding.mv_type_mb;
-                cmd.DW5.Forwardmbraw = vc1PicParams->raw_coding.forward_mb;
+                cmd->DW5.Fieldtxraw = vc1PicParams->raw_coding.field_tx;
+                cmd->DW5.Acpredraw = vc1PicParams->raw_coding.ac_pred;
+                cmd->DW5.Overflagsraw = vc1PicParams->raw_coding.overflags;
+                cmd->DW5.Directmbraw = vc1PicParams->raw_coding.direct_mb;
+                cmd->DW5.Skipmbraw = vc1PicParams->raw_coding.skip_mb;
+                cmd->DW5.Mvtypembraw = vc1PicParams->raw_coding.mv_type_mb;
+                cmd->DW5.Forwardmbraw = vc1PicParams->raw_coding.forward_mb;
             }
 
-            cmd.DW5.CbptabCodedBlockPatternTable = vc1PicParams->cbp_table;
-            cmd.DW5.TransdctabIntraTransformDcTable = vc1PicParams->transform_fields.intra_transform_dc_table;
-            cmd.DW5.TransacuvPictureLevelTransformChromaAcCodingSetIndexTransactable = vc1PicParams->transform_fields.transform_ac_codingset_idx1;
-            cmd.DW5.TransacyPictureLevelTransformLumaAcCodingSetIndexTransactable2 = (isIPicture || isBIPicture) ?
-                vc1PicParams->transform_fields.transform_ac_codingset_idx2 : cmd.DW5.TransacuvPictureLevelTransformChromaAcCodingSetIndexTransactable;
-            cmd.DW5.MbmodetabMacroblockModeTable = vc1PicParams->mb_mode_table;
+            cmd->DW5.CbptabCodedBlockPatternTable = vc1PicParams->cbp_table;
+            cmd->DW5.TransdctabIntraTransformDcTable = vc1PicParams->transform_fields.intra_transform_dc_table;
+            cmd->DW5.TransacuvPictureLevelTransformChromaAcCodingSetIndexTransactable = vc1PicParams->transform_fields.transform_ac_codingset_idx1;
+            cmd->DW5.TransacyPictureLevelTransformLumaAcCodingSetIndexTransactable2 = (isIPicture || isBIPicture) ?
+                vc1PicParams->transform_fields.transform_ac_codingset_idx2 : cmd->DW5.TransacuvPictureLevelTransformChromaAcCodingSetIndexTransactable;
+            cmd->DW5.MbmodetabMacroblockModeTable = vc1PicParams->mb_mode_table;
 
             if (vc1PicParams->transform_fields.variable_sized_transform_flag == 0)
             {
                 // H/W decodes TTMB, TTBLK and SUBBLKPAT if the picture level TTMBF flag is not set.
                 // If the VSTRANSFORM is 0, 8x8 TransformType is used for all the pictures belonging to this Entry-Point.
                 // Hence H/W overloads the TTMBF = 1 and TTFRM = 8x8 in this case.
-                cmd.DW5.TranstypembflagMacroblockTransformTypeFlag = 1;
-                cmd.DW5.TranstypePictureLevelTransformType = 0;
+                cmd->DW5.TranstypembflagMacroblockTransformTypeFlag = 1;
+                cmd->DW5.TranstypePictureLevelTransformType = 0;
             }
             else
             {
-                cmd.DW5.TranstypembflagMacroblockTransformTypeFlag = vc1PicParams->transform_fields.mb_level_transform_type_flag;
-                cmd.DW5.TranstypePictureLevelTransformType = vc1PicParams->transform_fields.frame_level_transform_type;
+                cmd->DW5.TranstypembflagMacroblockTransformTypeFlag = vc1PicParams->transform_fields.mb_level_transform_type_flag;
+                cmd->DW5.TranstypePictureLevelTransformType = vc1PicParams->transform_fields.frame_level_transform_type;
             }
-            cmd.DW5.Twomvbptab2MvBlockPatternTable = vc1PicParams->mv_fields.two_mv_block_pattern_table;
-            cmd.DW5.Fourmvbptab4MvBlockPatternTable = vc1PicParams->mv_fields.four_mv_block_pattern_table;
-            cmd.DW5.MvtabMotionVectorTable = vc1PicParams->mv_fields.mv_table;
+            cmd->DW5.Twomvbptab2MvBlockPatternTable = vc1PicParams->mv_fields.two_mv_block_pattern_table;
+            cmd->DW5.Fourmvbptab4MvBlockPatternTable = vc1PicParams->mv_fields.four_mv_block_pattern_table;
+            cmd->DW5.MvtabMotionVectorTable = vc1PicParams->mv_fields.mv_table;
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -2140,87 +2153,88 @@ protected:
             vc1PicParams->picture_fields.is_first_field,
             vc1PicParams->picture_fields.picture_type);
 
-        typename TMfxCmds::MFD_VC1_SHORT_PIC_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFD_VC1_SHORT_PIC_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         // DW 1
-        cmd.DW1.PictureWidth = widthInMbs - 1;
-        cmd.DW1.PictureHeight = frameFieldHeightInMb - 1;
+        cmd->DW1.PictureWidth = widthInMbs - 1;
+        cmd->DW1.PictureHeight = frameFieldHeightInMb - 1;
 
         // DW 2
-        cmd.DW2.PictureStructure =
+        cmd->DW2.PictureStructure =
             (CodecHal_PictureIsTopField(vc1PicParams->CurrPic)) ?
             mpeg2Vc1TopField : (CodecHal_PictureIsBottomField(vc1PicParams->CurrPic)) ?
             mpeg2Vc1BottomField : mpeg2Vc1Frame;
-        cmd.DW2.Secondfield = !vc1PicParams->picture_fields.is_first_field;
-        cmd.DW2.IntraPictureFlag = isIPicture || isBIPicture;
-        cmd.DW2.BackwardPredictionPresentFlag = isBPicture;
+        cmd->DW2.Secondfield = !vc1PicParams->picture_fields.is_first_field;
+        cmd->DW2.IntraPictureFlag = isIPicture || isBIPicture;
+        cmd->DW2.BackwardPredictionPresentFlag = isBPicture;
 
-        cmd.DW2.Vc1Profile = vc1PicParams->sequence_fields.AdvancedProfileFlag;
+        cmd->DW2.Vc1Profile = vc1PicParams->sequence_fields.AdvancedProfileFlag;
         if (isBPicture &&
             (CodecHal_PictureIsBottomField(vc1PicParams->CurrPic) ?
                 vc1PicState->bPrevOddAnchorPictureIsP : vc1PicState->bPrevEvenAnchorPictureIsP)) // OR if I not before B in decoding order
         {
-            cmd.DW2.Dmvsurfacevalid = true;
+            cmd->DW2.Dmvsurfacevalid = true;
         }
 
-        cmd.DW2.MotionVectorMode = vc1PicParams->mv_fields.MvMode & 0x9;
-        cmd.DW2.InterpolationRounderControl = vc1PicParams->rounding_control;
-        cmd.DW2.BitplaneBufferPitchMinus1 = (vc1PicParams->coded_width <= 2048) ?
+        cmd->DW2.MotionVectorMode = vc1PicParams->mv_fields.MvMode & 0x9;
+        cmd->DW2.InterpolationRounderControl = vc1PicParams->rounding_control;
+        cmd->DW2.BitplaneBufferPitchMinus1 = (vc1PicParams->coded_width <= 2048) ?
             (MHW_VDBOX_VC1_BITPLANE_BUFFER_PITCH_SMALL - 1) : (MHW_VDBOX_VC1_BITPLANE_BUFFER_PITCH_LARGE - 1);
 
         // DW 3
-        cmd.DW3.VstransformFlag = vc1PicParams->transform_fields.variable_sized_transform_flag;
-        cmd.DW3.Dquant = vc1PicParams->pic_quantizer_fields.dquant;
-        cmd.DW3.ExtendedMvPresentFlag = vc1PicParams->mv_fields.extended_mv_flag;
-        cmd.DW3.FastuvmcflagFastUvMotionCompensationFlag = vc1PicParams->fast_uvmc_flag;
-        cmd.DW3.LoopfilterEnableFlag = vc1PicParams->entrypoint_fields.loopfilter;
-        cmd.DW3.RefdistFlag = (vc1PicParams->sequence_fields.AdvancedProfileFlag) ?
+        cmd->DW3.VstransformFlag = vc1PicParams->transform_fields.variable_sized_transform_flag;
+        cmd->DW3.Dquant = vc1PicParams->pic_quantizer_fields.dquant;
+        cmd->DW3.ExtendedMvPresentFlag = vc1PicParams->mv_fields.extended_mv_flag;
+        cmd->DW3.FastuvmcflagFastUvMotionCompensationFlag = vc1PicParams->fast_uvmc_flag;
+        cmd->DW3.LoopfilterEnableFlag = vc1PicParams->entrypoint_fields.loopfilter;
+        cmd->DW3.RefdistFlag = (vc1PicParams->sequence_fields.AdvancedProfileFlag) ?
             vc1PicParams->reference_fields.reference_distance_flag : 1;
-        cmd.DW3.PanscanPresentFlag = vc1PicParams->entrypoint_fields.panscan_flag;
+        cmd->DW3.PanscanPresentFlag = vc1PicParams->entrypoint_fields.panscan_flag;
 
-        cmd.DW3.Maxbframes = vc1PicParams->sequence_fields.max_b_frames;
-        cmd.DW3.RangeredPresentFlagForSimpleMainProfileOnly = vc1PicParams->sequence_fields.rangered;
-        cmd.DW3.SyncmarkerPresentFlagForSimpleMainProfileOnly = vc1PicParams->sequence_fields.syncmarker;
-        cmd.DW3.MultiresPresentFlagForSimpleMainProfileOnly = vc1PicParams->sequence_fields.multires;
-        cmd.DW3.Quantizer = vc1PicParams->pic_quantizer_fields.quantizer;
-        cmd.DW3.PPicRefDistance = vc1PicParams->reference_fields.reference_distance;
+        cmd->DW3.Maxbframes = vc1PicParams->sequence_fields.max_b_frames;
+        cmd->DW3.RangeredPresentFlagForSimpleMainProfileOnly = vc1PicParams->sequence_fields.rangered;
+        cmd->DW3.SyncmarkerPresentFlagForSimpleMainProfileOnly = vc1PicParams->sequence_fields.syncmarker;
+        cmd->DW3.MultiresPresentFlagForSimpleMainProfileOnly = vc1PicParams->sequence_fields.multires;
+        cmd->DW3.Quantizer = vc1PicParams->pic_quantizer_fields.quantizer;
+        cmd->DW3.PPicRefDistance = vc1PicParams->reference_fields.reference_distance;
 
-        cmd.DW3.ProgressivePicType = (CodecHal_PictureIsFrame(vc1PicParams->CurrPic)) ? 1 : 2;
+        cmd->DW3.ProgressivePicType = (CodecHal_PictureIsFrame(vc1PicParams->CurrPic)) ? 1 : 2;
         // Dynamic range adjustment disabled
-        cmd.DW3.RangeReductionEnable = 0;
-        cmd.DW3.RangeReductionScale = 1;
+        cmd->DW3.RangeReductionEnable = 0;
+        cmd->DW3.RangeReductionScale = 1;
         if (vc1PicParams->sequence_fields.AdvancedProfileFlag)
         {
-            cmd.DW3.OverlapSmoothingEnableFlag = vc1PicParams->sequence_fields.overlap;
+            cmd->DW3.OverlapSmoothingEnableFlag = vc1PicParams->sequence_fields.overlap;
         }
         else
         {
-            cmd.DW3.OverlapSmoothingEnableFlag = 1;
+            cmd->DW3.OverlapSmoothingEnableFlag = 1;
             if (isBPicture || (vc1PicParams->pic_quantizer_fields.pic_quantizer_scale < 9) || !vc1PicParams->sequence_fields.overlap)
             {
-                cmd.DW3.OverlapSmoothingEnableFlag = 0;
+                cmd->DW3.OverlapSmoothingEnableFlag = 0;
             }
         }
 
         // DW 4
-        cmd.DW4.ExtendedDmvPresentFlag = vc1PicParams->mv_fields.extended_dmv_flag;
-        cmd.DW4.Psf = vc1PicParams->sequence_fields.psf;
-        cmd.DW4.Finterflag = vc1PicParams->sequence_fields.finterpflag;
-        cmd.DW4.Tfcntrflag = vc1PicParams->sequence_fields.tfcntrflag;
-        cmd.DW4.Interlace = vc1PicParams->sequence_fields.interlace;
-        cmd.DW4.Pulldown = vc1PicParams->sequence_fields.pulldown;
-        cmd.DW4.PostprocFlag = vc1PicParams->post_processing;
+        cmd->DW4.ExtendedDmvPresentFlag = vc1PicParams->mv_fields.extended_dmv_flag;
+        cmd->DW4.Psf = vc1PicParams->sequence_fields.psf;
+        cmd->DW4.Finterflag = vc1PicParams->sequence_fields.finterpflag;
+        cmd->DW4.Tfcntrflag = vc1PicParams->sequence_fields.tfcntrflag;
+        cmd->DW4.Interlace = vc1PicParams->sequence_fields.interlace;
+        cmd->DW4.Pulldown = vc1PicParams->sequence_fields.pulldown;
+        cmd->DW4.PostprocFlag = vc1PicParams->post_processing;
         if (isPPicture || (isBPicture && vc1PicParams->sequence_fields.interlace))
         {
-            cmd.DW4._4MvAllowedFlag = vc1PicParams->mv_fields.four_mv_allowed;
+            cmd->DW4._4MvAllowedFlag = vc1PicParams->mv_fields.four_mv_allowed;
         }
-        cmd.DW4.RefpicFlag = vc1PicParams->reference_fields.reference_picture_flag;
+        cmd->DW4.RefpicFlag = vc1PicParams->reference_fields.reference_picture_flag;
         if (isBPicture)
         {
-            cmd.DW4.BfractionEnumeration = vc1PicParams->b_picture_fraction;
+            cmd->DW4.BfractionEnumeration = vc1PicParams->b_picture_fraction;
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -2236,19 +2250,20 @@ protected:
         MHW_MI_CHK_NULL(cmdBuffer);
         MHW_MI_CHK_NULL(params);
  
-        typename TMfxCmds::MFX_VC1_DIRECTMODE_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFX_VC1_DIRECTMODE_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
 
         MHW_RESOURCE_PARAMS resourceParams;
         MOS_ZeroMemory(&resourceParams, sizeof(resourceParams));
         resourceParams.dwLsbNum = MHW_VDBOX_MFX_GENERAL_STATE_SHIFT;
         resourceParams.HwCommandType = MOS_MFX_VC1_DIRECT_MODE;
 
-        cmd.DW3.MemoryObjectControlState =
+        cmd->DW3.MemoryObjectControlState =
             m_cacheabilitySettings[MOS_CODEC_RESOURCE_USAGE_DIRECTMV_BUFFER_CODEC].Value;
 
         resourceParams.presResource = params->presDmvWriteBuffer;
         resourceParams.dwOffset = 0;
-        resourceParams.pdwCmd = &(cmd.DW1.Value);
+        resourceParams.pdwCmd = &(cmd->DW1.Value);
         resourceParams.dwLocationInCmd = 1;
         resourceParams.bIsWritable = true;
 
@@ -2257,12 +2272,12 @@ protected:
             cmdBuffer,
             &resourceParams));
 
-        cmd.DW6.MemoryObjectControlState =
+        cmd->DW6.MemoryObjectControlState =
             m_cacheabilitySettings[MOS_CODEC_RESOURCE_USAGE_DIRECTMV_BUFFER_CODEC].Value;
 
         resourceParams.presResource = params->presDmvReadBuffer;
         resourceParams.dwOffset = 0;
-        resourceParams.pdwCmd = &(cmd.DW4.Value);
+        resourceParams.pdwCmd = &(cmd->DW4.Value);
         resourceParams.dwLocationInCmd = 4;
         resourceParams.bIsWritable = false;
 
@@ -2271,7 +2286,7 @@ protected:
             cmdBuffer,
             &resourceParams));
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -2288,22 +2303,23 @@ protected:
         MHW_MI_CHK_NULL(vc1SliceState);
         MHW_MI_CHK_NULL(vc1SliceState->pSlc);
      
-        typename TMfxCmds::MFD_VC1_BSD_OBJECT_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFD_VC1_BSD_OBJECT_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         auto slcParams = vc1SliceState->pSlc;
 
-        cmd.DW1.IndirectBsdDataLength = vc1SliceState->dwLength;
+        cmd->DW1.IndirectBsdDataLength = vc1SliceState->dwLength;
 
-        cmd.DW2.IndirectDataStartAddress = slcParams->slice_data_offset + vc1SliceState->dwOffset; // byte aligned
+        cmd->DW2.IndirectDataStartAddress = slcParams->slice_data_offset + vc1SliceState->dwOffset; // byte aligned
 
-        cmd.DW3.SliceStartVerticalPosition = slcParams->slice_vertical_position;
-        cmd.DW3.NextSliceVerticalPosition = vc1SliceState->dwNextVerticalPosition;
+        cmd->DW3.SliceStartVerticalPosition = slcParams->slice_vertical_position;
+        cmd->DW3.NextSliceVerticalPosition = vc1SliceState->dwNextVerticalPosition;
 
-        cmd.DW4.FirstMbByteOffsetOfSliceDataOrSliceHeader = (slcParams->macroblock_offset >> 3) - vc1SliceState->dwOffset;
-        cmd.DW4.FirstmbbitoffsetFirstMacroblockBitOffset = slcParams->macroblock_offset & 0x7; // bit offset
+        cmd->DW4.FirstMbByteOffsetOfSliceDataOrSliceHeader = (slcParams->macroblock_offset >> 3) - vc1SliceState->dwOffset;
+        cmd->DW4.FirstmbbitoffsetFirstMacroblockBitOffset = slcParams->macroblock_offset & 0x7; // bit offset
 
         MHW_CP_SLICE_INFO_PARAMS sliceInfoParam;
         sliceInfoParam.presDataBuffer = vc1SliceState->presDataBuffer;
-        sliceInfoParam.dwDataStartOffset[0] = cmd.DW2.IndirectDataStartAddress;
+        sliceInfoParam.dwDataStartOffset[0] = cmd->DW2.IndirectDataStartAddress;
 
         m_cpInterface->SetMfxProtectionState(
             m_decodeInUse,
@@ -2311,7 +2327,7 @@ protected:
             nullptr,
             &sliceInfoParam);
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -2697,18 +2713,19 @@ protected:
         MHW_MI_CHK_NULL(cmdBuffer);
         MHW_MI_CHK_NULL(params);
 
-        typename TMfxCmds::MFX_JPEG_HUFF_TABLE_STATE_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFX_JPEG_HUFF_TABLE_STATE_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
        
-        cmd.DW1.Hufftableid1Bit = params->HuffTableID;
+        cmd->DW1.Hufftableid1Bit = params->HuffTableID;
 
-        MOS_SecureMemcpy(cmd.DcBits128BitArray, sizeof(cmd.DcBits128BitArray), params->pDCBits, sizeof(cmd.DcBits128BitArray));
-        MOS_SecureMemcpy(cmd.DcHuffval128BitArray, sizeof(cmd.DcHuffval128BitArray), params->pDCValues, sizeof(cmd.DcHuffval128BitArray));
-        MOS_SecureMemcpy(cmd.AcBits168BitArray, sizeof(cmd.AcBits168BitArray), params->pACBits, sizeof(cmd.AcBits168BitArray));
-        MOS_SecureMemcpy(cmd.AcHuffval1608BitArray, sizeof(cmd.AcHuffval1608BitArray), params->pACValues, sizeof(cmd.AcHuffval1608BitArray));
+        MOS_SecureMemcpy(cmd->DcBits128BitArray, sizeof(cmd->DcBits128BitArray), params->pDCBits, sizeof(cmd->DcBits128BitArray));
+        MOS_SecureMemcpy(cmd->DcHuffval128BitArray, sizeof(cmd->DcHuffval128BitArray), params->pDCValues, sizeof(cmd->DcHuffval128BitArray));
+        MOS_SecureMemcpy(cmd->AcBits168BitArray, sizeof(cmd->AcBits168BitArray), params->pACBits, sizeof(cmd->AcBits168BitArray));
+        MOS_SecureMemcpy(cmd->AcHuffval1608BitArray, sizeof(cmd->AcHuffval1608BitArray), params->pACValues, sizeof(cmd->AcHuffval1608BitArray));
 
-        MOS_SecureMemcpy(&cmd.DW52.Value, sizeof(uint16_t), (uint8_t*)params->pACValues + sizeof(cmd.AcHuffval1608BitArray), sizeof(uint16_t));
+        MOS_SecureMemcpy(&cmd->DW52.Value, sizeof(uint16_t), (uint8_t*)params->pACValues + sizeof(cmd->AcHuffval1608BitArray), sizeof(uint16_t));
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -2724,18 +2741,19 @@ protected:
         MHW_MI_CHK_NULL(cmdBuffer);
         MHW_MI_CHK_NULL(params);
 
-        typename TMfxCmds::MFD_JPEG_BSD_OBJECT_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFD_JPEG_BSD_OBJECT_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
     
-        cmd.DW1.IndirectDataLength = params->dwIndirectDataLength;
-        cmd.DW2.IndirectDataStartAddress = params->dwDataStartAddress;
-        cmd.DW3.ScanVerticalPosition = params->dwScanVerticalPosition;
-        cmd.DW3.ScanHorizontalPosition = params->dwScanHorizontalPosition;
-        cmd.DW4.McuCount = params->dwMCUCount;
-        cmd.DW4.ScanComponents = params->sScanComponent;
-        cmd.DW4.Interleaved = params->bInterleaved;
-        cmd.DW5.Restartinterval16Bit = params->dwRestartInterval;
+        cmd->DW1.IndirectDataLength = params->dwIndirectDataLength;
+        cmd->DW2.IndirectDataStartAddress = params->dwDataStartAddress;
+        cmd->DW3.ScanVerticalPosition = params->dwScanVerticalPosition;
+        cmd->DW3.ScanHorizontalPosition = params->dwScanHorizontalPosition;
+        cmd->DW4.McuCount = params->dwMCUCount;
+        cmd->DW4.ScanComponents = params->sScanComponent;
+        cmd->DW4.Interleaved = params->bInterleaved;
+        cmd->DW5.Restartinterval16Bit = params->dwRestartInterval;
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
@@ -2751,75 +2769,76 @@ protected:
         MHW_MI_CHK_NULL(cmdBuffer);
         MHW_MI_CHK_NULL(params);
 
-        typename TMfxCmds::MFD_VP8_BSD_OBJECT_CMD cmd;
+        auto cmd = Mhw_EmplaceCommand<typename TMfxCmds::MFD_VP8_BSD_OBJECT_CMD>(cmdBuffer);
+        MHW_MI_CHK_NULL(cmd);
         auto vp8PicParams = params->pVp8PicParams;
 
         uint8_t numPartitions = (1 << vp8PicParams->CodedCoeffTokenPartition);
 
-        cmd.DW1.CodedNumOfCoeffTokenPartitions = vp8PicParams->CodedCoeffTokenPartition;
-        cmd.DW1.Partition0CpbacEntropyRange = vp8PicParams->uiP0EntropyRange;
-        cmd.DW1.Partition0CpbacEntropyCount = vp8PicParams->ucP0EntropyCount;
-        cmd.DW2.Partition0CpbacEntropyValue = vp8PicParams->ucP0EntropyValue;
+        cmd->DW1.CodedNumOfCoeffTokenPartitions = vp8PicParams->CodedCoeffTokenPartition;
+        cmd->DW1.Partition0CpbacEntropyRange = vp8PicParams->uiP0EntropyRange;
+        cmd->DW1.Partition0CpbacEntropyCount = vp8PicParams->ucP0EntropyCount;
+        cmd->DW2.Partition0CpbacEntropyValue = vp8PicParams->ucP0EntropyValue;
 
-        cmd.DW3.IndirectPartition0DataLength = vp8PicParams->uiPartitionSize[0];
-        cmd.DW4.IndirectPartition0DataStartOffset = vp8PicParams->uiFirstMbByteOffset;
+        cmd->DW3.IndirectPartition0DataLength = vp8PicParams->uiPartitionSize[0];
+        cmd->DW4.IndirectPartition0DataStartOffset = vp8PicParams->uiFirstMbByteOffset;
 
-        cmd.DW5.IndirectPartition1DataLength = vp8PicParams->uiPartitionSize[1];
-        cmd.DW6.IndirectPartition1DataStartOffset = cmd.DW4.IndirectPartition0DataStartOffset +
-            cmd.DW3.IndirectPartition0DataLength +
+        cmd->DW5.IndirectPartition1DataLength = vp8PicParams->uiPartitionSize[1];
+        cmd->DW6.IndirectPartition1DataStartOffset = cmd->DW4.IndirectPartition0DataStartOffset +
+            cmd->DW3.IndirectPartition0DataLength +
             (numPartitions - 1) * 3;      // Account for P Sizes: 3 bytes per partition
                                             // excluding partition 0 and last partition.
 
         int32_t i = 2;
         if (i < ((1 + numPartitions)))
         {
-            cmd.DW7.IndirectPartition2DataLength = vp8PicParams->uiPartitionSize[i];
-            cmd.DW8.IndirectPartition2DataStartOffset = cmd.DW6.IndirectPartition1DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
+            cmd->DW7.IndirectPartition2DataLength = vp8PicParams->uiPartitionSize[i];
+            cmd->DW8.IndirectPartition2DataStartOffset = cmd->DW6.IndirectPartition1DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
         }
 
         i = 3;
         if (i < ((1 + numPartitions)))
         {
-            cmd.DW9.IndirectPartition3DataLength = vp8PicParams->uiPartitionSize[i];
-            cmd.DW10.IndirectPartition3DataStartOffset = cmd.DW8.IndirectPartition2DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
+            cmd->DW9.IndirectPartition3DataLength = vp8PicParams->uiPartitionSize[i];
+            cmd->DW10.IndirectPartition3DataStartOffset = cmd->DW8.IndirectPartition2DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
         }
 
         i = 4;
         if (i < ((1 + numPartitions)))
         {
-            cmd.DW11.IndirectPartition4DataLength = vp8PicParams->uiPartitionSize[i];
-            cmd.DW12.IndirectPartition4DataStartOffset = cmd.DW10.IndirectPartition3DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
+            cmd->DW11.IndirectPartition4DataLength = vp8PicParams->uiPartitionSize[i];
+            cmd->DW12.IndirectPartition4DataStartOffset = cmd->DW10.IndirectPartition3DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
         }
 
         i = 5;
         if (i < ((1 + numPartitions)))
         {
-            cmd.DW13.IndirectPartition5DataLength = vp8PicParams->uiPartitionSize[i];
-            cmd.DW14.IndirectPartition5DataStartOffset = cmd.DW12.IndirectPartition4DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
+            cmd->DW13.IndirectPartition5DataLength = vp8PicParams->uiPartitionSize[i];
+            cmd->DW14.IndirectPartition5DataStartOffset = cmd->DW12.IndirectPartition4DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
         }
 
         i = 6;
         if (i < ((1 + numPartitions)))
         {
-            cmd.DW15.IndirectPartition6DataLength = vp8PicParams->uiPartitionSize[i];
-            cmd.DW16.IndirectPartition6DataStartOffset = cmd.DW14.IndirectPartition5DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
+            cmd->DW15.IndirectPartition6DataLength = vp8PicParams->uiPartitionSize[i];
+            cmd->DW16.IndirectPartition6DataStartOffset = cmd->DW14.IndirectPartition5DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
         }
 
         i = 7;
         if (i < ((1 + numPartitions)))
         {
-            cmd.DW17.IndirectPartition7DataLength = vp8PicParams->uiPartitionSize[i];
-            cmd.DW18.IndirectPartition7DataStartOffset = cmd.DW16.IndirectPartition6DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
+            cmd->DW17.IndirectPartition7DataLength = vp8PicParams->uiPartitionSize[i];
+            cmd->DW18.IndirectPartition7DataStartOffset = cmd->DW16.IndirectPartition6DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
         }
 
         i = 8;
         if (i < ((1 + numPartitions)))
         {
-            cmd.DW19.IndirectPartition8DataLength = vp8PicParams->uiPartitionSize[i];
-            cmd.DW20.IndirectPartition8DataStartOffset = cmd.DW18.IndirectPartition7DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
+            cmd->DW19.IndirectPartition8DataLength = vp8PicParams->uiPartitionSize[i];
+            cmd->DW20.IndirectPartition8DataStartOffset = cmd->DW18.IndirectPartition7DataStartOffset + vp8PicParams->uiPartitionSize[i - 1];
         }
 
-        MHW_MI_CHK_STATUS(Mos_AddCommand(cmdBuffer, &cmd, sizeof(cmd)));
+        MHW_MI_CHK_STATUS(Mos_CommitCommand(cmdBuffer, cmd->byteSize));
 
         return eStatus;
     }
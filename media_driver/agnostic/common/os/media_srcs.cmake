@@ -19,9 +19,14 @@
 # OTHER DEALINGS IN THE SOFTWARE.
 
 set(TMP_SOURCES_
+    ${CMAKE_CURRENT_LIST_DIR}/mos_command_recorder.cpp
     ${CMAKE_CURRENT_LIST_DIR}/mos_context.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/mos_dump_service.cpp
     ${CMAKE_CURRENT_LIST_DIR}/mos_graphicsresource.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/mos_mem_copy.cpp
     ${CMAKE_CURRENT_LIST_DIR}/mos_os.c
+    ${CMAKE_CURRENT_LIST_DIR}/mos_sw_tiling.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/mos_task_pool.cpp
     ${CMAKE_CURRENT_LIST_DIR}/mos_util_debug.c
     ${CMAKE_CURRENT_LIST_DIR}/mos_util_user_interface.cpp
     ${CMAKE_CURRENT_LIST_DIR}/mos_utilities.c
@@ -29,14 +34,19 @@ set(TMP_SOURCES_
 
 set(TMP_HEADERS_
     ${CMAKE_CURRENT_LIST_DIR}/media_fourcc.h
+    ${CMAKE_CURRENT_LIST_DIR}/mos_command_recorder.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_context.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_defs.h
+    ${CMAKE_CURRENT_LIST_DIR}/mos_dump_service.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_graphicsresource.h
+    ${CMAKE_CURRENT_LIST_DIR}/mos_mem_copy.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_os.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_os_hw.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_os_trace_event.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_resource_defs.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_solo_generic.h
+    ${CMAKE_CURRENT_LIST_DIR}/mos_sw_tiling.h
+    ${CMAKE_CURRENT_LIST_DIR}/mos_task_pool.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_util_debug.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_util_user_feature_keys.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_util_user_interface.h
@@ -0,0 +1,461 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_command_recorder.cpp
+//! \brief    Records independent passes on worker threads and submits them in order
+//!
+
+#include "mos_command_recorder.h"
+#include "mos_task_pool.h"
+
+MosCommandRecorder::MosCommandRecorder(PMOS_INTERFACE osInterface) :
+    m_osInterface(osInterface)
+{
+    for (uint32_t i = 0; i < MOS_COMMAND_RECORDER_MAX_PASSES; i++)
+    {
+        m_passes[i].m_buffer     = nullptr;
+        m_passes[i].m_bufferSize = 0;
+    }
+}
+
+MosCommandRecorder::~MosCommandRecorder()
+{
+    for (uint32_t i = 0; i < MOS_COMMAND_RECORDER_MAX_PASSES; i++)
+    {
+        MOS_FreeMemory(m_passes[i].m_buffer);
+    }
+}
+
+void MosCommandRecorder::SetBatchCallbacks(
+    PFN_MOS_RECORD_BATCH    pfnBegin,
+    PFN_MOS_RECORD_BATCH    pfnEnd,
+    void                    *context)
+{
+    m_pfnBeginBatch = pfnBegin;
+    m_pfnEndBatch   = pfnEnd;
+    m_batchContext  = context;
+}
+
+MOS_STATUS MosCommandRecorder::AddPass(
+    MOS_GPU_CONTEXT         gpuContext,
+    PFN_MOS_RECORD_PASS     pfnRecord,
+    void                    *context,
+    uint32_t                maxSize,
+    uint32_t                *passIndex)
+{
+    Pass            *pass;
+    PMOS_INTERFACE  passOsInterface;
+
+    MOS_OS_CHK_NULL_RETURN(m_osInterface);
+    MOS_OS_CHK_NULL_RETURN(pfnRecord);
+    MOS_OS_CHK_NULL_RETURN(passIndex);
+
+    if (m_passCount >= MOS_COMMAND_RECORDER_MAX_PASSES || maxSize == 0)
+    {
+        MOS_OS_ASSERTMESSAGE("Cannot add a pass of %d bytes.", maxSize);
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    pass = &m_passes[m_passCount];
+    if (pass->m_bufferSize < maxSize)
+    {
+        MOS_FreeMemory(pass->m_buffer);
+        pass->m_bufferSize = 0;
+        pass->m_buffer     = (uint8_t *)MOS_AllocMemory(maxSize);
+        MOS_OS_CHK_NULL_RETURN(pass->m_buffer);
+        pass->m_bufferSize = maxSize;
+    }
+
+    pass->m_gpuContext = gpuContext;
+    pass->m_pfnRecord  = pfnRecord;
+    pass->m_context    = context;
+    pass->m_status     = MOS_STATUS_SUCCESS;
+
+    MOS_ZeroMemory(&pass->m_cmdBuffer, sizeof(pass->m_cmdBuffer));
+    pass->m_cmdBuffer.pCmdBase       = (uint32_t *)pass->m_buffer;
+    pass->m_cmdBuffer.pCmdPtr        = (uint32_t *)pass->m_buffer;
+    pass->m_cmdBuffer.iRemaining     = maxSize;
+    pass->m_cmdBuffer.bCachedMapping = true;
+
+    // Everything but the command buffer and the allocation and patch lists is shared
+    passOsInterface  = &pass->m_osInterface;
+    *passOsInterface = *m_osInterface;
+    pass->m_osInterface.m_pass = pass;
+
+    passOsInterface->CurrentGpuContextOrdinal       = gpuContext;
+    passOsInterface->pfnSetGpuContext               = SetGpuContext;
+    passOsInterface->pfnGetGpuContext               = GetGpuContext;
+    passOsInterface->pfnRegisterResource            = RegisterResource;
+    passOsInterface->pfnGetResourceAllocationIndex  = GetResourceAllocationIndex;
+    passOsInterface->pfnSetPatchEntry               = SetPatchEntry;
+    passOsInterface->pfnVerifyCommandBufferSize     = VerifyCommandBufferSize;
+    passOsInterface->pfnGetCommandBuffer            = GetCommandBuffer;
+    passOsInterface->pfnReturnCommandBuffer         = ReturnCommandBuffer;
+    passOsInterface->pfnSubmitCommandBuffer         = SubmitCommandBuffer;
+
+    *passIndex = m_passCount++;
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MosCommandRecorder::AddDependency(uint32_t passIndex, uint32_t dependencyIndex)
+{
+    if (passIndex >= m_passCount || dependencyIndex >= m_passCount || passIndex == dependencyIndex)
+    {
+        MOS_OS_ASSERTMESSAGE("Invalid dependency of pass %d on pass %d.", passIndex, dependencyIndex);
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    m_passes[passIndex].m_dependencies.push_back(dependencyIndex);
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MosCommandRecorder::Execute(uint32_t maxThreads, bool nullRendering)
+{
+    uint32_t            order[MOS_COMMAND_RECORDER_MAX_PASSES];
+    MOS_COMMAND_BUFFER  cmdBuffer;
+    MOS_GPU_CONTEXT     batchContext = MOS_GPU_CONTEXT_INVALID_HANDLE;
+    bool                batchOpen = false;
+    Pass                *pass;
+    uint32_t            i;
+    MOS_STATUS          eStatus = MOS_STATUS_SUCCESS;
+
+    MOS_OS_CHK_NULL(m_osInterface);
+
+    if (m_passCount == 0)
+    {
+        goto finish;
+    }
+
+    MOS_OS_CHK_STATUS(SortPasses(order));
+
+    MOS_OS_CHK_STATUS(MOS_TaskPool_Run(RecordPass, this, m_passCount, maxThreads));
+
+    // Report the failure of the first pass added, whatever the thread count
+    for (i = 0; i < m_passCount; i++)
+    {
+        MOS_OS_CHK_STATUS(m_passes[i].m_status);
+    }
+
+    MOS_ZeroMemory(&cmdBuffer, sizeof(cmdBuffer));
+
+    for (i = 0; i < m_passCount; i++)
+    {
+        pass = &m_passes[order[i]];
+
+        if (batchOpen && pass->m_gpuContext != batchContext)
+        {
+            batchOpen = false;
+            MOS_OS_CHK_STATUS(SubmitBatch(&cmdBuffer, nullRendering));
+        }
+
+        if (!batchOpen)
+        {
+            MOS_OS_CHK_STATUS(m_osInterface->pfnSetGpuContext(m_osInterface, pass->m_gpuContext));
+            MOS_OS_CHK_STATUS(m_osInterface->pfnGetCommandBuffer(m_osInterface, &cmdBuffer, 0));
+            batchOpen    = true;
+            batchContext = pass->m_gpuContext;
+
+            if (m_pfnBeginBatch)
+            {
+                MOS_OS_CHK_STATUS(m_pfnBeginBatch(m_batchContext, m_osInterface, &cmdBuffer));
+            }
+        }
+
+        // Dependencies on other contexts were submitted with an earlier batch
+        for (uint32_t dependency : pass->m_dependencies)
+        {
+            if (m_passes[dependency].m_gpuContext != pass->m_gpuContext &&
+                m_osInterface->pfnSyncGpuContext)
+            {
+                m_osInterface->pfnSyncGpuContext(m_osInterface, m_passes[dependency].m_gpuContext, pass->m_gpuContext);
+            }
+        }
+
+        MOS_OS_CHK_STATUS(ReplayPass(pass, &cmdBuffer));
+    }
+
+    batchOpen = false;
+    MOS_OS_CHK_STATUS(SubmitBatch(&cmdBuffer, nullRendering));
+
+finish:
+    if (batchOpen)
+    {
+        m_osInterface->pfnReturnCommandBuffer(m_osInterface, &cmdBuffer, 0);
+    }
+    Reset();
+    return eStatus;
+}
+
+MOS_STATUS MosCommandRecorder::SortPasses(uint32_t *order)
+{
+    bool        sorted[MOS_COMMAND_RECORDER_MAX_PASSES];
+    uint32_t    count = 0;
+    uint32_t    i;
+
+    MOS_ZeroMemory(sorted, sizeof(sorted));
+
+    // Take the first pass added whose dependencies are all submitted
+    while (count < m_passCount)
+    {
+        for (i = 0; i < m_passCount; i++)
+        {
+            bool ready = !sorted[i];
+            for (uint32_t dependency : m_passes[i].m_dependencies)
+            {
+                ready = ready && sorted[dependency];
+            }
+            if (ready)
+            {
+                break;
+            }
+        }
+
+        if (i == m_passCount)
+        {
+            MOS_OS_ASSERTMESSAGE("The pass dependencies have a cycle.");
+            return MOS_STATUS_INVALID_PARAMETER;
+        }
+
+        sorted[i]      = true;
+        order[count++] = i;
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MosCommandRecorder::ReplayPass(Pass *pass, PMOS_COMMAND_BUFFER cmdBuffer)
+{
+    MOS_PATCH_ENTRY_PARAMS  patchEntryParams;
+    uint32_t                baseOffset = cmdBuffer->iOffset;
+    uint32_t                size = pass->m_cmdBuffer.iOffset;
+
+    if (size > 0)
+    {
+        MOS_OS_CHK_STATUS_RETURN(Mos_AddCommand(cmdBuffer, pass->m_buffer, size));
+    }
+
+    for (uint32_t i = 0; i < pass->m_resources.size(); i++)
+    {
+        MOS_OS_CHK_STATUS_RETURN(m_osInterface->pfnRegisterResource(
+            m_osInterface,
+            pass->m_resources[i],
+            pass->m_writeModes[i],
+            pass->m_writeModes[i]));
+    }
+
+    // The commands are in place before the patch entries, which may read them
+    for (uint32_t i = 0; i < pass->m_patches.size(); i++)
+    {
+        patchEntryParams = pass->m_patches[i];
+        if (patchEntryParams.uiPatchOffset + sizeof(uint32_t) > size)
+        {
+            MOS_OS_ASSERTMESSAGE("Patch offset %d is out of the pass commands.", patchEntryParams.uiPatchOffset);
+            return MOS_STATUS_INVALID_PARAMETER;
+        }
+
+        patchEntryParams.presResource      = pass->m_resources[patchEntryParams.uiAllocationIndex];
+        patchEntryParams.uiAllocationIndex = m_osInterface->pfnGetResourceAllocationIndex(m_osInterface, patchEntryParams.presResource);
+        patchEntryParams.uiPatchOffset    += baseOffset;
+        patchEntryParams.cmdBufBase        = (uint8_t *)cmdBuffer->pCmdBase;
+
+        MOS_OS_CHK_STATUS_RETURN(m_osInterface->pfnSetPatchEntry(m_osInterface, &patchEntryParams));
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MosCommandRecorder::SubmitBatch(PMOS_COMMAND_BUFFER cmdBuffer, bool nullRendering)
+{
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+    if (m_pfnEndBatch)
+    {
+        eStatus = m_pfnEndBatch(m_batchContext, m_osInterface, cmdBuffer);
+    }
+
+    m_osInterface->pfnReturnCommandBuffer(m_osInterface, cmdBuffer, 0);
+    MOS_OS_CHK_STATUS_RETURN(eStatus);
+
+    return m_osInterface->pfnSubmitCommandBuffer(m_osInterface, cmdBuffer, nullRendering);
+}
+
+void MosCommandRecorder::Reset()
+{
+    for (uint32_t i = 0; i < m_passCount; i++)
+    {
+        // Cleared, not freed, the next execution usually records the same amount
+        m_passes[i].m_dependencies.clear();
+        m_passes[i].m_resources.clear();
+        m_passes[i].m_writeModes.clear();
+        m_passes[i].m_patches.clear();
+    }
+    m_passCount = 0;
+}
+
+void MosCommandRecorder::RecordPass(void *pContext, uint32_t index)
+{
+    Pass *pass = &static_cast<MosCommandRecorder *>(pContext)->m_passes[index];
+
+    pass->m_status = pass->m_pfnRecord(pass->m_context, &pass->m_osInterface, &pass->m_cmdBuffer);
+}
+
+MOS_STATUS MosCommandRecorder::SetGpuContext(PMOS_INTERFACE pOsInterface, MOS_GPU_CONTEXT GpuContext)
+{
+    Pass *pass = static_cast<PassOsInterface *>(pOsInterface)->m_pass;
+
+    if (GpuContext != pass->m_gpuContext)
+    {
+        MOS_OS_ASSERTMESSAGE("A pass cannot change its GPU context.");
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_GPU_CONTEXT MosCommandRecorder::GetGpuContext(PMOS_INTERFACE pOsInterface)
+{
+    return static_cast<PassOsInterface *>(pOsInterface)->m_pass->m_gpuContext;
+}
+
+MOS_STATUS MosCommandRecorder::RegisterResource(
+    PMOS_INTERFACE  pOsInterface,
+    PMOS_RESOURCE   pResource,
+    int32_t         bWrite,
+    int32_t         bWritebSetResourceSyncTag)
+{
+    Pass        *pass = static_cast<PassOsInterface *>(pOsInterface)->m_pass;
+    int32_t     index;
+
+    MOS_UNUSED(bWritebSetResourceSyncTag);
+    MOS_OS_CHK_NULL_RETURN(pResource);
+
+    // The shared resource is left untouched, its allocation index is set at submission
+    index = GetResourceAllocationIndex(pOsInterface, pResource);
+    if (index == MOS_INVALID_ALLOC_INDEX)
+    {
+        pass->m_resources.push_back(pResource);
+        pass->m_writeModes.push_back(bWrite);
+    }
+    else
+    {
+        pass->m_writeModes[index] |= bWrite;
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
+int32_t MosCommandRecorder::GetResourceAllocationIndex(PMOS_INTERFACE pOsInterface, PMOS_RESOURCE pResource)
+{
+    Pass *pass = static_cast<PassOsInterface *>(pOsInterface)->m_pass;
+
+    for (uint32_t i = 0; i < pass->m_resources.size(); i++)
+    {
+        if (pass->m_resources[i] == pResource)
+        {
+            return i;
+        }
+    }
+
+    return MOS_INVALID_ALLOC_INDEX;
+}
+
+MOS_STATUS MosCommandRecorder::SetPatchEntry(PMOS_INTERFACE pOsInterface, PMOS_PATCH_ENTRY_PARAMS pParams)
+{
+    Pass *pass = static_cast<PassOsInterface *>(pOsInterface)->m_pass;
+
+    MOS_OS_CHK_NULL_RETURN(pParams);
+
+    if (pParams->uiAllocationIndex >= pass->m_resources.size())
+    {
+        MOS_OS_ASSERTMESSAGE("Patch entry of an unregistered resource.");
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    pass->m_patches.push_back(*pParams);
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MosCommandRecorder::VerifyCommandBufferSize(
+    PMOS_INTERFACE  pOsInterface,
+    uint32_t        dwRequestedSize,
+    uint32_t        dwFlags)
+{
+    Pass *pass = static_cast<PassOsInterface *>(pOsInterface)->m_pass;
+
+    MOS_UNUSED(dwFlags);
+
+    if ((uint32_t)(pass->m_cmdBuffer.iOffset + pass->m_cmdBuffer.iRemaining) < dwRequestedSize)
+    {
+        return MOS_STATUS_UNKNOWN;
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MosCommandRecorder::GetCommandBuffer(
+    PMOS_INTERFACE      pOsInterface,
+    PMOS_COMMAND_BUFFER pCmdBuffer,
+    uint32_t            dwFlags)
+{
+    Pass *pass = static_cast<PassOsInterface *>(pOsInterface)->m_pass;
+
+    MOS_UNUSED(dwFlags);
+    MOS_OS_CHK_NULL_RETURN(pCmdBuffer);
+
+    if (pCmdBuffer != &pass->m_cmdBuffer)
+    {
+        *pCmdBuffer = pass->m_cmdBuffer;
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
+void MosCommandRecorder::ReturnCommandBuffer(
+    PMOS_INTERFACE      pOsInterface,
+    PMOS_COMMAND_BUFFER pCmdBuffer,
+    uint32_t            dwFlags)
+{
+    Pass *pass = static_cast<PassOsInterface *>(pOsInterface)->m_pass;
+
+    MOS_UNUSED(dwFlags);
+
+    if (pCmdBuffer && pCmdBuffer != &pass->m_cmdBuffer)
+    {
+        pass->m_cmdBuffer = *pCmdBuffer;
+    }
+}
+
+MOS_STATUS MosCommandRecorder::SubmitCommandBuffer(
+    PMOS_INTERFACE      pOsInterface,
+    PMOS_COMMAND_BUFFER pCmdBuffer,
+    int32_t             bNullRendering)
+{
+    MOS_UNUSED(pOsInterface);
+    MOS_UNUSED(pCmdBuffer);
+    MOS_UNUSED(bNullRendering);
+
+    MOS_OS_ASSERTMESSAGE("Passes are submitted by the recorder.");
+    return MOS_STATUS_INVALID_PARAMETER;
+}
@@ -0,0 +1,244 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_command_recorder.h
+//! \brief    Records independent passes on worker threads and submits them in order
+//! \details  Every pass records into its own host command buffer, on the MOS task
+//!           pool, through a pass local copy of the OS interface. Its resource
+//!           registrations and patch entries are kept with the pass instead of going
+//!           to the allocation and patch lists of the shared GPU context. Execute then
+//!           replays the passes into the real command buffers on the calling thread,
+//!           in dependency order with ties broken by the order the passes were added,
+//!           so the submitted commands do not depend on the thread count.
+//!
+#ifndef __MOS_COMMAND_RECORDER_H__
+#define __MOS_COMMAND_RECORDER_H__
+
+#include "mos_os.h"
+#include <vector>
+
+#define MOS_COMMAND_RECORDER_MAX_PASSES     32      //!< Passes of one execution
+
+//!
+//! \brief    Pass recording callback
+//! \details  Called on any thread. Only the OS interface given here may be used to
+//!           record, MHW and HAL objects holding the shared OS interface must not be.
+//!           The pass interface serves pfnGetCommandBuffer, pfnReturnCommandBuffer,
+//!           pfnVerifyCommandBufferSize, pfnRegisterResource,
+//!           pfnGetResourceAllocationIndex, pfnSetPatchEntry and the GPU context
+//!           getters and setters. The other functions are the ones of the shared
+//!           interface and must not modify it.
+//! \param    [in] pContext
+//!           Context given to AddPass
+//! \param    [in] pOsInterface
+//!           Pass OS interface
+//! \param    [in,out] pCmdBuffer
+//!           Host command buffer of the pass
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if the pass was recorded
+//!
+typedef MOS_STATUS (*PFN_MOS_RECORD_PASS)(
+    void                *pContext,
+    PMOS_INTERFACE      pOsInterface,
+    PMOS_COMMAND_BUFFER pCmdBuffer);
+
+//!
+//! \brief    Batch callback
+//! \details  Called on the submitting thread with the shared OS interface, before the
+//!           first and after the last pass of each command buffer, to add the prolog
+//!           and the batch buffer end
+//! \param    [in] pContext
+//!           Context given to SetBatchCallbacks
+//! \param    [in] pOsInterface
+//!           Shared OS interface, set to the GPU context of the batch
+//! \param    [in,out] pCmdBuffer
+//!           Command buffer of the batch
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if successful
+//!
+typedef MOS_STATUS (*PFN_MOS_RECORD_BATCH)(
+    void                *pContext,
+    PMOS_INTERFACE      pOsInterface,
+    PMOS_COMMAND_BUFFER pCmdBuffer);
+
+//!
+//! \class    MosCommandRecorder
+//! \brief    Passes of one execution, reused from frame to frame
+//!
+class MosCommandRecorder
+{
+public:
+    //!
+    //! \brief    Constructor
+    //! \param    [in] osInterface
+    //!           Shared OS interface the passes are submitted with
+    //!
+    MosCommandRecorder(PMOS_INTERFACE osInterface);
+
+    //!
+    //! \brief    Destructor
+    //!
+    ~MosCommandRecorder();
+
+    //!
+    //! \brief    Set the callbacks adding the prolog and the end of each batch
+    //! \param    [in] pfnBegin
+    //!           Called before the first pass of a batch, may be nullptr
+    //! \param    [in] pfnEnd
+    //!           Called after the last pass of a batch, may be nullptr
+    //! \param    [in] context
+    //!           Context given to both callbacks
+    //! \return   void
+    //!
+    void SetBatchCallbacks(PFN_MOS_RECORD_BATCH pfnBegin, PFN_MOS_RECORD_BATCH pfnEnd, void *context);
+
+    //!
+    //! \brief    Add a pass to the next execution
+    //! \param    [in] gpuContext
+    //!           GPU context the pass is submitted to
+    //! \param    [in] pfnRecord
+    //!           Recording callback
+    //! \param    [in] context
+    //!           Context given to the callback
+    //! \param    [in] maxSize
+    //!           Size of the pass command buffer in bytes
+    //! \param    [out] passIndex
+    //!           Index of the pass, used to add dependencies
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if the pass was added
+    //!
+    MOS_STATUS AddPass(
+        MOS_GPU_CONTEXT         gpuContext,
+        PFN_MOS_RECORD_PASS     pfnRecord,
+        void                    *context,
+        uint32_t                maxSize,
+        uint32_t                *passIndex);
+
+    //!
+    //! \brief    Make a pass execute after another one
+    //! \details  The pass is submitted after its dependency. When they run on different
+    //!           GPU contexts the submitting context is synchronized with the one of the
+    //!           dependency through pfnSyncGpuContext.
+    //! \param    [in] passIndex
+    //!           Dependent pass
+    //! \param    [in] dependencyIndex
+    //!           Pass it depends on
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if the edge was added
+    //!
+    MOS_STATUS AddDependency(uint32_t passIndex, uint32_t dependencyIndex);
+
+    //!
+    //! \brief    Record all the passes and submit them
+    //! \details  Consecutive passes of the same GPU context share a command buffer.
+    //!           Nothing is submitted if a pass fails to record. The passes are
+    //!           removed whatever the result, their host buffers are kept for the
+    //!           next execution.
+    //! \param    [in] maxThreads
+    //!           Maximum number of recording threads, calling thread included
+    //! \param    [in] nullRendering
+    //!           Null rendering flag given to pfnSubmitCommandBuffer
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if all the passes were submitted,
+    //!           MOS_STATUS_INVALID_PARAMETER if the dependencies have a cycle
+    //!
+    MOS_STATUS Execute(uint32_t maxThreads, bool nullRendering);
+
+    //!
+    //! \brief    Get the number of passes added since the last execution
+    //! \return   uint32_t
+    //!           Number of passes
+    //!
+    uint32_t GetPassCount() { return m_passCount; }
+
+private:
+    struct Pass;
+
+    //!
+    //! \brief    OS interface given to a recording pass
+    //!
+    struct PassOsInterface : public MOS_INTERFACE
+    {
+        Pass    *m_pass;
+    };
+
+    //!
+    //! \brief    Pass and what it recorded
+    //!
+    struct Pass
+    {
+        MOS_GPU_CONTEXT                     m_gpuContext;
+        PFN_MOS_RECORD_PASS                 m_pfnRecord;
+        void                                *m_context;
+        std::vector<uint32_t>               m_dependencies;
+        MOS_STATUS                          m_status;
+
+        PassOsInterface                     m_osInterface;
+        MOS_COMMAND_BUFFER                  m_cmdBuffer;
+        uint8_t                             *m_buffer;          //!< Host buffer, kept across executions
+        uint32_t                            m_bufferSize;
+        std::vector<PMOS_RESOURCE>          m_resources;        //!< Registered resources, in allocation index order
+        std::vector<int32_t>                m_writeModes;
+        std::vector<MOS_PATCH_ENTRY_PARAMS> m_patches;          //!< Patch offsets relative to the host buffer
+    };
+
+    MOS_STATUS SortPasses(uint32_t *order);
+
+    MOS_STATUS ReplayPass(Pass *pass, PMOS_COMMAND_BUFFER cmdBuffer);
+
+    MOS_STATUS SubmitBatch(PMOS_COMMAND_BUFFER cmdBuffer, bool nullRendering);
+
+    void Reset();
+
+    static void RecordPass(void *pContext, uint32_t index);
+
+    static MOS_STATUS SetGpuContext(PMOS_INTERFACE pOsInterface, MOS_GPU_CONTEXT GpuContext);
+
+    static MOS_GPU_CONTEXT GetGpuContext(PMOS_INTERFACE pOsInterface);
+
+    static MOS_STATUS RegisterResource(
+        PMOS_INTERFACE  pOsInterface,
+        PMOS_RESOURCE   pResource,
+        int32_t         bWrite,
+        int32_t         bWritebSetResourceSyncTag);
+
+    static int32_t GetResourceAllocationIndex(PMOS_INTERFACE pOsInterface, PMOS_RESOURCE pResource);
+
+    static MOS_STATUS SetPatchEntry(PMOS_INTERFACE pOsInterface, PMOS_PATCH_ENTRY_PARAMS pParams);
+
+    static MOS_STATUS VerifyCommandBufferSize(PMOS_INTERFACE pOsInterface, uint32_t dwRequestedSize, uint32_t dwFlags);
+
+    static MOS_STATUS GetCommandBuffer(PMOS_INTERFACE pOsInterface, PMOS_COMMAND_BUFFER pCmdBuffer, uint32_t dwFlags);
+
+    static void ReturnCommandBuffer(PMOS_INTERFACE pOsInterface, PMOS_COMMAND_BUFFER pCmdBuffer, uint32_t dwFlags);
+
+    static MOS_STATUS SubmitCommandBuffer(PMOS_INTERFACE pOsInterface, PMOS_COMMAND_BUFFER pCmdBuffer, int32_t bNullRendering);
+
+    PMOS_INTERFACE          m_osInterface;
+    PFN_MOS_RECORD_BATCH    m_pfnBeginBatch = nullptr;
+    PFN_MOS_RECORD_BATCH    m_pfnEndBatch = nullptr;
+    void                    *m_batchContext = nullptr;
+    Pass                    m_passes[MOS_COMMAND_RECORDER_MAX_PASSES];
+    uint32_t                m_passCount = 0;
+};
+
+#endif // __MOS_COMMAND_RECORDER_H__
@@ -0,0 +1,1106 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_dump_service.cpp
+//! \brief    Asynchronous file dump service used by the codec and VP debug tools
+//!
+
+#include "mos_dump_service.h"
+#include "mos_os.h"
+#include "mos_utilities.h"
+#include "mos_util_debug.h"
+#include "mos_mem_copy.h"
+#include <fcntl.h>
+
+#define MOS_DUMP_BUFFER_MAGIC           0x504d5544  // "DUMP"
+#define MOS_DUMP_HEX_LINE_SIZE          36          // 4 x "%08x " plus new line
+
+#define MOS_DUMP_LZ4_MAGIC              0x184D2204
+#define MOS_DUMP_LZ4_FLG                0x60        // Version 1, independent blocks
+#define MOS_DUMP_LZ4_BD                 0x40        // 64KB max block size
+#define MOS_DUMP_LZ4_HC                 0x82        // (XXH32(FLG BD, 0) >> 8) & 0xFF
+#define MOS_DUMP_LZ4_UNCOMPRESSED       0x80000000
+#define MOS_DUMP_LZ4_HASH_LOG           12
+#define MOS_DUMP_LZ4_MIN_MATCH          4
+#define MOS_DUMP_LZ4_LAST_LITERALS      5
+#define MOS_DUMP_LZ4_MF_LIMIT           12
+#define MOS_DUMP_LZ4_MAX_OFFSET         65535
+
+//!
+//! \brief    Header placed in front of every snapshot buffer
+//!
+typedef struct _MOS_DUMP_BUFFER
+{
+    uint32_t                dwCapacity;
+    uint32_t                dwMagic;
+    union
+    {
+        _MOS_DUMP_BUFFER    *pNext;         //!< Link in the cache of released buffers
+        uint64_t            uiAlign;
+    };
+} MOS_DUMP_BUFFER, *PMOS_DUMP_BUFFER;
+
+//!
+//! \brief    Queued work item of the writer thread
+//!
+typedef struct _MOS_DUMP_JOB
+{
+    _MOS_DUMP_JOB           *pNext;
+    PMOS_DUMP_BUFFER        pBuffer;        //!< Snapshot, nullptr for control jobs
+    uint32_t                dwSize;
+    MOS_DUMP_FORMAT         format;
+    bool                    bAppend;
+    bool                    bExit;          //!< Stop the writer thread
+    PMOS_SEMAPHORE          pFence;         //!< Posted once all earlier jobs are written
+    char                    sFilename[MOS_MAX_PATH_LENGTH + 1];
+} MOS_DUMP_JOB, *PMOS_DUMP_JOB;
+
+//!
+//! \brief    Process wide dump service
+//! \details  The queue, the pool and the counters are protected by m_queueMutex.
+//!           Allocations beyond the pool budget wait on m_spaceSemaphore for the
+//!           writer thread to release the buffers of the pending dumps.
+//!           The file state is only touched under m_writerMutex, which is held by
+//!           the writer thread, or by the submitting thread when dumps are
+//!           written synchronously.
+//!
+class MosDumpService
+{
+public:
+    static MosDumpService *GetInstance();
+
+    void *AllocBuffer(uint32_t size);
+
+    void FreeBuffer(void *buffer);
+
+    MOS_STATUS Submit(
+        const char      *filename,
+        void            *buffer,
+        uint32_t        size,
+        MOS_DUMP_FORMAT format,
+        bool            append);
+
+    MOS_STATUS Flush();
+
+    void GetStatistics(PMOS_DUMP_STATISTICS statistics);
+
+private:
+    MosDumpService();
+    ~MosDumpService();
+
+    static void *WriterThread(void *context);
+
+    void ProcessJobs();
+
+    void ReleaseBuffer(PMOS_DUMP_BUFFER buffer);
+
+    void TrimCache(uint64_t budget);
+
+    MOS_STATUS WriteJob(PMOS_DUMP_JOB job);
+
+    MOS_STATUS OpenFile(const char *filename, bool append);
+
+    MOS_STATUS CloseFile();
+
+    MOS_STATUS Output(const uint8_t *data, uint32_t size);
+
+    MOS_STATUS EmitBytes(const uint8_t *data, uint32_t size);
+
+    MOS_STATUS EmitBlock();
+
+    MOS_STATUS FlushWriteBuffer();
+
+    MOS_STATUS FormatHexDwords(const uint8_t *data, uint32_t size);
+
+    static uint32_t CompressBlock(
+        const uint8_t   *src,
+        uint32_t        srcSize,
+        uint8_t         *dst,
+        uint32_t        dstCapacity);
+
+    bool                m_async         = false;
+    bool                m_compress      = false;
+    bool                m_drop          = false;    //!< Drop dumps instead of waiting for pool space
+    uint64_t            m_poolBudget    = 0;
+    uint64_t            m_poolUsage     = 0;
+    bool                m_dropReported  = false;
+    uint32_t            m_pendingCount  = 0;        //!< Queued dumps not yet released by the writer
+    uint32_t            m_spaceWaiters  = 0;
+    PMOS_SEMAPHORE      m_spaceSemaphore = nullptr;
+
+    PMOS_MUTEX          m_queueMutex    = nullptr;
+    PMOS_SEMAPHORE      m_jobSemaphore  = nullptr;
+    MOS_THREADHANDLE    m_thread        = 0;
+    PMOS_DUMP_JOB       m_jobHead       = nullptr;
+    PMOS_DUMP_JOB       m_jobTail       = nullptr;
+    PMOS_DUMP_BUFFER    m_cached        = nullptr;
+    uint32_t            m_cachedCount   = 0;
+    MOS_DUMP_STATISTICS m_stats         = {};
+
+    // Writer state
+    PMOS_MUTEX          m_writerMutex   = nullptr;
+    HANDLE              m_file          = nullptr;
+    bool                m_fileOpen      = false;
+    char                m_filename[MOS_MAX_PATH_LENGTH + 1] = {};
+    uint8_t             *m_writeBuffer  = nullptr;
+    uint32_t            m_writeSize     = 0;
+    uint8_t             *m_block        = nullptr;      //!< LZ4 input block
+    uint32_t            m_blockSize     = 0;
+    uint8_t             *m_compressed   = nullptr;      //!< LZ4 output block
+};
+
+MosDumpService *MosDumpService::GetInstance()
+{
+    static MosDumpService instance;
+    return &instance;
+}
+
+MosDumpService::MosDumpService()
+{
+    uint64_t poolSizeMB = MOS_DUMP_SERVICE_DEFAULT_POOL_SIZE_MB;
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+    MOS_USER_FEATURE_VALUE_DATA userFeatureData;
+
+    MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_ENABLE_ID,
+        &userFeatureData);
+    m_async = userFeatureData.u32Data ? true : false;
+
+    MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_POOL_SIZE_ID,
+        &userFeatureData);
+    if (userFeatureData.u32Data)
+    {
+        poolSizeMB = userFeatureData.u32Data;
+    }
+
+    MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_COMPRESSION_ID,
+        &userFeatureData);
+    m_compress = userFeatureData.u32Data ? true : false;
+
+    MOS_ZeroMemory(&userFeatureData, sizeof(userFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_DROP_ENABLE_ID,
+        &userFeatureData);
+    m_drop = userFeatureData.u32Data ? true : false;
+#endif
+
+    m_poolBudget   = poolSizeMB << 20;
+    m_queueMutex   = MOS_CreateMutex();
+    m_writerMutex  = MOS_CreateMutex();
+
+    if (m_async && m_queueMutex && m_writerMutex)
+    {
+        m_jobSemaphore   = MOS_CreateSemaphore(0, INT32_MAX);
+        m_spaceSemaphore = MOS_CreateSemaphore(0, INT32_MAX);
+        if (m_jobSemaphore && m_spaceSemaphore)
+        {
+            m_thread = MOS_CreateThread((void *)WriterThread, this);
+        }
+    }
+
+    if (m_async && !m_thread)
+    {
+        MOS_OS_ASSERTMESSAGE("Failed to start the dump writer thread, dumps are written synchronously.");
+        m_async = false;
+    }
+}
+
+MosDumpService::~MosDumpService()
+{
+    if (m_thread)
+    {
+        PMOS_DUMP_JOB job = (PMOS_DUMP_JOB)MOS_AllocAndZeroMemory(sizeof(MOS_DUMP_JOB));
+        if (job)
+        {
+            job->bExit = true;
+            MOS_LockMutex(m_queueMutex);
+            if (m_jobTail)
+            {
+                m_jobTail->pNext = job;
+            }
+            else
+            {
+                m_jobHead = job;
+            }
+            m_jobTail = job;
+            MOS_UnlockMutex(m_queueMutex);
+            MOS_PostSemaphore(m_jobSemaphore, 1);
+            MOS_WaitThread(m_thread);
+        }
+        m_thread = 0;
+    }
+
+    TrimCache(0);
+    MOS_SafeFreeMemory(m_writeBuffer);
+    MOS_SafeFreeMemory(m_block);
+    MOS_SafeFreeMemory(m_compressed);
+
+    if (m_jobSemaphore)
+    {
+        MOS_DestroySemaphore(m_jobSemaphore);
+    }
+    if (m_spaceSemaphore)
+    {
+        MOS_DestroySemaphore(m_spaceSemaphore);
+    }
+    if (m_writerMutex)
+    {
+        MOS_DestroyMutex(m_writerMutex);
+    }
+    if (m_queueMutex)
+    {
+        MOS_DestroyMutex(m_queueMutex);
+    }
+}
+
+void *MosDumpService::AllocBuffer(uint32_t size)
+{
+    PMOS_DUMP_BUFFER  buffer  = nullptr;
+    PMOS_DUMP_BUFFER *bestRef = nullptr;
+    uint64_t          bytes   = sizeof(MOS_DUMP_BUFFER) + (uint64_t)size;
+
+    if (size == 0 || !m_queueMutex)
+    {
+        return nullptr;
+    }
+
+    MOS_LockMutex(m_queueMutex);
+
+    while (true)
+    {
+        // Best fit among the released buffers
+        bestRef = nullptr;
+        for (PMOS_DUMP_BUFFER *ref = &m_cached; *ref; ref = &(*ref)->pNext)
+        {
+            if ((*ref)->dwCapacity >= size &&
+                (!bestRef || (*ref)->dwCapacity < (*bestRef)->dwCapacity))
+            {
+                bestRef = ref;
+            }
+        }
+
+        if (bestRef)
+        {
+            buffer          = *bestRef;
+            *bestRef        = buffer->pNext;
+            m_cachedCount--;
+            break;
+        }
+
+        // Cached buffers are given up before new dumps are
+        if (m_poolUsage + bytes > m_poolBudget)
+        {
+            TrimCache(m_poolBudget > bytes ? m_poolBudget - bytes : 0);
+        }
+
+        // Without pending dumps the pool is held by the callers and nothing
+        // would free it, the budget is exceeded rather than waited for
+        if (m_poolUsage + bytes <= m_poolBudget || (!m_drop && m_pendingCount == 0))
+        {
+            buffer = (PMOS_DUMP_BUFFER)MOS_AllocMemory((size_t)bytes);
+            if (buffer)
+            {
+                buffer->dwCapacity  = size;
+                buffer->dwMagic     = MOS_DUMP_BUFFER_MAGIC;
+                m_poolUsage        += bytes;
+            }
+            break;
+        }
+
+        if (m_drop)
+        {
+            m_stats.uiDropped++;
+            m_stats.uiBytesDropped += size;
+            if (!m_dropReported)
+            {
+                MOS_OS_NORMALMESSAGE("Dump pool budget of %lld bytes exhausted, dumps are dropped.", (long long)m_poolBudget);
+                m_dropReported = true;
+            }
+            MOS_UnlockMutex(m_queueMutex);
+            return nullptr;
+        }
+
+        // Wait for the writer thread to release a buffer
+        m_spaceWaiters++;
+        MOS_UnlockMutex(m_queueMutex);
+        MOS_WaitSemaphore(m_spaceSemaphore, INFINITE);
+        MOS_LockMutex(m_queueMutex);
+    }
+
+    if (buffer)
+    {
+        buffer->pNext           = nullptr;
+        m_stats.uiPoolPeakUsage = MOS_MAX(m_stats.uiPoolPeakUsage, m_poolUsage);
+    }
+
+    MOS_UnlockMutex(m_queueMutex);
+
+    return buffer ? (void *)(buffer + 1) : nullptr;
+}
+
+void MosDumpService::FreeBuffer(void *buffer)
+{
+    if (buffer == nullptr)
+    {
+        return;
+    }
+
+    PMOS_DUMP_BUFFER header = (PMOS_DUMP_BUFFER)buffer - 1;
+    MOS_OS_ASSERT(header->dwMagic == MOS_DUMP_BUFFER_MAGIC);
+
+    MOS_LockMutex(m_queueMutex);
+    ReleaseBuffer(header);
+    MOS_UnlockMutex(m_queueMutex);
+}
+
+void MosDumpService::ReleaseBuffer(PMOS_DUMP_BUFFER buffer)
+{
+    buffer->pNext   = m_cached;
+    m_cached        = buffer;
+    m_cachedCount++;
+
+    if (m_cachedCount > MOS_DUMP_SERVICE_MAX_CACHED_BUFFERS)
+    {
+        TrimCache(m_poolBudget);
+    }
+
+    // All waiters check again, the space may fit only some of them
+    if (m_spaceWaiters)
+    {
+        MOS_PostSemaphore(m_spaceSemaphore, m_spaceWaiters);
+        m_spaceWaiters = 0;
+    }
+}
+
+void MosDumpService::TrimCache(uint64_t budget)
+{
+    // Drop the cached buffers from the oldest one, limiting both the pool usage
+    // and the number of cached buffers
+    while (m_cached &&
+           (m_poolUsage > budget || m_cachedCount > MOS_DUMP_SERVICE_MAX_CACHED_BUFFERS))
+    {
+        PMOS_DUMP_BUFFER *ref = &m_cached;
+        while ((*ref)->pNext)
+        {
+            ref = &(*ref)->pNext;
+        }
+
+        PMOS_DUMP_BUFFER oldest = *ref;
+        uint64_t         bytes  = sizeof(MOS_DUMP_BUFFER) + oldest->dwCapacity;
+        *ref            = nullptr;
+        m_cachedCount--;
+        m_poolUsage    -= bytes;
+        MOS_FreeMemory(oldest);
+    }
+}
+
+MOS_STATUS MosDumpService::Submit(
+    const char      *filename,
+    void            *buffer,
+    uint32_t        size,
+    MOS_DUMP_FORMAT format,
+    bool            append)
+{
+    PMOS_DUMP_BUFFER header;
+    PMOS_DUMP_JOB    job;
+    MOS_STATUS       eStatus = MOS_STATUS_SUCCESS;
+
+    MOS_OS_CHK_NULL_RETURN(buffer);
+    header = (PMOS_DUMP_BUFFER)buffer - 1;
+    MOS_OS_ASSERT(header->dwMagic == MOS_DUMP_BUFFER_MAGIC);
+
+    if (filename == nullptr || size == 0 || size > header->dwCapacity)
+    {
+        FreeBuffer(buffer);
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    job = (PMOS_DUMP_JOB)MOS_AllocAndZeroMemory(sizeof(MOS_DUMP_JOB));
+    if (job == nullptr)
+    {
+        FreeBuffer(buffer);
+        return MOS_STATUS_NO_SPACE;
+    }
+
+    job->pBuffer    = header;
+    job->dwSize     = size;
+    job->format     = format;
+    job->bAppend    = append;
+    MOS_SecureStrcpy(job->sFilename, sizeof(job->sFilename), filename);
+
+    MOS_LockMutex(m_queueMutex);
+    m_stats.uiSubmitted++;
+    m_stats.uiBytesSubmitted += size;
+    if (m_async)
+    {
+        if (m_jobTail)
+        {
+            m_jobTail->pNext = job;
+        }
+        else
+        {
+            m_jobHead = job;
+        }
+        m_jobTail = job;
+        m_pendingCount++;
+    }
+    MOS_UnlockMutex(m_queueMutex);
+
+    if (m_async)
+    {
+        return MOS_PostSemaphore(m_jobSemaphore, 1);
+    }
+
+    MOS_LockMutex(m_writerMutex);
+    eStatus = WriteJob(job);
+    CloseFile();
+    MOS_UnlockMutex(m_writerMutex);
+
+    MOS_LockMutex(m_queueMutex);
+    ReleaseBuffer(header);
+    MOS_UnlockMutex(m_queueMutex);
+    MOS_FreeMemory(job);
+
+    return eStatus;
+}
+
+MOS_STATUS MosDumpService::Flush()
+{
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+    if (m_async)
+    {
+        PMOS_DUMP_JOB job = (PMOS_DUMP_JOB)MOS_AllocAndZeroMemory(sizeof(MOS_DUMP_JOB));
+        MOS_OS_CHK_NULL_RETURN(job);
+
+        job->pFence = MOS_CreateSemaphore(0, 1);
+        if (job->pFence == nullptr)
+        {
+            MOS_FreeMemory(job);
+            return MOS_STATUS_UNKNOWN;
+        }
+
+        // The writer thread posts the fence and leaves the job to us
+        PMOS_SEMAPHORE fence = job->pFence;
+        MOS_LockMutex(m_queueMutex);
+        if (m_jobTail)
+        {
+            m_jobTail->pNext = job;
+        }
+        else
+        {
+            m_jobHead = job;
+        }
+        m_jobTail = job;
+        MOS_UnlockMutex(m_queueMutex);
+
+        MOS_PostSemaphore(m_jobSemaphore, 1);
+        eStatus = MOS_WaitSemaphore(fence, INFINITE);
+        MOS_DestroySemaphore(fence);
+        MOS_FreeMemory(job);
+    }
+
+    MOS_LockMutex(m_queueMutex);
+    TrimCache(0);
+    MOS_UnlockMutex(m_queueMutex);
+
+    return eStatus;
+}
+
+void MosDumpService::GetStatistics(PMOS_DUMP_STATISTICS statistics)
+{
+    MOS_LockMutex(m_queueMutex);
+    *statistics = m_stats;
+    MOS_UnlockMutex(m_queueMutex);
+}
+
+void *MosDumpService::WriterThread(void *context)
+{
+    ((MosDumpService *)context)->ProcessJobs();
+    return nullptr;
+}
+
+void MosDumpService::ProcessJobs()
+{
+    while (MOS_WaitSemaphore(m_jobSemaphore, INFINITE) == MOS_STATUS_SUCCESS)
+    {
+        PMOS_DUMP_JOB job;
+        bool          keepOpen = false;
+
+        MOS_LockMutex(m_queueMutex);
+        job = m_jobHead;
+        if (job)
+        {
+            m_jobHead = job->pNext;
+            if (m_jobHead == nullptr)
+            {
+                m_jobTail = nullptr;
+            }
+        }
+        MOS_UnlockMutex(m_queueMutex);
+
+        if (job == nullptr)
+        {
+            continue;
+        }
+
+        if (job->bExit || job->pFence)
+        {
+            MOS_LockMutex(m_writerMutex);
+            CloseFile();
+            MOS_UnlockMutex(m_writerMutex);
+
+            if (job->bExit)
+            {
+                MOS_FreeMemory(job);
+                break;
+            }
+            MOS_PostSemaphore(job->pFence, 1);
+            continue;
+        }
+
+        MOS_LockMutex(m_writerMutex);
+        WriteJob(job);
+
+        // Consecutive appends to the same file share one open handle and one
+        // write buffer
+        MOS_LockMutex(m_queueMutex);
+        keepOpen = m_jobHead &&
+                   m_jobHead->pBuffer &&
+                   m_jobHead->bAppend &&
+                   !strcmp(m_jobHead->sFilename, job->sFilename);
+        m_pendingCount--;
+        ReleaseBuffer(job->pBuffer);
+        MOS_UnlockMutex(m_queueMutex);
+
+        if (!keepOpen)
+        {
+            CloseFile();
+        }
+        MOS_UnlockMutex(m_writerMutex);
+
+        MOS_FreeMemory(job);
+    }
+}
+
+MOS_STATUS MosDumpService::WriteJob(PMOS_DUMP_JOB job)
+{
+    MOS_STATUS     eStatus = MOS_STATUS_SUCCESS;
+    const uint8_t *data    = (const uint8_t *)(job->pBuffer + 1);
+
+    if (!m_fileOpen || strcmp(m_filename, job->sFilename))
+    {
+        CloseFile();
+        eStatus = OpenFile(job->sFilename, job->bAppend);
+    }
+
+    if (eStatus == MOS_STATUS_SUCCESS)
+    {
+        if (job->format == MOS_DUMP_FORMAT_HEX_DWORDS)
+        {
+            eStatus = FormatHexDwords(data, job->dwSize);
+        }
+        else
+        {
+            eStatus = Output(data, job->dwSize);
+        }
+    }
+
+    MOS_LockMutex(m_queueMutex);
+    if (eStatus == MOS_STATUS_SUCCESS)
+    {
+        m_stats.uiWritten++;
+    }
+    else
+    {
+        m_stats.uiFailed++;
+    }
+    MOS_UnlockMutex(m_queueMutex);
+
+    if (eStatus != MOS_STATUS_SUCCESS)
+    {
+        MOS_OS_ASSERTMESSAGE("Failed to dump to file '%s'.", job->sFilename);
+        CloseFile();
+    }
+
+    return eStatus;
+}
+
+MOS_STATUS MosDumpService::OpenFile(const char *filename, bool append)
+{
+    char       path[MOS_MAX_PATH_LENGTH + sizeof(MOS_DUMP_SERVICE_LZ4_EXTENSION)];
+    uint32_t   flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+    MOS_STATUS eStatus;
+
+    if (m_writeBuffer == nullptr)
+    {
+        m_writeBuffer = (uint8_t *)MOS_AllocMemory(MOS_DUMP_SERVICE_WRITE_BUFFER_SIZE);
+        MOS_OS_CHK_NULL_RETURN(m_writeBuffer);
+    }
+
+    if (m_compress && m_block == nullptr)
+    {
+        m_block      = (uint8_t *)MOS_AllocMemory(MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE);
+        m_compressed = (uint8_t *)MOS_AllocMemory(MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE);
+        MOS_OS_CHK_NULL_RETURN(m_block);
+        MOS_OS_CHK_NULL_RETURN(m_compressed);
+    }
+
+    MOS_SecureStringPrint(path, sizeof(path), sizeof(path), "%s%s",
+        filename, m_compress ? MOS_DUMP_SERVICE_LZ4_EXTENSION : "");
+
+    eStatus = MOS_CreateFile(&m_file, path, flags);
+    if (eStatus != MOS_STATUS_SUCCESS)
+    {
+        return eStatus;
+    }
+
+    MOS_SecureStrcpy(m_filename, sizeof(m_filename), filename);
+    m_fileOpen  = true;
+    m_writeSize = 0;
+    m_blockSize = 0;
+
+    if (m_compress)
+    {
+        // Every open starts a new frame, appended frames are concatenated
+        const uint8_t frameHeader[] = {
+            MOS_DUMP_LZ4_MAGIC & 0xFF, (MOS_DUMP_LZ4_MAGIC >> 8) & 0xFF,
+            (MOS_DUMP_LZ4_MAGIC >> 16) & 0xFF, (MOS_DUMP_LZ4_MAGIC >> 24) & 0xFF,
+            MOS_DUMP_LZ4_FLG, MOS_DUMP_LZ4_BD, MOS_DUMP_LZ4_HC};
+        eStatus = EmitBytes(frameHeader, sizeof(frameHeader));
+    }
+
+    return eStatus;
+}
+
+MOS_STATUS MosDumpService::CloseFile()
+{
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+    if (!m_fileOpen)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    if (m_compress)
+    {
+        const uint8_t endMark[4] = {};
+
+        eStatus = EmitBlock();
+        if (eStatus == MOS_STATUS_SUCCESS)
+        {
+            eStatus = EmitBytes(endMark, sizeof(endMark));
+        }
+    }
+
+    if (eStatus == MOS_STATUS_SUCCESS)
+    {
+        eStatus = FlushWriteBuffer();
+    }
+
+    MOS_CloseHandle(m_file);
+    m_fileOpen  = false;
+    m_writeSize = 0;
+    m_blockSize = 0;
+
+    return eStatus;
+}
+
+MOS_STATUS MosDumpService::Output(const uint8_t *data, uint32_t size)
+{
+    if (!m_compress)
+    {
+        return EmitBytes(data, size);
+    }
+
+    while (size > 0)
+    {
+        uint32_t copySize = MOS_MIN(size, MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE - m_blockSize);
+
+        MOS_SecureMemcpy(m_block + m_blockSize, copySize, data, copySize);
+        m_blockSize += copySize;
+        data        += copySize;
+        size        -= copySize;
+
+        if (m_blockSize == MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE)
+        {
+            MOS_OS_CHK_STATUS_RETURN(EmitBlock());
+        }
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MosDumpService::EmitBlock()
+{
+    uint32_t       compressedSize;
+    uint32_t       blockHeader;
+    const uint8_t *payload;
+
+    if (m_blockSize == 0)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    compressedSize = CompressBlock(m_block, m_blockSize, m_compressed, m_blockSize - 1);
+    if (compressedSize)
+    {
+        blockHeader = compressedSize;
+        payload     = m_compressed;
+    }
+    else
+    {
+        // Incompressible data is stored as is
+        compressedSize = m_blockSize;
+        blockHeader    = m_blockSize | MOS_DUMP_LZ4_UNCOMPRESSED;
+        payload        = m_block;
+    }
+
+    const uint8_t header[4] = {
+        (uint8_t)blockHeader, (uint8_t)(blockHeader >> 8),
+        (uint8_t)(blockHeader >> 16), (uint8_t)(blockHeader >> 24)};
+
+    m_blockSize = 0;
+    MOS_OS_CHK_STATUS_RETURN(EmitBytes(header, sizeof(header)));
+    return EmitBytes(payload, compressedSize);
+}
+
+MOS_STATUS MosDumpService::EmitBytes(const uint8_t *data, uint32_t size)
+{
+    // Large payloads bypass the write buffer once it is drained
+    if (size >= MOS_DUMP_SERVICE_WRITE_BUFFER_SIZE)
+    {
+        uint32_t written = 0;
+
+        MOS_OS_CHK_STATUS_RETURN(FlushWriteBuffer());
+        MOS_OS_CHK_STATUS_RETURN(MOS_WriteFile(m_file, (void *)data, size, &written, nullptr));
+
+        MOS_LockMutex(m_queueMutex);
+        m_stats.uiBytesWritten += written;
+        MOS_UnlockMutex(m_queueMutex);
+
+        return (written == size) ? MOS_STATUS_SUCCESS : MOS_STATUS_FILE_WRITE_FAILED;
+    }
+
+    while (size > 0)
+    {
+        uint32_t copySize = MOS_MIN(size, MOS_DUMP_SERVICE_WRITE_BUFFER_SIZE - m_writeSize);
+
+        MOS_SecureMemcpy(m_writeBuffer + m_writeSize, copySize, data, copySize);
+        m_writeSize += copySize;
+        data        += copySize;
+        size        -= copySize;
+
+        if (m_writeSize == MOS_DUMP_SERVICE_WRITE_BUFFER_SIZE)
+        {
+            MOS_OS_CHK_STATUS_RETURN(FlushWriteBuffer());
+        }
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MosDumpService::FlushWriteBuffer()
+{
+    uint32_t written = 0;
+
+    if (m_writeSize == 0)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    MOS_OS_CHK_STATUS_RETURN(MOS_WriteFile(m_file, m_writeBuffer, m_writeSize, &written, nullptr));
+
+    MOS_LockMutex(m_queueMutex);
+    m_stats.uiBytesWritten += written;
+    MOS_UnlockMutex(m_queueMutex);
+
+    if (written != m_writeSize)
+    {
+        return MOS_STATUS_FILE_WRITE_FAILED;
+    }
+
+    m_writeSize = 0;
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MosDumpService::FormatHexDwords(const uint8_t *data, uint32_t size)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    char              text[MOS_DUMP_HEX_LINE_SIZE * 128];
+    uint32_t          textSize  = 0;
+    uint32_t          dwordSize = (size + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    for (uint32_t i = 0; i < dwordSize; i++)
+    {
+        uint32_t dword     = 0;
+        uint32_t remaining = size - i * sizeof(uint32_t);
+
+        // A trailing partial dword is zero padded
+        MOS_SecureMemcpy(&dword, sizeof(dword), data + i * sizeof(uint32_t), MOS_MIN(remaining, sizeof(uint32_t)));
+
+        for (int32_t shift = 28; shift >= 0; shift -= 4)
+        {
+            text[textSize++] = hexDigits[(dword >> shift) & 0xF];
+        }
+
+        if (remaining < sizeof(uint32_t))
+        {
+            text[textSize++] = '\n';
+            break;
+        }
+
+        text[textSize++] = ' ';
+        if (i % 4 == 3)
+        {
+            text[textSize++] = '\n';
+        }
+
+        if (textSize > sizeof(text) - MOS_DUMP_HEX_LINE_SIZE)
+        {
+            MOS_OS_CHK_STATUS_RETURN(Output((const uint8_t *)text, textSize));
+            textSize = 0;
+        }
+    }
+
+    return Output((const uint8_t *)text, textSize);
+}
+
+//!
+//! \brief    Greedy LZ4 block compressor
+//! \details  Produces a standard LZ4 block, decodable by any LZ4 decoder
+//! \return   uint32_t
+//!           Compressed size, 0 if the result does not fit in dstCapacity
+//!
+uint32_t MosDumpService::CompressBlock(
+    const uint8_t   *src,
+    uint32_t        srcSize,
+    uint8_t         *dst,
+    uint32_t        dstCapacity)
+{
+    uint32_t       hashTable[1 << MOS_DUMP_LZ4_HASH_LOG] = {};
+    const uint8_t *ip         = src;
+    const uint8_t *anchor     = src;
+    const uint8_t *end        = src + srcSize;
+    uint8_t       *op         = dst;
+    uint8_t       *opEnd      = dst + dstCapacity;
+    uint32_t       literalLen;
+
+    if (srcSize > MOS_DUMP_LZ4_MF_LIMIT)
+    {
+        const uint8_t *mfLimit    = end - MOS_DUMP_LZ4_MF_LIMIT;
+        const uint8_t *matchLimit = end - MOS_DUMP_LZ4_LAST_LITERALS;
+
+        while (ip < mfLimit)
+        {
+            uint32_t sequence;
+            uint32_t candidate;
+            uint32_t hash;
+
+            MOS_SecureMemcpy(&sequence, sizeof(sequence), ip, sizeof(sequence));
+            hash            = (sequence * 2654435761U) >> (32 - MOS_DUMP_LZ4_HASH_LOG);
+            candidate       = hashTable[hash];
+            hashTable[hash] = (uint32_t)(ip - src);
+
+            const uint8_t *ref = src + candidate;
+            if (ref >= ip || ip - ref > MOS_DUMP_LZ4_MAX_OFFSET || memcmp(ref, ip, MOS_DUMP_LZ4_MIN_MATCH))
+            {
+                ip++;
+                continue;
+            }
+
+            const uint8_t *matchEnd = ip + MOS_DUMP_LZ4_MIN_MATCH;
+            ref += MOS_DUMP_LZ4_MIN_MATCH;
+            while (matchEnd < matchLimit && *matchEnd == *ref)
+            {
+                matchEnd++;
+                ref++;
+            }
+
+            uint32_t matchLen = (uint32_t)(matchEnd - ip) - MOS_DUMP_LZ4_MIN_MATCH;
+            uint32_t offset   = (uint32_t)(matchEnd - ref);
+            literalLen        = (uint32_t)(ip - anchor);
+
+            if (op + 1 + literalLen / 255 + 1 + literalLen + 2 + matchLen / 255 + 1 > opEnd)
+            {
+                return 0;
+            }
+
+            uint8_t *token = op++;
+            *token = (uint8_t)(MOS_MIN(literalLen, 15) << 4);
+            if (literalLen >= 15)
+            {
+                uint32_t len = literalLen - 15;
+                for (; len >= 255; len -= 255)
+                {
+                    *op++ = 255;
+                }
+                *op++ = (uint8_t)len;
+            }
+            MOS_SecureMemcpy(op, literalLen, anchor, literalLen);
+            op += literalLen;
+
+            *op++ = (uint8_t)offset;
+            *op++ = (uint8_t)(offset >> 8);
+
+            *token |= (uint8_t)MOS_MIN(matchLen, 15);
+            if (matchLen >= 15)
+            {
+                uint32_t len = matchLen - 15;
+                for (; len >= 255; len -= 255)
+                {
+                    *op++ = 255;
+                }
+                *op++ = (uint8_t)len;
+            }
+
+            ip     = matchEnd;
+            anchor = ip;
+        }
+    }
+
+    // The block always ends with a literal run
+    literalLen = (uint32_t)(end - anchor);
+    if (op + 1 + literalLen / 255 + 1 + literalLen > opEnd)
+    {
+        return 0;
+    }
+
+    *op++ = (uint8_t)(MOS_MIN(literalLen, 15) << 4);
+    if (literalLen >= 15)
+    {
+        uint32_t len = literalLen - 15;
+        for (; len >= 255; len -= 255)
+        {
+            *op++ = 255;
+        }
+        *op++ = (uint8_t)len;
+    }
+    MOS_SecureMemcpy(op, literalLen, anchor, literalLen);
+    op += literalLen;
+
+    return (uint32_t)(op - dst);
+}
+
+void *MOS_DumpService_AllocBuffer(
+    uint32_t            dwSize)
+{
+    return MosDumpService::GetInstance()->AllocBuffer(dwSize);
+}
+
+void MOS_DumpService_FreeBuffer(
+    void                *pBuffer)
+{
+    MosDumpService::GetInstance()->FreeBuffer(pBuffer);
+}
+
+MOS_STATUS MOS_DumpService_Submit(
+    const char          *pFilename,
+    void                *pBuffer,
+    uint32_t            dwSize,
+    MOS_DUMP_FORMAT     format,
+    bool                bAppend)
+{
+    return MosDumpService::GetInstance()->Submit(pFilename, pBuffer, dwSize, format, bAppend);
+}
+
+MOS_STATUS MOS_DumpService_WriteFile(
+    const char          *pFilename,
+    const void          *pData,
+    uint32_t            dwSize,
+    MOS_DUMP_FORMAT     format)
+{
+    void *pBuffer;
+
+    MOS_OS_CHK_NULL_RETURN(pFilename);
+    MOS_OS_CHK_NULL_RETURN(pData);
+
+    if (dwSize == 0)
+    {
+        MOS_OS_ASSERTMESSAGE("Attempting to write 0 bytes to a file");
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    // A full pool drops the dump, which is not an error for the caller
+    pBuffer = MOS_DumpService_AllocBuffer(dwSize);
+    if (pBuffer == nullptr)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    // Dumped data is usually a locked GPU resource
+    MOS_FastMemCopy(pBuffer, pData, dwSize, MOS_MEMCOPY_SRC_UNCACHED);
+
+    return MOS_DumpService_Submit(pFilename, pBuffer, dwSize, format, false);
+}
+
+MOS_STATUS MOS_DumpService_Write2D(
+    const char          *pFilename,
+    const void          *pData,
+    uint32_t            dwWidth,
+    uint32_t            dwHeight,
+    uint32_t            dwPitch)
+{
+    uint8_t       *pBuffer;
+    uint64_t       size = (uint64_t)dwWidth * dwHeight;
+
+    MOS_OS_CHK_NULL_RETURN(pFilename);
+    MOS_OS_CHK_NULL_RETURN(pData);
+
+    if (size == 0 || size > UINT32_MAX || dwPitch < dwWidth)
+    {
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    pBuffer = (uint8_t *)MOS_DumpService_AllocBuffer((uint32_t)size);
+    if (pBuffer == nullptr)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    MOS_FastMemCopy2D(pBuffer, dwWidth, pData, dwPitch, dwWidth, dwHeight, MOS_MEMCOPY_SRC_UNCACHED);
+
+    return MOS_DumpService_Submit(pFilename, pBuffer, (uint32_t)size, MOS_DUMP_FORMAT_BINARY, false);
+}
+
+MOS_STATUS MOS_DumpService_Flush()
+{
+    return MosDumpService::GetInstance()->Flush();
+}
+
+MOS_STATUS MOS_DumpService_GetStatistics(
+    PMOS_DUMP_STATISTICS pStatistics)
+{
+    MOS_OS_CHK_NULL_RETURN(pStatistics);
+    MosDumpService::GetInstance()->GetStatistics(pStatistics);
+    return MOS_STATUS_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_dump_service.h
+//! \brief    Asynchronous file dump service used by the codec and VP debug tools
+//! \details  Callers snapshot the data to dump into a buffer taken from a bounded
+//!           pool and submit it. Formatting, optional LZ4 compression and the file
+//!           writes are done by a background thread, so the render thread only pays
+//!           for the snapshot copy. When the pool budget is exhausted new dumps wait
+//!           for the pending ones to be written, or are dropped and counted if the
+//!           "Media Async Dump Drop Enable" key is set.
+//!
+#ifndef __MOS_DUMP_SERVICE_H__
+#define __MOS_DUMP_SERVICE_H__
+
+#include "mos_defs.h"
+
+#define MOS_DUMP_SERVICE_DEFAULT_POOL_SIZE_MB   256         //!< Default budget of the snapshot pool
+#define MOS_DUMP_SERVICE_MAX_CACHED_BUFFERS     16          //!< Released buffers kept for reuse
+#define MOS_DUMP_SERVICE_WRITE_BUFFER_SIZE      (1 << 20)   //!< Staging size of the file writes
+#define MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE         (64 * 1024) //!< LZ4 frame block size
+#define MOS_DUMP_SERVICE_LZ4_EXTENSION          ".lz4"
+
+//!
+//! \brief    How the dumped data is written to the file
+//!
+typedef enum _MOS_DUMP_FORMAT
+{
+    MOS_DUMP_FORMAT_BINARY = 0,     //!< Raw bytes
+    MOS_DUMP_FORMAT_HEX_DWORDS      //!< Text, 4 hex dwords per line
+} MOS_DUMP_FORMAT;
+
+//!
+//! \brief    Counters of the dump service
+//!
+typedef struct _MOS_DUMP_STATISTICS
+{
+    uint64_t    uiSubmitted;        //!< Dumps accepted by the service
+    uint64_t    uiWritten;          //!< Dumps written to disk
+    uint64_t    uiDropped;          //!< Dumps dropped because the pool was full, if enabled
+    uint64_t    uiFailed;           //!< Dumps that could not be written
+    uint64_t    uiBytesSubmitted;   //!< Snapshot bytes accepted
+    uint64_t    uiBytesDropped;     //!< Snapshot bytes dropped
+    uint64_t    uiBytesWritten;     //!< Bytes written to disk after formatting and compression
+    uint64_t    uiPoolPeakUsage;    //!< Highest pool usage in bytes
+} MOS_DUMP_STATISTICS, *PMOS_DUMP_STATISTICS;
+
+//!
+//! \brief    Get a snapshot buffer from the dump pool
+//! \details  The content of the buffer is undefined. The buffer must be given back
+//!           with MOS_DumpService_Submit or MOS_DumpService_FreeBuffer. When the
+//!           pool budget is exhausted the call waits for pending dumps to be
+//!           written, unless dropping is enabled.
+//! \param    [in] dwSize
+//!           Size of the buffer in bytes
+//! \return   void *
+//!           Pointer to the buffer, nullptr if the allocation failed or the dump
+//!           was dropped
+//!
+void *MOS_DumpService_AllocBuffer(
+    uint32_t            dwSize);
+
+//!
+//! \brief    Give back a snapshot buffer without dumping it
+//! \param    [in] pBuffer
+//!           Buffer returned by MOS_DumpService_AllocBuffer, may be nullptr
+//!
+void MOS_DumpService_FreeBuffer(
+    void                *pBuffer);
+
+//!
+//! \brief    Queue a snapshot buffer for writing
+//! \details  Ownership of the buffer is transferred to the service in all cases.
+//!           Dumps are written in submission order. When asynchronous dumping is
+//!           disabled the buffer is written before returning.
+//! \param    [in] pFilename
+//!           Destination file, ".lz4" is appended when compression is enabled
+//! \param    [in] pBuffer
+//!           Buffer returned by MOS_DumpService_AllocBuffer
+//! \param    [in] dwSize
+//!           Number of valid bytes in the buffer
+//! \param    [in] format
+//!           Output format
+//! \param    [in] bAppend
+//!           Append to the file instead of replacing it
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if the dump was queued or written
+//!
+MOS_STATUS MOS_DumpService_Submit(
+    const char          *pFilename,
+    void                *pBuffer,
+    uint32_t            dwSize,
+    MOS_DUMP_FORMAT     format,
+    bool                bAppend);
+
+//!
+//! \brief    Snapshot a linear buffer and queue it for writing
+//! \details  Drop-in replacement of MOS_WriteFileFromPtr for debug dumps
+//! \param    [in] pFilename
+//!           Destination file
+//! \param    [in] pData
+//!           Data to dump
+//! \param    [in] dwSize
+//!           Number of bytes to dump
+//! \param    [in] format
+//!           Output format
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if the dump was queued, written or dropped
+//!
+MOS_STATUS MOS_DumpService_WriteFile(
+    const char          *pFilename,
+    const void          *pData,
+    uint32_t            dwSize,
+    MOS_DUMP_FORMAT     format);
+
+//!
+//! \brief    Snapshot a pitched 2D buffer and queue it for writing
+//! \details  Rows are packed, the pitch padding is not dumped
+//! \param    [in] pFilename
+//!           Destination file
+//! \param    [in] pData
+//!           First row
+//! \param    [in] dwWidth
+//!           Bytes per row to dump
+//! \param    [in] dwHeight
+//!           Number of rows
+//! \param    [in] dwPitch
+//!           Byte distance between rows
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if the dump was queued, written or dropped
+//!
+MOS_STATUS MOS_DumpService_Write2D(
+    const char          *pFilename,
+    const void          *pData,
+    uint32_t            dwWidth,
+    uint32_t            dwHeight,
+    uint32_t            dwPitch);
+
+//!
+//! \brief    Wait until all queued dumps are on disk
+//! \details  Also releases the cached pool buffers
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if success, else fail reason
+//!
+MOS_STATUS MOS_DumpService_Flush();
+
+//!
+//! \brief    Get the counters of the dump service
+//! \param    [out] pStatistics
+//!           Counters since the service was started
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if success, else fail reason
+//!
+MOS_STATUS MOS_DumpService_GetStatistics(
+    PMOS_DUMP_STATISTICS pStatistics);
+
+#endif // __MOS_DUMP_SERVICE_H__
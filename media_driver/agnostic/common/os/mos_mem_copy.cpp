@@ -0,0 +1,637 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_mem_copy.cpp
+//! \brief    CPU copy and fill of large buffers and GPU mappings
+//!
+
+#include "mos_mem_copy.h"
+#include "mos_task_pool.h"
+#include "mos_utilities.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MOS_MEMCOPY_X86     1
+#include <immintrin.h>
+#endif
+
+#define MOS_MEMCOPY_CHUNK_ALIGNMENT     4096    //!< Linear copies are split on page boundaries
+
+//! Copy kernels leave the fences around streaming loads and non-temporal stores to the caller
+typedef void (*PFN_MOS_MEMCOPY)(uint8_t *pDst, const uint8_t *pSrc, size_t size, bool bNonTemporal);
+typedef void (*PFN_MOS_MEMFILL)(uint8_t *pDst, uint32_t dwPattern, size_t size, bool bNonTemporal);
+
+//!
+//! \brief    Kernels selected for the CPU
+//!
+typedef struct _MOS_MEMCOPY_KERNELS
+{
+    MOS_CPU_SIMD_LEVEL  Level;
+    PFN_MOS_MEMCOPY     pfnCopy;            //!< Cached source
+    PFN_MOS_MEMCOPY     pfnCopyFromWC;      //!< Source read with streaming loads
+    PFN_MOS_MEMFILL     pfnFill;
+} MOS_MEMCOPY_KERNELS;
+
+//!
+//! \brief    Rows copied by one thread
+//!
+typedef struct _MOS_MEMCOPY_TASK
+{
+    uint8_t             *pDst;
+    const uint8_t       *pSrc;
+    size_t              dstPitch;
+    size_t              srcPitch;
+    size_t              width;
+    uint32_t            height;
+    uint32_t            flags;              //!< MOS_MEMCOPY_DST_UNCACHED also set for copies above the non-temporal threshold
+} MOS_MEMCOPY_TASK;
+
+//!
+//! \brief    Bytes to process before p is aligned, at most size
+//!
+static inline size_t MOS_MemCopy_HeadSize(const void *p, size_t alignment, size_t size)
+{
+    size_t head = (size_t)(0 - (uintptr_t)p) & (alignment - 1);
+    return (head < size) ? head : size;
+}
+
+//!
+//! \brief    Pattern seen from a position bytes further into the fill
+//!
+static inline uint32_t MOS_MemFill_Rotate(uint32_t dwPattern, size_t bytes)
+{
+    uint32_t shift = (uint32_t)(bytes & 3) * 8;
+    return shift ? ((dwPattern >> shift) | (dwPattern << (32 - shift))) : dwPattern;
+}
+
+static inline void MOS_MemFill_Bytes(uint8_t *pDst, uint32_t dwPattern, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        pDst[i] = (uint8_t)(dwPattern >> ((i & 3) * 8));
+    }
+}
+
+static void MOS_MemCopy_C(uint8_t *pDst, const uint8_t *pSrc, size_t size, bool bNonTemporal)
+{
+    MOS_UNUSED(bNonTemporal);
+    memcpy(pDst, pSrc, size);
+}
+
+static void MOS_MemFill_C(uint8_t *pDst, uint32_t dwPattern, size_t size, bool bNonTemporal)
+{
+    MOS_UNUSED(bNonTemporal);
+    for (; size >= sizeof(uint32_t); size -= sizeof(uint32_t), pDst += sizeof(uint32_t))
+    {
+        memcpy(pDst, &dwPattern, sizeof(uint32_t));
+    }
+    MOS_MemFill_Bytes(pDst, dwPattern, size);
+}
+
+#if MOS_MEMCOPY_X86
+
+__attribute__((target("sse2")))
+static void MOS_MemCopy_Sse2(uint8_t *pDst, const uint8_t *pSrc, size_t size, bool bNonTemporal)
+{
+    if (!bNonTemporal)
+    {
+        memcpy(pDst, pSrc, size);
+        return;
+    }
+
+    size_t head = MOS_MemCopy_HeadSize(pDst, 16, size);
+    memcpy(pDst, pSrc, head);
+    pDst += head;
+    pSrc += head;
+    size -= head;
+
+    for (; size >= 64; size -= 64, pDst += 64, pSrc += 64)
+    {
+        __m128i x0 = _mm_loadu_si128((const __m128i *)pSrc);
+        __m128i x1 = _mm_loadu_si128((const __m128i *)pSrc + 1);
+        __m128i x2 = _mm_loadu_si128((const __m128i *)pSrc + 2);
+        __m128i x3 = _mm_loadu_si128((const __m128i *)pSrc + 3);
+        _mm_stream_si128((__m128i *)pDst, x0);
+        _mm_stream_si128((__m128i *)pDst + 1, x1);
+        _mm_stream_si128((__m128i *)pDst + 2, x2);
+        _mm_stream_si128((__m128i *)pDst + 3, x3);
+    }
+    for (; size >= 16; size -= 16, pDst += 16, pSrc += 16)
+    {
+        _mm_stream_si128((__m128i *)pDst, _mm_loadu_si128((const __m128i *)pSrc));
+    }
+
+    memcpy(pDst, pSrc, size);
+}
+
+__attribute__((target("sse4.1")))
+static void MOS_MemCopyFromWC_Sse41(uint8_t *pDst, const uint8_t *pSrc, size_t size, bool bNonTemporal)
+{
+    // Streaming loads need an aligned source
+    size_t head = MOS_MemCopy_HeadSize(pSrc, 16, size);
+    memcpy(pDst, pSrc, head);
+    pDst += head;
+    pSrc += head;
+    size -= head;
+
+    bNonTemporal = bNonTemporal && ((uintptr_t)pDst & 15) == 0;
+
+    for (; size >= 64; size -= 64, pDst += 64, pSrc += 64)
+    {
+        __m128i x0 = _mm_stream_load_si128((__m128i *)pSrc);
+        __m128i x1 = _mm_stream_load_si128((__m128i *)pSrc + 1);
+        __m128i x2 = _mm_stream_load_si128((__m128i *)pSrc + 2);
+        __m128i x3 = _mm_stream_load_si128((__m128i *)pSrc + 3);
+        if (bNonTemporal)
+        {
+            _mm_stream_si128((__m128i *)pDst, x0);
+            _mm_stream_si128((__m128i *)pDst + 1, x1);
+            _mm_stream_si128((__m128i *)pDst + 2, x2);
+            _mm_stream_si128((__m128i *)pDst + 3, x3);
+        }
+        else
+        {
+            _mm_storeu_si128((__m128i *)pDst, x0);
+            _mm_storeu_si128((__m128i *)pDst + 1, x1);
+            _mm_storeu_si128((__m128i *)pDst + 2, x2);
+            _mm_storeu_si128((__m128i *)pDst + 3, x3);
+        }
+    }
+    for (; size >= 16; size -= 16, pDst += 16, pSrc += 16)
+    {
+        _mm_storeu_si128((__m128i *)pDst, _mm_stream_load_si128((__m128i *)pSrc));
+    }
+
+    memcpy(pDst, pSrc, size);
+}
+
+__attribute__((target("sse2")))
+static void MOS_MemFill_Sse2(uint8_t *pDst, uint32_t dwPattern, size_t size, bool bNonTemporal)
+{
+    size_t head = MOS_MemCopy_HeadSize(pDst, 16, size);
+    MOS_MemFill_Bytes(pDst, dwPattern, head);
+    pDst += head;
+    size -= head;
+
+    dwPattern = MOS_MemFill_Rotate(dwPattern, head);
+    __m128i x = _mm_set1_epi32((int)dwPattern);
+
+    if (bNonTemporal)
+    {
+        for (; size >= 16; size -= 16, pDst += 16)
+        {
+            _mm_stream_si128((__m128i *)pDst, x);
+        }
+        _mm_sfence();
+    }
+    else
+    {
+        for (; size >= 16; size -= 16, pDst += 16)
+        {
+            _mm_store_si128((__m128i *)pDst, x);
+        }
+    }
+
+    MOS_MemFill_Bytes(pDst, dwPattern, size);
+}
+
+__attribute__((target("avx2")))
+static void MOS_MemCopy_Avx2(uint8_t *pDst, const uint8_t *pSrc, size_t size, bool bNonTemporal)
+{
+    if (!bNonTemporal)
+    {
+        memcpy(pDst, pSrc, size);
+        return;
+    }
+
+    size_t head = MOS_MemCopy_HeadSize(pDst, 32, size);
+    memcpy(pDst, pSrc, head);
+    pDst += head;
+    pSrc += head;
+    size -= head;
+
+    for (; size >= 128; size -= 128, pDst += 128, pSrc += 128)
+    {
+        __m256i y0 = _mm256_loadu_si256((const __m256i *)pSrc);
+        __m256i y1 = _mm256_loadu_si256((const __m256i *)pSrc + 1);
+        __m256i y2 = _mm256_loadu_si256((const __m256i *)pSrc + 2);
+        __m256i y3 = _mm256_loadu_si256((const __m256i *)pSrc + 3);
+        _mm256_stream_si256((__m256i *)pDst, y0);
+        _mm256_stream_si256((__m256i *)pDst + 1, y1);
+        _mm256_stream_si256((__m256i *)pDst + 2, y2);
+        _mm256_stream_si256((__m256i *)pDst + 3, y3);
+    }
+    for (; size >= 32; size -= 32, pDst += 32, pSrc += 32)
+    {
+        _mm256_stream_si256((__m256i *)pDst, _mm256_loadu_si256((const __m256i *)pSrc));
+    }
+
+    memcpy(pDst, pSrc, size);
+}
+
+__attribute__((target("avx2")))
+static void MOS_MemCopyFromWC_Avx2(uint8_t *pDst, const uint8_t *pSrc, size_t size, bool bNonTemporal)
+{
+    size_t head = MOS_MemCopy_HeadSize(pSrc, 32, size);
+    memcpy(pDst, pSrc, head);
+    pDst += head;
+    pSrc += head;
+    size -= head;
+
+    bNonTemporal = bNonTemporal && ((uintptr_t)pDst & 31) == 0;
+
+    for (; size >= 128; size -= 128, pDst += 128, pSrc += 128)
+    {
+        __m256i y0 = _mm256_stream_load_si256((const __m256i *)pSrc);
+        __m256i y1 = _mm256_stream_load_si256((const __m256i *)pSrc + 1);
+        __m256i y2 = _mm256_stream_load_si256((const __m256i *)pSrc + 2);
+        __m256i y3 = _mm256_stream_load_si256((const __m256i *)pSrc + 3);
+        if (bNonTemporal)
+        {
+            _mm256_stream_si256((__m256i *)pDst, y0);
+            _mm256_stream_si256((__m256i *)pDst + 1, y1);
+            _mm256_stream_si256((__m256i *)pDst + 2, y2);
+            _mm256_stream_si256((__m256i *)pDst + 3, y3);
+        }
+        else
+        {
+            _mm256_storeu_si256((__m256i *)pDst, y0);
+            _mm256_storeu_si256((__m256i *)pDst + 1, y1);
+            _mm256_storeu_si256((__m256i *)pDst + 2, y2);
+            _mm256_storeu_si256((__m256i *)pDst + 3, y3);
+        }
+    }
+    for (; size >= 32; size -= 32, pDst += 32, pSrc += 32)
+    {
+        _mm256_storeu_si256((__m256i *)pDst, _mm256_stream_load_si256((const __m256i *)pSrc));
+    }
+
+    memcpy(pDst, pSrc, size);
+}
+
+__attribute__((target("avx2")))
+static void MOS_MemFill_Avx2(uint8_t *pDst, uint32_t dwPattern, size_t size, bool bNonTemporal)
+{
+    size_t head = MOS_MemCopy_HeadSize(pDst, 32, size);
+    MOS_MemFill_Bytes(pDst, dwPattern, head);
+    pDst += head;
+    size -= head;
+
+    dwPattern = MOS_MemFill_Rotate(dwPattern, head);
+    __m256i y = _mm256_set1_epi32((int)dwPattern);
+
+    if (bNonTemporal)
+    {
+        for (; size >= 32; size -= 32, pDst += 32)
+        {
+            _mm256_stream_si256((__m256i *)pDst, y);
+        }
+        _mm_sfence();
+    }
+    else
+    {
+        for (; size >= 32; size -= 32, pDst += 32)
+        {
+            _mm256_store_si256((__m256i *)pDst, y);
+        }
+    }
+
+    MOS_MemFill_Bytes(pDst, dwPattern, size);
+}
+
+__attribute__((target("avx512f")))
+static void MOS_MemCopy_Avx512(uint8_t *pDst, const uint8_t *pSrc, size_t size, bool bNonTemporal)
+{
+    if (!bNonTemporal)
+    {
+        memcpy(pDst, pSrc, size);
+        return;
+    }
+
+    size_t head = MOS_MemCopy_HeadSize(pDst, 64, size);
+    memcpy(pDst, pSrc, head);
+    pDst += head;
+    pSrc += head;
+    size -= head;
+
+    for (; size >= 256; size -= 256, pDst += 256, pSrc += 256)
+    {
+        __m512i z0 = _mm512_loadu_si512((const void *)pSrc);
+        __m512i z1 = _mm512_loadu_si512((const void *)(pSrc + 64));
+        __m512i z2 = _mm512_loadu_si512((const void *)(pSrc + 128));
+        __m512i z3 = _mm512_loadu_si512((const void *)(pSrc + 192));
+        _mm512_stream_si512((__m512i *)pDst, z0);
+        _mm512_stream_si512((__m512i *)(pDst + 64), z1);
+        _mm512_stream_si512((__m512i *)(pDst + 128), z2);
+        _mm512_stream_si512((__m512i *)(pDst + 192), z3);
+    }
+    for (; size >= 64; size -= 64, pDst += 64, pSrc += 64)
+    {
+        _mm512_stream_si512((__m512i *)pDst, _mm512_loadu_si512((const void *)pSrc));
+    }
+
+    memcpy(pDst, pSrc, size);
+}
+
+__attribute__((target("avx512f")))
+static void MOS_MemCopyFromWC_Avx512(uint8_t *pDst, const uint8_t *pSrc, size_t size, bool bNonTemporal)
+{
+    size_t head = MOS_MemCopy_HeadSize(pSrc, 64, size);
+    memcpy(pDst, pSrc, head);
+    pDst += head;
+    pSrc += head;
+    size -= head;
+
+    bNonTemporal = bNonTemporal && ((uintptr_t)pDst & 63) == 0;
+
+    for (; size >= 256; size -= 256, pDst += 256, pSrc += 256)
+    {
+        __m512i z0 = _mm512_stream_load_si512((void *)pSrc);
+        __m512i z1 = _mm512_stream_load_si512((void *)(pSrc + 64));
+        __m512i z2 = _mm512_stream_load_si512((void *)(pSrc + 128));
+        __m512i z3 = _mm512_stream_load_si512((void *)(pSrc + 192));
+        if (bNonTemporal)
+        {
+            _mm512_stream_si512((__m512i *)pDst, z0);
+            _mm512_stream_si512((__m512i *)(pDst + 64), z1);
+            _mm512_stream_si512((__m512i *)(pDst + 128), z2);
+            _mm512_stream_si512((__m512i *)(pDst + 192), z3);
+        }
+        else
+        {
+            _mm512_storeu_si512((void *)pDst, z0);
+            _mm512_storeu_si512((void *)(pDst + 64), z1);
+            _mm512_storeu_si512((void *)(pDst + 128), z2);
+            _mm512_storeu_si512((void *)(pDst + 192), z3);
+        }
+    }
+    for (; size >= 64; size -= 64, pDst += 64, pSrc += 64)
+    {
+        _mm512_storeu_si512((void *)pDst, _mm512_stream_load_si512((void *)pSrc));
+    }
+
+    memcpy(pDst, pSrc, size);
+}
+
+__attribute__((target("avx512f")))
+static void MOS_MemFill_Avx512(uint8_t *pDst, uint32_t dwPattern, size_t size, bool bNonTemporal)
+{
+    size_t head = MOS_MemCopy_HeadSize(pDst, 64, size);
+    MOS_MemFill_Bytes(pDst, dwPattern, head);
+    pDst += head;
+    size -= head;
+
+    dwPattern = MOS_MemFill_Rotate(dwPattern, head);
+    __m512i z = _mm512_set1_epi32((int)dwPattern);
+
+    if (bNonTemporal)
+    {
+        for (; size >= 64; size -= 64, pDst += 64)
+        {
+            _mm512_stream_si512((__m512i *)pDst, z);
+        }
+        _mm_sfence();
+    }
+    else
+    {
+        for (; size >= 64; size -= 64, pDst += 64)
+        {
+            _mm512_store_si512((void *)pDst, z);
+        }
+    }
+
+    MOS_MemFill_Bytes(pDst, dwPattern, size);
+}
+
+#endif // MOS_MEMCOPY_X86
+
+static MOS_MEMCOPY_KERNELS MOS_MemCopy_SelectKernels()
+{
+    MOS_MEMCOPY_KERNELS kernels = {MOS_CPU_SIMD_NONE, MOS_MemCopy_C, MOS_MemCopy_C, MOS_MemFill_C};
+
+#if MOS_MEMCOPY_X86
+    // __builtin_cpu_supports also checks that the OS saves the AVX and AVX-512 registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        kernels = {MOS_CPU_SIMD_AVX512, MOS_MemCopy_Avx512, MOS_MemCopyFromWC_Avx512, MOS_MemFill_Avx512};
+    }
+    else if (__builtin_cpu_supports("avx2"))
+    {
+        kernels = {MOS_CPU_SIMD_AVX2, MOS_MemCopy_Avx2, MOS_MemCopyFromWC_Avx2, MOS_MemFill_Avx2};
+    }
+    else if (__builtin_cpu_supports("sse4.1"))
+    {
+        kernels = {MOS_CPU_SIMD_SSE4_1, MOS_MemCopy_Sse2, MOS_MemCopyFromWC_Sse41, MOS_MemFill_Sse2};
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        kernels = {MOS_CPU_SIMD_SSE2, MOS_MemCopy_Sse2, MOS_MemCopy_Sse2, MOS_MemFill_Sse2};
+    }
+#endif
+
+    return kernels;
+}
+
+static const MOS_MEMCOPY_KERNELS *MOS_MemCopy_GetKernels()
+{
+    static const MOS_MEMCOPY_KERNELS kernels = MOS_MemCopy_SelectKernels();
+    return &kernels;
+}
+
+static void MOS_MemCopy_RunTask(const MOS_MEMCOPY_TASK *pTask)
+{
+    const MOS_MEMCOPY_KERNELS *pKernels = MOS_MemCopy_GetKernels();
+    PFN_MOS_MEMCOPY pfnCopy = (pTask->flags & MOS_MEMCOPY_SRC_UNCACHED) ? pKernels->pfnCopyFromWC : pKernels->pfnCopy;
+    bool bNonTemporal       = (pTask->flags & MOS_MEMCOPY_DST_UNCACHED) ? true : false;
+
+#if MOS_MEMCOPY_X86
+    // Order the streaming loads after earlier writes to the mapping
+    if (pTask->flags & MOS_MEMCOPY_SRC_UNCACHED)
+    {
+        _mm_mfence();
+    }
+#endif
+
+    uint8_t       *pDst = pTask->pDst;
+    const uint8_t *pSrc = pTask->pSrc;
+    for (uint32_t i = 0; i < pTask->height; i++)
+    {
+        pfnCopy(pDst, pSrc, pTask->width, bNonTemporal);
+        pDst += pTask->dstPitch;
+        pSrc += pTask->srcPitch;
+    }
+
+#if MOS_MEMCOPY_X86
+    if (bNonTemporal)
+    {
+        _mm_sfence();
+    }
+#endif
+}
+
+static void MOS_MemCopy_RunTaskAt(void *pContext, uint32_t index)
+{
+    MOS_MemCopy_RunTask((const MOS_MEMCOPY_TASK *)pContext + index);
+}
+
+//!
+//! \brief    Split a copy between the calling thread and the task pool workers
+//!
+static void MOS_MemCopy_RunParallel(const MOS_MEMCOPY_TASK *pTask)
+{
+    uint32_t         numTasks = MOS_MIN(MOS_TaskPool_GetThreadCount(), MOS_MEMCOPY_MAX_THREADS);
+    MOS_MEMCOPY_TASK tasks[MOS_MEMCOPY_MAX_THREADS];
+
+    if (pTask->height > 1)
+    {
+        numTasks = MOS_MIN(numTasks, pTask->height);
+        for (uint32_t i = 0; i < numTasks; i++)
+        {
+            uint32_t startRow = (uint32_t)((uint64_t)pTask->height * i / numTasks);
+            uint32_t endRow   = (uint32_t)((uint64_t)pTask->height * (i + 1) / numTasks);
+
+            tasks[i]        = *pTask;
+            tasks[i].pDst   = pTask->pDst + startRow * pTask->dstPitch;
+            tasks[i].pSrc   = pTask->pSrc + startRow * pTask->srcPitch;
+            tasks[i].height = endRow - startRow;
+        }
+    }
+    else
+    {
+        size_t chunk = MOS_ALIGN_CEIL(pTask->width / numTasks, MOS_MEMCOPY_CHUNK_ALIGNMENT);
+        size_t offset = 0;
+        uint32_t i;
+        for (i = 0; i < numTasks && offset < pTask->width; i++)
+        {
+            tasks[i]        = *pTask;
+            tasks[i].pDst   = pTask->pDst + offset;
+            tasks[i].pSrc   = pTask->pSrc + offset;
+            tasks[i].width  = MOS_MIN(chunk, pTask->width - offset);
+            offset         += tasks[i].width;
+        }
+        numTasks = i;
+    }
+
+    // Runs every task on this thread when the pool is in use
+    MOS_TaskPool_Run(MOS_MemCopy_RunTaskAt, tasks, numTasks, numTasks);
+}
+
+MOS_CPU_SIMD_LEVEL MOS_FastMemCopy_GetSimdLevel()
+{
+    return MOS_MemCopy_GetKernels()->Level;
+}
+
+void MOS_FastMemCopy(
+    void                *pDst,
+    const void          *pSrc,
+    size_t              size,
+    uint32_t            flags)
+{
+    MOS_FastMemCopy2D(pDst, size, pSrc, size, size, 1, flags);
+}
+
+void MOS_FastMemCopy2D(
+    void                *pDst,
+    size_t              dstPitch,
+    const void          *pSrc,
+    size_t              srcPitch,
+    size_t              widthInBytes,
+    uint32_t            height,
+    uint32_t            flags)
+{
+    if (pDst == nullptr || pSrc == nullptr || widthInBytes == 0 || height == 0)
+    {
+        return;
+    }
+
+    MOS_MEMCOPY_TASK task;
+    task.pDst       = (uint8_t *)pDst;
+    task.pSrc       = (const uint8_t *)pSrc;
+    task.dstPitch   = dstPitch;
+    task.srcPitch   = srcPitch;
+    task.width      = widthInBytes;
+    task.height     = height;
+    task.flags      = flags;
+
+    // Rows without padding on either side are one linear copy
+    if (height > 1 && dstPitch == widthInBytes && srcPitch == widthInBytes)
+    {
+        task.width    = widthInBytes * height;
+        task.dstPitch = task.width;
+        task.srcPitch = task.width;
+        task.height   = 1;
+    }
+
+    // The whole copy decides, rows of a large surface bypass the cache too
+    size_t size = widthInBytes * height;
+    if (size >= MOS_MEMCOPY_NON_TEMPORAL_THRESHOLD)
+    {
+        task.flags |= MOS_MEMCOPY_DST_UNCACHED;
+    }
+
+    if ((flags & MOS_MEMCOPY_PARALLEL) &&
+        size >= MOS_MEMCOPY_PARALLEL_THRESHOLD &&
+        MOS_TaskPool_GetThreadCount() > 1)
+    {
+        MOS_MemCopy_RunParallel(&task);
+        return;
+    }
+
+    MOS_MemCopy_RunTask(&task);
+}
+
+void MOS_FastMemFill(
+    void                *pDst,
+    uint8_t             value,
+    size_t              size,
+    uint32_t            flags)
+{
+    if (pDst == nullptr || size == 0)
+    {
+        return;
+    }
+
+    if (!(flags & MOS_MEMCOPY_DST_UNCACHED) && size < MOS_MEMCOPY_NON_TEMPORAL_THRESHOLD)
+    {
+        memset(pDst, value, size);
+        return;
+    }
+
+    MOS_MemCopy_GetKernels()->pfnFill((uint8_t *)pDst, value * 0x01010101u, size, true);
+}
+
+void MOS_FastMemFill32(
+    void                *pDst,
+    uint32_t            value,
+    size_t              size,
+    uint32_t            flags)
+{
+    size &= ~(size_t)(sizeof(uint32_t) - 1);
+    if (pDst == nullptr || size == 0)
+    {
+        return;
+    }
+
+    bool bNonTemporal = (flags & MOS_MEMCOPY_DST_UNCACHED) || size >= MOS_MEMCOPY_NON_TEMPORAL_THRESHOLD;
+    MOS_MemCopy_GetKernels()->pfnFill((uint8_t *)pDst, value, size, bNonTemporal);
+}
@@ -0,0 +1,162 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_mem_copy.h
+//! \brief    CPU copy and fill of large buffers and GPU mappings
+//! \details  The SSE2, SSE4.1, AVX2 or AVX-512 kernels are selected once with CPUID.
+//!           Cached copies below MOS_MEMCOPY_NON_TEMPORAL_THRESHOLD go to the C library,
+//!           larger ones and writes to WC/UC mappings use non-temporal stores, and reads
+//!           from WC/UC mappings use streaming loads. Copies above
+//!           MOS_MEMCOPY_PARALLEL_THRESHOLD can be split across the MOS task pool.
+//!
+#ifndef __MOS_MEM_COPY_H__
+#define __MOS_MEM_COPY_H__
+
+#include "mos_defs.h"
+
+#define MOS_MEMCOPY_NON_TEMPORAL_THRESHOLD  (2 << 20)   //!< Copies from this size on bypass the cache, about an L2
+#define MOS_MEMCOPY_PARALLEL_THRESHOLD      (4 << 20)   //!< Copies from this size on can be split across threads
+#define MOS_MEMCOPY_MAX_THREADS             4           //!< Calling thread included
+
+//!
+//! \brief    Hints about the buffers of a copy or fill
+//!
+typedef enum _MOS_MEMCOPY_FLAGS
+{
+    MOS_MEMCOPY_DEFAULT         = 0,
+    MOS_MEMCOPY_SRC_UNCACHED    = (1 << 0),     //!< Source is a WC or UC mapping, read it with streaming loads
+    MOS_MEMCOPY_DST_UNCACHED    = (1 << 1),     //!< Destination is a WC or UC mapping, always use non-temporal stores
+    MOS_MEMCOPY_PARALLEL        = (1 << 2)      //!< Large copies may be split across worker threads
+} MOS_MEMCOPY_FLAGS;
+
+//!
+//! \brief    Instruction set of the selected kernels
+//!
+typedef enum _MOS_CPU_SIMD_LEVEL
+{
+    MOS_CPU_SIMD_NONE = 0,
+    MOS_CPU_SIMD_SSE2,
+    MOS_CPU_SIMD_SSE4_1,
+    MOS_CPU_SIMD_AVX2,
+    MOS_CPU_SIMD_AVX512
+} MOS_CPU_SIMD_LEVEL;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//!
+//! \brief    Get the instruction set the copy and fill kernels were selected for
+//! \return   MOS_CPU_SIMD_LEVEL
+//!           Highest level supported by both the CPU and the OS
+//!
+MOS_CPU_SIMD_LEVEL MOS_FastMemCopy_GetSimdLevel();
+
+//!
+//! \brief    Copy a buffer
+//! \details  The buffers must not overlap
+//! \param    [out] pDst
+//!           Destination buffer
+//! \param    [in] pSrc
+//!           Source buffer
+//! \param    [in] size
+//!           Number of bytes to copy
+//! \param    [in] flags
+//!           Combination of MOS_MEMCOPY_FLAGS
+//! \return   void
+//!
+void MOS_FastMemCopy(
+    void                *pDst,
+    const void          *pSrc,
+    size_t              size,
+    uint32_t            flags);
+
+//!
+//! \brief    Copy a rectangle between two pitched buffers
+//! \details  Becomes a single linear copy when neither buffer has padding
+//! \param    [out] pDst
+//!           First row of the destination
+//! \param    [in] dstPitch
+//!           Destination pitch in bytes
+//! \param    [in] pSrc
+//!           First row of the source
+//! \param    [in] srcPitch
+//!           Source pitch in bytes
+//! \param    [in] widthInBytes
+//!           Bytes to copy per row
+//! \param    [in] height
+//!           Number of rows
+//! \param    [in] flags
+//!           Combination of MOS_MEMCOPY_FLAGS
+//! \return   void
+//!
+void MOS_FastMemCopy2D(
+    void                *pDst,
+    size_t              dstPitch,
+    const void          *pSrc,
+    size_t              srcPitch,
+    size_t              widthInBytes,
+    uint32_t            height,
+    uint32_t            flags);
+
+//!
+//! \brief    Fill a buffer with a byte value
+//! \param    [out] pDst
+//!           Destination buffer
+//! \param    [in] value
+//!           Byte value
+//! \param    [in] size
+//!           Number of bytes to fill
+//! \param    [in] flags
+//!           MOS_MEMCOPY_DST_UNCACHED or MOS_MEMCOPY_DEFAULT
+//! \return   void
+//!
+void MOS_FastMemFill(
+    void                *pDst,
+    uint8_t             value,
+    size_t              size,
+    uint32_t            flags);
+
+//!
+//! \brief    Fill a buffer with a dword value
+//! \details  Only whole dwords are written, trailing bytes of size are left untouched
+//! \param    [out] pDst
+//!           Destination buffer
+//! \param    [in] value
+//!           Dword value
+//! \param    [in] size
+//!           Size of the buffer in bytes
+//! \param    [in] flags
+//!           MOS_MEMCOPY_DST_UNCACHED or MOS_MEMCOPY_DEFAULT
+//! \return   void
+//!
+void MOS_FastMemFill32(
+    void                *pDst,
+    uint32_t            value,
+    size_t              size,
+    uint32_t            flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MOS_MEM_COPY_H__
@@ -83,6 +83,114 @@ MOS_STATUS Mos_AddCommand(
     return MOS_STATUS_SUCCESS;
 }
 
+#define MOS_STAGED_COMMAND_MAX_SIZE     1024    //!< Larger commands are always built in place
+
+//!
+//! \brief    Command staged by the calling thread
+//!
+typedef struct _MOS_STAGED_COMMAND
+{
+    void        *pTarget;                                                   //!< Position of the command in the buffer, nullptr if none
+    uint64_t    Data[MOS_STAGED_COMMAND_MAX_SIZE / sizeof(uint64_t)];
+} MOS_STAGED_COMMAND;
+
+static __thread MOS_STAGED_COMMAND gMosStagedCommand;
+
+void *Mos_StageCommand(
+    void                    *pTarget,
+    uint32_t                dwCmdSize,
+    bool                    bCachedTarget)
+{
+    if (bCachedTarget || dwCmdSize > MOS_STAGED_COMMAND_MAX_SIZE)
+    {
+        gMosStagedCommand.pTarget = nullptr;
+        return pTarget;
+    }
+
+    gMosStagedCommand.pTarget = pTarget;
+    return gMosStagedCommand.Data;
+}
+
+void Mos_UnstageCommand(
+    void                    *pTarget,
+    uint32_t                dwCmdSize)
+{
+    if (pTarget == nullptr || gMosStagedCommand.pTarget != pTarget)
+    {
+        return;
+    }
+
+    MOS_SecureMemcpy(pTarget, dwCmdSize, gMosStagedCommand.Data, dwCmdSize);
+    gMosStagedCommand.pTarget = nullptr;
+}
+
+//! \brief    Unified OS reserve space for a command in command buffer
+//! \details  Returns the space to build a command in if dwCmdSize bytes fit in the buffer,
+//!           without advancing it: the current write position of a cached mapping, a
+//!           cached area otherwise. The caller constructs the command there, patches
+//!           its resources (which still see the command at iOffset) and then calls
+//!           Mos_CommitCommand with the same size.
+//! \param    PMOS_COMMAND_BUFFER pCmdBuffer
+//!           [in] Pointer to Command Buffer
+//! \param    uint32_t dwCmdSize
+//!           [in] Size of command in bytes
+//! \return   void *
+//!           Pointer to the reserved space, nullptr if the buffer has no space left
+//!
+void *Mos_ReserveCommand(
+    PMOS_COMMAND_BUFFER     pCmdBuffer,
+    uint32_t                dwCmdSize)
+{
+    //---------------------------------------------
+    MOS_OS_ASSERT(pCmdBuffer);
+    //---------------------------------------------
+
+    if (pCmdBuffer->iRemaining < (int32_t)MOS_ALIGN_CEIL(dwCmdSize, sizeof(uint32_t)))
+    {
+        MOS_OS_ASSERTMESSAGE("Unable to reserve command (no space).");
+        return nullptr;
+    }
+
+    return Mos_StageCommand(pCmdBuffer->pCmdPtr, dwCmdSize, pCmdBuffer->bCachedMapping);
+}
+
+//! \brief    Unified OS commit a command reserved by Mos_ReserveCommand
+//! \details  Copies a command built out of place to the buffer and advances the
+//!           command buffer past it
+//! \param    PMOS_COMMAND_BUFFER pCmdBuffer
+//!           [in/out] Pointer to Command Buffer
+//! \param    uint32_t dwCmdSize
+//!           [in] Size of command in bytes
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if successful, otherwise failed
+//!
+MOS_STATUS Mos_CommitCommand(
+    PMOS_COMMAND_BUFFER     pCmdBuffer,
+    uint32_t                dwCmdSize)
+{
+    uint32_t dwCmdSizeDwAligned;
+
+    //---------------------------------------------
+    MOS_OS_ASSERT(pCmdBuffer);
+    //---------------------------------------------
+
+    dwCmdSizeDwAligned = MOS_ALIGN_CEIL(dwCmdSize, sizeof(uint32_t));
+
+    pCmdBuffer->iOffset    += dwCmdSizeDwAligned;
+    pCmdBuffer->iRemaining -= dwCmdSizeDwAligned;
+
+    if (pCmdBuffer->iRemaining < 0)
+    {
+        MOS_OS_ASSERTMESSAGE("Unable to commit command (no space).");
+        return MOS_STATUS_UNKNOWN;
+    }
+
+    Mos_UnstageCommand(pCmdBuffer->pCmdPtr, dwCmdSize);
+    pCmdBuffer->pCmdPtr += (dwCmdSizeDwAligned / sizeof(uint32_t));
+
+    return MOS_STATUS_SUCCESS;
+}
+
 //!
 //! \brief    Unified OS fill Resource
 //! \details  Locks the surface and fills the resource with data
@@ -182,6 +182,7 @@ typedef struct _MOS_COMMAND_BUFFER
     int32_t             iRemaining;                 //!< Remaining size
     int32_t             iTokenOffsetInCmdBuf;       //!< Pointer to (Un)Secure token's next field Offset
     int32_t             iCmdIndex;                  //!< command buffer's index
+    bool                bCachedMapping;             //!< pCmdBase is a CPU cached mapping, commands may be built in place
 
     MOS_COMMAND_BUFFER_ATTRIBUTES Attributes;       //!< Attributes for the command buffer to be provided to KMD at submission
 } MOS_COMMAND_BUFFER;
@@ -536,6 +537,10 @@ typedef struct _MOS_INTERFACE
         PMOS_INTERFACE              pOsInterface,
         PMOS_RESOURCE               pResource);
 
+    bool (* pfnIsLockCached) (
+        PMOS_INTERFACE              pOsInterface,
+        PMOS_RESOURCE               pResource);
+
     MOS_STATUS (* pfnDecompResource) (
         PMOS_INTERFACE              pOsInterface,
         PMOS_RESOURCE               pResource);
@@ -833,6 +838,61 @@ MOS_STATUS Mos_AddCommand(
     const void          *pCmd,
     uint32_t            dwCmdSize);
 
+//! \brief    Unified OS reserve space for a command in command buffer
+//! \details  Returns the current write position without advancing the buffer,
+//!           the command built there is added by Mos_CommitCommand
+//! \param    PMOS_COMMAND_BUFFER pCmdBuffer
+//!           [in] Pointer to Command Buffer
+//! \param    uint32_t dwCmdSize
+//!           [in] Size of command in bytes
+//! \return   void *
+//!           Pointer to the reserved space, nullptr if the buffer has no space left
+//!
+void *Mos_ReserveCommand(
+    PMOS_COMMAND_BUFFER pCmdBuffer,
+    uint32_t            dwCmdSize);
+
+//! \brief    Unified OS commit a command reserved by Mos_ReserveCommand
+//! \param    PMOS_COMMAND_BUFFER pCmdBuffer
+//!           [in/out] Pointer to Command Buffer
+//! \param    uint32_t dwCmdSize
+//!           [in] Size of command in bytes
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if successful, otherwise failed
+//!
+MOS_STATUS Mos_CommitCommand(
+    PMOS_COMMAND_BUFFER pCmdBuffer,
+    uint32_t            dwCmdSize);
+
+//! \brief    Get the space to build a command in before it is copied to a buffer
+//! \details  Commands written field by field into a write-combined or GTT mapping
+//!           are slow to build, they are built in a cached area of the calling thread
+//!           instead and copied with Mos_UnstageCommand
+//! \param    void *pTarget
+//!           [in] Position of the command in the buffer
+//! \param    uint32_t dwCmdSize
+//!           [in] Size of command in bytes
+//! \param    bool bCachedTarget
+//!           [in] The buffer is a CPU cached mapping
+//! \return   void *
+//!           Space to build the command in, pTarget if it is built in place
+//!
+void *Mos_StageCommand(
+    void                *pTarget,
+    uint32_t            dwCmdSize,
+    bool                bCachedTarget);
+
+//! \brief    Copy a command staged by Mos_StageCommand to its position in the buffer
+//! \param    void *pTarget
+//!           [in] Position of the command in the buffer
+//! \param    uint32_t dwCmdSize
+//!           [in] Size of command in bytes
+//! \return   void
+//!
+void Mos_UnstageCommand(
+    void                *pTarget,
+    uint32_t            dwCmdSize);
+
 #if !EMUL
 //!
 //! \brief    Get memory object based on resource usage
@@ -0,0 +1,174 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_sw_tiling.cpp
+//! \brief    Software conversion between tiled and linear surface layouts
+//!
+
+#include "mos_sw_tiling.h"
+#include <string.h>
+
+bool MOS_SwTiling_IsSupported(
+    MOS_TILE_TYPE       TileType,
+    uint32_t            dwPitch)
+{
+    switch (TileType)
+    {
+        case MOS_TILE_X:
+            return (dwPitch != 0) && (dwPitch % MOS_SW_TILING_X_TILE_WIDTH == 0);
+        case MOS_TILE_Y:
+            return (dwPitch != 0) && (dwPitch % MOS_SW_TILING_Y_TILE_WIDTH == 0);
+        default:
+            return false;
+    }
+}
+
+uint32_t MOS_SwTiling_GetTileHeight(
+    MOS_TILE_TYPE       TileType)
+{
+    switch (TileType)
+    {
+        case MOS_TILE_X:
+            return MOS_SW_TILING_X_TILE_HEIGHT;
+        case MOS_TILE_Y:
+            return MOS_SW_TILING_Y_TILE_HEIGHT;
+        default:
+            return 0;
+    }
+}
+
+uint32_t MOS_SwTiling_GetRowCount(
+    MOS_TILE_TYPE       TileType,
+    uint32_t            dwPitch,
+    uint64_t            uiSize)
+{
+    uint32_t dwTileHeight = MOS_SwTiling_GetTileHeight(TileType);
+
+    if (dwTileHeight == 0 || dwPitch == 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)(uiSize / ((uint64_t)dwPitch * dwTileHeight)) * dwTileHeight;
+}
+
+void MOS_SwTiling_Detile(
+    const uint8_t       *pTiled,
+    uint8_t             *pLinear,
+    MOS_TILE_TYPE       TileType,
+    uint32_t            dwPitch,
+    uint32_t            dwRows)
+{
+    // The tiled surface is read sequentially, it is the side that is not in the CPU caches
+    if (TileType == MOS_TILE_Y)
+    {
+        uint32_t dwTiles = dwPitch / MOS_SW_TILING_Y_TILE_WIDTH;
+
+        for (uint32_t y = 0; y < dwRows; y += MOS_SW_TILING_Y_TILE_HEIGHT)
+        {
+            uint8_t *pBand = pLinear + (size_t)y * dwPitch;
+            for (uint32_t t = 0; t < dwTiles; t++)
+            {
+                for (uint32_t c = 0; c < MOS_SW_TILING_Y_TILE_WIDTH; c += MOS_SW_TILING_Y_COLUMN_WIDTH)
+                {
+                    uint8_t *pDst = pBand + t * MOS_SW_TILING_Y_TILE_WIDTH + c;
+                    for (uint32_t r = 0; r < MOS_SW_TILING_Y_TILE_HEIGHT; r++)
+                    {
+                        memcpy(pDst, pTiled, MOS_SW_TILING_Y_COLUMN_WIDTH);
+                        pTiled += MOS_SW_TILING_Y_COLUMN_WIDTH;
+                        pDst   += dwPitch;
+                    }
+                }
+            }
+        }
+    }
+    else if (TileType == MOS_TILE_X)
+    {
+        uint32_t dwTiles = dwPitch / MOS_SW_TILING_X_TILE_WIDTH;
+
+        for (uint32_t y = 0; y < dwRows; y += MOS_SW_TILING_X_TILE_HEIGHT)
+        {
+            uint8_t *pBand = pLinear + (size_t)y * dwPitch;
+            for (uint32_t t = 0; t < dwTiles; t++)
+            {
+                uint8_t *pDst = pBand + t * MOS_SW_TILING_X_TILE_WIDTH;
+                for (uint32_t r = 0; r < MOS_SW_TILING_X_TILE_HEIGHT; r++)
+                {
+                    memcpy(pDst, pTiled, MOS_SW_TILING_X_TILE_WIDTH);
+                    pTiled += MOS_SW_TILING_X_TILE_WIDTH;
+                    pDst   += dwPitch;
+                }
+            }
+        }
+    }
+}
+
+void MOS_SwTiling_Retile(
+    const uint8_t       *pLinear,
+    uint8_t             *pTiled,
+    MOS_TILE_TYPE       TileType,
+    uint32_t            dwPitch,
+    uint32_t            dwRows)
+{
+    // The tiled surface is written sequentially, as it was read by MOS_SwTiling_Detile
+    if (TileType == MOS_TILE_Y)
+    {
+        uint32_t dwTiles = dwPitch / MOS_SW_TILING_Y_TILE_WIDTH;
+
+        for (uint32_t y = 0; y < dwRows; y += MOS_SW_TILING_Y_TILE_HEIGHT)
+        {
+            const uint8_t *pBand = pLinear + (size_t)y * dwPitch;
+            for (uint32_t t = 0; t < dwTiles; t++)
+            {
+                for (uint32_t c = 0; c < MOS_SW_TILING_Y_TILE_WIDTH; c += MOS_SW_TILING_Y_COLUMN_WIDTH)
+                {
+                    const uint8_t *pSrc = pBand + t * MOS_SW_TILING_Y_TILE_WIDTH + c;
+                    for (uint32_t r = 0; r < MOS_SW_TILING_Y_TILE_HEIGHT; r++)
+                    {
+                        memcpy(pTiled, pSrc, MOS_SW_TILING_Y_COLUMN_WIDTH);
+                        pTiled += MOS_SW_TILING_Y_COLUMN_WIDTH;
+                        pSrc   += dwPitch;
+                    }
+                }
+            }
+        }
+    }
+    else if (TileType == MOS_TILE_X)
+    {
+        uint32_t dwTiles = dwPitch / MOS_SW_TILING_X_TILE_WIDTH;
+
+        for (uint32_t y = 0; y < dwRows; y += MOS_SW_TILING_X_TILE_HEIGHT)
+        {
+            const uint8_t *pBand = pLinear + (size_t)y * dwPitch;
+            for (uint32_t t = 0; t < dwTiles; t++)
+            {
+                const uint8_t *pSrc = pBand + t * MOS_SW_TILING_X_TILE_WIDTH;
+                for (uint32_t r = 0; r < MOS_SW_TILING_X_TILE_HEIGHT; r++)
+                {
+                    memcpy(pTiled, pSrc, MOS_SW_TILING_X_TILE_WIDTH);
+                    pTiled += MOS_SW_TILING_X_TILE_WIDTH;
+                    pSrc   += dwPitch;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_sw_tiling.h
+//! \brief    Software conversion between tiled and linear surface layouts
+//! \details  Used to give the CPU a linear view of X and Y tiled surfaces through a
+//!           cached staging copy instead of a fenced GTT mapping. The linear copy
+//!           uses the pitch of the tiled surface, so plane offsets are unchanged.
+//!           Bit 6 address swizzling is not handled.
+//!
+#ifndef __MOS_SW_TILING_H__
+#define __MOS_SW_TILING_H__
+
+#include "mos_defs.h"
+#include "mos_resource_defs.h"
+
+#define MOS_SW_TILING_TILE_SIZE         4096    //!< Bytes per X or Y tile
+#define MOS_SW_TILING_X_TILE_WIDTH      512     //!< X tile: 512 bytes x 8 rows
+#define MOS_SW_TILING_X_TILE_HEIGHT     8
+#define MOS_SW_TILING_Y_TILE_WIDTH      128     //!< Y tile: 8 columns of 16 bytes x 32 rows
+#define MOS_SW_TILING_Y_TILE_HEIGHT     32
+#define MOS_SW_TILING_Y_COLUMN_WIDTH    16
+
+//!
+//! \brief    Check if a layout can be converted in software
+//! \param    [in] TileType
+//!           Tiling of the surface
+//! \param    [in] dwPitch
+//!           Surface pitch in bytes
+//! \return   bool
+//!           true if the tiling is X or Y and the pitch is a whole number of tiles
+//!
+bool MOS_SwTiling_IsSupported(
+    MOS_TILE_TYPE       TileType,
+    uint32_t            dwPitch);
+
+//!
+//! \brief    Get the number of rows of one tile
+//! \param    [in] TileType
+//!           Tiling of the surface
+//! \return   uint32_t
+//!           Tile height, 0 if the tiling is not supported
+//!
+uint32_t MOS_SwTiling_GetTileHeight(
+    MOS_TILE_TYPE       TileType);
+
+//!
+//! \brief    Get the number of whole tile rows held by an allocation
+//! \param    [in] TileType
+//!           Tiling of the surface
+//! \param    [in] dwPitch
+//!           Surface pitch in bytes
+//! \param    [in] uiSize
+//!           Size of the allocation in bytes
+//! \return   uint32_t
+//!           Number of surface rows, a multiple of the tile height
+//!
+uint32_t MOS_SwTiling_GetRowCount(
+    MOS_TILE_TYPE       TileType,
+    uint32_t            dwPitch,
+    uint64_t            uiSize);
+
+//!
+//! \brief    Convert tiled rows to linear rows
+//! \param    [in] pTiled
+//!           Start of the tiled surface
+//! \param    [out] pLinear
+//!           Start of the linear copy, dwPitch * dwRows bytes
+//! \param    [in] TileType
+//!           Tiling of the surface, must be supported
+//! \param    [in] dwPitch
+//!           Surface pitch in bytes
+//! \param    [in] dwRows
+//!           Number of rows, a multiple of the tile height
+//!
+void MOS_SwTiling_Detile(
+    const uint8_t       *pTiled,
+    uint8_t             *pLinear,
+    MOS_TILE_TYPE       TileType,
+    uint32_t            dwPitch,
+    uint32_t            dwRows);
+
+//!
+//! \brief    Convert linear rows back to tiled rows
+//! \param    [in] pLinear
+//!           Start of the linear copy
+//! \param    [out] pTiled
+//!           Start of the tiled surface
+//! \param    [in] TileType
+//!           Tiling of the surface, must be supported
+//! \param    [in] dwPitch
+//!           Surface pitch in bytes
+//! \param    [in] dwRows
+//!           Number of rows, a multiple of the tile height
+//!
+void MOS_SwTiling_Retile(
+    const uint8_t       *pLinear,
+    uint8_t             *pTiled,
+    MOS_TILE_TYPE       TileType,
+    uint32_t            dwPitch,
+    uint32_t            dwRows);
+
+#endif // __MOS_SW_TILING_H__
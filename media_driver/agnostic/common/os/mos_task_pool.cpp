@@ -0,0 +1,284 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_task_pool.cpp
+//! \brief    Small pool of worker threads shared by the CPU side of the driver
+//!
+
+#include "mos_task_pool.h"
+#include "mos_utilities.h"
+#include <atomic>
+
+//!
+//! \brief    Worker threads and the run they are working on
+//! \details  Owned by the thread that sets bBusy, other callers run their tasks on their own thread
+//!
+typedef struct _MOS_TASK_POOL
+{
+    bool                    bBusy;              //!< Owned by a run or by close, guarded by gMosTaskPoolMutex
+    PMOS_SEMAPHORE          pIdle;              //!< Posted when the owner releases the pool, set by a waiting close
+    bool                    bStarted;
+    bool                    bExit;
+    uint32_t                numWorkers;
+    PMOS_SEMAPHORE          pStart;             //!< Posted once per worker joining a run
+    PMOS_SEMAPHORE          pDone;              //!< Posted once per worker leaving a run
+    MOS_THREADHANDLE        hThreads[MOS_TASK_POOL_MAX_THREADS - 1];
+
+    PFN_MOS_TASK            pfnTask;
+    void                    *pContext;
+    uint32_t                count;
+    std::atomic<uint32_t>   next;               //!< Next task index to pick up
+} MOS_TASK_POOL;
+
+static MOS_TASK_POOL        gMosTaskPool;
+static MOS_MUTEX            gMosTaskPoolMutex = MOS_MUTEX_INITIALIZER;
+
+//!
+//! \brief    Take the pool if no other run or close owns it
+//! \return   bool
+//!           true if the caller owns the pool
+//!
+static bool MOS_TaskPool_TryAcquire(MOS_TASK_POOL *pPool)
+{
+    bool bOwned;
+
+    MOS_LockMutex(&gMosTaskPoolMutex);
+    bOwned = !pPool->bBusy;
+    pPool->bBusy = true;
+    MOS_UnlockMutex(&gMosTaskPoolMutex);
+
+    return bOwned;
+}
+
+//!
+//! \brief    Give the pool back, waking up a close waiting for it
+//!
+static void MOS_TaskPool_Release(MOS_TASK_POOL *pPool)
+{
+    MOS_LockMutex(&gMosTaskPoolMutex);
+    pPool->bBusy = false;
+    if (pPool->pIdle)
+    {
+        MOS_PostSemaphore(pPool->pIdle, 1);
+        pPool->pIdle = nullptr;
+    }
+    MOS_UnlockMutex(&gMosTaskPoolMutex);
+}
+
+//!
+//! \brief    Run tasks of the current run until none are left
+//!
+static void MOS_TaskPool_Drain(MOS_TASK_POOL *pPool)
+{
+    uint32_t index;
+    while ((index = pPool->next.fetch_add(1, std::memory_order_relaxed)) < pPool->count)
+    {
+        pPool->pfnTask(pPool->pContext, index);
+    }
+}
+
+static void *MOS_TaskPool_WorkerThread(void *pData)
+{
+    MOS_TASK_POOL *pPool = (MOS_TASK_POOL *)pData;
+
+    while (true)
+    {
+        if (MOS_WaitSemaphore(pPool->pStart, INFINITE) != MOS_STATUS_SUCCESS)
+        {
+            continue;
+        }
+        if (pPool->bExit)
+        {
+            break;
+        }
+
+        MOS_TaskPool_Drain(pPool);
+        MOS_PostSemaphore(pPool->pDone, 1);
+    }
+
+    return nullptr;
+}
+
+//!
+//! \brief    Start the workers on first use, must be called with the pool owned
+//! \return   bool
+//!           true if there is at least one worker
+//!
+static bool MOS_TaskPool_Start(MOS_TASK_POOL *pPool)
+{
+    if (pPool->bStarted)
+    {
+        return pPool->numWorkers > 0;
+    }
+    pPool->bStarted = true;
+
+    uint32_t numThreads = MOS_TaskPool_GetThreadCount();
+    if (numThreads < 2)
+    {
+        return false;
+    }
+
+    pPool->pStart = MOS_CreateSemaphore(0, numThreads - 1);
+    pPool->pDone  = MOS_CreateSemaphore(0, numThreads - 1);
+    if (pPool->pStart == nullptr || pPool->pDone == nullptr)
+    {
+        // Run serially until the pool is closed, without keeping a half created pool
+        if (pPool->pStart)
+        {
+            MOS_DestroySemaphore(pPool->pStart);
+            pPool->pStart = nullptr;
+        }
+        if (pPool->pDone)
+        {
+            MOS_DestroySemaphore(pPool->pDone);
+            pPool->pDone = nullptr;
+        }
+        return false;
+    }
+
+    for (uint32_t i = 0; i < numThreads - 1; i++)
+    {
+        pPool->hThreads[pPool->numWorkers] = MOS_CreateThread((void *)MOS_TaskPool_WorkerThread, pPool);
+        if (!pPool->hThreads[pPool->numWorkers])
+        {
+            break;
+        }
+        pPool->numWorkers++;
+    }
+
+    return pPool->numWorkers > 0;
+}
+
+uint32_t MOS_TaskPool_GetThreadCount()
+{
+    static const uint32_t numThreads = MOS_MAX(1, MOS_MIN(MOS_GetLogicalCoreNumber(), MOS_TASK_POOL_MAX_THREADS));
+    return numThreads;
+}
+
+MOS_STATUS MOS_TaskPool_Run(
+    PFN_MOS_TASK        pfnTask,
+    void                *pContext,
+    uint32_t            count,
+    uint32_t            maxThreads)
+{
+    MOS_OS_CHK_NULL_RETURN(pfnTask);
+
+    MOS_TASK_POOL *pPool   = &gMosTaskPool;
+    bool           bOwned  = false;
+    uint32_t       helpers = 0;
+
+    if (count > 1 && maxThreads > 1)
+    {
+        bOwned = MOS_TaskPool_TryAcquire(pPool);
+    }
+
+    if (bOwned && MOS_TaskPool_Start(pPool))
+    {
+        helpers = MOS_MIN(MOS_MIN(pPool->numWorkers, maxThreads - 1), count - 1);
+    }
+
+    if (helpers == 0)
+    {
+        if (bOwned)
+        {
+            MOS_TaskPool_Release(pPool);
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            pfnTask(pContext, i);
+        }
+        return MOS_STATUS_SUCCESS;
+    }
+
+    pPool->pfnTask  = pfnTask;
+    pPool->pContext = pContext;
+    pPool->count    = count;
+    pPool->next.store(0, std::memory_order_relaxed);
+
+    MOS_PostSemaphore(pPool->pStart, helpers);
+    MOS_TaskPool_Drain(pPool);
+
+    for (uint32_t i = 0; i < helpers; i++)
+    {
+        while (MOS_WaitSemaphore(pPool->pDone, INFINITE) != MOS_STATUS_SUCCESS);
+    }
+
+    pPool->pfnTask  = nullptr;
+    pPool->pContext = nullptr;
+    MOS_TaskPool_Release(pPool);
+
+    return MOS_STATUS_SUCCESS;
+}
+
+void MOS_TaskPool_Close()
+{
+    MOS_TASK_POOL *pPool = &gMosTaskPool;
+
+    // Nothing should be running when the last instance closes, wait for it anyway
+    MOS_LockMutex(&gMosTaskPoolMutex);
+    while (pPool->bBusy)
+    {
+        PMOS_SEMAPHORE pIdle = MOS_CreateSemaphore(0, 1);
+        pPool->pIdle = pIdle;
+        MOS_UnlockMutex(&gMosTaskPoolMutex);
+
+        if (pIdle)
+        {
+            MOS_WaitSemaphore(pIdle, INFINITE);
+            MOS_DestroySemaphore(pIdle);
+        }
+        else
+        {
+            MOS_Sleep(1);
+        }
+
+        MOS_LockMutex(&gMosTaskPoolMutex);
+    }
+    pPool->bBusy = true;
+    MOS_UnlockMutex(&gMosTaskPoolMutex);
+
+    pPool->bExit = true;
+    if (pPool->numWorkers)
+    {
+        MOS_PostSemaphore(pPool->pStart, pPool->numWorkers);
+    }
+    for (uint32_t i = 0; i < pPool->numWorkers; i++)
+    {
+        MOS_WaitThread(pPool->hThreads[i]);
+        pPool->hThreads[i] = 0;
+    }
+    if (pPool->pStart)
+    {
+        MOS_DestroySemaphore(pPool->pStart);
+        pPool->pStart = nullptr;
+    }
+    if (pPool->pDone)
+    {
+        MOS_DestroySemaphore(pPool->pDone);
+        pPool->pDone = nullptr;
+    }
+    pPool->numWorkers = 0;
+    pPool->bStarted   = false;
+    pPool->bExit      = false;
+
+    MOS_TaskPool_Release(pPool);
+}
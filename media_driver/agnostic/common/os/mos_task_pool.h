@@ -0,0 +1,91 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_task_pool.h
+//! \brief    Small pool of worker threads shared by the CPU side of the driver
+//! \details  A run splits work into indexed tasks that the calling thread and the
+//!           workers pick up until none are left. Only one run uses the workers at
+//!           a time, a concurrent run executes all its tasks on its own thread.
+//!
+#ifndef __MOS_TASK_POOL_H__
+#define __MOS_TASK_POOL_H__
+
+#include "mos_defs.h"
+
+#define MOS_TASK_POOL_MAX_THREADS       8       //!< Calling thread included
+
+//!
+//! \brief    Task callback
+//! \details  Called once for every index of a run, in no particular order and
+//!           possibly from several threads at the same time
+//! \param    [in] pContext
+//!           Context passed to MOS_TaskPool_Run
+//! \param    [in] index
+//!           Task index, from 0 to the task count minus one
+//!
+typedef void (*PFN_MOS_TASK)(void *pContext, uint32_t index);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//!
+//! \brief    Get the number of threads a run can use
+//! \return   uint32_t
+//!           Calling thread included, 1 when tasks always run on the calling thread
+//!
+uint32_t MOS_TaskPool_GetThreadCount();
+
+//!
+//! \brief    Run tasks on the calling thread and the workers
+//! \details  Returns once every task has completed. The workers are started
+//!           by the first run that needs them.
+//! \param    [in] pfnTask
+//!           Task callback
+//! \param    [in] pContext
+//!           Context passed to every task
+//! \param    [in] count
+//!           Number of tasks
+//! \param    [in] maxThreads
+//!           Maximum number of threads to use, calling thread included
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if all the tasks ran, MOS_STATUS_NULL_POINTER if pfnTask is null
+//!
+MOS_STATUS MOS_TaskPool_Run(
+    PFN_MOS_TASK        pfnTask,
+    void                *pContext,
+    uint32_t            count,
+    uint32_t            maxThreads);
+
+//!
+//! \brief    Stop the worker threads
+//! \details  Called when the last MOS utilities instance is closed, the threads
+//!           are started again by the next run
+//! \return   void
+//!
+void MOS_TaskPool_Close();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MOS_TASK_POOL_H__
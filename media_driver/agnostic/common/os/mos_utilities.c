@@ -94,6 +94,60 @@ static MOS_USER_FEATURE_VALUE MOSUserFeatureDescFields[__MOS_USER_FEATURE_KEY_MA
      MOS_USER_FEATURE_VALUE_TYPE_INT32,
      "0",
      "Disable KMD Watchdog"),
+    MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_PERSISTENT_MAPPING_ENABLE_ID,
+     "Persistent Mapping Enable",
+     __MEDIA_USER_FEATURE_SUBKEY_PERFORMANCE,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "General",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_INT32,
+     "0",
+     "Keep the CPU mappings of linear buffers across lock/unlock on LLC platforms."),
+    MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_PERSISTENT_MAPPING_BUDGET_ID,
+     "Persistent Mapping Budget",
+     __MEDIA_USER_FEATURE_SUBKEY_PERFORMANCE,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "General",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "64",
+     "Size in MB of the persistently mapped buffers. Least recently locked buffers are unmapped beyond it."),
+    MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_TILED_LOCK_STAGING_ENABLE_ID,
+     "Tiled Lock Staging Enable",
+     __MEDIA_USER_FEATURE_SUBKEY_PERFORMANCE,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "General",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_INT32,
+     "1",
+     "Read tiled surfaces of up to 8MB locked read only by the CPU through a write-back mapping and a software detiled copy instead of a GTT mapping."),
+    MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_BO_CACHE_MAX_SIZE_ID,
+     "BO Cache Max Size",
+     __MEDIA_USER_FEATURE_SUBKEY_PERFORMANCE,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "General",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "256",
+     "Size in MB of the largest buffer kept for reuse after it is freed."),
+    MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_BO_CACHE_BUDGET_ID,
+     "BO Cache Budget",
+     __MEDIA_USER_FEATURE_SUBKEY_PERFORMANCE,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "General",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "512",
+     "Size in MB of the freed buffers kept for reuse. Least recently freed buffers are released beyond it, 0 for no limit. Buffers unused for a second are always released."),
+    MOS_DECLARE_UF_KEY(__MEDIA_USER_FEATURE_VALUE_SHARED_KERNEL_HEAP_ENABLE_ID,
+     "Shared Kernel Heap Enable",
+     __MEDIA_USER_FEATURE_SUBKEY_PERFORMANCE,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "General",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_INT32,
+     "0",
+     "Load the render kernels of all the video processing contexts of a device into one instruction heap, each kernel once."),
     MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_SINGLE_TASK_PHASE_ENABLE_ID,
      "Single Task Phase Enable",
      __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
@@ -1537,6 +1591,42 @@ MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_ENCODE_BRC_SOFTWARE_ID,
      MOS_USER_FEATURE_VALUE_TYPE_STRING,
      "",
      "Directory where all CodecHal debug interface can locate cfg file and dump."),
+    MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_ENABLE_ID,
+     "Media Async Dump Enable",
+     __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "Media",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "1",
+     "Write codec and VP debug dumps from a background thread."),
+    MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_POOL_SIZE_ID,
+     "Media Async Dump Pool Size",
+     __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "Media",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "256",
+     "Memory budget in MB of the pending debug dumps. Dumps beyond the budget wait for the pending ones to be written."),
+    MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_COMPRESSION_ID,
+     "Media Async Dump Compression",
+     __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "Media",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "0",
+     "Compress debug dumps to .lz4 files."),
+    MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_DROP_ENABLE_ID,
+     "Media Async Dump Drop Enable",
+     __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
+     __MEDIA_USER_FEATURE_SUBKEY_REPORT,
+     "Media",
+     MOS_USER_FEATURE_TYPE_USER,
+     MOS_USER_FEATURE_VALUE_TYPE_UINT32,
+     "0",
+     "Drop debug dumps when the dump pool budget is exhausted instead of waiting for the pending dumps to be written."),
      MOS_DECLARE_UF_KEY_DBGONLY(__MEDIA_USER_FEATURE_VALUE_HUC_DEMO_KERNEL_ID, // Used to indicate which huc kernel to load for the Huc Demo feature
      "Media Huc Demo kernel Id",
      __MEDIA_USER_FEATURE_SUBKEY_INTERNAL,
@@ -113,6 +113,12 @@ typedef enum _MOS_USER_FEATURE_VALUE_ID
     __MEDIA_USER_FEATURE_VALUE_FORCE_VDBOX_ID,
     __MEDIA_USER_FEATURE_VALUE_LINUX_PERFORMANCETAG_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_DISABLE_KMD_WATCHDOG_ID,
+    __MEDIA_USER_FEATURE_VALUE_PERSISTENT_MAPPING_ENABLE_ID,
+    __MEDIA_USER_FEATURE_VALUE_PERSISTENT_MAPPING_BUDGET_ID,
+    __MEDIA_USER_FEATURE_VALUE_TILED_LOCK_STAGING_ENABLE_ID,
+    __MEDIA_USER_FEATURE_VALUE_BO_CACHE_MAX_SIZE_ID,
+    __MEDIA_USER_FEATURE_VALUE_BO_CACHE_BUDGET_ID,
+    __MEDIA_USER_FEATURE_VALUE_SHARED_KERNEL_HEAP_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_SINGLE_TASK_PHASE_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_MFE_MBENC_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_RC_PANIC_ENABLE_ID,
@@ -276,6 +282,10 @@ typedef enum _MOS_USER_FEATURE_VALUE_ID
     __MEDIA_USER_FEATURE_VALUE_MEDIASOLO_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_STREAM_OUT_ENABLE_ID,
     __MEDIA_USER_FEATURE_VALUE_CODECHAL_DEBUG_OUTPUT_DIRECTORY_ID,
+    __MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_ENABLE_ID,
+    __MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_POOL_SIZE_ID,
+    __MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_COMPRESSION_ID,
+    __MEDIA_USER_FEATURE_VALUE_ASYNC_DUMP_DROP_ENABLE_ID,
 
 #endif // (_DEBUG || _RELEASE_INTERNAL)
     __MEDIA_USER_FEATURE_VALUE_STATUS_REPORTING_ENABLE_ID,
@@ -31,6 +31,7 @@
 #include "renderhal_platform_interface.h"
 #include "media_interfaces_renderhal.h"
 #include "media_interfaces_mhw.h"
+#include "mos_mem_copy.h"
 
 extern const SURFACE_STATE_TOKEN_COMMON g_cInit_SURFACE_STATE_TOKEN_COMMON =
 {
@@ -923,6 +924,96 @@ void RenderHal_GetPixelsPerSample(
     }
 }
 
+//!
+//! \brief    Set Surface State Entry
+//! \details  Setup the surface state of a slot in the current SSH instance.
+//!           The surface state is copied from the cache when the slot was last
+//!           encoded with the same params, MHW encodes it otherwise.
+//! \param    PRENDERHAL_INTERFACE pRenderHal
+//!           [in] Pointer to Hardware Interface Structure
+//! \param    int32_t iSurfStateID
+//!           [in] Surface state slot
+//! \param    PMHW_SURFACE_STATE_PARAMS pParams
+//!           [in/out] Surface state params, returns the address to patch
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if success. Error code otherwise
+//!
+MOS_STATUS RenderHal_SetSurfaceStateEntry(
+    PRENDERHAL_INTERFACE        pRenderHal,
+    int32_t                     iSurfStateID,
+    PMHW_SURFACE_STATE_PARAMS   pParams)
+{
+    PRENDERHAL_STATE_HEAP                pStateHeap;
+    PRENDERHAL_SURFACE_STATE_CACHE_ENTRY pCacheEntry;
+    const uint8_t                        *pKey;
+    uint8_t                              *pSurfaceState;
+    uint32_t                             dwStateSize;
+    MOS_STATUS                           eStatus;
+
+    //-----------------------------------------
+    MHW_RENDERHAL_CHK_NULL(pRenderHal);
+    MHW_RENDERHAL_CHK_NULL(pParams);
+    MHW_RENDERHAL_CHK_NULL(pParams->pSurfaceState);
+    MHW_RENDERHAL_CHK_NULL(pRenderHal->pStateHeap);
+    MHW_RENDERHAL_CHK_NULL(pRenderHal->pHwSizes);
+    MHW_RENDERHAL_CHK_NULL(pRenderHal->pMhwStateHeap);
+    //-----------------------------------------
+
+    eStatus     = MOS_STATUS_UNKNOWN;
+    pStateHeap  = pRenderHal->pStateHeap;
+    dwStateSize = (pParams->bUseAdvState) ? pRenderHal->pHwSizes->dwSizeSurfaceStateAvs :
+                                            pRenderHal->pHwSizes->dwSizeSurfaceState;
+
+    // Encode in place if the slot or the surface state is not covered by the cache
+    if (pStateHeap->pSurfaceStateCache == nullptr                           ||
+        iSurfStateID < 0                                                    ||
+        iSurfStateID >= pRenderHal->StateHeapSettings.iSurfaceStates        ||
+        dwStateSize > RENDERHAL_SURFACE_STATE_CACHE_STATE_SIZE)
+    {
+        MHW_RENDERHAL_CHK_STATUS(pRenderHal->pMhwStateHeap->SetSurfaceStateEntry(pParams));
+        goto finish;
+    }
+
+    pCacheEntry = &pStateHeap->pSurfaceStateCache[iSurfStateID];
+    pKey        = (const uint8_t*)pParams + RENDERHAL_SURFACE_STATE_CACHE_KEY_OFFSET;
+
+    if (!pCacheEntry->bValid                    ||
+        pCacheEntry->dwStateSize != dwStateSize ||
+        memcmp(pCacheEntry->Key, pKey, RENDERHAL_SURFACE_STATE_CACHE_KEY_SIZE))
+    {
+        // Encode in the cache entry, the surface address is patched in the SSH copy
+        pSurfaceState           = pParams->pSurfaceState;
+        pParams->pSurfaceState  = pCacheEntry->SurfaceState;
+        pCacheEntry->bValid     = false;
+        MOS_ZeroMemory(pCacheEntry->SurfaceState, sizeof(pCacheEntry->SurfaceState));
+
+        eStatus = pRenderHal->pMhwStateHeap->SetSurfaceStateEntry(pParams);
+        pParams->pSurfaceState  = pSurfaceState;
+        MHW_RENDERHAL_CHK_STATUS(eStatus);
+
+        pCacheEntry->bValid          = true;
+        pCacheEntry->dwStateSize     = dwStateSize;
+        pCacheEntry->dwPatchOffset   = (uint32_t)((uint8_t*)pParams->pdwCmd - pCacheEntry->SurfaceState);
+        pCacheEntry->dwLocationInCmd = pParams->dwLocationInCmd;
+        MOS_SecureMemcpy(pCacheEntry->Key, sizeof(pCacheEntry->Key), pKey, RENDERHAL_SURFACE_STATE_CACHE_KEY_SIZE);
+
+        pStateHeap->dwSurfaceStateCacheMisses++;
+    }
+    else
+    {
+        pStateHeap->dwSurfaceStateCacheHits++;
+    }
+
+    MOS_SecureMemcpy(pParams->pSurfaceState, dwStateSize, pCacheEntry->SurfaceState, dwStateSize);
+    pParams->pdwCmd          = (uint32_t*)(pParams->pSurfaceState + pCacheEntry->dwPatchOffset);
+    pParams->dwLocationInCmd = pCacheEntry->dwLocationInCmd;
+
+    eStatus = MOS_STATUS_SUCCESS;
+
+finish:
+    return eStatus;
+}
+
 //!
 //! \brief    Allocate GSH, SSH, ISH control structures and heaps
 //! \details  Allocates State Heap control structure (system memory)
@@ -1168,6 +1259,7 @@ MOS_STATUS RenderHal_AllocateStateHeaps(
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iMediaStateHeaps * sizeof(RENDERHAL_MEDIA_STATE)        , 16);
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iMediaStateHeaps * pSettings->iMediaIDs * sizeof(int32_t)   , 16);
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iSurfaceStates   * sizeof(RENDERHAL_SURFACE_STATE_ENTRY), 16);
+    dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iSurfaceStates   * sizeof(RENDERHAL_SURFACE_STATE_CACHE_ENTRY), 16);
 
     // Allocate State Heap control structure (aligned)
     pRenderHal->pStateHeap = pStateHeap = (PRENDERHAL_STATE_HEAP)MOS_AlignedAllocMemory(dwSizeAlloc, 16);
@@ -1212,6 +1304,10 @@ MOS_STATUS RenderHal_AllocateStateHeaps(
 
     // Pointer to Surface State allocations
     pStateHeap->pSurfaceEntry = (PRENDERHAL_SURFACE_STATE_ENTRY) ptr;
+    ptr += MOS_ALIGN_CEIL(pSettings->iSurfaceStates * sizeof(RENDERHAL_SURFACE_STATE_ENTRY), 16);
+
+    // Pointer to encoded Surface State cache
+    pStateHeap->pSurfaceStateCache = (PRENDERHAL_SURFACE_STATE_CACHE_ENTRY) ptr;
 
     //-------------------------------------------------------------------------
     // Calculate offsets/sizes in GSH
@@ -1363,6 +1459,23 @@ MOS_STATUS RenderHal_AllocateStateHeaps(
 
     pStateHeap->dwSizeISH = dwSizeISH;
 
+    // Kernels go to the ISH shared by the instances of the device, private ISH otherwise
+    if (pRenderHal->bSharedKernelHeap)
+    {
+        pStateHeap->pSharedIsh = RenderHal_SharedIsh_Attach(
+            pRenderHal->pOsInterface,
+            pSettings->iKernelHeapSize,
+            pSettings->iKernelBlockSize,
+            pSettings->iSipSize);
+    }
+
+    if (pStateHeap->pSharedIsh)
+    {
+        pStateHeap->dwSipBase                = pStateHeap->pSharedIsh->dwSipBase;
+        pRenderHal->SipStateParams.dwSipBase = pStateHeap->pSharedIsh->dwSipBase;
+        pStateHeap->dwSizeISH                = pStateHeap->pSharedIsh->dwSize;
+    }
+
     //----------------------------------
     // Surface State Heap
     //----------------------------------
@@ -1405,7 +1518,7 @@ MOS_STATUS RenderHal_AllocateStateHeaps(
     //----------------------------------
     MOS_ZeroMemory(&MhwStateHeapSettings, sizeof(MhwStateHeapSettings));
     MhwStateHeapSettings.dwDshSize     = pStateHeap->dwSizeGSH;
-    MhwStateHeapSettings.dwIshSize     = pStateHeap->dwSizeISH;
+    MhwStateHeapSettings.dwIshSize     = pStateHeap->pSharedIsh ? MHW_PAGE_SIZE : pStateHeap->dwSizeISH;
     MhwStateHeapSettings.dwNumSyncTags = pStateHeap->dwSizeSync;
 
     MHW_RENDERHAL_CHK_STATUS(pRenderHal->pMhwRenderInterface->AllocateHeaps(MhwStateHeapSettings));
@@ -1417,11 +1530,22 @@ MOS_STATUS RenderHal_AllocateStateHeaps(
     pStateHeap->pGshBuffer    = (uint8_t*)pDshHeap->pvLockedHeap;
     pStateHeap->bGshLocked    = true;
 
-    pIshHeap = pRenderHal->pMhwStateHeap->GetISHPointer();
-    MHW_RENDERHAL_CHK_STATUS(pRenderHal->pMhwStateHeap->LockStateHeap(pIshHeap));
-    pStateHeap->IshOsResource = pIshHeap->resHeap;
-    pStateHeap->pIshBuffer    = (uint8_t*)pIshHeap->pvLockedHeap;
-    pStateHeap->bIshLocked    = true;
+    if (pStateHeap->pSharedIsh)
+    {
+        // The shared ISH stays mapped for its lifetime
+        pStateHeap->IshOsResource = pStateHeap->pSharedIsh->OsResource;
+        pRenderHal->pOsInterface->pfnResetResourceAllocationIndex(pRenderHal->pOsInterface, &pStateHeap->IshOsResource);
+        pStateHeap->pIshBuffer    = pStateHeap->pSharedIsh->pBuffer;
+        pStateHeap->bIshLocked    = true;
+    }
+    else
+    {
+        pIshHeap = pRenderHal->pMhwStateHeap->GetISHPointer();
+        MHW_RENDERHAL_CHK_STATUS(pRenderHal->pMhwStateHeap->LockStateHeap(pIshHeap));
+        pStateHeap->IshOsResource = pIshHeap->resHeap;
+        pStateHeap->pIshBuffer    = (uint8_t*)pIshHeap->pvLockedHeap;
+        pStateHeap->bIshLocked    = true;
+    }
 
     //-----------------------------
     // Heap initialization
@@ -1449,6 +1573,12 @@ finish:
                 MOS_FreeMemory(pStateHeap->pSshBuffer);
             }
 
+            // No kernel was loaded yet
+            if (pStateHeap->pSharedIsh)
+            {
+                RenderHal_SharedIsh_Detach(pRenderHal->pOsInterface, pStateHeap->pSharedIsh);
+            }
+
             // Free State Heap control structure
             MOS_AlignedFreeMemory(pStateHeap);
             pRenderHal->pStateHeap = nullptr;
@@ -1468,9 +1598,12 @@ finish:
 //!
 MOS_STATUS RenderHal_FreeStateHeaps(PRENDERHAL_INTERFACE pRenderHal)
 {
-    PMOS_INTERFACE        pOsInterface;
-    PRENDERHAL_STATE_HEAP pStateHeap;
-    MOS_STATUS            eStatus;
+    PMOS_INTERFACE            pOsInterface;
+    PRENDERHAL_STATE_HEAP     pStateHeap;
+    PRENDERHAL_KRN_ALLOCATION pKernelAllocation;
+    bool                      bIdle;
+    int32_t                   i;
+    MOS_STATUS                eStatus;
 
     //------------------------------------------------
     MHW_RENDERHAL_CHK_NULL(pRenderHal);
@@ -1490,6 +1623,34 @@ MOS_STATUS RenderHal_FreeStateHeaps(PRENDERHAL_INTERFACE pRenderHal)
         pStateHeap->pSshBuffer = nullptr;
     }
 
+    // Release the kernels in the shared ISH once the GPU completed the work of the instance.
+    // The sync tag is written at the start of a submission and cannot tell when the last one completed,
+    // wait for the GSH referenced by every submission instead. Blocks are only left unused on timeout.
+    if (pStateHeap->pSharedIsh)
+    {
+        bIdle = RenderHal_SharedIsh_WaitIdle(pOsInterface, &pStateHeap->GshOsResource, RENDERHAL_SHARED_ISH_IDLE_TIMEOUT_MS);
+        if (!bIdle)
+        {
+            MHW_RENDERHAL_ASSERTMESSAGE("GPU did not complete, kernels of the instance are not released to the shared ISH.");
+        }
+
+        pKernelAllocation = pStateHeap->pKernelAllocation;
+        for (i = 0; i < pRenderHal->StateHeapSettings.iKernelCount; i++, pKernelAllocation++)
+        {
+            if (pKernelAllocation->iSharedBlock >= 0)
+            {
+                RenderHal_SharedIsh_UnloadKernel(pStateHeap->pSharedIsh, pKernelAllocation->iSharedBlock, bIdle);
+                pKernelAllocation->iSharedBlock = -1;
+            }
+        }
+
+        RenderHal_SharedIsh_Detach(pOsInterface, pStateHeap->pSharedIsh);
+        pStateHeap->pSharedIsh = nullptr;
+    }
+
+    MHW_RENDERHAL_NORMALMESSAGE("Surface state cache: %u hits, %u misses.",
+        pStateHeap->dwSurfaceStateCacheHits, pStateHeap->dwSurfaceStateCacheMisses);
+
     // Free State Heap Control structure
     MOS_AlignedFreeMemory(pStateHeap);
     pRenderHal->pStateHeap = nullptr;
@@ -1689,6 +1850,8 @@ MOS_STATUS RenderHal_LockBB(
 
     MHW_RENDERHAL_CHK_NULL(pBatchBuffer->pData);
 
+    pBatchBuffer->bCachedMapping = pOsInterface->pfnIsLockCached &&
+                                   pOsInterface->pfnIsLockCached(pOsInterface, &pBatchBuffer->OsResource);
     pBatchBuffer->bLocked   = true;
     eStatus                 = MOS_STATUS_SUCCESS;
 
@@ -1731,7 +1894,8 @@ MOS_STATUS RenderHal_UnlockBB(
                 pOsInterface, 
                 &pBatchBuffer->OsResource));
 
-    pBatchBuffer->bLocked = false;
+    pBatchBuffer->bLocked        = false;
+    pBatchBuffer->bCachedMapping = false;
 
     eStatus = MOS_STATUS_SUCCESS;
 
@@ -1865,6 +2029,150 @@ finish:
     return eStatus;
 }
 
+//!
+//! \brief    Get Least Recently Used Kernel
+//! \details  Search the kernel not used for the greater amount of time among
+//!           the kernels the GPU is done with
+//! \param    PRENDERHAL_INTERFACE pRenderHal
+//!           [in] Pointer to Hardware Interface Structure
+//! \param    int32_t iMinSize
+//!           [in] Minimum block size of the kernel
+//! \return   int32_t
+//!           Kernel allocation index, -1 if no kernel may be unloaded
+//!
+static int32_t RenderHal_GetLeastRecentlyUsedKernel(
+    PRENDERHAL_INTERFACE       pRenderHal,
+    int32_t                    iMinSize)
+{
+    PRENDERHAL_STATE_HEAP       pStateHeap;
+    PRENDERHAL_KRN_ALLOCATION   pKernelAllocation;
+    int32_t                     iKernelAllocationID;
+    int32_t                     iSearchIndex;
+    uint32_t                    dwOldest;
+    uint32_t                    dwLastUsed;
+
+    pStateHeap   = pRenderHal->pStateHeap;
+    iSearchIndex = -1;
+    dwOldest     = 0;
+
+    // Search least used kernel
+    pKernelAllocation = pStateHeap->pKernelAllocation;
+    for (iKernelAllocationID = 0;
+         iKernelAllocationID < pRenderHal->StateHeapSettings.iKernelCount;
+         iKernelAllocationID++, pKernelAllocation++)
+    {
+        // Skip unused entries and entries that would not fit
+        // Skip kernels flagged as locked (cannot be automatically deallocated)
+        if (pKernelAllocation->dwFlags == RENDERHAL_KERNEL_ALLOCATION_FREE ||
+            pKernelAllocation->dwFlags == RENDERHAL_KERNEL_ALLOCATION_LOCKED ||
+            pKernelAllocation->iSize < iMinSize)
+        {
+            continue;
+        }
+
+        // Check if kernel may be replaced (not in use by GPU)
+        if ((int32_t)(pStateHeap->dwSyncTag - pKernelAllocation->dwSync) < 0)
+        {
+            continue;
+        }
+
+        // Find kernel not used for the greater amount of time (measured in number of operations)
+        // Must not unload recently allocated kernels
+        dwLastUsed = (uint32_t)(pStateHeap->dwAccessCounter - pKernelAllocation->dwCount);
+        if (dwLastUsed > dwOldest)
+        {
+            iSearchIndex = iKernelAllocationID;
+            dwOldest     = dwLastUsed;
+        }
+    }
+
+    return iSearchIndex;
+}
+
+//!
+//! \brief    Unload Least Recently Used Shared Kernel
+//! \details  Shared ISH blocks are only released once the GPU completed the
+//!           work of the instance, waits for it if the kernel cannot be unloaded
+//! \param    PRENDERHAL_INTERFACE pRenderHal
+//!           [in] Pointer to Hardware Interface Structure
+//! \return   int32_t
+//!           Kernel allocation index of the unloaded kernel, -1 if no kernel may be unloaded
+//!
+static int32_t RenderHal_UnloadLeastRecentlyUsedSharedKernel(
+    PRENDERHAL_INTERFACE       pRenderHal)
+{
+    PRENDERHAL_STATE_HEAP       pStateHeap;
+    int32_t                     iUnloadIndex;
+
+    pStateHeap = pRenderHal->pStateHeap;
+
+    iUnloadIndex = RenderHal_GetLeastRecentlyUsedKernel(pRenderHal, 0);
+    if (iUnloadIndex < 0)
+    {
+        return -1;
+    }
+
+    if (pRenderHal->pfnUnloadKernel(pRenderHal, iUnloadIndex) != MOS_STATUS_SUCCESS)
+    {
+        if (!RenderHal_SharedIsh_WaitIdle(pRenderHal->pOsInterface, &pStateHeap->GshOsResource, RENDERHAL_SHARED_ISH_IDLE_TIMEOUT_MS) ||
+            pRenderHal->pfnUnloadKernel(pRenderHal, iUnloadIndex) != MOS_STATUS_SUCCESS)
+        {
+            return -1;
+        }
+    }
+
+    return iUnloadIndex;
+}
+
+//!
+//! \brief    Load Shared Kernel
+//! \details  Reference the kernel in the shared ISH, unloading the least
+//!           recently used kernels of the instance until a block is available
+//! \param    PRENDERHAL_INTERFACE pRenderHal
+//!           [in] Pointer to Hardware Interface Structure
+//! \param    PMHW_KERNEL_PARAM pKernel
+//!           [in] Pointer to Kernel entry
+//! \param    uint32_t *pdwOffset
+//!           [out] Offset of the kernel in the ISH
+//! \param    int32_t *piSize
+//!           [out] Size of the kernel block
+//! \return   int32_t
+//!           Block in the shared ISH, -1 if no space available
+//!
+static int32_t RenderHal_LoadSharedKernel(
+    PRENDERHAL_INTERFACE       pRenderHal,
+    PMHW_KERNEL_PARAM          pKernel,
+    uint32_t                   *pdwOffset,
+    int32_t                    *piSize)
+{
+    PRENDERHAL_STATE_HEAP       pStateHeap;
+    int32_t                     iSharedBlock;
+
+    pStateHeap = pRenderHal->pStateHeap;
+
+    for (;;)
+    {
+        iSharedBlock = RenderHal_SharedIsh_LoadKernel(
+            pStateHeap->pSharedIsh,
+            pKernel->pBinary,
+            pKernel->iSize,
+            pdwOffset,
+            piSize);
+        if (iSharedBlock >= 0)
+        {
+            break;
+        }
+
+        // Blocks only referenced by this instance become available once unloaded
+        if (RenderHal_UnloadLeastRecentlyUsedSharedKernel(pRenderHal) < 0)
+        {
+            break;
+        }
+    }
+
+    return iSharedBlock;
+}
+
 //!
 //! \brief    Load Kernel
 //! \details  Load a kernel from cache into GSH; searches for unused space in 
@@ -1902,9 +2210,11 @@ int32_t RenderHal_LoadKernel(
     int32_t iMaxKernels;            // Max number of kernels allowed in GSH
     uint32_t dwOffset;
     int32_t iSize;
+    int32_t iSharedBlock;           // Kernel block in the shared ISH
     MOS_STATUS eStatus;
 
     iKernelAllocationID = RENDERHAL_KERNEL_LOAD_FAIL;
+    iSharedBlock        = -1;
     eStatus             = MOS_STATUS_SUCCESS;
 
     MHW_RENDERHAL_CHK_NULL(pRenderHal);
@@ -1955,14 +2265,63 @@ int32_t RenderHal_LoadKernel(
     if (iKernelAllocationID < iMaxKernels)
     {
         // To reload the kernel forcibly if needed
-        if (pKernel->bForceReload)
+        if (pKernel->bForceReload && pKernelAllocation->iSharedBlock >= 0)
         {
-            dwOffset = pKernelAllocation->dwOffset;
-            MOS_SecureMemcpy(pStateHeap->pIshBuffer + dwOffset, iKernelSize, pKernelPtr, iKernelSize);
+            // Other instances may be using the block, load the binary as a new kernel.
+            // The old entry keeps its block until the GPU is done with it, it is then unloaded as any other kernel.
+            pKernelAllocation->iKUID        = -1;
+            pKernelAllocation->iKCID        = -1;
+            pKernelAllocation->dwFlags      = RENDERHAL_KERNEL_ALLOCATION_USED;
+            pKernelAllocation->pKernelEntry = nullptr;
+
+            if (pRenderHal->pfnUnloadKernel(pRenderHal, iKernelAllocationID) == MOS_STATUS_SUCCESS &&
+                iSearchIndex < 0)
+            {
+                iSearchIndex = iKernelAllocationID;
+            }
 
             pKernel->bForceReload = false;
         }
-        goto finish;
+        else
+        {
+            if (pKernel->bForceReload)
+            {
+                dwOffset = pKernelAllocation->dwOffset;
+                MOS_SecureMemcpy(pStateHeap->pIshBuffer + dwOffset, iKernelSize, pKernelPtr, iKernelSize);
+
+                pKernel->bForceReload = false;
+            }
+            goto finish;
+        }
+    }
+
+    // Shared ISH: blocks are allocated by the shared ISH, the table only holds the kernels of this instance
+    if (pStateHeap->pSharedIsh)
+    {
+        iKernelAllocationID = RENDERHAL_KERNEL_LOAD_FAIL;
+
+        if (iSearchIndex < 0)
+        {
+            iSearchIndex = RenderHal_UnloadLeastRecentlyUsedSharedKernel(pRenderHal);
+            if (iSearchIndex < 0)
+            {
+                MHW_RENDERHAL_NORMALMESSAGE("Failed to load kernel - no kernel allocation available.");
+                goto finish;
+            }
+        }
+
+        iSharedBlock = RenderHal_LoadSharedKernel(pRenderHal, pKernel, &dwOffset, &iSize);
+        if (iSharedBlock < 0)
+        {
+            MHW_RENDERHAL_NORMALMESSAGE("Failed to load kernel - no space available in shared ISH.");
+            goto finish;
+        }
+
+        iKernelAllocationID = iSearchIndex;
+        pKernelAllocation   = &(pStateHeap->pKernelAllocation[iSearchIndex]);
+
+        // Kernel is already in the shared ISH
+        goto loadkernel;
     }
 
     // Simple allocation: allocation index available, space available
@@ -2018,39 +2377,7 @@ int32_t RenderHal_LoadKernel(
     // Did not find block, try to deallocate a kernel not recently used
     if (iSearchIndex < 0)
     {
-        uint32_t dwOldest = 0;
-        uint32_t dwLastUsed;
-
-        // Search and deallocate least used kernel
-        pKernelAllocation = pStateHeap->pKernelAllocation;
-        for (iKernelAllocationID = 0;
-             iKernelAllocationID < iMaxKernels;
-             iKernelAllocationID++, pKernelAllocation++)
-        {
-            // Skip unused entries and entries that would not fit
-            // Skip kernels flagged as locked (cannot be automatically deallocated)
-            if (pKernelAllocation->dwFlags == RENDERHAL_KERNEL_ALLOCATION_FREE ||
-                pKernelAllocation->dwFlags == RENDERHAL_KERNEL_ALLOCATION_LOCKED ||
-                pKernelAllocation->iSize < iKernelSize)
-            {
-                continue;
-            }
-
-            // Check if kernel may be replaced (not in use by GPU)
-            if ((int32_t)(pStateHeap->dwSyncTag - pKernelAllocation->dwSync) < 0)
-            {
-                continue;
-            }
-
-            // Find kernel not used for the greater amount of time (measured in number of operations)
-            // Must not unload recently allocated kernels
-            dwLastUsed = (uint32_t)(pStateHeap->dwAccessCounter - pKernelAllocation->dwCount);
-            if (dwLastUsed > dwOldest)
-            {
-                iSearchIndex = iKernelAllocationID;
-                dwOldest     = dwLastUsed;
-            }
-        }
+        iSearchIndex = RenderHal_GetLeastRecentlyUsedKernel(pRenderHal, iKernelSize);
 
         // Did not found any entry for deallocation
         if (iSearchIndex < 0)
@@ -2089,12 +2416,16 @@ loadkernel:
     pKernelAllocation->Params          = *pParameters;
     pKernelAllocation->pKernelEntry    = pKernelEntry;
     pKernelAllocation->iAllocIndex     = iKernelAllocationID;
+    pKernelAllocation->iSharedBlock    = iSharedBlock;
 
     // Copy kernel data
-    MOS_SecureMemcpy(pStateHeap->pIshBuffer + dwOffset, iKernelSize, pKernelPtr, iKernelSize);
-    if (iKernelSize < iSize)
+    if (iSharedBlock < 0)
     {
-        MOS_ZeroMemory(pStateHeap->pIshBuffer + dwOffset + iKernelSize, iSize - iKernelSize);
+        MOS_SecureMemcpy(pStateHeap->pIshBuffer + dwOffset, iKernelSize, pKernelPtr, iKernelSize);
+        if (iKernelSize < iSize)
+        {
+            MOS_ZeroMemory(pStateHeap->pIshBuffer + dwOffset + iKernelSize, iSize - iKernelSize);
+        }
     }
 
 finish:
@@ -2164,6 +2495,14 @@ MOS_STATUS RenderHal_UnloadKernel(
         goto finish;
     }
 
+    // Blocks of the shared ISH are reused by the other instances as soon as they are released,
+    // the sync tag cannot tell the GPU completed the work using them
+    if (pKernelAllocation->iSharedBlock >= 0 &&
+        !RenderHal_SharedIsh_WaitIdle(pRenderHal->pOsInterface, &pStateHeap->GshOsResource, 0))
+    {
+        goto finish;
+    }
+
     // Unload kernel
     if (pKernelAllocation->pKernelEntry)
     {
@@ -2179,6 +2518,15 @@ MOS_STATUS RenderHal_UnloadKernel(
     pKernelAllocation->dwCount          = 0;
     pKernelAllocation->pKernelEntry     = nullptr;
 
+    // Blocks of the shared ISH are reallocated by the shared ISH only
+    if (pKernelAllocation->iSharedBlock >= 0)
+    {
+        RenderHal_SharedIsh_UnloadKernel(pStateHeap->pSharedIsh, pKernelAllocation->iSharedBlock, true);
+        pKernelAllocation->iSharedBlock = -1;
+        pKernelAllocation->dwOffset     = 0;
+        pKernelAllocation->iSize        = 0;
+    }
+
     eStatus = MOS_STATUS_SUCCESS;
 
 finish:
@@ -2266,6 +2614,7 @@ void RenderHal_ResetKernels(
         pKernelAllocation->dwCount          = 0;
         pKernelAllocation->pKernelEntry     = nullptr;
         pKernelAllocation->iAllocIndex      = i;
+        pKernelAllocation->iSharedBlock     = -1;
         pKernelAllocation->Params           = g_cRenderHal_InitKernelParams;
     }
 
@@ -4556,6 +4905,9 @@ MOS_STATUS RenderHal_Initialize(
     if (pSettings)
     {
         pRenderHal->StateHeapSettings.iMediaStateHeaps = pSettings->iMediaStates;
+
+        // Kernels loaded by the SIP debug path are private to the instance
+        pRenderHal->bSharedKernelHeap = pSettings->bSharedKernelHeap && !pRenderHal->bIsaAsmDebugEnable;
     }
 
     // Apply SSH settings for the current platform
@@ -5531,6 +5883,84 @@ bool RenderHal_Is2PlaneNV12Needed(
 }
 
 
+//!
+//! \brief      Set an AVS sampler state
+//! \details    The state is encoded in the sampler AVS image and copied to the GSH,
+//!             which is mapped write-combined and should not take the read-modify-writes
+//!             of the bitfields. The image is copied without encoding when the sampler
+//!             and AVS table parameters match the ones it was encoded from.
+//! \param      PRENDERHAL_INTERFACE pRenderHal
+//!             [in]    Pointer to HW interface
+//! \param      void *pSampler
+//!             [in]    Pointer to the AVS sampler state in GSH
+//! \param      PMHW_SAMPLER_STATE_PARAM pSamplerParams
+//!             [in]    Pointer to sampler state parameters
+//! \return     MOS_STATUS MOS_STATUS_SUCCESS if success, otherwise fail reason
+//!
+static MOS_STATUS RenderHal_SetSamplerAvsState(
+    PRENDERHAL_INTERFACE        pRenderHal,
+    void                        *pSampler,
+    PMHW_SAMPLER_STATE_PARAM    pSamplerParams)
+{
+    PRENDERHAL_SAMPLER_AVS_IMAGE    pImage;
+    MHW_SAMPLER_STATE_AVS_PARAM     Avs;
+    MHW_SAMPLER_AVS_TABLE_PARAM     Table;
+    uint32_t                        dwSize;
+    MOS_STATUS                      eStatus;
+
+    pImage = &pRenderHal->SamplerAvsImage;
+    dwSize = pRenderHal->pHwSizes->dwSizeSamplerStateAvs;
+
+    // Kernel state samplers go to the DSH, a missing table is reported by MHW
+    if (pSamplerParams->pKernelState ||
+        dwSize > RENDERHAL_SAMPLER_AVS_IMAGE_MAX_SIZE ||
+        (pSamplerParams->Avs.bEnableAVS && pSamplerParams->Avs.pMhwSamplerAvsTableParam == nullptr))
+    {
+        return pRenderHal->pMhwStateHeap->SetSamplerState(pSampler, pSamplerParams);
+    }
+
+    // Bytewise copy so that the padding is part of the comparison
+    MOS_ZeroMemory(&Avs, sizeof(Avs));
+    MOS_SecureMemcpy(&Avs, sizeof(Avs), &pSamplerParams->Avs, sizeof(Avs));
+    Avs.stateID                  = 0;
+    Avs.pMhwSamplerAvsTableParam = nullptr;
+    Avs.iTable8x8_Index          = 0;
+    Avs.pTable8x8_Ptr            = nullptr;
+    Avs.dwTable8x8_Offset        = 0;
+
+    if (pSamplerParams->Avs.bEnableAVS)
+    {
+        MOS_SecureMemcpy(&Table, sizeof(Table), pSamplerParams->Avs.pMhwSamplerAvsTableParam, sizeof(Table));
+    }
+    else
+    {
+        MOS_ZeroMemory(&Table, sizeof(Table));
+    }
+
+    if (!pImage->bValid ||
+        pImage->dwSize != dwSize ||
+        memcmp(&pImage->Avs, &Avs, sizeof(Avs)) != 0 ||
+        memcmp(&pImage->Table, &Table, sizeof(Table)) != 0)
+    {
+        pImage->bValid = false;
+
+        eStatus = pRenderHal->pMhwStateHeap->SetSamplerState(pImage->Image, pSamplerParams);
+        if (MOS_FAILED(eStatus))
+        {
+            return eStatus;
+        }
+
+        pImage->Avs    = Avs;
+        pImage->Table  = Table;
+        pImage->dwSize = dwSize;
+        pImage->bValid = true;
+    }
+
+    MOS_FastMemCopy(pSampler, pImage->Image, dwSize, MOS_MEMCOPY_DST_UNCACHED);
+
+    return MOS_STATUS_SUCCESS;
+}
+
 //!
 //! \brief      Sets Sampler States for Gen8
 //! \details    Initialize and set sampler states
@@ -5607,7 +6037,7 @@ MOS_STATUS RenderHal_SetSamplerStates(
                 eStatus = pRenderHal->pMhwStateHeap->SetSamplerState(pPtrSampler, pSamplerStateParams);
                 break;
             case MHW_SAMPLER_TYPE_AVS:
-                eStatus = pRenderHal->pMhwStateHeap->SetSamplerState(pPtrSamplerAvs, pSamplerStateParams);
+                eStatus = RenderHal_SetSamplerAvsState(pRenderHal, pPtrSamplerAvs, pSamplerStateParams);
                 pPtrSamplerAvs += pRenderHal->dwSamplerAvsIncrement;
                 break;
             default:
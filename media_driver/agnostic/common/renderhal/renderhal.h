@@ -36,6 +36,7 @@
 #include "mhw_render.h"
 
 #include "renderhal_dsh.h"
+#include "renderhal_shared_ish.h"
 #include "mhw_memory_pool.h"
 
 class XRenderHal_Platform_Interface;
@@ -106,6 +107,15 @@ class XRenderHal_Platform_Interface;
 #define RENDERHAL_SSH_SURFACES_PER_BT_MIN  4
 #define RENDERHAL_SSH_SURFACES_PER_BT_MAX  256
 
+//!
+//! \brief  Encoded surface state cache, one entry per surface state slot
+//!         The key covers every encoding input of MHW_SURFACE_STATE_PARAMS, the
+//!         surface address is not part of it as it is patched for each binding
+//!
+#define RENDERHAL_SURFACE_STATE_CACHE_KEY_OFFSET    offsetof(MHW_SURFACE_STATE_PARAMS, dwCacheabilityControl)
+#define RENDERHAL_SURFACE_STATE_CACHE_KEY_SIZE      (offsetof(MHW_SURFACE_STATE_PARAMS, pdwCmd) - RENDERHAL_SURFACE_STATE_CACHE_KEY_OFFSET)
+#define RENDERHAL_SURFACE_STATE_CACHE_STATE_SIZE    64
+
 //!
 //! \brief  Default size of area for sync, debugging, performance collecting
 //!
@@ -222,6 +232,11 @@ class XRenderHal_Platform_Interface;
 #define RENDERHAL_CHROMA_KEY_COUNT          4
 #define RENDERHAL_CHROMA_KEY_MAX            4
 
+//!
+//! \brief  Largest AVS sampler state kept by the sampler AVS image
+//!
+#define RENDERHAL_SAMPLER_AVS_IMAGE_MAX_SIZE    2048
+
 //!
 //! \brief  Alignment
 //!
@@ -457,6 +472,8 @@ typedef struct _RENDERHAL_SETTINGS
 
     PRENDERHAL_DYN_HEAP_SETTINGS pDynSettings; // Dynamic State Heap Settings
 
+    bool bSharedKernelHeap;                    // Load kernels into the ISH shared by the instances of the device
+
 } RENDERHAL_SETTINGS, *PRENDERHAL_SETTINGS;
 
 //!
@@ -758,6 +775,7 @@ typedef struct _RENDERHAL_KRN_ALLOCATION
     Kdll_CacheEntry             *pKernelEntry;                                  // Pointer to Kernel entry for VP/KDLL
     RENDERHAL_CLONE_KERNEL_PARAM cloneKernelParams;                             // CM - Clone kernel information
     int32_t                 iAllocIndex;                                        // Kernel allocation index (index in kernel allocation table)
+    int32_t                 iSharedBlock;                                       // Block in the shared ISH (-1 if the ISH is private)
 
     // DSH - Dynamic list of kernel allocations
     PMHW_STATE_HEAP_MEMORY_BLOCK pMemoryBlock;                                  // Memory block in ISH
@@ -835,6 +853,16 @@ typedef struct _RENDERHAL_STATE_HEAP_SETTINGS
     int32_t             iBTAlignment;                                           // BT Alignment size
 } RENDERHAL_STATE_HEAP_SETTINGS, *PRENDERHAL_STATE_HEAP_SETTINGS;
 
+typedef struct _RENDERHAL_SURFACE_STATE_CACHE_ENTRY
+{
+    bool                    bValid;                                             // Entry holds an encoded surface state
+    uint32_t                dwStateSize;                                        // Size of the encoded surface state
+    uint32_t                dwPatchOffset;                                      // Offset of the address to patch in the surface state
+    uint32_t                dwLocationInCmd;                                    // DW of the address to patch in the surface state
+    uint8_t                 Key[RENDERHAL_SURFACE_STATE_CACHE_KEY_SIZE];        // Encoding params of the surface state
+    uint8_t                 SurfaceState[RENDERHAL_SURFACE_STATE_CACHE_STATE_SIZE]; // Encoded surface state
+} RENDERHAL_SURFACE_STATE_CACHE_ENTRY, *PRENDERHAL_SURFACE_STATE_CACHE_ENTRY;
+
 typedef struct _RENDERHAL_STATE_HEAP
 {
     //---------------------------
@@ -916,6 +944,11 @@ typedef struct _RENDERHAL_STATE_HEAP
     // Array of Surface State control structures
     PRENDERHAL_SURFACE_STATE_ENTRY  pSurfaceEntry;
 
+    // Encoded Surface States of the last binding of each Surface State slot
+    PRENDERHAL_SURFACE_STATE_CACHE_ENTRY pSurfaceStateCache;
+    uint32_t                dwSurfaceStateCacheHits;                            // Surface states copied from the cache
+    uint32_t                dwSurfaceStateCacheMisses;                          // Surface states encoded by MHW
+
     // Current allocations
     int32_t                 iCurSshBufferIndex;                                 // Current SSH Buffer instance in the SSH heap
     int32_t                 iCurrentBindingTable;                               // Current BT
@@ -928,6 +961,7 @@ typedef struct _RENDERHAL_STATE_HEAP
     MOS_RESOURCE            IshOsResource;                                      // ISH OS Buffer
     bool                    bIshLocked;                                         // ISH is locked
     uint8_t                 *pIshBuffer;                                         // Pointer to ISH buffer data
+    PRENDERHAL_SHARED_ISH   pSharedIsh;                                         // ISH shared with other instances (nullptr if private)
     uint32_t                dwKernelBase;                                       // Offset of kernels in ISH
 
     // Kernel Allocation
@@ -1082,6 +1116,20 @@ typedef struct _RENDERHAL_L3_CACHE_SETTINGS
     uint32_t dwLra1Reg;
 } RENDERHAL_L3_CACHE_SETTINGS, *PRENDERHAL_L3_CACHE_SETTINGS;
 
+//!
+// \brief   Last AVS sampler state written by pfnSetSamplerStates
+// \details Consecutive composition phases usually scale with the same parameters,
+//          the state is then copied instead of being encoded again
+//!
+typedef struct _RENDERHAL_SAMPLER_AVS_IMAGE
+{
+    bool                            bValid;
+    MHW_SAMPLER_STATE_AVS_PARAM     Avs;            // Sampler parameters, pointers and heap locations cleared
+    MHW_SAMPLER_AVS_TABLE_PARAM     Table;          // AVS table parameters, zero if AVS is disabled
+    uint32_t                        dwSize;
+    uint8_t                         Image[RENDERHAL_SAMPLER_AVS_IMAGE_MAX_SIZE];
+} RENDERHAL_SAMPLER_AVS_IMAGE, *PRENDERHAL_SAMPLER_AVS_IMAGE;
+
 typedef MhwMiInterface *PMHW_MI_INTERFACE;
 //!
 // \brief   Hardware dependent render engine interface
@@ -1147,6 +1195,7 @@ typedef struct _RENDERHAL_INTERFACE
     uint32_t                    dwCurbeBlockAlign;                              // Unifies pfnLoadCurbeData - Curbe Block Alignment
     uint32_t                    dwScratchSpaceMaxThreads;                       // Unifies pfnGetScratchSpaceSize - Threads used for scratch space calculation
     uint32_t                    dwSamplerAvsIncrement;                          // Unifies pfnSetSamplerStates
+    RENDERHAL_SAMPLER_AVS_IMAGE SamplerAvsImage;                                // Last AVS sampler state written by pfnSetSamplerStates
 
     const void                  *sseuTable;                                     // pointer of const VphalSseuSetting table on a platform
 
@@ -1183,6 +1232,7 @@ typedef struct _RENDERHAL_INTERFACE
     bool                        IsMDFLoad;
 
     bool                        bDynamicStateHeap;		//!< Indicates that DSH is in use
+    bool                        bSharedKernelHeap;                              //!< Kernels are loaded into the ISH shared by the instances of the device
 
 #if (_DEBUG || _RELEASE_INTERNAL)
     // Dump state for VP debugging
@@ -1720,6 +1770,25 @@ void RenderHal_GetPixelsPerSample(
     MOS_FORMAT                  format,
     uint32_t                    *pdwPixelsPerSampleUV);
 
+//!
+//! \brief    Set Surface State Entry
+//! \details  Setup the surface state of a slot in the current SSH instance.
+//!           The surface state is copied from the cache when the slot was last
+//!           encoded with the same params, MHW encodes it otherwise.
+//! \param    PRENDERHAL_INTERFACE pRenderHal
+//!           [in] Pointer to Hardware Interface Structure
+//! \param    int32_t iSurfStateID
+//!           [in] Surface state slot
+//! \param    PMHW_SURFACE_STATE_PARAMS pParams
+//!           [in/out] Surface state params, returns the address to patch
+//! \return   MOS_STATUS
+//!           MOS_STATUS_SUCCESS if success. Error code otherwise
+//!
+MOS_STATUS RenderHal_SetSurfaceStateEntry(
+    PRENDERHAL_INTERFACE        pRenderHal,
+    int32_t                     iSurfStateID,
+    PMHW_SURFACE_STATE_PARAMS   pParams);
+
 //!
 //! \brief    Set Surface for HW Access
 //! \details  Common Function for setting up surface state
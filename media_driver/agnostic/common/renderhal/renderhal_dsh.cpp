@@ -659,6 +659,8 @@ MOS_STATUS RenderHal_DSH_AllocateStateHeaps(
     pStateHeap->iSurfaceStateOffset  = pSettings->iBindingTables * pStateHeap->iBindingTableSize;
     pStateHeap->pSurfaceEntry        = (PRENDERHAL_SURFACE_STATE_ENTRY) MOS_AllocAndZeroMemory(pSettings->iSurfaceStates * sizeof(RENDERHAL_SURFACE_STATE_ENTRY));
     MHW_RENDERHAL_CHK_NULL(pStateHeap->pSurfaceEntry);
+    pStateHeap->pSurfaceStateCache   = (PRENDERHAL_SURFACE_STATE_CACHE_ENTRY) MOS_AllocAndZeroMemory(pSettings->iSurfaceStates * sizeof(RENDERHAL_SURFACE_STATE_CACHE_ENTRY));
+    MHW_RENDERHAL_CHK_NULL(pStateHeap->pSurfaceStateCache);
 
     //----------------------------------
     // Allocate State Heap in MHW
@@ -711,6 +713,11 @@ finish:
                 MOS_FreeMemory(pStateHeap->pSurfaceEntry);
             }
 
+            if (pStateHeap->pSurfaceStateCache)
+            {
+                MOS_FreeMemory(pStateHeap->pSurfaceStateCache);
+            }
+
             if (pStateHeap->pSshBuffer)
             {
                 MOS_FreeMemory(pStateHeap->pSshBuffer);
@@ -752,6 +759,15 @@ MOS_STATUS RenderHal_DSH_FreeStateHeaps(PRENDERHAL_INTERFACE pRenderHal)
         pStateHeap->pSurfaceEntry = nullptr;
     }
 
+    // Free encoded Surface State cache
+    if (pStateHeap->pSurfaceStateCache)
+    {
+        MHW_RENDERHAL_NORMALMESSAGE("Surface state cache: %u hits, %u misses.",
+            pStateHeap->dwSurfaceStateCacheHits, pStateHeap->dwSurfaceStateCacheMisses);
+        MOS_FreeMemory(pStateHeap->pSurfaceStateCache);
+        pStateHeap->pSurfaceStateCache = nullptr;
+    }
+
     // Free SSH Resource
     if (pStateHeap->pSshBuffer)
     {
@@ -2806,6 +2822,10 @@ MOS_STATUS RenderHal_DSH_Initialize(
     pRenderHal->dwStateHeapSize = sizeof(RENDERHAL_STATE_HEAP);
     MHW_RENDERHAL_CHK_NULL(pStateHeap);
 
+    pStateHeap->pSurfaceStateCache        = nullptr;
+    pStateHeap->dwSurfaceStateCacheHits   = 0;
+    pStateHeap->dwSurfaceStateCacheMisses = 0;
+
     RenderHal_HashTable_Init(&pRenderHal->pStateHeap->KernelHashTable);
 
     // Apply state heap settings (iMediaStates not actually used in DSH)
@@ -0,0 +1,371 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     renderhal_shared_ish.cpp
+//! \brief    Instruction state heap shared by the RenderHal instances of a device
+//!
+
+#include "renderhal.h"
+#include "renderhal_shared_ish.h"
+#include <string.h>
+
+static PRENDERHAL_SHARED_ISH    gRenderHalSharedIshList = nullptr;
+static MOS_MUTEX                gRenderHalSharedIshListMutex = MOS_MUTEX_INITIALIZER;
+
+//!
+//! \brief    64-bit hash of a kernel binary
+//! \details  FNV-1a over 8 byte words in four interleaved lanes, so that the
+//!           multiplications of consecutive words do not wait for each other
+//!
+static uint64_t RenderHal_SharedIsh_Hash(const void *pBinary, int32_t iSize)
+{
+    const uint8_t   *pData = (const uint8_t *)pBinary;
+    uint64_t        ui64Lane[4];
+    uint64_t        ui64Word;
+    uint64_t        ui64Hash;
+    int32_t         i, j;
+
+    for (j = 0; j < 4; j++)
+    {
+        ui64Lane[j] = 0xcbf29ce484222325ULL + j;
+    }
+
+    for (i = 0; i + 32 <= iSize; i += 32)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            memcpy(&ui64Word, pData + i + j * 8, sizeof(ui64Word));
+            ui64Lane[j] = (ui64Lane[j] ^ ui64Word) * 0x100000001b3ULL;
+        }
+    }
+
+    ui64Hash = 0xcbf29ce484222325ULL;
+    for (j = 0; j < 4; j++)
+    {
+        ui64Hash = (ui64Hash ^ ui64Lane[j]) * 0x100000001b3ULL;
+        ui64Hash ^= ui64Hash >> 29;
+    }
+    for (; i < iSize; i++)
+    {
+        ui64Hash = (ui64Hash ^ pData[i]) * 0x100000001b3ULL;
+    }
+
+    return ui64Hash;
+}
+
+//!
+//! \brief    Allocate and map a shared heap
+//!
+static PRENDERHAL_SHARED_ISH RenderHal_SharedIsh_Create(
+    PMOS_INTERFACE              pOsInterface,
+    void                        *pDevice,
+    int32_t                     iKernelHeapSize,
+    int32_t                     iBlockSize,
+    int32_t                     iSipSize)
+{
+    PRENDERHAL_SHARED_ISH       pSharedIsh;
+    MOS_ALLOC_GFXRES_PARAMS     AllocParams;
+    MOS_LOCK_PARAMS             LockParams;
+
+    pSharedIsh = (PRENDERHAL_SHARED_ISH)MOS_AllocAndZeroMemory(sizeof(RENDERHAL_SHARED_ISH));
+    if (pSharedIsh == nullptr)
+    {
+        return nullptr;
+    }
+
+    pSharedIsh->pDevice         = pDevice;
+    pSharedIsh->iKernelHeapSize = iKernelHeapSize;
+    pSharedIsh->iBlockSize      = iBlockSize;
+    pSharedIsh->iSipSize        = iSipSize;
+    pSharedIsh->dwSipBase       = MOS_ALIGN_CEIL(iKernelHeapSize * RENDERHAL_SHARED_ISH_SIZE_FACTOR, RENDERHAL_KERNEL_BLOCK_ALIGN);
+    pSharedIsh->dwSize          = pSharedIsh->dwSipBase + MOS_ALIGN_CEIL(iSipSize, RENDERHAL_KERNEL_BLOCK_ALIGN);
+
+    pSharedIsh->pMutex = MOS_CreateMutex();
+    if (pSharedIsh->pMutex == nullptr)
+    {
+        goto fail;
+    }
+
+    MOS_ZeroMemory(&AllocParams, sizeof(AllocParams));
+    AllocParams.Type     = MOS_GFXRES_BUFFER;
+    AllocParams.TileType = MOS_TILE_LINEAR;
+    AllocParams.Format   = Format_Buffer;
+    AllocParams.dwBytes  = pSharedIsh->dwSize;
+    AllocParams.pBufName = "SharedIsh";
+    if (pOsInterface->pfnAllocateResource(pOsInterface, &AllocParams, &pSharedIsh->OsResource) != MOS_STATUS_SUCCESS)
+    {
+        goto fail;
+    }
+
+    MOS_ZeroMemory(&LockParams, sizeof(LockParams));
+    LockParams.WriteOnly   = 1;
+    LockParams.NoOverWrite = 1;
+    LockParams.Uncached    = 1;
+    pSharedIsh->pBuffer = (uint8_t *)pOsInterface->pfnLockResource(pOsInterface, &pSharedIsh->OsResource, &LockParams);
+    if (pSharedIsh->pBuffer == nullptr)
+    {
+        pOsInterface->pfnFreeResource(pOsInterface, &pSharedIsh->OsResource);
+        goto fail;
+    }
+    MOS_ZeroMemory(pSharedIsh->pBuffer, pSharedIsh->dwSize);
+
+    return pSharedIsh;
+
+fail:
+    if (pSharedIsh->pMutex)
+    {
+        MOS_DestroyMutex(pSharedIsh->pMutex);
+    }
+    MOS_FreeMemory(pSharedIsh);
+    return nullptr;
+}
+
+PRENDERHAL_SHARED_ISH RenderHal_SharedIsh_Attach(
+    PMOS_INTERFACE              pOsInterface,
+    int32_t                     iKernelHeapSize,
+    int32_t                     iBlockSize,
+    int32_t                     iSipSize)
+{
+    PRENDERHAL_SHARED_ISH       pSharedIsh;
+    void                        *pDevice;
+
+    if (pOsInterface == nullptr || iKernelHeapSize <= 0 || iBlockSize <= 0)
+    {
+        return nullptr;
+    }
+
+    pDevice = RenderHal_SharedIsh_GetDevice(pOsInterface);
+    if (pDevice == nullptr)
+    {
+        return nullptr;
+    }
+
+    MOS_LockMutex(&gRenderHalSharedIshListMutex);
+
+    for (pSharedIsh = gRenderHalSharedIshList; pSharedIsh; pSharedIsh = pSharedIsh->pNext)
+    {
+        if (pSharedIsh->pDevice         == pDevice          &&
+            pSharedIsh->iKernelHeapSize == iKernelHeapSize  &&
+            pSharedIsh->iBlockSize      == iBlockSize       &&
+            pSharedIsh->iSipSize        == iSipSize         &&
+            pSharedIsh->iClients        <  RENDERHAL_SHARED_ISH_MAX_CLIENTS)
+        {
+            break;
+        }
+    }
+
+    if (pSharedIsh == nullptr)
+    {
+        pSharedIsh = RenderHal_SharedIsh_Create(pOsInterface, pDevice, iKernelHeapSize, iBlockSize, iSipSize);
+        if (pSharedIsh)
+        {
+            pSharedIsh->pNext       = gRenderHalSharedIshList;
+            gRenderHalSharedIshList = pSharedIsh;
+        }
+    }
+
+    if (pSharedIsh)
+    {
+        pSharedIsh->iClients++;
+    }
+
+    MOS_UnlockMutex(&gRenderHalSharedIshListMutex);
+
+    return pSharedIsh;
+}
+
+void RenderHal_SharedIsh_Detach(
+    PMOS_INTERFACE              pOsInterface,
+    PRENDERHAL_SHARED_ISH       pSharedIsh)
+{
+    PRENDERHAL_SHARED_ISH       *ppSharedIsh;
+
+    if (pOsInterface == nullptr || pSharedIsh == nullptr)
+    {
+        return;
+    }
+
+    MOS_LockMutex(&gRenderHalSharedIshListMutex);
+
+    if (--pSharedIsh->iClients > 0)
+    {
+        MOS_UnlockMutex(&gRenderHalSharedIshListMutex);
+        return;
+    }
+
+    for (ppSharedIsh = &gRenderHalSharedIshList; *ppSharedIsh; ppSharedIsh = &(*ppSharedIsh)->pNext)
+    {
+        if (*ppSharedIsh == pSharedIsh)
+        {
+            *ppSharedIsh = pSharedIsh->pNext;
+            break;
+        }
+    }
+
+    MOS_UnlockMutex(&gRenderHalSharedIshListMutex);
+
+    // Submitted command buffers keep their own reference on the buffer
+    pOsInterface->pfnUnlockResource(pOsInterface, &pSharedIsh->OsResource);
+    pOsInterface->pfnFreeResource(pOsInterface, &pSharedIsh->OsResource);
+    MOS_DestroyMutex(pSharedIsh->pMutex);
+    MOS_FreeMemory(pSharedIsh);
+}
+
+int32_t RenderHal_SharedIsh_LoadKernel(
+    PRENDERHAL_SHARED_ISH       pSharedIsh,
+    const void                  *pBinary,
+    int32_t                     iKernelSize,
+    uint32_t                    *pdwOffset,
+    int32_t                     *piSize)
+{
+    PRENDERHAL_SHARED_ISH_BLOCK pBlock;
+    uint64_t                    ui64Hash;
+    int32_t                     iSize;
+    int32_t                     iBlock;
+    int32_t                     iFreeEntry;
+    int32_t                     iReuse;
+    int32_t                     i;
+
+    if (pSharedIsh == nullptr || pBinary == nullptr || iKernelSize <= 0 ||
+        pdwOffset == nullptr || piSize == nullptr)
+    {
+        return -1;
+    }
+
+    // Hashed outside of the lock, instances only get here when their own table misses
+    ui64Hash = RenderHal_SharedIsh_Hash(pBinary, iKernelSize);
+    iSize    = MOS_ALIGN_CEIL(iKernelSize, pSharedIsh->iBlockSize);
+    iBlock   = -1;
+
+    MOS_LockMutex(pSharedIsh->pMutex);
+
+    // Kernel already in the heap
+    iFreeEntry = -1;
+    for (i = 0; i < RENDERHAL_SHARED_ISH_MAX_BLOCKS; i++)
+    {
+        pBlock = &pSharedIsh->Blocks[i];
+        if (pBlock->iSize == 0)
+        {
+            if (iFreeEntry < 0)
+            {
+                iFreeEntry = i;
+            }
+            continue;
+        }
+        // The hash only selects the candidates, a different binary gets a block of its own
+        if (pBlock->ui64Hash == ui64Hash && pBlock->iKernelSize == iKernelSize &&
+            memcmp(pSharedIsh->pBuffer + pBlock->dwOffset, pBinary, iKernelSize) == 0)
+        {
+            pBlock->iRefCount++;
+            iBlock = i;
+            goto finish;
+        }
+    }
+
+    // Allocate from the end of the heap
+    if (iFreeEntry >= 0 &&
+        pSharedIsh->dwKernelUsed + iSize <= pSharedIsh->dwSipBase)
+    {
+        iBlock = iFreeEntry;
+        pBlock = &pSharedIsh->Blocks[iBlock];
+        pBlock->dwOffset = pSharedIsh->dwKernelUsed;
+        pBlock->iSize    = iSize;
+        pSharedIsh->dwKernelUsed += iSize;
+        goto loadkernel;
+    }
+
+    // Reuse the smallest large enough block without references, the least recently released first
+    iReuse = -1;
+    for (i = 0; i < RENDERHAL_SHARED_ISH_MAX_BLOCKS; i++)
+    {
+        pBlock = &pSharedIsh->Blocks[i];
+        if (pBlock->iSize < iKernelSize || pBlock->iRefCount > 0 || pBlock->bPinned)
+        {
+            continue;
+        }
+        if (iReuse < 0 ||
+            pBlock->iSize < pSharedIsh->Blocks[iReuse].iSize ||
+            (pBlock->iSize == pSharedIsh->Blocks[iReuse].iSize &&
+             (int32_t)(pBlock->dwReleased - pSharedIsh->Blocks[iReuse].dwReleased) < 0))
+        {
+            iReuse = i;
+        }
+    }
+
+    if (iReuse < 0)
+    {
+        MHW_RENDERHAL_NORMALMESSAGE("Failed to load kernel - no space available in shared ISH.");
+        goto finish;
+    }
+
+    iBlock = iReuse;
+    pBlock = &pSharedIsh->Blocks[iBlock];
+
+loadkernel:
+    pBlock->ui64Hash    = ui64Hash;
+    pBlock->iKernelSize = iKernelSize;
+    pBlock->iRefCount   = 1;
+    pBlock->bPinned     = false;
+
+    MOS_SecureMemcpy(pSharedIsh->pBuffer + pBlock->dwOffset, iKernelSize, pBinary, iKernelSize);
+    if (iKernelSize < pBlock->iSize)
+    {
+        MOS_ZeroMemory(pSharedIsh->pBuffer + pBlock->dwOffset + iKernelSize, pBlock->iSize - iKernelSize);
+    }
+
+finish:
+    if (iBlock >= 0)
+    {
+        *pdwOffset = pSharedIsh->Blocks[iBlock].dwOffset;
+        *piSize    = pSharedIsh->Blocks[iBlock].iSize;
+    }
+
+    MOS_UnlockMutex(pSharedIsh->pMutex);
+
+    return iBlock;
+}
+
+void RenderHal_SharedIsh_UnloadKernel(
+    PRENDERHAL_SHARED_ISH       pSharedIsh,
+    int32_t                     iBlock,
+    bool                        bIdle)
+{
+    PRENDERHAL_SHARED_ISH_BLOCK pBlock;
+
+    if (pSharedIsh == nullptr || iBlock < 0 || iBlock >= RENDERHAL_SHARED_ISH_MAX_BLOCKS)
+    {
+        return;
+    }
+
+    MOS_LockMutex(pSharedIsh->pMutex);
+
+    pBlock = &pSharedIsh->Blocks[iBlock];
+    if (pBlock->iRefCount > 0)
+    {
+        // The kernel stays in the heap for the next instance loading it
+        pBlock->iRefCount--;
+        pBlock->bPinned   |= !bIdle;
+        pBlock->dwReleased = pSharedIsh->dwReleaseCounter++;
+    }
+
+    MOS_UnlockMutex(pSharedIsh->pMutex);
+}
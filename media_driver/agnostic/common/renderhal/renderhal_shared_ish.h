@@ -0,0 +1,186 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     renderhal_shared_ish.h
+//! \brief    Instruction state heap shared by the RenderHal instances of a device
+//! \details  Instances opting in load their kernels into a heap owned by all the
+//!           instances of the same device instead of a private ISH. A kernel is
+//!           stored once, identified by a hash of its binary, and every instance
+//!           using it holds a reference on its block. Blocks without references
+//!           keep their kernel until the space is needed, and only blocks released
+//!           after the GPU completed the work of every instance are reused.
+//!
+#ifndef __RENDERHAL_SHARED_ISH_H__
+#define __RENDERHAL_SHARED_ISH_H__
+
+#include "mos_os.h"
+
+#define RENDERHAL_SHARED_ISH_MAX_CLIENTS    16      //!< Instances attached to one heap, further ones create another heap
+#define RENDERHAL_SHARED_ISH_SIZE_FACTOR    2       //!< Heap size in private kernel heap sizes
+#define RENDERHAL_SHARED_ISH_MAX_BLOCKS     256     //!< Kernels stored in one heap
+#define RENDERHAL_SHARED_ISH_IDLE_TIMEOUT_MS 1000   //!< Wait for the GPU before an instance releases its kernels
+
+//!
+//! \brief    Kernel stored in a shared heap
+//!
+typedef struct _RENDERHAL_SHARED_ISH_BLOCK
+{
+    uint64_t        ui64Hash;           //!< Hash of the kernel binary
+    int32_t         iKernelSize;        //!< Size of the kernel binary
+    uint32_t        dwOffset;           //!< Offset of the block in the heap
+    int32_t         iSize;              //!< Size of the block, 0 if the entry is unused
+    int32_t         iRefCount;          //!< Kernel allocations of the instances using the block
+    bool            bPinned;            //!< Released after the GPU failed to complete, never reused
+    uint32_t        dwReleased;         //!< Release order of blocks without references
+} RENDERHAL_SHARED_ISH_BLOCK, *PRENDERHAL_SHARED_ISH_BLOCK;
+
+//!
+//! \brief    Instruction state heap shared by the RenderHal instances of a device
+//!
+typedef struct _RENDERHAL_SHARED_ISH
+{
+    void                        *pDevice;           //!< Device the heap was allocated on
+    int32_t                     iClients;           //!< Attached instances
+    PMOS_MUTEX                  pMutex;             //!< Protects the blocks and the heap contents
+
+    MOS_RESOURCE                OsResource;
+    uint8_t                     *pBuffer;           //!< CPU mapping, kept for the lifetime of the heap
+    uint32_t                    dwSize;             //!< Size of the heap, SIP area included
+    uint32_t                    dwSipBase;          //!< Offset of the System Routine area
+
+    int32_t                     iKernelHeapSize;    //!< Private kernel heap size of the attached instances
+    int32_t                     iBlockSize;         //!< Kernel block granularity of the attached instances
+    int32_t                     iSipSize;           //!< SIP area size of the attached instances
+    uint32_t                    dwKernelUsed;       //!< End of the allocated blocks
+    uint32_t                    dwReleaseCounter;
+
+    RENDERHAL_SHARED_ISH_BLOCK  Blocks[RENDERHAL_SHARED_ISH_MAX_BLOCKS];
+
+    struct _RENDERHAL_SHARED_ISH *pNext;
+} RENDERHAL_SHARED_ISH, *PRENDERHAL_SHARED_ISH;
+
+//!
+//! \brief    Get the device a resource allocated by an OS interface belongs to
+//! \details  Heaps are only shared by instances whose resources can be used
+//!           by each other's command buffers
+//! \param    [in] pOsInterface
+//!           Pointer to OS interface
+//! \return   void *
+//!           Device identifier, nullptr if the heap cannot be shared
+//!
+void *RenderHal_SharedIsh_GetDevice(
+    PMOS_INTERFACE              pOsInterface);
+
+//!
+//! \brief    Wait for the GPU to complete the work using a resource
+//! \details  Called before an instance releases its kernels, the blocks are
+//!           reused by the other instances as soon as they are released
+//! \param    [in] pOsInterface
+//!           Pointer to OS interface
+//! \param    [in] pOsResource
+//!           Resource referenced by all the submissions of the instance
+//! \param    [in] dwTimeoutMs
+//!           Time to wait for in milliseconds
+//! \return   bool
+//!           true if the GPU completed the work, false on timeout
+//!
+bool RenderHal_SharedIsh_WaitIdle(
+    PMOS_INTERFACE              pOsInterface,
+    PMOS_RESOURCE               pOsResource,
+    uint32_t                    dwTimeoutMs);
+
+//!
+//! \brief    Attach to a shared heap of the device
+//! \details  Allocates a new heap when the device has none with the same
+//!           settings and room for another instance
+//! \param    [in] pOsInterface
+//!           Pointer to OS interface of the instance
+//! \param    [in] iKernelHeapSize
+//!           Private kernel heap size of the instance
+//! \param    [in] iBlockSize
+//!           Kernel block granularity of the instance
+//! \param    [in] iSipSize
+//!           SIP area size of the instance
+//! \return   PRENDERHAL_SHARED_ISH
+//!           Attached heap, nullptr if the instance should use a private heap
+//!
+PRENDERHAL_SHARED_ISH RenderHal_SharedIsh_Attach(
+    PMOS_INTERFACE              pOsInterface,
+    int32_t                     iKernelHeapSize,
+    int32_t                     iBlockSize,
+    int32_t                     iSipSize);
+
+//!
+//! \brief    Detach from a shared heap
+//! \details  All the kernels of the instance must have been released. The heap
+//!           is freed when its last instance detaches.
+//! \param    [in] pOsInterface
+//!           Pointer to OS interface of the instance
+//! \param    [in] pSharedIsh
+//!           Heap to detach from
+//! \return   void
+//!
+void RenderHal_SharedIsh_Detach(
+    PMOS_INTERFACE              pOsInterface,
+    PRENDERHAL_SHARED_ISH       pSharedIsh);
+
+//!
+//! \brief    Reference a kernel in a shared heap
+//! \details  Adds a reference on the block holding the same binary, compared
+//!           byte for byte, or copies the binary to a free block
+//! \param    [in] pSharedIsh
+//!           Shared heap
+//! \param    [in] pBinary
+//!           Kernel binary
+//! \param    [in] iKernelSize
+//!           Size of the kernel binary
+//! \param    [out] pdwOffset
+//!           Offset of the kernel in the heap
+//! \param    [out] piSize
+//!           Size of the block
+//! \return   int32_t
+//!           Index of the block, -1 if the heap has no room left
+//!
+int32_t RenderHal_SharedIsh_LoadKernel(
+    PRENDERHAL_SHARED_ISH       pSharedIsh,
+    const void                  *pBinary,
+    int32_t                     iKernelSize,
+    uint32_t                    *pdwOffset,
+    int32_t                     *piSize);
+
+//!
+//! \brief    Release a reference on a kernel in a shared heap
+//! \param    [in] pSharedIsh
+//!           Shared heap
+//! \param    [in] iBlock
+//!           Index of the block returned by RenderHal_SharedIsh_LoadKernel
+//! \param    [in] bIdle
+//!           The GPU completed all the work of the instance using the kernel,
+//!           the block is never reused otherwise
+//! \return   void
+//!
+void RenderHal_SharedIsh_UnloadKernel(
+    PRENDERHAL_SHARED_ISH       pSharedIsh,
+    int32_t                     iBlock,
+    bool                        bIdle);
+
+#endif // __RENDERHAL_SHARED_ISH_H__
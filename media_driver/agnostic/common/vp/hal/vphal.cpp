@@ -56,6 +56,7 @@ void VphalFeatureReport::InitReportValue()
     PrimaryCompressible =   false;
     PrimaryCompressMode =   0;
     CompositionMode     =   VPHAL_NO_COMPOSITION;
+    CompPhases          =   0;
 }
 
 //!
@@ -73,6 +74,7 @@ MOS_STATUS VphalState::Allocate(
 {
     MHW_VEBOX_GPUNODE_LIMIT     GpuNodeLimit;
     RENDERHAL_SETTINGS          RenderHalSettings;
+    MOS_USER_FEATURE_VALUE_DATA UserFeatureData;
     MOS_GPU_NODE                VeboxGpuNode;
     MOS_GPU_CONTEXT             VeboxGpuContext;
     MOS_STATUS                  eStatus;
@@ -123,7 +125,16 @@ MOS_STATUS VphalState::Allocate(
     }
 
     // Allocate and initialize HW states
+    MOS_ZeroMemory(&RenderHalSettings, sizeof(RenderHalSettings));
     RenderHalSettings.iMediaStates  = pVpHalSettings->mediaStates;
+
+    // Share the kernel heap with the other VP instances of the device
+    MOS_ZeroMemory(&UserFeatureData, sizeof(UserFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_SHARED_KERNEL_HEAP_ENABLE_ID,
+        &UserFeatureData);
+    RenderHalSettings.bSharedKernelHeap = UserFeatureData.i32Data ? true : false;
     VPHAL_PUBLIC_CHK_STATUS(m_renderHal->pfnInitialize(m_renderHal, &RenderHalSettings));
 
     if (m_veboxInterface && 
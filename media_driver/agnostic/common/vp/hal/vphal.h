@@ -350,6 +350,7 @@ struct VphalFeatureReport
     bool                            PrimaryCompressible;//!< Input Primary Surface Compressible flag
     uint8_t                         PrimaryCompressMode;//!< Input Primary Surface Compression mode  
     VPHAL_COMPOSITION_REPORT_MODE   CompositionMode;    //!< Inplace/Legacy Compostion flag
+    uint32_t                        CompPhases;         //!< Number of composition phases rendered
     bool                            VEFeatureInUse;     //!< If any VEBOX feature is in use, excluding pure bypass for SFC
 };
 
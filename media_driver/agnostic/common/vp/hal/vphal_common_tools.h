@@ -146,6 +146,7 @@ typedef struct _VP_CONFIG
     uint32_t   dwCapturePipeInUseReported; // Reported Capture pipe
     uint32_t   dwCurrentCompositionMode;   // In Place or Legacy Composition
     uint32_t   dwReportedCompositionMode;  // Reported Composition Mode
+    uint32_t   dwCurrentCompPhases;        // Composition phases of the last frame
     uint32_t   dwCurrentHdrMode;           // Current Hdr Mode
     uint32_t   dwReportedHdrMode;          // Reported Hdr Mode
 
@@ -205,6 +205,9 @@ void VpHal_DdiReportFeatureMode(
 
     // Report In Place Compositon status
     pConfigValues->dwCurrentCompositionMode = pReport->CompositionMode;
+
+    // Report composition phases
+    pConfigValues->dwCurrentCompPhases = pReport->CompPhases;
 }
 
 //!
@@ -36,6 +36,7 @@
 #include "mhw_vebox.h"
 #include "mos_os.h"
 #include "vphal_debug.h"
+#include "mos_dump_service.h"
 
 #include "vphal_render_vebox_base.h"
 
@@ -522,8 +523,14 @@ MOS_STATUS VphalSurfaceDumper::DumpSurfaceToFile(
 
     VphalDumperTool::GetOsFilePath(sPath, sOsPath);
 
-    pDst = (uint8_t*)MOS_AllocAndZeroMemory(dwSize);
-    VPHAL_DEBUG_CHK_NULL(pDst);
+    // Planes are snapshotted into the dump pool and written by the dump service
+    // thread. The dump is dropped when the pool is full.
+    pDst = (uint8_t*)MOS_DumpService_AllocBuffer(dwSize);
+    if (pDst == nullptr)
+    {
+        goto finish;
+    }
+    MOS_ZeroMemory(pDst, dwSize);
     pTmpSrc = pData;
     pTmpDst = pDst;
 
@@ -542,10 +549,13 @@ MOS_STATUS VphalSurfaceDumper::DumpSurfaceToFile(
             pTmpDst += planes[j].dwPitch;
         }
     }
-    VPHAL_DEBUG_CHK_STATUS(MOS_WriteFileFromPtr(sOsPath, pDst, dwSize));
+    // The service owns the snapshot from here on
+    pTmpDst = pDst;
+    pDst    = nullptr;
+    VPHAL_DEBUG_CHK_STATUS(MOS_DumpService_Submit(sOsPath, pTmpDst, dwSize, MOS_DUMP_FORMAT_BINARY, false));
 
 finish:
-    MOS_SafeFreeMemory(pDst);
+    MOS_DumpService_FreeBuffer(pDst);
 
     if (isSurfaceLocked)
     {
@@ -1160,7 +1170,7 @@ MOS_STATUS VphalHwStateDumper::DumpBinaryStruct(
     lSize            = lLastFieldOffset + lLastFieldSize;
 
     VphalDumperTool::GetOsFilePath(pcOutFileName, pcTargetFileName);
-    VPHAL_DEBUG_CHK_STATUS(MOS_WriteFileFromPtr(pcTargetFileName, pvStructToDump, lSize));
+    VPHAL_DEBUG_CHK_STATUS(MOS_DumpService_WriteFile(pcTargetFileName, pvStructToDump, lSize, MOS_DUMP_FORMAT_BINARY));
 
 finish:
 	MOS_SafeFreeMemory(pcOutFileName);
@@ -1332,9 +1342,10 @@ MOS_STATUS VphalHwStateDumper::DumpGshBinary(
         goto finish;
     }
     dwSizeMS = (uint32_t)iStrLen;
-    VPHAL_DEBUG_CHK_STATUS(MOS_WriteFileFromPtr(pcTargetFileName,
-                                                    pcOutContents, 
-                                                    dwSizeMS));
+    VPHAL_DEBUG_CHK_STATUS(MOS_DumpService_WriteFile(pcTargetFileName,
+                                                    pcOutContents,
+                                                    dwSizeMS,
+                                                    MOS_DUMP_FORMAT_BINARY));
 
     VPHAL_DEBUG_CHK_STATUS(DumpBinaryStruct(pGshLayout, 
                                         uiNumGSHFields, pStateHeap->pGshBuffer, 
@@ -1414,9 +1425,10 @@ MOS_STATUS VphalHwStateDumper::DumpSshBinary(
         goto finish;
     }
     dwSizeMS = (uint32_t)iStrLen;
-    VPHAL_DEBUG_CHK_STATUS(MOS_WriteFileFromPtr(pcTargetFileName,
-                                                    pcOutContents, 
-                                                    dwSizeMS));
+    VPHAL_DEBUG_CHK_STATUS(MOS_DumpService_WriteFile(pcTargetFileName,
+                                                    pcOutContents,
+                                                    dwSizeMS,
+                                                    MOS_DUMP_FORMAT_BINARY));
 
     VPHAL_DEBUG_CHK_STATUS(DumpBinaryStruct(pSshLayout, 
                                         uiNumSSHFields, pStateHeap->pSshBuffer,
@@ -2217,11 +2229,14 @@ finish:
 
 VphalSurfaceDumper::~VphalSurfaceDumper()
 {
+    MOS_DumpService_Flush();
     MOS_SafeFreeMemory(m_dumpSpec.pDumpLocations);
 }
 
 VphalHwStateDumper::~VphalHwStateDumper()
 {
+    MOS_DumpService_Flush();
+
     VPHAL_DBG_DUMP_SPEC *pDumpSpec = &m_dumpSpec;
 
     if (pDumpSpec != nullptr)
@@ -3056,7 +3071,7 @@ MOS_STATUS VphalParameterDumper::DumpToXML(
    
     VphalDumperTool::GetOsFilePath(sPath, sOsPath);    
 
-    VPHAL_DEBUG_CHK_STATUS(MOS_WriteFileFromPtr(sOsPath, pcOutContents, strlen(pcOutContents)));
+    VPHAL_DEBUG_CHK_STATUS(MOS_DumpService_WriteFile(sOsPath, pcOutContents, strlen(pcOutContents), MOS_DUMP_FORMAT_BINARY));
 finish:
     if (pcOutContents)
     {
@@ -3560,17 +3575,11 @@ void VphalDumperTool::WriteFrame(
     uint8_t*                pData;
     char                    sPath[MAX_PATH];
     char                    sOsPath[MAX_PATH];
-    uint8_t*                pDst;
-    uint8_t*                pTmpDst;
-    uint8_t*                pTmpSrc;
     uint32_t                iWidthInBytes;
     uint32_t                iHeightInRows;
     uint32_t                iBpp;
-    uint32_t                iSize;
-    uint32_t                iY;
     MOS_LOCK_PARAMS         LockFlags;
 
-    pDst = nullptr;
     MOS_ZeroMemory(sPath, MAX_PATH);
     MOS_ZeroMemory(sOsPath, MAX_PATH);
 
@@ -3583,8 +3592,6 @@ void VphalDumperTool::WriteFrame(
         &iWidthInBytes,
         &iHeightInRows);
 
-    iSize = iWidthInBytes * iHeightInRows;
-
     // Write original image to file
     MOS_ZeroMemory(&LockFlags, sizeof(MOS_LOCK_PARAMS));
 
@@ -3610,30 +3617,7 @@ void VphalDumperTool::WriteFrame(
     MOS_SecureMemcpy(sOsPath, MAX_PATH, sPath, strlen(sPath));
 
     // Write the data to file
-    if (pSurface->dwPitch == iWidthInBytes)
-    {
-        MOS_WriteFileFromPtr((const char *)sOsPath, pData, iSize);
-    }
-    else
-    {
-        pDst = (uint8_t*)MOS_AllocAndZeroMemory(iSize);
-        pTmpSrc = pData;
-        pTmpDst = pDst;
-
-        for (iY = 0; iY < iHeightInRows; iY++)
-        {
-            MOS_SecureMemcpy(pTmpDst, iSize, pTmpSrc, iWidthInBytes);
-            pTmpSrc += pSurface->dwPitch;
-            pTmpDst += iWidthInBytes;
-        }
-
-        MOS_WriteFileFromPtr((const char *)sOsPath, pDst, iSize);
-    }
-
-    if (pDst)
-    {
-        MOS_FreeMemory(pDst);
-    }
+    MOS_DumpService_Write2D((const char *)sOsPath, pData, iWidthInBytes, iHeightInRows, pSurface->dwPitch);
 
     pOsInterface->pfnUnlockResource(
         pOsInterface,
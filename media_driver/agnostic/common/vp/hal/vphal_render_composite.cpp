@@ -29,6 +29,7 @@
 #include "vphal_renderer.h"         // for VpHal_RenderAllocateBB
 #include "vphal_render_common.h"    // for VPHAL_RENDER_CACHE_CNTL
 #include "vphal_render_ief.h"       
+#include "mos_task_pool.h"
 
 // Compositing surface binding table index
 #define VPHAL_COMP_BTINDEX_LAYER0          0
@@ -1759,6 +1760,178 @@ finish:
     return bResult;
 }
 
+//!
+//! \brief    Adds a source layer for composite, leaving the phase unchanged if it does not fit
+//! \details  AddCompLayer consumes the resources of a layer before checking the limits of the
+//!           phase, which is only fine when the phase ends on the first layer refused
+//! \param    [in,out] pComposite
+//!           Pointer to Composite parameters
+//! \param    [in] pSource
+//!           Pointer to Source Surface
+//! \return   bool
+//!           Return true if source was added to the phase, otherwise false
+//!
+bool CompositeState::TryAddCompLayer(
+    PVPHAL_COMPOSITE_PARAMS     pComposite,
+    PVPHAL_SURFACE              pSource)
+{
+    int32_t             nLayers;
+    int32_t             nPalettes;
+    int32_t             nAVS;
+    int32_t             nProcamp;
+    int32_t             nLumaKeys;
+    int32_t             nSampler;
+    VPHAL_ROTATION      Rotation;
+    VPHAL_SCALING_MODE  ScalingMode;
+
+    nLayers     = pComposite->nLayers;
+    nPalettes   = pComposite->nPalettes;
+    nAVS        = pComposite->nAVS;
+    nProcamp    = pComposite->nProcamp;
+    nLumaKeys   = pComposite->nLumaKeys;
+    nSampler    = pComposite->nSampler;
+    Rotation    = pComposite->Rotation;
+
+    // Luma key may switch layer 0 to AVS before the limits are checked
+    ScalingMode = (pComposite->uSourceCount > 0) ?
+                  pComposite->pSource[0]->ScalingMode : VPHAL_SCALING_NEAREST;
+
+    if (AddCompLayer(pComposite, pSource))
+    {
+        return true;
+    }
+
+    pComposite->nLayers   = nLayers;
+    pComposite->nPalettes = nPalettes;
+    pComposite->nAVS      = nAVS;
+    pComposite->nProcamp  = nProcamp;
+    pComposite->nLumaKeys = nLumaKeys;
+    pComposite->nSampler  = nSampler;
+    pComposite->Rotation  = Rotation;
+    if (pComposite->uSourceCount > 0)
+    {
+        pComposite->pSource[0]->ScalingMode = ScalingMode;
+    }
+
+    return false;
+}
+
+//!
+//! \brief    Check whether the layers of a multiple phase composition can be regrouped
+//! \details  Layers are regrouped by AddPhaseLayers, constricted output and rotation
+//!           done in separate phases keep the input order
+//! \param    [in] pcRenderParams
+//!           Pointer to VPHAL_RENDER_PARAMS
+//! \param    [in] ppSources
+//!           Pointer to PVPHAL_SURFACE, array of input surfaces
+//! \param    [in] iSources
+//!           Number of input surfaces
+//! \return   bool
+//!           Return true if AddPhaseLayers can be used
+//!
+bool CompositeState::IsLayerRegroupAllowed(
+    PCVPHAL_RENDER_PARAMS       pcRenderParams,
+    PVPHAL_SURFACE              *ppSources,
+    int32_t                     iSources)
+{
+    int32_t i;
+
+    // Constricted output is composed at another scale, with two layers there is nothing to regroup
+    if (pcRenderParams->pConstriction || iSources <= 2)
+    {
+        return false;
+    }
+
+    // Rotated layers get their own phase when the sampler cannot rotate
+    if (!m_bSamplerSupportRotation)
+    {
+        for (i = 0; i < iSources; i++)
+        {
+            if (ppSources[i]->Rotation != VPHAL_ROTATION_IDENTITY)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//!
+//! \brief    Adds the source layers of a phase, not necessarily in input order
+//! \details  Layers left are tried in Z order. A layer that does not fit is deferred to a
+//!           later phase, and a layer above it may still be added to this phase as long as
+//!           its destination rectangle does not overlap any deferred layer, so that the
+//!           composed output is the same as with the layers in input order
+//! \param    [in,out] pComposite
+//!           Pointer to Composite parameters
+//! \param    [in] ppSources
+//!           Pointer to PVPHAL_SURFACE, array of input surfaces
+//! \param    [in] iSources
+//!           Number of input surfaces
+//! \param    [in] pPrevOutput
+//!           Output of the previous phase added as the first layer, nullptr in the first phase
+//! \param    [in,out] pbComposed
+//!           Per source flag, set for the sources added to this phase
+//! \return   bool
+//!           Return true if all the sources have been added
+//!
+bool CompositeState::AddPhaseLayers(
+    PVPHAL_COMPOSITE_PARAMS     pComposite,
+    PVPHAL_SURFACE              *ppSources,
+    int32_t                     iSources,
+    PVPHAL_SURFACE              pPrevOutput,
+    bool                        *pbComposed)
+{
+    RECT            rcDeferred[VPHAL_MAX_SOURCES];  // Destination of the layers left for later phases
+    int32_t         iDeferred;
+    int32_t         i, j;
+    bool            bOverlap;
+    PVPHAL_SURFACE  pSrc;
+
+    iDeferred = 0;
+
+    // Set previous output as the first layer
+    if (pPrevOutput)
+    {
+        pPrevOutput->iLayerID = 0;
+        AddCompLayer(pComposite, pPrevOutput);
+    }
+
+    for (i = 0; i < iSources; i++)
+    {
+        if (pbComposed[i])
+        {
+            continue;
+        }
+
+        pSrc = ppSources[i];
+
+        // Layers below it in Z order that are not composed yet would end up on top
+        bOverlap = (pComposite->nLayers <= 0);
+        for (j = 0; j < iDeferred && !bOverlap; j++)
+        {
+            bOverlap = pSrc->rcDst.left   < rcDeferred[j].right  &&
+                       rcDeferred[j].left < pSrc->rcDst.right    &&
+                       pSrc->rcDst.top    < rcDeferred[j].bottom &&
+                       rcDeferred[j].top  < pSrc->rcDst.bottom;
+        }
+
+        if (!bOverlap)
+        {
+            pSrc->iLayerID = pComposite->uSourceCount;
+            pbComposed[i]  = TryAddCompLayer(pComposite, pSrc);
+        }
+
+        if (!pbComposed[i])
+        {
+            rcDeferred[iDeferred++] = pSrc->rcDst;
+        }
+    }
+
+    return (iDeferred == 0);
+}
+
 //!
 //! \brief    Adds render target layer for composite
 //! \param    [in,out] pComposite
@@ -1834,6 +2007,13 @@ MOS_STATUS CompositeState::RenderMultiPhase(
     bool                 bPrimary, bRotation;
     VPHAL_PERFTAG        PerfTag;
 
+    // Layer regrouping
+    bool                 bRegroupLayers;
+    bool                 bComposed[VPHAL_MAX_SOURCES];
+
+    bRegroupLayers = IsLayerRegroupAllowed(pcRenderParams, ppSources, iSources);
+    MOS_ZeroMemory(bComposed, sizeof(bComposed));
+
     for (index = 0, phase = 0; (!bLastPhase); phase++)
     {
         VPHAL_COMPOSITE_PARAMS  CompositeParams;
@@ -1864,57 +2044,82 @@ MOS_STATUS CompositeState::RenderMultiPhase(
         bLastPhase = true;
         bPrimary   = false;
         bRotation  = false;
-        for (i = 0; index < (uint32_t)iSources || bExtraRotationPhase; i++)
+        if (bRegroupLayers)
         {
-            // Set previous output as the first layer
-            if (i == 0 && phase != 0)
+            // Non overlapping layers may be composed ahead of the layers below them
+            bLastPhase = AddPhaseLayers(
+                &CompositeParams,
+                ppSources,
+                iSources,
+                (phase != 0) ? pOutput : nullptr,
+                bComposed);
+
+            for (i = 0; i < (int32_t)CompositeParams.uSourceCount; i++)
             {
-                // Optimization for 2 layers composition (with sub-layer rotation) usage case , in the second phase, the first layer should be layer0
-                if (!m_bApplyTwoLayersCompOptimize || (iSources != 2) || (ppSources[1]->Rotation == VPHAL_ROTATION_IDENTITY))
+                if (CompositeParams.pSource[i]->SurfType == SURF_IN_PRIMARY)
                 {
-                    pSrc = pOutput;
+                    bPrimary = true;
                 }
-                else
+                if (CompositeParams.pSource[i]->Rotation != VPHAL_ROTATION_IDENTITY)
                 {
-                    CompositeParams.pColorFillParams = pcRenderParams->pColorFillParams;
-                    CompositeParams.bSkipBlocks      = false;
-                    pSrc = ppSources[0];
+                    bRotation = true;
                 }
             }
-            else if (i == 1 && bExtraRotationPhase)
-            {
-                // bExtraRotationPhase == true means that Intermediate2 was used as a
-                // temp output resource in the previous phase and now is to be 
-                // used as an input
-                pSrc = &m_Intermediate2;
-                pSrc->SurfType = SURF_IN_SUBSTREAM; // set the surface type to substream
-                bExtraRotationPhase = false;        // reset rotation phase
-            }
-            else
+        }
+        else
+        {
+            for (i = 0; index < (uint32_t)iSources || bExtraRotationPhase; i++)
             {
-                pSrc = ppSources[index];
-                index++;
-            }
+                // Set previous output as the first layer
+                if (i == 0 && phase != 0)
+                {
+                    // Optimization for 2 layers composition (with sub-layer rotation) usage case , in the second phase, the first layer should be layer0
+                    if (!m_bApplyTwoLayersCompOptimize || (iSources != 2) || (ppSources[1]->Rotation == VPHAL_ROTATION_IDENTITY))
+                    {
+                        pSrc = pOutput;
+                    }
+                    else
+                    {
+                        CompositeParams.pColorFillParams = pcRenderParams->pColorFillParams;
+                        CompositeParams.bSkipBlocks      = false;
+                        pSrc = ppSources[0];
+                    }
+                }
+                else if (i == 1 && bExtraRotationPhase)
+                {
+                    // bExtraRotationPhase == true means that Intermediate2 was used as a
+                    // temp output resource in the previous phase and now is to be 
+                    // used as an input
+                    pSrc = &m_Intermediate2;
+                    pSrc->SurfType = SURF_IN_SUBSTREAM; // set the surface type to substream
+                    bExtraRotationPhase = false;        // reset rotation phase
+                }
+                else
+                {
+                    pSrc = ppSources[index];
+                    index++;
+                }
 
-            // Set if primary is present
-            if (pSrc->SurfType == SURF_IN_PRIMARY)
-            {
-                bPrimary = true;
-            }
+                // Set if primary is present
+                if (pSrc->SurfType == SURF_IN_PRIMARY)
+                {
+                    bPrimary = true;
+                }
 
-            // Add layer to the compositing - breaks at end of phase
-            pSrc->iLayerID = i;
+                // Add layer to the compositing - breaks at end of phase
+                pSrc->iLayerID = i;
 
-            if (!AddCompLayer(&CompositeParams, pSrc))
-            {
-                bLastPhase = false;
-                index--;
-                break;
-            }
+                if (!AddCompLayer(&CompositeParams, pSrc))
+                {
+                    bLastPhase = false;
+                    index--;
+                    break;
+                }
 
-            if (pSrc->Rotation != VPHAL_ROTATION_IDENTITY)
-            {
-                bRotation = true;
+                if (pSrc->Rotation != VPHAL_ROTATION_IDENTITY)
+                {
+                    bRotation = true;
+                }
             }
         }
 
@@ -4779,7 +4984,9 @@ finish:
 
 //!
 //! \brief    Render Composite BatchBuffer
-//! \details  Render Composite BatchBuffer, setup Media Object header and inline data
+//! \details  Render Composite BatchBuffer, setup Media Object header and inline data.
+//!           The block masks of the columns are computed once for all the rows, and
+//!           every media object is a copy of the first one with its own inline data.
 //! \param    [in] pBatchBuffer
 //!           Pointer to BatchBuffer
 //! \param    [in] pRenderingData
@@ -4796,24 +5003,31 @@ bool CompositeState::RenderBuffer(
     MOS_STATUS                          eStatus;
     PVPHAL_BB_COMP_ARGS                 pBbArgs;
     MEDIA_OBJECT_KA2_STATIC_DATA        *pStatic;
-    MEDIA_OBJECT_KA2_INLINE_DATA        *pInline;
-    MEDIA_OBJECT_NLAS_INLINE_DATA       *pInlineNLAS;
-    VPHAL_COMPOSITE_MO_INLINE_DATA      MOInlineData;
     MHW_MEDIA_OBJECT_PARAMS             MediaObjectParams;
+    MHW_BATCH_BUFFER                    TemplateBuffer;
+    uint8_t                             Template[VPHAL_COMP_MO_HEADER_MAX + sizeof(VPHAL_COMPOSITE_MO_INLINE_DATA)];
+    VPHAL_COMPOSITE_BLOCK_ROWS          Rows;
+    uint8_t                             *pGeometry;
+    uint16_t                            *pwMaskX;
     uint16_t                            wMask;
     uint16_t                            wCombinedMask;
     PRECT                               rcDst;
+    int32_t                             iLayers, iLayer;
+    int32_t                             iColumns, iRows;
     int32_t                             x, y, dx, dy;
     int32_t                             xl, xr, yt, yb;
+    uint32_t                            dwBlocks;
+    uint32_t                            dwSize;
+    uint32_t                            dwBands;
     bool                                bResult;
-    float                               fSrcX[8];
     uint32_t                            applyRotation;
     uint32_t                            targetIndex;
 
     bResult             = false;
+    pGeometry           = nullptr;
     pRenderHal          = m_pRenderHal;
     pMhwMiInterface     = pRenderHal->pMhwMiInterface;
-    MOS_ZeroMemory(fSrcX, sizeof(float) * 8);
+    MOS_ZeroMemory(&Rows, sizeof(Rows));
 
     if (pRenderHal->pfnLockBB(pRenderHal, pBatchBuffer) != MOS_STATUS_SUCCESS)
     {
@@ -4823,17 +5037,45 @@ bool CompositeState::RenderBuffer(
 
     pBbArgs   = &pRenderingData->BbArgs;
     rcDst     = pBbArgs->rcDst;
+    pStatic   = &pRenderingData->Static;
+    iLayers   = pRenderingData->iLayers;
+    iColumns  = pRenderingData->iBlocksX;
+    iRows     = pRenderingData->iBlocksY;
 
     MOS_ZeroMemory(&MediaObjectParams, sizeof(MediaObjectParams));
     MediaObjectParams.dwInterfaceDescriptorOffset   = pRenderingData->iMediaID;
     MediaObjectParams.dwInlineDataSize              =
         pRenderingData->iCmdInlineSize + pRenderingData->iNLASInlineSize;
 
-    MOInlineData.NLASInline     = g_cInit_MEDIA_OBJECT_NLAS_INLINE_DATA;
-    MOInlineData.KA2Inline      = pRenderingData->Inline;
-    pInline                     = &MOInlineData.KA2Inline;
-    pInlineNLAS                 = &MOInlineData.NLASInline;
-    pStatic                     = &pRenderingData->Static;
+    Rows.pCompositeState        = this;
+    Rows.pRenderingData         = pRenderingData;
+    Rows.InitInline.NLASInline  = g_cInit_MEDIA_OBJECT_NLAS_INLINE_DATA;
+    Rows.InitInline.KA2Inline   = pRenderingData->Inline;
+    Rows.dwInlineSize           = MediaObjectParams.dwInlineDataSize;
+
+    if (pBbArgs->bEnableNLAS)
+    {
+        MediaObjectParams.pInlineData = &Rows.InitInline.NLASInline;
+    }
+    else
+    {
+        MediaObjectParams.pInlineData = &Rows.InitInline.KA2Inline;
+    }
+
+    // The MEDIA_OBJECT command only depends on the inline data, add one to a
+    // local buffer to get the part that is the same for every block
+    MOS_ZeroMemory(&TemplateBuffer, sizeof(TemplateBuffer));
+    TemplateBuffer.pData      = Template;
+    TemplateBuffer.iSize      = sizeof(Template);
+    TemplateBuffer.iRemaining = sizeof(Template);
+    VPHAL_RENDER_CHK_STATUS(pRenderHal->pMhwRenderInterface->AddMediaObject(
+        nullptr,
+        &TemplateBuffer,
+        &MediaObjectParams));
+
+    Rows.pHeader      = Template;
+    Rows.dwObjectSize = (uint32_t)TemplateBuffer.iCurrent;
+    Rows.dwHeaderSize = Rows.dwObjectSize - MOS_ALIGN_CEIL(Rows.dwInlineSize, sizeof(uint32_t));
 
     // Traverse blocks in the render target area. If destination is not 16x16 
     // pixel aligned, the top-most row and left-most column will launch MO cmds
@@ -4854,321 +5096,167 @@ bool CompositeState::RenderBuffer(
         targetIndex     = 1;
     }
 
-    y  = pBbArgs->rcOutput.top;
-    for (dy = 0; dy < pRenderingData->iBlocksY; dy++)
+    // Gen9+ Possible HW Rotation, kernels not available yet.
+    // DW09 bits 2:0 indicate RotationMirrorMode, 
+    // bit 3 indicates if RotationMirrorMode applies to all layers, 
+    // =1 means to apply for all layers, =0 means only for Layer0
+    // In case of RatationMirrorAllLayer(bit3) = 0, all layers from 
+    // layer 1 onwards must be no rotation in a single rendering phase.
+    Rows.Rotation[0] = (VPHAL_ROTATION)(pStatic->DW09.RotationMirrorMode & applyRotation);
+    for (iLayer = 1; iLayer < VPHAL_COMP_MAX_LAYERS; iLayer++)
     {
-        pInline->DW00.DestinationBlockVerticalOrigin = y;
+        Rows.Rotation[iLayer] = (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode *
+            pStatic->DW09.RotationMirrorAllLayer) & applyRotation);
+    }
 
-        wCombinedMask = (pBbArgs->bSkipBlocks) ? 0x0000 : 0xffff;
-        switch (pRenderingData->iLayers)
-        {
-            case 8:
-                yt = rcDst[7].top    - y;
-                yb = rcDst[7].bottom - y;
-                yt = MOS_MIN(MOS_MAX(0, yt), VPHAL_COMP_BLOCK_HEIGHT);
-                yb = MOS_MIN(MOS_MAX(0, yb), VPHAL_COMP_BLOCK_HEIGHT);
-                wMask = (0xffff << yt) & ((0x0001 << yb) - 1);
-                wCombinedMask |= wMask;
-
-                // Gen9+ Possible HW Rotation, kernels not available yet.
-                // DW09 bits 2:0 indicate RotationMirrorMode, 
-                // bit 3 indicates if RotationMirrorMode applies to all layers, 
-                // =1 means to apply for all layers, =0 means only for Layer0
-                // In case of RatationMirrorAllLayer(bit3) = 0, all layers from 
-                // layer 1 onwards must be no rotation in a single rendering phase.
-                SetInline16x16Mask(
-                    (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                    pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                    (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW12, 
-                    wMask, 
-                    VPHAL_VERTICAL_16X16BLOCK_MASK);
-            case 7:
-                yt = rcDst[6].top    - y;
-                yb = rcDst[6].bottom - y;
-                yt = MOS_MIN(MOS_MAX(0, yt), VPHAL_COMP_BLOCK_HEIGHT);
-                yb = MOS_MIN(MOS_MAX(0, yb), VPHAL_COMP_BLOCK_HEIGHT);
-                wMask = (0xffff << yt) & ((0x0001 << yb) - 1);
-                wCombinedMask |= wMask;
-                SetInline16x16Mask(
-                    (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                    pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                    (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW11, 
-                    wMask, 
-                    VPHAL_VERTICAL_16X16BLOCK_MASK);
-            case 6:
-                yt = rcDst[5].top    - y;
-                yb = rcDst[5].bottom - y;
-                yt = MOS_MIN(MOS_MAX(0, yt), VPHAL_COMP_BLOCK_HEIGHT);
-                yb = MOS_MIN(MOS_MAX(0, yb), VPHAL_COMP_BLOCK_HEIGHT);
-                wMask = (0xffff << yt) & ((0x0001 << yb) - 1);
-                wCombinedMask |= wMask;
-                SetInline16x16Mask(
-                    (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                    pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                    (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW10, 
-                    wMask, 
-                    VPHAL_VERTICAL_16X16BLOCK_MASK);
-            case 5:
-                yt = rcDst[4].top    - y;
-                yb = rcDst[4].bottom - y;
-                yt = MOS_MIN(MOS_MAX(0, yt), VPHAL_COMP_BLOCK_HEIGHT);
-                yb = MOS_MIN(MOS_MAX(0, yb), VPHAL_COMP_BLOCK_HEIGHT);
-                wMask = (0xffff << yt) & ((0x0001 << yb) - 1);
-                wCombinedMask |= wMask;
-                SetInline16x16Mask(
-                    (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                    pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                    (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW09, 
-                    wMask, 
-                    VPHAL_VERTICAL_16X16BLOCK_MASK);
-            case 4:
-                yt = rcDst[3].top    - y;
-                yb = rcDst[3].bottom - y;
-                yt = MOS_MIN(MOS_MAX(0, yt), VPHAL_COMP_BLOCK_HEIGHT);
-                yb = MOS_MIN(MOS_MAX(0, yb), VPHAL_COMP_BLOCK_HEIGHT);
-                wMask = (0xffff << yt) & ((0x0001 << yb) - 1);
-                wCombinedMask |= wMask;
-                SetInline16x16Mask(
-                    (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                    pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                    (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW08, 
-                    wMask, 
-                    VPHAL_VERTICAL_16X16BLOCK_MASK);
-            case 3:
-                yt = rcDst[2].top    - y;
-                yb = rcDst[2].bottom - y;
-                yt = MOS_MIN(MOS_MAX(0, yt), VPHAL_COMP_BLOCK_HEIGHT);
-                yb = MOS_MIN(MOS_MAX(0, yb), VPHAL_COMP_BLOCK_HEIGHT);
-                wMask = (0xffff << yt) & ((0x0001 << yb) - 1);
-                wCombinedMask |= wMask;
-                SetInline16x16Mask(
-                    (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                    pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                    (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW03, 
-                    wMask, 
-                    VPHAL_VERTICAL_16X16BLOCK_MASK);
-            case 2:
-                yt = rcDst[1].top    - y;
-                yb = rcDst[1].bottom - y;
-                yt = MOS_MIN(MOS_MAX(0, yt), VPHAL_COMP_BLOCK_HEIGHT);
-                yb = MOS_MIN(MOS_MAX(0, yb), VPHAL_COMP_BLOCK_HEIGHT);
-                wMask = (0xffff << yt) & ((0x0001 << yb) - 1);
-                wCombinedMask |= wMask;
-                SetInline16x16Mask(
-                    (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                    pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                    (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW02, 
-                    wMask, 
-                    VPHAL_VERTICAL_16X16BLOCK_MASK);
-            case 1:
-                yt = rcDst[0].top    - y;
-                yb = rcDst[0].bottom - y;
-                yt = MOS_MIN(MOS_MAX(0, yt), VPHAL_COMP_BLOCK_HEIGHT);
-                yb = MOS_MIN(MOS_MAX(0, yb), VPHAL_COMP_BLOCK_HEIGHT);
-                wMask = (0xffff << yt) & ((0x0001 << yb) - 1);
-                wCombinedMask |= wMask;
-                SetInline16x16Mask((VPHAL_ROTATION)
-                    (pStatic->DW09.RotationMirrorMode & applyRotation), 
-                    (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW01, 
-                    wMask, 
-                    VPHAL_VERTICAL_16X16BLOCK_MASK);
-                break;
-            case 0:
-                // This case is true only for colorfill only cases. Force block mask to zero.
-                pInline->DW01.VerticalBlockCompositeMaskLayer0 = 0;
-                break;
-        }
+    // get the horizontal origin - the second term is necessary to ensure
+    // accurate computation of the starting value of fSrcX when the output
+    // rectangle does not start at 0 (for example, split-screen demo mode)
+    x = pBbArgs->rcOutput.left;
+    switch (iLayers)
+    {
+        case 8:
+            Rows.fSrcX[7] = pStatic->DW47.HorizontalFrameOriginLayer7 +
+                ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
+        case 7:
+            Rows.fSrcX[6] = pStatic->DW46.HorizontalFrameOriginLayer6 +
+                ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
+        case 6:
+            Rows.fSrcX[5] = pStatic->DW45.HorizontalFrameOriginLayer5 +
+                ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
+        case 5:
+            Rows.fSrcX[4] = pStatic->DW44.HorizontalFrameOriginLayer4 +
+                ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
+        case 4:
+            Rows.fSrcX[3] = pStatic->DW43.HorizontalFrameOriginLayer3 +
+                ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
+        case 3:
+            Rows.fSrcX[2] = pStatic->DW42.HorizontalFrameOriginLayer2 +
+                ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
+        case 2:
+            Rows.fSrcX[1] = pStatic->DW41.HorizontalFrameOriginLayer1 +
+                ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
+        case 1:
+            Rows.fSrcX[0] = pStatic->DW40.HorizontalFrameOriginLayer0 +
+                ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
+            break;
+        case 0:
+        default:
+            break;
+    }
 
-        // Skip row if no blocks are flagged for rendering
-        if (!wCombinedMask)
+    if (iColumns <= 0 || iRows <= 0)
+    {
+        iColumns = iRows = 0;
+    }
+    else
+    {
+        pGeometry = (uint8_t *)MOS_AllocMemory(
+            iColumns * (sizeof(int32_t) + VPHAL_COMP_MAX_LAYERS * sizeof(uint16_t) + sizeof(bool)) +
+            iRows    * (sizeof(int32_t) + sizeof(bool)));
+        if (pGeometry == nullptr)
         {
-            y += VPHAL_COMP_BLOCK_HEIGHT;
-            y -= y % VPHAL_COMP_BLOCK_HEIGHT;
-            continue;
+            VPHAL_RENDER_ASSERTMESSAGE("Failed to allocate block geometry.");
+            goto finish;
         }
+        Rows.piOriginX   = (int32_t *)pGeometry;
+        Rows.piOriginY   = Rows.piOriginX + iColumns;
+        Rows.pwMaskX     = (uint16_t *)(Rows.piOriginY + iRows);
+        Rows.pbAddColumn = (bool *)(Rows.pwMaskX + iColumns * VPHAL_COMP_MAX_LAYERS);
+        Rows.pbAddRow    = Rows.pbAddColumn + iColumns;
+    }
 
-        x = pBbArgs->rcOutput.left;
-
-        // get the horizontal origin - the second term is necessary to ensure
-        // accurate computation of the starting value of fSrcX when the output
-        // rectangle does not start at 0 (for example, split-screen demo mode)
-        switch (pRenderingData->iLayers)
-        {
-            case 8:
-                fSrcX[7] = pStatic->DW47.HorizontalFrameOriginLayer7 +
-                    ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
-            case 7:
-                fSrcX[6] = pStatic->DW46.HorizontalFrameOriginLayer6 +
-                    ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
-            case 6:
-                fSrcX[5] = pStatic->DW45.HorizontalFrameOriginLayer5 +
-                    ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
-            case 5:
-                fSrcX[4] = pStatic->DW44.HorizontalFrameOriginLayer4 +
-                    ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
-            case 4:
-                fSrcX[3] = pStatic->DW43.HorizontalFrameOriginLayer3 +
-                    ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
-            case 3:
-                fSrcX[2] = pStatic->DW42.HorizontalFrameOriginLayer2 +
-                    ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
-            case 2:
-                fSrcX[1] = pStatic->DW41.HorizontalFrameOriginLayer1 +
-                    ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
-            case 1:
-                fSrcX[0] = pStatic->DW40.HorizontalFrameOriginLayer0 +
-                    ((float)(x) / (float)(pRenderingData->pTarget[targetIndex]->dwWidth));
-                break;
-            case 0:
-            default:
-                fSrcX[0] = fSrcX[1] = fSrcX[2] = fSrcX[3] = 0;
-                fSrcX[4] = fSrcX[5] = fSrcX[6] = fSrcX[7] = 0;
-                break;
+    // Horizontal masks of the layers, the same for every row
+    Rows.dwRowSize = 0;
+    for (dx = 0; dx < iColumns; dx++)
+    {
+        Rows.piOriginX[dx] = x;
+        pwMaskX            = Rows.pwMaskX + dx * VPHAL_COMP_MAX_LAYERS;
+
+        wCombinedMask = (pBbArgs->bSkipBlocks) ? 0x0000 : 0xffff;
+        for (iLayer = 0; iLayer < iLayers; iLayer++)
+        {
+            xl = rcDst[iLayer].left  - x;
+            xr = rcDst[iLayer].right - x;
+            xl = MOS_MIN(MOS_MAX(0, xl), VPHAL_COMP_BLOCK_WIDTH);
+            xr = MOS_MIN(MOS_MAX(0, xr), VPHAL_COMP_BLOCK_WIDTH);
+            wMask = (0xffff << xl) & ((0x0001 << xr) - 1);
+            wCombinedMask |= wMask;
+            pwMaskX[iLayer] = wMask;
         }
 
-        for (dx = 0; dx < pRenderingData->iBlocksX; dx++)
+        Rows.pbAddColumn[dx] = (wCombinedMask != 0);
+        if (Rows.pbAddColumn[dx])
         {
-            pInline->DW00.DestinationBlockHorizontalOrigin = x;
+            Rows.dwRowSize += Rows.dwObjectSize;
+        }
 
-            wCombinedMask = (pBbArgs->bSkipBlocks) ? 0x0000 : 0xffff;
-            switch (pRenderingData->iLayers)
-            {
-                case 8:
-                    xl = rcDst[7].left  - x;
-                    xr = rcDst[7].right - x;
-                    xl = MOS_MIN(MOS_MAX(0, xl), VPHAL_COMP_BLOCK_WIDTH);
-                    xr = MOS_MIN(MOS_MAX(0, xr), VPHAL_COMP_BLOCK_WIDTH);
-                    wMask = (0xffff << xl) & ((0x0001 << xr) - 1);
-                    wCombinedMask |= wMask;
-                    SetInline16x16Mask( 
-                        (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                        pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                        (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW12, 
-                        wMask, 
-                        VPHAL_HORIZONTAL_16X16BLOCK_MASK);
-                case 7:
-                    xl = rcDst[6].left  - x;
-                    xr = rcDst[6].right - x;
-                    xl = MOS_MIN(MOS_MAX(0, xl), VPHAL_COMP_BLOCK_WIDTH);
-                    xr = MOS_MIN(MOS_MAX(0, xr), VPHAL_COMP_BLOCK_WIDTH);
-                    wMask = (0xffff << xl) & ((0x0001 << xr) - 1);
-                    wCombinedMask |= wMask;
-                    SetInline16x16Mask(
-                        (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                        pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                        (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW11, 
-                        wMask, 
-                        VPHAL_HORIZONTAL_16X16BLOCK_MASK);
-                case 6:
-                    xl = rcDst[5].left  - x;
-                    xr = rcDst[5].right - x;
-                    xl = MOS_MIN(MOS_MAX(0, xl), VPHAL_COMP_BLOCK_WIDTH);
-                    xr = MOS_MIN(MOS_MAX(0, xr), VPHAL_COMP_BLOCK_WIDTH);
-                    wMask = (0xffff << xl) & ((0x0001 << xr) - 1);
-                    wCombinedMask |= wMask;
-                    SetInline16x16Mask(
-                        (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                        pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                        (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW10, 
-                        wMask, 
-                        VPHAL_HORIZONTAL_16X16BLOCK_MASK);
-                case 5:
-                    xl = rcDst[4].left  - x;
-                    xr = rcDst[4].right - x;
-                    xl = MOS_MIN(MOS_MAX(0, xl), VPHAL_COMP_BLOCK_WIDTH);
-                    xr = MOS_MIN(MOS_MAX(0, xr), VPHAL_COMP_BLOCK_WIDTH);
-                    wMask = (0xffff << xl) & ((0x0001 << xr) - 1);
-                    wCombinedMask |= wMask;
-                    SetInline16x16Mask(
-                        (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                        pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                        (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW09, 
-                        wMask, 
-                        VPHAL_HORIZONTAL_16X16BLOCK_MASK);
-                case 4:
-                    xl = rcDst[3].left  - x;
-                    xr = rcDst[3].right - x;
-                    xl = MOS_MIN(MOS_MAX(0, xl), VPHAL_COMP_BLOCK_WIDTH);
-                    xr = MOS_MIN(MOS_MAX(0, xr), VPHAL_COMP_BLOCK_WIDTH);
-                    wMask = (0xffff << xl) & ((0x0001 << xr) - 1);
-                    wCombinedMask |= wMask;
-                    SetInline16x16Mask(
-                        (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                        pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                        (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW08, 
-                        wMask, 
-                        VPHAL_HORIZONTAL_16X16BLOCK_MASK);
-                case 3:
-                    xl = rcDst[2].left  - x;
-                    xr = rcDst[2].right - x;
-                    xl = MOS_MIN(MOS_MAX(0, xl), VPHAL_COMP_BLOCK_WIDTH);
-                    xr = MOS_MIN(MOS_MAX(0, xr), VPHAL_COMP_BLOCK_WIDTH);
-                    wMask = (0xffff << xl) & ((0x0001 << xr) - 1);
-                    wCombinedMask |= wMask;
-                    SetInline16x16Mask(
-                        (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                        pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                        (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW03, 
-                        wMask, 
-                        VPHAL_HORIZONTAL_16X16BLOCK_MASK);
-                case 2:
-                    xl = rcDst[1].left  - x;
-                    xr = rcDst[1].right - x;
-                    xl = MOS_MIN(MOS_MAX(0, xl), VPHAL_COMP_BLOCK_WIDTH);
-                    xr = MOS_MIN(MOS_MAX(0, xr), VPHAL_COMP_BLOCK_WIDTH);
-                    wMask = (0xffff << xl) & ((0x0001 << xr) - 1);
-                    wCombinedMask |= wMask;
-                    SetInline16x16Mask(
-                        (VPHAL_ROTATION)((pStatic->DW09.RotationMirrorMode * 
-                        pStatic->DW09.RotationMirrorAllLayer) & applyRotation),
-                        (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW02, 
-                        wMask, 
-                        VPHAL_HORIZONTAL_16X16BLOCK_MASK);
-                case 1:
-                    xl = rcDst[0].left  - x;
-                    xr = rcDst[0].right - x;
-                    xl = MOS_MIN(MOS_MAX(0, xl), VPHAL_COMP_BLOCK_WIDTH);
-                    xr = MOS_MIN(MOS_MAX(0, xr), VPHAL_COMP_BLOCK_WIDTH);
-                    wMask = (0xffff << xl) & ((0x0001 << xr) - 1);
-                    wCombinedMask |= wMask;
-                    SetInline16x16Mask((VPHAL_ROTATION)
-                        (pStatic->DW09.RotationMirrorMode & applyRotation),
-                        (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW01,
-                        wMask,
-                        VPHAL_HORIZONTAL_16X16BLOCK_MASK);
-                    break;
-                case 0:
-                    // This case is true only for colorfill only cases. Force block mask to zero.
-                    pInline->DW01.HorizontalBlockCompositeMaskLayer0 = 0;
-                    break;
-            }
+        x += VPHAL_COMP_BLOCK_WIDTH;
+        x -= x % VPHAL_COMP_BLOCK_WIDTH;
+    }
 
-            ModifyInlineData(pBbArgs, pRenderingData, pStatic, pInline, pInlineNLAS, x, fSrcX);
-            
-            if (wCombinedMask)
-            {
-                if (pBbArgs->bEnableNLAS)
-                {
-                    MediaObjectParams.pInlineData = &MOInlineData.NLASInline;
-                }
-                else
-                {
-                    MediaObjectParams.pInlineData = &MOInlineData.KA2Inline;
-                }
-                VPHAL_RENDER_CHK_STATUS(pRenderHal->pMhwRenderInterface->AddMediaObject(
-                    nullptr,
-                    pBatchBuffer,
-                    &MediaObjectParams));
-            }
+    // Skip rows if no blocks are flagged for rendering
+    dwBlocks = 0;
+    y        = pBbArgs->rcOutput.top;
+    for (dy = 0; dy < iRows; dy++)
+    {
+        Rows.piOriginY[dy] = y;
 
-            x += VPHAL_COMP_BLOCK_WIDTH;
-            x -= x % VPHAL_COMP_BLOCK_WIDTH;
+        wCombinedMask = (pBbArgs->bSkipBlocks) ? 0x0000 : 0xffff;
+        for (iLayer = 0; iLayer < iLayers; iLayer++)
+        {
+            yt = rcDst[iLayer].top    - y;
+            yb = rcDst[iLayer].bottom - y;
+            yt = MOS_MIN(MOS_MAX(0, yt), VPHAL_COMP_BLOCK_HEIGHT);
+            yb = MOS_MIN(MOS_MAX(0, yb), VPHAL_COMP_BLOCK_HEIGHT);
+            wMask = (0xffff << yt) & ((0x0001 << yb) - 1);
+            wCombinedMask |= wMask;
+        }
+
+        Rows.pbAddRow[dy] = (wCombinedMask != 0);
+        if (Rows.pbAddRow[dy])
+        {
+            dwBlocks += iColumns;
         }
 
         y += VPHAL_COMP_BLOCK_HEIGHT;
         y -= y % VPHAL_COMP_BLOCK_HEIGHT;
     }
 
+    // Reserve all the media objects at once, rows are copied to known offsets
+    dwSize = 0;
+    for (dy = 0; dy < iRows; dy++)
+    {
+        dwSize += Rows.pbAddRow[dy] ? Rows.dwRowSize : 0;
+    }
+
+    Rows.pData = (uint8_t *)Mhw_ReserveCommandBB(pBatchBuffer, dwSize);
+    if (Rows.pData == nullptr)
+    {
+        VPHAL_RENDER_ASSERTMESSAGE("Failed to reserve the media objects.");
+        goto finish;
+    }
+
+    dwBands = 1;
+    if (dwBlocks >= VPHAL_COMP_BB_PARALLEL_MIN_BLOCKS &&
+        MOS_TaskPool_GetThreadCount() > 1)
+    {
+        dwBands = MOS_MIN(MOS_TaskPool_GetThreadCount() * VPHAL_COMP_BB_BANDS_PER_THREAD, (uint32_t)iRows);
+    }
+    Rows.iRowsPerBand = MOS_MAX(1, (int32_t)MOS_ROUNDUP_DIVIDE(iRows, dwBands));
+    dwBands           = MOS_ROUNDUP_DIVIDE(iRows, Rows.iRowsPerBand);
+
+    if (dwBands > 1)
+    {
+        VPHAL_RENDER_CHK_STATUS(MOS_TaskPool_Run(RenderBufferBand, &Rows, dwBands, MOS_TaskPool_GetThreadCount()));
+    }
+    else
+    {
+        RenderBufferRows(&Rows, 0, iRows);
+    }
+
+    VPHAL_RENDER_CHK_STATUS(Mhw_CommitCommandBB(pBatchBuffer, dwSize));
+
     VPHAL_RENDER_CHK_STATUS(pMhwMiInterface->AddMiBatchBufferEnd(nullptr, pBatchBuffer));
 
     if (pRenderHal->pfnUnlockBB(pRenderHal, pBatchBuffer) != MOS_STATUS_SUCCESS)
@@ -5181,6 +5269,7 @@ bool CompositeState::RenderBuffer(
     bResult = true;
 
 finish:
+    MOS_FreeMemory(pGeometry);
     if (pBatchBuffer && pBatchBuffer->bLocked)
     {
         // Only happens in Error cases
@@ -5192,6 +5281,155 @@ finish:
     return bResult;
 }
 
+//!
+//! \brief    Add the media objects of a range of block rows
+//! \details  The inline data carries over from row to row, so the rendered row above the
+//!           range and the rows after it are processed again without adding commands
+//! \param    [in] pRows
+//!           Pointer to the block rows of the batch buffer
+//! \param    [in] iFirstRow
+//!           First row of the range
+//! \param    [in] iLastRow
+//!           Row after the range
+//! \return   void
+//!
+void CompositeState::RenderBufferRows(
+    PVPHAL_COMPOSITE_BLOCK_ROWS     pRows,
+    int32_t                         iFirstRow,
+    int32_t                         iLastRow)
+{
+    PVPHAL_RENDERING_DATA_COMPOSITE     pRenderingData;
+    PVPHAL_BB_COMP_ARGS                 pBbArgs;
+    MEDIA_OBJECT_KA2_STATIC_DATA        *pStatic;
+    MEDIA_OBJECT_KA2_INLINE_DATA        *pInline;
+    MEDIA_OBJECT_NLAS_INLINE_DATA       *pInlineNLAS;
+    VPHAL_COMPOSITE_MO_INLINE_DATA      MOInlineData;
+    PVPHAL_16X16BLOCK_COMPOSITE_MASK    pLayerMask[VPHAL_COMP_MAX_LAYERS];
+    uint8_t                             *pInlineData;
+    uint8_t                             *pCmd;
+    uint16_t                            *pwMaskX;
+    uint16_t                            wMask;
+    PRECT                               rcDst;
+    int32_t                             iLayers, iLayer;
+    int32_t                             x, y, dx, dy, yt, yb;
+    int32_t                             iStartRow;
+    float                               fSrcX[8];
+
+    pRenderingData  = pRows->pRenderingData;
+    pBbArgs         = &pRenderingData->BbArgs;
+    pStatic         = &pRenderingData->Static;
+    rcDst           = pBbArgs->rcDst;
+    iLayers         = pRenderingData->iLayers;
+
+    MOInlineData    = pRows->InitInline;
+    pInline         = &MOInlineData.KA2Inline;
+    pInlineNLAS     = &MOInlineData.NLASInline;
+    pInlineData     = (pBbArgs->bEnableNLAS) ? (uint8_t *)pInlineNLAS : (uint8_t *)pInline;
+    MOS_ZeroMemory(fSrcX, sizeof(fSrcX));
+
+    pLayerMask[0]   = (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW01;
+    pLayerMask[1]   = (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW02;
+    pLayerMask[2]   = (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW03;
+    pLayerMask[3]   = (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW08;
+    pLayerMask[4]   = (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW09;
+    pLayerMask[5]   = (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW10;
+    pLayerMask[6]   = (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW11;
+    pLayerMask[7]   = (PVPHAL_16X16BLOCK_COMPOSITE_MASK)&pInline->DW12;
+
+    // Start from the last rendered row above the range, the rows in between only set vertical masks
+    pCmd      = pRows->pData;
+    iStartRow = 0;
+    for (dy = 0; dy < iFirstRow; dy++)
+    {
+        if (pRows->pbAddRow[dy])
+        {
+            pCmd     += pRows->dwRowSize;
+            iStartRow = dy;
+        }
+    }
+
+    for (dy = iStartRow; dy < iLastRow; dy++)
+    {
+        y = pRows->piOriginY[dy];
+        pInline->DW00.DestinationBlockVerticalOrigin = y;
+
+        for (iLayer = iLayers - 1; iLayer >= 0; iLayer--)
+        {
+            yt = rcDst[iLayer].top    - y;
+            yb = rcDst[iLayer].bottom - y;
+            yt = MOS_MIN(MOS_MAX(0, yt), VPHAL_COMP_BLOCK_HEIGHT);
+            yb = MOS_MIN(MOS_MAX(0, yb), VPHAL_COMP_BLOCK_HEIGHT);
+            wMask = (0xffff << yt) & ((0x0001 << yb) - 1);
+            SetInline16x16Mask(pRows->Rotation[iLayer], pLayerMask[iLayer], wMask, VPHAL_VERTICAL_16X16BLOCK_MASK);
+        }
+        if (iLayers == 0)
+        {
+            // This case is true only for colorfill only cases. Force block mask to zero.
+            pInline->DW01.VerticalBlockCompositeMaskLayer0 = 0;
+        }
+
+        if (!pRows->pbAddRow[dy])
+        {
+            continue;
+        }
+
+        MOS_SecureMemcpy(fSrcX, iLayers * sizeof(float), pRows->fSrcX, iLayers * sizeof(float));
+        if (iLayers == 0)
+        {
+            MOS_ZeroMemory(fSrcX, sizeof(fSrcX));
+        }
+
+        for (dx = 0; dx < pRenderingData->iBlocksX; dx++)
+        {
+            x       = pRows->piOriginX[dx];
+            pwMaskX = pRows->pwMaskX + dx * VPHAL_COMP_MAX_LAYERS;
+            pInline->DW00.DestinationBlockHorizontalOrigin = x;
+
+            for (iLayer = iLayers - 1; iLayer >= 0; iLayer--)
+            {
+                SetInline16x16Mask(pRows->Rotation[iLayer], pLayerMask[iLayer], pwMaskX[iLayer], VPHAL_HORIZONTAL_16X16BLOCK_MASK);
+            }
+            if (iLayers == 0)
+            {
+                // This case is true only for colorfill only cases. Force block mask to zero.
+                pInline->DW01.HorizontalBlockCompositeMaskLayer0 = 0;
+            }
+
+            ModifyInlineData(pBbArgs, pRenderingData, pStatic, pInline, pInlineNLAS, x, fSrcX);
+
+            // Rows above the range only rebuild the inline data
+            if (dy >= iFirstRow && pRows->pbAddColumn[dx])
+            {
+                MOS_SecureMemcpy(pCmd, pRows->dwHeaderSize, pRows->pHeader, pRows->dwHeaderSize);
+                MOS_SecureMemcpy(pCmd + pRows->dwHeaderSize, pRows->dwInlineSize, pInlineData, pRows->dwInlineSize);
+                pCmd += pRows->dwObjectSize;
+            }
+        }
+    }
+}
+
+//!
+//! \brief    MOS task pool callback adding the media objects of one row band
+//! \param    [in] pContext
+//!           Pointer to the block rows of the batch buffer
+//! \param    [in] index
+//!           Index of the band
+//! \return   void
+//!
+void CompositeState::RenderBufferBand(
+    void                            *pContext,
+    uint32_t                        index)
+{
+    PVPHAL_COMPOSITE_BLOCK_ROWS pRows = (PVPHAL_COMPOSITE_BLOCK_ROWS)pContext;
+    int32_t                     iFirstRow;
+    int32_t                     iLastRow;
+
+    iFirstRow = (int32_t)index * pRows->iRowsPerBand;
+    iLastRow  = MOS_MIN(iFirstRow + pRows->iRowsPerBand, pRows->pRenderingData->iBlocksY);
+
+    pRows->pCompositeState->RenderBufferRows(pRows, iFirstRow, iLastRow);
+}
+
 //!
 //! \brief    Judge whether  media walker pattern  will be vertical or not
 //! \details  if input layer is one , and input is linear format and rotation 90
@@ -5900,6 +6138,9 @@ MOS_STATUS CompositeState::RenderPhase(
         &m_StatusTableUpdateParams,
         kernelCombinedFc));
 
+    // Phases submitted for the frame
+    m_reporting->CompPhases++;
+
 finish:
     if (m_bForceNoneCpCompCall && pOsInterface && pOsInterface->osCpInterface)
     {
@@ -6731,6 +6972,7 @@ void CompositeState::CopyReporting(VphalFeatureReport* pReporting)
 
     pReporting->IEF         = m_reporting->IEF;
     pReporting->ScalingMode = m_reporting->ScalingMode;
+    pReporting->CompPhases  = m_reporting->CompPhases;
 
     if (m_reporting->DeinterlaceMode != VPHAL_DI_REPORT_PROGRESSIVE)
     {
@@ -50,6 +50,10 @@
 #define VPHAL_COMP_SAMPLER_LUMAKEY  4
 #define VPHAL_COMP_MAX_SAMPLER      (VPHAL_COMP_SAMPLER_NEAREST | VPHAL_COMP_SAMPLER_BILINEAR | VPHAL_COMP_SAMPLER_LUMAKEY)
 
+#define VPHAL_COMP_MO_HEADER_MAX            64      //!< Upper bound of the MEDIA_OBJECT size without inline data
+#define VPHAL_COMP_BB_PARALLEL_MIN_BLOCKS   16384   //!< Targets from this number of blocks on are built by row bands in parallel
+#define VPHAL_COMP_BB_BANDS_PER_THREAD      2       //!< Row bands per thread of the MOS task pool
+
 // GRF 8 for unified kernel inline data (NLAS is enabled)
 struct MEDIA_OBJECT_NLAS_INLINE_DATA
 {
@@ -250,6 +254,38 @@ typedef struct _VPHAL_16X16BLOCK_COMPOSITE_MASK
     uint32_t       VerticalBlockCompositeMask      : 16;
 } VPHAL_16X16BLOCK_COMPOSITE_MASK, *PVPHAL_16X16BLOCK_COMPOSITE_MASK;
 
+class CompositeState;
+
+//!
+//! \brief Structure to VPHAL Composite block rows, shared by the threads adding the media objects
+//!
+typedef struct _VPHAL_COMPOSITE_BLOCK_ROWS
+{
+    CompositeState                      *pCompositeState;
+    PVPHAL_RENDERING_DATA_COMPOSITE     pRenderingData;
+    VPHAL_COMPOSITE_MO_INLINE_DATA      InitInline;                         //!< Inline data before the first block
+    float                               fSrcX[8];                           //!< Horizontal origin of the layers at the start of a row
+    VPHAL_ROTATION                      Rotation[VPHAL_COMP_MAX_LAYERS];    //!< Rotation applied to the block masks of each layer
+
+    // Media object template
+    uint8_t                             *pHeader;                           //!< MEDIA_OBJECT command without inline data
+    uint32_t                            dwHeaderSize;
+    uint32_t                            dwInlineSize;                       //!< Inline data bytes copied for each block
+    uint32_t                            dwObjectSize;                       //!< Bytes added for each block
+
+    // Block geometry
+    int32_t                             *piOriginX;                         //!< Horizontal origin of each block column
+    int32_t                             *piOriginY;                         //!< Vertical origin of each block row
+    uint16_t                            *pwMaskX;                           //!< Horizontal mask of each block column, by layer
+    bool                                *pbAddColumn;                       //!< Blocks of the column are rendered
+    bool                                *pbAddRow;                          //!< Blocks of the row are rendered
+    uint32_t                            dwRowSize;                          //!< Bytes added for each rendered row
+
+    // Output
+    uint8_t                             *pData;                             //!< Media objects of the first rendered row
+    int32_t                             iRowsPerBand;
+} VPHAL_COMPOSITE_BLOCK_ROWS, *PVPHAL_COMPOSITE_BLOCK_ROWS;
+
 //!
 //! \brief Class to VPHAL Composite render
 //!
@@ -481,6 +517,9 @@ protected:
 
     //!
     //! \brief    set inline data
+    //! \details  Called for every block of a row from left to right. Rows of large targets
+    //!           are built by several threads at the same time, each with its own copy of
+    //!           the inline data and fSrcX.
     //! \param    [in] pBbArgs
     //!           Pointer to Composite BB argument
     //! \param    [in] pRenderingData
@@ -698,6 +737,65 @@ private:
         PVPHAL_COMPOSITE_PARAMS     pComposite,
         PVPHAL_SURFACE              pSource);
 
+    //!
+    //! \brief    Adds a source layer for composite, leaving the phase unchanged if it does not fit
+    //! \details  AddCompLayer consumes the resources of a layer before checking the limits of the
+    //!           phase, which is only fine when the phase ends on the first layer refused
+    //! \param    [in,out] pComposite
+    //!           Pointer to Composite parameters
+    //! \param    [in] pSource
+    //!           Pointer to Source Surface
+    //! \return   bool
+    //!           Return true if source was added to the phase, otherwise false
+    //!
+    bool TryAddCompLayer(
+        PVPHAL_COMPOSITE_PARAMS     pComposite,
+        PVPHAL_SURFACE              pSource);
+
+    //!
+    //! \brief    Check whether the layers of a multiple phase composition can be regrouped
+    //! \details  Layers are regrouped by AddPhaseLayers, constricted output and rotation
+    //!           done in separate phases keep the input order
+    //! \param    [in] pcRenderParams
+    //!           Pointer to VPHAL_RENDER_PARAMS
+    //! \param    [in] ppSources
+    //!           Pointer to PVPHAL_SURFACE, array of input surfaces
+    //! \param    [in] iSources
+    //!           Number of input surfaces
+    //! \return   bool
+    //!           Return true if AddPhaseLayers can be used
+    //!
+    bool IsLayerRegroupAllowed(
+        PCVPHAL_RENDER_PARAMS       pcRenderParams,
+        PVPHAL_SURFACE              *ppSources,
+        int32_t                     iSources);
+
+    //!
+    //! \brief    Adds the source layers of a phase, not necessarily in input order
+    //! \details  Layers left are tried in Z order. A layer that does not fit is deferred to a
+    //!           later phase, and a layer above it may still be added to this phase as long as
+    //!           its destination rectangle does not overlap any deferred layer, so that the
+    //!           composed output is the same as with the layers in input order
+    //! \param    [in,out] pComposite
+    //!           Pointer to Composite parameters
+    //! \param    [in] ppSources
+    //!           Pointer to PVPHAL_SURFACE, array of input surfaces
+    //! \param    [in] iSources
+    //!           Number of input surfaces
+    //! \param    [in] pPrevOutput
+    //!           Output of the previous phase added as the first layer, nullptr in the first phase
+    //! \param    [in,out] pbComposed
+    //!           Per source flag, set for the sources added to this phase
+    //! \return   bool
+    //!           Return true if all the sources have been added
+    //!
+    bool AddPhaseLayers(
+        PVPHAL_COMPOSITE_PARAMS     pComposite,
+        PVPHAL_SURFACE              *ppSources,
+        int32_t                     iSources,
+        PVPHAL_SURFACE              pPrevOutput,
+        bool                        *pbComposed);
+
     //!
     //! \brief    Adds render target layer for composite
     //! \param    [in,out] pComposite
@@ -889,6 +987,35 @@ private:
         PMHW_BATCH_BUFFER               pBatchBuffer,
         PVPHAL_RENDERING_DATA_COMPOSITE pRenderingData);
 
+    //!
+    //! \brief    Add the media objects of a range of block rows
+    //! \details  The inline data carries over from row to row, so the rendered row above the
+    //!           range and the rows after it are processed again without adding commands
+    //! \param    [in] pRows
+    //!           Pointer to the block rows of the batch buffer
+    //! \param    [in] iFirstRow
+    //!           First row of the range
+    //! \param    [in] iLastRow
+    //!           Row after the range
+    //! \return   void
+    //!
+    void RenderBufferRows(
+        PVPHAL_COMPOSITE_BLOCK_ROWS     pRows,
+        int32_t                         iFirstRow,
+        int32_t                         iLastRow);
+
+    //!
+    //! \brief    MOS task pool callback adding the media objects of one row band
+    //! \param    [in] pContext
+    //!           Pointer to the block rows of the batch buffer
+    //! \param    [in] index
+    //!           Index of the band
+    //! \return   void
+    //!
+    static void RenderBufferBand(
+        void                            *pContext,
+        uint32_t                        index);
+
     //!
     //! \brief    Judge whether 8-tap adaptive filter for all channels should be enabled
     //! \details  Judge whether 8-tap adaptive filter for all channels should be enabled according to the input parameter
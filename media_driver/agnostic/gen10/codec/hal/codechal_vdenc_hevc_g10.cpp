@@ -1171,6 +1171,9 @@ MOS_STATUS CodechalVdencHevcStateG10::SendMeSurfaces(bool using4xMe, PMOS_COMMAN
             m_osInterface,
             &m_resVdencStreamInBuffer[m_currRecycledBufIdx]);
 
+        // HME writes the stream-in buffer, the ROI/dirty rect map has to be written in full next time
+        m_streamInMap[m_currRecycledBufIdx].valid = false;
+
         MOS_ZeroMemory(&surfaceCodecParams, sizeof(surfaceCodecParams));
         surfaceCodecParams.dwSize = MOS_BYTES_TO_DWORDS(m_picHeightInMb * m_picWidthInMb * 32);
         surfaceCodecParams.bIs2DSurface = false;
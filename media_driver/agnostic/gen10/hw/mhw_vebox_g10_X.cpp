@@ -602,12 +602,15 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxState(
     uint32_t                   uiInstanceBaseAddr = 0;
     MHW_RESOURCE_PARAMS        ResourceParams;
 
-    mhw_vebox_g10_X::VEBOX_STATE_CMD cmd;
+    mhw_vebox_g10_X::VEBOX_STATE_CMD *cmd;
 
     MHW_CHK_NULL(m_osInterface);
     MHW_CHK_NULL(pCmdBuffer);
     MHW_CHK_NULL(pVeboxStateCmdParams);
 
+    cmd = Mhw_EmplaceCommand<mhw_vebox_g10_X::VEBOX_STATE_CMD>(pCmdBuffer);
+    MHW_CHK_NULL(cmd);
+
     // Initialize
     eStatus         = MOS_STATUS_SUCCESS;
     pOsInterface    = m_osInterface;
@@ -643,7 +646,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxState(
             ResourceParams.presResource = pVeboxHeapResource;
             ResourceParams.dwOffset     = pVeboxHeap->uiDndiStateOffset + uiInstanceBaseAddr;
         }
-        ResourceParams.pdwCmd          = & (cmd.DW2.Value);
+        ResourceParams.pdwCmd          = & (cmd->DW2.Value);
         ResourceParams.dwLocationInCmd = 2;
         ResourceParams.HwCommandType   = MOS_VEBOX_STATE;
 
@@ -663,7 +666,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxState(
             ResourceParams.presResource = pVeboxHeapResource;
             ResourceParams.dwOffset     = pVeboxHeap->uiIecpStateOffset + uiInstanceBaseAddr;
         }
-        ResourceParams.pdwCmd             = & (cmd.DW4.Value);
+        ResourceParams.pdwCmd             = & (cmd->DW4.Value);
         ResourceParams.dwLocationInCmd    = 4;
         ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
         ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -684,7 +687,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxState(
             ResourceParams.presResource = pVeboxHeapResource;
             ResourceParams.dwOffset     = pVeboxHeap->uiGamutStateOffset + uiInstanceBaseAddr;
         }
-        ResourceParams.pdwCmd             = & (cmd.DW6.Value);
+        ResourceParams.pdwCmd             = & (cmd->DW6.Value);
         ResourceParams.dwLocationInCmd    = 6;
         ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
         ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -705,7 +708,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxState(
             ResourceParams.presResource = pVeboxHeapResource;
             ResourceParams.dwOffset     = pVeboxHeap->uiVertexTableOffset + uiInstanceBaseAddr;
         }
-        ResourceParams.pdwCmd             = & (cmd.DW8.Value);
+        ResourceParams.pdwCmd             = & (cmd->DW8.Value);
         ResourceParams.dwLocationInCmd    = 8;
         ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
         ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -726,7 +729,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxState(
             ResourceParams.presResource = pVeboxHeapResource;
             ResourceParams.dwOffset     = pVeboxHeap->uiCapturePipeStateOffset + uiInstanceBaseAddr;
         }
-        ResourceParams.pdwCmd             = & (cmd.DW10.Value);
+        ResourceParams.pdwCmd             = & (cmd->DW10.Value);
         ResourceParams.dwLocationInCmd    = 10;
         ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
         ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -741,7 +744,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxState(
             MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
             ResourceParams.presResource       = pVeboxStateCmdParams->pLaceLookUpTables;
             ResourceParams.dwOffset           = 0;
-            ResourceParams.pdwCmd             = & (cmd.DW12.Value);
+            ResourceParams.pdwCmd             = & (cmd->DW12.Value);
             ResourceParams.dwLocationInCmd    = 12;
             ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
             ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -763,7 +766,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxState(
             ResourceParams.presResource = pVeboxHeapResource;
             ResourceParams.dwOffset     = pVeboxHeap->uiGammaCorrectionStateOffset + uiInstanceBaseAddr;
         }
-        ResourceParams.pdwCmd             = & (cmd.DW14_15.Value[0]);
+        ResourceParams.pdwCmd             = & (cmd->DW14_15.Value[0]);
         ResourceParams.dwLocationInCmd    = 14;
         ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
         ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -784,7 +787,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxState(
             ResourceParams.presResource = pVeboxHeapResource;
             ResourceParams.dwOffset     = pVeboxHeap->ui3DLUTStateOffset + uiInstanceBaseAddr;
         }
-        ResourceParams.pdwCmd             = & (cmd.DW16.Value);
+        ResourceParams.pdwCmd             = & (cmd->DW16.Value);
         ResourceParams.dwLocationInCmd    = 16;
         ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
         ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -795,37 +798,37 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxState(
             &ResourceParams));
     }
 
-    cmd.DW1.ColorGamutExpansionEnable    = pVeboxMode->ColorGamutExpansionEnable;
-    cmd.DW1.ColorGamutCompressionEnable  = pVeboxMode->ColorGamutCompressionEnable;
-    cmd.DW1.GlobalIecpEnable             = pVeboxMode->GlobalIECPEnable;
-    cmd.DW1.DnEnable                     = pVeboxMode->DNEnable;
-    cmd.DW1.DiEnable                     = pVeboxMode->DIEnable;
-    cmd.DW1.DnDiFirstFrame               = pVeboxMode->DNDIFirstFrame;
-    cmd.DW1.DiOutputFrames               = pVeboxMode->DIOutputFrames;
-    cmd.DW1.DemosaicEnable               = pVeboxMode->DemosaicEnable;
-    cmd.DW1.VignetteEnable               = pVeboxMode->VignetteEnable;
-    cmd.DW1.AlphaPlaneEnable             = pVeboxMode->AlphaPlaneEnable;
-    cmd.DW1.HotPixelFilteringEnable      = pVeboxMode->HotPixelFilteringEnable;
-    cmd.DW1.SingleSliceVeboxEnable       = pVeboxMode->SingleSliceVeboxEnable;
-    cmd.DW1.LaceCorrectionEnable         = pVeboxMode->LACECorrectionEnable;
-    cmd.DW1.DisableEncoderStatistics     = pVeboxMode->DisableEncoderStatistics;
-    cmd.DW1.DisableTemporalDenoiseFilter = pVeboxMode->DisableTemporalDenoiseFilter;
-    cmd.DW1.SinglePipeEnable             = pVeboxMode->SinglePipeIECPEnable;
-    cmd.DW1.ScalarMode                   = pVeboxMode->ScalarMode;
-    cmd.DW1.ForwardGammaCorrectionEnable = pVeboxMode->ForwardGammaCorrectionEnable;
-
-    cmd.DW17.ArbitrationPriorityControlForLut3D = pLUT3D->ArbitrationPriorityControl;
-    cmd.DW18.Lut3DEnable                        = pLUT3D->Lut3dEnable;
-    cmd.DW18.Lut3DSize                          = pLUT3D->Lut3dSize;
-
-    cmd.DW18.ChromaUpsamplingCoSitedHorizontalOffset   = pChromaSampling->ChromaUpsamplingCoSitedHorizontalOffset;
-    cmd.DW18.ChromaUpsamplingCoSitedVerticalOffset     = pChromaSampling->ChromaUpsamplingCoSitedVerticalOffset;
-    cmd.DW18.ChromaDownsamplingCoSitedHorizontalOffset = pChromaSampling->ChromaDownsamplingCoSitedHorizontalOffset;
-    cmd.DW18.ChromaDownsamplingCoSitedVerticalOffset   = pChromaSampling->ChromaDownsamplingCoSitedVerticalOffset;
-    cmd.DW18.BypassChromaUpsampling                    = pChromaSampling->BypassChromaUpsampling;
-    cmd.DW18.BypassChromaDownsampling                  = pChromaSampling->BypassChromaDownsampling;
-
-    Mos_AddCommand(pCmdBuffer, &cmd, cmd.byteSize);
+    cmd->DW1.ColorGamutExpansionEnable    = pVeboxMode->ColorGamutExpansionEnable;
+    cmd->DW1.ColorGamutCompressionEnable  = pVeboxMode->ColorGamutCompressionEnable;
+    cmd->DW1.GlobalIecpEnable             = pVeboxMode->GlobalIECPEnable;
+    cmd->DW1.DnEnable                     = pVeboxMode->DNEnable;
+    cmd->DW1.DiEnable                     = pVeboxMode->DIEnable;
+    cmd->DW1.DnDiFirstFrame               = pVeboxMode->DNDIFirstFrame;
+    cmd->DW1.DiOutputFrames               = pVeboxMode->DIOutputFrames;
+    cmd->DW1.DemosaicEnable               = pVeboxMode->DemosaicEnable;
+    cmd->DW1.VignetteEnable               = pVeboxMode->VignetteEnable;
+    cmd->DW1.AlphaPlaneEnable             = pVeboxMode->AlphaPlaneEnable;
+    cmd->DW1.HotPixelFilteringEnable      = pVeboxMode->HotPixelFilteringEnable;
+    cmd->DW1.SingleSliceVeboxEnable       = pVeboxMode->SingleSliceVeboxEnable;
+    cmd->DW1.LaceCorrectionEnable         = pVeboxMode->LACECorrectionEnable;
+    cmd->DW1.DisableEncoderStatistics     = pVeboxMode->DisableEncoderStatistics;
+    cmd->DW1.DisableTemporalDenoiseFilter = pVeboxMode->DisableTemporalDenoiseFilter;
+    cmd->DW1.SinglePipeEnable             = pVeboxMode->SinglePipeIECPEnable;
+    cmd->DW1.ScalarMode                   = pVeboxMode->ScalarMode;
+    cmd->DW1.ForwardGammaCorrectionEnable = pVeboxMode->ForwardGammaCorrectionEnable;
+
+    cmd->DW17.ArbitrationPriorityControlForLut3D = pLUT3D->ArbitrationPriorityControl;
+    cmd->DW18.Lut3DEnable                        = pLUT3D->Lut3dEnable;
+    cmd->DW18.Lut3DSize                          = pLUT3D->Lut3dSize;
+
+    cmd->DW18.ChromaUpsamplingCoSitedHorizontalOffset   = pChromaSampling->ChromaUpsamplingCoSitedHorizontalOffset;
+    cmd->DW18.ChromaUpsamplingCoSitedVerticalOffset     = pChromaSampling->ChromaUpsamplingCoSitedVerticalOffset;
+    cmd->DW18.ChromaDownsamplingCoSitedHorizontalOffset = pChromaSampling->ChromaDownsamplingCoSitedHorizontalOffset;
+    cmd->DW18.ChromaDownsamplingCoSitedVerticalOffset   = pChromaSampling->ChromaDownsamplingCoSitedVerticalOffset;
+    cmd->DW18.BypassChromaUpsampling                    = pChromaSampling->BypassChromaUpsampling;
+    cmd->DW18.BypassChromaDownsampling                  = pChromaSampling->BypassChromaDownsampling;
+
+    Mos_CommitCommand(pCmdBuffer, cmd->byteSize);
 
 finish:
     return eStatus;
@@ -839,7 +842,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
     PMOS_INTERFACE      pOsInterface;
     MHW_RESOURCE_PARAMS ResourceParams;
 
-    mhw_vebox_g10_X::VEB_DI_IECP_CMD cmd;
+    mhw_vebox_g10_X::VEB_DI_IECP_CMD *cmd;
 
     MHW_CHK_NULL(m_osInterface);
     MHW_CHK_NULL(pCmdBuffer);
@@ -847,22 +850,25 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
     MHW_ASSERT(MOS_IS_ALIGNED(pVeboxDiIecpCmdParams->dwCurrInputSurfOffset, MHW_PAGE_SIZE));  // offset should be aligned with 4KB
     MHW_ASSERT(MOS_IS_ALIGNED(pVeboxDiIecpCmdParams->dwPrevInputSurfOffset, MHW_PAGE_SIZE));  // offset should be aligned with 4KB
 
+    cmd = Mhw_EmplaceCommand<mhw_vebox_g10_X::VEB_DI_IECP_CMD>(pCmdBuffer);
+    MHW_CHK_NULL(cmd);
+
     // Initialize
     eStatus      = MOS_STATUS_SUCCESS;
     pOsInterface = m_osInterface;
 
     if (pVeboxDiIecpCmdParams->pOsResCurrInput)
     {
-        cmd.DW2.CurrentFrameSurfaceControlBitsMemoryCompressionEnable =
+        cmd->DW2.CurrentFrameSurfaceControlBitsMemoryCompressionEnable =
             (pVeboxDiIecpCmdParams->CurInputSurfMMCState != MOS_MEMCOMP_DISABLED) ? 1 : 0;
-        cmd.DW2.CurrentFrameSurfaceControlBitsMemoryCompressionMode =
+        cmd->DW2.CurrentFrameSurfaceControlBitsMemoryCompressionMode =
             (pVeboxDiIecpCmdParams->CurInputSurfMMCState == MOS_MEMCOMP_HORIZONTAL) ? 0 : 1;
 
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.dwLsbNum        = MHW_VEBOX_DI_IECP_SHIFT;
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResCurrInput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->dwCurrInputSurfOffset;
-        ResourceParams.pdwCmd          =  & (cmd.DW2.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW2.Value);
         ResourceParams.dwLocationInCmd = 2;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
 
@@ -876,7 +882,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
     if (pVeboxDiIecpCmdParams->CurInputSurfMMCState == 0)
     {
         // bit 0 ~ 10 is MOCS/MMC bits
-        cmd.DW2.Value = (cmd.DW2.Value & 0xFFFFF800) + pVeboxDiIecpCmdParams->CurrInputSurfCtrl.Value;
+        cmd->DW2.Value = (cmd->DW2.Value & 0xFFFFF800) + pVeboxDiIecpCmdParams->CurrInputSurfCtrl.Value;
     }
 
     if (pVeboxDiIecpCmdParams->pOsResPrevInput)
@@ -884,7 +890,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResPrevInput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->PrevInputSurfCtrl.Value + pVeboxDiIecpCmdParams->dwPrevInputSurfOffset;
-        ResourceParams.pdwCmd          =  & (cmd.DW4.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW4.Value);
         ResourceParams.dwLocationInCmd = 4;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
 
@@ -899,7 +905,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResStmmInput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->StmmInputSurfCtrl.Value;
-        ResourceParams.pdwCmd          =  & (cmd.DW6.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW6.Value);
         ResourceParams.dwLocationInCmd = 6;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
 
@@ -914,7 +920,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResStmmOutput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->StmmOutputSurfCtrl.Value;
-        ResourceParams.pdwCmd          =  & (cmd.DW8.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW8.Value);
         ResourceParams.dwLocationInCmd = 8;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -930,7 +936,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResDenoisedCurrOutput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->DenoisedCurrOutputSurfCtrl.Value;
-        ResourceParams.pdwCmd          =  & (cmd.DW10.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW10.Value);
         ResourceParams.dwLocationInCmd = 10;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -946,7 +952,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResCurrOutput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->CurrOutputSurfCtrl.Value;
-        ResourceParams.pdwCmd          =  & (cmd.DW12.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW12.Value);
         ResourceParams.dwLocationInCmd = 12;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -962,7 +968,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResPrevOutput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->PrevOutputSurfCtrl.Value;
-        ResourceParams.pdwCmd          =  & (cmd.DW14.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW14.Value);
         ResourceParams.dwLocationInCmd = 14;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -978,7 +984,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResStatisticsOutput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->StatisticsOutputSurfCtrl.Value;
-        ResourceParams.pdwCmd          =  & (cmd.DW16.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW16.Value);
         ResourceParams.dwLocationInCmd = 16;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -994,7 +1000,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResAlphaOrVignette;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->AlphaOrVignetteSurfCtrl.Value;
-        ResourceParams.pdwCmd          =  & (cmd.DW18.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW18.Value);
         ResourceParams.dwLocationInCmd = 18;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -1010,7 +1016,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResLaceOrAceOrRgbHistogram;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->LaceOrAceOrRgbHistogramSurfCtrl.Value;
-        ResourceParams.pdwCmd          =  & (cmd.DW20.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW20.Value);
         ResourceParams.dwLocationInCmd = 20;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -1026,7 +1032,7 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResSkinScoreSurface;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->SkinScoreSurfaceSurfCtrl.Value;
-        ResourceParams.pdwCmd          =  & (cmd.DW22.Value);
+        ResourceParams.pdwCmd          =  & (cmd->DW22.Value);
         ResourceParams.dwLocationInCmd = 22;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -1037,10 +1043,10 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDiIecp(
             &ResourceParams));
     }
 
-    cmd.DW1.EndingX   = pVeboxDiIecpCmdParams->dwEndingX;
-    cmd.DW1.StartingX = pVeboxDiIecpCmdParams->dwStartingX;
+    cmd->DW1.EndingX   = pVeboxDiIecpCmdParams->dwEndingX;
+    cmd->DW1.StartingX = pVeboxDiIecpCmdParams->dwStartingX;
 
-    Mos_AddCommand(pCmdBuffer, &cmd, cmd.byteSize);
+    Mos_CommitCommand(pCmdBuffer, cmd->byteSize);
 
 finish:
     return eStatus;
@@ -1527,6 +1533,18 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDndiState(
                                                   pVeboxHeap->uiDndiStateOffset +
                                                   uiOffset);
     MHW_ASSERT(pVeboxDndiState);
+
+    // The block only depends on the parameters, copy the last image while they do not change
+    if (LoadStateImage(
+            &m_dndiStateImage,
+            pVeboxDndiParams,
+            sizeof(*pVeboxDndiParams),
+            pVeboxDndiState,
+            sizeof(*pVeboxDndiState)))
+    {
+        goto finish;
+    }
+
     *pVeboxDndiState = VeboxDndiState;
 
     pVeboxDndiState->DW0.DenoiseMovingPixelThreshold =
@@ -1708,6 +1726,13 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxDndiState(
     pVeboxDndiState->DW16.Fmd2VerticalDifferenceThreshold = 100;
     pVeboxDndiState->DW16.Fmd1VerticalDifferenceThreshold = 16;
 
+    SaveStateImage(
+        &m_dndiStateImage,
+        pVeboxDndiParams,
+        sizeof(*pVeboxDndiParams),
+        pVeboxDndiState,
+        sizeof(*pVeboxDndiState));
+
 finish:
     return eStatus;
 }
@@ -1721,6 +1746,8 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxIecpState(
     PMHW_VEBOX_HEAP        pVeboxHeap;
     uint32_t               uiOffset;
     MOS_STATUS             eStatus = MOS_STATUS_SUCCESS;
+    MHW_VEBOX_IECP_STATE_KEY IecpStateKey;
+    bool                   bIecpStateKey = false;
 
     mhw_vebox_g10_X::VEBOX_IECP_STATE_CMD *pVeboxIecpState;
 
@@ -1733,6 +1760,20 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxIecpState(
                                                                 pVeboxHeap->uiIecpStateOffset +
                                                                 uiOffset);
     MHW_ASSERT(pVeboxIecpState);
+
+    // Without the capture pipe the block only depends on the parameters, copy the last image while they do not change
+    bIecpStateKey = GetIecpStateKey(pVeboxIecpParams, &IecpStateKey);
+    if (bIecpStateKey &&
+        LoadStateImage(
+            &m_iecpStateImage,
+            &IecpStateKey,
+            sizeof(IecpStateKey),
+            pVeboxIecpState,
+            sizeof(*pVeboxIecpState)))
+    {
+        goto finish;
+    }
+
     IecpStateInitialization(pVeboxIecpState);
 
     if (pVeboxIecpParams->ColorPipeParams.bActive)
@@ -1854,6 +1895,16 @@ MOS_STATUS MhwVeboxInterfaceG10::AddVeboxIecpState(
             pVeboxIecpParams->CapPipeParams.ICCColorConversionParams.LUTLength);
     }
 
+    if (bIecpStateKey)
+    {
+        SaveStateImage(
+            &m_iecpStateImage,
+            &IecpStateKey,
+            sizeof(IecpStateKey),
+            pVeboxIecpState,
+            sizeof(*pVeboxIecpState));
+    }
+
 finish:
     return eStatus;
 }
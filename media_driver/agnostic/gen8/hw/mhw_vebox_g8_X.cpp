@@ -292,13 +292,16 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxState(
     PMHW_VEBOX_MODE                  pVeboxMode;
     uint32_t                         uiInstanceBaseAddr;
     MHW_RESOURCE_PARAMS              ResourceParams;
-    mhw_vebox_g8_X::VEBOX_STATE_CMD  cmd;
+    mhw_vebox_g8_X::VEBOX_STATE_CMD *cmd;
 
     MHW_CHK_NULL(m_osInterface);
     MHW_CHK_NULL(m_veboxHeap);
     MHW_CHK_NULL(pCmdBuffer);
     MHW_CHK_NULL(pVeboxStateCmdParams);
 
+    cmd = Mhw_EmplaceCommand<mhw_vebox_g8_X::VEBOX_STATE_CMD>(pCmdBuffer);
+    MHW_CHK_NULL(cmd);
+
     // Initialize
     eStatus      = MOS_STATUS_SUCCESS;
     pOsInterface = m_osInterface;
@@ -315,8 +318,8 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxState(
         uiInstanceBaseAddr = pVeboxHeap->uiInstanceSize * pVeboxHeap->uiCurState;
     }
 
-    cmd.DW1.DownsampleMethod422to420 = 1;
-    cmd.DW1.DownsampleMethod444to422 = 1;
+    cmd->DW1.DownsampleMethod422to420 = 1;
+    cmd->DW1.DownsampleMethod444to422 = 1;
 
     MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
     if (bUseCmBuffer)
@@ -329,7 +332,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxState(
         ResourceParams.presResource = pVeboxHeapResource;
         ResourceParams.dwOffset     = pVeboxHeap->uiDndiStateOffset + uiInstanceBaseAddr;
     }
-    ResourceParams.pdwCmd          = & (cmd.DW2.Value);
+    ResourceParams.pdwCmd          = & (cmd->DW2.Value);
     ResourceParams.dwLocationInCmd = 2;
     ResourceParams.HwCommandType   = MOS_VEBOX_STATE;
 
@@ -349,7 +352,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxState(
         ResourceParams.presResource = pVeboxHeapResource;
         ResourceParams.dwOffset     = pVeboxHeap->uiIecpStateOffset + uiInstanceBaseAddr;
     }
-    ResourceParams.pdwCmd             = & (cmd.DW4.Value);
+    ResourceParams.pdwCmd             = & (cmd->DW4.Value);
     ResourceParams.dwLocationInCmd    = 4;
     ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
     ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -370,7 +373,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxState(
         ResourceParams.presResource = pVeboxHeapResource;
         ResourceParams.dwOffset     = pVeboxHeap->uiGamutStateOffset + uiInstanceBaseAddr;
     }
-    ResourceParams.pdwCmd             = & (cmd.DW6.Value);
+    ResourceParams.pdwCmd             = & (cmd->DW6.Value);
     ResourceParams.dwLocationInCmd    = 6;
     ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
     ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -391,7 +394,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxState(
         ResourceParams.presResource = pVeboxHeapResource;
         ResourceParams.dwOffset     = pVeboxHeap->uiVertexTableOffset + uiInstanceBaseAddr;
     }
-    ResourceParams.pdwCmd             = & (cmd.DW8.Value);
+    ResourceParams.pdwCmd             = & (cmd->DW8.Value);
     ResourceParams.dwLocationInCmd    = 8;
     ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
     ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -412,7 +415,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxState(
         ResourceParams.presResource = pVeboxHeapResource;
         ResourceParams.dwOffset     = pVeboxHeap->uiCapturePipeStateOffset + uiInstanceBaseAddr;
     }
-    ResourceParams.pdwCmd             = & (cmd.DW10.Value);
+    ResourceParams.pdwCmd             = & (cmd->DW10.Value);
     ResourceParams.dwLocationInCmd    = 10;
     ResourceParams.HwCommandType      = MOS_VEBOX_STATE;
     ResourceParams.dwSharedMocsOffset = 1 - ResourceParams.dwLocationInCmd;
@@ -422,20 +425,20 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxState(
         pCmdBuffer,
         &ResourceParams));
 
-    cmd.DW1.ColorGamutExpansionEnable   = pVeboxMode->ColorGamutExpansionEnable;
-    cmd.DW1.ColorGamutCompressionEnable = pVeboxMode->ColorGamutCompressionEnable;
-    cmd.DW1.GlobalIecpEnable            = pVeboxMode->GlobalIECPEnable;
-    cmd.DW1.DnEnable                    = pVeboxMode->DNEnable;
-    cmd.DW1.DiEnable                    = pVeboxMode->DIEnable;
-    cmd.DW1.DnDiFirstFrame              = pVeboxMode->DNDIFirstFrame;
-    cmd.DW1.DiOutputFrames              = pVeboxMode->DIOutputFrames;
-    cmd.DW1.DemosaicEnable              = pVeboxMode->DemosaicEnable;
-    cmd.DW1.VignetteEnable              = pVeboxMode->VignetteEnable;
-    cmd.DW1.AlphaPlaneEnable            = pVeboxMode->AlphaPlaneEnable;
-    cmd.DW1.HotPixelFilteringEnable     = pVeboxMode->HotPixelFilteringEnable;
-    cmd.DW1.SingleSliceVeboxEnable      = pVeboxMode->SingleSliceVeboxEnable;
-
-    Mos_AddCommand(pCmdBuffer, &cmd, cmd.byteSize);
+    cmd->DW1.ColorGamutExpansionEnable   = pVeboxMode->ColorGamutExpansionEnable;
+    cmd->DW1.ColorGamutCompressionEnable = pVeboxMode->ColorGamutCompressionEnable;
+    cmd->DW1.GlobalIecpEnable            = pVeboxMode->GlobalIECPEnable;
+    cmd->DW1.DnEnable                    = pVeboxMode->DNEnable;
+    cmd->DW1.DiEnable                    = pVeboxMode->DIEnable;
+    cmd->DW1.DnDiFirstFrame              = pVeboxMode->DNDIFirstFrame;
+    cmd->DW1.DiOutputFrames              = pVeboxMode->DIOutputFrames;
+    cmd->DW1.DemosaicEnable              = pVeboxMode->DemosaicEnable;
+    cmd->DW1.VignetteEnable              = pVeboxMode->VignetteEnable;
+    cmd->DW1.AlphaPlaneEnable            = pVeboxMode->AlphaPlaneEnable;
+    cmd->DW1.HotPixelFilteringEnable     = pVeboxMode->HotPixelFilteringEnable;
+    cmd->DW1.SingleSliceVeboxEnable      = pVeboxMode->SingleSliceVeboxEnable;
+
+    Mos_CommitCommand(pCmdBuffer, cmd->byteSize);
 
 finish:
     return eStatus;
@@ -643,7 +646,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
 {
     MOS_STATUS          eStatus;;
     MHW_RESOURCE_PARAMS ResourceParams;
-    mhw_vebox_g8_X::VEB_DI_IECP_CMD  cmd;
+    mhw_vebox_g8_X::VEB_DI_IECP_CMD *cmd;
 
     MHW_CHK_NULL(m_osInterface);
     MHW_CHK_NULL(pCmdBuffer);
@@ -651,6 +654,9 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
     MHW_ASSERT(MOS_IS_ALIGNED(pVeboxDiIecpCmdParams->dwCurrInputSurfOffset, MHW_PAGE_SIZE));  // offset should be aligned with 4KB
     MHW_ASSERT(MOS_IS_ALIGNED(pVeboxDiIecpCmdParams->dwPrevInputSurfOffset, MHW_PAGE_SIZE));  // offset should be aligned with 4KB
 
+    cmd = Mhw_EmplaceCommand<mhw_vebox_g8_X::VEB_DI_IECP_CMD>(pCmdBuffer);
+    MHW_CHK_NULL(cmd);
+
     // Initialize
     eStatus      = MOS_STATUS_SUCCESS;
 
@@ -659,7 +665,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResCurrInput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->CurrInputSurfCtrl.Value + pVeboxDiIecpCmdParams->dwCurrInputSurfOffset;
-        ResourceParams.pdwCmd          = & (cmd.DW2.Value);
+        ResourceParams.pdwCmd          = & (cmd->DW2.Value);
         ResourceParams.dwLocationInCmd = 2;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
 
@@ -674,7 +680,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResPrevInput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->PrevInputSurfCtrl.Value + pVeboxDiIecpCmdParams->dwPrevInputSurfOffset;
-        ResourceParams.pdwCmd          = & (cmd.DW4.Value);
+        ResourceParams.pdwCmd          = & (cmd->DW4.Value);
         ResourceParams.dwLocationInCmd = 4;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
 
@@ -690,7 +696,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResStmmInput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->StmmInputSurfCtrl.Value;
-        ResourceParams.pdwCmd          = & (cmd.DW6.Value);
+        ResourceParams.pdwCmd          = & (cmd->DW6.Value);
         ResourceParams.dwLocationInCmd = 6;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
 
@@ -705,7 +711,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResStmmOutput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->StmmOutputSurfCtrl.Value;
-        ResourceParams.pdwCmd          = & (cmd.DW8.Value);
+        ResourceParams.pdwCmd          = & (cmd->DW8.Value);
         ResourceParams.dwLocationInCmd = 8;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -721,7 +727,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResDenoisedCurrOutput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->DenoisedCurrOutputSurfCtrl.Value;
-        ResourceParams.pdwCmd          = & (cmd.DW10.Value);
+        ResourceParams.pdwCmd          = & (cmd->DW10.Value);
         ResourceParams.dwLocationInCmd = 10;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -737,7 +743,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResCurrOutput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->CurrOutputSurfCtrl.Value;
-        ResourceParams.pdwCmd          = & (cmd.DW12.Value);
+        ResourceParams.pdwCmd          = & (cmd->DW12.Value);
         ResourceParams.dwLocationInCmd = 12;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -753,7 +759,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResPrevOutput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->PrevOutputSurfCtrl.Value;
-        ResourceParams.pdwCmd          = & (cmd.DW14.Value);
+        ResourceParams.pdwCmd          = & (cmd->DW14.Value);
         ResourceParams.dwLocationInCmd = 14;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -769,7 +775,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResStatisticsOutput;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->StatisticsOutputSurfCtrl.Value;
-        ResourceParams.pdwCmd          = & (cmd.DW16.Value);
+        ResourceParams.pdwCmd          = & (cmd->DW16.Value);
         ResourceParams.dwLocationInCmd = 16;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -785,7 +791,7 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
         MOS_ZeroMemory(&ResourceParams, sizeof(ResourceParams));
         ResourceParams.presResource    = pVeboxDiIecpCmdParams->pOsResAlphaOrVignette;
         ResourceParams.dwOffset        = pVeboxDiIecpCmdParams->AlphaOrVignetteSurfCtrl.Value;
-        ResourceParams.pdwCmd          = & (cmd.DW18.Value);
+        ResourceParams.pdwCmd          = & (cmd->DW18.Value);
         ResourceParams.dwLocationInCmd = 18;
         ResourceParams.bIsWritable     = true;
         ResourceParams.HwCommandType   = MOS_VEBOX_DI_IECP;
@@ -796,10 +802,10 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDiIecp(
             &ResourceParams));
     }
 
-    cmd.DW1.EndingX   = pVeboxDiIecpCmdParams->dwEndingX;
-    cmd.DW1.StartingX = pVeboxDiIecpCmdParams->dwStartingX;
+    cmd->DW1.EndingX   = pVeboxDiIecpCmdParams->dwEndingX;
+    cmd->DW1.StartingX = pVeboxDiIecpCmdParams->dwStartingX;
 
-    Mos_AddCommand(pCmdBuffer, &cmd, cmd.byteSize);
+    Mos_CommitCommand(pCmdBuffer, cmd->byteSize);
 
 finish:
     return eStatus;
@@ -822,6 +828,17 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDndiState(
                                                                pVeboxHeap->uiDndiStateOffset +
                                                                uiOffset);
 
+    // The block only depends on the parameters, copy the last image while they do not change
+    if (LoadStateImage(
+            &m_dndiStateImage,
+            pVeboxDndiParams,
+            sizeof(*pVeboxDndiParams),
+            pVeboxDndiState,
+            sizeof(*pVeboxDndiState)))
+    {
+        goto finish;
+    }
+
     *pVeboxDndiState = VeboxDndiState;
 
     pVeboxDndiState->DW0.DenoiseAsdThreshold =
@@ -890,6 +907,13 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxDndiState(
 
     MHW_ASSERT(pVeboxDndiState->DW6.Value & 0xFF);
 
+    SaveStateImage(
+        &m_dndiStateImage,
+        pVeboxDndiParams,
+        sizeof(*pVeboxDndiParams),
+        pVeboxDndiState,
+        sizeof(*pVeboxDndiState));
+
 finish:
     return eStatus;
 }
@@ -1324,6 +1348,8 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxIecpState(
     MOS_STATUS                                    eStatus = MOS_STATUS_SUCCESS;
     mhw_vebox_g8_X::VEBOX_IECP_STATE_CMD *        pVeboxIecpState;
     mhw_vebox_g8_X::VEBOX_CAPTURE_PIPE_STATE_CMD *pVeboxCapPipeState, CapPipeStatecmd;
+    MHW_VEBOX_IECP_STATE_KEY                      IecpStateKey;
+    bool                                          bIecpStateKey = false;
 
     MHW_CHK_NULL(pVeboxIecpParams);
     MHW_CHK_NULL(m_veboxHeap);
@@ -1334,6 +1360,27 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxIecpState(
                                                                pVeboxHeap->uiIecpStateOffset +
                                                                uiOffset);
     MHW_ASSERT(pVeboxIecpState);
+
+    pVeboxCapPipeState =
+        (mhw_vebox_g8_X::VEBOX_CAPTURE_PIPE_STATE_CMD *)(pVeboxHeap->pLockedDriverResourceMem +
+                                                         pVeboxHeap->uiCapturePipeStateOffset +
+                                                         uiOffset);
+    MHW_ASSERT(pVeboxCapPipeState);
+    *pVeboxCapPipeState = CapPipeStatecmd;
+
+    // Without the capture pipe the block only depends on the parameters, copy the last image while they do not change
+    bIecpStateKey = GetIecpStateKey(pVeboxIecpParams, &IecpStateKey);
+    if (bIecpStateKey &&
+        LoadStateImage(
+            &m_iecpStateImage,
+            &IecpStateKey,
+            sizeof(IecpStateKey),
+            pVeboxIecpState,
+            sizeof(*pVeboxIecpState)))
+    {
+        goto finish;
+    }
+
     IecpStateInitialization(pVeboxIecpState);
 
     if (pVeboxIecpParams->ColorPipeParams.bActive)
@@ -1409,12 +1456,15 @@ MOS_STATUS MhwVeboxInterfaceG8::AddVeboxIecpState(
             &pVeboxIecpParams->ProcAmpParams);
     }
 
-    pVeboxCapPipeState =
-        (mhw_vebox_g8_X::VEBOX_CAPTURE_PIPE_STATE_CMD *)(pVeboxHeap->pLockedDriverResourceMem +
-                                                         pVeboxHeap->uiCapturePipeStateOffset +
-                                                         uiOffset);
-    MHW_ASSERT(pVeboxCapPipeState);
-    *pVeboxCapPipeState = CapPipeStatecmd;
+    if (bIecpStateKey)
+    {
+        SaveStateImage(
+            &m_iecpStateImage,
+            &IecpStateKey,
+            sizeof(IecpStateKey),
+            pVeboxIecpState,
+            sizeof(*pVeboxIecpState));
+    }
 
 finish:
     return eStatus;
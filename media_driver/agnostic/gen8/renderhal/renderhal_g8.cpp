@@ -272,8 +272,8 @@ MOS_STATUS XRenderHal_Interface_g8::SetupSurfaceState(
             }
         }
 
-        // Call MHW to setup the Surface State Heap entry
-        pRenderHal->pMhwStateHeap->SetSurfaceStateEntry(&SurfStateParams);
+        // Setup the Surface State Heap entry, encoded by MHW unless cached for the slot
+        MHW_RENDERHAL_CHK_STATUS(RenderHal_SetSurfaceStateEntry(pRenderHal, pSurfaceEntry->iSurfStateID, &SurfStateParams));
 
         // Setup OS specific states
         MHW_RENDERHAL_CHK_STATUS(pRenderHal->pfnSetupSurfaceStateOs(pRenderHal, pRenderHalSurface, pParams, pSurfaceEntry));
@@ -0,0 +1,256 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//!
+//! \file      cm_jit_cache_os.cpp
+//! \brief     Contains Linux-dependent CmJitCache member functions.
+//!
+
+#include "cm_jit_cache.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CM_JIT_CACHE_DIR_ENV            "CM_JIT_CACHE_DIR"
+#define CM_JIT_CACHE_MAX_SIZE_ENV       "CM_JIT_CACHE_MAX_SIZE_MB"
+#define CM_JIT_CACHE_TEMP_EXTENSION     ".tmp"
+#define CM_JIT_CACHE_STALE_TEMP_TIME    600     // Seconds before an orphan temp file is removed
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Read the cache location and budget from the environment
+//| Returns:    true if the cache is usable.
+//*-----------------------------------------------------------------------------
+bool CmJitCache::GetConfiguration(std::string &directory, uint64_t &maxSize)
+{
+    const char *dir = getenv(CM_JIT_CACHE_DIR_ENV);
+    if (dir == nullptr || dir[0] == '\0')
+    {
+        return false;
+    }
+
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST)
+    {
+        CM_NORMALMESSAGE("Failed to create jit cache directory %s.", dir);
+        return false;
+    }
+    if (access(dir, R_OK | W_OK | X_OK) != 0)
+    {
+        CM_NORMALMESSAGE("Jit cache directory %s is not writable.", dir);
+        return false;
+    }
+    directory = dir;
+
+    uint64_t maxSizeInMB = CM_JIT_CACHE_DEFAULT_MAX_SIZE_MB;
+    const char *size = getenv(CM_JIT_CACHE_MAX_SIZE_ENV);
+    if (size != nullptr && size[0] != '\0')
+    {
+        maxSizeInMB = strtoull(size, nullptr, 0);
+    }
+    maxSize = maxSizeInMB << 20;
+
+    return maxSize != 0;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Read a whole cache entry
+//| Returns:    CM_SUCCESS if the file was read.
+//*-----------------------------------------------------------------------------
+int32_t CmJitCache::ReadEntry(const std::string &path, std::vector<uint8_t> &data)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return CM_FAILURE;
+    }
+
+    int32_t result = CM_FAILURE;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        data.resize((size_t)st.st_size);
+        size_t offset = 0;
+        while (offset < data.size())
+        {
+            ssize_t bytes = read(fd, data.data() + offset, data.size() - offset);
+            if (bytes <= 0)
+            {
+                if (bytes < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            offset += (size_t)bytes;
+        }
+        result = (offset == data.size()) ? CM_SUCCESS : CM_FAILURE;
+    }
+
+    close(fd);
+    return result;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Write a cache entry atomically
+//| Arguments :
+//|               path      [in]     Final name of the entry
+//|               data      [in]     Content of the entry
+//| Returns:    CM_SUCCESS if the entry was published.
+//| Notes:      The entry is written to a temp file private to this thread and
+//|             renamed, so readers either see a complete entry or none at all.
+//*-----------------------------------------------------------------------------
+int32_t CmJitCache::WriteEntry(const std::string &path, const std::vector<uint8_t> &data)
+{
+    char suffix[64];
+    MOS_SecureStringPrint(suffix, sizeof(suffix), sizeof(suffix), CM_JIT_CACHE_TEMP_EXTENSION ".%d.%u",
+                          (int)getpid(), MOS_GetCurrentThreadId());
+    std::string tempPath = path + suffix;
+
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        return CM_FAILURE;
+    }
+
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+        ssize_t bytes = write(fd, data.data() + offset, data.size() - offset);
+        if (bytes <= 0)
+        {
+            if (bytes < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        offset += (size_t)bytes;
+    }
+
+    if (close(fd) != 0 || offset != data.size() || rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        unlink(tempPath.c_str());
+        return CM_FAILURE;
+    }
+    return CM_SUCCESS;
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Mark an entry as recently used
+//| Returns:    None.
+//*-----------------------------------------------------------------------------
+void CmJitCache::TouchEntry(const std::string &path)
+{
+    utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+}
+
+//*-----------------------------------------------------------------------------
+//| Purpose:    Remove the least recently used entries while the cache is over budget
+//| Returns:    Size of the cache after trimming.
+//| Notes:      Other processes may trim the same directory concurrently, failing
+//|             to remove an entry which is already gone is harmless.
+//*-----------------------------------------------------------------------------
+uint64_t CmJitCache::Trim()
+{
+    struct CacheFile
+    {
+        std::string path;
+        uint64_t size;
+        struct timespec lastUse;
+    };
+
+    DIR *dir = opendir(m_directory.c_str());
+    if (dir == nullptr)
+    {
+        return 0;
+    }
+
+    std::vector<CacheFile> files;
+    uint64_t totalSize = 0;
+    time_t now = time(nullptr);
+    size_t extensionLength = strlen(CM_JIT_CACHE_FILE_EXTENSION);
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        std::string name = entry->d_name;
+        bool isEntry = name.size() > extensionLength &&
+                       name.compare(name.size() - extensionLength, extensionLength, CM_JIT_CACHE_FILE_EXTENSION) == 0;
+        bool isTemp = !isEntry && name.find(CM_JIT_CACHE_FILE_EXTENSION CM_JIT_CACHE_TEMP_EXTENSION) != std::string::npos;
+        if (!isEntry && !isTemp)
+        {
+            continue;
+        }
+
+        CacheFile file;
+        file.path = m_directory + "/" + name;
+        struct stat st;
+        if (stat(file.path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            continue;
+        }
+
+        if (isTemp)
+        {
+            // Left behind by a process which died while writing
+            if (now - st.st_mtime > CM_JIT_CACHE_STALE_TEMP_TIME)
+            {
+                unlink(file.path.c_str());
+            }
+            continue;
+        }
+
+        file.size = (uint64_t)st.st_size;
+        file.lastUse = st.st_mtim;
+        totalSize += file.size;
+        files.push_back(file);
+    }
+    closedir(dir);
+
+    if (totalSize <= m_maxSize)
+    {
+        return totalSize;
+    }
+
+    std::sort(files.begin(), files.end(), [](const CacheFile &a, const CacheFile &b) {
+        return (a.lastUse.tv_sec != b.lastUse.tv_sec) ? (a.lastUse.tv_sec < b.lastUse.tv_sec)
+                                                      : (a.lastUse.tv_nsec < b.lastUse.tv_nsec);
+    });
+
+    uint64_t targetSize = m_maxSize / 100 * CM_JIT_CACHE_TRIM_PERCENT;
+    for (auto &file : files)
+    {
+        if (totalSize <= targetSize)
+        {
+            break;
+        }
+        if (unlink(file.path.c_str()) == 0 || errno == ENOENT)
+        {
+            totalSize -= file.size;
+        }
+    }
+    return totalSize;
+}
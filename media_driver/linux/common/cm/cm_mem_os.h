@@ -142,112 +142,17 @@ inline void GetCPUID(int CPUInfo[4], int InfoType)
 Inline Function:
     CmFastMemCopyFromWC
 Description:
-    Intel C++ Compiler Memory Copy function for large amounts of data
+    Memory Copy function for large amounts of data read from a WC mapping
 Input:
-    dst - pointer to write-combined destination buffer
-    src - pointer to source buffer
+    dst - pointer to destination buffer
+    src - pointer to write-combined source buffer
     bytes - number of bytes to copy
 \*****************************************************************************/
 inline void CmFastMemCopyFromWC( void* dst, const void* src, const size_t bytes, CPU_INSTRUCTION_LEVEL cpuInstructionLevel )
 {
-    if( cpuInstructionLevel >= CPU_INSTRUCTION_LEVEL_SSE4_1 )
-    {
-        // Cache pointers to memory
-        uint8_t *p_dst = (uint8_t*)dst;
-        uint8_t *p_src = (uint8_t*)src;
-
-        size_t count = bytes;
-
-        if( count >= sizeof(DHWORD) )
-        {
-            //Streaming Load must be 16-byte aligned but should
-            //be 64-byte aligned for optimal performance
-            const size_t doubleHexWordAlignBytes =
-                GetAlignmentOffset( p_src, sizeof(DHWORD) );
-
-            // Copy portion of the source memory that is not aligned
-            if( doubleHexWordAlignBytes )
-            {
-                CmSafeMemCopy( p_dst, p_src, doubleHexWordAlignBytes );
-
-                p_dst += doubleHexWordAlignBytes;
-                p_src += doubleHexWordAlignBytes;
-                count -= doubleHexWordAlignBytes;
-            }
-
-            CM_ASSERT( IsAligned( p_src, sizeof(DHWORD) ) == true );
-
-            // Get the number of bytes to be copied (rounded down to nearets DHWORD)
-            const size_t DoubleHexWordsToCopy = count / sizeof(DHWORD);
-
-            if( DoubleHexWordsToCopy )
-            {
-                // Determine if the destination address is aligned
-                const bool isDstDoubleQuadWordAligned =
-                    IsAligned( p_dst, sizeof(DQWORD) );
-
-                __m128i* pMMSrc = (__m128i*)(p_src);
-                __m128i* pMMDest = reinterpret_cast<__m128i*>(p_dst);
-                __m128i  xmm0, xmm1, xmm2, xmm3;
-
-                if( isDstDoubleQuadWordAligned )
-                {
-                    for( size_t i=0; i<DoubleHexWordsToCopy; i++ )
-                    {
-                        // Sync the WC memory data before issuing the MOVNTDQA instruction.
-                        _mm_mfence();
-                        xmm0 = _mm_stream_load_si128(pMMSrc);
-                        xmm1 = _mm_stream_load_si128(pMMSrc + 1);
-                        xmm2 = _mm_stream_load_si128(pMMSrc + 2);
-                        xmm3 = _mm_stream_load_si128(pMMSrc + 3);
-                        pMMSrc += 4;
-
-                        _mm_store_si128(pMMDest, xmm0);
-                        _mm_store_si128(pMMDest + 1, xmm1);
-                        _mm_store_si128(pMMDest + 2, xmm2);
-                        _mm_store_si128(pMMDest + 3, xmm3);
-                        pMMDest += 4;
-
-                        p_dst += sizeof(DHWORD);
-                        p_src += sizeof(DHWORD);
-                        count -= sizeof(DHWORD);
-                    }
-                }
-                else
-                {
-                    for( size_t i=0; i<DoubleHexWordsToCopy; i++ )
-                    {
-                        // Sync the WC memory data before issuing the MOVNTDQA instruction.
-                        _mm_mfence();
-                        xmm0 = _mm_stream_load_si128(pMMSrc);
-                        xmm1 = _mm_stream_load_si128(pMMSrc + 1);
-                        xmm2 = _mm_stream_load_si128(pMMSrc + 2);
-                        xmm3 = _mm_stream_load_si128(pMMSrc + 3);
-                        pMMSrc += 4;
-
-                        _mm_storeu_si128(pMMDest, xmm0);
-                        _mm_storeu_si128(pMMDest + 1, xmm1);
-                        _mm_storeu_si128(pMMDest + 2, xmm2);
-                        _mm_storeu_si128(pMMDest + 3, xmm3);
-                        pMMDest += 4;
-                        p_dst += sizeof(DHWORD);
-                        p_src += sizeof(DHWORD);
-                        count -= sizeof(DHWORD);
-                    }
-                }
-            }
-        }
-
-        // Copy remaining uint8_t(s)
-        if( count )
-        {
-            CmSafeMemCopy( p_dst, p_src, count );
-        }
-    }
-    else
-    {
-        CmFastMemCopy( dst, src, bytes );
-    }
+    // Streaming loads need SSE4.1, below that the source is read through the cache
+    MOS_FastMemCopy( dst, src, bytes,
+        ( cpuInstructionLevel >= CPU_INSTRUCTION_LEVEL_SSE4_1 ) ? MOS_MEMCOPY_SRC_UNCACHED : MOS_MEMCOPY_DEFAULT );
 }
 
 
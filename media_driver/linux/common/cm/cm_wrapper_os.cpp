@@ -195,7 +195,7 @@ int32_t CmCreateDevice(VADriverContextP pVaDrvCtx, CmDevice* &pCmDev, uint32_t D
     }
 
     // store pCmCtx in pMedia
-    pVaCtxHeapElmt->pVaContext    = (void *)pCmCtx;
+    __atomic_store_n(&pVaCtxHeapElmt->pVaContext, (void *)pCmCtx, __ATOMIC_RELEASE);
     VaContextID = (VAContextID)(pVaCtxHeapElmt->uiVaContextID + DDI_MEDIA_VACONTEXTID_OFFSET_CM);
 
     //Set VaCtx ID to Cm device
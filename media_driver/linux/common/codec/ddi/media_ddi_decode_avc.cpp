@@ -777,7 +777,7 @@ VAStatus DdiDecodeAVC::InitResourceBuffer()
     bufMgr             = &(m_ddiDecodeCtx->BufMgr);
     bufMgr->pSliceData = nullptr;
 
-    bufMgr->ui64BitstreamOrder = 0;
+    bufMgr->dwBitstreamFrameCount = 0;
     bufMgr->dwMaxBsSize        = m_ddiDecodeCtx->dwWidth *
                           m_ddiDecodeCtx->dwHeight * 3 / 2;
     // minimal 10k bytes for some special case. Will refractor this later
@@ -854,7 +854,7 @@ void DdiDecodeAVC::FreeResourceBuffer()
 
     bufMgr = &(m_ddiDecodeCtx->BufMgr);
 
-    for (i = 0; i < DDI_CODEC_MAX_BITSTREAM_BUFFER; i++)
+    for (i = 0; i < DDI_CODEC_MAX_BITSTREAM_BUFFER_RING; i++)
     {
         if (bufMgr->pBitStreamBase[i])
         {
@@ -31,6 +31,7 @@
 #include "codechal_memdecomp.h"
 #include "media_interfaces_codechal.h"
 #include "media_interfaces_mmd.h"
+#include "mos_mem_copy.h"
 
 DdiMediaDecode::DdiMediaDecode(DDI_DECODE_CONFIG_ATTR *ddiDecodeAttr)
     : DdiMediaBase()
@@ -222,8 +223,12 @@ VAStatus DdiMediaDecode::DecodeCombineBitstream(DDI_MEDIA_CONTEXT *mediaCtx)
     DDI_CODEC_COM_BUFFER_MGR *bufMgr;
     /* As it is checked in previous caller, it is skipped. */
     bufMgr = &(m_ddiDecodeCtx->BufMgr);
+    DDI_CHK_NULL(bufMgr, "Null bufMgr", VA_STATUS_ERROR_INVALID_PARAMETER);
 
-    if (bufMgr && (bufMgr->bIsSliceOverSize == false))
+    // the frame size history is used to size the bitstream buffers of the following frames
+    DdiDecode_RecordBsFrameSize(bufMgr, m_ddiDecodeCtx->DecodeParams.m_dataSize);
+
+    if (bufMgr->bIsSliceOverSize == false)
     {
         return VA_STATUS_SUCCESS;
     }
@@ -237,7 +242,8 @@ VAStatus DdiMediaDecode::DecodeCombineBitstream(DDI_MEDIA_CONTEXT *mediaCtx)
         return VA_STATUS_ERROR_DECODING_ERROR;
     }
 
-    newBitstreamBuffer->iSize     = m_ddiDecodeCtx->DecodeParams.m_dataSize;
+    // size the new buffer for the following frames as well, it replaces the bitstream buffer in the ring
+    newBitstreamBuffer->iSize     = DdiDecode_GetBsBufferSize(bufMgr, m_ddiDecodeCtx->DecodeParams.m_dataSize);
     newBitstreamBuffer->uiType    = VASliceDataBufferType;
     newBitstreamBuffer->format    = Media_Format_Buffer;
     newBitstreamBuffer->uiOffset  = 0;
@@ -272,9 +278,10 @@ VAStatus DdiMediaDecode::DecodeCombineBitstream(DDI_MEDIA_CONTEXT *mediaCtx)
         {
             if (bufMgr->pSliceData[slcInd].pSliceBuf)
             {
-                memcpy(newBitStreamBase + bufMgr->pSliceData[slcInd].uiOffset,
+                MOS_FastMemCopy(newBitStreamBase + bufMgr->pSliceData[slcInd].uiOffset,
                     bufMgr->pSliceData[slcInd].pSliceBuf,
-                    bufMgr->pSliceData[slcInd].uiLength);
+                    bufMgr->pSliceData[slcInd].uiLength,
+                    MOS_MEMCOPY_DST_UNCACHED);
                 MOS_FreeMemory(bufMgr->pSliceData[slcInd].pSliceBuf);
                 bufMgr->pSliceData[slcInd].pSliceBuf    = nullptr;
                 bufMgr->pSliceData[slcInd].bIsUseExtBuf = false;
@@ -282,9 +289,10 @@ VAStatus DdiMediaDecode::DecodeCombineBitstream(DDI_MEDIA_CONTEXT *mediaCtx)
         }
         else
         {
-            memcpy(newBitStreamBase + bufMgr->pSliceData[slcInd].uiOffset,
+            MOS_FastMemCopy(newBitStreamBase + bufMgr->pSliceData[slcInd].uiOffset,
                 bufMgr->pBitStreamBase[bufMgr->dwBitstreamIndex] + bufMgr->pSliceData[slcInd].uiOffset,
-                bufMgr->pSliceData[slcInd].uiLength);
+                bufMgr->pSliceData[slcInd].uiLength,
+                MOS_MEMCOPY_SRC_UNCACHED | MOS_MEMCOPY_DST_UNCACHED);
         }
     }
 
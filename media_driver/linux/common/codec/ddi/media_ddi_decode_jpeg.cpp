@@ -739,7 +739,7 @@ VAStatus DdiDecodeJPEG::InitResourceBuffer()
     DDI_CODEC_COM_BUFFER_MGR *bufMgr   = &(m_ddiDecodeCtx->BufMgr);
     bufMgr->pSliceData                 = nullptr;
 
-    bufMgr->ui64BitstreamOrder = 0;
+    bufMgr->dwBitstreamFrameCount = 0;
     bufMgr->dwMaxBsSize        = m_ddiDecodeCtx->dwWidth *
                           m_ddiDecodeCtx->dwHeight * 3 / 2;
 
@@ -588,7 +588,7 @@ VAStatus DdiDecodeMPEG2::InitResourceBuffer()
 
     bufMgr->pSliceData = nullptr;
 
-    bufMgr->ui64BitstreamOrder = 0;
+    bufMgr->dwBitstreamFrameCount = 0;
     bufMgr->dwMaxBsSize        = m_ddiDecodeCtx->dwWidth *
                           m_ddiDecodeCtx->dwHeight * 3 / 2;
     // minimal 10k bytes for some special case. Will refractor this later
@@ -650,7 +650,7 @@ void DdiDecodeMPEG2::FreeResourceBuffer()
     DDI_CODEC_COM_BUFFER_MGR *bufMgr = &(m_ddiDecodeCtx->BufMgr);
 
     int32_t i;
-    for (i = 0; i < DDI_CODEC_MAX_BITSTREAM_BUFFER; i++)
+    for (i = 0; i < DDI_CODEC_MAX_BITSTREAM_BUFFER_RING; i++)
     {
         if (bufMgr->pBitStreamBase[i])
         {
@@ -401,7 +401,7 @@ VAStatus DdiDecodeVP8::InitResourceBuffer(DDI_MEDIA_CONTEXT *mediaCtx)
     DDI_CODEC_COM_BUFFER_MGR *bufMgr = &(m_ddiDecodeCtx->BufMgr);
     bufMgr->pSliceData               = nullptr;
 
-    bufMgr->ui64BitstreamOrder = 0;
+    bufMgr->dwBitstreamFrameCount = 0;
     bufMgr->dwMaxBsSize        = m_ddiDecodeCtx->dwWidth *
                           m_ddiDecodeCtx->dwHeight * 3 / 2;
     // minimal 10k bytes for some special case. Will refractor this later
@@ -488,7 +488,7 @@ void DdiDecodeVP8::FreeResourceBuffer()
     DDI_CODEC_COM_BUFFER_MGR *bufMgr = &(m_ddiDecodeCtx->BufMgr);
 
     int32_t i;
-    for (i = 0; i < DDI_CODEC_MAX_BITSTREAM_BUFFER; i++)
+    for (i = 0; i < DDI_CODEC_MAX_BITSTREAM_BUFFER_RING; i++)
     {
         if (bufMgr->pBitStreamBase[i])
         {
@@ -1201,9 +1201,9 @@ VAStatus DdiEncodeBase::CreateBuffer(
         return va;
     }
 
-    bufferHeapElement->pBuffer   = buf;
-    bufferHeapElement->pCtx      = (void*)m_encodeCtx;
-    bufferHeapElement->uiCtxType = DDI_MEDIA_CONTEXT_TYPE_ENCODER;
+    __atomic_store_n(&bufferHeapElement->pCtx, (void*)m_encodeCtx, __ATOMIC_RELEASE);
+    __atomic_store_n(&bufferHeapElement->uiCtxType, DDI_MEDIA_CONTEXT_TYPE_ENCODER, __ATOMIC_RELEASE);
+    __atomic_store_n(&bufferHeapElement->pBuffer, buf, __ATOMIC_RELEASE);
     *bufId                        = bufferHeapElement->uiVaBufferID;
     mediaCtx->uiNumBufs++;
 
@@ -105,9 +105,9 @@ static int32_t DdiDecode_GetDisplayInfo(VADriverContextP ctx)
 int32_t DdiDecode_GetBitstreamBufIndexFromBuffer(DDI_CODEC_COM_BUFFER_MGR *pBufMgr, DDI_MEDIA_BUFFER *pBuf)
 {
     int32_t i;
-    for(i = 0; i < DDI_CODEC_MAX_BITSTREAM_BUFFER; i++)
+    for(i = 0; i < DDI_CODEC_MAX_BITSTREAM_BUFFER_RING; i++)
     {
-        if(pBufMgr->pBitStreamBuffObject[i]->bo == pBuf->bo)
+        if((pBufMgr->pBitStreamBuffObject[i] != nullptr) && (pBufMgr->pBitStreamBuffObject[i]->bo == pBuf->bo))
         {
             return i;
         }
@@ -116,6 +116,46 @@ int32_t DdiDecode_GetBitstreamBufIndexFromBuffer(DDI_CODEC_COM_BUFFER_MGR *pBufM
     return DDI_CODEC_INVALID_BUFFER_INDEX;
 }
 
+void DdiDecode_RecordBsFrameSize(DDI_CODEC_COM_BUFFER_MGR *pBufMgr, uint32_t dwFrameSize)
+{
+    pBufMgr->dwBsSizeHistory[pBufMgr->dwBsSizeHistoryIndex % DDI_CODEC_BS_SIZE_HISTORY] = dwFrameSize;
+    pBufMgr->dwBsSizeHistoryIndex++;
+}
+
+static uint32_t DdiDecode_GetRecentBsFrameSize(DDI_CODEC_COM_BUFFER_MGR *pBufMgr)
+{
+    uint32_t i;
+    uint32_t dwRecentSize = 0;
+
+    for (i = 0; i < DDI_CODEC_BS_SIZE_HISTORY; i++)
+    {
+        dwRecentSize = MOS_MAX(dwRecentSize, pBufMgr->dwBsSizeHistory[i]);
+    }
+
+    return dwRecentSize;
+}
+
+uint32_t DdiDecode_GetBsBufferSize(DDI_CODEC_COM_BUFFER_MGR *pBufMgr, uint32_t dwRequiredSize)
+{
+    uint32_t dwRecentSize;
+    uint32_t dwSize;
+
+    dwRecentSize = DdiDecode_GetRecentBsFrameSize(pBufMgr);
+    if (dwRecentSize == 0)
+    {
+        // no frame decoded yet, use the worst case size derived from the picture size
+        dwSize = pBufMgr->dwMaxBsSize;
+    }
+    else
+    {
+        // leave headroom for intra frames, which are usually larger than the recent ones
+        dwSize = MOS_MAX(dwRecentSize + dwRecentSize / 2, DDI_CODEC_MIN_VALUE_OF_MAX_BS_SIZE);
+    }
+
+    dwSize = MOS_MAX(dwSize, dwRequiredSize);
+    return MOS_ALIGN_CEIL(dwSize, MOS_PAGE_SIZE);
+}
+
 
 static bool DdiDecode_AllocBpBuffer(
     DDI_CODEC_COM_BUFFER_MGR   *pBufMgr)
@@ -180,17 +220,132 @@ static bool DdiDecode_AllocJPEGBsBuffer(
     return true;
 }
 
+static int32_t DdiDecode_GetFreeBsBufferIndex(
+    DDI_CODEC_COM_BUFFER_MGR    *pBufMgr)
+{
+    int32_t           i;
+    int32_t           unusedIndex = DDI_CODEC_INVALID_BUFFER_INDEX;
+    int32_t           oldestIndex = DDI_CODEC_INVALID_BUFFER_INDEX;
+    DDI_MEDIA_BUFFER *pBsBufObj;
+
+    for (i = 0; i < DDI_CODEC_MAX_BITSTREAM_BUFFER_RING; i++)
+    {
+        pBsBufObj = pBufMgr->pBitStreamBuffObject[i];
+        if ((pBsBufObj == nullptr) || (pBsBufObj->bo == nullptr))
+        {
+            //a bitstream buffer whose graphic memory is not allocated yet, only used if none of the allocated ones is free
+            if (unusedIndex == DDI_CODEC_INVALID_BUFFER_INDEX)
+            {
+                unusedIndex = i;
+            }
+            continue;
+        }
+
+        if (!mos_bo_busy(pBsBufObj->bo))
+        {
+            //find a bitstream buffer whose graphic memory is allocated but not used by HW now.
+            return i;
+        }
+
+        if ((oldestIndex == DDI_CODEC_INVALID_BUFFER_INDEX) ||
+            ((pBufMgr->dwBitstreamFrameCount - pBufMgr->dwBitstreamFrameTag[i]) >
+             (pBufMgr->dwBitstreamFrameCount - pBufMgr->dwBitstreamFrameTag[oldestIndex])))
+        {
+            oldestIndex = i;
+        }
+    }
+
+    if (unusedIndex != DDI_CODEC_INVALID_BUFFER_INDEX)
+    {
+        //all allocated bitstream buffers are in use, grow the ring instead of waiting.
+        return unusedIndex;
+    }
+
+    //the ring is full, wait for the oldest bistream buffer which is the most possible one to become free in the shortest time.
+    mos_bo_wait_rendering(pBufMgr->pBitStreamBuffObject[oldestIndex]->bo);
+    return oldestIndex;
+}
+
+static bool DdiDecode_GrowBsBuffer(
+    DDI_CODEC_COM_BUFFER_MGR    *pBufMgr,
+    PDDI_MEDIA_CONTEXT          pMediaCtx,
+    uint32_t                    dwUsedSize,
+    uint32_t                    dwRequiredSize)
+{
+    uint32_t          i;
+    DDI_MEDIA_BUFFER *pNewBsBufObj;
+    uint8_t          *pNewBsBufBaseAddr;
+    uint32_t          dwIndex = pBufMgr->dwBitstreamIndex;
+
+    // the slice data can only be moved if it was uploaded at creation, the application may hold a mapping of the others.
+    for (i = 0; i < pBufMgr->dwNumSliceData; i++)
+    {
+        if (pBufMgr->pSliceData[i].bIsUseExtBuf || (pBufMgr->pSliceData[i].pUploadedBuffer == nullptr))
+        {
+            return false;
+        }
+    }
+
+    pNewBsBufObj = (DDI_MEDIA_BUFFER *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_BUFFER));
+    if (pNewBsBufObj == nullptr)
+    {
+        return false;
+    }
+
+    // grow geometrically so that the following slices of this frame fit as well
+    pNewBsBufObj->iSize     = DdiDecode_GetBsBufferSize(pBufMgr, dwRequiredSize + dwRequiredSize / 2);
+    pNewBsBufObj->uiType    = VASliceDataBufferType;
+    pNewBsBufObj->format    = Media_Format_Buffer;
+    pNewBsBufObj->uiOffset  = 0;
+    pNewBsBufObj->pMediaCtx = pMediaCtx;
+
+    if (VA_STATUS_SUCCESS != DdiMediaUtil_CreateBuffer(pNewBsBufObj, pMediaCtx->pDrmBufMgr))
+    {
+        MOS_FreeMemory(pNewBsBufObj);
+        return false;
+    }
+
+    pNewBsBufBaseAddr = (uint8_t*)DdiMediaUtil_LockBuffer(pNewBsBufObj, MOS_LOCKFLAG_WRITEONLY);
+    if (pNewBsBufBaseAddr == nullptr)
+    {
+        DdiMediaUtil_FreeBuffer(pNewBsBufObj);
+        MOS_FreeMemory(pNewBsBufObj);
+        return false;
+    }
+
+    // move the slices uploaded so far once, the rest of the frame is written to the new buffer directly.
+    if (dwUsedSize > 0)
+    {
+        MOS_SecureMemcpy(pNewBsBufBaseAddr, dwUsedSize, pBufMgr->pBitStreamBase[dwIndex], dwUsedSize);
+    }
+
+    for (i = 0; i < pBufMgr->dwNumSliceData; i++)
+    {
+        pBufMgr->pSliceData[i].pUploadedBuffer->bo    = pNewBsBufObj->bo;
+        pBufMgr->pSliceData[i].pUploadedBuffer->pData = pNewBsBufBaseAddr;
+    }
+
+    DdiMediaUtil_UnlockBuffer(pBufMgr->pBitStreamBuffObject[dwIndex]);
+    DdiMediaUtil_FreeBuffer(pBufMgr->pBitStreamBuffObject[dwIndex]);
+    MOS_FreeMemory(pBufMgr->pBitStreamBuffObject[dwIndex]);
+
+    pBufMgr->pBitStreamBuffObject[dwIndex] = pNewBsBufObj;
+    pBufMgr->pBitStreamBase[dwIndex]       = pNewBsBufBaseAddr;
+    return true;
+}
+
 static bool DdiDecode_AllocBsBuffer(
     DDI_CODEC_COM_BUFFER_MGR    *pBufMgr,
     DDI_MEDIA_BUFFER            *pBuf,
     PDDI_MEDIA_CONTEXT          pMediaCtx)
 {
-    int32_t           index, i;
+    int32_t           index;
     VAStatus          vaStatus;
     uint8_t          *pSliceBuf;
     DDI_MEDIA_BUFFER *pBsBufObj = nullptr;
     uint8_t          *pBsBufBaseAddr = nullptr;
     bool              bCreateBsBuffer = false;
+    uint32_t          dwRecentSize;
 
     if ( nullptr == pBufMgr || nullptr == pBuf || nullptr == pMediaCtx )
     {
@@ -227,8 +382,10 @@ static bool DdiDecode_AllocBsBuffer(
     if(index >= 1)
     {
         pBuf->uiOffset = pBufMgr->pSliceData[index-1].uiOffset + pBufMgr->pSliceData[index-1].uiLength;
-        if((pBuf->uiOffset + pBuf->iSize) > pBufMgr->pBitStreamBuffObject[pBufMgr->dwBitstreamIndex]->iSize)
+        if((pBuf->uiOffset + pBuf->iSize) > pBufMgr->pBitStreamBuffObject[pBufMgr->dwBitstreamIndex]->iSize &&
+           !DdiDecode_GrowBsBuffer(pBufMgr, pMediaCtx, pBuf->uiOffset, pBuf->uiOffset + pBuf->iSize))
         {
+            //the slices can not be moved to a larger buffer now, keep this one aside and combine them at the end of the frame.
             pSliceBuf = (uint8_t*)MOS_AllocAndZeroMemory(pBuf->iSize);
             if(pSliceBuf == nullptr)
             {
@@ -245,57 +402,45 @@ static bool DdiDecode_AllocBsBuffer(
     else
     {
         pBufMgr->bIsSliceOverSize = false;
-        for (i = 0; i < DDI_CODEC_MAX_BITSTREAM_BUFFER; i++)
+        pBufMgr->dwBitstreamIndex = DdiDecode_GetFreeBsBufferIndex(pBufMgr);
+        pBufMgr->dwBitstreamFrameTag[pBufMgr->dwBitstreamIndex] = ++pBufMgr->dwBitstreamFrameCount;
+
+        if (pBufMgr->pBitStreamBuffObject[pBufMgr->dwBitstreamIndex] == nullptr)
         {
-            if (pBufMgr->pBitStreamBuffObject[i]->bo != nullptr)
-            {
-                if (!mos_bo_busy(pBufMgr->pBitStreamBuffObject[i]->bo))
-                {
-                    //find a bitstream buffer whoes graphic memory is allocated but not used by HW now.
-                    break;
-                }
-            }
-            else
+            pBsBufObj = (DDI_MEDIA_BUFFER *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_BUFFER));
+            if (pBsBufObj == nullptr)
             {
-                //find a new bitstream buffer whoes graphic memory is not allocated yet
-                break;
+                return false;
             }
+            pBsBufObj->uiType   = VASliceDataBufferType;
+            pBsBufObj->format   = Media_Format_Buffer;
+            pBsBufObj->uiOffset = 0;
+            pBufMgr->pBitStreamBuffObject[pBufMgr->dwBitstreamIndex] = pBsBufObj;
+            pBufMgr->pBitStreamBase[pBufMgr->dwBitstreamIndex]       = nullptr;
         }
 
-        if (i == DDI_CODEC_MAX_BITSTREAM_BUFFER)
-        {
-            //find the oldest bistream buffer which is the most possible one to become free in the shortest time.
-            pBufMgr->dwBitstreamIndex = (pBufMgr->ui64BitstreamOrder >> (DDI_CODEC_BITSTREAM_BUFFER_INDEX_BITS * DDI_CODEC_MAX_BITSTREAM_BUFFER_MINUS1)) & DDI_CODEC_MAX_BITSTREAM_BUFFER_INDEX;
-            // wait until decode complete
-            mos_bo_wait_rendering(pBufMgr->pBitStreamBuffObject[pBufMgr->dwBitstreamIndex]->bo);
-        }
-        else
-        {
-            pBufMgr->dwBitstreamIndex = i;
-        }
-        pBufMgr->ui64BitstreamOrder = (pBufMgr->ui64BitstreamOrder << 4) + pBufMgr->dwBitstreamIndex;
-        
         pBsBufObj                   = pBufMgr->pBitStreamBuffObject[pBufMgr->dwBitstreamIndex];
         pBsBufObj ->pMediaCtx       = pMediaCtx;
         pBsBufBaseAddr              = pBufMgr->pBitStreamBase[pBufMgr->dwBitstreamIndex];
+        dwRecentSize                = DdiDecode_GetRecentBsFrameSize(pBufMgr);
 
         if(pBsBufBaseAddr == nullptr)
         {
             bCreateBsBuffer = true;
-            if (pBuf->iSize > pBsBufObj->iSize)
-            {
-                pBsBufObj->iSize = pBuf->iSize;
-            }
+            pBsBufObj->iSize = DdiDecode_GetBsBufferSize(pBufMgr, pBuf->iSize);
         }
-        else if(pBuf->iSize > pBsBufObj->iSize)
+        else if((pBuf->iSize > pBsBufObj->iSize) ||
+                (dwRecentSize > pBsBufObj->iSize) ||
+                (pBsBufObj->iSize > 4 * DdiDecode_GetBsBufferSize(pBufMgr, pBuf->iSize)))
         {
-           //free bo
+            //resize the buffer to the recent frame sizes, it is idle at this point
             DdiMediaUtil_UnlockBuffer(pBsBufObj);
             DdiMediaUtil_FreeBuffer(pBsBufObj);
+            pBufMgr->pBitStreamBase[pBufMgr->dwBitstreamIndex] = nullptr;
             pBsBufBaseAddr = nullptr;
 
             bCreateBsBuffer = true;
-            pBsBufObj->iSize = pBuf->iSize;
+            pBsBufObj->iSize = DdiDecode_GetBsBufferSize(pBufMgr, pBuf->iSize);
         }
 
         if (bCreateBsBuffer)
@@ -304,7 +449,7 @@ static bool DdiDecode_AllocBsBuffer(
             {
                return false;
             }
-            
+
             pBsBufBaseAddr = (uint8_t*)DdiMediaUtil_LockBuffer(pBsBufObj, MOS_LOCKFLAG_WRITEONLY);
             if(pBsBufBaseAddr == nullptr)
             {
@@ -314,14 +459,15 @@ static bool DdiDecode_AllocBsBuffer(
             pBufMgr->pBitStreamBase[pBufMgr->dwBitstreamIndex] = pBsBufBaseAddr;
         }
     }
-    
+
     if(pBufMgr->pBitStreamBase[pBufMgr->dwBitstreamIndex] == nullptr)
     {
         return false;
     }
 
-    pBufMgr->pSliceData[index].uiLength = pBuf->iSize;
-    pBufMgr->pSliceData[index].uiOffset = pBuf->uiOffset;
+    pBufMgr->pSliceData[index].uiLength        = pBuf->iSize;
+    pBufMgr->pSliceData[index].uiOffset        = pBuf->uiOffset;
+    pBufMgr->pSliceData[index].pUploadedBuffer = nullptr;
 
     if(pBufMgr->bIsSliceOverSize == true)
     {
@@ -339,7 +485,6 @@ static bool DdiDecode_AllocBsBuffer(
 
     pBufMgr->dwNumSliceData ++;
     pBuf->bo                            = pBufMgr->pBitStreamBuffObject[pBufMgr->dwBitstreamIndex]->bo;
-    pBuf->bCFlushReq                    = true;
 
     return true;
 }
@@ -715,9 +860,9 @@ VAStatus DdiDecode_CreateBuffer(
         va = VA_STATUS_ERROR_MAX_NUM_EXCEEDED;
         goto CleanUpandReturn;
     }
-    pBufferHeapElement->pBuffer      = pBuf;
-    pBufferHeapElement->pCtx         = (void*)pDecCtx;
-    pBufferHeapElement->uiCtxType    = DDI_MEDIA_CONTEXT_TYPE_DECODER;
+    __atomic_store_n(&pBufferHeapElement->pCtx, (void*)pDecCtx, __ATOMIC_RELEASE);
+    __atomic_store_n(&pBufferHeapElement->uiCtxType, DDI_MEDIA_CONTEXT_TYPE_DECODER, __ATOMIC_RELEASE);
+    __atomic_store_n(&pBufferHeapElement->pBuffer, pBuf, __ATOMIC_RELEASE);
     *pBufId                          = pBufferHeapElement->uiVaBufferID;
 
 
@@ -735,14 +880,14 @@ VAStatus DdiDecode_CreateBuffer(
         return va;
     }
 
-    if( true == pBuf->bCFlushReq )
-    {
-        mos_bo_subdata(pBuf->bo, pBuf->uiOffset, size * num_elements, pData);
-    }
-    else
+    // slice data is written through the persistent mapping of the bitstream buffer, no pwrite is needed.
+    eStatus = MOS_SecureMemcpy((void *)(pBuf->pData + pBuf->uiOffset), size * num_elements, pData, size * num_elements);
+    DDI_CHK_CONDITION((eStatus != MOS_STATUS_SUCCESS), "DDI:Failed to copy buffer data!", VA_STATUS_ERROR_OPERATION_FAILED);
+
+    // the uploaded slice data can be moved if a later slice of this frame does not fit into the bitstream buffer.
+    if ((type == VASliceDataBufferType || type == VAProtectedSliceDataBufferType) && pDecCtx->wMode != CODECHAL_DECODE_MODE_JPEG)
     {
-        eStatus = MOS_SecureMemcpy((void *)(pBuf->pData + pBuf->uiOffset), size * num_elements, pData, size * num_elements);
-        DDI_CHK_CONDITION((eStatus != MOS_STATUS_SUCCESS), "DDI:Failed to copy buffer data!", VA_STATUS_ERROR_OPERATION_FAILED);
+        pDecCtx->BufMgr.pSliceData[pDecCtx->BufMgr.dwNumSliceData - 1].pUploadedBuffer = pBuf;
     }
     return va;
 
@@ -768,15 +913,15 @@ VAStatus DdiDecode_UnRegisterRTSurfaces(
     //Look through all decode contexts to unregister the surface in each decode context's RTtable.
     if (mediaCtx->pDecoderCtxHeap != nullptr)
     {
-        PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT pDecVACtxHeapBase;
+        PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT pDecVACtxHeapElmt;
 
         DdiMediaUtil_LockMutex(&mediaCtx->DecoderMutex);
-        pDecVACtxHeapBase  = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)mediaCtx->pDecoderCtxHeap->pHeapBase;
-        for (int32_t j = 0; j < mediaCtx->pDecoderCtxHeap->uiAllocatedHeapElements; j++)
+        for (uint32_t j = 0; j < mediaCtx->pDecoderCtxHeap->uiAllocatedHeapElements; j++)
         {
-            if (pDecVACtxHeapBase[j].pVaContext != nullptr)
+            pDecVACtxHeapElmt = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(mediaCtx->pDecoderCtxHeap, j);
+            if (pDecVACtxHeapElmt != nullptr && pDecVACtxHeapElmt->pVaContext != nullptr)
             {
-                PDDI_DECODE_CONTEXT  pDecCtx = (PDDI_DECODE_CONTEXT)pDecVACtxHeapBase[j].pVaContext;
+                PDDI_DECODE_CONTEXT  pDecCtx = (PDDI_DECODE_CONTEXT)pDecVACtxHeapElmt->pVaContext;
                 if (pDecCtx && pDecCtx->m_ddiDecode)
                 {
                     //not check the return value since the surface may not be registered in the context. pay attention to LOGW.
@@ -1060,7 +1205,7 @@ VAStatus DdiDecode_CreateContext (
         goto CleanUpandReturn;
     }
 
-    pVaContextHeapElmt->pVaContext     = (void*)pDecCtx;
+    __atomic_store_n(&pVaContextHeapElmt->pVaContext, (void*)pDecCtx, __ATOMIC_RELEASE);
     pMediaCtx->uiNumDecoders++;
     *context                           = (VAContextID)(pVaContextHeapElmt->uiVaContextID + DDI_MEDIA_VACONTEXTID_OFFSET_DECODER);
     DdiMediaUtil_UnLockMutex(&pMediaCtx->DecoderMutex);
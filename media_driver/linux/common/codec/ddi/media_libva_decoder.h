@@ -105,6 +105,8 @@ static __inline PDDI_DECODE_CONTEXT DdiDecode_GetDecContextFromPVOID (void *pDec
 
 PDDI_DECODE_CONTEXT DdiDecode_GetDecContextFromContextID (VADriverContextP ctx, VAContextID vaCtxID);
 int32_t DdiDecode_GetBitstreamBufIndexFromBuffer(DDI_CODEC_COM_BUFFER_MGR *pBufMgr, DDI_MEDIA_BUFFER *pBuf);
+void DdiDecode_RecordBsFrameSize(DDI_CODEC_COM_BUFFER_MGR *pBufMgr, uint32_t dwFrameSize);
+uint32_t DdiDecode_GetBsBufferSize(DDI_CODEC_COM_BUFFER_MGR *pBufMgr, uint32_t dwRequiredSize);
 
 VAStatus DdiDecode_CreateBuffer(
     VADriverContextP         ctx,
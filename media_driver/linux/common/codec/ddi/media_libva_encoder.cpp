@@ -417,7 +417,7 @@ VAStatus DdiEncode_CreateContext(
         return vaStatus;
     }
 
-    pVaContextHeapElmt->pVaContext = (void*)pEncCtx;
+    __atomic_store_n(&pVaContextHeapElmt->pVaContext, (void*)pEncCtx, __ATOMIC_RELEASE);
     pMediaDrvCtx->uiNumEncoders++;
     *context = (VAContextID)(pVaContextHeapElmt->uiVaContextID + DDI_MEDIA_VACONTEXTID_OFFSET_ENCODER);
     DdiMediaUtil_UnLockMutex(&pMediaDrvCtx->EncoderMutex);
@@ -49,11 +49,13 @@
 #include "media_libva_encoder.h"
 #ifndef ANDROID
 #include "media_libva_putsurface_linux.h"
+#include "media_libva_putsurface_sw.h"
 #else
 #include "media_libva_putsurface_android.h"
 #endif
 #include "media_libva_vp.h"
 #include "mos_os.h"
+#include "mos_mem_copy.h"
 
 #include "hwinfo_linux.h"
 #include "codechal_memdecomp.h"
@@ -281,6 +283,15 @@ static bool DdiMedia_ReleaseBsBuffer(
         }
         return false;
     }
+
+    // the buffer is gone, it must not be rebound if the bitstream buffer grows
+    for(i = 0; i < pBufMgr->dwNumSliceData; i++)
+    {
+        if(pBufMgr->pSliceData[i].pUploadedBuffer == pBuf)
+        {
+            pBufMgr->pSliceData[i].pUploadedBuffer = nullptr;
+        }
+    }
     return true;
 }
 
@@ -294,6 +305,7 @@ static uint32_t DdiMedia_CreateRenderTarget(
 )
 {
     PDDI_MEDIA_SURFACE_HEAP_ELEMENT  pSurfaceElement;
+    PDDI_MEDIA_SURFACE               pSurface;
     uint32_t                         uiSurfaceID;
 
     DdiMediaUtil_LockMutex(&pMediaDrvCtx->SurfaceMutex);
@@ -305,31 +317,34 @@ static uint32_t DdiMedia_CreateRenderTarget(
         return VA_INVALID_ID;
     }
 
-    pSurfaceElement->pSurface = (DDI_MEDIA_SURFACE *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_SURFACE));
-    if (nullptr == pSurfaceElement->pSurface)
+    pSurface = (DDI_MEDIA_SURFACE *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_SURFACE));
+    if (nullptr == pSurface)
     {
-        DdiMediaUtil_ReleasePMediaSurfaceFromHeap(pMediaDrvCtx->pSurfaceHeap, pSurfaceElement->uiVaSurfaceID);
+        DdiMediaUtil_ReleaseHeapElement(pMediaDrvCtx->pSurfaceHeap, pSurfaceElement->uiVaSurfaceID);
         DdiMediaUtil_UnLockMutex(&pMediaDrvCtx->SurfaceMutex);
         return VA_INVALID_ID;
     }
 
-    pSurfaceElement->pSurface->pMediaCtx       = pMediaDrvCtx;
-    pSurfaceElement->pSurface->iWidth          = dwWidth;
-    pSurfaceElement->pSurface->iHeight         = dwHeight;
-    pSurfaceElement->pSurface->pSurfDesc       = pSurfDesc;
-    pSurfaceElement->pSurface->format          = mediaFormat;
-    pSurfaceElement->pSurface->uiLockedBufID   = VA_INVALID_ID;
-    pSurfaceElement->pSurface->uiLockedImageID = VA_INVALID_ID;
-    pSurfaceElement->pSurface->surfaceUsageHint= surfaceUsageHint;
+    pSurface->pMediaCtx       = pMediaDrvCtx;
+    pSurface->iWidth          = dwWidth;
+    pSurface->iHeight         = dwHeight;
+    pSurface->pSurfDesc       = pSurfDesc;
+    pSurface->format          = mediaFormat;
+    pSurface->uiLockedBufID   = VA_INVALID_ID;
+    pSurface->uiLockedImageID = VA_INVALID_ID;
+    pSurface->surfaceUsageHint= surfaceUsageHint;
 
-    if(DdiMediaUtil_CreateSurface(pSurfaceElement->pSurface, pMediaDrvCtx)!= VA_STATUS_SUCCESS)
+    if(DdiMediaUtil_CreateSurface(pSurface, pMediaDrvCtx)!= VA_STATUS_SUCCESS)
     {
-        MOS_FreeMemory(pSurfaceElement->pSurface);
-        DdiMediaUtil_ReleasePMediaSurfaceFromHeap(pMediaDrvCtx->pSurfaceHeap, pSurfaceElement->uiVaSurfaceID);
+        MOS_FreeMemory(pSurface);
+        DdiMediaUtil_ReleaseHeapElement(pMediaDrvCtx->pSurfaceHeap, pSurfaceElement->uiVaSurfaceID);
         DdiMediaUtil_UnLockMutex(&pMediaDrvCtx->SurfaceMutex);
         return VA_INVALID_ID;
     }
 
+    // Lookups from other threads see the surface only once it is complete
+    __atomic_store_n(&pSurfaceElement->pSurface, pSurface, __ATOMIC_RELEASE);
+
     pMediaDrvCtx->uiNumSurfaces++;
     uiSurfaceID = pSurfaceElement->uiVaSurfaceID;
     DdiMediaUtil_UnLockMutex(&pMediaDrvCtx->SurfaceMutex);
@@ -606,221 +621,6 @@ static unsigned long DdiMedia_mask2shift(unsigned long mask)
     }
     return shift;
 }
-static void DdiMedia_yuv2pixel(uint32_t *pixel, int32_t y, int32_t u, int32_t v,
-                               unsigned long rshift, unsigned long rmask,
-                               unsigned long gshift, unsigned long gmask,
-                               unsigned long bshift, unsigned long bmask)
-{
-    int32_t r, g, b;
-    /* Warning, magic values ahead */
-    r = y + ((351 * (v-128)) >> 8);
-    g = y - (((179 * (v-128)) + (86 * (u-128))) >> 8);
-    b = y + ((444 * (u-128)) >> 8);
-
-    if (r > 255) r = 255;
-    if (g > 255) g = 255;
-    if (b > 255) b = 255;
-    if (r < 0)   r = 0;
-    if (g < 0)   g = 0;
-    if (b < 0)   b = 0;
-
-    *pixel = (uint32_t)(((r << rshift) & rmask) | ((g << gshift) & gmask) |((b << bshift) & bmask));
-}
-
-
-#define YUV_444P_TO_ARGB() \
-    pSrcY = pUmdContextY + pitch * srcy;\
-    pSrcU = pSrcY + pitch * ((pMediaSurface->iHeight));\
-    pSrcV = pSrcU + pitch * ((pMediaSurface->iHeight));\
-     \
-    for(y = srcy; y < (srcy + height); y += 1) \
-    {\
-        for(x = srcx; x < (srcx + width); x += 1) \
-        {\
-            y1 = *(pSrcY + x); \
-            u1 = *(pSrcU + x);\
-            v1 = *(pSrcV + x);\
-            \
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + (x * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y1, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-           \
-        }\
-        pSrcY += pitch;\
-        pSrcU += pitch;\
-        pSrcV += pitch;\
-    }
-
-#define YUV_422H_TO_ARGB()\
-    pSrcY = pUmdContextY + pitch * srcy;\
-    pSrcU = pSrcY + pitch * pMediaSurface->iHeight;\
-    pSrcV = pSrcU + pitch * pMediaSurface->iHeight;\
-    \
-    for(y = srcy; y < (srcy + height); y += 1)\
-    {\
-        for(x = srcx; x < (srcx + width); x += 2)\
-        {\
-            y1 = *(pSrcY + x);\
-            y2 = *(pSrcY + x + 1);\
-            u1 = *(pSrcU + x / 2);\
-            v1 = *(pSrcV + x / 2);\
-            \
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + (x * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y1, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + ((x + 1) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y2, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-        }\
-        pSrcY += pitch;\
-        pSrcU += pitch;\
-        pSrcV += pitch;\
-    }
-
-#define YUV_422V_TO_ARGB() \
-    pSrcY = pUmdContextY + pitch * srcy;\
-    pSrcU = pSrcY + pitch * pMediaSurface->iHeight;\
-    pSrcV = pSrcU + pitch * pMediaSurface->iHeight / 2;\
-    \
-    for(y = srcy; y < (srcy + width); y += 1)\
-    {\
-        for(x = srcx; x < (srcx + height); x += 2)\
-        {\
-            y1 = *(pSrcY + x * pitch);\
-            y2 = *(pSrcY + (x + 1) * pitch);\
-            u1 = *(pSrcU + (x / 2) * pitch);\
-            v1 = *(pSrcV + (x / 2) * pitch);\
-            \
-            pPixel = (uint32_t *)(pXimg->data + (x * pXimg->bytes_per_line) + (y * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y1, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + (x* pXimg->bytes_per_line) + ((y + 1) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y2, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            \
-        }\
-        \
-        pSrcY += 1;\
-        pSrcU += 1;\
-        pSrcV += 1;\
-    }
-
-#define YUV_IMC3_TO_ARGB() \
-    pSrcY = pUmdContextY + pitch * srcy;\
-    pSrcU = pSrcY + pitch * pMediaSurface->iHeight;\
-    pSrcV = pSrcU + pitch * pMediaSurface->iHeight / 2;\
-    \
-    for(y = srcy; y < (srcy + height); y += 2) \
-    {\
-        for(x = srcx; x < (srcx + width); x += 2) \
-        {\
-            y1 = *(pSrcY + x);\
-            y2 = *(pSrcY + x + 1);\
-            y3 = *(pSrcY + x + pitch);\
-            y4 = *(pSrcY + x + pitch + 1);\
-            \
-            u1 = *(pSrcU + x / 2);\
-            v1 = *(pSrcV + x / 2);\
-            \
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + (x * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y1, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + ((x + 1) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y2, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + ((y + 1) * pXimg->bytes_per_line) + (x * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y3, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + ((y + 1) * pXimg->bytes_per_line) + ((x + 1) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y4, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask); \
-        }\
-        pSrcY += pitch * 2;\
-        pSrcU += pitch;\
-        pSrcV += pitch;\
-    }
-
-#define YUV_411P_TO_ARGB() \
-    pSrcY = pUmdContextY + pitch * srcy;\
-    pSrcU = pSrcY + pitch * pMediaSurface->iHeight;\
-    pSrcV = pSrcU + pitch * pMediaSurface->iHeight;\
-    \
-    for(y = srcy; y < (srcy + height); y += 1)\
-    {\
-        for(x = srcx; x < (srcx + width); x += 4)\
-        {\
-            y1 = *(pSrcY + x);\
-            y2 = *(pSrcY + x + 1);\
-            y3 = *(pSrcY + x + 2);\
-            y4 = *(pSrcY + x + 3);\
-            \
-            u1 = *(pSrcU + x / 4);\
-            v1 = *(pSrcV + x / 4);\
-            \
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + (x * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y1, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + ((x + 1) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y2, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + ((y ) * pXimg->bytes_per_line) + ((x+2) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y3, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + ((y) * pXimg->bytes_per_line) + ((x + 3) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y4, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-        }\
-        pSrcY  += pitch;\
-        pSrcU  += pitch;\
-        pSrcV  += pitch;\
-    }
-
-#define YUV_400P_TO_ARGB()\
-    pSrcY = pUmdContextY + pitch * srcy;\
-    pSrcU = pSrcY;\
-    pSrcV = pSrcY;\
-    \
-    for(y = srcy; y < (srcy + height); y += 2)\
-    {\
-        for(x = srcx; x < (srcx + width); x += 2)\
-        {\
-            y1 = *(pSrcY + x);\
-            y2 = *(pSrcY + x + 1);\
-            y3 = *(pSrcY + x + pitch);\
-            y4 = *(pSrcY + x + pitch + 1);\
-            \
-            u1 = 128;\
-            v1 = 128;\
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + (x * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y1, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + ((x + 1) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y2, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + ((y + 1) * pXimg->bytes_per_line) + (x * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y3, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + ((y + 1) * pXimg->bytes_per_line) + ((x + 1) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y4, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-        }\
-        pSrcY += pitch * 2;\
-        pSrcU += pitch;\
-        pSrcV += pitch;\
-    }
-
-#define YUV_NV12_TO_ARGB()\
-    pSrcY = pUmdContextY + pitch * srcy;\
-    pSrcU = pSrcY + pitch * pMediaSurface->iHeight;\
-    pSrcV = pSrcU + 1;\
-    \
-    for(y = srcy; y < (srcy + height); y += 2)\
-    {\
-        for(x = srcx; x < (srcx + width); x += 2)\
-        {\
-            y1 = *(pSrcY + x);\
-            y2 = *(pSrcY + x + 1);\
-            y3 = *(pSrcY + x + pitch);\
-            y4 = *(pSrcY + x + pitch + 1);\
-            \
-            u1 = *(pSrcU + x);\
-            v1 = *(pSrcU + x +1);\
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + (x * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y1, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + (y * pXimg->bytes_per_line) + ((x + 1) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y2, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + ((y + 1) * pXimg->bytes_per_line) + (x * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y3, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-            pPixel = (uint32_t *)(pXimg->data + ((y + 1) * pXimg->bytes_per_line) + ((x + 1) * (pXimg->bits_per_pixel >> 3)));\
-            DdiMedia_yuv2pixel(pPixel, y4, u1, v1, rshift, rmask, gshift, gmask, bshift, bmask);\
-        }\
-        pSrcY += pitch * 2;\
-        pSrcU += pitch;\
-    }
-
 VAStatus DdiMedia_PutSurfaceLinuxSW(
     VADriverContextP ctx,
     VASurfaceID      surface,
@@ -841,15 +641,7 @@ VAStatus DdiMedia_PutSurfaceLinuxSW(
     GC               gc;
     XImage          *pXimg = nullptr;
     Visual          *visual;
-    uint16_t         width, height;
     int32_t          depth;
-    int32_t          x, y;
-    uint8_t         *pSurface = nullptr;
-    uint32_t        *pPixel;
-    uint8_t         *pSrcY;
-    uint8_t         *pSrcU;
-    uint8_t         *pSrcV;
-    int32_t          y1, y2, y3, y4, u1, v1;
 
     PDDI_MEDIA_CONTEXT             pMediaCtx;
     DDI_MEDIA_SURFACE             *pMediaSurface;
@@ -857,12 +649,10 @@ VAStatus DdiMedia_PutSurfaceLinuxSW(
     int32_t                        pitch =0;
     uint8_t                       *pUmdContextY = nullptr;
     unsigned long                  rmask, gmask, bmask;
-    unsigned long                  rshift, gshift, bshift;
-    uint32_t                       uiAdjustU     = 1;
-    uint32_t                       uiAdjustD     = 1;
     uint32_t                       uiSurfaceSize = 0;
     uint8_t                       *pDispTempBuffer;
-    MOS_STATUS                     eStatus = MOS_STATUS_SUCCESS;
+    DDI_MEDIA_SW_CSC_PARAMS        CscParams;
+    VAStatus                       vaStatus;
 
     TypeXCreateGC                  pfn_XCreateGC     = nullptr;
     TypeXFreeGC                    pfn_XFreeGC       = nullptr;
@@ -889,45 +679,30 @@ VAStatus DdiMedia_PutSurfaceLinuxSW(
     pMediaSurface     = DdiMedia_GetSurfaceFromVASurfaceID(pMediaCtx, surface);
     DDI_CHK_NULL(pMediaSurface, "Null pMediaSurface.", VA_STATUS_ERROR_INVALID_SURFACE);
 
-    if (srcw <= destw)
-        width = srcw;
-    else
-        width = destw;
-
-    if (srch <= desth)
-        height = srch;
-    else
-        height = desth;
+    pitch         = pMediaSurface->iPitch;
+    uiSurfaceSize = DdiMediaSw_GetSurfaceSize(pMediaSurface->format, pitch, pMediaSurface->iHeight);
+    if (0 == uiSurfaceSize)
+    {
+        DDI_ASSERTMESSAGE("Color Format is not supported: %d",pMediaSurface->format);
+        return VA_STATUS_ERROR_INVALID_VALUE;
+    }
 
-    pitch      = pMediaSurface->iPitch;
-    switch(pMediaSurface->format)
+    // Clip the source rectangle to the surface, scaling maps it onto the whole destination rectangle
+    srcx = MOS_MAX(srcx, 0);
+    srcy = MOS_MAX(srcy, 0);
+    if (srcx >= pMediaSurface->iWidth || srcy >= pMediaSurface->iHeight || 0 == destw || 0 == desth)
     {
-        case Media_Format_422H:
-        case Media_Format_444P:
-        case Media_Format_411P:
-            uiAdjustU = 3;
-            uiAdjustD = 1;
-            break;
-        case Media_Format_400P:
-            uiAdjustU = 1;
-            uiAdjustD = 1;
-            break;
-        case Media_Format_422V:
-        case Media_Format_IMC3:
-            uiAdjustU = 2;
-            uiAdjustD = 1;
-            break;
-        case Media_Format_NV12:
-            uiAdjustU = 3;
-            uiAdjustD = 2;
-            break;
-        default:
-            DDI_ASSERTMESSAGE("Color Format is not supported: %d",pMediaSurface->format);
-            return VA_STATUS_ERROR_INVALID_VALUE;
+        return VA_STATUS_SUCCESS;
+    }
+    srcw = MOS_MIN(srcw, pMediaSurface->iWidth - srcx);
+    srch = MOS_MIN(srch, pMediaSurface->iHeight - srcy);
+    if (0 == srcw || 0 == srch)
+    {
+        return VA_STATUS_SUCCESS;
     }
-    ptr                    = (uint8_t*)DdiMediaUtil_LockSurface(pMediaSurface, (MOS_LOCKFLAG_READONLY | MOS_LOCKFLAG_WRITEONLY));
 
-    uiSurfaceSize          = pitch * pMediaSurface->iHeight * uiAdjustU / uiAdjustD;
+    ptr                    = (uint8_t*)DdiMediaUtil_LockSurface(pMediaSurface, MOS_LOCKFLAG_READONLY);
+
     pDispTempBuffer        = (uint8_t *)malloc(uiSurfaceSize);
     if (pDispTempBuffer == nullptr)
     {
@@ -936,9 +711,9 @@ VAStatus DdiMedia_PutSurfaceLinuxSW(
     }
 
     pUmdContextY = pDispTempBuffer;
-    eStatus = MOS_SecureMemcpy(pUmdContextY, uiSurfaceSize, ptr, uiSurfaceSize);
-    DDI_CHK_CONDITION((eStatus != MOS_STATUS_SUCCESS), "DDI:Failed to copy surface buffer data!", VA_STATUS_ERROR_OPERATION_FAILED);
-    pSurface     = pUmdContextY;
+    MOS_FastMemCopy(pUmdContextY, ptr, uiSurfaceSize, MOS_MEMCOPY_SRC_UNCACHED);
+    DdiMediaUtil_UnlockSurface(pMediaSurface);
+
     visual       = DefaultVisual(ctx->native_dpy, ctx->x11_screen);
     gc           = (*pfn_XCreateGC)((Display*)ctx->native_dpy, (Drawable)draw, 0, nullptr);
     depth        = DefaultDepth(ctx->native_dpy, ctx->x11_screen);
@@ -954,11 +729,30 @@ VAStatus DdiMedia_PutSurfaceLinuxSW(
     gmask  = visual->green_mask;
     bmask  = visual->blue_mask;
 
-    rshift = DdiMedia_mask2shift(rmask);
-    gshift = DdiMedia_mask2shift(gmask);
-    bshift = DdiMedia_mask2shift(bmask);
-
-    pXimg   = (*pfn_XCreateImage)((Display*)ctx->native_dpy, visual, depth, ZPixmap, 0, nullptr,width, height, 32, 0 );
+    MOS_ZeroMemory(&CscParams, sizeof(CscParams));
+    vaStatus = DdiMediaSw_SetupPlanes(pMediaSurface->format, pUmdContextY, pitch, pMediaSurface->iHeight, &CscParams);
+    if (VA_STATUS_SUCCESS != vaStatus)
+    {
+        (*pfn_XFreeGC)((Display*)ctx->native_dpy, gc);
+        MOS_FreeMemory(pDispTempBuffer);
+        return vaStatus;
+    }
+    CscParams.iPlaneWidth   = pMediaSurface->iWidth;
+    CscParams.iPlaneHeight  = pMediaSurface->iHeight;
+    CscParams.iSrcX         = srcx;
+    CscParams.iSrcY         = srcy;
+    CscParams.iSrcWidth     = srcw;
+    CscParams.iSrcHeight    = srch;
+    CscParams.iDstWidth     = destw;
+    CscParams.iDstHeight    = desth;
+    CscParams.uiRMask       = (uint32_t)rmask;
+    CscParams.uiGMask       = (uint32_t)gmask;
+    CscParams.uiBMask       = (uint32_t)bmask;
+    CscParams.uiRShift      = (uint32_t)DdiMedia_mask2shift(rmask);
+    CscParams.uiGShift      = (uint32_t)DdiMedia_mask2shift(gmask);
+    CscParams.uiBShift      = (uint32_t)DdiMedia_mask2shift(bmask);
+
+    pXimg   = (*pfn_XCreateImage)((Display*)ctx->native_dpy, visual, depth, ZPixmap, 0, nullptr, destw, desth, 32, 0 );
     if (pXimg == nullptr)
     {
         MOS_FreeMemory(pDispTempBuffer);
@@ -973,7 +767,7 @@ VAStatus DdiMedia_PutSurfaceLinuxSW(
          return VA_STATUS_ERROR_UNKNOWN;
     }
 
-    pXimg->data = (char *) malloc(pXimg->bytes_per_line * MOS_ALIGN_CEIL(height, 2)); // If height is odd, need to add it by one for we process two lines per iteration
+    pXimg->data = (char *) malloc(pXimg->bytes_per_line * desth);
     if (nullptr == pXimg->data)
     {
         (*pfn_XDestroyImage)(pXimg);
@@ -982,35 +776,17 @@ VAStatus DdiMedia_PutSurfaceLinuxSW(
         return VA_STATUS_ERROR_ALLOCATION_FAILED;
     }
 
-     switch(pMediaSurface->format)
+    CscParams.pDst      = (uint8_t *)pXimg->data;
+    CscParams.iDstPitch = pXimg->bytes_per_line;
+    vaStatus = DdiMediaSw_ConvertAndScale(&CscParams);
+    if (VA_STATUS_SUCCESS != vaStatus)
     {
-        case Media_Format_444P:
-            YUV_444P_TO_ARGB();
-            break;
-        case Media_Format_422H:
-            YUV_422H_TO_ARGB();
-            break;
-        case Media_Format_422V:
-            YUV_422V_TO_ARGB();
-            break;
-        case Media_Format_IMC3:
-            YUV_IMC3_TO_ARGB();
-            break;
-        case Media_Format_411P:
-            YUV_411P_TO_ARGB();
-            break;
-        case Media_Format_400P:
-            YUV_400P_TO_ARGB();
-            break;
-        case Media_Format_NV12:
-            YUV_NV12_TO_ARGB();
-            break;
-        default:
-            DDI_ASSERTMESSAGE("Color Format is not supported: %d", pMediaSurface->format);
+        (*pfn_XDestroyImage)(pXimg);
+        (*pfn_XFreeGC)((Display*)ctx->native_dpy, gc);
+        MOS_FreeMemory(pDispTempBuffer);
+        return vaStatus;
     }
 
-    DdiMediaUtil_UnlockSurface(pMediaSurface);
-
     (*pfn_XPutImage)((Display*)ctx->native_dpy,(Drawable)draw, gc, pXimg, 0, 0, destx, desty, destw, desth);
 
     if (pXimg != nullptr)
@@ -1127,7 +903,6 @@ err_finish:
 static void DdiMedia_FreeSurfaceHeapElements(PDDI_MEDIA_CONTEXT pMediaCtx)
 {
     PDDI_MEDIA_HEAP                 pSurfaceHeap;
-    PDDI_MEDIA_SURFACE_HEAP_ELEMENT pMediaSurfaceHeapBase;
     PDDI_MEDIA_SURFACE_HEAP_ELEMENT pMediaSurfaceHeapElmt;
     int32_t                         uiElementId;
     int32_t                         uiSurfaceNums;
@@ -1139,15 +914,11 @@ static void DdiMedia_FreeSurfaceHeapElements(PDDI_MEDIA_CONTEXT pMediaCtx)
     if (nullptr == pSurfaceHeap)
         return;
 
-    pMediaSurfaceHeapBase = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)pSurfaceHeap->pHeapBase;
-    if (nullptr == pMediaSurfaceHeapBase)
-        return;
-
     uiSurfaceNums = pMediaCtx->uiNumSurfaces;
     for (uiElementId = 0; uiElementId < uiSurfaceNums; uiElementId++)
     {
-        pMediaSurfaceHeapElmt = &pMediaSurfaceHeapBase[uiElementId];
-        if (nullptr == pMediaSurfaceHeapElmt->pSurface)
+        pMediaSurfaceHeapElmt = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pSurfaceHeap, uiElementId);
+        if (nullptr == pMediaSurfaceHeapElmt || nullptr == pMediaSurfaceHeapElmt->pSurface)
             continue;
 
         DdiMediaUtil_FreeSurface(pMediaSurfaceHeapElmt->pSurface);
@@ -1169,7 +940,6 @@ static void DdiMedia_FreeBufferHeapElements(VADriverContextP    ctx)
     PDDI_MEDIA_CONTEXT             pMediaCtx;
     PDDI_MEDIA_HEAP                pBufferHeap;
     PDDI_MEDIA_BUFFER_HEAP_ELEMENT pMediaBufferHeapElmt;
-    PDDI_MEDIA_BUFFER_HEAP_ELEMENT pMediaBufferHeapBase;
     int32_t                        uiElementId;
     int32_t                        uiBufNums;
 
@@ -1181,15 +951,11 @@ static void DdiMedia_FreeBufferHeapElements(VADriverContextP    ctx)
     if (nullptr == pBufferHeap)
         return;
 
-    pMediaBufferHeapBase = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)pBufferHeap->pHeapBase;
-    if (nullptr == pMediaBufferHeapBase)
-        return;
-
     uiBufNums = pMediaCtx->uiNumBufs;
     for (uiElementId = 0; uiElementId < uiBufNums; ++uiElementId)
     {
-        pMediaBufferHeapElmt = &pMediaBufferHeapBase[uiElementId];
-        if (nullptr == pMediaBufferHeapElmt->pBuffer)
+        pMediaBufferHeapElmt = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pBufferHeap, uiElementId);
+        if (nullptr == pMediaBufferHeapElmt || nullptr == pMediaBufferHeapElmt->pBuffer)
             continue;
         DdiMedia_DestroyBuffer(ctx,pMediaBufferHeapElmt->uiVaBufferID);
     }
@@ -1207,7 +973,6 @@ static void DdiMedia_FreeImageHeapElements(VADriverContextP    ctx)
     PDDI_MEDIA_CONTEXT             pMediaCtx;
     PDDI_MEDIA_HEAP                pImageHeap;
     PDDI_MEDIA_IMAGE_HEAP_ELEMENT  pMediaImageHeapElmt;
-    PDDI_MEDIA_IMAGE_HEAP_ELEMENT  pMediaImageHeapBase;
     int32_t                        uiElementId;
     int32_t                        uiImageNums;
 
@@ -1219,15 +984,11 @@ static void DdiMedia_FreeImageHeapElements(VADriverContextP    ctx)
     if (nullptr == pImageHeap)
         return;
 
-    pMediaImageHeapBase = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)pImageHeap->pHeapBase;
-    if (nullptr == pMediaImageHeapBase)
-        return;
-
     uiImageNums = pMediaCtx->uiNumImages;
     for (uiElementId = 0; uiElementId < uiImageNums; ++uiElementId)
     {
-        pMediaImageHeapElmt = &pMediaImageHeapBase[uiElementId];
-        if (nullptr == pMediaImageHeapElmt->pImage)
+        pMediaImageHeapElmt = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pImageHeap, uiElementId);
+        if (nullptr == pMediaImageHeapElmt || nullptr == pMediaImageHeapElmt->pImage)
             continue;
         DdiMedia_DestroyImage(ctx,pMediaImageHeapElmt->uiVaImageID);
     }
@@ -1243,19 +1004,14 @@ static void DdiMedia_FreeImageHeapElements(VADriverContextP    ctx)
 /////////////////////////////////////////////////////////////////////////////
 static void DdiMedia_FreeContextHeap(VADriverContextP ctx, PDDI_MEDIA_HEAP pContextHeap,int32_t VaContextOffset, int32_t uiCtxNums)
 {
-    PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT  pMediaContextHeapBase;
     PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT  pMediaContextHeapElmt;
     int32_t                            uiElementId;
     VAContextID                        uiVaCtxID;
 
-    pMediaContextHeapBase = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)pContextHeap->pHeapBase;
-    if (nullptr == pMediaContextHeapBase)
-        return;
-
     for (uiElementId = 0; uiElementId < uiCtxNums; ++uiElementId)
     {
-        pMediaContextHeapElmt = &pMediaContextHeapBase[uiElementId];
-        if (nullptr == pMediaContextHeapElmt->pVaContext)
+        pMediaContextHeapElmt = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pContextHeap, uiElementId);
+        if (nullptr == pMediaContextHeapElmt || nullptr == pMediaContextHeapElmt->pVaContext)
             continue;
         uiVaCtxID = (VAContextID)(pMediaContextHeapElmt->uiVaContextID + VaContextOffset);
         DdiMedia_DestroyContext(ctx,uiVaCtxID);
@@ -1353,12 +1109,9 @@ VAImage* DdiMedia_GetVAImageFromVAImageID (PDDI_MEDIA_CONTEXT pMediaCtx, VAImage
     VAImage                      *pVaImage;
 
     i               = (uint32_t)ImageID;
-    DDI_CHK_LESS(i, pMediaCtx->pImageHeap->uiAllocatedHeapElements, "invalid image id", nullptr);
-    DdiMediaUtil_LockMutex(&pMediaCtx->ImageMutex);
-    pImageElement   = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)pMediaCtx->pImageHeap->pHeapBase;
-    pImageElement  += i;
-    pVaImage        = pImageElement->pImage;
-    DdiMediaUtil_UnLockMutex(&pMediaCtx->ImageMutex);
+    pImageElement   = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pMediaCtx->pImageHeap, i);
+    DDI_CHK_NULL(pImageElement, "invalid image id", nullptr);
+    pVaImage        = __atomic_load_n(&pImageElement->pImage, __ATOMIC_ACQUIRE);
 
     return pVaImage;
 }
@@ -1369,12 +1122,9 @@ void* DdiMedia_GetCtxFromVABufferID (PDDI_MEDIA_CONTEXT pMediaCtx, VABufferID bu
     void                          *pTemp;
 
     i                = (uint32_t)bufferID;
-    DDI_CHK_LESS(i, pMediaCtx->pBufferHeap->uiAllocatedHeapElements, "invalid buffer id", nullptr);
-    DdiMediaUtil_LockMutex(&pMediaCtx->BufferMutex);
-    pBufHeapElement  = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)pMediaCtx->pBufferHeap->pHeapBase;
-    pBufHeapElement += i;
-    pTemp            = pBufHeapElement->pCtx;
-    DdiMediaUtil_UnLockMutex(&pMediaCtx->BufferMutex);
+    pBufHeapElement  = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pMediaCtx->pBufferHeap, i);
+    DDI_CHK_NULL(pBufHeapElement, "invalid buffer id", nullptr);
+    pTemp            = __atomic_load_n(&pBufHeapElement->pCtx, __ATOMIC_ACQUIRE);
 
     return pTemp;
 }
@@ -1386,12 +1136,9 @@ uint32_t DdiMedia_GetCtxTypeFromVABufferID (PDDI_MEDIA_CONTEXT pMediaCtx, VABuff
     uint32_t                       uiCtxType;
 
     i                = (uint32_t)bufferID;
-    DDI_CHK_LESS(i, pMediaCtx->pBufferHeap->uiAllocatedHeapElements, "invalid buffer id", DDI_MEDIA_CONTEXT_TYPE_NONE);
-    DdiMediaUtil_LockMutex(&pMediaCtx->BufferMutex);
-    pBufHeapElement  = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)pMediaCtx->pBufferHeap->pHeapBase;
-    pBufHeapElement += i;
-    uiCtxType        = pBufHeapElement->uiCtxType;
-    DdiMediaUtil_UnLockMutex(&pMediaCtx->BufferMutex);
+    pBufHeapElement  = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pMediaCtx->pBufferHeap, i);
+    DDI_CHK_NULL(pBufHeapElement, "invalid buffer id", DDI_MEDIA_CONTEXT_TYPE_NONE);
+    uiCtxType        = __atomic_load_n(&pBufHeapElement->uiCtxType, __ATOMIC_ACQUIRE);
 
     return uiCtxType;
 
@@ -1822,28 +1569,28 @@ static VAStatus DdiMedia_Terminate (
     mos_bufmgr_destroy(pMediaCtx->pDrmBufMgr);
 
     // destroy heaps
-    MOS_FreeMemory(pMediaCtx->pSurfaceHeap->pHeapBase);
+    DdiMediaUtil_DestroyHeap(pMediaCtx->pSurfaceHeap);
     MOS_FreeMemory(pMediaCtx->pSurfaceHeap);
 
-    MOS_FreeMemory(pMediaCtx->pBufferHeap->pHeapBase);
+    DdiMediaUtil_DestroyHeap(pMediaCtx->pBufferHeap);
     MOS_FreeMemory(pMediaCtx->pBufferHeap);
 
-    MOS_FreeMemory(pMediaCtx->pImageHeap->pHeapBase);
+    DdiMediaUtil_DestroyHeap(pMediaCtx->pImageHeap);
     MOS_FreeMemory(pMediaCtx->pImageHeap);
 
-    MOS_FreeMemory(pMediaCtx->pDecoderCtxHeap->pHeapBase);
+    DdiMediaUtil_DestroyHeap(pMediaCtx->pDecoderCtxHeap);
     MOS_FreeMemory(pMediaCtx->pDecoderCtxHeap);
 
-    MOS_FreeMemory(pMediaCtx->pEncoderCtxHeap->pHeapBase);
+    DdiMediaUtil_DestroyHeap(pMediaCtx->pEncoderCtxHeap);
     MOS_FreeMemory(pMediaCtx->pEncoderCtxHeap);
 
-    MOS_FreeMemory(pMediaCtx->pVpCtxHeap->pHeapBase);
+    DdiMediaUtil_DestroyHeap(pMediaCtx->pVpCtxHeap);
     MOS_FreeMemory(pMediaCtx->pVpCtxHeap);
 
-    MOS_FreeMemory(pMediaCtx->pCmCtxHeap->pHeapBase);
+    DdiMediaUtil_DestroyHeap(pMediaCtx->pCmCtxHeap);
     MOS_FreeMemory(pMediaCtx->pCmCtxHeap);
 
-    MOS_FreeMemory(pMediaCtx->pMfeCtxHeap->pHeapBase);
+    DdiMediaUtil_DestroyHeap(pMediaCtx->pMfeCtxHeap);
     MOS_FreeMemory(pMediaCtx->pMfeCtxHeap);
 
     // Destroy memory allocated to store Media System Info
@@ -2679,7 +2426,7 @@ static VAStatus DdiMedia_CreateMfeContextInternal(
         goto CleanUpandReturn;
     }
 
-    pVaContextHeapElmt->pVaContext    = (void*)pEncodeMfeContext;
+    __atomic_store_n(&pVaContextHeapElmt->pVaContext, (void*)pEncodeMfeContext, __ATOMIC_RELEASE);
     pMediaDrvCtx->uiNumMfes++;
     *mfe_context                          = (VAMFContextID)(pVaContextHeapElmt->uiVaContextID + DDI_MEDIA_VACONTEXTID_OFFSET_MFE);
     DdiMediaUtil_UnLockMutex(&pMediaDrvCtx->MfeMutex);
@@ -3286,6 +3033,39 @@ VAStatus DdiMedia_MapBuffer (
     return DdiMedia_MapBufferInternal(ctx, buf_id, pbuf, MOS_LOCKFLAG_READONLY | MOS_LOCKFLAG_WRITEONLY);
 }
 
+#if VA_CHECK_VERSION(1, 21, 0)
+/*
+ * vaMapBuffer2: read only maps of derived images go through the cached
+ * detiled copy of the surface instead of the GTT
+ */
+static VAStatus DdiMedia_MapBufferWithFlags (
+    VADriverContextP    ctx,
+    VABufferID          buf_id,
+    void                **pbuf,
+    uint32_t            flags
+)
+{
+    uint32_t            lockFlag = 0;
+
+    if (flags & ~(VA_MAPBUFFER_FLAG_READ | VA_MAPBUFFER_FLAG_WRITE))
+    {
+        return VA_STATUS_ERROR_INVALID_PARAMETER;
+    }
+
+    if (flags == VA_MAPBUFFER_FLAG_DEFAULT)
+    {
+        lockFlag = MOS_LOCKFLAG_READONLY | MOS_LOCKFLAG_WRITEONLY;
+    }
+    else
+    {
+        lockFlag |= (flags & VA_MAPBUFFER_FLAG_READ)  ? MOS_LOCKFLAG_READONLY  : 0;
+        lockFlag |= (flags & VA_MAPBUFFER_FLAG_WRITE) ? MOS_LOCKFLAG_WRITEONLY : 0;
+    }
+
+    return DdiMedia_MapBufferInternal(ctx, buf_id, pbuf, lockFlag);
+}
+#endif
+
 /*
  * After client making changes to a mapped data store, it needs to
  * "Unmap" it to let the server know that the data is ready to be
@@ -3825,10 +3605,9 @@ static VAStatus DdiMedia_SyncSurface (
                     if ((tempNewReport.m_codecStatus == CODECHAL_STATUS_SUCCESSFUL) || (tempNewReport.m_codecStatus == CODECHAL_STATUS_ERROR) || (tempNewReport.m_codecStatus == CODECHAL_STATUS_INCOMPLETE))
                     {
                         DdiMediaUtil_LockMutex(&pMediaCtx->SurfaceMutex);
-                        pMediaSurfaceHeapElmt = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)pMediaCtx->pSurfaceHeap->pHeapBase;
-
-                        for (j = 0; j < pMediaCtx->pSurfaceHeap->uiAllocatedHeapElements; j++, pMediaSurfaceHeapElmt++)
+                        for (j = 0; j < pMediaCtx->pSurfaceHeap->uiAllocatedHeapElements; j++)
                         {
+                            pMediaSurfaceHeapElmt = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pMediaCtx->pSurfaceHeap, j);
                             if (pMediaSurfaceHeapElmt != nullptr && 
                                     pMediaSurfaceHeapElmt->pSurface != nullptr && 
                                     bo == pMediaSurfaceHeapElmt->pSurface->bo)
@@ -4147,7 +3926,7 @@ static VAStatus DdiMedia_PutSurface(
 
     DDI_CHK_LESS((uint32_t)surface, pMediaDrvCtx->pSurfaceHeap->uiAllocatedHeapElements, "Invalid surface", VA_STATUS_ERROR_INVALID_SURFACE);
 
-    if (nullptr != pMediaDrvCtx->pVpCtxHeap->pHeapBase)
+    if (0 != pMediaDrvCtx->pVpCtxHeap->uiAllocatedHeapElements)
     {
         pVpCtx = DdiMedia_GetContextFromContextID(ctx, (VAContextID)(0 + DDI_MEDIA_VACONTEXTID_OFFSET_VP), &uiCtxType);
     }
@@ -4381,9 +4160,9 @@ VAStatus DdiMedia_CreateImage(
         return VA_STATUS_ERROR_MAX_NUM_EXCEEDED;
     }
 
-    pBufferHeapElement->pBuffer   = pBuf;
-    pBufferHeapElement->pCtx      = nullptr;
-    pBufferHeapElement->uiCtxType = DDI_MEDIA_CONTEXT_TYPE_MEDIA;
+    __atomic_store_n(&pBufferHeapElement->pCtx, nullptr, __ATOMIC_RELEASE);
+    __atomic_store_n(&pBufferHeapElement->uiCtxType, DDI_MEDIA_CONTEXT_TYPE_MEDIA, __ATOMIC_RELEASE);
+    __atomic_store_n(&pBufferHeapElement->pBuffer, pBuf, __ATOMIC_RELEASE);
 
     pVAImg->buf                   = pBufferHeapElement->uiVaBufferID;
     pMediaCtx->uiNumBufs++;
@@ -4397,7 +4176,7 @@ VAStatus DdiMedia_CreateImage(
         MOS_FreeMemory(pVAImg);
         return VA_STATUS_ERROR_MAX_NUM_EXCEEDED;
     }
-    pImageHeapElement->pImage     = pVAImg;
+    __atomic_store_n(&pImageHeapElement->pImage, pVAImg, __ATOMIC_RELEASE);
     pMediaCtx->uiNumImages++;
     pVAImg->image_id              = pImageHeapElement->uiVaImageID;
     DdiMediaUtil_UnLockMutex(&pMediaCtx->ImageMutex);
@@ -4450,7 +4229,7 @@ VAStatus DdiMedia_DeriveImage (
         vaStatus = VA_STATUS_ERROR_MAX_NUM_EXCEEDED;
         goto CleanUpandReturn;
     }
-    pImageHeapElement->pImage        = pVAImg;
+    __atomic_store_n(&pImageHeapElement->pImage, pVAImg, __ATOMIC_RELEASE);
     pMediaCtx->uiNumImages++;
     pVAImg->image_id                 = pImageHeapElement->uiVaImageID;
     DdiMediaUtil_UnLockMutex(&pMediaCtx->ImageMutex);
@@ -4628,9 +4407,9 @@ VAStatus DdiMedia_DeriveImage (
         vaStatus = VA_STATUS_ERROR_MAX_NUM_EXCEEDED;
         goto CleanUpandReturn;
     }
-    pBufferHeapElement->pBuffer    = pBuf;
-    pBufferHeapElement->pCtx       = nullptr;
-    pBufferHeapElement->uiCtxType  = DDI_MEDIA_CONTEXT_TYPE_MEDIA;
+    __atomic_store_n(&pBufferHeapElement->pCtx, nullptr, __ATOMIC_RELEASE);
+    __atomic_store_n(&pBufferHeapElement->uiCtxType, DDI_MEDIA_CONTEXT_TYPE_MEDIA, __ATOMIC_RELEASE);
+    __atomic_store_n(&pBufferHeapElement->pBuffer, pBuf, __ATOMIC_RELEASE);
 
     pVAImg->buf             = pBufferHeapElement->uiVaBufferID;
     pMediaCtx->uiNumBufs++;
@@ -4729,7 +4508,6 @@ VAStatus DdiMedia_GetImage(
     VAStatus                      status;
     void                         *pSurfData;
     void                         *pImageData;
-    MOS_STATUS                    eStatus = MOS_STATUS_SUCCESS;
     DDI_UNUSED(x);
     DDI_UNUSED(y);
     DDI_UNUSED(width);
@@ -4768,7 +4546,7 @@ VAStatus DdiMedia_GetImage(
     }
 
     //Lock Surface
-    pSurfData = DdiMediaUtil_LockSurface(pSurface, (MOS_LOCKFLAG_READONLY | MOS_LOCKFLAG_WRITEONLY));
+    pSurfData = DdiMediaUtil_LockSurface(pSurface, MOS_LOCKFLAG_READONLY);
     if (nullptr == pSurfData)
     {
         return VA_STATUS_ERROR_SURFACE_BUSY;
@@ -4783,8 +4561,7 @@ VAStatus DdiMedia_GetImage(
 
     //copy data from surface to image
     //this is temp solution, will copy by difference size and difference format in further
-    eStatus = MOS_SecureMemcpy(pImageData, pVAImg->data_size, pSurfData, pVAImg->data_size);
-    DDI_CHK_CONDITION((eStatus != MOS_STATUS_SUCCESS), "DDI:Failed to copy surface to image buffer data!", VA_STATUS_ERROR_OPERATION_FAILED);
+    MOS_FastMemCopy(pImageData, pSurfData, pVAImg->data_size, MOS_MEMCOPY_SRC_UNCACHED | MOS_MEMCOPY_PARALLEL);
 
     status = DdiMedia_UnmapBuffer(ctx, pVAImg->buf);
     if (status != VA_STATUS_SUCCESS)
@@ -4836,7 +4613,6 @@ VAStatus DdiMedia_PutImage(
     VAStatus                      status;
     void                         *pSurfData;
     void                         *pImageData;
-    MOS_STATUS                    eStatus = MOS_STATUS_SUCCESS;
     DDI_UNUSED(src_x);
     DDI_UNUSED(src_y);
     DDI_UNUSED(src_width);
@@ -4895,8 +4671,7 @@ VAStatus DdiMedia_PutImage(
 
     //copy data from image to surferce
     //this is temp solution, will copy by difference size and difference format in further
-    eStatus = MOS_SecureMemcpy(pSurfData, pVAImg->data_size, pImageData, pVAImg->data_size);
-    DDI_CHK_CONDITION((eStatus != MOS_STATUS_SUCCESS), "DDI:Failed to copy image to surface buffer data!", VA_STATUS_ERROR_OPERATION_FAILED);
+    MOS_FastMemCopy(pSurfData, pImageData, pVAImg->data_size, MOS_MEMCOPY_DST_UNCACHED | MOS_MEMCOPY_PARALLEL);
 
     status = DdiMedia_UnmapBuffer(ctx, pVAImg->buf);
     if (status != VA_STATUS_SUCCESS)
@@ -5659,6 +5434,9 @@ VAStatus __vaDriverInit_0_31(VADriverContextP ctx )
     pVTable->vaCreateBuffer                  = DdiMedia_CreateBuffer;
     pVTable->vaBufferSetNumElements          = DdiMedia_BufferSetNumElements;
     pVTable->vaMapBuffer                     = DdiMedia_MapBuffer;
+#if VA_CHECK_VERSION(1, 21, 0)
+    pVTable->vaMapBuffer2                    = DdiMedia_MapBufferWithFlags;
+#endif
     pVTable->vaUnmapBuffer                   = DdiMedia_UnmapBuffer;
     pVTable->vaDestroyBuffer                 = DdiMedia_DestroyBuffer;
     pVTable->vaBeginPicture                  = DdiMedia_BeginPicture;
@@ -83,9 +83,8 @@
 #define DDI_CODEC_NUM_QUERY_ATTR_VP   9
 
 #define DDI_CODEC_MAX_BITSTREAM_BUFFER        16
-#define DDI_CODEC_MAX_BITSTREAM_BUFFER_MINUS1 (DDI_CODEC_MAX_BITSTREAM_BUFFER - 1)
-#define DDI_CODEC_BITSTREAM_BUFFER_INDEX_BITS 4  //the bitstream buffer index is 4 bits length
-#define DDI_CODEC_MAX_BITSTREAM_BUFFER_INDEX  0xF  // the maximum bitstream buffer index is 0xF
+#define DDI_CODEC_MAX_BITSTREAM_BUFFER_RING   32 // the bitstream ring grows up to this many entries before it waits on the oldest one
+#define DDI_CODEC_BS_SIZE_HISTORY             32 // number of recent frame sizes used to size new bitstream buffers
 #define DDI_CODEC_INVALID_BUFFER_INDEX        -1
 #define DDI_CODEC_VP8_MAX_REF_FRAMES          5
 #define DDI_CODEC_MIN_VALUE_OF_MAX_BS_SIZE    10240
@@ -129,6 +128,7 @@ typedef struct _DDI_CODEC_BITSTREAM_BUFFER_INFO
     PDDI_MEDIA_BUFFER   pMappedGPUBuffer; // the GPU mapping for this buffer.
     bool                bIsUseExtBuf;
     uint8_t            *pSliceBuf;
+    PDDI_MEDIA_BUFFER   pUploadedBuffer; // the slice data buffer if its data was uploaded when it was created, so it can be moved to a larger bitstream buffer.
 } DDI_CODEC_BITSTREAM_BUFFER_INFO;
 
 typedef struct _DDI_CODEC_BUFFER_PARAM_H264
@@ -229,10 +229,13 @@ typedef struct _DDI_CODEC_BUFFER_PARAM_VP9
 typedef struct _DDI_CODEC_COM_BUFFER_MGR
 {
     // bitstream buffer
-    DDI_MEDIA_BUFFER                            *pBitStreamBuffObject[DDI_CODEC_MAX_BITSTREAM_BUFFER];
-    uint8_t                                     *pBitStreamBase[DDI_CODEC_MAX_BITSTREAM_BUFFER];
+    DDI_MEDIA_BUFFER                            *pBitStreamBuffObject[DDI_CODEC_MAX_BITSTREAM_BUFFER_RING];
+    uint8_t                                     *pBitStreamBase[DDI_CODEC_MAX_BITSTREAM_BUFFER_RING];
     uint32_t                                     dwBitstreamIndex;   //indicating which bitstream buffer is used now
-    uint64_t                                     ui64BitstreamOrder; //save  bitstream buffer index used by previous 15 frames and current frame. the MSB is the oldest one, the LSB is current one.
+    uint32_t                                     dwBitstreamFrameTag[DDI_CODEC_MAX_BITSTREAM_BUFFER_RING]; // the frame count when each bitstream buffer was last used, the smallest one is the oldest.
+    uint32_t                                     dwBitstreamFrameCount;
+    uint32_t                                     dwBsSizeHistory[DDI_CODEC_BS_SIZE_HISTORY]; // the bitstream size of recent frames
+    uint32_t                                     dwBsSizeHistoryIndex;
     MOS_RESOURCE                                 resBitstreamBuffer;
     uint8_t                                     *pBitstreamBuffer;
     DDI_CODEC_BITSTREAM_BUFFER_INFO             *pSliceData;
@@ -27,23 +27,21 @@
 #include "media_libva_util.h"
 #include "mos_solo_generic.h"
 
-static void* DdiMedia_GetVaContextFromHeap(PDDI_MEDIA_HEAP  pMediaHeap, uint32_t uiIndex, PMEDIA_MUTEX_T pMutex)
+static void* DdiMedia_GetVaContextFromHeap(PDDI_MEDIA_HEAP  pMediaHeap, uint32_t uiIndex)
 {
     PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT  pVaCtxHeapElmt;
-    void                              *pContext;
 
-    DdiMediaUtil_LockMutex(pMutex);
-    if(nullptr == pMediaHeap || uiIndex >= pMediaHeap->uiAllocatedHeapElements)
+    if(nullptr == pMediaHeap)
+    {
+        return nullptr;
+    }
+    pVaCtxHeapElmt  = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pMediaHeap, uiIndex);
+    if(nullptr == pVaCtxHeapElmt)
     {
-        DdiMediaUtil_UnLockMutex(pMutex);
         return nullptr;
     }
-    pVaCtxHeapElmt  = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)pMediaHeap->pHeapBase;
-    pVaCtxHeapElmt += uiIndex;
-    pContext        = pVaCtxHeapElmt->pVaContext;
-    DdiMediaUtil_UnLockMutex(pMutex);
 
-    return pContext;
+    return __atomic_load_n(&pVaCtxHeapElmt->pVaContext, __ATOMIC_ACQUIRE);
 }
 
 void DdiMedia_MediaSurfaceToMosResource(DDI_MEDIA_SURFACE *pMediaSurface, MOS_RESOURCE  *pMosResource)
@@ -218,33 +216,33 @@ void* DdiMedia_GetContextFromContextID (VADriverContextP ctx, VAContextID vaCtxI
     {
         DDI_VERBOSEMESSAGE("Cenc context detected: 0x%x", vaCtxID);
         *pCtxType = DDI_MEDIA_CONTEXT_TYPE_CENC_DECODER;
-        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pDecoderCtxHeap, uiIndex, &pMediaCtx->DecoderMutex);
+        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pDecoderCtxHeap, uiIndex);
     }
     else if ((vaCtxID&DDI_MEDIA_MASK_VACONTEXT_TYPE) == DDI_MEDIA_VACONTEXTID_OFFSET_DECODER)
     {
         DDI_VERBOSEMESSAGE("Decode context detected: 0x%x", vaCtxID);
         *pCtxType = DDI_MEDIA_CONTEXT_TYPE_DECODER;
-        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pDecoderCtxHeap, uiIndex, &pMediaCtx->DecoderMutex);
+        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pDecoderCtxHeap, uiIndex);
     }
     else if ((vaCtxID&DDI_MEDIA_MASK_VACONTEXT_TYPE) == DDI_MEDIA_VACONTEXTID_OFFSET_ENCODER)
     {
         *pCtxType = DDI_MEDIA_CONTEXT_TYPE_ENCODER;
-        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pEncoderCtxHeap, uiIndex, &pMediaCtx->EncoderMutex);
+        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pEncoderCtxHeap, uiIndex);
     }
     else if ((vaCtxID & DDI_MEDIA_MASK_VACONTEXT_TYPE) == DDI_MEDIA_VACONTEXTID_OFFSET_VP)
     {
         *pCtxType = DDI_MEDIA_CONTEXT_TYPE_VP;
-        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pVpCtxHeap, uiIndex, &pMediaCtx->VpMutex);
+        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pVpCtxHeap, uiIndex);
     }
     else if ((vaCtxID & DDI_MEDIA_MASK_VACONTEXT_TYPE) == DDI_MEDIA_VACONTEXTID_OFFSET_CM)
     {
         *pCtxType = DDI_MEDIA_CONTEXT_TYPE_CM;
-        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pCmCtxHeap, uiIndex, &pMediaCtx->CmMutex);
+        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pCmCtxHeap, uiIndex);
     }
     else if ((vaCtxID & DDI_MEDIA_MASK_VACONTEXT_TYPE) == DDI_MEDIA_VACONTEXTID_OFFSET_MFE)
     {
         *pCtxType = DDI_MEDIA_CONTEXT_TYPE_MFE;
-        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pMfeCtxHeap, uiIndex, &pMediaCtx->MfeMutex);
+        return DdiMedia_GetVaContextFromHeap(pMediaCtx->pMfeCtxHeap, uiIndex);
     }
     else
     {
@@ -262,12 +260,9 @@ DDI_MEDIA_SURFACE* DdiMedia_GetSurfaceFromVASurfaceID (PDDI_MEDIA_CONTEXT pMedia
     PDDI_MEDIA_SURFACE               pSurface;
 
     i                = (uint32_t)surfaceID;
-    DDI_CHK_LESS(i, pMediaCtx->pSurfaceHeap->uiAllocatedHeapElements, "invalid surface id", nullptr);
-    DdiMediaUtil_LockMutex(&pMediaCtx->SurfaceMutex);
-    pSurfaceElement  = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)pMediaCtx->pSurfaceHeap->pHeapBase;
-    pSurfaceElement += i;
-    pSurface         = pSurfaceElement->pSurface;
-    DdiMediaUtil_UnLockMutex(&pMediaCtx->SurfaceMutex);
+    pSurfaceElement  = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pMediaCtx->pSurfaceHeap, i);
+    DDI_CHK_NULL(pSurfaceElement, "invalid surface id", nullptr);
+    pSurface         = __atomic_load_n(&pSurfaceElement->pSurface, __ATOMIC_ACQUIRE);
 
     return pSurface;
 }
@@ -279,12 +274,9 @@ DDI_MEDIA_BUFFER* DdiMedia_GetBufferFromVABufferID (PDDI_MEDIA_CONTEXT pMediaCtx
     PDDI_MEDIA_BUFFER              pBuf;
 
     i                = (uint32_t)bufferID;
-    DDI_CHK_LESS(i, pMediaCtx->pBufferHeap->uiAllocatedHeapElements, "invalid buffer id", nullptr);
-    DdiMediaUtil_LockMutex(&pMediaCtx->BufferMutex);
-    pBufHeapElement  = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)pMediaCtx->pBufferHeap->pHeapBase;
-    pBufHeapElement += i;
-    pBuf             = pBufHeapElement->pBuffer;
-    DdiMediaUtil_UnLockMutex(&pMediaCtx->BufferMutex);
+    pBufHeapElement  = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pMediaCtx->pBufferHeap, i);
+    DDI_CHK_NULL(pBufHeapElement, "invalid buffer id", nullptr);
+    pBuf             = __atomic_load_n(&pBufHeapElement->pBuffer, __ATOMIC_ACQUIRE);
 
     return pBuf;
 }
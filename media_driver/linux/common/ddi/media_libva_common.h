@@ -81,7 +81,8 @@ static int32_t atrace_switch            = 0;
 #define DDI_MEDIA_MAX_INSTANCE_NUMBER          0x0FFFFFFF
 
 // heap
-#define DDI_MEDIA_HEAP_INCREMENTAL_SIZE      8
+#define DDI_MEDIA_HEAP_CHUNK_SIZE            256
+#define DDI_MEDIA_HEAP_MAX_CHUNKS            1024
 
 #define DDI_MEDIA_VACONTEXTID_OFFSET_DECODER       0x10000000
 #define DDI_MEDIA_VACONTEXTID_OFFSET_ENCODER       0x20000000
@@ -230,6 +231,7 @@ typedef struct _DDI_MEDIA_SURFACE
     uint32_t                isTiled;
     uint32_t                TileType;
     uint32_t                bMapped;
+    MOS_MMAP_OPERATION      MmapOperation;       // how pData is mapped, staging modes point pData to a detiled copy
     MOS_LINUX_BO           *bo;
     uint32_t                name;
     uint32_t                surfaceUsageHint;
@@ -282,7 +284,6 @@ typedef struct _DDI_MEDIA_SURFACE_HEAP_ELEMENT
 {
     PDDI_MEDIA_SURFACE                      pSurface;
     uint32_t                                uiVaSurfaceID;
-    struct _DDI_MEDIA_SURFACE_HEAP_ELEMENT *pNextFree;
 }DDI_MEDIA_SURFACE_HEAP_ELEMENT, *PDDI_MEDIA_SURFACE_HEAP_ELEMENT;
 
 typedef struct _DDI_MEDIA_BUFFER_HEAP_ELEMENT
@@ -291,29 +292,32 @@ typedef struct _DDI_MEDIA_BUFFER_HEAP_ELEMENT
     void                                   *pCtx;
     uint32_t                                uiCtxType;
     uint32_t                                uiVaBufferID;
-    struct _DDI_MEDIA_BUFFER_HEAP_ELEMENT  *pNextFree;
 }DDI_MEDIA_BUFFER_HEAP_ELEMENT, *PDDI_MEDIA_BUFFER_HEAP_ELEMENT;
 
 typedef struct _DDI_MEDIA_IMAGE_HEAP_ELEMENT
 {
     VAImage                                *pImage;
     uint32_t                                uiVaImageID;
-    struct _DDI_MEDIA_IMAGE_HEAP_ELEMENT   *pNextFree;
 }DDI_MEDIA_IMAGE_HEAP_ELEMENT, *PDDI_MEDIA_IMAGE_HEAP_ELEMENT;
 
 typedef struct _DDI_MEDIA_VACONTEXT_HEAP_ELEMENT
 {
     void                                       *pVaContext;
     uint32_t                                    uiVaContextID;
-    struct _DDI_MEDIA_VACONTEXT_HEAP_ELEMENT   *pNextFree;
 }DDI_MEDIA_VACONTEXT_HEAP_ELEMENT, *PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT;
 
+//!
+//! \brief Chunked table of heap elements
+//! \details Chunks are never reallocated, so element addresses are stable and
+//!          ID lookups are lock free. Only element allocation and release
+//!          touch the free list, which is a generation tagged lock free stack.
+//!
 typedef struct _DDI_MEDIA_HEAP
 {
-    void               *pHeapBase;
+    void               *pHeapChunks[DDI_MEDIA_HEAP_MAX_CHUNKS];
     uint32_t            uiHeapElementSize;
-    uint32_t            uiAllocatedHeapElements;
-    void               *pFirstFreeHeapElement;
+    uint32_t            uiAllocatedHeapElements;    // published with release semantics once a chunk is installed
+    uint64_t            uiFreeListHead;             // generation tag in high dword, element index + 1 in low dword
 }DDI_MEDIA_HEAP, *PDDI_MEDIA_HEAP;
 
 #ifndef ANDROID
@@ -342,6 +346,7 @@ struct DDI_MEDIA_CONTEXT
     int32_t             fd; 
     int32_t             iDeviceId;
     bool                bIsAtomSOC;
+    bool                bTiledLockStaging;
 
     MEDIA_FEATURE_TABLE SkuTable;
     MEDIA_WA_TABLE      WaTable;
@@ -291,7 +291,7 @@ VAStatus DdiCodec_PutSurfaceLinuxVphalExt(
         return VA_STATUS_ERROR_UNKNOWN;
     }
 
-    pXimg->data = (CHAR*)DdiMediaUtil_LockSurface(pDstSurfBuffObj, (MOS_LOCKFLAG_READONLY | MOS_LOCKFLAG_WRITEONLY));
+    pXimg->data = (CHAR*)DdiMediaUtil_LockSurface(pDstSurfBuffObj, MOS_LOCKFLAG_READONLY);
 
     if (nullptr == pXimg->data) 
     {
@@ -376,7 +376,7 @@ VAStatus DdiCodec_PutSurfaceLinuxHW(
     pitch = pBufferObject->iPitch;
    
     pVpCtx         = nullptr;
-    if (nullptr != pMediaCtx->pVpCtxHeap->pHeapBase)
+    if (0 != pMediaCtx->pVpCtxHeap->uiAllocatedHeapElements)
     {
         pVpCtx = (PDDI_VP_CONTEXT)DdiMedia_GetContextFromContextID(ctx, (VAContextID)(0 + DDI_MEDIA_VACONTEXTID_OFFSET_VP), &uiCtxType);
         DDI_CHK_NULL(pVpCtx, "Null pVpCtx", VA_STATUS_ERROR_INVALID_PARAMETER);
@@ -0,0 +1,573 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file      media_libva_putsurface_sw.cpp
+//! \brief     Software color space conversion and scaling for the X11 putsurface fallback path
+//!
+
+#include <immintrin.h>
+#include "media_libva_putsurface_sw.h"
+#include "media_libva_util.h"
+#include "mos_task_pool.h"
+
+// Sampling positions are kept in 16.16 fixed point, filter weights in 8 bits
+#define DDI_MEDIA_SW_FIX_SHIFT      16
+#define DDI_MEDIA_SW_FIX_HALF       (1 << (DDI_MEDIA_SW_FIX_SHIFT - 1))
+#define DDI_MEDIA_SW_WEIGHT_SHIFT   8
+#define DDI_MEDIA_SW_WEIGHT_ONE     (1 << DDI_MEDIA_SW_WEIGHT_SHIFT)
+
+typedef void (*PFN_DDI_MEDIA_SW_CSC_ROW)(
+    const uint8_t                  *pY,
+    const uint8_t                  *pU,
+    const uint8_t                  *pV,
+    uint32_t                       *pDst,
+    int32_t                         iCount,
+    const DDI_MEDIA_SW_CSC_PARAMS  *pParams);
+
+//!
+//! \brief Horizontal filter taps of one plane for every destination column
+//!
+typedef struct _DDI_MEDIA_SW_HTAPS
+{
+    int32_t    *pOffset0;
+    int32_t    *pOffset1;
+    uint16_t   *pWeight;
+    bool        bIdentity;      // one source sample per destination pixel, no filtering
+} DDI_MEDIA_SW_HTAPS;
+
+typedef struct _DDI_MEDIA_SW_CSC_TASK
+{
+    const DDI_MEDIA_SW_CSC_PARAMS  *pParams;
+    const DDI_MEDIA_SW_HTAPS       *pTaps;
+    PFN_DDI_MEDIA_SW_CSC_ROW        pfnCscRow;
+    int32_t                         iStartRow;
+    int32_t                         iEndRow;
+    VAStatus                        status;
+} DDI_MEDIA_SW_CSC_TASK;
+
+static inline int32_t DdiMediaSw_Clamp(int32_t v)
+{
+    return (v < 0) ? 0 : ((v > 255) ? 255 : v);
+}
+
+static inline uint8_t DdiMediaSw_Lerp(int32_t a, int32_t b, int32_t w)
+{
+    return (uint8_t)((a * (DDI_MEDIA_SW_WEIGHT_ONE - w) + b * w + (DDI_MEDIA_SW_WEIGHT_ONE >> 1)) >> DDI_MEDIA_SW_WEIGHT_SHIFT);
+}
+
+// Reference conversion, same coefficients as the original per pixel path
+static void DdiMediaSw_CscRow_C(
+    const uint8_t                  *pY,
+    const uint8_t                  *pU,
+    const uint8_t                  *pV,
+    uint32_t                       *pDst,
+    int32_t                         iCount,
+    const DDI_MEDIA_SW_CSC_PARAMS  *pParams)
+{
+    for (int32_t i = 0; i < iCount; i++)
+    {
+        int32_t y = pY[i];
+        int32_t u = pU[i] - 128;
+        int32_t v = pV[i] - 128;
+        int32_t r = DdiMediaSw_Clamp(y + ((351 * v) >> 8));
+        int32_t g = DdiMediaSw_Clamp(y - ((179 * v + 86 * u) >> 8));
+        int32_t b = DdiMediaSw_Clamp(y + ((444 * u) >> 8));
+
+        pDst[i] = (((uint32_t)r << pParams->uiRShift) & pParams->uiRMask) |
+                  (((uint32_t)g << pParams->uiGShift) & pParams->uiGMask) |
+                  (((uint32_t)b << pParams->uiBShift) & pParams->uiBMask);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void DdiMediaSw_CscRow_SSE4(
+    const uint8_t                  *pY,
+    const uint8_t                  *pU,
+    const uint8_t                  *pV,
+    uint32_t                       *pDst,
+    int32_t                         iCount,
+    const DDI_MEDIA_SW_CSC_PARAMS  *pParams)
+{
+    const __m128i c128  = _mm_set1_epi32(128);
+    const __m128i cRV   = _mm_set1_epi32(351);
+    const __m128i cGV   = _mm_set1_epi32(179);
+    const __m128i cGU   = _mm_set1_epi32(86);
+    const __m128i cBU   = _mm_set1_epi32(444);
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i max   = _mm_set1_epi32(255);
+    const __m128i rMask = _mm_set1_epi32((int32_t)pParams->uiRMask);
+    const __m128i gMask = _mm_set1_epi32((int32_t)pParams->uiGMask);
+    const __m128i bMask = _mm_set1_epi32((int32_t)pParams->uiBMask);
+    const __m128i rSh   = _mm_cvtsi32_si128((int32_t)pParams->uiRShift);
+    const __m128i gSh   = _mm_cvtsi32_si128((int32_t)pParams->uiGShift);
+    const __m128i bSh   = _mm_cvtsi32_si128((int32_t)pParams->uiBShift);
+    int32_t       i     = 0;
+
+    for (; i + 4 <= iCount; i += 4)
+    {
+        __m128i y = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int32_t *)(pY + i)));
+        __m128i u = _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int32_t *)(pU + i))), c128);
+        __m128i v = _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int32_t *)(pV + i))), c128);
+
+        __m128i r = _mm_add_epi32(y, _mm_srai_epi32(_mm_mullo_epi32(v, cRV), 8));
+        __m128i g = _mm_sub_epi32(y, _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(v, cGV), _mm_mullo_epi32(u, cGU)), 8));
+        __m128i b = _mm_add_epi32(y, _mm_srai_epi32(_mm_mullo_epi32(u, cBU), 8));
+
+        r = _mm_min_epi32(_mm_max_epi32(r, zero), max);
+        g = _mm_min_epi32(_mm_max_epi32(g, zero), max);
+        b = _mm_min_epi32(_mm_max_epi32(b, zero), max);
+
+        __m128i pixel = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(_mm_sll_epi32(r, rSh), rMask), _mm_and_si128(_mm_sll_epi32(g, gSh), gMask)),
+            _mm_and_si128(_mm_sll_epi32(b, bSh), bMask));
+        _mm_storeu_si128((__m128i *)(pDst + i), pixel);
+    }
+
+    DdiMediaSw_CscRow_C(pY + i, pU + i, pV + i, pDst + i, iCount - i, pParams);
+}
+
+__attribute__((target("avx2")))
+static void DdiMediaSw_CscRow_AVX2(
+    const uint8_t                  *pY,
+    const uint8_t                  *pU,
+    const uint8_t                  *pV,
+    uint32_t                       *pDst,
+    int32_t                         iCount,
+    const DDI_MEDIA_SW_CSC_PARAMS  *pParams)
+{
+    const __m256i c128  = _mm256_set1_epi32(128);
+    const __m256i cRV   = _mm256_set1_epi32(351);
+    const __m256i cGV   = _mm256_set1_epi32(179);
+    const __m256i cGU   = _mm256_set1_epi32(86);
+    const __m256i cBU   = _mm256_set1_epi32(444);
+    const __m256i zero  = _mm256_setzero_si256();
+    const __m256i max   = _mm256_set1_epi32(255);
+    const __m256i rMask = _mm256_set1_epi32((int32_t)pParams->uiRMask);
+    const __m256i gMask = _mm256_set1_epi32((int32_t)pParams->uiGMask);
+    const __m256i bMask = _mm256_set1_epi32((int32_t)pParams->uiBMask);
+    const __m128i rSh   = _mm_cvtsi32_si128((int32_t)pParams->uiRShift);
+    const __m128i gSh   = _mm_cvtsi32_si128((int32_t)pParams->uiGShift);
+    const __m128i bSh   = _mm_cvtsi32_si128((int32_t)pParams->uiBShift);
+    int32_t       i     = 0;
+
+    for (; i + 8 <= iCount; i += 8)
+    {
+        __m256i y = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(pY + i)));
+        __m256i u = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(pU + i))), c128);
+        __m256i v = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(pV + i))), c128);
+
+        __m256i r = _mm256_add_epi32(y, _mm256_srai_epi32(_mm256_mullo_epi32(v, cRV), 8));
+        __m256i g = _mm256_sub_epi32(y, _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(v, cGV), _mm256_mullo_epi32(u, cGU)), 8));
+        __m256i b = _mm256_add_epi32(y, _mm256_srai_epi32(_mm256_mullo_epi32(u, cBU), 8));
+
+        r = _mm256_min_epi32(_mm256_max_epi32(r, zero), max);
+        g = _mm256_min_epi32(_mm256_max_epi32(g, zero), max);
+        b = _mm256_min_epi32(_mm256_max_epi32(b, zero), max);
+
+        __m256i pixel = _mm256_or_si256(
+            _mm256_or_si256(_mm256_and_si256(_mm256_sll_epi32(r, rSh), rMask), _mm256_and_si256(_mm256_sll_epi32(g, gSh), gMask)),
+            _mm256_and_si256(_mm256_sll_epi32(b, bSh), bMask));
+        _mm256_storeu_si256((__m256i *)(pDst + i), pixel);
+    }
+
+    DdiMediaSw_CscRow_SSE4(pY + i, pU + i, pV + i, pDst + i, iCount - i, pParams);
+}
+
+static PFN_DDI_MEDIA_SW_CSC_ROW DdiMediaSw_SelectCscRow(bool bForceScalar)
+{
+    if (bForceScalar)
+    {
+        return DdiMediaSw_CscRow_C;
+    }
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return DdiMediaSw_CscRow_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        return DdiMediaSw_CscRow_SSE4;
+    }
+    return DdiMediaSw_CscRow_C;
+}
+
+// Position of the first sample tap in plane coordinates. Chroma is co-sited
+// horizontally and centered vertically, as for MPEG-2/H.264 4:2:0 content.
+static inline int32_t DdiMediaSw_PlanePosition(int64_t lumaPos, uint32_t uiShift, bool bCentered)
+{
+    if (uiShift == 0)
+    {
+        return (int32_t)lumaPos;
+    }
+    if (bCentered)
+    {
+        return (int32_t)(((lumaPos + DDI_MEDIA_SW_FIX_HALF) >> uiShift) - DDI_MEDIA_SW_FIX_HALF);
+    }
+    return (int32_t)(lumaPos >> uiShift);
+}
+
+static inline void DdiMediaSw_GetTaps(int32_t pos, int32_t iSize, int32_t *piTap0, int32_t *piTap1, int32_t *piWeight)
+{
+    int32_t tap = pos >> DDI_MEDIA_SW_FIX_SHIFT;
+
+    if (pos < 0)
+    {
+        *piTap0   = 0;
+        *piTap1   = 0;
+        *piWeight = 0;
+    }
+    else if (tap >= iSize - 1)
+    {
+        *piTap0   = iSize - 1;
+        *piTap1   = iSize - 1;
+        *piWeight = 0;
+    }
+    else
+    {
+        *piTap0   = tap;
+        *piTap1   = tap + 1;
+        *piWeight = (pos >> (DDI_MEDIA_SW_FIX_SHIFT - DDI_MEDIA_SW_WEIGHT_SHIFT)) & (DDI_MEDIA_SW_WEIGHT_ONE - 1);
+    }
+}
+
+static inline int64_t DdiMediaSw_LumaPosition(int32_t iDst, int32_t iSrcStart, int32_t iSrcSize, int32_t iDstSize)
+{
+    int64_t step = ((int64_t)iSrcSize << DDI_MEDIA_SW_FIX_SHIFT) / iDstSize;
+    return ((int64_t)iSrcStart << DDI_MEDIA_SW_FIX_SHIFT) + iDst * step + step / 2 - DDI_MEDIA_SW_FIX_HALF;
+}
+
+static void DdiMediaSw_BuildHorizontalTaps(const DDI_MEDIA_SW_CSC_PARAMS *pParams, uint32_t uiPlane, DDI_MEDIA_SW_HTAPS *pTaps)
+{
+    const DDI_MEDIA_SW_PLANE *pPlane = &pParams->Planes[uiPlane];
+    int32_t planeWidth = (pParams->iPlaneWidth + (1 << pPlane->uiShiftX) - 1) >> pPlane->uiShiftX;
+
+    pTaps->bIdentity = (pParams->iSrcWidth == pParams->iDstWidth) && (pPlane->uiShiftX == 0);
+
+    for (int32_t x = 0; x < pParams->iDstWidth; x++)
+    {
+        int32_t tap0, tap1, weight;
+        int32_t pos = DdiMediaSw_PlanePosition(
+            DdiMediaSw_LumaPosition(x, pParams->iSrcX, pParams->iSrcWidth, pParams->iDstWidth),
+            pPlane->uiShiftX,
+            false);
+
+        DdiMediaSw_GetTaps(pos, planeWidth, &tap0, &tap1, &weight);
+        pTaps->pOffset0[x] = tap0 * pPlane->iStep;
+        pTaps->pOffset1[x] = tap1 * pPlane->iStep;
+        pTaps->pWeight[x]  = (uint16_t)weight;
+    }
+}
+
+static void DdiMediaSw_SampleRow(
+    const DDI_MEDIA_SW_CSC_PARAMS  *pParams,
+    uint32_t                        uiPlane,
+    const DDI_MEDIA_SW_HTAPS       *pTaps,
+    int32_t                         iDstRow,
+    uint8_t                        *pLine)
+{
+    const DDI_MEDIA_SW_PLANE *pPlane = &pParams->Planes[uiPlane];
+    int32_t                   width  = pParams->iDstWidth;
+    int32_t                   planeHeight;
+    int32_t                   row0, row1, weightY;
+    const uint8_t            *pSrc0;
+    const uint8_t            *pSrc1;
+
+    if (nullptr == pPlane->pBase)
+    {
+        memset(pLine, 128, width);
+        return;
+    }
+
+    planeHeight = (pParams->iPlaneHeight + (1 << pPlane->uiShiftY) - 1) >> pPlane->uiShiftY;
+    DdiMediaSw_GetTaps(
+        DdiMediaSw_PlanePosition(
+            DdiMediaSw_LumaPosition(iDstRow, pParams->iSrcY, pParams->iSrcHeight, pParams->iDstHeight),
+            pPlane->uiShiftY,
+            true),
+        planeHeight, &row0, &row1, &weightY);
+
+    pSrc0 = pPlane->pBase + row0 * pPlane->iPitch;
+    pSrc1 = pPlane->pBase + row1 * pPlane->iPitch;
+
+    if (pTaps->bIdentity)
+    {
+        pSrc0 += pTaps->pOffset0[0];
+        pSrc1 += pTaps->pOffset0[0];
+        if (weightY == 0 && pPlane->iStep == 1)
+        {
+            MOS_SecureMemcpy(pLine, width, pSrc0, width);
+        }
+        else if (weightY == 0)
+        {
+            for (int32_t x = 0; x < width; x++)
+            {
+                pLine[x] = pSrc0[x * pPlane->iStep];
+            }
+        }
+        else
+        {
+            for (int32_t x = 0; x < width; x++)
+            {
+                pLine[x] = DdiMediaSw_Lerp(pSrc0[x * pPlane->iStep], pSrc1[x * pPlane->iStep], weightY);
+            }
+        }
+        return;
+    }
+
+    if (weightY == 0)
+    {
+        for (int32_t x = 0; x < width; x++)
+        {
+            pLine[x] = DdiMediaSw_Lerp(pSrc0[pTaps->pOffset0[x]], pSrc0[pTaps->pOffset1[x]], pTaps->pWeight[x]);
+        }
+    }
+    else
+    {
+        for (int32_t x = 0; x < width; x++)
+        {
+            uint8_t top    = DdiMediaSw_Lerp(pSrc0[pTaps->pOffset0[x]], pSrc0[pTaps->pOffset1[x]], pTaps->pWeight[x]);
+            uint8_t bottom = DdiMediaSw_Lerp(pSrc1[pTaps->pOffset0[x]], pSrc1[pTaps->pOffset1[x]], pTaps->pWeight[x]);
+            pLine[x]       = DdiMediaSw_Lerp(top, bottom, weightY);
+        }
+    }
+}
+
+static void DdiMediaSw_ConvertRows(void *pContext, uint32_t index)
+{
+    DDI_MEDIA_SW_CSC_TASK          *pTask   = (DDI_MEDIA_SW_CSC_TASK *)pContext + index;
+    const DDI_MEDIA_SW_CSC_PARAMS  *pParams = pTask->pParams;
+    int32_t                         width   = pParams->iDstWidth;
+    uint8_t                        *pLines;
+
+    pLines = (uint8_t *)MOS_AllocMemory(3 * width);
+    if (nullptr == pLines)
+    {
+        pTask->status = VA_STATUS_ERROR_ALLOCATION_FAILED;
+        return;
+    }
+
+    for (int32_t y = pTask->iStartRow; y < pTask->iEndRow; y++)
+    {
+        for (uint32_t plane = 0; plane < 3; plane++)
+        {
+            DdiMediaSw_SampleRow(pParams, plane, &pTask->pTaps[plane], y, pLines + plane * width);
+        }
+        pTask->pfnCscRow(pLines, pLines + width, pLines + 2 * width,
+            (uint32_t *)(pParams->pDst + y * pParams->iDstPitch), width, pParams);
+    }
+
+    MOS_FreeMemory(pLines);
+    pTask->status = VA_STATUS_SUCCESS;
+}
+
+uint32_t DdiMediaSw_GetSurfaceSize(DDI_MEDIA_FORMAT format, int32_t iPitch, int32_t iHeight)
+{
+    uint32_t lumaSize = (uint32_t)(iPitch * iHeight);
+
+    switch (format)
+    {
+        case Media_Format_422H:
+        case Media_Format_444P:
+        case Media_Format_411P:
+            return lumaSize * 3;
+        case Media_Format_422V:
+        case Media_Format_IMC3:
+            return lumaSize * 2;
+        case Media_Format_NV12:
+        case Media_Format_YV12:
+        case Media_Format_I420:
+        case Media_Format_IYUV:
+            return lumaSize * 3 / 2;
+        case Media_Format_400P:
+        case Media_Format_YUY2:
+        case Media_Format_UYVY:
+            return lumaSize;
+        default:
+            return 0;
+    }
+}
+
+VAStatus DdiMediaSw_SetupPlanes(
+    DDI_MEDIA_FORMAT            format,
+    const uint8_t              *pSurface,
+    int32_t                     iPitch,
+    int32_t                     iHeight,
+    PDDI_MEDIA_SW_CSC_PARAMS    pParams)
+{
+    PDDI_MEDIA_SW_PLANE pY, pU, pV;
+    const uint8_t      *pChroma;
+
+    DDI_CHK_NULL(pSurface, "Null pSurface", VA_STATUS_ERROR_INVALID_PARAMETER);
+    DDI_CHK_NULL(pParams,  "Null pParams",  VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    pY = &pParams->Planes[0];
+    pU = &pParams->Planes[1];
+    pV = &pParams->Planes[2];
+    MOS_ZeroMemory(pParams->Planes, sizeof(pParams->Planes));
+
+    pY->pBase  = pSurface;
+    pY->iPitch = iPitch;
+    pY->iStep  = 1;
+    pU->iPitch = pV->iPitch = iPitch;
+    pU->iStep  = pV->iStep  = 1;
+    pChroma    = pSurface + iPitch * iHeight;
+
+    switch (format)
+    {
+        case Media_Format_444P:
+            pU->pBase    = pChroma;
+            pV->pBase    = pChroma + iPitch * iHeight;
+            break;
+        case Media_Format_422H:
+            pU->pBase    = pChroma;
+            pV->pBase    = pChroma + iPitch * iHeight;
+            pU->uiShiftX = pV->uiShiftX = 1;
+            break;
+        case Media_Format_411P:
+            pU->pBase    = pChroma;
+            pV->pBase    = pChroma + iPitch * iHeight;
+            pU->uiShiftX = pV->uiShiftX = 2;
+            break;
+        case Media_Format_422V:
+            pU->pBase    = pChroma;
+            pV->pBase    = pChroma + iPitch * iHeight / 2;
+            pU->uiShiftY = pV->uiShiftY = 1;
+            break;
+        case Media_Format_IMC3:
+            pU->pBase    = pChroma;
+            pV->pBase    = pChroma + iPitch * iHeight / 2;
+            pU->uiShiftX = pV->uiShiftX = 1;
+            pU->uiShiftY = pV->uiShiftY = 1;
+            break;
+        case Media_Format_NV12:
+            pU->pBase    = pChroma;
+            pV->pBase    = pChroma + 1;
+            pU->iStep    = pV->iStep    = 2;
+            pU->uiShiftX = pV->uiShiftX = 1;
+            pU->uiShiftY = pV->uiShiftY = 1;
+            break;
+        case Media_Format_YV12:
+        case Media_Format_I420:
+        case Media_Format_IYUV:
+            // same plane placement as reported by DdiMedia_DeriveImage
+            if (format == Media_Format_YV12)
+            {
+                pV->pBase = pChroma;
+                pU->pBase = pChroma + iPitch * iHeight / 4;
+            }
+            else
+            {
+                pU->pBase = pChroma + iPitch * iHeight / 4;
+                pV->pBase = pChroma;
+            }
+            pU->iPitch   = pV->iPitch   = iPitch / 2;
+            pU->uiShiftX = pV->uiShiftX = 1;
+            pU->uiShiftY = pV->uiShiftY = 1;
+            break;
+        case Media_Format_YUY2:
+            pY->iStep    = 2;
+            pU->pBase    = pSurface + 1;
+            pV->pBase    = pSurface + 3;
+            pU->iStep    = pV->iStep    = 4;
+            pU->uiShiftX = pV->uiShiftX = 1;
+            break;
+        case Media_Format_UYVY:
+            pY->pBase    = pSurface + 1;
+            pY->iStep    = 2;
+            pU->pBase    = pSurface;
+            pV->pBase    = pSurface + 2;
+            pU->iStep    = pV->iStep    = 4;
+            pU->uiShiftX = pV->uiShiftX = 1;
+            break;
+        case Media_Format_400P:
+            break;
+        default:
+            DDI_ASSERTMESSAGE("Color Format is not supported: %d", format);
+            return VA_STATUS_ERROR_INVALID_VALUE;
+    }
+
+    return VA_STATUS_SUCCESS;
+}
+
+VAStatus DdiMediaSw_ConvertAndScale(const DDI_MEDIA_SW_CSC_PARAMS *pParams)
+{
+    DDI_MEDIA_SW_HTAPS      taps[3];
+    DDI_MEDIA_SW_CSC_TASK   tasks[DDI_MEDIA_SW_CSC_MAX_THREADS];
+    PFN_DDI_MEDIA_SW_CSC_ROW pfnCscRow;
+    uint8_t                *pTapBuffer;
+    int32_t                 width, height;
+    uint32_t                numTasks;
+    VAStatus                vaStatus = VA_STATUS_SUCCESS;
+
+    DDI_CHK_NULL(pParams,       "Null pParams",       VA_STATUS_ERROR_INVALID_PARAMETER);
+    DDI_CHK_NULL(pParams->pDst, "Null pParams->pDst", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    width  = pParams->iDstWidth;
+    height = pParams->iDstHeight;
+    if (width <= 0 || height <= 0 || pParams->iSrcWidth <= 0 || pParams->iSrcHeight <= 0)
+    {
+        return VA_STATUS_SUCCESS;
+    }
+
+    pTapBuffer = (uint8_t *)MOS_AllocMemory(3 * width * (2 * sizeof(int32_t) + sizeof(uint16_t)));
+    DDI_CHK_NULL(pTapBuffer, "Null pTapBuffer", VA_STATUS_ERROR_ALLOCATION_FAILED);
+
+    for (uint32_t plane = 0; plane < 3; plane++)
+    {
+        uint8_t *pPlaneTaps     = pTapBuffer + plane * width * (2 * sizeof(int32_t) + sizeof(uint16_t));
+        taps[plane].pOffset0    = (int32_t *)pPlaneTaps;
+        taps[plane].pOffset1    = taps[plane].pOffset0 + width;
+        taps[plane].pWeight     = (uint16_t *)(taps[plane].pOffset1 + width);
+        DdiMediaSw_BuildHorizontalTaps(pParams, plane, &taps[plane]);
+    }
+
+    pfnCscRow = DdiMediaSw_SelectCscRow(pParams->bForceScalar);
+
+    numTasks = MOS_MIN(MOS_TaskPool_GetThreadCount(), DDI_MEDIA_SW_CSC_MAX_THREADS);
+    numTasks = MOS_MIN(numTasks, (uint32_t)(height / DDI_MEDIA_SW_CSC_MIN_ROWS_PER_TASK));
+    numTasks = MOS_MAX(numTasks, 1);
+
+    for (uint32_t i = 0; i < numTasks; i++)
+    {
+        tasks[i].pParams    = pParams;
+        tasks[i].pTaps      = taps;
+        tasks[i].pfnCscRow  = pfnCscRow;
+        tasks[i].iStartRow  = height * i / numTasks;
+        tasks[i].iEndRow    = height * (i + 1) / numTasks;
+        tasks[i].status     = VA_STATUS_ERROR_UNKNOWN;
+    }
+
+    // Runs every band on this thread when the pool is in use
+    MOS_TaskPool_Run(DdiMediaSw_ConvertRows, tasks, numTasks, numTasks);
+
+    for (uint32_t i = 0; i < numTasks; i++)
+    {
+        if (tasks[i].status != VA_STATUS_SUCCESS)
+        {
+            vaStatus = tasks[i].status;
+        }
+    }
+
+    MOS_FreeMemory(pTapBuffer);
+    return vaStatus;
+}
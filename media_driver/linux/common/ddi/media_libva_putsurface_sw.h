@@ -0,0 +1,124 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file      media_libva_putsurface_sw.h
+//! \brief     Software color space conversion and scaling for the X11 putsurface fallback path
+//!
+#ifndef __MEDIA_LIBVA_PUTSURFACE_SW_H__
+#define __MEDIA_LIBVA_PUTSURFACE_SW_H__
+
+#include "media_libva_common.h"
+
+#define DDI_MEDIA_SW_CSC_MAX_THREADS        8
+#define DDI_MEDIA_SW_CSC_MIN_ROWS_PER_TASK  64
+
+//!
+//! \brief Describes one source plane sampled by the software converter
+//!
+typedef struct _DDI_MEDIA_SW_PLANE
+{
+    const uint8_t   *pBase;         //!< First sample of the plane, nullptr for a constant (grey) plane
+    int32_t          iPitch;        //!< Byte distance between two rows
+    int32_t          iStep;         //!< Byte distance between two horizontally adjacent samples
+    uint32_t         uiShiftX;      //!< log2 of the horizontal subsampling factor
+    uint32_t         uiShiftY;      //!< log2 of the vertical subsampling factor
+} DDI_MEDIA_SW_PLANE, *PDDI_MEDIA_SW_PLANE;
+
+//!
+//! \brief Parameters of a software YUV to packed RGB conversion with bilinear scaling
+//!
+typedef struct _DDI_MEDIA_SW_CSC_PARAMS
+{
+    DDI_MEDIA_SW_PLANE  Planes[3];      //!< Y, U and V planes
+    int32_t             iPlaneWidth;    //!< Luma plane width, used to clamp the filter taps
+    int32_t             iPlaneHeight;   //!< Luma plane height, used to clamp the filter taps
+    int32_t             iSrcX;
+    int32_t             iSrcY;
+    int32_t             iSrcWidth;
+    int32_t             iSrcHeight;
+    uint8_t            *pDst;           //!< 32bpp destination image
+    int32_t             iDstPitch;
+    int32_t             iDstWidth;
+    int32_t             iDstHeight;
+    uint32_t            uiRShift;
+    uint32_t            uiRMask;
+    uint32_t            uiGShift;
+    uint32_t            uiGMask;
+    uint32_t            uiBShift;
+    uint32_t            uiBMask;
+    bool                bForceScalar;   //!< Disable the SIMD kernels, mainly for validation
+} DDI_MEDIA_SW_CSC_PARAMS, *PDDI_MEDIA_SW_CSC_PARAMS;
+
+//!
+//! \brief    Get the size of a linear copy of a surface usable by the software converter
+//!
+//! \param    [in] format
+//!           Media format of the surface
+//! \param    [in] iPitch
+//!           Surface pitch
+//! \param    [in] iHeight
+//!           Surface (luma) height
+//!
+//! \return   uint32_t
+//!           Size in bytes, 0 if the format is not supported
+//!
+uint32_t DdiMediaSw_GetSurfaceSize(DDI_MEDIA_FORMAT format, int32_t iPitch, int32_t iHeight);
+
+//!
+//! \brief    Fill the plane descriptors of the conversion parameters for a surface
+//!
+//! \param    [in] format
+//!           Media format of the surface
+//! \param    [in] pSurface
+//!           Linear copy of the surface
+//! \param    [in] iPitch
+//!           Surface pitch
+//! \param    [in] iHeight
+//!           Surface (luma) height
+//! \param    [out] pParams
+//!           Conversion parameters to fill
+//!
+//! \return   VAStatus
+//!           VA_STATUS_SUCCESS if success, else fail reason
+//!
+VAStatus DdiMediaSw_SetupPlanes(
+    DDI_MEDIA_FORMAT            format,
+    const uint8_t              *pSurface,
+    int32_t                     iPitch,
+    int32_t                     iHeight,
+    PDDI_MEDIA_SW_CSC_PARAMS    pParams);
+
+//!
+//! \brief    Convert the source rectangle to packed RGB and scale it to the destination
+//! \details  Uses the widest SIMD kernel supported by the CPU and splits large
+//!           destinations into row bands processed by the MOS task pool. The result
+//!           is bit exact with the scalar path.
+//!
+//! \param    [in] pParams
+//!           Conversion parameters
+//!
+//! \return   VAStatus
+//!           VA_STATUS_SUCCESS if success, else fail reason
+//!
+VAStatus DdiMediaSw_ConvertAndScale(const DDI_MEDIA_SW_CSC_PARAMS *pParams);
+
+#endif //__MEDIA_LIBVA_PUTSURFACE_SW_H__
@@ -53,6 +53,8 @@
 
 #define DDI_UTIL_CHK_NULL(p) (p == nullptr )
 
+#define DDI_MEDIA_BO_CACHE_CLASSES 4    // BO cache size classes per power of two
+
 #ifdef DEBUG
 static int32_t         g_iFrameCountFps   = -1;
 static struct timeval  g_Tv1;
@@ -982,6 +984,36 @@ VAStatus DdiMediaUtil_CreateBuffer(DDI_MEDIA_BUFFER *pBuffer, MOS_BUFMGR *pBufmg
     return hr;
 }
 
+//!
+//! \brief    Convert the i915 tiling of a surface to the MOS tile type
+//!
+static MOS_TILE_TYPE DdiMediaUtil_GetMosTileType(uint32_t tileType)
+{
+    switch (tileType)
+    {
+        case I915_TILING_X:
+            return MOS_TILE_X;
+        case I915_TILING_Y:
+            return MOS_TILE_Y;
+        case I915_TILING_NONE:
+            return MOS_TILE_LINEAR;
+        default:
+            return MOS_TILE_INVALID;
+    }
+}
+
+//!
+//! \brief    Get the number of bytes of a surface the CPU can access through a lock
+//!
+static uint64_t DdiMediaUtil_GetLockSize(DDI_MEDIA_SURFACE *pSurface)
+{
+    if (pSurface->pGmmResourceInfo)
+    {
+        return GmmResGetRenderSize(pSurface->pGmmResourceInfo);
+    }
+    return pSurface->bo->size;
+}
+
 // add thread protection for multiple thread?
 void* DdiMediaUtil_LockSurface(DDI_MEDIA_SURFACE  *pSurface, uint32_t flag)
 {
@@ -1015,10 +1047,39 @@ void* DdiMediaUtil_LockSurface(DDI_MEDIA_SURFACE  *pSurface, uint32_t flag)
         }
         else
         {
+            pSurface->MmapOperation = MOS_MMAP_OPERATION_NONE;
+            if (pSurface->TileType != I915_TILING_NONE && pSurface->pMediaCtx->bTiledLockStaging)
+            {
+                pSurface->MmapOperation = Mos_Specific_SelectTiledMapOperation(
+                    pSurface->bo,
+                    DdiMediaUtil_GetMosTileType(pSurface->TileType),
+                    pSurface->iPitch,
+                    DdiMediaUtil_GetLockSize(pSurface),
+                    !(flag & MOS_LOCKFLAG_WRITEONLY),
+                    !(flag & MOS_LOCKFLAG_READONLY));
+                if (pSurface->MmapOperation != MOS_MMAP_OPERATION_MMAP_GTT)
+                {
+                    pSurface->pData = Mos_Specific_MapTiledStaging(
+                        pSurface->bo,
+                        DdiMediaUtil_GetMosTileType(pSurface->TileType),
+                        pSurface->iPitch,
+                        DdiMediaUtil_GetLockSize(pSurface));
+                    if (pSurface->pData == nullptr)
+                    {
+                        pSurface->MmapOperation = MOS_MMAP_OPERATION_NONE;
+                    }
+                }
+            }
+
             if (pSurface->TileType == I915_TILING_NONE)
             {
                 mos_bo_map(pSurface->bo, flag & MOS_LOCKFLAG_WRITEONLY);
             }
+            else if (pSurface->MmapOperation == MOS_MMAP_OPERATION_STAGING_READ ||
+                     pSurface->MmapOperation == MOS_MMAP_OPERATION_STAGING_WRITE)
+            {
+                // pData already points to the detiled copy
+            }
             else if (flag & MOS_LOCKFLAG_WRITEONLY)
             {
                 mos_gem_bo_map_gtt(pSurface->bo);
@@ -1029,9 +1090,19 @@ void* DdiMediaUtil_LockSurface(DDI_MEDIA_SURFACE  *pSurface, uint32_t flag)
                 mos_gem_bo_start_gtt_access(pSurface->bo, 0);    // set to GTT domain,0 means readonly
             }
         }
-        pSurface->pData   = (uint8_t*) pSurface->bo->virt;
+
+        if (pSurface->MmapOperation != MOS_MMAP_OPERATION_STAGING_READ &&
+            pSurface->MmapOperation != MOS_MMAP_OPERATION_STAGING_WRITE)
+        {
+            pSurface->pData = (uint8_t*) pSurface->bo->virt;
+        }
         pSurface->bMapped = true;
     }
+    else if ((pSurface->MmapOperation == MOS_MMAP_OPERATION_STAGING_READ) && (flag & MOS_LOCKFLAG_WRITEONLY))
+    {
+        // A nested lock writes the surface, write the copy back at the last unlock
+        pSurface->MmapOperation = MOS_MMAP_OPERATION_STAGING_WRITE;
+    }
     else
     {
         // do nothing here
@@ -1074,7 +1145,18 @@ void DdiMediaUtil_UnlockSurface(DDI_MEDIA_SURFACE  *pSurface)
         }
         else
         {
-            if (pSurface->TileType == I915_TILING_NONE)
+            if (pSurface->MmapOperation == MOS_MMAP_OPERATION_STAGING_READ ||
+                pSurface->MmapOperation == MOS_MMAP_OPERATION_STAGING_WRITE)
+            {
+                Mos_Specific_UnmapTiledStaging(
+                    pSurface->bo,
+                    DdiMediaUtil_GetMosTileType(pSurface->TileType),
+                    pSurface->iPitch,
+                    DdiMediaUtil_GetLockSize(pSurface),
+                    pSurface->pData,
+                    pSurface->MmapOperation);
+            }
+            else if (pSurface->TileType == I915_TILING_NONE)
             {
                mos_bo_unmap(pSurface->bo);
             }
@@ -1082,6 +1164,7 @@ void DdiMediaUtil_UnlockSurface(DDI_MEDIA_SURFACE  *pSurface)
             {
                mos_gem_bo_unmap_gtt(pSurface->bo);
             }
+            pSurface->MmapOperation = MOS_MMAP_OPERATION_NONE;
         }
         pSurface->pData       = nullptr;
         pSurface->bo->virt    = nullptr;
@@ -1142,6 +1225,13 @@ void* DdiMediaUtil_LockBuffer(DDI_MEDIA_BUFFER *pBuf, uint32_t flag)
     }
     else 
     {
+        if ((nullptr != pBuf->pSurface) &&
+            (pBuf->pSurface->MmapOperation == MOS_MMAP_OPERATION_STAGING_READ) &&
+            (flag & MOS_LOCKFLAG_WRITEONLY))
+        {
+            // A nested map writes the derived image, write the copy back at the last unmap
+            pBuf->pSurface->MmapOperation = MOS_MMAP_OPERATION_STAGING_WRITE;
+        }
         pBuf->iRefCount++;
     }
 
@@ -1392,36 +1482,166 @@ void DdiMediaUtil_PostSemaphore(PMEDIA_SEM_T  pSem)
 }
 
 // heap related
-PDDI_MEDIA_SURFACE_HEAP_ELEMENT DdiMediaUtil_AllocPMediaSurfaceFromHeap(PDDI_MEDIA_HEAP pSurfaceHeap)
+//
+// Heap elements live in fixed size chunks which are never moved or freed until the heap is
+// destroyed, so an element address stays valid for the lifetime of the media context. Lookups
+// only need an acquire load of uiAllocatedHeapElements and never take the heap mutex.
+// The free list head packs a generation tag (high 32 bits) with (element index + 1) so that
+// a pop racing with a release cannot be fooled by the same index being recycled (ABA).
+#define DDI_MEDIA_HEAP_FREE_LIST_INDEX(head)     ((uint32_t)((head) & 0xFFFFFFFF))
+#define DDI_MEDIA_HEAP_FREE_LIST_TAG(head)       ((uint32_t)((head) >> 32))
+#define DDI_MEDIA_HEAP_FREE_LIST_HEAD(tag, idx)  ((((uint64_t)(tag)) << 32) | (uint64_t)(idx))
+
+static inline uint32_t *DdiMediaUtil_GetHeapNextFree(void *pChunk, uint32_t uiHeapElementSize, uint32_t uiIndex)
 {
-    PDDI_MEDIA_SURFACE_HEAP_ELEMENT  pSurfaceHeapBase;
-    PDDI_MEDIA_SURFACE_HEAP_ELEMENT  pMediaSurfaceHeapElmt;
-    void                            *pNewHeapBase;
-    int32_t                          i;
+    uint32_t *pNextFree = (uint32_t *)((uint8_t *)pChunk + DDI_MEDIA_HEAP_CHUNK_SIZE * uiHeapElementSize);
+    return &pNextFree[uiIndex % DDI_MEDIA_HEAP_CHUNK_SIZE];
+}
+
+void* DdiMediaUtil_GetHeapElement(PDDI_MEDIA_HEAP pHeap, uint32_t uiIndex)
+{
+    void     *pChunk;
+    uint32_t  uiAllocated;
 
-    if (nullptr == pSurfaceHeap->pFirstFreeHeapElement)
+    DDI_CHK_NULL(pHeap, "nullptr pHeap", nullptr);
+
+    uiAllocated = __atomic_load_n(&pHeap->uiAllocatedHeapElements, __ATOMIC_ACQUIRE);
+    if (uiIndex >= uiAllocated)
+    {
+        return nullptr;
+    }
+
+    pChunk = __atomic_load_n(&pHeap->pHeapChunks[uiIndex / DDI_MEDIA_HEAP_CHUNK_SIZE], __ATOMIC_ACQUIRE);
+    if (nullptr == pChunk)
     {
-        pNewHeapBase = realloc(pSurfaceHeap->pHeapBase, (pSurfaceHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT));
+        return nullptr;
+    }
 
-        if (nullptr == pNewHeapBase)
+    return (uint8_t *)pChunk + (uiIndex % DDI_MEDIA_HEAP_CHUNK_SIZE) * pHeap->uiHeapElementSize;
+}
+
+static void DdiMediaUtil_PushHeapFreeList(PDDI_MEDIA_HEAP pHeap, uint32_t uiFirst, uint32_t uiLast)
+{
+    void     *pChunk;
+    uint32_t *pNextFree;
+    uint64_t  head, newHead;
+
+    pChunk    = __atomic_load_n(&pHeap->pHeapChunks[uiLast / DDI_MEDIA_HEAP_CHUNK_SIZE], __ATOMIC_ACQUIRE);
+    pNextFree = DdiMediaUtil_GetHeapNextFree(pChunk, pHeap->uiHeapElementSize, uiLast);
+
+    head = __atomic_load_n(&pHeap->uiFreeListHead, __ATOMIC_ACQUIRE);
+    do
+    {
+        __atomic_store_n(pNextFree, DDI_MEDIA_HEAP_FREE_LIST_INDEX(head), __ATOMIC_RELAXED);
+        newHead = DDI_MEDIA_HEAP_FREE_LIST_HEAD(DDI_MEDIA_HEAP_FREE_LIST_TAG(head) + 1, uiFirst + 1);
+    } while (!__atomic_compare_exchange_n(&pHeap->uiFreeListHead, &head, newHead, false, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+}
+
+static bool DdiMediaUtil_PopHeapFreeList(PDDI_MEDIA_HEAP pHeap, uint32_t *puiIndex)
+{
+    void     *pChunk;
+    uint32_t  uiIndex, uiNext;
+    uint64_t  head, newHead;
+
+    head = __atomic_load_n(&pHeap->uiFreeListHead, __ATOMIC_ACQUIRE);
+    while (DDI_MEDIA_HEAP_FREE_LIST_INDEX(head) != 0)
+    {
+        uiIndex = DDI_MEDIA_HEAP_FREE_LIST_INDEX(head) - 1;
+        pChunk  = __atomic_load_n(&pHeap->pHeapChunks[uiIndex / DDI_MEDIA_HEAP_CHUNK_SIZE], __ATOMIC_ACQUIRE);
+        uiNext  = __atomic_load_n(DdiMediaUtil_GetHeapNextFree(pChunk, pHeap->uiHeapElementSize, uiIndex), __ATOMIC_RELAXED);
+        newHead = DDI_MEDIA_HEAP_FREE_LIST_HEAD(DDI_MEDIA_HEAP_FREE_LIST_TAG(head) + 1, uiNext);
+        if (__atomic_compare_exchange_n(&pHeap->uiFreeListHead, &head, newHead, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
         {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
+            *puiIndex = uiIndex;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void* DdiMediaUtil_AllocHeapElement(PDDI_MEDIA_HEAP pHeap, uint32_t *puiIndex)
+{
+    void     *pChunk;
+    void     *pExpected;
+    uint32_t  uiChunk;
+    uint32_t  uiFirst;
+
+    while (!DdiMediaUtil_PopHeapFreeList(pHeap, puiIndex))
+    {
+        // Free list is empty, install a new chunk. Concurrent growers race on the chunk slot
+        // and the loser simply retries the free list.
+        uiChunk = __atomic_load_n(&pHeap->uiAllocatedHeapElements, __ATOMIC_ACQUIRE) / DDI_MEDIA_HEAP_CHUNK_SIZE;
+        if (uiChunk >= DDI_MEDIA_HEAP_MAX_CHUNKS)
+        {
+            DDI_ASSERTMESSAGE("DDI: heap exhausted.");
+            return nullptr;
+        }
+
+        pChunk = MOS_AllocAndZeroMemory(DDI_MEDIA_HEAP_CHUNK_SIZE * (pHeap->uiHeapElementSize + sizeof(uint32_t)));
+        if (nullptr == pChunk)
+        {
+            DDI_ASSERTMESSAGE("DDI: chunk allocation failed.");
             return nullptr;
         }
-        pSurfaceHeap->pHeapBase                    = pNewHeapBase;
-        pSurfaceHeapBase                           = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)pSurfaceHeap->pHeapBase;
-        pSurfaceHeap->pFirstFreeHeapElement        = (void*)(&pSurfaceHeapBase[pSurfaceHeap->uiAllocatedHeapElements]);
-        for (i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
+
+        pExpected = nullptr;
+        if (!__atomic_compare_exchange_n(&pHeap->pHeapChunks[uiChunk], &pExpected, pChunk, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        {
+            MOS_FreeMemory(pChunk);
+            continue;
+        }
+
+        uiFirst = uiChunk * DDI_MEDIA_HEAP_CHUNK_SIZE;
+        __atomic_store_n(&pHeap->uiAllocatedHeapElements, uiFirst + DDI_MEDIA_HEAP_CHUNK_SIZE, __ATOMIC_RELEASE);
+
+        // keep the first element for the caller and hand the rest over to the free list
+        for (uint32_t i = 1; i < DDI_MEDIA_HEAP_CHUNK_SIZE - 1; i++)
         {
-            pMediaSurfaceHeapElmt                  = &pSurfaceHeapBase[pSurfaceHeap->uiAllocatedHeapElements + i];
-            pMediaSurfaceHeapElmt->pNextFree       = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &pSurfaceHeapBase[pSurfaceHeap->uiAllocatedHeapElements + i + 1];
-            pMediaSurfaceHeapElmt->uiVaSurfaceID   = pSurfaceHeap->uiAllocatedHeapElements + i;
+            *DdiMediaUtil_GetHeapNextFree(pChunk, pHeap->uiHeapElementSize, i) = uiFirst + i + 2;
         }
-        pSurfaceHeap->uiAllocatedHeapElements     += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
+        DdiMediaUtil_PushHeapFreeList(pHeap, uiFirst + 1, uiFirst + DDI_MEDIA_HEAP_CHUNK_SIZE - 1);
+
+        *puiIndex = uiFirst;
+        break;
     }
 
-    pMediaSurfaceHeapElmt                          = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)pSurfaceHeap->pFirstFreeHeapElement;
-    pSurfaceHeap->pFirstFreeHeapElement            = pMediaSurfaceHeapElmt->pNextFree;
+    return DdiMediaUtil_GetHeapElement(pHeap, *puiIndex);
+}
+
+// Also releases elements whose object was never published, which the typed releases reject
+void DdiMediaUtil_ReleaseHeapElement(PDDI_MEDIA_HEAP pHeap, uint32_t uiIndex)
+{
+    DdiMediaUtil_PushHeapFreeList(pHeap, uiIndex, uiIndex);
+}
+
+void DdiMediaUtil_DestroyHeap(PDDI_MEDIA_HEAP pHeap)
+{
+    if (nullptr == pHeap)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < DDI_MEDIA_HEAP_MAX_CHUNKS; i++)
+    {
+        if (nullptr == pHeap->pHeapChunks[i])
+        {
+            break;
+        }
+        MOS_FreeMemory(pHeap->pHeapChunks[i]);
+        pHeap->pHeapChunks[i] = nullptr;
+    }
+    pHeap->uiAllocatedHeapElements = 0;
+    pHeap->uiFreeListHead          = 0;
+}
+
+PDDI_MEDIA_SURFACE_HEAP_ELEMENT DdiMediaUtil_AllocPMediaSurfaceFromHeap(PDDI_MEDIA_HEAP pSurfaceHeap)
+{
+    PDDI_MEDIA_SURFACE_HEAP_ELEMENT  pMediaSurfaceHeapElmt;
+    uint32_t                         uiIndex;
+
+    pMediaSurfaceHeapElmt = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)DdiMediaUtil_AllocHeapElement(pSurfaceHeap, &uiIndex);
+    DDI_CHK_NULL(pMediaSurfaceHeapElmt, "DDI: surface heap allocation failed.", nullptr);
+    __atomic_store_n(&pMediaSurfaceHeapElmt->uiVaSurfaceID, uiIndex, __ATOMIC_RELEASE);
 
     return pMediaSurfaceHeapElmt;
 }
@@ -1430,151 +1650,72 @@ PDDI_MEDIA_SURFACE_HEAP_ELEMENT DdiMediaUtil_AllocPMediaSurfaceFromHeap(PDDI_MED
 void DdiMediaUtil_ReleasePMediaSurfaceFromHeap(PDDI_MEDIA_HEAP pSurfaceHeap, uint32_t uiVaSurfaceID)
 {
     PDDI_MEDIA_SURFACE_HEAP_ELEMENT  pMediaSurfaceHeapElmt;
-    PDDI_MEDIA_SURFACE_HEAP_ELEMENT  pMediaSurfaceHeapBase;
-    void                            *pFirstFree;
 
-    DDI_CHK_LESS(uiVaSurfaceID, pSurfaceHeap->uiAllocatedHeapElements, "invalid surface id", );
-    pMediaSurfaceHeapBase                   = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)pSurfaceHeap->pHeapBase;
-    pMediaSurfaceHeapElmt                   = &pMediaSurfaceHeapBase[uiVaSurfaceID];
+    pMediaSurfaceHeapElmt = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pSurfaceHeap, uiVaSurfaceID);
+    DDI_CHK_NULL(pMediaSurfaceHeapElmt, "invalid surface id", );
     DDI_CHK_NULL(pMediaSurfaceHeapElmt->pSurface, "surface is already released", );
-    pFirstFree                              = pSurfaceHeap->pFirstFreeHeapElement;
-    pSurfaceHeap->pFirstFreeHeapElement     = (void*)pMediaSurfaceHeapElmt;
-    pMediaSurfaceHeapElmt->pNextFree        = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)pFirstFree;
-    pMediaSurfaceHeapElmt->pSurface         = nullptr;
+    __atomic_store_n(&pMediaSurfaceHeapElmt->pSurface, nullptr, __ATOMIC_RELEASE);
+    DdiMediaUtil_ReleaseHeapElement(pSurfaceHeap, uiVaSurfaceID);
 }
 
 
 PDDI_MEDIA_BUFFER_HEAP_ELEMENT DdiMediaUtil_AllocPMediaBufferFromHeap(PDDI_MEDIA_HEAP pBufferHeap)
 {
-    PDDI_MEDIA_BUFFER_HEAP_ELEMENT  pMediaBufferHeapBase;
     PDDI_MEDIA_BUFFER_HEAP_ELEMENT  pMediaBufferHeapElmt;
-    void                           *pNewHeapBase;
-    int32_t                         i;
+    uint32_t                        uiIndex;
 
-    if (nullptr == pBufferHeap->pFirstFreeHeapElement)
-    {
-        pNewHeapBase = realloc(pBufferHeap->pHeapBase, (pBufferHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_BUFFER_HEAP_ELEMENT));
-        if (nullptr == pNewHeapBase)
-        {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
-            return nullptr;
-        }
-        pBufferHeap->pHeapBase                 = pNewHeapBase;
-        pMediaBufferHeapBase                   = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)pBufferHeap->pHeapBase;
-        pBufferHeap->pFirstFreeHeapElement     = (void*)(&pMediaBufferHeapBase[pBufferHeap->uiAllocatedHeapElements]);
-        for (i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
-        {
-            pMediaBufferHeapElmt               = &pMediaBufferHeapBase[pBufferHeap->uiAllocatedHeapElements + i];
-            pMediaBufferHeapElmt->pNextFree    = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &pMediaBufferHeapBase[pBufferHeap->uiAllocatedHeapElements + i + 1];
-            pMediaBufferHeapElmt->uiVaBufferID = pBufferHeap->uiAllocatedHeapElements + i;
-        }
-        pBufferHeap->uiAllocatedHeapElements  += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
-    }
+    pMediaBufferHeapElmt = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)DdiMediaUtil_AllocHeapElement(pBufferHeap, &uiIndex);
+    DDI_CHK_NULL(pMediaBufferHeapElmt, "DDI: buffer heap allocation failed.", nullptr);
+    __atomic_store_n(&pMediaBufferHeapElmt->uiVaBufferID, uiIndex, __ATOMIC_RELEASE);
 
-    pMediaBufferHeapElmt                       = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)pBufferHeap->pFirstFreeHeapElement;
-    pBufferHeap->pFirstFreeHeapElement         = pMediaBufferHeapElmt->pNextFree;
     return pMediaBufferHeapElmt;
 }
 
 
 void DdiMediaUtil_ReleasePMediaBufferFromHeap(PDDI_MEDIA_HEAP pBufferHeap, uint32_t uiVaBufferID)
 {
-    PDDI_MEDIA_BUFFER_HEAP_ELEMENT   pMediaBufferHeapBase;
     PDDI_MEDIA_BUFFER_HEAP_ELEMENT   pMediaBufferHeapElmt;
-    void                            *pFirstFree;
 
-    DDI_CHK_LESS(uiVaBufferID, pBufferHeap->uiAllocatedHeapElements, "invalid buffer id", );
-    pMediaBufferHeapBase                    = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)pBufferHeap->pHeapBase;
-    pMediaBufferHeapElmt                    = &pMediaBufferHeapBase[uiVaBufferID];
+    pMediaBufferHeapElmt = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pBufferHeap, uiVaBufferID);
+    DDI_CHK_NULL(pMediaBufferHeapElmt, "invalid buffer id", );
     DDI_CHK_NULL(pMediaBufferHeapElmt->pBuffer, "buffer is already released", );
-    pFirstFree                              = pBufferHeap->pFirstFreeHeapElement;
-    pBufferHeap->pFirstFreeHeapElement      = (void*)pMediaBufferHeapElmt;
-    pMediaBufferHeapElmt->pNextFree         = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)pFirstFree;
-    pMediaBufferHeapElmt->pBuffer           = nullptr;
+    __atomic_store_n(&pMediaBufferHeapElmt->pBuffer, nullptr, __ATOMIC_RELEASE);
+    DdiMediaUtil_ReleaseHeapElement(pBufferHeap, uiVaBufferID);
 }
 
 PDDI_MEDIA_IMAGE_HEAP_ELEMENT DdiMediaUtil_AllocPVAImageFromHeap(PDDI_MEDIA_HEAP pImageHeap)
 {
-    PDDI_MEDIA_IMAGE_HEAP_ELEMENT   pVAImageHeapBase;
     PDDI_MEDIA_IMAGE_HEAP_ELEMENT   pVAImageHeapElmt;
-    void                           *pNewHeapBase;
-    int32_t                         i;
+    uint32_t                        uiIndex;
 
-    if (nullptr == pImageHeap->pFirstFreeHeapElement)
-    {
-        pNewHeapBase = realloc(pImageHeap->pHeapBase, (pImageHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_IMAGE_HEAP_ELEMENT));
-
-        if (nullptr == pNewHeapBase)
-        {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
-            return nullptr;
-        }
-        pImageHeap->pHeapBase                  = pNewHeapBase;
-        pVAImageHeapBase                       = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)pImageHeap->pHeapBase;
-        pImageHeap->pFirstFreeHeapElement      = (void*)(&pVAImageHeapBase[pImageHeap->uiAllocatedHeapElements]);
-        for (i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
-        {
-            pVAImageHeapElmt                   = &pVAImageHeapBase[pImageHeap->uiAllocatedHeapElements + i];
-            pVAImageHeapElmt->pNextFree        = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &pVAImageHeapBase[pImageHeap->uiAllocatedHeapElements + i + 1];
-            pVAImageHeapElmt->uiVaImageID      = pImageHeap->uiAllocatedHeapElements + i;
-        }
-        pImageHeap->uiAllocatedHeapElements   += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
+    pVAImageHeapElmt = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)DdiMediaUtil_AllocHeapElement(pImageHeap, &uiIndex);
+    DDI_CHK_NULL(pVAImageHeapElmt, "DDI: image heap allocation failed.", nullptr);
+    __atomic_store_n(&pVAImageHeapElmt->uiVaImageID, uiIndex, __ATOMIC_RELEASE);
 
-    }
-
-    pVAImageHeapElmt                           = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)pImageHeap->pFirstFreeHeapElement;
-    pImageHeap->pFirstFreeHeapElement          = pVAImageHeapElmt->pNextFree;
     return pVAImageHeapElmt;
 }
 
 
 void DdiMediaUtil_ReleasePVAImageFromHeap(PDDI_MEDIA_HEAP pImageHeap, uint32_t uiVAImageID)
 {
-    PDDI_MEDIA_IMAGE_HEAP_ELEMENT    pVAImageHeapBase;
     PDDI_MEDIA_IMAGE_HEAP_ELEMENT    pVAImageHeapElmt;
-    void                            *pFirstFree;
 
-    DDI_CHK_LESS(uiVAImageID, pImageHeap->uiAllocatedHeapElements, "invalid image id", );
-    pVAImageHeapBase                    = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)pImageHeap->pHeapBase;
-    pVAImageHeapElmt                    = &pVAImageHeapBase[uiVAImageID];
+    pVAImageHeapElmt = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pImageHeap, uiVAImageID);
+    DDI_CHK_NULL(pVAImageHeapElmt, "invalid image id", );
     DDI_CHK_NULL(pVAImageHeapElmt->pImage, "image is already released", );
-    pFirstFree                          = pImageHeap->pFirstFreeHeapElement;
-    pImageHeap->pFirstFreeHeapElement   = (void*)pVAImageHeapElmt;
-    pVAImageHeapElmt->pNextFree         = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)pFirstFree;
-    pVAImageHeapElmt->pImage            = nullptr;
+    __atomic_store_n(&pVAImageHeapElmt->pImage, nullptr, __ATOMIC_RELEASE);
+    DdiMediaUtil_ReleaseHeapElement(pImageHeap, uiVAImageID);
 }
 
 PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT DdiMediaUtil_AllocPVAContextFromHeap(PDDI_MEDIA_HEAP pVaContextHeap)
 {
-    PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT   pVAContextHeapBase;
     PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT   pVAContextHeapElmt;
-    void                               *pNewHeapBase;
-    int32_t                                 i;
+    uint32_t                            uiIndex;
 
-    if (nullptr == pVaContextHeap->pFirstFreeHeapElement)
-    {
-        pNewHeapBase = realloc(pVaContextHeap->pHeapBase, (pVaContextHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_VACONTEXT_HEAP_ELEMENT));
+    pVAContextHeapElmt = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)DdiMediaUtil_AllocHeapElement(pVaContextHeap, &uiIndex);
+    DDI_CHK_NULL(pVAContextHeapElmt, "DDI: context heap allocation failed.", nullptr);
+    __atomic_store_n(&pVAContextHeapElmt->uiVaContextID, uiIndex, __ATOMIC_RELEASE);
 
-        if (nullptr == pNewHeapBase)
-        {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
-            return nullptr;
-        }
-        pVaContextHeap->pHeapBase                    = pNewHeapBase;
-        pVAContextHeapBase                           = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)pVaContextHeap->pHeapBase;
-        pVaContextHeap->pFirstFreeHeapElement        = (void*)(&(pVAContextHeapBase[pVaContextHeap->uiAllocatedHeapElements]));
-        for (i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
-        {
-            pVAContextHeapElmt                       = &pVAContextHeapBase[pVaContextHeap->uiAllocatedHeapElements + i];
-            pVAContextHeapElmt->pNextFree            = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &pVAContextHeapBase[pVaContextHeap->uiAllocatedHeapElements + i + 1];
-            pVAContextHeapElmt->uiVaContextID        = pVaContextHeap->uiAllocatedHeapElements + i;
-            pVAContextHeapElmt->pVaContext           = nullptr;
-        }
-        pVaContextHeap->uiAllocatedHeapElements     += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
-    }
-
-    pVAContextHeapElmt                               = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)pVaContextHeap->pFirstFreeHeapElement;
-    pVaContextHeap->pFirstFreeHeapElement            = pVAContextHeapElmt->pNextFree;
     return pVAContextHeapElmt;
 }
 
@@ -1582,17 +1723,12 @@ PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT DdiMediaUtil_AllocPVAContextFromHeap(PDDI_MEDI
 void DdiMediaUtil_ReleasePVAContextFromHeap(PDDI_MEDIA_HEAP pVaContextHeap, uint32_t uiVAContextID)
 {
     PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT    pVAContextHeapElmt;
-    PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT    pVAContextHeapBase;
-    void                                *pFirstFree;
 
-    DDI_CHK_LESS(uiVAContextID, pVaContextHeap->uiAllocatedHeapElements, "invalid context id", );
-    pVAContextHeapBase                      = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)pVaContextHeap->pHeapBase;
-    pVAContextHeapElmt                      = &pVAContextHeapBase[uiVAContextID];
+    pVAContextHeapElmt = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)DdiMediaUtil_GetHeapElement(pVaContextHeap, uiVAContextID);
+    DDI_CHK_NULL(pVAContextHeapElmt, "invalid context id", );
     DDI_CHK_NULL(pVAContextHeapElmt->pVaContext, "context is already released", );
-    pFirstFree                              = pVaContextHeap->pFirstFreeHeapElement;
-    pVaContextHeap->pFirstFreeHeapElement   = (void*)pVAContextHeapElmt;
-    pVAContextHeapElmt->pNextFree           = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)pFirstFree;
-    pVAContextHeapElmt->pVaContext          = nullptr;
+    __atomic_store_n(&pVAContextHeapElmt->pVaContext, nullptr, __ATOMIC_RELEASE);
+    DdiMediaUtil_ReleaseHeapElement(pVaContextHeap, uiVAContextID);
 }
 
 void DdiMediaUtil_UnRefBufObjInMediaBuffer(PDDI_MEDIA_BUFFER pBuf)
@@ -1620,6 +1756,28 @@ void DdiMediaUtil_GetEnabledFeature(PDDI_MEDIA_CONTEXT pMediaCtx)
 
     pMediaCtx->bVC1Enabled = (UserFeatureValue.u32Data == 1) ? true : false;
 
+    MOS_USER_FEATURE_VALUE_DATA UserFeatureData;
+    MOS_ZeroMemory(&UserFeatureData, sizeof(UserFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_TILED_LOCK_STAGING_ENABLE_ID,
+        &UserFeatureData);
+    pMediaCtx->bTiledLockStaging = (UserFeatureData.i32Data) ? true : false;
+
+    MOS_ZeroMemory(&UserFeatureData, sizeof(UserFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_BO_CACHE_MAX_SIZE_ID,
+        &UserFeatureData);
+    mos_bufmgr_gem_set_cache_classes(pMediaCtx->pDrmBufMgr, (uint64_t)UserFeatureData.u32Data << 20, DDI_MEDIA_BO_CACHE_CLASSES);
+
+    MOS_ZeroMemory(&UserFeatureData, sizeof(UserFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_BO_CACHE_BUDGET_ID,
+        &UserFeatureData);
+    mos_bufmgr_gem_set_cache_budget(pMediaCtx->pDrmBufMgr, (uint64_t)UserFeatureData.u32Data << 20);
+
 #ifdef ANDROID
     pMediaCtx->bVC1Enabled = false;
 #endif
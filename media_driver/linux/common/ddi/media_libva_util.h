@@ -60,6 +60,10 @@ VAStatus DdiMediaUtil_ConvertBufImageToSurface(DDI_MEDIA_BUFFER *pBuf, VAImage *
 VAStatus DdiMediaUtil_FillPositionToRect(RECT *rect, int16_t offset_x, int16_t offset_y, int16_t width, int16_t height);
 bool     DdiMediaUtil_IsExternalSurface(PDDI_MEDIA_SURFACE pSurface);
 
+void*    DdiMediaUtil_GetHeapElement(PDDI_MEDIA_HEAP pHeap, uint32_t uiIndex);
+void     DdiMediaUtil_ReleaseHeapElement(PDDI_MEDIA_HEAP pHeap, uint32_t uiIndex);
+void     DdiMediaUtil_DestroyHeap(PDDI_MEDIA_HEAP pHeap);
+
 PDDI_MEDIA_SURFACE_HEAP_ELEMENT DdiMediaUtil_AllocPMediaSurfaceFromHeap(PDDI_MEDIA_HEAP pSurfaceHeap);
 void     DdiMediaUtil_ReleasePMediaSurfaceFromHeap(PDDI_MEDIA_HEAP pSurfaceHeap, uint32_t uiVaSurfaceID);
 
@@ -41,11 +41,13 @@ if(NOT ${PLATFORM} STREQUAL "android")
  set(TMP_SOURCES_
     ${TMP_SOURCES_}
     ${CMAKE_CURRENT_LIST_DIR}/media_libva_putsurface_linux.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/media_libva_putsurface_sw.cpp
 )
 
 set(TMP_HEADERS_
     ${TMP_HEADERS_}
     ${CMAKE_CURRENT_LIST_DIR}/media_libva_putsurface_linux.h
+    ${CMAKE_CURRENT_LIST_DIR}/media_libva_putsurface_sw.h
 )
 endif()
 
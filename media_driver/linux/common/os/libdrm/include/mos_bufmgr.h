@@ -51,6 +51,20 @@ typedef struct mos_bufmgr MOS_BUFMGR;
 typedef struct drm_i915_cmd_descriptor cmd_descriptor;
 #endif
 
+/**
+ * Counters of the CPU mapping related work done by the buffer manager.
+ */
+struct mos_bufmgr_map_stats {
+	uint64_t mmap_ioctls;		/* DRM_IOCTL_I915_GEM_MMAP */
+	uint64_t set_domain_ioctls;	/* DRM_IOCTL_I915_GEM_SET_DOMAIN from bo_map */
+	uint64_t sw_finish_ioctls;	/* DRM_IOCTL_I915_GEM_SW_FINISH from bo_unmap */
+	uint64_t munmaps;		/* CPU mappings released */
+	uint64_t persistent_hits;	/* Locks served by an existing persistent mapping */
+	uint64_t persistent_evictions;	/* Persistent mappings dropped by the LRU */
+	uint64_t busy_checks;		/* Busy ioctls done instead of a set-domain */
+	uint64_t busy_waits;		/* Busy checks which had to wait for the GPU */
+};
+
 #ifndef ANDROID
 #include "mos_os_specific.h"
 #endif
@@ -254,6 +268,18 @@ void mos_bufmgr_gem_enable_reuse(struct mos_bufmgr *bufmgr);
 void mos_bufmgr_gem_enable_fenced_relocs(struct mos_bufmgr *bufmgr);
 void mos_bufmgr_gem_set_vma_cache_size(struct mos_bufmgr *bufmgr,
 					     int limit);
+void mos_bufmgr_gem_enable_persistent_mapping(struct mos_bufmgr *bufmgr,
+					      uint64_t max_size);
+void mos_bufmgr_gem_get_map_stats(struct mos_bufmgr *bufmgr,
+				  struct mos_bufmgr_map_stats *stats);
+int mos_bufmgr_gem_set_cache_classes(struct mos_bufmgr *bufmgr,
+				     uint64_t max_size, int classes);
+void mos_bufmgr_gem_set_cache_budget(struct mos_bufmgr *bufmgr,
+				     uint64_t budget);
+int mos_gem_bo_map_persistent(struct mos_linux_bo *bo, int write_enable,
+			      int sync, void **virt);
+void mos_gem_bo_unmap_persistent(struct mos_linux_bo *bo);
+
 int mos_gem_bo_map_unsynchronized(struct mos_linux_bo *bo);
 int mos_gem_bo_map_gtt(struct mos_linux_bo *bo);
 int mos_gem_bo_unmap_gtt(struct mos_linux_bo *bo);
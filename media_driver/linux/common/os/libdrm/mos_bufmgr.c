@@ -112,6 +112,41 @@ struct mos_gem_bo_bucket {
 	unsigned long size;
 };
 
+/*
+ * The BO cache has three buckets of 4, 8 and 12KB, then a group of size
+ * classes per power of two from 16KB up to the largest cached size.
+ */
+#define MOS_GEM_BO_SMALL_BUCKETS	3
+#define MOS_GEM_BO_FIRST_ORDER		14
+#define MOS_GEM_BO_CLASSES_DEFAULT	4
+#define MOS_GEM_BO_CLASSES_MAX		8
+#define MOS_GEM_BO_CACHE_MAX_DEFAULT	(64ul * 1024 * 1024)
+#define MOS_GEM_BO_CACHE_MAX_LIMIT	(1ul << 32)
+#define MOS_GEM_BO_BUCKETS_MAX		(MOS_GEM_BO_SMALL_BUCKETS + \
+					 (32 - MOS_GEM_BO_FIRST_ORDER + 1) * \
+					 MOS_GEM_BO_CLASSES_MAX)
+
+/*
+ * Small BOs freed without any relocation are first kept in a front cache
+ * chosen per thread, which avoids the bufmgr lock and the madvise ioctls.
+ * Threads are spread round robin over the front caches. Front cached BOs
+ * count in the cache budget and are aged as the other cached BOs.
+ */
+#define MOS_GEM_FRONT_CACHE_COUNT	8
+#define MOS_GEM_FRONT_CACHE_SLOTS	8
+#define MOS_GEM_FRONT_CACHE_MAX_SIZE	(512 * 1024)
+
+struct mos_bo_gem;
+
+struct mos_gem_front_cache {
+	pthread_mutex_t lock;
+	struct mos_bo_gem *bo[MOS_GEM_FRONT_CACHE_SLOTS];	/* Oldest first */
+	int count;
+} __attribute__((aligned(64)));
+
+static __thread int mos_gem_front_cache_index = -1;
+static int mos_gem_front_cache_next;
+
 struct mos_bufmgr_gem {
 	struct mos_bufmgr bufmgr;
 
@@ -129,17 +164,33 @@ struct mos_bufmgr_gem {
 	int exec_size;
 	int exec_count;
 
-	/** Array of lists of cached gem objects of power-of-two sizes */
-	struct mos_gem_bo_bucket cache_bucket[14 * 4];
+	/** Array of lists of cached gem objects, one per size class */
+	struct mos_gem_bo_bucket cache_bucket[MOS_GEM_BO_BUCKETS_MAX];
 	int num_buckets;
+	int cache_classes;
 	time_t time;
 
+	/** Cached objects of all the buckets, least recently freed first */
+	drmMMListHead cache_lru;
+	/** Size of the cached objects, trimmed down to the budget if set */
+	uint64_t cache_size, cache_budget;
+	/** Size of the objects in the front caches, updated atomically */
+	uint64_t front_size;
+
+	struct mos_gem_front_cache front_cache[MOS_GEM_FRONT_CACHE_COUNT];
+
 	drmMMListHead managers;
 
 	drmMMListHead named;
 	drmMMListHead vma_cache;
 	int vma_count, vma_open, vma_max;
 
+	/** LRU of the persistently mapped buffers, least recently locked first */
+	drmMMListHead persistent_lru;
+	uint64_t persistent_size, persistent_max;
+
+	struct mos_bufmgr_map_stats map_stats;
+
 	uint64_t gtt_size;
 	int available_fences;
 	int pci_device;
@@ -235,6 +286,8 @@ struct mos_bo_gem {
 
 	/** BO cache list */
 	drmMMListHead head;
+	/** Position in the LRU of all the cached BOs */
+	drmMMListHead lru_list;
 
 	/**
 	 * Boolean of whether this BO and its children have been included in
@@ -303,6 +356,16 @@ struct mos_bo_gem {
 
 	/** Flags that we may need to do the SW_FINSIH ioctl on unmap. */
 	bool mapped_cpu_write;
+
+	/**
+	 * Whether the CPU mapping is kept across locks, see
+	 * mos_gem_bo_map_persistent(). A persistent mapping holds one
+	 * map_count reference and is linked in bufmgr_gem->persistent_lru.
+	 */
+	bool persistent_mapped;
+	/** Number of outstanding locks on the persistent mapping */
+	int persistent_pins;
+	drmMMListHead persistent_list;
 #ifdef ANDROID
 	uint32_t aub_offset;
 
@@ -429,17 +492,28 @@ static struct mos_gem_bo_bucket *
 mos_gem_bo_bucket_for_size(struct mos_bufmgr_gem *bufmgr_gem,
 				 unsigned long size)
 {
-	int i;
+	unsigned long base, step;
+	int order, index;
 
-	for (i = 0; i < bufmgr_gem->num_buckets; i++) {
-		struct mos_gem_bo_bucket *bucket =
-		    &bufmgr_gem->cache_bucket[i];
-		if (bucket->size >= size) {
-			return bucket;
-		}
+	/* The bucket index is computed from the size, see init_cache_buckets */
+	if (size <= 4096 * MOS_GEM_BO_SMALL_BUCKETS) {
+		index = size ? (size - 1) / 4096 : 0;
+	} else if (size <= (1ul << MOS_GEM_BO_FIRST_ORDER)) {
+		index = MOS_GEM_BO_SMALL_BUCKETS;
+	} else {
+		/* base < size <= 2 * base, in classes of base / classes bytes */
+		order = 63 - __builtin_clzl(size - 1);
+		base = 1ul << order;
+		step = base / bufmgr_gem->cache_classes;
+		index = MOS_GEM_BO_SMALL_BUCKETS +
+			(order - MOS_GEM_BO_FIRST_ORDER) * bufmgr_gem->cache_classes +
+			(size - base + step - 1) / step;
 	}
 
-	return nullptr;
+	if (index >= bufmgr_gem->num_buckets)
+		return nullptr;
+
+	return &bufmgr_gem->cache_bucket[index];
 }
 
 static void
@@ -766,6 +840,74 @@ mos_gem_bo_madvise(struct mos_linux_bo *bo, int madv)
 		 madv);
 }
 
+static void
+mos_gem_bo_cache_add(struct mos_bufmgr_gem *bufmgr_gem,
+		     struct mos_gem_bo_bucket *bucket,
+		     struct mos_bo_gem *bo_gem)
+{
+	DRMLISTADDTAIL(&bo_gem->head, &bucket->head);
+	DRMLISTADDTAIL(&bo_gem->lru_list, &bufmgr_gem->cache_lru);
+	bufmgr_gem->cache_size += bo_gem->bo.size;
+}
+
+static void
+mos_gem_bo_cache_remove(struct mos_bufmgr_gem *bufmgr_gem,
+			struct mos_bo_gem *bo_gem)
+{
+	DRMLISTDEL(&bo_gem->head);
+	DRMLISTDEL(&bo_gem->lru_list);
+	bufmgr_gem->cache_size -= bo_gem->bo.size;
+}
+
+/* Frees the least recently cached objects until the cache fits in size */
+static void
+mos_gem_bo_cache_trim(struct mos_bufmgr_gem *bufmgr_gem, uint64_t size)
+{
+	while (bufmgr_gem->cache_size > size) {
+		struct mos_bo_gem *bo_gem;
+
+		bo_gem = DRMLISTENTRY(struct mos_bo_gem,
+				      bufmgr_gem->cache_lru.next, lru_list);
+		mos_gem_bo_cache_remove(bufmgr_gem, bo_gem);
+		mos_gem_bo_free(&bo_gem->bo);
+	}
+}
+
+/**
+ * Frees the objects of the front caches freed before @time, all of them
+ * if @time is 0. Called with the bufmgr lock held.
+ */
+static void
+mos_gem_front_cache_age(struct mos_bufmgr_gem *bufmgr_gem, time_t time)
+{
+	int i, j, n;
+
+	for (i = 0; i < MOS_GEM_FRONT_CACHE_COUNT; i++) {
+		struct mos_gem_front_cache *front = &bufmgr_gem->front_cache[i];
+
+		pthread_mutex_lock(&front->lock);
+		for (n = 0; n < front->count; n++) {
+			if (time && time - front->bo[n]->free_time <= 1)
+				break;
+		}
+		for (j = 0; j < n; j++) {
+			__sync_fetch_and_sub(&bufmgr_gem->front_size,
+					     front->bo[j]->bo.size);
+			mos_gem_bo_free(&front->bo[j]->bo);
+		}
+		front->count -= n;
+		memmove(&front->bo[0], &front->bo[n],
+			front->count * sizeof(front->bo[0]));
+		pthread_mutex_unlock(&front->lock);
+	}
+}
+
+static void
+mos_gem_front_cache_drain(struct mos_bufmgr_gem *bufmgr_gem)
+{
+	mos_gem_front_cache_age(bufmgr_gem, 0);
+}
+
 /* drop the oldest entries that have been purged by the kernel */
 static void
 mos_gem_bo_cache_purge_bucket(struct mos_bufmgr_gem *bufmgr_gem,
@@ -780,11 +922,144 @@ mos_gem_bo_cache_purge_bucket(struct mos_bufmgr_gem *bufmgr_gem,
 		    (bufmgr_gem, bo_gem, I915_MADV_DONTNEED))
 			break;
 
-		DRMLISTDEL(&bo_gem->head);
+		mos_gem_bo_cache_remove(bufmgr_gem, bo_gem);
 		mos_gem_bo_free(&bo_gem->bo);
 	}
+
+	/* The kernel only reclaims cached objects when memory runs low, give
+	 * back half of the cache and the front caches that it cannot reclaim.
+	 */
+	mos_gem_bo_cache_trim(bufmgr_gem, bufmgr_gem->cache_size / 2);
+	mos_gem_front_cache_drain(bufmgr_gem);
+}
+
+#ifndef ANDROID
+static struct mos_gem_front_cache *
+mos_gem_front_cache_get(struct mos_bufmgr_gem *bufmgr_gem)
+{
+	if (mos_gem_front_cache_index < 0)
+		mos_gem_front_cache_index =
+			__sync_fetch_and_add(&mos_gem_front_cache_next, 1) &
+			(MOS_GEM_FRONT_CACHE_COUNT - 1);
+
+	return &bufmgr_gem->front_cache[mos_gem_front_cache_index];
+}
+
+/**
+ * Keeps a buffer released by its last user in the front cache of the
+ * thread. Only buffers which nothing else can reach are taken: not named,
+ * not mapped and without relocations, so that no bufmgr state changes.
+ */
+static bool
+mos_gem_front_cache_put(struct mos_bufmgr_gem *bufmgr_gem,
+			struct mos_bo_gem *bo_gem, time_t time)
+{
+	struct mos_gem_front_cache *front;
+	struct mos_gem_bo_bucket *bucket;
+
+	if (!bufmgr_gem->bo_reuse || !bo_gem->reusable ||
+	    bo_gem->global_name || bo_gem->reloc_count ||
+	    bo_gem->softpin_target_count || bo_gem->map_count ||
+	    bo_gem->persistent_mapped ||
+	    bo_gem->bo.size > MOS_GEM_FRONT_CACHE_MAX_SIZE)
+		return false;
+
+	if (bufmgr_gem->cache_budget &&
+	    bufmgr_gem->front_size + bo_gem->bo.size > bufmgr_gem->cache_budget)
+		return false;
+
+	bucket = mos_gem_bo_bucket_for_size(bufmgr_gem, bo_gem->bo.size);
+	if (bucket == nullptr || bucket->size != bo_gem->bo.size)
+		return false;
+
+	front = mos_gem_front_cache_get(bufmgr_gem);
+	pthread_mutex_lock(&front->lock);
+	if (front->count == MOS_GEM_FRONT_CACHE_SLOTS) {
+		pthread_mutex_unlock(&front->lock);
+		return false;
+	}
+
+	atomic_set(&bo_gem->refcount, 0);
+	bo_gem->name = nullptr;
+	bo_gem->validate_index = -1;
+	bo_gem->used_as_reloc_target = false;
+	bo_gem->free_time = time;
+	front->bo[front->count++] = bo_gem;
+	pthread_mutex_unlock(&front->lock);
+
+	__sync_fetch_and_add(&bufmgr_gem->front_size, bo_gem->bo.size);
+
+	return true;
 }
 
+/**
+ * Takes a buffer of the given size out of the front cache of the thread.
+ * As for the shared cache, render targets reuse the most recently freed
+ * buffer and other buffers the oldest one if idle. The busy check is done
+ * without the front cache lock, a busy buffer is put back as the oldest.
+ */
+static struct mos_bo_gem *
+mos_gem_front_cache_take(struct mos_bufmgr_gem *bufmgr_gem,
+			 unsigned long size, bool for_render)
+{
+	struct mos_gem_front_cache *front = mos_gem_front_cache_get(bufmgr_gem);
+	struct mos_bo_gem *bo_gem = nullptr;
+	int i;
+
+	pthread_mutex_lock(&front->lock);
+	if (for_render) {
+		for (i = front->count - 1; i >= 0; i--) {
+			if (front->bo[i]->bo.size == size)
+				break;
+		}
+	} else {
+		for (i = 0; i < front->count; i++) {
+			if (front->bo[i]->bo.size == size)
+				break;
+		}
+		if (i == front->count)
+			i = -1;
+	}
+	if (i >= 0) {
+		bo_gem = front->bo[i];
+		front->count--;
+		memmove(&front->bo[i], &front->bo[i + 1],
+			(front->count - i) * sizeof(front->bo[0]));
+	}
+	pthread_mutex_unlock(&front->lock);
+
+	if (bo_gem == nullptr)
+		return nullptr;
+
+	if (!for_render && mos_gem_bo_busy(&bo_gem->bo)) {
+		pthread_mutex_lock(&front->lock);
+		if (front->count < MOS_GEM_FRONT_CACHE_SLOTS) {
+			memmove(&front->bo[1], &front->bo[0],
+				front->count * sizeof(front->bo[0]));
+			front->bo[0] = bo_gem;
+			front->count++;
+			bo_gem = nullptr;
+		}
+		pthread_mutex_unlock(&front->lock);
+
+		/* Refilled by the thread meanwhile */
+		if (bo_gem != nullptr) {
+			__sync_fetch_and_sub(&bufmgr_gem->front_size,
+					     bo_gem->bo.size);
+			pthread_mutex_lock(&bufmgr_gem->lock);
+			mos_gem_bo_free(&bo_gem->bo);
+			pthread_mutex_unlock(&bufmgr_gem->lock);
+		}
+
+		return nullptr;
+	}
+
+	__sync_fetch_and_sub(&bufmgr_gem->front_size, bo_gem->bo.size);
+
+	return bo_gem;
+}
+#endif
+
 #ifdef ANDROID
 static void
 mos_gem_empty_bo_cache(struct mos_bufmgr_gem *bufmgr_gem)
@@ -803,7 +1078,7 @@ mos_gem_empty_bo_cache(struct mos_bufmgr_gem *bufmgr_gem)
 			bo_gem = DRMLISTENTRY(struct mos_bo_gem,
 					      bucket->head.next, head);
 
-			DRMLISTDEL(&bo_gem->head);
+			mos_gem_bo_cache_remove(bufmgr_gem, bo_gem);
 			mos_gem_bo_free(&bo_gem->bo);
 		}
 	}
@@ -848,6 +1123,27 @@ mos_gem_bo_alloc_internal(struct mos_bufmgr *bufmgr,
 		bo_size = bucket->size;
 	}
 
+	/* Small objects are first looked up in the front cache of the thread,
+	 * they are kept there without madvise so only the tiling may change.
+	 */
+	if (bucket != nullptr && bufmgr_gem->bo_reuse &&
+	    bo_size <= MOS_GEM_FRONT_CACHE_MAX_SIZE) {
+		bo_gem = mos_gem_front_cache_take(bufmgr_gem, bo_size,
+						  for_render);
+		if (bo_gem != nullptr) {
+			if (for_render)
+				bo_gem->bo.align = alignment;
+			if (mos_gem_bo_set_tiling_internal(&bo_gem->bo,
+							   tiling_mode,
+							   stride) == 0)
+				goto init;
+
+			pthread_mutex_lock(&bufmgr_gem->lock);
+			mos_gem_bo_free(&bo_gem->bo);
+			pthread_mutex_unlock(&bufmgr_gem->lock);
+		}
+	}
+
 	pthread_mutex_lock(&bufmgr_gem->lock);
 	/* Get a buffer out of the cache if available */
 retry:
@@ -860,7 +1156,7 @@ retry:
 			 */
 			bo_gem = DRMLISTENTRY(struct mos_bo_gem,
 					      bucket->head.prev, head);
-			DRMLISTDEL(&bo_gem->head);
+			mos_gem_bo_cache_remove(bufmgr_gem, bo_gem);
 			alloc_from_cache = true;
 			bo_gem->bo.align = alignment;
 		} else {
@@ -876,7 +1172,7 @@ retry:
 					      bucket->head.next, head);
 			if (!mos_gem_bo_busy(&bo_gem->bo)) {
 				alloc_from_cache = true;
-				DRMLISTDEL(&bo_gem->head);
+				mos_gem_bo_cache_remove(bufmgr_gem, bo_gem);
 			}
 		}
 
@@ -939,6 +1235,7 @@ retry:
 		}
 	}
 
+init:
 	bo_gem->name = name;
 	atomic_set(&bo_gem->refcount, 1);
 	bo_gem->validate_index = -1;
@@ -1007,7 +1304,7 @@ retry:
 					entry, head);
 
 			    if (bo_gem->bo.size >= size) {
-					DRMLISTDEL(&bo_gem->head);
+					mos_gem_bo_cache_remove(bufmgr_gem, bo_gem);
 					alloc_from_cache = true;
 					break;
 			    }
@@ -1027,7 +1324,7 @@ retry:
 
 			    if ((bo_gem->bo.size >= size) &&
 				!mos_gem_bo_busy(&bo_gem->bo)) {
-					DRMLISTDEL(&bo_gem->head);
+					mos_gem_bo_cache_remove(bufmgr_gem, bo_gem);
 					alloc_from_cache = true;
 					break;
 			    }
@@ -1655,33 +1952,39 @@ mos_gem_bo_mark_mmaps_incoherent(struct mos_linux_bo *bo)
 #endif
 }
 
-/** Frees all cached buffers significantly older than @time. */
+/**
+ * Frees cached buffers beyond the cache budget, then all the cached buffers
+ * significantly older than @time.
+ */
 static void
 mos_gem_cleanup_bo_cache(struct mos_bufmgr_gem *bufmgr_gem, time_t time)
 {
-	int i;
+	if (bufmgr_gem->cache_budget) {
+		uint64_t front_size = bufmgr_gem->front_size;
+
+		mos_gem_bo_cache_trim(bufmgr_gem,
+				      bufmgr_gem->cache_budget > front_size ?
+				      bufmgr_gem->cache_budget - front_size : 0);
+	}
 
 	if (bufmgr_gem->time == time)
 		return;
 
-	for (i = 0; i < bufmgr_gem->num_buckets; i++) {
-		struct mos_gem_bo_bucket *bucket =
-		    &bufmgr_gem->cache_bucket[i];
-
-		while (!DRMLISTEMPTY(&bucket->head)) {
-			struct mos_bo_gem *bo_gem;
-
-			bo_gem = DRMLISTENTRY(struct mos_bo_gem,
-					      bucket->head.next, head);
-			if (time - bo_gem->free_time <= 1)
-				break;
+	/* The LRU is ordered by free time */
+	while (!DRMLISTEMPTY(&bufmgr_gem->cache_lru)) {
+		struct mos_bo_gem *bo_gem;
 
-			DRMLISTDEL(&bo_gem->head);
+		bo_gem = DRMLISTENTRY(struct mos_bo_gem,
+				      bufmgr_gem->cache_lru.next, lru_list);
+		if (time - bo_gem->free_time <= 1)
+			break;
 
-			mos_gem_bo_free(&bo_gem->bo);
-		}
+		mos_gem_bo_cache_remove(bufmgr_gem, bo_gem);
+		mos_gem_bo_free(&bo_gem->bo);
 	}
 
+	mos_gem_front_cache_age(bufmgr_gem, time);
+
 	bufmgr_gem->time = time;
 }
 
@@ -1715,6 +2018,7 @@ static void mos_gem_bo_purge_vma_cache(struct mos_bufmgr_gem *bufmgr_gem)
 			drm_munmap(bo_gem->mem_virtual, bo_gem->bo.size);
 			bo_gem->mem_virtual = nullptr;
 			bufmgr_gem->vma_count--;
+			bufmgr_gem->map_stats.munmaps++;
 		}
 		if (bo_gem->gtt_virtual) {
 			drm_munmap(bo_gem->gtt_virtual, bo_gem->bo.size);
@@ -1805,6 +2109,14 @@ mos_gem_bo_unreference_final(struct mos_linux_bo *bo, time_t time)
 		bo_gem->softpin_target_size = 0;
 	}
 
+	/* Drop the persistent mapping, its map_count reference is cleared below */
+	if (bo_gem->persistent_mapped) {
+		DRMLISTDELINIT(&bo_gem->persistent_list);
+		bufmgr_gem->persistent_size -= bo->size;
+		bo_gem->persistent_mapped = false;
+		bo_gem->persistent_pins = 0;
+	}
+
 	/* Clear any left-over mappings */
 	if (bo_gem->map_count) {
 		MOS_DBG("bo freed with non-zero map-count %d\n", bo_gem->map_count);
@@ -1816,6 +2128,11 @@ mos_gem_bo_unreference_final(struct mos_linux_bo *bo, time_t time)
 	DRMLISTDEL(&bo_gem->name_list);
 
 	bucket = mos_gem_bo_bucket_for_size(bufmgr_gem, bo->size);
+#ifndef ANDROID
+	/* Buffers allocated before the size classes were changed */
+	if (bucket != nullptr && bucket->size != bo->size)
+		bucket = nullptr;
+#endif
 	/* Put the buffer into our internal cache for reuse if we can. */
 	if (bufmgr_gem->bo_reuse && bo_gem->reusable && bucket != nullptr &&
 	    mos_gem_bo_madvise_internal(bufmgr_gem, bo_gem,
@@ -1825,7 +2142,7 @@ mos_gem_bo_unreference_final(struct mos_linux_bo *bo, time_t time)
 		bo_gem->name = nullptr;
 		bo_gem->validate_index = -1;
 
-		DRMLISTADDTAIL(&bo_gem->head, &bucket->head);
+		mos_gem_bo_cache_add(bufmgr_gem, bucket, bo_gem);
 	} else {
 		mos_gem_bo_free(bo);
 	}
@@ -1854,6 +2171,19 @@ static void mos_gem_bo_unreference(struct mos_linux_bo *bo)
 
 		clock_gettime(CLOCK_MONOTONIC, &time);
 
+#ifndef ANDROID
+		/* We hold the last reference, nobody can look the buffer up */
+		if (mos_gem_front_cache_put(bufmgr_gem, bo_gem, time.tv_sec)) {
+			/* Age the caches once a second */
+			if (bufmgr_gem->time != time.tv_sec) {
+				pthread_mutex_lock(&bufmgr_gem->lock);
+				mos_gem_cleanup_bo_cache(bufmgr_gem, time.tv_sec);
+				pthread_mutex_unlock(&bufmgr_gem->lock);
+			}
+			return;
+		}
+#endif
+
 		pthread_mutex_lock(&bufmgr_gem->lock);
 
 		if (atomic_dec_and_test(&bo_gem->refcount)) {
@@ -2018,6 +2348,7 @@ drm_export int mos_gem_bo_map(struct mos_linux_bo *bo, int write_enable)
 		memclear(mmap_arg);
 		mmap_arg.handle = bo_gem->gem_handle;
 		mmap_arg.size = bo->size;
+		bufmgr_gem->map_stats.mmap_ioctls++;
 		ret = drmIoctl(bufmgr_gem->fd,
 			       DRM_IOCTL_I915_GEM_MMAP,
 			       &mmap_arg);
@@ -2049,6 +2380,7 @@ drm_export int mos_gem_bo_map(struct mos_linux_bo *bo, int write_enable)
 		set_domain.write_domain = I915_GEM_DOMAIN_CPU;
 	else
 		set_domain.write_domain = 0;
+	bufmgr_gem->map_stats.set_domain_ioctls++;
 	ret = drmIoctl(bufmgr_gem->fd,
 		       DRM_IOCTL_I915_GEM_SET_DOMAIN,
 		       &set_domain);
@@ -2260,6 +2592,7 @@ drm_export int mos_gem_bo_unmap(struct mos_linux_bo *bo)
 		 */
 		memclear(sw_finish);
 		sw_finish.handle = bo_gem->gem_handle;
+		bufmgr_gem->map_stats.sw_finish_ioctls++;
 		ret = drmIoctl(bufmgr_gem->fd,
 			       DRM_IOCTL_I915_GEM_SW_FINISH,
 			       &sw_finish);
@@ -2498,19 +2831,10 @@ mos_bufmgr_gem_destroy(struct mos_bufmgr *bufmgr)
 
 #ifndef ANDROID
 	/* Free any cached buffer objects we were going to reuse */
-	for (i = 0; i < bufmgr_gem->num_buckets; i++) {
-		struct mos_gem_bo_bucket *bucket =
-		    &bufmgr_gem->cache_bucket[i];
-		struct mos_bo_gem *bo_gem;
-
-		while (!DRMLISTEMPTY(&bucket->head)) {
-			bo_gem = DRMLISTENTRY(struct mos_bo_gem,
-					      bucket->head.next, head);
-			DRMLISTDEL(&bo_gem->head);
-
-			mos_gem_bo_free(&bo_gem->bo);
-		}
-	}
+	mos_gem_bo_cache_trim(bufmgr_gem, 0);
+	mos_gem_front_cache_drain(bufmgr_gem);
+	for (i = 0; i < MOS_GEM_FRONT_CACHE_COUNT; i++)
+		pthread_mutex_destroy(&bufmgr_gem->front_cache[i].lock);
 
 	/* Release userptr bo kept hanging around for optimisation. */
 	if (bufmgr_gem->userptr_active.ptr) {
@@ -4484,7 +4808,7 @@ mos_gem_bo_references(struct mos_linux_bo *bo, struct mos_linux_bo *target_bo)
 }
 
 static void
-add_bucket(struct mos_bufmgr_gem *bufmgr_gem, int size)
+add_bucket(struct mos_bufmgr_gem *bufmgr_gem, unsigned long size)
 {
 	unsigned int i = bufmgr_gem->num_buckets;
 
@@ -4495,10 +4819,16 @@ add_bucket(struct mos_bufmgr_gem *bufmgr_gem, int size)
 	bufmgr_gem->num_buckets++;
 }
 
+/*
+ * Sets up the size classes, which mos_gem_bo_bucket_for_size maps sizes to
+ * without searching. The cache must be empty.
+ */
 static void
-init_cache_buckets(struct mos_bufmgr_gem *bufmgr_gem)
+init_cache_buckets(struct mos_bufmgr_gem *bufmgr_gem,
+		   unsigned long cache_max_size, int classes)
 {
-	unsigned long size, cache_max_size = 64 * 1024 * 1024;
+	unsigned long size;
+	int i;
 
 	/* OK, so power of two buckets was too wasteful of memory.
 	 * Give 3 other sizes between each power of two, to hopefully
@@ -4508,17 +4838,17 @@ init_cache_buckets(struct mos_bufmgr_gem *bufmgr_gem)
 	 * width/height alignment and rounding of sizes to pages will
 	 * get us useful cache hit rates anyway)
 	 */
+	bufmgr_gem->num_buckets = 0;
+	bufmgr_gem->cache_classes = classes;
+
 	add_bucket(bufmgr_gem, 4096);
 	add_bucket(bufmgr_gem, 4096 * 2);
 	add_bucket(bufmgr_gem, 4096 * 3);
 
 	/* Initialize the linked lists for BO reuse cache. */
 	for (size = 4 * 4096; size <= cache_max_size; size *= 2) {
-		add_bucket(bufmgr_gem, size);
-
-		add_bucket(bufmgr_gem, size + size * 1 / 4);
-		add_bucket(bufmgr_gem, size + size * 2 / 4);
-		add_bucket(bufmgr_gem, size + size * 3 / 4);
+		for (i = 0; i < classes; i++)
+			add_bucket(bufmgr_gem, size + size * i / classes);
 	}
 }
 
@@ -4532,6 +4862,243 @@ mos_bufmgr_gem_set_vma_cache_size(struct mos_bufmgr *bufmgr, int limit)
 	mos_gem_bo_purge_vma_cache(bufmgr_gem);
 }
 
+/**
+ * Releases the persistent mapping of a buffer.
+ *
+ * The CPU mapping itself is unmapped so that the LRU bounds the address
+ * space used, even when the vma cache is unlimited.
+ *
+ * Called with bufmgr_gem->lock held.
+ */
+static void
+mos_gem_bo_release_persistent(struct mos_bufmgr_gem *bufmgr_gem,
+			      struct mos_bo_gem *bo_gem)
+{
+	DRMLISTDELINIT(&bo_gem->persistent_list);
+	bufmgr_gem->persistent_size -= bo_gem->bo.size;
+	bo_gem->persistent_mapped = false;
+	bo_gem->persistent_pins = 0;
+	bo_gem->mapped_cpu_write = false;
+
+	if (--bo_gem->map_count == 0) {
+		mos_gem_bo_close_vma(bufmgr_gem, bo_gem);
+		mos_gem_bo_mark_mmaps_incoherent(&bo_gem->bo);
+		if (bo_gem->mem_virtual) {
+			drm_munmap(bo_gem->mem_virtual, bo_gem->bo.size);
+			bo_gem->mem_virtual = nullptr;
+			bufmgr_gem->vma_count--;
+			bufmgr_gem->map_stats.munmaps++;
+		}
+#ifdef __cplusplus
+		bo_gem->bo.virt = nullptr;
+#else
+		bo_gem->bo.virtual = nullptr;
+#endif
+	}
+}
+
+/**
+ * Drops the least recently locked persistent mappings until the mapped
+ * size fits the budget. Mappings which are currently locked are skipped.
+ *
+ * Called with bufmgr_gem->lock held.
+ */
+static void
+mos_gem_bo_evict_persistent(struct mos_bufmgr_gem *bufmgr_gem)
+{
+	struct mos_bo_gem *bo_gem, *next;
+
+	DRMLISTFOREACHENTRYSAFE(bo_gem, next, &bufmgr_gem->persistent_lru,
+				persistent_list) {
+		if (bufmgr_gem->persistent_size <= bufmgr_gem->persistent_max)
+			break;
+		if (bo_gem->persistent_pins)
+			continue;
+		MOS_DBG("bo_evict_persistent: %d (%s)\n",
+		    bo_gem->gem_handle, bo_gem->name);
+		mos_gem_bo_release_persistent(bufmgr_gem, bo_gem);
+		bufmgr_gem->map_stats.persistent_evictions++;
+	}
+}
+
+/**
+ * Enables persistent CPU mappings, see mos_gem_bo_map_persistent().
+ *
+ * \param max_size Budget in bytes of the persistently mapped buffers,
+ * 0 disables the persistent mappings.
+ *
+ * Persistent mappings are only supported on LLC platforms, where the CPU
+ * caches are coherent with the GPU and no cache maintenance is needed
+ * between the CPU and GPU accesses.
+ */
+void
+mos_bufmgr_gem_enable_persistent_mapping(struct mos_bufmgr *bufmgr,
+					 uint64_t max_size)
+{
+	struct mos_bufmgr_gem *bufmgr_gem = (struct mos_bufmgr_gem *)bufmgr;
+
+	pthread_mutex_lock(&bufmgr_gem->lock);
+	bufmgr_gem->persistent_max = bufmgr_gem->has_llc ? max_size : 0;
+	mos_gem_bo_evict_persistent(bufmgr_gem);
+	pthread_mutex_unlock(&bufmgr_gem->lock);
+}
+
+/**
+ * Returns the mapping counters of the buffer manager.
+ */
+void
+mos_bufmgr_gem_get_map_stats(struct mos_bufmgr *bufmgr,
+			     struct mos_bufmgr_map_stats *stats)
+{
+	struct mos_bufmgr_gem *bufmgr_gem = (struct mos_bufmgr_gem *)bufmgr;
+
+	pthread_mutex_lock(&bufmgr_gem->lock);
+	*stats = bufmgr_gem->map_stats;
+	pthread_mutex_unlock(&bufmgr_gem->lock);
+}
+
+/**
+ * Changes the size classes of the BO cache: objects up to @max_size are
+ * cached, in @classes size classes per power of two. More classes waste less
+ * memory rounding sizes up, but spread the reuse over more buckets. The
+ * cached objects are freed.
+ *
+ * Returns 0 on success, -EINVAL if @classes is not a power of two up to
+ * 8 or @max_size exceeds 4GB.
+ */
+int
+mos_bufmgr_gem_set_cache_classes(struct mos_bufmgr *bufmgr,
+				 uint64_t max_size, int classes)
+{
+	struct mos_bufmgr_gem *bufmgr_gem = (struct mos_bufmgr_gem *)bufmgr;
+
+	if (classes <= 0 || classes > MOS_GEM_BO_CLASSES_MAX ||
+	    (classes & (classes - 1)) || max_size > MOS_GEM_BO_CACHE_MAX_LIMIT)
+		return -EINVAL;
+
+	pthread_mutex_lock(&bufmgr_gem->lock);
+	mos_gem_bo_cache_trim(bufmgr_gem, 0);
+	mos_gem_front_cache_drain(bufmgr_gem);
+	init_cache_buckets(bufmgr_gem, max_size, classes);
+	pthread_mutex_unlock(&bufmgr_gem->lock);
+
+	return 0;
+}
+
+/**
+ * Bounds the size of the BO cache, front caches included, to @budget bytes,
+ * freeing the least recently cached objects first. Cached objects are still
+ * freed after a second of idleness. 0 removes the bound.
+ */
+void
+mos_bufmgr_gem_set_cache_budget(struct mos_bufmgr *bufmgr, uint64_t budget)
+{
+	struct mos_bufmgr_gem *bufmgr_gem = (struct mos_bufmgr_gem *)bufmgr;
+
+	pthread_mutex_lock(&bufmgr_gem->lock);
+	bufmgr_gem->cache_budget = budget;
+	mos_gem_cleanup_bo_cache(bufmgr_gem, bufmgr_gem->time);
+	pthread_mutex_unlock(&bufmgr_gem->lock);
+}
+
+/**
+ * Maps a buffer for CPU access and keeps the mapping across locks.
+ *
+ * The first lock maps the buffer with mos_gem_bo_map(), which also moves it
+ * to the CPU domain. Later locks reuse the mapping and, when sync is set,
+ * only check that the GPU is done with the buffer, waiting for it if needed.
+ * Each successful call must be balanced by mos_gem_bo_unmap_persistent().
+ *
+ * \param virt Returns the CPU address of the buffer.
+ *
+ * Returns 0 on success, -ENODEV when persistent mappings are not enabled or
+ * not supported for this buffer (the caller then falls back to
+ * mos_gem_bo_map()), or another negative error code.
+ */
+int
+mos_gem_bo_map_persistent(struct mos_linux_bo *bo, int write_enable,
+			  int sync, void **virt)
+{
+	struct mos_bufmgr_gem *bufmgr_gem = (struct mos_bufmgr_gem *) bo->bufmgr;
+	struct mos_bo_gem *bo_gem = (struct mos_bo_gem *) bo;
+	int ret;
+
+	if (bo_gem->is_userptr || bufmgr_gem->persistent_max == 0)
+		return -ENODEV;
+
+	pthread_mutex_lock(&bufmgr_gem->lock);
+	if (bo_gem->persistent_mapped) {
+		DRMLISTDEL(&bo_gem->persistent_list);
+		DRMLISTADDTAIL(&bo_gem->persistent_list,
+			       &bufmgr_gem->persistent_lru);
+		bo_gem->persistent_pins++;
+		*virt = bo_gem->mem_virtual;
+		bufmgr_gem->map_stats.persistent_hits++;
+		if (sync)
+			bufmgr_gem->map_stats.busy_checks++;
+		pthread_mutex_unlock(&bufmgr_gem->lock);
+
+		/* Not under the lock, the wait may be long */
+		if (sync && mos_gem_bo_busy(bo)) {
+			mos_gem_bo_wait(bo, -1);
+			pthread_mutex_lock(&bufmgr_gem->lock);
+			bufmgr_gem->map_stats.busy_waits++;
+			pthread_mutex_unlock(&bufmgr_gem->lock);
+		}
+		return 0;
+	}
+	if (bo->size > bufmgr_gem->persistent_max) {
+		pthread_mutex_unlock(&bufmgr_gem->lock);
+		return -ENODEV;
+	}
+	pthread_mutex_unlock(&bufmgr_gem->lock);
+
+	ret = mos_gem_bo_map(bo, write_enable);
+	if (ret != 0)
+		return ret;
+
+	pthread_mutex_lock(&bufmgr_gem->lock);
+	if (bo_gem->persistent_mapped) {
+		/* Mapped concurrently by another thread, which already holds
+		 * the map_count reference of the persistent mapping.
+		 */
+		bo_gem->map_count--;
+	} else {
+		bo_gem->persistent_mapped = true;
+		DRMLISTADDTAIL(&bo_gem->persistent_list,
+			       &bufmgr_gem->persistent_lru);
+		bufmgr_gem->persistent_size += bo->size;
+	}
+	bo_gem->persistent_pins++;
+	*virt = bo_gem->mem_virtual;
+	mos_gem_bo_evict_persistent(bufmgr_gem);
+	pthread_mutex_unlock(&bufmgr_gem->lock);
+
+	return 0;
+}
+
+/**
+ * Ends a lock taken with mos_gem_bo_map_persistent().
+ *
+ * The mapping stays alive until the buffer is freed or evicted by the LRU.
+ * No cache maintenance is needed since persistent mappings require LLC.
+ */
+void
+mos_gem_bo_unmap_persistent(struct mos_linux_bo *bo)
+{
+	struct mos_bufmgr_gem *bufmgr_gem = (struct mos_bufmgr_gem *) bo->bufmgr;
+	struct mos_bo_gem *bo_gem = (struct mos_bo_gem *) bo;
+
+	pthread_mutex_lock(&bufmgr_gem->lock);
+	if (bo_gem->persistent_mapped && bo_gem->persistent_pins > 0) {
+		/* Pinned mappings may have been skipped by an earlier eviction */
+		if (--bo_gem->persistent_pins == 0 &&
+		    bufmgr_gem->persistent_size > bufmgr_gem->persistent_max)
+			mos_gem_bo_evict_persistent(bufmgr_gem);
+	}
+	pthread_mutex_unlock(&bufmgr_gem->lock);
+}
+
 /**
  * Get the PCI ID for the device.  This can be overridden by setting the
  * INTEL_DEVID_OVERRIDE environment variable to the desired ID.
@@ -5223,11 +5790,18 @@ mos_bufmgr_gem_init(int fd, int batch_size)
 	bufmgr_gem->bufmgr.bo_references = mos_gem_bo_references;
 
 	DRMINITLISTHEAD(&bufmgr_gem->named);
-	init_cache_buckets(bufmgr_gem);
+	DRMINITLISTHEAD(&bufmgr_gem->cache_lru);
+	init_cache_buckets(bufmgr_gem, MOS_GEM_BO_CACHE_MAX_DEFAULT,
+			   MOS_GEM_BO_CLASSES_DEFAULT);
+	for (tmp = 0; tmp < MOS_GEM_FRONT_CACHE_COUNT; tmp++)
+		pthread_mutex_init(&bufmgr_gem->front_cache[tmp].lock, nullptr);
 
 	DRMINITLISTHEAD(&bufmgr_gem->vma_cache);
 	bufmgr_gem->vma_max = -1; /* unlimited by default */
 
+	DRMINITLISTHEAD(&bufmgr_gem->persistent_lru);
+	bufmgr_gem->persistent_max = 0; /* disabled by default */
+
 	DRMLISTADD(&bufmgr_gem->managers, &bufmgr_list);
 
 exit:
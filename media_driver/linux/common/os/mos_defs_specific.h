@@ -35,6 +35,8 @@ typedef sem_t                   MOS_SEMAPHORE, *PMOS_SEMAPHORE;           //!< s
 typedef pthread_t               MOS_THREADHANDLE;                         //!< thread handle
 typedef uint32_t                UFKEY, *PUFKEY;                           //!< Handle of user feature key
 
+#define MOS_MUTEX_INITIALIZER   PTHREAD_MUTEX_INITIALIZER                 //!< initializer of statically allocated mutexes
+
 #define _T(x)     x
 #define MAX_PATH  128
 
@@ -36,6 +36,7 @@
 
 #include "mos_graphicsresource.h"
 #include "mos_context_specific.h"
+#include "mos_sw_tiling.h"
 
 #if MOS_MEDIASOLO_SUPPORTED
 #include "mos_os_solo.h"
@@ -61,6 +62,12 @@
 #define X_TILE_WIDTH  512
 #define X_TILE_HEIGHT 8
 
+//!
+//! \brief Read locks of tiled surfaces up to this size go through a staging copy, larger ones through GTT
+//!
+#define MOS_TILED_STAGING_MAX_SIZE      (8 * 1024 * 1024)
+#define MOS_TILED_STAGING_ALIGNMENT     64
+
 #define MI_BATCHBUFFER_END 0x05000000
 
 //!
@@ -191,6 +198,7 @@ int32_t Linux_GetCommandBuffer(
     pCmdBuffer->pCmdPtr     = (uint32_t*)cmd_bo->virt;
     pCmdBuffer->iOffset     = 0;
     pCmdBuffer->iRemaining  = cmd_bo->size;
+    pCmdBuffer->bCachedMapping = true;     // CPU mapping, also on non-LLC parts
     pCmdBuffer->iCmdIndex   = -1;
 
     MOS_ZeroMemory(pCmdBuffer->pCmdBase, cmd_bo->size);
@@ -2052,6 +2060,152 @@ MOS_STATUS Mos_Specific_LockSyncRequest(
     return MOS_STATUS_SUCCESS;        
 }
 
+//!
+//! \brief    Get the number of bytes of a resource the CPU can access through a lock
+//! \details  Locks map the whole resource, so this is the size of all its planes
+//!
+static uint64_t Mos_Specific_GetLockSize(
+    PMOS_RESOURCE         pOsResource)
+{
+    if (pOsResource->pGmmResInfo)
+    {
+        return GmmResGetRenderSize(pOsResource->pGmmResInfo);
+    }
+    return pOsResource->bo ? pOsResource->bo->size : 0;
+}
+
+//!
+//! \brief    Get the number of rows of a staging buffer
+//! \details  Covers the locked size rounded up to whole tile rows, within the BO
+//!
+static uint32_t Mos_Specific_GetTiledStagingRows(
+    MOS_LINUX_BO          *bo,
+    MOS_TILE_TYPE         TileType,
+    uint32_t              dwPitch,
+    uint64_t              qwLockSize)
+{
+    uint64_t qwTileRowSize = (uint64_t)dwPitch * MOS_SwTiling_GetTileHeight(TileType);
+
+    if (qwTileRowSize == 0)
+    {
+        return 0;
+    }
+
+    qwLockSize = MOS_ROUNDUP_DIVIDE(qwLockSize, qwTileRowSize) * qwTileRowSize;
+    return MOS_SwTiling_GetRowCount(TileType, dwPitch, MOS_MIN(qwLockSize, (uint64_t)bo->size));
+}
+
+MOS_MMAP_OPERATION Mos_Specific_SelectTiledMapOperation(
+    MOS_LINUX_BO          *bo,
+    MOS_TILE_TYPE         TileType,
+    uint32_t              dwPitch,
+    uint64_t              qwLockSize,
+    bool                  bReadOnly,
+    bool                  bWriteOnly)
+{
+    uint32_t dwTiling  = I915_TILING_NONE;
+    uint32_t dwSwizzle = I915_BIT_6_SWIZZLE_NONE;
+
+    MOS_OS_ASSERT(bo);
+
+    // Writes through the returned pointer cannot be tracked, so only locks that
+    // never write are staged and nothing has to be written back at unlock
+    if (!bReadOnly || bWriteOnly)
+    {
+        return MOS_MMAP_OPERATION_MMAP_GTT;
+    }
+
+    // The whole locked size is detiled, large locks are cheaper through the fenced mapping
+    if (qwLockSize == 0                                 ||
+        qwLockSize > MOS_TILED_STAGING_MAX_SIZE         ||
+        !MOS_SwTiling_IsSupported(TileType, dwPitch))
+    {
+        return MOS_MMAP_OPERATION_MMAP_GTT;
+    }
+
+    // The software detiler does not apply bit 6 swizzling
+    if (mos_bo_get_tiling(bo, &dwTiling, &dwSwizzle) != 0 ||
+        dwSwizzle != I915_BIT_6_SWIZZLE_NONE             ||
+        dwTiling  != ((TileType == MOS_TILE_X) ? I915_TILING_X : I915_TILING_Y))
+    {
+        return MOS_MMAP_OPERATION_MMAP_GTT;
+    }
+
+    return MOS_MMAP_OPERATION_STAGING_READ;
+}
+
+uint8_t *Mos_Specific_MapTiledStaging(
+    MOS_LINUX_BO          *bo,
+    MOS_TILE_TYPE         TileType,
+    uint32_t              dwPitch,
+    uint64_t              qwLockSize)
+{
+    uint8_t  *pStaging = nullptr;
+    uint32_t dwRows;
+
+    MOS_OS_ASSERT(bo);
+
+    dwRows = Mos_Specific_GetTiledStagingRows(bo, TileType, dwPitch, qwLockSize);
+    if (dwRows == 0)
+    {
+        return nullptr;
+    }
+
+    pStaging = (uint8_t *)MOS_AlignedAllocMemory((size_t)dwRows * dwPitch, MOS_TILED_STAGING_ALIGNMENT);
+    if (pStaging == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Waits for the GPU and moves the BO to the CPU read domain
+    if (mos_bo_map(bo, false) != 0)
+    {
+        MOS_OS_ASSERTMESSAGE("Failed to map tiled bo for staging.");
+        MOS_AlignedFreeMemory(pStaging);
+        return nullptr;
+    }
+
+    MOS_SwTiling_Detile((const uint8_t *)bo->virt, pStaging, TileType, dwPitch, dwRows);
+    mos_bo_unmap(bo);
+
+    return pStaging;
+}
+
+MOS_STATUS Mos_Specific_UnmapTiledStaging(
+    MOS_LINUX_BO          *bo,
+    MOS_TILE_TYPE         TileType,
+    uint32_t              dwPitch,
+    uint64_t              qwLockSize,
+    uint8_t               *pStaging,
+    MOS_MMAP_OPERATION    MmapOperation)
+{
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+    MOS_OS_CHK_NULL(bo);
+    MOS_OS_CHK_NULL(pStaging);
+
+    if (MmapOperation == MOS_MMAP_OPERATION_STAGING_WRITE)
+    {
+        uint32_t dwRows = Mos_Specific_GetTiledStagingRows(bo, TileType, dwPitch, qwLockSize);
+
+        if (mos_bo_map(bo, true) != 0)
+        {
+            MOS_OS_ASSERTMESSAGE("Failed to map tiled bo for write back.");
+            eStatus = MOS_STATUS_UNKNOWN;
+            goto finish;
+        }
+
+        MOS_SwTiling_Retile(pStaging, (uint8_t *)bo->virt, TileType, dwPitch, dwRows);
+        mos_bo_unmap(bo);
+
+        MOS_OS_VERBOSEMESSAGE("Staging write back of bo %d: %d rows.", bo->handle, dwRows);
+    }
+
+finish:
+    MOS_AlignedFreeMemory(pStaging);
+    return eStatus;
+}
+
 //!
 //! \brief    Lock resource
 //! \details  Lock allocated resource
@@ -2138,6 +2292,59 @@ void  *Mos_Specific_LockResource(
             pOsContext->pfnMemoryDecompress(pOsContext, pOsResource);
         }
 
+        // Linear buffers keep their CPU mapping across locks when persistent
+        // mappings are enabled, the lock then only waits for the GPU
+        if (false == pOsResource->bMapped                &&
+            pContext->bPersistentMapping                 &&
+            !pContext->bIsAtomSOC                        &&
+            pOsResource->TileType == MOS_TILE_LINEAR     &&
+            !pLockFlags->Uncached)
+        {
+            void *pVirt = nullptr;
+            if (mos_gem_bo_map_persistent(bo,
+                                          (OSKM_LOCKFLAG_WRITEONLY&pLockFlags->WriteOnly),
+                                          !pLockFlags->NoOverWrite,
+                                          &pVirt) == 0)
+            {
+                pOsResource->pData         = (uint8_t*)pVirt;
+                pOsResource->bMapped       = true;
+                pOsResource->MmapOperation = MOS_MMAP_OPERATION_MMAP_PERSISTENT;
+            }
+        }
+
+        // Tiled surfaces are detiled into a cached staging buffer unless the
+        // caller asked for the tiled layout or an uncached view
+        if (false == pOsResource->bMapped                &&
+            pContext->bTiledLockStaging                  &&
+            !pContext->bIsAtomSOC                        &&
+            pOsResource->TileType != MOS_TILE_LINEAR     &&
+            !pLockFlags->TiledAsTiled                    &&
+            !pLockFlags->Uncached)
+        {
+            MOS_MMAP_OPERATION MmapOperation = Mos_Specific_SelectTiledMapOperation(
+                bo,
+                pOsResource->TileType,
+                pOsResource->iPitch,
+                Mos_Specific_GetLockSize(pOsResource),
+                pLockFlags->ReadOnly,
+                pLockFlags->WriteOnly);
+
+            if (MmapOperation != MOS_MMAP_OPERATION_MMAP_GTT)
+            {
+                uint8_t *pStaging = Mos_Specific_MapTiledStaging(
+                    bo,
+                    pOsResource->TileType,
+                    pOsResource->iPitch,
+                    Mos_Specific_GetLockSize(pOsResource));
+                if (pStaging)
+                {
+                    pOsResource->pData         = pStaging;
+                    pOsResource->bMapped       = true;
+                    pOsResource->MmapOperation = MmapOperation;
+                }
+            }
+        }
+
         if(false == pOsResource->bMapped)
         {
             if (pContext->bIsAtomSOC)
@@ -2250,7 +2457,25 @@ MOS_STATUS Mos_Specific_UnlockResource(
     {
         if(true == pOsResource->bMapped)
         {
-           if (pContext->bIsAtomSOC)
+           if (pOsResource->MmapOperation == MOS_MMAP_OPERATION_MMAP_PERSISTENT)
+           {
+               // The mapping is kept by the bufmgr, only release the lock
+               mos_gem_bo_unmap_persistent(pOsResource->bo);
+               pOsResource->MmapOperation = MOS_MMAP_OPERATION_NONE;
+           }
+           else if (pOsResource->MmapOperation == MOS_MMAP_OPERATION_STAGING_READ ||
+                    pOsResource->MmapOperation == MOS_MMAP_OPERATION_STAGING_WRITE)
+           {
+               eStatus = Mos_Specific_UnmapTiledStaging(
+                   pOsResource->bo,
+                   pOsResource->TileType,
+                   pOsResource->iPitch,
+                   Mos_Specific_GetLockSize(pOsResource),
+                   pOsResource->pData,
+                   pOsResource->MmapOperation);
+               pOsResource->MmapOperation = MOS_MMAP_OPERATION_NONE;
+           }
+           else if (pContext->bIsAtomSOC)
            {
                mos_gem_bo_unmap_gtt(pOsResource->bo);
            }
@@ -2293,6 +2518,34 @@ finish:
     return eStatus;
 }
 
+bool Mos_Specific_IsLockCached(
+    PMOS_INTERFACE        pOsInterface,
+    PMOS_RESOURCE         pOsResource)
+{
+    if (pOsInterface == nullptr || pOsInterface->pOsContext == nullptr ||
+        pOsResource == nullptr || !pOsResource->bMapped)
+    {
+        return false;
+    }
+
+    // Atom SoCs lock every buffer through the GTT
+    if (pOsInterface->pOsContext->bIsAtomSOC)
+    {
+        return false;
+    }
+
+    switch (pOsResource->MmapOperation)
+    {
+        case MOS_MMAP_OPERATION_MMAP:
+        case MOS_MMAP_OPERATION_MMAP_PERSISTENT:
+        case MOS_MMAP_OPERATION_STAGING_READ:
+        case MOS_MMAP_OPERATION_STAGING_WRITE:
+            return true;
+        default:
+            return false;
+    }
+}
+
 //!
 //! \brief    Decompress Resource
 //! \details  Decompress Resource
@@ -3503,6 +3756,40 @@ void Mos_Specific_IncPerfBufferID(
     }
 }
 
+#if MOS_MESSAGES_ENABLED
+//!
+//! \brief    Report the CPU mapping counters of the frame
+//! \details  Logs the map related syscalls done by the bufmgr since the previous
+//!           frame. The bufmgr is shared by the contexts of a device, so the counters
+//!           include the work of all of them.
+//! \param    PMOS_CONTEXT pOsContext
+//!           [in] Pointer to OS context structure
+//! \return   void
+//!
+static void Mos_Specific_ReportMapStatistics(
+    PMOS_CONTEXT pOsContext)
+{
+    struct mos_bufmgr_map_stats  stats;
+    struct mos_bufmgr_map_stats *pLast = &pOsContext->MapStatistics;
+
+    mos_bufmgr_gem_get_map_stats(pOsContext->bufmgr, &stats);
+
+    MOS_OS_VERBOSEMESSAGE(
+        "Frame map stats: mmap %llu, set domain %llu, sw finish %llu, munmap %llu, "
+        "persistent hits %llu, evictions %llu, busy checks %llu, busy waits %llu.",
+        (unsigned long long)(stats.mmap_ioctls          - pLast->mmap_ioctls),
+        (unsigned long long)(stats.set_domain_ioctls    - pLast->set_domain_ioctls),
+        (unsigned long long)(stats.sw_finish_ioctls     - pLast->sw_finish_ioctls),
+        (unsigned long long)(stats.munmaps              - pLast->munmaps),
+        (unsigned long long)(stats.persistent_hits      - pLast->persistent_hits),
+        (unsigned long long)(stats.persistent_evictions - pLast->persistent_evictions),
+        (unsigned long long)(stats.busy_checks          - pLast->busy_checks),
+        (unsigned long long)(stats.busy_waits           - pLast->busy_waits));
+
+    *pLast = stats;
+}
+#endif // MOS_MESSAGES_ENABLED
+
 //!
 //! \brief    Increment the perf tag for Frame ID
 //! \details  Increment the perf tag for frame ID
@@ -3515,6 +3802,13 @@ void Mos_Specific_IncPerfFrameID(
 {
     PMOS_CONTEXT pOsContext = (pOsInterface) ? (PMOS_CONTEXT)pOsInterface->pOsContext : nullptr;
 
+#if MOS_MESSAGES_ENABLED
+    if (pOsContext != nullptr && pOsContext->bufmgr != nullptr)
+    {
+        Mos_Specific_ReportMapStatistics(pOsContext);
+    }
+#endif
+
     if (pOsContext == nullptr || !pOsContext->uEnablePerfTag)
         return;
 
@@ -5187,6 +5481,7 @@ MOS_STATUS Mos_Specific_InitInterface(
     pOsInterface->pfnLockSyncRequest                        = Mos_Specific_LockSyncRequest;    
     pOsInterface->pfnLockResource                           = Mos_Specific_LockResource;
     pOsInterface->pfnUnlockResource                         = Mos_Specific_UnlockResource;
+    pOsInterface->pfnIsLockCached                           = Mos_Specific_IsLockCached;
     pOsInterface->pfnDecompResource                         = Mos_Specific_DecompResource;
     pOsInterface->pfnRegisterResource                       = Mos_Specific_RegisterResource;
     pOsInterface->pfnResetResourceAllocationIndex           = Mos_Specific_ResetResourceAllocationIndex;
@@ -5357,6 +5652,31 @@ MOS_STATUS Mos_Specific_InitInterface(
         &UserFeatureData);
     pOsContext->uEnablePerfTag = UserFeatureData.i32Data;
 
+    // read "Persistent Mapping Enable" user feature key
+    MOS_ZeroMemory(&UserFeatureData, sizeof(UserFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_PERSISTENT_MAPPING_ENABLE_ID,
+        &UserFeatureData);
+    pOsContext->bPersistentMapping = (UserFeatureData.i32Data) ? true : false;
+    if (pOsContext->bPersistentMapping)
+    {
+        MOS_ZeroMemory(&UserFeatureData, sizeof(UserFeatureData));
+        MOS_UserFeature_ReadValue_ID(
+            nullptr,
+            __MEDIA_USER_FEATURE_VALUE_PERSISTENT_MAPPING_BUDGET_ID,
+            &UserFeatureData);
+        mos_bufmgr_gem_enable_persistent_mapping(pOsContext->bufmgr, (uint64_t)UserFeatureData.u32Data << 20);
+    }
+
+    // read "Tiled Lock Staging Enable" user feature key
+    MOS_ZeroMemory(&UserFeatureData, sizeof(UserFeatureData));
+    MOS_UserFeature_ReadValue_ID(
+        nullptr,
+        __MEDIA_USER_FEATURE_VALUE_TILED_LOCK_STAGING_ENABLE_ID,
+        &UserFeatureData);
+    pOsContext->bTiledLockStaging = (UserFeatureData.i32Data) ? true : false;
+
     eStatus = MOS_STATUS_SUCCESS;
 
 finish:
@@ -223,7 +223,10 @@ typedef enum _MOS_MMAP_OPERATION
     MOS_MMAP_OPERATION_NONE    = 0, 
     MOS_MMAP_OPERATION_MMAP,
     MOS_MMAP_OPERATION_MMAP_GTT,
-    MOS_MMAP_OPERATION_MMAP_WC
+    MOS_MMAP_OPERATION_MMAP_WC,
+    MOS_MMAP_OPERATION_MMAP_PERSISTENT,         //!< Mapping kept by the bufmgr across locks
+    MOS_MMAP_OPERATION_STAGING_READ,            //!< Tiled surface detiled into a staging buffer, not written back
+    MOS_MMAP_OPERATION_STAGING_WRITE            //!< Staged surface written by a nested lock, retiled at unlock
 } MOS_MMAP_OPERATION, *PMOS_MMAP_OPERATION;
 
 //!
@@ -492,6 +495,9 @@ struct _MOS_OS_CONTEXT
     int32_t             bDisableKmdWatchdog;      //!< 0: Do not disable kmd watchdog, that is to say, pass I915_EXEC_ENABLE_WATCHDOG flag to KMD;
                                                   //!< 1: Disable kmd watchdog, that is to say, DO NOT pass I915_EXEC_ENABLE_WATCHDOG flag to KMD;
     PERF_DATA           *pPerfData;               //!< Add Perf Data for KMD to capture perf tag
+    int32_t             bPersistentMapping;       //!< Keep the CPU mappings of linear buffers across lock/unlock
+    struct mos_bufmgr_map_stats MapStatistics;    //!< Bufmgr mapping counters at the previous frame
+    int32_t             bTiledLockStaging;        //!< Lock tiled surfaces through a detiled staging buffer instead of GTT
 
     int32_t             *pbHybridDecMultiThreadEnabled;  //!< Hybrid Decoder Multi-Threading Enable Flag
     int32_t             bHybridDecoderRunningFlag;      //!< Flag to indicate if hybrid decoder is running
@@ -738,6 +744,98 @@ MOS_STATUS Mos_Specific_UnlockResource(
     PMOS_INTERFACE        pOsInterface,
     PMOS_RESOURCE         pOsResource);
 
+//!
+//! \brief    Check the CPU mapping of a locked resource is cached
+//! \details  Writes through GTT and write-combined mappings bypass the CPU caches,
+//!           data is better built elsewhere and copied at once
+//! \param    PMOS_INTERFACE pOsInterface
+//!           [in] Pointer to OS interface structure
+//! \param    PMOS_RESOURCE pOsResource
+//!           [in] Pointer to input OS resource
+//! \return   bool
+//!           true if the resource is locked through a CPU cached mapping
+//!
+bool Mos_Specific_IsLockCached(
+    PMOS_INTERFACE        pOsInterface,
+    PMOS_RESOURCE         pOsResource);
+
+//!
+//! \brief    Select how a tiled BO is mapped for a CPU lock
+//! \details  Read only locks of up to 8MB go through a write-back mapping and a
+//!           detiled staging buffer. Locks that may write, larger locks, BOs with
+//!           bit 6 swizzling or a tiling the software detiler does not handle use
+//!           the GTT mapping.
+//! \param    MOS_LINUX_BO *bo
+//!           [in] Tiled BO
+//! \param    MOS_TILE_TYPE TileType
+//!           [in] Tiling of the surface
+//! \param    uint32_t dwPitch
+//!           [in] Surface pitch
+//! \param    uint64_t qwLockSize
+//!           [in] Bytes from the start of the BO the CPU can access
+//! \param    bool bReadOnly
+//!           [in] The CPU will not write the surface
+//! \param    bool bWriteOnly
+//!           [in] The CPU will not read the surface
+//! \return   MOS_MMAP_OPERATION
+//!           MOS_MMAP_OPERATION_STAGING_READ or MOS_MMAP_OPERATION_MMAP_GTT
+//!
+MOS_MMAP_OPERATION Mos_Specific_SelectTiledMapOperation(
+    MOS_LINUX_BO          *bo,
+    MOS_TILE_TYPE         TileType,
+    uint32_t              dwPitch,
+    uint64_t              qwLockSize,
+    bool                  bReadOnly,
+    bool                  bWriteOnly);
+
+//!
+//! \brief    Map a tiled BO through a detiled staging buffer
+//! \details  The staging buffer has the pitch of the surface and covers the
+//!           locked size rounded up to whole tile rows
+//! \param    MOS_LINUX_BO *bo
+//!           [in] Tiled BO
+//! \param    MOS_TILE_TYPE TileType
+//!           [in] Tiling of the surface
+//! \param    uint32_t dwPitch
+//!           [in] Surface pitch
+//! \param    uint64_t qwLockSize
+//!           [in] Bytes from the start of the BO the CPU can access
+//! \return   uint8_t *
+//!           Staging buffer, nullptr if failed
+//!
+uint8_t *Mos_Specific_MapTiledStaging(
+    MOS_LINUX_BO          *bo,
+    MOS_TILE_TYPE         TileType,
+    uint32_t              dwPitch,
+    uint64_t              qwLockSize);
+
+//!
+//! \brief    Release a staging buffer returned by Mos_Specific_MapTiledStaging
+//! \details  With MOS_MMAP_OPERATION_STAGING_WRITE the staged rows are written
+//!           back to the BO first
+//! \param    MOS_LINUX_BO *bo
+//!           [in] Tiled BO
+//! \param    MOS_TILE_TYPE TileType
+//!           [in] Tiling of the surface
+//! \param    uint32_t dwPitch
+//!           [in] Surface pitch
+//! \param    uint64_t qwLockSize
+//!           [in] Locked size the staging buffer was mapped with
+//! \param    uint8_t *pStaging
+//!           [in] Staging buffer
+//! \param    MOS_MMAP_OPERATION MmapOperation
+//!           [in] Operation the staging buffer was locked with
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if successful, otherwise failed
+//!
+MOS_STATUS Mos_Specific_UnmapTiledStaging(
+    MOS_LINUX_BO          *bo,
+    MOS_TILE_TYPE         TileType,
+    uint32_t              dwPitch,
+    uint64_t              qwLockSize,
+    uint8_t               *pStaging,
+    MOS_MMAP_OPERATION    MmapOperation);
+
 //!
 //! \brief    Get Resource Information
 //! \details  Linux get resource info
@@ -27,6 +27,7 @@
 #include "mos_utilities_specific.h"
 #include "mos_utilities.h"
 #include "mos_util_debug.h"
+#include "mos_task_pool.h"
 #include <fcntl.h>     // open
 #include <stdlib.h>    // atoi
 #include <string.h>    // strlen, strcat, etc.
@@ -87,6 +88,14 @@ MOS_MUTEX gMosUtilMutex = PTHREAD_MUTEX_INITIALIZER;
 
 static uint32_t uiMOSUtilInitCount = 0; // number count of mos utilities init
 
+//!
+//! \brief User Feature File parsed once for the key lookups of the process
+//!
+static MOS_PUF_KEYLIST gpUfKeyListCache      = nullptr;
+static struct stat     gUfKeyListCacheStat;             // file the list was parsed from
+static bool            gbUfKeyListCacheValid = false;
+static MOS_MUTEX       gUfKeyListCacheMutex  = PTHREAD_MUTEX_INITIALIZER;
+
 MOS_STATUS MOS_SecureStrcat(char  *strDestination, size_t numberOfElements, const char * const strSource)
 {
     if ( (strDestination == nullptr) || (strSource == nullptr) )
@@ -1061,6 +1070,94 @@ static void _UserFeature_FreeKeyList(MOS_PUF_KEYLIST pKeyList)
     return;
 }
 
+/*----------------------------------------------------------------------------
+| Name      : _UserFeature_LockKeyList
+| Purpose   : Get the key list of the User Feature File, parsed once for all
+|             the lookups of the process.
+| Arguments : ppKeyList          [out] Key Linked list, valid until
+|                                      _UserFeature_UnlockKeyList is called.
+| Returns   : MOS_STATUS_SUCCESS           Operation success, the list is locked.
+|             Other                        Error of _UserFeature_DumpFile, the list
+|                                          is not locked.
+| Comments  : The file is parsed again when its inode, size, modification or
+|             status change time changed since the list was parsed.
+\---------------------------------------------------------------------------*/
+static MOS_STATUS _UserFeature_LockKeyList(MOS_PUF_KEYLIST *ppKeyList)
+{
+    struct stat         FileStat;
+    MOS_PUF_KEYLIST     pKeyList;
+    MOS_STATUS          eStatus;
+
+    pKeyList = nullptr;
+    eStatus  = MOS_STATUS_SUCCESS;
+
+    MOS_LockMutex(&gUfKeyListCacheMutex);
+
+    if (stat(USER_FEATURE_FILE, &FileStat) != 0)
+    {
+        eStatus = MOS_STATUS_USER_FEATURE_KEY_READ_FAILED;
+    }
+    else if (!gbUfKeyListCacheValid                                                  ||
+             FileStat.st_ino          != gUfKeyListCacheStat.st_ino                  ||
+             FileStat.st_size         != gUfKeyListCacheStat.st_size                 ||
+             FileStat.st_mtim.tv_sec  != gUfKeyListCacheStat.st_mtim.tv_sec          ||
+             FileStat.st_mtim.tv_nsec != gUfKeyListCacheStat.st_mtim.tv_nsec         ||
+             FileStat.st_ctim.tv_sec  != gUfKeyListCacheStat.st_ctim.tv_sec          ||
+             FileStat.st_ctim.tv_nsec != gUfKeyListCacheStat.st_ctim.tv_nsec)
+    {
+        // Stat before parsing, a change made in between only causes another parse
+        eStatus = _UserFeature_DumpFile(USER_FEATURE_FILE, &pKeyList);
+        if (eStatus == MOS_STATUS_SUCCESS)
+        {
+            _UserFeature_FreeKeyList(gpUfKeyListCache);
+            gpUfKeyListCache      = pKeyList;
+            gUfKeyListCacheStat   = FileStat;
+            gbUfKeyListCacheValid = true;
+        }
+    }
+
+    if (eStatus != MOS_STATUS_SUCCESS)
+    {
+        _UserFeature_FreeKeyList(gpUfKeyListCache);
+        gpUfKeyListCache      = nullptr;
+        gbUfKeyListCacheValid = false;
+        MOS_UnlockMutex(&gUfKeyListCacheMutex);
+        return eStatus;
+    }
+
+    *ppKeyList = gpUfKeyListCache;
+    return MOS_STATUS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+| Name      : _UserFeature_UnlockKeyList
+| Purpose   : Release the key list returned by _UserFeature_LockKeyList.
+| Arguments : None
+| Returns   : None
+| Comments  :
+\---------------------------------------------------------------------------*/
+static void _UserFeature_UnlockKeyList()
+{
+    MOS_UnlockMutex(&gUfKeyListCacheMutex);
+}
+
+/*----------------------------------------------------------------------------
+| Name      : _UserFeature_InvalidateKeyList
+| Purpose   : Free the parsed key list, the next lookup parses the file again.
+| Arguments : None
+| Returns   : None
+| Comments  : Called after the file is written by this process, whatever the
+|             resolution of the file system timestamps.
+\---------------------------------------------------------------------------*/
+static void _UserFeature_InvalidateKeyList()
+{
+    MOS_LockMutex(&gUfKeyListCacheMutex);
+    _UserFeature_FreeKeyList(gpUfKeyListCache);
+    gpUfKeyListCache      = nullptr;
+    gbUfKeyListCacheValid = false;
+    MOS_UnlockMutex(&gUfKeyListCacheMutex);
+}
+
 /*----------------------------------------------------------------------------
 | Name      : _UserFeature_SetValue
 | Purpose   : Modify or add a value of the specified user feature key.
@@ -1134,6 +1231,7 @@ static MOS_STATUS _UserFeature_SetValue(
     }
 
     _UserFeature_FreeKeyList(pKeyList);
+    _UserFeature_InvalidateKeyList();
     return eStatus;
 }
 
@@ -1185,7 +1283,7 @@ static MOS_STATUS _UserFeature_QueryValue(
     NewKey.pValueArray = &NewValue;
     NewKey.ulValueNum = 1;
 
-    if ( (eStatus = _UserFeature_DumpFile(USER_FEATURE_FILE, &pKeyList)) == MOS_STATUS_SUCCESS)
+    if ( (eStatus = _UserFeature_LockKeyList(&pKeyList)) == MOS_STATUS_SUCCESS)
     {
         if ( (eStatus = _UserFeature_Query(pKeyList, &NewKey)) == MOS_STATUS_SUCCESS )
         {
@@ -1198,8 +1296,8 @@ static MOS_STATUS _UserFeature_QueryValue(
                 *nDataSize   = NewKey.pValueArray[0].ulValueLen;
             }
         }
+        _UserFeature_UnlockKeyList();
     }
-    _UserFeature_FreeKeyList(pKeyList);
 
     return eStatus;
 }
@@ -1224,7 +1322,7 @@ static MOS_STATUS _UserFeature_GetKeyIdbyName(const char  *pcKeyName, void **pUF
     pKeyList   = nullptr;
     iResult    = -1;
 
-    if ( (eStatus = _UserFeature_DumpFile(USER_FEATURE_FILE, &pKeyList)) !=
+    if ( (eStatus = _UserFeature_LockKeyList(&pKeyList)) !=
         MOS_STATUS_SUCCESS )
     {
         return eStatus;
@@ -1242,7 +1340,7 @@ static MOS_STATUS _UserFeature_GetKeyIdbyName(const char  *pcKeyName, void **pUF
             break;
         }
     }
-    _UserFeature_FreeKeyList(pKeyList);
+    _UserFeature_UnlockKeyList();
 
     return eStatus;
 }
@@ -1276,7 +1374,7 @@ static MOS_STATUS _UserFeature_GetKeyNamebyId(void  *UFKey, char  *pcKeyName)
         eStatus = MOS_STATUS_SUCCESS;
         break;
     default:
-        if ( (eStatus = _UserFeature_DumpFile(USER_FEATURE_FILE, &pKeyList)) !=
+        if ( (eStatus = _UserFeature_LockKeyList(&pKeyList)) !=
             MOS_STATUS_SUCCESS )
         {
             return eStatus;
@@ -1293,7 +1391,7 @@ static MOS_STATUS _UserFeature_GetKeyNamebyId(void  *UFKey, char  *pcKeyName)
                 break;
             }
         }
-        _UserFeature_FreeKeyList(pKeyList);
+        _UserFeature_UnlockKeyList();
         break;
     }
 
@@ -2130,8 +2228,10 @@ MOS_STATUS MOS_OS_Utilities_Close()
     uiMOSUtilInitCount--;
     if (uiMOSUtilInitCount == 0 )
     {
+        MOS_TaskPool_Close();
         MOS_TraceEventClose();
         eStatus = MOS_DestroyUserFeatureKeysForAllDescFields();
+        _UserFeature_InvalidateKeyList();
 #if _MEDIA_RESERVED
         if (utilUserInterface) delete utilUserInterface;
 #endif // _MEDIA_RESERVED
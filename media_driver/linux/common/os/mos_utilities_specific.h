@@ -35,11 +35,13 @@
 #define LINUX_OS_VERSION_FILE                "/proc/version"
 
 //user feature
+#ifndef USER_FEATURE_FILE
 #if ANDROID_VERSION >= 800
 #define USER_FEATURE_FILE                   "/data/igfx_user_feature.txt"
 #else
 #define USER_FEATURE_FILE                   "/etc/igfx_user_feature.txt"
 #endif
+#endif
 #define UF_KEY_ID                           "[KEY]"
 #define UF_VALUE_ID                         "[VALUE]"
 #define UF_CAPABILITY                       64
@@ -484,6 +484,54 @@ void RenderHal_InitInterfaceEx(PRENDERHAL_INTERFACE pRenderHal)
     return;
 }
 
+//!
+//! \brief    Get the device a resource allocated by an OS interface belongs to
+//! \details  Buffer objects of one buffer manager can be used by the command
+//!           buffers of all the contexts created on it
+//! \param    PMOS_INTERFACE pOsInterface
+//!           [in] Pointer to OS interface
+//! \return   void *
+//!           Buffer manager of the OS interface, nullptr if none
+//!
+void *RenderHal_SharedIsh_GetDevice(
+    PMOS_INTERFACE          pOsInterface)
+{
+    if (pOsInterface == nullptr || pOsInterface->pOsContext == nullptr)
+    {
+        return nullptr;
+    }
+
+    return pOsInterface->pOsContext->bufmgr;
+}
+
+//!
+//! \brief    Wait for the GPU to complete the work using a resource
+//! \details  Waits for the batches referencing the buffer object at the time
+//!           of the call
+//! \param    PMOS_INTERFACE pOsInterface
+//!           [in] Pointer to OS interface
+//! \param    PMOS_RESOURCE pOsResource
+//!           [in] Resource referenced by all the submissions of the instance
+//! \param    uint32_t dwTimeoutMs
+//!           [in] Time to wait for in milliseconds
+//! \return   bool
+//!           true if the GPU completed the work, false on timeout
+//!
+bool RenderHal_SharedIsh_WaitIdle(
+    PMOS_INTERFACE          pOsInterface,
+    PMOS_RESOURCE           pOsResource,
+    uint32_t                dwTimeoutMs)
+{
+    MHW_RENDERHAL_UNUSED(pOsInterface);
+
+    if (pOsResource == nullptr || pOsResource->bo == nullptr)
+    {
+        return false;
+    }
+
+    return mos_gem_bo_wait(pOsResource->bo, (int64_t)dwTimeoutMs * 1000000) == 0;
+}
+
 //!
 //! \brief    Issue command to write timestamp
 //! \param    [in] pRenderHal
@@ -78,6 +78,9 @@ VAStatus     DdiVp_InitCtx(VADriverContextP, PDDI_VP_CONTEXT);
 VAStatus     DdiVp_SetProcPipelineParams(VADriverContextP, PDDI_VP_CONTEXT, VAProcPipelineParameterBuffer*);
 VAStatus     DdiVp_UpdateFilterParamBuffer(PDDI_VP_CONTEXT, uint32_t, int32_t, void *, uint32_t, DDI_VP_STATE*);
 VAStatus     DdiVp_ClearFilterParamBuffer(PDDI_VP_CONTEXT , uint32_t, DDI_VP_STATE);
+bool         DdiVp_BuildLayerSnapshotKey(PDDI_MEDIA_CONTEXT, VAProcPipelineParameterBuffer*, VPHAL_SURFACE_TYPE, DDI_VP_LAYER_SNAPSHOT_KEY*);
+bool         DdiVp_RestoreLayerSnapshot(PDDI_VP_CONTEXT, uint32_t, DDI_VP_LAYER_SNAPSHOT_KEY*);
+void         DdiVp_SaveLayerSnapshot(PDDI_VP_CONTEXT, uint32_t, DDI_VP_LAYER_SNAPSHOT_KEY*);
 VAStatus     DdiVp_SetProcFilterDinterlaceParams(PDDI_VP_CONTEXT, uint32_t, VAProcFilterParameterBufferDeinterlacing*);
 VAStatus     DdiVp_SetProcFilterDenoiseParams(PDDI_VP_CONTEXT, uint32_t, VAProcFilterParameterBuffer*);
 VAStatus     DdiVp_SetProcFilterSharpnessParams(PDDI_VP_CONTEXT, uint32_t, VAProcFilterParameterBuffer*);
@@ -395,6 +398,7 @@ DdiVp_DestroyRenderParams(PDDI_VP_CONTEXT pVpCtx)
             MOS_FreeMemAndSetNull(pVpCtx->pVpHalRenderParams->pCompAlpha);
             MOS_FreeMemAndSetNull(pVpCtx->pVpHalRenderParams);
         }
+        MOS_FreeMemAndSetNull(pVpCtx->pLayerSnapshots);
     }
 
     return VA_STATUS_SUCCESS;
@@ -735,6 +739,8 @@ DdiVp_SetProcPipelineParams(
     MOS_STATUS                  eStatus;
     DDI_VP_STATE                vpStateFlags;
     PMOS_INTERFACE              pOsInterface;
+    DDI_VP_LAYER_SNAPSHOT_KEY   snapshotKey;
+    bool                        bSnapshotKey;
 
     VP_DDI_FUNCTION_ENTER;
     DDI_CHK_NULL(pVaDrvCtx, "Null pVaDrvCtx.", VA_STATUS_ERROR_INVALID_CONTEXT);
@@ -949,33 +955,43 @@ DdiVp_SetProcPipelineParams(
         }
     }
 
-    for (i = 0; i < pPipelineParam->num_filters; i++)
+    // Only derive the filter params again when the filter buffers of the layer changed
+    bSnapshotKey = DdiVp_BuildLayerSnapshotKey(pMediaCtx, pPipelineParam, pVpHalSrcSurf->SurfType, &snapshotKey);
+    if (!bSnapshotKey || !DdiVp_RestoreLayerSnapshot(pVpCtx, uSurfIndex, &snapshotKey))
     {
-        VABufferID filter = pPipelineParam->filters[i];
+        for (i = 0; i < pPipelineParam->num_filters; i++)
+        {
+            VABufferID filter = pPipelineParam->filters[i];
+
+            pFilterBuf = DdiMedia_GetBufferFromVABufferID(pMediaCtx, filter);
+            DDI_CHK_NULL(pFilterBuf, "Null pFilterBuf!", VA_STATUS_ERROR_INVALID_BUFFER);
 
-        pFilterBuf = DdiMedia_GetBufferFromVABufferID(pMediaCtx, filter);
-        DDI_CHK_NULL(pFilterBuf, "Null pFilterBuf!", VA_STATUS_ERROR_INVALID_BUFFER);
+            DDI_CHK_CONDITION((VAProcFilterParameterBufferType != pFilterBuf->uiType),
+                    "Invalid parameter buffer type!", VA_STATUS_ERROR_INVALID_PARAMETER);
 
-        DDI_CHK_CONDITION((VAProcFilterParameterBufferType != pFilterBuf->uiType),
-                "Invalid parameter buffer type!", VA_STATUS_ERROR_INVALID_PARAMETER);
+            // Map Buffer data to virtual addres space
+            DdiMedia_MapBuffer(pVaDrvCtx, filter, &pData);
 
-        // Map Buffer data to virtual addres space
-        DdiMedia_MapBuffer(pVaDrvCtx, filter, &pData);
+            VAProcFilterParameterBufferBase* filter_param = (VAProcFilterParameterBufferBase*) pData;
 
-        VAProcFilterParameterBufferBase* filter_param = (VAProcFilterParameterBufferBase*) pData;
+            // HSBC can only be applied to the primary layer
+            if (!((filter_param->type == VAProcFilterColorBalance)
+                  && pVpHalSrcSurf->SurfType != SURF_IN_PRIMARY))
+            {
+                // Pass the filter type
+                vaStatus = DdiVp_UpdateFilterParamBuffer(pVpCtx, uSurfIndex, filter_param->type, pData, pFilterBuf->iNumElements, &vpStateFlags);
+                DDI_CHK_RET(vaStatus, "Failed to update parameter buffer!");
+            }
+        }
 
-        // HSBC can only be applied to the primary layer
-        if (!((filter_param->type == VAProcFilterColorBalance)
-              && pVpHalSrcSurf->SurfType != SURF_IN_PRIMARY))
+        DdiVp_ClearFilterParamBuffer(pVpCtx, uSurfIndex, vpStateFlags);
+
+        if (bSnapshotKey)
         {
-            // Pass the filter type
-            vaStatus = DdiVp_UpdateFilterParamBuffer(pVpCtx, uSurfIndex, filter_param->type, pData, pFilterBuf->iNumElements, &vpStateFlags);
-            DDI_CHK_RET(vaStatus, "Failed to update parameter buffer!");
+            DdiVp_SaveLayerSnapshot(pVpCtx, uSurfIndex, &snapshotKey);
         }
     }
 
-	DdiVp_ClearFilterParamBuffer(pVpCtx, uSurfIndex, vpStateFlags);
-
     // Update the Deinterlace params
     //vaStatus = DdiVp_UpdateProcDeinterlaceParams(pVaDrvCtx, pVpHalSrcSurf, pPipelineParam);
     //DDI_CHK_RET(vaStatus, "Failed to update vphal advance deinterlace!");
@@ -1635,6 +1651,177 @@ VAStatus DdiVp_ClearFilterParamBuffer(
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+//! \purpose Build the key the filter params of a layer are snapshotted on
+//! \params
+//! [in]  pMediaCtx : Media context
+//! [in]  pPipelineParam : Pipeline parameters from application (VAProcPipelineParameterBuffer)
+//! [in]  SurfType : Type the layer is composited as
+//! [out] pKey : Filter buffers of the layer
+//! \returns true if the filter params of the layer can be restored from a snapshot
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool DdiVp_BuildLayerSnapshotKey(
+    PDDI_MEDIA_CONTEXT              pMediaCtx,
+    VAProcPipelineParameterBuffer*  pPipelineParam,
+    VPHAL_SURFACE_TYPE              SurfType,
+    DDI_VP_LAYER_SNAPSHOT_KEY*      pKey)
+{
+    PDDI_MEDIA_BUFFER                   pFilterBuf;
+    VAProcFilterParameterBufferBase*    pFilterParam;
+    uint8_t*                            pKeyData;
+    uint32_t                            i;
+
+    pKey->SurfType         = SurfType;
+    pKey->uiNumFilters     = pPipelineParam->num_filters;
+    pKey->uiFilterDataSize = 0;
+
+    for (i = 0; i < pPipelineParam->num_filters; i++)
+    {
+        // Invalid buffers are reported when the filters are applied
+        pFilterBuf = DdiMedia_GetBufferFromVABufferID(pMediaCtx, pPipelineParam->filters[i]);
+        if (nullptr == pFilterBuf ||
+            nullptr == pFilterBuf->pData ||
+            VAProcFilterParameterBufferType != pFilterBuf->uiType ||
+            pFilterBuf->iSize < sizeof(VAProcFilterParameterBufferBase))
+        {
+            return false;
+        }
+
+        // Deinterlacing refreshes the frame IDs of the layer every frame
+        pFilterParam = (VAProcFilterParameterBufferBase*)(pFilterBuf->pData + pFilterBuf->uiOffset);
+        if (VAProcFilterDeinterlacing == pFilterParam->type)
+        {
+            return false;
+        }
+
+        if (pKey->uiFilterDataSize + sizeof(pFilterBuf->iNumElements) + pFilterBuf->iSize > DDI_VP_LAYER_SNAPSHOT_FILTER_DATA_SIZE)
+        {
+            return false;
+        }
+
+        // The element count bounds the elements a filter reads, it is keyed with the data
+        pKeyData = pKey->FilterData + pKey->uiFilterDataSize;
+        MOS_SecureMemcpy(pKeyData, sizeof(pFilterBuf->iNumElements), &pFilterBuf->iNumElements, sizeof(pFilterBuf->iNumElements));
+        pKeyData += sizeof(pFilterBuf->iNumElements);
+        MOS_SecureMemcpy(pKeyData, pFilterBuf->iSize, pFilterParam, pFilterBuf->iSize);
+        pKey->uiFilterDataSize += sizeof(pFilterBuf->iNumElements) + pFilterBuf->iSize;
+    }
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//! \purpose Restore the filter params of a layer whose filter buffers did not change
+//! \params
+//! [in]  pVpCtx : VP context
+//! [in]  uSurfIndex : uSurfIndex to the input surface array
+//! [in]  pKey : Filter buffers of the layer in this frame
+//! [out] None
+//! \returns true if the params were restored, false if they need to be derived
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool DdiVp_RestoreLayerSnapshot(
+    PDDI_VP_CONTEXT                 pVpCtx,
+    uint32_t                        uSurfIndex,
+    DDI_VP_LAYER_SNAPSHOT_KEY*      pKey)
+{
+    DDI_VP_LAYER_SNAPSHOT*          pSnapshot;
+    PVPHAL_SURFACE                  pSrc;
+
+    if (nullptr == pVpCtx->pLayerSnapshots)
+    {
+        return false;
+    }
+
+    pSnapshot = &pVpCtx->pLayerSnapshots[uSurfIndex];
+    if (!pSnapshot->bValid                                          ||
+        pSnapshot->Key.SurfType         != pKey->SurfType           ||
+        pSnapshot->Key.uiNumFilters     != pKey->uiNumFilters       ||
+        pSnapshot->Key.uiFilterDataSize != pKey->uiFilterDataSize   ||
+        memcmp(pSnapshot->Key.FilterData, pKey->FilterData, pKey->uiFilterDataSize))
+    {
+        // Deriving the params can fail half way, the snapshot is taken again once it succeeded
+        pSnapshot->bValid = false;
+        return false;
+    }
+
+    // The params are allocated by the frame that took the snapshot, and only freed by a frame
+    // with other filters. VPHAL may have adjusted them since, so they are all written back.
+    pSrc       = pVpCtx->pVpHalRenderParams->pSrc[uSurfIndex];
+    pSrc->bIEF = pSnapshot->bIEF;
+    if (pSrc->pDenoiseParams)
+    {
+        *pSrc->pDenoiseParams = pSnapshot->DenoiseParams;
+    }
+    if (pSrc->pIEFParams)
+    {
+        *pSrc->pIEFParams = pSnapshot->IEFParams;
+    }
+    if (pSrc->pProcampParams)
+    {
+        *pSrc->pProcampParams = pSnapshot->ProcampParams;
+    }
+    if (pSrc->pColorPipeParams)
+    {
+        *pSrc->pColorPipeParams = pSnapshot->ColorPipeParams;
+    }
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//! \purpose Snapshot the filter params just derived for a layer
+//! \params
+//! [in]  pVpCtx : VP context
+//! [in]  uSurfIndex : uSurfIndex to the input surface array
+//! [in]  pKey : Filter buffers the params were derived from
+//! [out] None
+//! \returns None
+//////////////////////////////////////////////////////////////////////////////////////////////
+void DdiVp_SaveLayerSnapshot(
+    PDDI_VP_CONTEXT                 pVpCtx,
+    uint32_t                        uSurfIndex,
+    DDI_VP_LAYER_SNAPSHOT_KEY*      pKey)
+{
+    DDI_VP_LAYER_SNAPSHOT*          pSnapshot;
+    PVPHAL_SURFACE                  pSrc;
+
+    if (nullptr == pVpCtx->pLayerSnapshots)
+    {
+        // Without snapshots the layers are derived every frame
+        pVpCtx->pLayerSnapshots = (DDI_VP_LAYER_SNAPSHOT*)MOS_AllocAndZeroMemory(VPHAL_MAX_SOURCES * sizeof(DDI_VP_LAYER_SNAPSHOT));
+        if (nullptr == pVpCtx->pLayerSnapshots)
+        {
+            return;
+        }
+    }
+
+    pSnapshot                       = &pVpCtx->pLayerSnapshots[uSurfIndex];
+    pSnapshot->Key.SurfType         = pKey->SurfType;
+    pSnapshot->Key.uiNumFilters     = pKey->uiNumFilters;
+    pSnapshot->Key.uiFilterDataSize = pKey->uiFilterDataSize;
+    MOS_SecureMemcpy(pSnapshot->Key.FilterData, sizeof(pSnapshot->Key.FilterData), pKey->FilterData, pKey->uiFilterDataSize);
+
+    pSrc             = pVpCtx->pVpHalRenderParams->pSrc[uSurfIndex];
+    pSnapshot->bIEF  = pSrc->bIEF;
+    if (pSrc->pDenoiseParams)
+    {
+        pSnapshot->DenoiseParams = *pSrc->pDenoiseParams;
+    }
+    if (pSrc->pIEFParams)
+    {
+        pSnapshot->IEFParams = *pSrc->pIEFParams;
+    }
+    if (pSrc->pProcampParams)
+    {
+        pSnapshot->ProcampParams = *pSrc->pProcampParams;
+    }
+    if (pSrc->pColorPipeParams)
+    {
+        pSnapshot->ColorPipeParams = *pSrc->pColorPipeParams;
+    }
+    pSnapshot->bValid = true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //! \purpose Set DI filter params for input VPHAL surface
 //! \params
@@ -2259,9 +2446,9 @@ VAStatus DdiVp_CreateBuffer(
         VP_DDI_ASSERTMESSAGE("Invalid buffer index.");
         return VA_STATUS_ERROR_INVALID_BUFFER;
     }
-    pBufferHeapElement->pBuffer      = pBuf;
-    pBufferHeapElement->pCtx         = (void *)pVpCtx;
-    pBufferHeapElement->uiCtxType    = DDI_MEDIA_CONTEXT_TYPE_VP;
+    __atomic_store_n(&pBufferHeapElement->pCtx, (void *)pVpCtx, __ATOMIC_RELEASE);
+    __atomic_store_n(&pBufferHeapElement->uiCtxType, DDI_MEDIA_CONTEXT_TYPE_VP, __ATOMIC_RELEASE);
+    __atomic_store_n(&pBufferHeapElement->pBuffer, pBuf, __ATOMIC_RELEASE);
     *pVaBufID                        = pBufferHeapElement->uiVaBufferID;
     pMediaCtx->uiNumBufs++;
 
@@ -2484,7 +2671,7 @@ VAStatus DdiVp_CreateContext (
     }
 
     // store pVpCtx in pMedia
-    pVaCtxHeapElmt->pVaContext    = (void *)pVpCtx;
+    __atomic_store_n(&pVaCtxHeapElmt->pVaContext, (void *)pVpCtx, __ATOMIC_RELEASE);
     *pVaCtxID = (VAContextID)(pVaCtxHeapElmt->uiVaContextID + DDI_MEDIA_VACONTEXTID_OFFSET_VP);
 
     // increate VP context number
@@ -73,6 +73,38 @@ typedef struct _DDI_VP_FRAMEID_TRACER
     uint32_t                                   uiLastSampleType;
 } DDI_VP_FRAMEID_TRACER;
 
+// Filter buffer bytes a layer snapshot can key on, layers with more filter data are always derived
+#define DDI_VP_LAYER_SNAPSHOT_FILTER_DATA_SIZE 1024
+
+//!
+//! \brief Filter buffers of one source layer, as the snapshot of a layer is keyed on
+//!
+typedef struct _DDI_VP_LAYER_SNAPSHOT_KEY
+{
+    VPHAL_SURFACE_TYPE                         SurfType;
+    uint32_t                                   uiNumFilters;
+    uint32_t                                   uiFilterDataSize;
+    uint8_t                                    FilterData[DDI_VP_LAYER_SNAPSHOT_FILTER_DATA_SIZE];
+} DDI_VP_LAYER_SNAPSHOT_KEY;
+
+//!
+//! \brief Filter params last derived for one source layer
+//! \details VPHAL adjusts the filter params of a layer in place while rendering. When a
+//!          layer brings the same filter buffers as in the last frame, the params are
+//!          restored from here instead of being derived from the buffers again.
+//!
+typedef struct _DDI_VP_LAYER_SNAPSHOT
+{
+    bool                                       bValid;
+    DDI_VP_LAYER_SNAPSHOT_KEY                  Key;
+
+    bool                                       bIEF;
+    VPHAL_DENOISE_PARAMS                       DenoiseParams;
+    VPHAL_IEF_PARAMS                           IEFParams;
+    VPHAL_PROCAMP_PARAMS                       ProcampParams;
+    VPHAL_COLORPIPE_PARAMS                     ColorPipeParams;
+} DDI_VP_LAYER_SNAPSHOT;
+
 //core structure for VP DDI
 typedef struct DDI_VP_CONTEXT
 {
@@ -91,6 +123,9 @@ typedef struct DDI_VP_CONTEXT
 
     DDI_VP_FRAMEID_TRACER                     FrameIDTracer;
 
+    // filter params last derived per source layer, allocated on first use
+    DDI_VP_LAYER_SNAPSHOT                     *pLayerSnapshots;
+
 #if (_DEBUG || _RELEASE_INTERNAL)
     DDI_VP_DUMP_PARAM                         *pCurVpDumpDDIParam;
     DDI_VP_DUMP_PARAM                         *pPreVpDumpDDIParam;
@@ -0,0 +1,361 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     codechal_encode_mpeg2_mbenc_test.cpp
+//! \brief    Byte identity tests of the MPEG-2 MbEnc MEDIA_OBJECT batches
+//! \details  The MbEnc batches are built from cached walk orders and slice records and
+//!           replayed while their inputs do not change. The reference below builds
+//!           every batch from scratch the way it was built before the caches.
+//!
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_ult_os_interface.h"
+
+#if defined(_MPEG2_ENCODE_SUPPORTED) && defined(IGFX_GEN9_SUPPORTED)
+
+#include "codechal_encode_mpeg2_g9.h"
+
+//!
+//! \brief    Inputs of one MbEnc batch
+//!
+struct Mpeg2MbEncFrame
+{
+    uint16_t                                 pictureCodingType;
+    uint16_t                                 widthInMb;
+    uint16_t                                 heightInMb;
+    uint32_t                                 downscaledWidthInMb;
+    uint32_t                                 downscaledHeightInMb;
+    bool                                     useHwScoreboard;
+    uint32_t                                 halfSliceSelect;
+    CODECHAL_FUNCTION                        codecFunction;
+    bool                                     distortion;
+    std::vector<CodecEncodeMpeg2SliceParmas> sliceParams;
+    std::vector<CODEC_ENCODER_SLCDATA>       slcData;
+};
+
+//!
+//! \class    CodechalEncodeMpeg2MbEncUlt
+//! \brief    Gen9 MPEG-2 encoder with access to the MbEnc batch building
+//!
+class CodechalEncodeMpeg2MbEncUlt : public CodechalEncodeMpeg2G9
+{
+public:
+    using CodechalEncodeMpeg2G9::CodechalEncodeMpeg2G9;
+
+    void SetFrame(Mpeg2MbEncFrame &frame)
+    {
+        m_pictureCodingType                 = frame.pictureCodingType;
+        m_picWidthInMb                      = frame.widthInMb;
+        m_frameFieldHeightInMb              = frame.heightInMb;
+        m_downscaledWidthInMb4x             = frame.downscaledWidthInMb;
+        m_downscaledFrameFieldHeightInMb4x  = frame.downscaledHeightInMb;
+        m_useHwScoreboard                   = frame.useHwScoreboard;
+        m_halfSliceSelect                   = frame.halfSliceSelect;
+        m_codecFunction                     = frame.codecFunction;
+        m_numSlices                         = (uint32_t)frame.sliceParams.size();
+        m_sliceParams                       = frame.sliceParams.data();
+        m_slcData                           = frame.slcData.data();
+    }
+
+    MOS_STATUS SendMediaObjects(PMHW_BATCH_BUFFER batchBuffer, bool distortion)
+    {
+        return SendMediaObjectsBB(batchBuffer, distortion);
+    }
+
+    //!
+    //! \brief    Reference batch, records and walk order built for the frame alone
+    //!
+    MOS_STATUS SendReferenceMediaObjects(PMHW_BATCH_BUFFER batchBuffer, bool distortion)
+    {
+        uint16_t widthInMb  = distortion ? (uint16_t)m_downscaledWidthInMb4x : m_picWidthInMb;
+        uint16_t heightInMb = distortion ? (uint16_t)m_downscaledFrameFieldHeightInMb4x : m_frameFieldHeightInMb;
+        uint32_t numSlice   = distortion ? 1 : m_numSlices;
+        uint32_t numObjs    = widthInMb * heightInMb;
+
+        std::vector<uint16_t> mbOffset(numObjs);
+        uint8_t               scoreboardMask = 0;
+        if (m_pictureCodingType == I_TYPE)
+        {
+            CodecHalEncode_MBWalker_RasterScan(widthInMb, heightInMb, mbOffset.data());
+        }
+        else if (m_pictureCodingType == P_TYPE)
+        {
+            CodecHalEncode_MBWalker_45(widthInMb, heightInMb, mbOffset.data());
+            scoreboardMask = 0x03;
+        }
+        else
+        {
+            CodecHalEncode_MBWalker_VerticalScan(widthInMb, heightInMb, mbOffset.data());
+            scoreboardMask = 0x01;
+        }
+
+        // DW1 and DW2 of the inline data of each MB in raster order
+        std::vector<uint32_t> recordDw1(numObjs, 0);
+        std::vector<uint32_t> recordDw2(numObjs, 0);
+        if (m_codecFunction != CODECHAL_FUNCTION_ENC)
+        {
+            uint32_t mb = 0;
+            for (uint32_t i = 0; i < numSlice; i++)
+            {
+                uint32_t numMbs   = distortion ? numObjs : m_sliceParams[i].m_numMbsForSlice;
+                bool     startsSg = distortion || (m_slcData[i].SliceGroup & SLICE_GROUP_START);
+                bool     endsSg   = distortion || (m_slcData[i].SliceGroup & SLICE_GROUP_END);
+
+                for (uint32_t j = 0; j < numMbs; j++, mb++)
+                {
+                    if (j == 0)
+                    {
+                        recordDw1[mb] |= 0x40000000 | (startsSg ? 0x00000100 : 0);
+                    }
+                    if (j == numMbs - 1)
+                    {
+                        recordDw1[mb] |= 0x00800000;
+                        if (endsSg)
+                        {
+                            recordDw1[mb] |= 0x00000004;
+                            recordDw2[mb] = 0x05000000;
+                        }
+                    }
+                }
+            }
+        }
+
+        uint32_t                inlineData[3];
+        MHW_MEDIA_OBJECT_PARAMS params;
+        MOS_ZeroMemory(&params, sizeof(params));
+        params.VfeScoreboard.ScoreboardEnable   = (m_pictureCodingType == I_TYPE) ? false : m_useHwScoreboard;
+        params.dwHalfSliceDestinationSelect     = m_halfSliceSelect;
+        params.pInlineData                      = inlineData;
+        params.dwInlineDataSize                 = sizeof(inlineData);
+
+        for (uint32_t i = 0; i < numObjs; i++)
+        {
+            uint32_t mbX = mbOffset[i] % widthInMb;
+            uint32_t mbY = mbOffset[i] / widthInMb;
+
+            params.VfeScoreboard.Value[0]       = mbX;
+            params.VfeScoreboard.Value[1]       = mbY;
+            params.VfeScoreboard.ScoreboardMask = scoreboardMask;
+            inlineData[0] = (mbX & 0xff) | ((mbY & 0xff) << 8);
+            inlineData[1] = recordDw1[mbOffset[i]];
+            inlineData[2] = recordDw2[mbOffset[i]];
+
+            MOS_STATUS eStatus = m_hwInterface->GetRenderInterface()->AddMediaObject(nullptr, batchBuffer, &params);
+            if (eStatus != MOS_STATUS_SUCCESS)
+            {
+                return eStatus;
+            }
+        }
+
+        return m_miInterface->AddMiBatchBufferEnd(nullptr, batchBuffer);
+    }
+
+    void FreeCaches()
+    {
+        FreeMbObjectCaches();
+        m_sliceParams = nullptr;
+        m_slcData     = nullptr;
+    }
+};
+
+class CodechalEncodeMpeg2MbEncTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_osInterface = new MediaUltOsInterface(IGFX_SKYLAKE, IGFX_GEN9_CORE);
+
+        CodechalHwInterface *hwInterface = m_osInterface->CreateCodechalHwInterface(CODECHAL_FUNCTION_ENC_PAK);
+        ASSERT_NE(hwInterface, nullptr);
+
+        CODECHAL_STANDARD_INFO standardInfo;
+        MOS_ZeroMemory(&standardInfo, sizeof(standardInfo));
+        standardInfo.CodecFunction = CODECHAL_FUNCTION_ENC_PAK;
+        standardInfo.Mode          = CODECHAL_ENCODE_MODE_MPEG2;
+
+        m_encoder = MOS_New(CodechalEncodeMpeg2MbEncUlt, hwInterface, m_osInterface->CreateDebugInterface(), &standardInfo);
+        ASSERT_NE(m_encoder, nullptr);
+    }
+
+    void TearDown() override
+    {
+        if (m_encoder)
+        {
+            m_encoder->FreeCaches();
+            MOS_Delete(m_encoder);
+        }
+
+        delete m_osInterface;
+    }
+
+    //!
+    //! \brief    Batch buffer on host memory, locked for the whole test
+    //! \details  Without a cached mapping the commands are staged before being copied in
+    //!
+    void InitBatchBuffer(MHW_BATCH_BUFFER &batchBuffer, std::vector<uint8_t> &memory, bool cachedMapping)
+    {
+        MOS_ZeroMemory(&batchBuffer, sizeof(batchBuffer));
+        memory.assign(m_batchBufferSize, 0);
+        batchBuffer.pData          = memory.data();
+        batchBuffer.iSize          = m_batchBufferSize;
+        batchBuffer.iRemaining     = m_batchBufferSize;
+        batchBuffer.bLocked        = true;
+        batchBuffer.bCachedMapping = cachedMapping;
+    }
+
+    void RandomFrame(Mpeg2MbEncFrame &frame)
+    {
+        static const uint16_t sizes[][2] = {{45, 36}, {120, 68}, {120, 34}, {22, 18}, {1, 1}, {7, 3}};
+        static const uint16_t codingTypes[] = {I_TYPE, P_TYPE, B_TYPE};
+
+        uint32_t size = m_random() % (sizeof(sizes) / sizeof(sizes[0]));
+
+        frame.pictureCodingType     = codingTypes[m_random() % 3];
+        frame.widthInMb             = sizes[size][0];
+        frame.heightInMb            = sizes[size][1];
+        frame.downscaledWidthInMb   = (frame.widthInMb + 3) / 4;
+        frame.downscaledHeightInMb  = (frame.heightInMb + 3) / 4;
+        frame.useHwScoreboard       = m_random() % 2;
+        frame.halfSliceSelect       = m_random() % 4;
+        frame.codecFunction         = (m_random() % 5) ? CODECHAL_FUNCTION_ENC_PAK : CODECHAL_FUNCTION_ENC;
+        frame.distortion            = frame.pictureCodingType == I_TYPE && (m_random() % 3) == 0;
+
+        // Row aligned slices of equal height, the last ones may be shorter or missing MBs
+        uint32_t numSlices  = 1;
+        uint32_t numDivisors = 0;
+        for (uint32_t rows = 1; rows <= frame.heightInMb; rows++)
+        {
+            if (frame.heightInMb % rows == 0 && (m_random() % ++numDivisors) == 0)
+            {
+                numSlices = frame.heightInMb / rows;
+            }
+        }
+        uint32_t sliceMbs = frame.widthInMb * frame.heightInMb / numSlices;
+
+        frame.sliceParams.assign(numSlices, CodecEncodeMpeg2SliceParmas());
+        frame.slcData.assign(numSlices, CODEC_ENCODER_SLCDATA());
+        for (uint32_t i = 0; i < numSlices; i++)
+        {
+            MOS_ZeroMemory(&frame.sliceParams[i], sizeof(frame.sliceParams[i]));
+            MOS_ZeroMemory(&frame.slcData[i], sizeof(frame.slcData[i]));
+
+            frame.sliceParams[i].m_numMbsForSlice = (uint16_t)sliceMbs;
+            if (i == numSlices - 1 && (m_random() % 4) == 0)
+            {
+                frame.sliceParams[i].m_numMbsForSlice = (uint16_t)(1 + m_random() % sliceMbs);
+            }
+            frame.slcData[i].SliceGroup = (uint8_t)(m_random() % 4);
+        }
+    }
+
+    void CheckBatch(Mpeg2MbEncFrame &frame, uint32_t frameIdx, bool cachedMapping)
+    {
+        MHW_BATCH_BUFFER     batchBuffer;
+        MHW_BATCH_BUFFER     referenceBuffer;
+        std::vector<uint8_t> memory;
+        std::vector<uint8_t> referenceMemory;
+
+        InitBatchBuffer(batchBuffer, memory, cachedMapping);
+        InitBatchBuffer(referenceBuffer, referenceMemory, true);
+
+        m_encoder->SetFrame(frame);
+        ASSERT_EQ(m_encoder->SendMediaObjects(&batchBuffer, frame.distortion), MOS_STATUS_SUCCESS);
+        ASSERT_EQ(m_encoder->SendReferenceMediaObjects(&referenceBuffer, frame.distortion), MOS_STATUS_SUCCESS);
+
+        ASSERT_EQ(batchBuffer.iCurrent, referenceBuffer.iCurrent) << "Frame " << frameIdx;
+        ASSERT_EQ(memcmp(memory.data(), referenceMemory.data(), referenceBuffer.iCurrent), 0) << "Frame " << frameIdx;
+    }
+
+    static constexpr int32_t m_batchBufferSize = 120 * 68 * 64 + 64;
+
+    MediaUltOsInterface         *m_osInterface = nullptr;
+    CodechalEncodeMpeg2MbEncUlt *m_encoder     = nullptr;
+    std::mt19937                m_random{0x4d503247};
+};
+
+//!
+//! \brief    Random frames, each batch must match the one built from scratch
+//! \details  Frames are repeated and alternated so batches are replayed, rebuilt after
+//!           a slice layout change and evicted from the cache.
+//!
+TEST_F(CodechalEncodeMpeg2MbEncTest, MatchesUncachedBuild)
+{
+    std::vector<Mpeg2MbEncFrame> recentFrames;
+
+    for (uint32_t i = 0; i < 400; i++)
+    {
+        Mpeg2MbEncFrame frame;
+
+        if (!recentFrames.empty() && (m_random() % 2))
+        {
+            // Same inputs as a recent frame, possibly with a single slice changed
+            frame = recentFrames[m_random() % recentFrames.size()];
+            if ((m_random() % 4) == 0 && frame.codecFunction != CODECHAL_FUNCTION_ENC && !frame.distortion)
+            {
+                frame.slcData[m_random() % frame.slcData.size()].SliceGroup ^= SLICE_GROUP_END;
+            }
+        }
+        else
+        {
+            RandomFrame(frame);
+        }
+
+        CheckBatch(frame, i, (m_random() % 2) == 0);
+        if (HasFatalFailure())
+        {
+            return;
+        }
+
+        recentFrames.push_back(frame);
+        if (recentFrames.size() > 8)
+        {
+            recentFrames.erase(recentFrames.begin());
+        }
+    }
+}
+
+//!
+//! \brief    The same frame over and over is replayed identically
+//!
+TEST_F(CodechalEncodeMpeg2MbEncTest, ReplayMatchesFirstBuild)
+{
+    for (uint32_t type = 0; type < 3; type++)
+    {
+        Mpeg2MbEncFrame frame;
+        RandomFrame(frame);
+        frame.pictureCodingType = (type == 0) ? I_TYPE : ((type == 1) ? P_TYPE : B_TYPE);
+        frame.distortion        = false;
+
+        for (uint32_t repeat = 0; repeat < 4; repeat++)
+        {
+            CheckBatch(frame, repeat, repeat % 2);
+            if (HasFatalFailure())
+            {
+                return;
+            }
+        }
+    }
+}
+
+#endif // _MPEG2_ENCODE_SUPPORTED && IGFX_GEN9_SUPPORTED
@@ -0,0 +1,455 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     codechal_vdenc_hevc_streamin_test.cpp
+//! \brief    Byte identity tests of the HEVC VDEnc ROI and dirty rectangle stream-in
+//! \details  The stream-in buffers are built from a map of distinct records and only
+//!           rewritten where they change. The reference below is the direct per CU
+//!           write of a cleared buffer the map replaced.
+//!
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_ult_os_interface.h"
+
+#if defined(_HEVC_ENCODE_SUPPORTED) && defined(IGFX_GEN10_SUPPORTED)
+
+#include "codechal_vdenc_hevc_g10.h"
+
+class CodechalVdencHevcStreamInTest : public testing::Test
+{
+protected:
+    static constexpr uint32_t m_maxWidth  = 4096;
+    static constexpr uint32_t m_maxHeight = 2176;
+    static constexpr uint32_t m_bufferSize = (m_maxWidth / 32) * (m_maxHeight / 32) * CODECHAL_CACHELINE_SIZE;
+
+    void SetUp() override
+    {
+        m_osInterface = new MediaUltOsInterface(IGFX_CANNONLAKE, IGFX_GEN10_CORE);
+
+        CodechalHwInterface *hwInterface = m_osInterface->CreateCodechalHwInterface(CODECHAL_FUNCTION_ENC_VDENC_PAK);
+        ASSERT_NE(hwInterface, nullptr);
+
+        CODECHAL_STANDARD_INFO standardInfo;
+        MOS_ZeroMemory(&standardInfo, sizeof(standardInfo));
+        standardInfo.CodecFunction = CODECHAL_FUNCTION_ENC_VDENC_PAK;
+        standardInfo.Mode          = CODECHAL_ENCODE_MODE_HEVC;
+
+        m_encoder = MOS_New(CodechalVdencHevcStateG10, hwInterface, m_osInterface->CreateDebugInterface(), &standardInfo);
+        ASSERT_NE(m_encoder, nullptr);
+
+        MOS_ZeroMemory(&m_picParams, sizeof(m_picParams));
+        MOS_ZeroMemory(&m_seqParams, sizeof(m_seqParams));
+        MOS_ZeroMemory(&m_sliceParams, sizeof(m_sliceParams));
+        m_encoder->pHevcPicParams   = &m_picParams;
+        m_encoder->pHevcSeqParams   = &m_seqParams;
+        m_encoder->pHevcSliceParams = &m_sliceParams;
+        m_picParams.pDirtyRect      = m_dirtyRects;
+
+        for (uint32_t i = 0; i < CODECHAL_ENCODE_RECYCLED_BUFFER_NUM; i++)
+        {
+            ASSERT_EQ(m_osInterface->AllocateBuffer(&m_streamIn[i], m_bufferSize), MOS_STATUS_SUCCESS);
+        }
+    }
+
+    void TearDown() override
+    {
+        for (uint32_t i = 0; i < CODECHAL_ENCODE_RECYCLED_BUFFER_NUM; i++)
+        {
+            m_osInterface->FreeBuffer(&m_streamIn[i]);
+        }
+
+        if (m_encoder)
+        {
+            // Only the stream-in maps were allocated, the encoder resources never were
+            for (uint32_t i = 0; i < CODECHAL_ENCODE_RECYCLED_BUFFER_NUM; i++)
+            {
+                MOS_FreeMemory(m_encoder->m_streamInMap[i].cuRecord);
+                m_encoder->m_streamInMap[i].cuRecord = nullptr;
+            }
+            MOS_FreeMemory(m_encoder->m_streamInMapNew.cuRecord);
+            m_encoder->m_streamInMapNew.cuRecord = nullptr;
+            MOS_FreeMemory(m_encoder->m_streamInZigZagLut);
+            m_encoder->m_streamInZigZagLut = nullptr;
+
+            MOS_Delete(m_encoder);
+        }
+
+        delete m_osInterface;
+    }
+
+    uint8_t *CuData(std::vector<uint8_t> &buffer, uint32_t streamInWidth, uint32_t x, uint32_t y)
+    {
+        uint32_t offset  = streamInWidth * y;
+        uint32_t yOffset = 0;
+        uint32_t xOffset = 2 * x;
+
+        if (y % 2)
+        {
+            offset  = streamInWidth * (y - 1);
+            yOffset = 2;
+        }
+        if (x % 2)
+        {
+            xOffset = (2 * x) - 1;
+        }
+
+        return buffer.data() + (offset + xOffset + yOffset) * CODECHAL_CACHELINE_SIZE;
+    }
+
+    void SetPerTu(MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS &params, uint8_t maxcu)
+    {
+        params.maxTuSize = 3;
+        params.maxCuSize = maxcu;
+        switch (m_seqParams.TargetUsage)
+        {
+        case 1:
+        case 4:
+            params.numMergeCandidateCu64x64 = 4;
+            params.numMergeCandidateCu32x32 = 3;
+            params.numMergeCandidateCu16x16 = 2;
+            params.numMergeCandidateCu8x8   = 1;
+            params.numImePredictors         = m_encoder->m_imgStateImePredictors;
+            break;
+        case 7:
+            params.numMergeCandidateCu64x64 = 2;
+            params.numMergeCandidateCu32x32 = 2;
+            params.numMergeCandidateCu16x16 = 2;
+            params.numMergeCandidateCu8x8   = 0;
+            params.numImePredictors         = 4;
+            break;
+        }
+    }
+
+    void SetRegion(
+        std::vector<uint8_t>                  &buffer,
+        uint32_t                              streamInWidth,
+        uint32_t                              top,
+        uint32_t                              bottom,
+        uint32_t                              left,
+        uint32_t                              right,
+        MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS &params)
+    {
+        for (uint32_t y = top; y < bottom; y++)
+        {
+            for (uint32_t x = left; x < right; x++)
+            {
+                m_encoder->SetStreaminDataPerLcu(&params, CuData(buffer, streamInWidth, x, y));
+            }
+        }
+    }
+
+    //!
+    //! \brief    Reference ROI stream-in, written CU by CU to a cleared buffer
+    //!
+    void ReferenceRoiStreamIn(std::vector<uint8_t> &buffer)
+    {
+        uint32_t streamInWidth  = MOS_ALIGN_CEIL(m_encoder->m_frameWidth, 64) / 32;
+        uint32_t streamInHeight = MOS_ALIGN_CEIL(m_encoder->m_frameHeight, 64) / 32;
+        bool     cu64Align      = true;
+
+        buffer.assign(streamInWidth * streamInHeight * CODECHAL_CACHELINE_SIZE, 0);
+
+        for (int32_t i = m_picParams.NumROI - 1; i >= 0; i--)
+        {
+            uint32_t top    = CodecHal_Clip3(0, (int32_t)streamInHeight - 1, m_picParams.ROI[i].Top);
+            uint32_t bottom = CodecHal_Clip3(0, (int32_t)streamInHeight - 1, m_picParams.ROI[i].Bottom) + 1;
+            uint32_t left   = CodecHal_Clip3(0, (int32_t)streamInWidth - 1, m_picParams.ROI[i].Left);
+            uint32_t right  = CodecHal_Clip3(0, (int32_t)streamInWidth - 1, m_picParams.ROI[i].Right) + 1;
+
+            if ((top % 2) || (bottom % 2) || (left % 2) || (right % 2))
+            {
+                cu64Align = false;
+            }
+
+            uint32_t roiCtrl = 0;
+            for (uint32_t j = 0; j < m_encoder->m_maxNumNativeROI; j++)
+            {
+                if (m_picParams.ROIDistinctDeltaQp[j] == m_picParams.ROI[i].PriorityLevelOrDQp)
+                {
+                    roiCtrl = (j + 1) * 0x55;
+                    break;
+                }
+            }
+
+            MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS params;
+            MOS_ZeroMemory(&params, sizeof(params));
+            params.setQpRoiCtrl = true;
+            if (m_encoder->m_vdencNativeROIEnabled)
+            {
+                params.roiCtrl = (uint8_t)roiCtrl;
+            }
+            else
+            {
+                params.forceQp = (int8_t)CodecHal_Clip3(0, 51,
+                    m_picParams.QpY + m_picParams.ROI[i].PriorityLevelOrDQp + m_sliceParams.slice_qp_delta);
+            }
+            SetRegion(buffer, streamInWidth, top, bottom, left, right, params);
+        }
+
+        MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS params;
+        MOS_ZeroMemory(&params, sizeof(params));
+        SetPerTu(params, cu64Align ? 3 : 2);
+        SetRegion(buffer, streamInWidth, 0, streamInHeight, 0, streamInWidth, params);
+    }
+
+    void ReferenceDirtyRectRegion(
+        std::vector<uint8_t> &buffer,
+        uint32_t             streamInWidth,
+        uint32_t             top,
+        uint32_t             bottom,
+        uint32_t             left,
+        uint32_t             right,
+        uint8_t              maxcu)
+    {
+        MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS params;
+        MOS_ZeroMemory(&params, sizeof(params));
+        SetPerTu(params, maxcu);
+        params.puTypeCtrl = 0;
+        SetRegion(buffer, streamInWidth, top, bottom, left, right, params);
+    }
+
+    void ReferenceStaticRegion(
+        std::vector<uint8_t> &buffer,
+        uint32_t             streamInWidth,
+        uint32_t             top,
+        uint32_t             bottom,
+        uint32_t             left,
+        uint32_t             right)
+    {
+        MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS params;
+        MOS_ZeroMemory(&params, sizeof(params));
+        params.maxTuSize                = 3;
+        params.maxCuSize                = 2;
+        params.numMergeCandidateCu32x32 = 1;
+        params.puTypeCtrl               = 0xff;
+        SetRegion(buffer, streamInWidth, top, bottom, left, right, params);
+    }
+
+    //!
+    //! \brief    Reference dirty rectangle stream-in, written CU by CU to a cleared buffer
+    //!
+    void ReferenceDirtyRectStreamIn(std::vector<uint8_t> &buffer)
+    {
+        uint32_t streamInWidth  = MOS_ALIGN_CEIL(m_encoder->m_frameWidth, 64) / 32;
+        uint32_t streamInHeight = MOS_ALIGN_CEIL(m_encoder->m_frameHeight, 64) / 32;
+
+        buffer.assign(streamInWidth * streamInHeight * CODECHAL_CACHELINE_SIZE, 0);
+
+        MHW_VDBOX_VDENC_STREAMIN_STATE_PARAMS params;
+        MOS_ZeroMemory(&params, sizeof(params));
+        params.maxTuSize                = 3;
+        params.maxCuSize                = 3;
+        params.puTypeCtrl               = 0xff;
+        params.numMergeCandidateCu64x64 = 1;
+        SetRegion(buffer, streamInWidth, 0, streamInHeight, 0, streamInWidth, params);
+
+        for (int32_t i = m_picParams.NumDirtyRects - 1; i >= 0; i--)
+        {
+            uint32_t top    = CodecHal_Clip3(0, (int32_t)streamInHeight - 1, m_picParams.pDirtyRect[i].Top);
+            uint32_t bottom = CodecHal_Clip3(0, (int32_t)streamInHeight - 1, m_picParams.pDirtyRect[i].Bottom) + 1;
+            uint32_t left   = CodecHal_Clip3(0, (int32_t)streamInWidth - 1, m_picParams.pDirtyRect[i].Left);
+            uint32_t right  = CodecHal_Clip3(0, (int32_t)streamInWidth - 1, m_picParams.pDirtyRect[i].Right) + 1;
+
+            uint32_t dirtyTop    = top;
+            uint32_t dirtyBottom = bottom;
+            uint32_t dirtyLeft   = left;
+            uint32_t dirtyRight  = right;
+            uint32_t evenLeft    = (left % 2) ? left - 1 : left;
+            uint32_t evenRight   = (right % 2) ? right + 1 : right;
+            uint32_t evenTop     = (top % 2) ? top - 1 : top;
+            uint32_t evenBottom  = (bottom % 2) ? bottom + 1 : bottom;
+
+            if (top % 2)
+            {
+                ReferenceDirtyRectRegion(buffer, streamInWidth, top, top + 1, left, right, 2);
+                ReferenceStaticRegion(buffer, streamInWidth, top - 1, top, evenLeft, evenRight);
+                dirtyTop = top + 1;
+            }
+            if (bottom % 2)
+            {
+                ReferenceDirtyRectRegion(buffer, streamInWidth, bottom - 1, bottom, left, right, 2);
+                ReferenceStaticRegion(buffer, streamInWidth, bottom, bottom + 1, evenLeft, evenRight);
+                dirtyBottom = bottom - 1;
+            }
+            if (left % 2)
+            {
+                ReferenceDirtyRectRegion(buffer, streamInWidth, top, bottom, left, left + 1, 2);
+                ReferenceStaticRegion(buffer, streamInWidth, evenTop, evenBottom, left - 1, left);
+                dirtyLeft = left + 1;
+            }
+            if (right % 2)
+            {
+                ReferenceDirtyRectRegion(buffer, streamInWidth, top, bottom, right - 1, right, 2);
+                ReferenceStaticRegion(buffer, streamInWidth, evenTop, evenBottom, right, right + 1);
+                dirtyRight = right - 1;
+            }
+            ReferenceDirtyRectRegion(buffer, streamInWidth, dirtyTop, dirtyBottom, dirtyLeft, dirtyRight, 3);
+        }
+    }
+
+    void RandomRect(CODEC_ROI &rect, uint32_t streamInWidth, uint32_t streamInHeight)
+    {
+        // Rectangles may reach past the frame to exercise the clipping
+        rect.Top    = (uint16_t)(m_random() % (streamInHeight + 2));
+        rect.Bottom = (uint16_t)(rect.Top + m_random() % (streamInHeight / 2 + 1));
+        rect.Left   = (uint16_t)(m_random() % (streamInWidth + 2));
+        rect.Right  = (uint16_t)(rect.Left + m_random() % (streamInWidth / 2 + 1));
+    }
+
+    void RandomFrameParams(bool roi)
+    {
+        static const uint8_t targetUsages[] = {1, 4, 7};
+
+        uint32_t streamInWidth  = MOS_ALIGN_CEIL(m_encoder->m_frameWidth, 64) / 32;
+        uint32_t streamInHeight = MOS_ALIGN_CEIL(m_encoder->m_frameHeight, 64) / 32;
+
+        m_seqParams.TargetUsage       = targetUsages[m_random() % 3];
+        m_picParams.QpY               = (char)(10 + m_random() % 35);
+        m_sliceParams.slice_qp_delta  = (char)((int32_t)(m_random() % 11) - 5);
+
+        if (roi)
+        {
+            // Few distinct small delta QPs use native ROI, others force the QP
+            bool native = m_random() % 2;
+            m_picParams.NumROI = (uint8_t)(1 + m_random() % CODECHAL_ENCODE_HEVC_MAX_NUM_ROI);
+            for (uint32_t i = 0; i < m_picParams.NumROI; i++)
+            {
+                RandomRect(m_picParams.ROI[i], streamInWidth, streamInHeight);
+                int32_t dqp = native ? (int32_t)(m_random() % 3) - 1 : (int32_t)(m_random() % 31) - 15;
+                m_picParams.ROI[i].PriorityLevelOrDQp = (char)(dqp ? dqp : 2);
+            }
+            m_encoder->ProcessRoiDeltaQp();
+        }
+        else
+        {
+            m_picParams.NumDirtyRects = (uint8_t)(1 + m_random() % m_maxDirtyRects);
+            for (uint32_t i = 0; i < m_picParams.NumDirtyRects; i++)
+            {
+                RandomRect(m_dirtyRects[i], streamInWidth, streamInHeight);
+            }
+        }
+    }
+
+    void CheckBuffer(uint8_t bufIdx, const std::vector<uint8_t> &expected)
+    {
+        ASSERT_EQ(memcmp(m_streamIn[bufIdx].pData, expected.data(), expected.size()), 0)
+            << "Buffer " << (uint32_t)bufIdx << ", " << m_encoder->m_frameWidth << "x" << m_encoder->m_frameHeight;
+    }
+
+    static constexpr uint32_t   m_maxDirtyRects = 8;
+
+    MediaUltOsInterface                 *m_osInterface = nullptr;
+    CodechalVdencHevcStateG10           *m_encoder     = nullptr;
+    CODEC_HEVC_ENCODE_PICTURE_PARAMS    m_picParams;
+    CODEC_HEVC_ENCODE_SEQUENCE_PARAMS   m_seqParams;
+    CODEC_HEVC_ENCODE_SLICE_PARAMS      m_sliceParams;
+    CODEC_ROI                           m_dirtyRects[m_maxDirtyRects] = {};
+    MOS_RESOURCE                        m_streamIn[CODECHAL_ENCODE_RECYCLED_BUFFER_NUM];
+    std::mt19937                        m_random{0x48455643};
+};
+
+//!
+//! \brief    Random ROI and dirty rectangle frames over the recycled buffers
+//! \details  Frames switch between ROI and dirty rectangles, native ROI and forced QP,
+//!           target usages and resolutions, so the buffers are rewritten from maps built
+//!           for other content. Each buffer must match a buffer written from scratch.
+//!
+TEST_F(CodechalVdencHevcStreamInTest, MatchesPerCuWrite)
+{
+    static const uint32_t resolutions[][2] = {
+        {1920, 1080}, {1280, 720}, {352, 288}, {4096, 2176}, {200, 72}};
+
+    std::vector<uint8_t> expected;
+    uint32_t             resolution = 0;
+
+    for (uint32_t frame = 0; frame < 600; frame++)
+    {
+        if (frame % 97 == 0)
+        {
+            resolution = m_random() % (sizeof(resolutions) / sizeof(resolutions[0]));
+        }
+        m_encoder->m_frameWidth  = resolutions[resolution][0];
+        m_encoder->m_frameHeight = resolutions[resolution][1];
+        m_encoder->m_currRecycledBufIdx = (uint8_t)(frame % CODECHAL_ENCODE_RECYCLED_BUFFER_NUM);
+
+        bool roi = (m_random() % 3) != 0;
+        RandomFrameParams(roi);
+
+        if (roi)
+        {
+            ASSERT_EQ(m_encoder->SetupROIStreamIn(&m_streamIn[m_encoder->m_currRecycledBufIdx]), MOS_STATUS_SUCCESS);
+            ReferenceRoiStreamIn(expected);
+        }
+        else
+        {
+            ASSERT_EQ(m_encoder->SetupDirtyRectStreamIn(&m_streamIn[m_encoder->m_currRecycledBufIdx]), MOS_STATUS_SUCCESS);
+            ReferenceDirtyRectStreamIn(expected);
+        }
+        CheckBuffer(m_encoder->m_currRecycledBufIdx, expected);
+    }
+}
+
+//!
+//! \brief    A buffer whose content does not change is not locked
+//!
+TEST_F(CodechalVdencHevcStreamInTest, UnchangedFrameSkipsWrite)
+{
+    std::vector<uint8_t> expected;
+
+    m_encoder->m_frameWidth  = 1920;
+    m_encoder->m_frameHeight = 1080;
+
+    for (uint32_t frame = 0; frame < 60; frame++)
+    {
+        uint8_t bufIdx = (uint8_t)(frame % CODECHAL_ENCODE_RECYCLED_BUFFER_NUM);
+        bool    roi    = (frame / CODECHAL_ENCODE_RECYCLED_BUFFER_NUM) % 2 == 0;
+
+        m_encoder->m_currRecycledBufIdx = bufIdx;
+        RandomFrameParams(roi);
+
+        for (uint32_t repeat = 0; repeat < 2; repeat++)
+        {
+            uint32_t lockCount = m_osInterface->m_lockCount;
+
+            if (roi)
+            {
+                ASSERT_EQ(m_encoder->SetupROIStreamIn(&m_streamIn[bufIdx]), MOS_STATUS_SUCCESS);
+                ReferenceRoiStreamIn(expected);
+            }
+            else
+            {
+                ASSERT_EQ(m_encoder->SetupDirtyRectStreamIn(&m_streamIn[bufIdx]), MOS_STATUS_SUCCESS);
+                ReferenceDirtyRectStreamIn(expected);
+            }
+            CheckBuffer(bufIdx, expected);
+
+            if (repeat)
+            {
+                EXPECT_EQ(m_osInterface->m_lockCount, lockCount);
+            }
+        }
+    }
+}
+
+#endif // _HEVC_ENCODE_SUPPORTED && IGFX_GEN10_SUPPORTED
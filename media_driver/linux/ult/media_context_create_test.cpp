@@ -0,0 +1,124 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_context_create_test.cpp
+//! \brief    Create/destroy benchmark of the device independent part of vaCreateContext
+//! \details  Builds and destroys the HAL objects a context creation builds before any
+//!           GPU allocation: the MHW and CodecHal HW interfaces with the encoder, and
+//!           the VPHAL state with its RenderHal. The user feature reads they do go
+//!           through the file written by the test environment.
+//!
+
+#include <stdio.h>
+#include <chrono>
+#include "gtest/gtest.h"
+#include "media_ult_os_interface.h"
+
+#ifdef IGFX_GEN9_SUPPORTED
+
+#include "vphal_g9.h"
+#ifdef _MPEG2_ENCODE_SUPPORTED
+#include "codechal_encode_mpeg2_g9.h"
+#endif
+
+class MediaContextCreateTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_osInterface = new MediaUltOsInterface(IGFX_SKYLAKE, IGFX_GEN9_CORE);
+        m_osInterface->osCpInterface = MOS_New(MosCpInterface, m_osInterface);
+        ASSERT_NE(m_osInterface->osCpInterface, nullptr);
+    }
+
+    void TearDown() override
+    {
+        MOS_Delete(m_osInterface->osCpInterface);
+        delete m_osInterface;
+    }
+
+    //!
+    //! \brief    Time a create/destroy loop
+    //! \return   double
+    //!           Microseconds per context
+    //!
+    template <typename CreateDestroy>
+    static double UsPerContext(uint32_t numContexts, CreateDestroy createDestroy)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < numContexts; i++)
+        {
+            createDestroy();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / numContexts;
+    }
+
+    static const uint32_t m_numContexts = 2000;
+
+    MediaUltOsInterface *m_osInterface = nullptr;
+};
+
+#ifdef _MPEG2_ENCODE_SUPPORTED
+TEST_F(MediaContextCreateTest, EncodeCreateDestroyBenchmark)
+{
+    CODECHAL_STANDARD_INFO standardInfo;
+    MOS_ZeroMemory(&standardInfo, sizeof(standardInfo));
+    standardInfo.CodecFunction = CODECHAL_FUNCTION_ENC_PAK;
+    standardInfo.Mode          = CODECHAL_ENCODE_MODE_MPEG2;
+
+    bool created = true;
+    double usPerContext = UsPerContext(m_numContexts, [&]() {
+        // The encoder owns the HW interface and deletes it
+        CodechalHwInterface *hwInterface = m_osInterface->CreateCodechalHwInterface(CODECHAL_FUNCTION_ENC_PAK);
+        CodechalEncodeMpeg2G9 *encoder  = hwInterface ?
+            MOS_New(CodechalEncodeMpeg2G9, hwInterface, m_osInterface->CreateDebugInterface(), &standardInfo) : nullptr;
+        created = created && encoder != nullptr;
+        if (encoder == nullptr)
+        {
+            MOS_Delete(hwInterface);
+        }
+        MOS_Delete(encoder);
+    });
+    ASSERT_TRUE(created);
+
+    RecordProperty("EncodeUsPerContext", (int)(usPerContext + 0.5));
+    printf("MPEG-2 encode: %.1f us per context create/destroy\n", usPerContext);
+}
+#endif
+
+TEST_F(MediaContextCreateTest, VpCreateDestroyBenchmark)
+{
+    bool created = true;
+    double usPerContext = UsPerContext(m_numContexts, [&]() {
+        MOS_STATUS eStatus = MOS_STATUS_UNKNOWN;
+        VphalState *vpHal  = MOS_New(VphalStateG9, m_osInterface, nullptr, &eStatus);
+        created = created && vpHal != nullptr && eStatus == MOS_STATUS_SUCCESS;
+        MOS_Delete(vpHal);
+    });
+    ASSERT_TRUE(created);
+
+    RecordProperty("VpUsPerContext", (int)(usPerContext + 0.5));
+    printf("VP: %.1f us per context create/destroy\n", usPerContext);
+}
+
+#endif // IGFX_GEN9_SUPPORTED
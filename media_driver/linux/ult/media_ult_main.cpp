@@ -0,0 +1,75 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_ult_main.cpp
+//! \brief    Entry point of the media driver unit tests
+//! \details  The user feature file the driver objects read is redirected to the build
+//!           directory. It is written before the MOS utilities start, with the keys
+//!           the tests depend on.
+//!
+
+#include <stdio.h>
+#include "gtest/gtest.h"
+#include "mos_utilities.h"
+#include "mos_utilities_specific.h"
+
+class MediaUltEnvironment : public testing::Environment
+{
+public:
+    void SetUp() override
+    {
+        FILE *file = fopen(USER_FEATURE_FILE, "w");
+        ASSERT_NE(file, nullptr) << "Cannot write " << USER_FEATURE_FILE;
+
+        // Same layout as the file the driver writes back
+        fprintf(file, "%s\n", UF_KEY_ID);
+        fprintf(file, "\t0x%.8x\n", UFKEY_INTERNAL);
+        fprintf(file, "\t%s%s\n", USER_FEATURE_KEY_INTERNAL, __MEDIA_USER_FEATURE_SUBKEY_INTERNAL);
+        WriteValue(file, "Media Async Dump Enable", 1);
+        WriteValue(file, "Media Async Dump Compression", 1);
+        fclose(file);
+
+        // Status only reflects the optional user feature XML export, the DDI ignores it too
+        MOS_utilities_init();
+    }
+
+    void TearDown() override
+    {
+        MOS_utilities_close();
+    }
+
+private:
+    static void WriteValue(FILE *file, const char *name, uint32_t value)
+    {
+        fprintf(file, "\t\t%s\n", UF_VALUE_ID);
+        fprintf(file, "\t\t\t%s\n", name);
+        fprintf(file, "\t\t\t%d\n", UF_DWORD);
+        fprintf(file, "\t\t\t%u\n", value);
+    }
+};
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    testing::AddGlobalTestEnvironment(new MediaUltEnvironment);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,340 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_ult_os_interface.cpp
+//! \brief    OS interface emulation for the media driver unit tests
+//!
+
+#include "media_ult_os_interface.h"
+#include "media_interfaces_mhw.h"
+
+MediaUltOsInterface::MediaUltOsInterface(
+    PRODUCT_FAMILY productFamily,
+    GFXCORE_FAMILY renderCoreFamily)
+{
+    MOS_ZeroMemory(static_cast<MOS_INTERFACE *>(this), sizeof(MOS_INTERFACE));
+    MOS_ZeroMemory(&m_platform, sizeof(m_platform));
+    MOS_ZeroMemory(&m_gtSystemInfo, sizeof(m_gtSystemInfo));
+
+    m_platform.eProductFamily    = productFamily;
+    m_platform.eRenderCoreFamily = renderCoreFamily;
+
+    // GT2 like configuration
+    m_gtSystemInfo.EUCount               = 24;
+    m_gtSystemInfo.ThreadCount           = 24 * 7;
+    m_gtSystemInfo.SliceCount            = 1;
+    m_gtSystemInfo.SubSliceCount         = 3;
+    m_gtSystemInfo.MaxEuPerSubSlice      = 8;
+    m_gtSystemInfo.MaxSlicesSupported    = 1;
+    m_gtSystemInfo.MaxSubSlicesSupported = 3;
+    m_gtSystemInfo.L3BankCount           = 4;
+
+    // Patch lists leave the commands independent of the buffer addresses
+    bUsesPatchList      = true;
+    bUsesGfxAddress     = false;
+    bDeallocateOnExit   = false;
+
+    pfnGetPlatform                  = GetPlatform;
+    pfnGetSkuTable                  = GetSkuTable;
+    pfnGetWaTable                   = GetWaTable;
+    pfnGetGtSystemInfo              = GetGtSystemInfo;
+    pfnSetGpuContext                = SetGpuContext;
+    pfnGetGpuContext                = GetGpuContext;
+    pfnRegisterResource             = RegisterResource;
+    pfnGetResourceAllocationIndex   = GetResourceAllocationIndex;
+    pfnSetPatchEntry                = SetPatchEntry;
+    pfnGetCommandBuffer             = GetCommandBuffer;
+    pfnReturnCommandBuffer          = ReturnCommandBuffer;
+    pfnSubmitCommandBuffer          = SubmitCommandBuffer;
+    pfnCachePolicyGetMemoryObject   = CachePolicyGetMemoryObject;
+    pfnLockResource                 = LockResource;
+    pfnUnlockResource               = UnlockResource;
+    pfnIsLockCached                 = IsLockCached;
+    pfnFreeResource                 = FreeResource;
+    pfnDestroy                      = Destroy;
+}
+
+MediaUltOsInterface::~MediaUltOsInterface()
+{
+    for (uint32_t i = 0; i < MOS_GPU_CONTEXT_MAX; i++)
+    {
+        MOS_FreeMemory(m_gpuContexts[i].buffer);
+    }
+}
+
+MOS_STATUS MediaUltOsInterface::AllocateBuffer(PMOS_RESOURCE resource, uint32_t size)
+{
+    MOS_OS_CHK_NULL_RETURN(resource);
+
+    MOS_ZeroMemory(resource, sizeof(*resource));
+    resource->pData = (uint8_t *)MOS_AllocAndZeroMemory(size);
+    MOS_OS_CHK_NULL_RETURN(resource->pData);
+
+    resource->iSize   = size;
+    resource->iWidth  = size;
+    resource->iHeight = 1;
+    resource->iPitch  = size;
+    resource->Format  = Format_Buffer;
+
+    return MOS_STATUS_SUCCESS;
+}
+
+void MediaUltOsInterface::FreeBuffer(PMOS_RESOURCE resource)
+{
+    FreeResource(this, resource);
+}
+
+CodechalHwInterface *MediaUltOsInterface::CreateCodechalHwInterface(CODECHAL_FUNCTION codecFunction)
+{
+    MhwInterfaces::CreateParams params;
+    MOS_ZeroMemory(&params, sizeof(params));
+    params.Flags.m_render   = true;
+    params.Flags.m_vdboxAll = true;
+    params.m_heapMode       = (uint8_t)2;
+    params.m_isDecode       = CodecHalIsDecode(codecFunction);
+
+    MhwInterfaces *mhwInterfaces = MhwInterfaces::CreateFactory(params, this);
+    if (mhwInterfaces == nullptr)
+    {
+        return nullptr;
+    }
+
+    CodechalHwInterface *hwInterface = MOS_New(CodechalHwInterface, this, codecFunction, mhwInterfaces);
+    if (hwInterface == nullptr)
+    {
+        mhwInterfaces->Destroy();
+    }
+    MOS_Delete(mhwInterfaces);
+
+    return hwInterface;
+}
+
+CodechalDebugInterface *MediaUltOsInterface::CreateDebugInterface()
+{
+#if USE_CODECHAL_DEBUG_TOOL
+    return MOS_New(CodechalDebugInterface);
+#else
+    return nullptr;
+#endif
+}
+
+void MediaUltOsInterface::GetPlatform(PMOS_INTERFACE osInterface, PLATFORM *platform)
+{
+    *platform = static_cast<MediaUltOsInterface *>(osInterface)->m_platform;
+}
+
+MEDIA_FEATURE_TABLE *MediaUltOsInterface::GetSkuTable(PMOS_INTERFACE osInterface)
+{
+    return &static_cast<MediaUltOsInterface *>(osInterface)->m_skuTable;
+}
+
+MEDIA_WA_TABLE *MediaUltOsInterface::GetWaTable(PMOS_INTERFACE osInterface)
+{
+    return &static_cast<MediaUltOsInterface *>(osInterface)->m_waTable;
+}
+
+MEDIA_SYSTEM_INFO *MediaUltOsInterface::GetGtSystemInfo(PMOS_INTERFACE osInterface)
+{
+    return &static_cast<MediaUltOsInterface *>(osInterface)->m_gtSystemInfo;
+}
+
+MOS_STATUS MediaUltOsInterface::SetGpuContext(PMOS_INTERFACE osInterface, MOS_GPU_CONTEXT gpuContext)
+{
+    if (gpuContext >= MOS_GPU_CONTEXT_MAX)
+    {
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    osInterface->CurrentGpuContextOrdinal = gpuContext;
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_GPU_CONTEXT MediaUltOsInterface::GetGpuContext(PMOS_INTERFACE osInterface)
+{
+    // Render until a test selects another context
+    return osInterface->CurrentGpuContextOrdinal;
+}
+
+MOS_STATUS MediaUltOsInterface::RegisterResource(
+    PMOS_INTERFACE osInterface,
+    PMOS_RESOURCE  resource,
+    int32_t        write,
+    int32_t        setResourceSyncTag)
+{
+    MOS_UNUSED(write);
+    MOS_UNUSED(setResourceSyncTag);
+    MOS_OS_CHK_NULL_RETURN(resource);
+
+    MOS_GPU_CONTEXT  gpuContext = osInterface->CurrentGpuContextOrdinal;
+    GpuContextState &state      = static_cast<MediaUltOsInterface *>(osInterface)->m_gpuContexts[gpuContext];
+
+    // Same buffer, same allocation, like the bo lookup of the driver
+    uint32_t index;
+    for (index = 0; index < state.resources.size(); index++)
+    {
+        if (state.resources[index]->pData == resource->pData)
+        {
+            break;
+        }
+    }
+    if (index == state.resources.size())
+    {
+        state.resources.push_back(resource);
+    }
+
+    resource->iAllocationIndex[gpuContext] = index;
+    return MOS_STATUS_SUCCESS;
+}
+
+int32_t MediaUltOsInterface::GetResourceAllocationIndex(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource)
+{
+    return resource ? resource->iAllocationIndex[osInterface->CurrentGpuContextOrdinal] : MOS_INVALID_ALLOC_INDEX;
+}
+
+MOS_STATUS MediaUltOsInterface::SetPatchEntry(PMOS_INTERFACE osInterface, PMOS_PATCH_ENTRY_PARAMS params)
+{
+    MOS_OS_CHK_NULL_RETURN(params);
+
+    GpuContextState &state = static_cast<MediaUltOsInterface *>(osInterface)->m_gpuContexts[osInterface->CurrentGpuContextOrdinal];
+    if (params->uiAllocationIndex >= state.resources.size())
+    {
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    state.patches.push_back(*params);
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MediaUltOsInterface::GetCommandBuffer(PMOS_INTERFACE osInterface, PMOS_COMMAND_BUFFER cmdBuffer, uint32_t flags)
+{
+    MOS_UNUSED(flags);
+    MOS_OS_CHK_NULL_RETURN(cmdBuffer);
+
+    GpuContextState &state = static_cast<MediaUltOsInterface *>(osInterface)->m_gpuContexts[osInterface->CurrentGpuContextOrdinal];
+    if (state.buffer == nullptr)
+    {
+        state.buffer = (uint32_t *)MOS_AllocAndZeroMemory(m_commandBufferSize);
+        MOS_OS_CHK_NULL_RETURN(state.buffer);
+
+        MOS_ZeroMemory(&state.cmdBuffer, sizeof(state.cmdBuffer));
+        state.cmdBuffer.pCmdBase       = state.buffer;
+        state.cmdBuffer.pCmdPtr        = state.buffer;
+        state.cmdBuffer.iRemaining     = m_commandBufferSize;
+        state.cmdBuffer.bCachedMapping = true;
+    }
+
+    *cmdBuffer = state.cmdBuffer;
+    return MOS_STATUS_SUCCESS;
+}
+
+void MediaUltOsInterface::ReturnCommandBuffer(PMOS_INTERFACE osInterface, PMOS_COMMAND_BUFFER cmdBuffer, uint32_t flags)
+{
+    MOS_UNUSED(flags);
+
+    if (cmdBuffer)
+    {
+        static_cast<MediaUltOsInterface *>(osInterface)->m_gpuContexts[osInterface->CurrentGpuContextOrdinal].cmdBuffer = *cmdBuffer;
+    }
+}
+
+MOS_STATUS MediaUltOsInterface::SubmitCommandBuffer(PMOS_INTERFACE osInterface, PMOS_COMMAND_BUFFER cmdBuffer, int32_t nullRendering)
+{
+    MOS_UNUSED(nullRendering);
+    MOS_OS_CHK_NULL_RETURN(cmdBuffer);
+
+    MediaUltOsInterface *ultOsInterface = static_cast<MediaUltOsInterface *>(osInterface);
+    MOS_GPU_CONTEXT      gpuContext     = osInterface->CurrentGpuContextOrdinal;
+    GpuContextState     &state          = ultOsInterface->m_gpuContexts[gpuContext];
+
+    Submission submission;
+    submission.gpuContext = gpuContext;
+    submission.commands.assign(state.cmdBuffer.pCmdBase, state.cmdBuffer.pCmdBase + state.cmdBuffer.iOffset / sizeof(uint32_t));
+    submission.patches.swap(state.patches);
+    submission.resources.swap(state.resources);
+    ultOsInterface->m_submissions.push_back(submission);
+
+    for (PMOS_RESOURCE resource : submission.resources)
+    {
+        resource->iAllocationIndex[gpuContext] = MOS_INVALID_ALLOC_INDEX;
+    }
+
+    state.cmdBuffer.pCmdPtr    = state.cmdBuffer.pCmdBase;
+    state.cmdBuffer.iOffset    = 0;
+    state.cmdBuffer.iRemaining = m_commandBufferSize;
+    return MOS_STATUS_SUCCESS;
+}
+
+MEMORY_OBJECT_CONTROL_STATE MediaUltOsInterface::CachePolicyGetMemoryObject(MOS_HW_RESOURCE_DEF usage)
+{
+    MOS_UNUSED(usage);
+
+    MEMORY_OBJECT_CONTROL_STATE memoryObject;
+    MOS_ZeroMemory(&memoryObject, sizeof(memoryObject));
+    return memoryObject;
+}
+
+void *MediaUltOsInterface::LockResource(
+    PMOS_INTERFACE   osInterface,
+    PMOS_RESOURCE    resource,
+    PMOS_LOCK_PARAMS lockFlags)
+{
+    MOS_UNUSED(lockFlags);
+
+    if (resource == nullptr || resource->pData == nullptr)
+    {
+        return nullptr;
+    }
+
+    static_cast<MediaUltOsInterface *>(osInterface)->m_lockCount++;
+    return resource->pData;
+}
+
+MOS_STATUS MediaUltOsInterface::UnlockResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource)
+{
+    MOS_UNUSED(osInterface);
+    MOS_UNUSED(resource);
+    return MOS_STATUS_SUCCESS;
+}
+
+bool MediaUltOsInterface::IsLockCached(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource)
+{
+    MOS_UNUSED(osInterface);
+    MOS_UNUSED(resource);
+    return true;
+}
+
+void MediaUltOsInterface::FreeResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource)
+{
+    MOS_UNUSED(osInterface);
+
+    if (resource)
+    {
+        MOS_FreeMemory(resource->pData);
+        MOS_ZeroMemory(resource, sizeof(*resource));
+    }
+}
+
+void MediaUltOsInterface::Destroy(PMOS_INTERFACE osInterface, int32_t destroyVscVppDeviceTag)
+{
+    MOS_UNUSED(osInterface);
+    MOS_UNUSED(destroyVscVppDeviceTag);
+}
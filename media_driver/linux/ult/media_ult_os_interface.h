@@ -0,0 +1,174 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_ult_os_interface.h
+//! \brief    OS interface emulation for the media driver unit tests
+//! \details  Lets HAL code run on host memory, without a device. Buffers are plain
+//!           allocations that locks map directly, and the HAL interfaces are built
+//!           the way the codec device factory builds them. Command buffers are host
+//!           buffers per GPU context, submitting one stores its commands and patch
+//!           entries for the test to check.
+//!
+#ifndef __MEDIA_ULT_OS_INTERFACE_H__
+#define __MEDIA_ULT_OS_INTERFACE_H__
+
+#include "mos_os.h"
+#include "codechal_hw.h"
+#include "codechal_debug.h"
+#include <vector>
+
+//!
+//! \class    MediaUltOsInterface
+//! \brief    MOS interface of one emulated platform
+//!
+class MediaUltOsInterface : public MOS_INTERFACE
+{
+public:
+    //!
+    //! \brief    Constructor
+    //! \param    [in] productFamily
+    //!           Platform to emulate
+    //! \param    [in] renderCoreFamily
+    //!           Render core of the platform
+    //!
+    MediaUltOsInterface(PRODUCT_FAMILY productFamily, GFXCORE_FAMILY renderCoreFamily);
+
+    //!
+    //! \brief    Destructor
+    //!
+    ~MediaUltOsInterface();
+
+    //!
+    //! \brief    Allocate a host backed linear buffer
+    //! \param    [out] resource
+    //!           Resource whose locks return the buffer
+    //! \param    [in] size
+    //!           Size in bytes
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS AllocateBuffer(PMOS_RESOURCE resource, uint32_t size);
+
+    //!
+    //! \brief    Free a buffer allocated by AllocateBuffer
+    //! \param    [in] resource
+    //!           Resource to free
+    //! \return   void
+    //!
+    void FreeBuffer(PMOS_RESOURCE resource);
+
+    //!
+    //! \brief    Create the CodecHal HW interface of the platform
+    //! \details  Creates the render, MI and VDBOX interfaces like CodechalDevice::CreateFactory.
+    //!           The HW interface is owned by the codec it is given to.
+    //! \param    [in] codecFunction
+    //!           Codec function of the HW interface
+    //! \return   CodechalHwInterface *
+    //!           HW interface, nullptr if failed
+    //!
+    CodechalHwInterface *CreateCodechalHwInterface(CODECHAL_FUNCTION codecFunction);
+
+    //!
+    //! \brief    Create the debug interface to give a codec constructor
+    //! \details  The constructors require one when the debug tool is built in. It is not
+    //!           initialized, nothing is dumped.
+    //! \return   CodechalDebugInterface *
+    //!           Debug interface, nullptr without the debug tool
+    //!
+    CodechalDebugInterface *CreateDebugInterface();
+
+    //!
+    //! \brief    Command buffer given to pfnSubmitCommandBuffer
+    //!
+    struct Submission
+    {
+        MOS_GPU_CONTEXT                     gpuContext;
+        std::vector<uint32_t>               commands;
+        std::vector<MOS_PATCH_ENTRY_PARAMS> patches;    //!< Allocation indexes of the submission
+        std::vector<PMOS_RESOURCE>          resources;  //!< Allocation list of the submission
+    };
+
+    static const uint32_t m_commandBufferSize = 256 * 1024;
+
+    PLATFORM            m_platform;                 //!< Emulated platform
+    MEDIA_FEATURE_TABLE m_skuTable;                 //!< SKU table, empty unless a test sets features
+    MEDIA_WA_TABLE      m_waTable;                  //!< WA table, empty unless a test sets WAs
+    MEDIA_SYSTEM_INFO   m_gtSystemInfo;             //!< GT system info
+    uint32_t            m_lockCount = 0;            //!< Resource locks taken
+    std::vector<Submission> m_submissions;          //!< Command buffers submitted, cleared by the tests
+
+protected:
+    //!
+    //! \brief    Command buffer, allocation list and patch list of a GPU context
+    //!
+    struct GpuContextState
+    {
+        uint32_t                            *buffer = nullptr;
+        MOS_COMMAND_BUFFER                  cmdBuffer;
+        std::vector<PMOS_RESOURCE>          resources;
+        std::vector<MOS_PATCH_ENTRY_PARAMS> patches;
+    };
+
+    GpuContextState     m_gpuContexts[MOS_GPU_CONTEXT_MAX];
+
+    static void GetPlatform(PMOS_INTERFACE osInterface, PLATFORM *platform);
+
+    static MEDIA_FEATURE_TABLE *GetSkuTable(PMOS_INTERFACE osInterface);
+
+    static MEDIA_WA_TABLE *GetWaTable(PMOS_INTERFACE osInterface);
+
+    static MEDIA_SYSTEM_INFO *GetGtSystemInfo(PMOS_INTERFACE osInterface);
+
+    static MOS_STATUS SetGpuContext(PMOS_INTERFACE osInterface, MOS_GPU_CONTEXT gpuContext);
+
+    static MOS_GPU_CONTEXT GetGpuContext(PMOS_INTERFACE osInterface);
+
+    static MOS_STATUS RegisterResource(
+        PMOS_INTERFACE osInterface,
+        PMOS_RESOURCE  resource,
+        int32_t        write,
+        int32_t        setResourceSyncTag);
+
+    static int32_t GetResourceAllocationIndex(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource);
+
+    static MOS_STATUS SetPatchEntry(PMOS_INTERFACE osInterface, PMOS_PATCH_ENTRY_PARAMS params);
+
+    static MOS_STATUS GetCommandBuffer(PMOS_INTERFACE osInterface, PMOS_COMMAND_BUFFER cmdBuffer, uint32_t flags);
+
+    static void ReturnCommandBuffer(PMOS_INTERFACE osInterface, PMOS_COMMAND_BUFFER cmdBuffer, uint32_t flags);
+
+    static MOS_STATUS SubmitCommandBuffer(PMOS_INTERFACE osInterface, PMOS_COMMAND_BUFFER cmdBuffer, int32_t nullRendering);
+
+    static MEMORY_OBJECT_CONTROL_STATE CachePolicyGetMemoryObject(MOS_HW_RESOURCE_DEF usage);
+
+    static void *LockResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource, PMOS_LOCK_PARAMS lockFlags);
+
+    static MOS_STATUS UnlockResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource);
+
+    static bool IsLockCached(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource);
+
+    static void FreeResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource);
+
+    static void Destroy(PMOS_INTERFACE osInterface, int32_t destroyVscVppDeviceTag);
+};
+
+#endif // __MEDIA_ULT_OS_INTERFACE_H__
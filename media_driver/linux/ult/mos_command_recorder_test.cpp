@@ -0,0 +1,326 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_command_recorder_test.cpp
+//! \brief    Tests of the multi-threaded command recorder
+//! \details  Passes record MHW style commands referencing shared buffers. Whatever
+//!           the thread count, the submitted command buffers must match the ones
+//!           recorded on a single thread.
+//!
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_ult_os_interface.h"
+#include "mos_command_recorder.h"
+#include "mos_task_pool.h"
+#include "mhw_utilities.h"
+
+#define COMMAND_RECORDER_TEST_RESOURCES     6
+#define COMMAND_RECORDER_TEST_PASS_SIZE     (64 * 1024)
+
+//!
+//! \brief    Pass of the tests
+//!
+struct TestPass
+{
+    PMOS_RESOURCE   resources;
+    uint32_t        id;
+    uint32_t        numCommands;
+    uint32_t        setupWork;          //!< Iterations standing in for the parameter setup of a HAL pass
+    bool            fail;
+};
+
+//!
+//! \brief    Record one store per command, each referencing a shared buffer
+//! \details  Odd passes go through pfnGetCommandBuffer and pfnReturnCommandBuffer
+//!           like the HALs do, even ones use the buffer they are given.
+//!
+static MOS_STATUS RecordTestPass(void *context, PMOS_INTERFACE osInterface, PMOS_COMMAND_BUFFER cmdBuffer)
+{
+    TestPass            *pass = (TestPass *)context;
+    MOS_COMMAND_BUFFER  halCmdBuffer;
+    PMOS_COMMAND_BUFFER recordBuffer = cmdBuffer;
+
+    if (pass->id & 1)
+    {
+        MOS_OS_CHK_STATUS_RETURN(osInterface->pfnGetCommandBuffer(osInterface, &halCmdBuffer, 0));
+        recordBuffer = &halCmdBuffer;
+    }
+
+    for (uint32_t i = 0; i < pass->numCommands; i++)
+    {
+        uint32_t payload = pass->id * 0x9E3779B1 + i;
+        for (uint32_t j = 0; j < pass->setupWork; j++)
+        {
+            payload = payload * 1664525 + 1013904223;
+        }
+
+        uint32_t cmd[4] = {0x10000000 | (pass->id << 16) | i, 0, 0, payload};
+
+        MHW_RESOURCE_PARAMS params;
+        MOS_ZeroMemory(&params, sizeof(params));
+        params.presResource    = &pass->resources[(pass->id + i) % COMMAND_RECORDER_TEST_RESOURCES];
+        params.dwOffset        = i * sizeof(uint32_t);
+        params.pdwCmd          = &cmd[1];
+        params.dwLocationInCmd = 1;
+        params.bIsWritable     = (i & 1) != 0;
+        MOS_OS_CHK_STATUS_RETURN(Mhw_AddResourceToCmd_PatchList(osInterface, recordBuffer, &params));
+
+        MOS_OS_CHK_STATUS_RETURN(Mos_AddCommand(recordBuffer, cmd, sizeof(cmd)));
+    }
+
+    if (pass->id & 1)
+    {
+        osInterface->pfnReturnCommandBuffer(osInterface, &halCmdBuffer, 0);
+    }
+
+    return pass->fail ? MOS_STATUS_UNKNOWN : MOS_STATUS_SUCCESS;
+}
+
+class MosCommandRecorderTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_osInterface = new MediaUltOsInterface(IGFX_SKYLAKE, IGFX_GEN9_CORE);
+        for (uint32_t i = 0; i < COMMAND_RECORDER_TEST_RESOURCES; i++)
+        {
+            ASSERT_EQ(m_osInterface->AllocateBuffer(&m_resources[i], 4096), MOS_STATUS_SUCCESS);
+        }
+        m_recorder = MOS_New(MosCommandRecorder, m_osInterface);
+        ASSERT_NE(m_recorder, nullptr);
+    }
+
+    void TearDown() override
+    {
+        MOS_Delete(m_recorder);
+        for (uint32_t i = 0; i < COMMAND_RECORDER_TEST_RESOURCES; i++)
+        {
+            m_osInterface->FreeBuffer(&m_resources[i]);
+        }
+        delete m_osInterface;
+    }
+
+    void InitPasses(uint32_t numPasses, uint32_t numCommands, uint32_t setupWork)
+    {
+        m_passes.resize(numPasses);
+        for (uint32_t i = 0; i < numPasses; i++)
+        {
+            m_passes[i].resources   = m_resources;
+            m_passes[i].id          = i;
+            m_passes[i].numCommands = numCommands;
+            m_passes[i].setupWork   = setupWork;
+            m_passes[i].fail        = false;
+        }
+    }
+
+    //!
+    //! \brief    Add the passes, alternating render and video, each video pass after the previous pass
+    //!
+    void AddPasses()
+    {
+        for (uint32_t i = 0; i < m_passes.size(); i++)
+        {
+            uint32_t index = 0;
+            MOS_GPU_CONTEXT gpuContext = (i % 3 == 1) ? MOS_GPU_CONTEXT_VIDEO : MOS_GPU_CONTEXT_RENDER;
+            ASSERT_EQ(m_recorder->AddPass(gpuContext, RecordTestPass, &m_passes[i], COMMAND_RECORDER_TEST_PASS_SIZE, &index), MOS_STATUS_SUCCESS);
+            ASSERT_EQ(index, i);
+            if (gpuContext == MOS_GPU_CONTEXT_VIDEO)
+            {
+                ASSERT_EQ(m_recorder->AddDependency(i, i - 1), MOS_STATUS_SUCCESS);
+            }
+        }
+    }
+
+    //!
+    //! \brief    Check every patch entry points at the address of a store, with its resource
+    //!
+    void CheckPatches(const MediaUltOsInterface::Submission &submission)
+    {
+        for (const MOS_PATCH_ENTRY_PARAMS &patch : submission.patches)
+        {
+            ASSERT_EQ(patch.uiPatchOffset % sizeof(uint32_t), 0u);
+            uint32_t location = patch.uiPatchOffset / sizeof(uint32_t);
+            ASSERT_GE(location, 1u);
+            ASSERT_LT(location, submission.commands.size());
+
+            uint32_t header = submission.commands[location - 1];
+            uint32_t passId = (header >> 16) & 0xFFF;
+            uint32_t i      = header & 0xFFFF;
+            ASSERT_LT(patch.uiAllocationIndex, submission.resources.size());
+            EXPECT_EQ(submission.resources[patch.uiAllocationIndex]->pData,
+                      m_resources[(passId + i) % COMMAND_RECORDER_TEST_RESOURCES].pData);
+            EXPECT_EQ(patch.uiResourceOffset, i * sizeof(uint32_t));
+            EXPECT_EQ(patch.bWrite, (i & 1) != 0);
+        }
+    }
+
+    static void ExpectSameSubmissions(
+        const std::vector<MediaUltOsInterface::Submission> &expected,
+        const std::vector<MediaUltOsInterface::Submission> &actual)
+    {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (uint32_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_EQ(actual[i].gpuContext, expected[i].gpuContext);
+            EXPECT_EQ(actual[i].commands, expected[i].commands);
+            EXPECT_EQ(actual[i].resources, expected[i].resources);
+            ASSERT_EQ(actual[i].patches.size(), expected[i].patches.size());
+            for (uint32_t j = 0; j < expected[i].patches.size(); j++)
+            {
+                EXPECT_EQ(actual[i].patches[j].uiAllocationIndex, expected[i].patches[j].uiAllocationIndex);
+                EXPECT_EQ(actual[i].patches[j].uiResourceOffset, expected[i].patches[j].uiResourceOffset);
+                EXPECT_EQ(actual[i].patches[j].uiPatchOffset, expected[i].patches[j].uiPatchOffset);
+                EXPECT_EQ(actual[i].patches[j].bWrite, expected[i].patches[j].bWrite);
+            }
+        }
+    }
+
+    MediaUltOsInterface     *m_osInterface = nullptr;
+    MosCommandRecorder      *m_recorder = nullptr;
+    MOS_RESOURCE            m_resources[COMMAND_RECORDER_TEST_RESOURCES];
+    std::vector<TestPass>   m_passes;
+};
+
+TEST_F(MosCommandRecorderTest, SubmissionIndependentOfThreadCount)
+{
+    InitPasses(9, 50, 0);
+
+    AddPasses();
+    ASSERT_EQ(m_recorder->Execute(1, false), MOS_STATUS_SUCCESS);
+    std::vector<MediaUltOsInterface::Submission> expected;
+    expected.swap(m_osInterface->m_submissions);
+
+    // Render 0, video 1, render 2 3, video 4, render 5 6, video 7, render 8
+    ASSERT_EQ(expected.size(), 7u);
+    for (uint32_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_EQ(expected[i].gpuContext, (i & 1) ? MOS_GPU_CONTEXT_VIDEO : MOS_GPU_CONTEXT_RENDER);
+        CheckPatches(expected[i]);
+    }
+    EXPECT_EQ(expected[2].commands.size(), 2 * 50 * 4u);
+    EXPECT_EQ(expected[2].commands[50 * 4], 0x10000000u | (3 << 16));
+
+    for (uint32_t threads = 2; threads <= MOS_TASK_POOL_MAX_THREADS; threads++)
+    {
+        AddPasses();
+        ASSERT_EQ(m_recorder->Execute(threads, false), MOS_STATUS_SUCCESS);
+        ExpectSameSubmissions(expected, m_osInterface->m_submissions);
+        m_osInterface->m_submissions.clear();
+    }
+}
+
+TEST_F(MosCommandRecorderTest, DependencyOrder)
+{
+    InitPasses(4, 2, 0);
+
+    uint32_t index;
+    ASSERT_EQ(m_recorder->AddPass(MOS_GPU_CONTEXT_RENDER, RecordTestPass, &m_passes[0], 1024, &index), MOS_STATUS_SUCCESS);
+    ASSERT_EQ(m_recorder->AddPass(MOS_GPU_CONTEXT_RENDER, RecordTestPass, &m_passes[1], 1024, &index), MOS_STATUS_SUCCESS);
+    ASSERT_EQ(m_recorder->AddPass(MOS_GPU_CONTEXT_VIDEO, RecordTestPass, &m_passes[2], 1024, &index), MOS_STATUS_SUCCESS);
+    ASSERT_EQ(m_recorder->AddPass(MOS_GPU_CONTEXT_RENDER, RecordTestPass, &m_passes[3], 1024, &index), MOS_STATUS_SUCCESS);
+    ASSERT_EQ(m_recorder->AddDependency(0, 3), MOS_STATUS_SUCCESS);
+    ASSERT_EQ(m_recorder->AddDependency(1, 2), MOS_STATUS_SUCCESS);
+    EXPECT_EQ(m_recorder->AddDependency(1, 1), MOS_STATUS_INVALID_PARAMETER);
+    EXPECT_EQ(m_recorder->AddDependency(1, 4), MOS_STATUS_INVALID_PARAMETER);
+
+    // 2 goes first and releases 1, which was added before 3, and 3 releases 0
+    ASSERT_EQ(m_recorder->Execute(MOS_TASK_POOL_MAX_THREADS, false), MOS_STATUS_SUCCESS);
+    EXPECT_EQ(m_recorder->GetPassCount(), 0u);
+
+    std::vector<MediaUltOsInterface::Submission> &submissions = m_osInterface->m_submissions;
+    ASSERT_EQ(submissions.size(), 2u);
+    EXPECT_EQ(submissions[0].gpuContext, MOS_GPU_CONTEXT_VIDEO);
+    EXPECT_EQ(submissions[1].gpuContext, MOS_GPU_CONTEXT_RENDER);
+    ASSERT_EQ(submissions[1].commands.size(), 3 * 2 * 4u);
+    EXPECT_EQ(submissions[1].commands[0], 0x10000000u | (1 << 16));
+    EXPECT_EQ(submissions[1].commands[8], 0x10000000u | (3 << 16));
+    EXPECT_EQ(submissions[1].commands[16], 0x10000000u | (0 << 16));
+    CheckPatches(submissions[0]);
+    CheckPatches(submissions[1]);
+}
+
+TEST_F(MosCommandRecorderTest, NothingSubmittedOnError)
+{
+    InitPasses(3, 4, 0);
+
+    uint32_t index;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(m_recorder->AddPass(MOS_GPU_CONTEXT_RENDER, RecordTestPass, &m_passes[i], 1024, &index), MOS_STATUS_SUCCESS);
+    }
+    ASSERT_EQ(m_recorder->AddDependency(0, 1), MOS_STATUS_SUCCESS);
+    ASSERT_EQ(m_recorder->AddDependency(1, 0), MOS_STATUS_SUCCESS);
+    EXPECT_EQ(m_recorder->Execute(MOS_TASK_POOL_MAX_THREADS, false), MOS_STATUS_INVALID_PARAMETER);
+    EXPECT_EQ(m_recorder->GetPassCount(), 0u);
+
+    m_passes[1].fail = true;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(m_recorder->AddPass(MOS_GPU_CONTEXT_RENDER, RecordTestPass, &m_passes[i], 1024, &index), MOS_STATUS_SUCCESS);
+    }
+    EXPECT_EQ(m_recorder->Execute(MOS_TASK_POOL_MAX_THREADS, false), MOS_STATUS_UNKNOWN);
+
+    // A pass larger than its buffer fails to record
+    m_passes[1].fail        = false;
+    m_passes[1].numCommands = 1024 / 16 + 1;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(m_recorder->AddPass(MOS_GPU_CONTEXT_RENDER, RecordTestPass, &m_passes[i], 1024, &index), MOS_STATUS_SUCCESS);
+    }
+    EXPECT_NE(m_recorder->Execute(MOS_TASK_POOL_MAX_THREADS, false), MOS_STATUS_SUCCESS);
+
+    EXPECT_TRUE(m_osInterface->m_submissions.empty());
+}
+
+TEST_F(MosCommandRecorderTest, RecordingThreadsBenchmark)
+{
+    const uint32_t numFrames   = 2000;
+    const uint32_t numPasses   = 8;
+    const uint32_t numCommands = 200;
+    const uint32_t setupWork   = 64;
+
+    InitPasses(numPasses, numCommands, setupWork);
+
+    uint32_t maxThreads = MOS_TaskPool_GetThreadCount();
+    std::vector<double> usPerFrame(maxThreads + 1, 0.0);
+    for (uint32_t threads = 1; threads <= maxThreads; threads++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < numFrames; frame++)
+        {
+            AddPasses();
+            ASSERT_EQ(m_recorder->Execute(threads, false), MOS_STATUS_SUCCESS);
+            m_osInterface->m_submissions.clear();
+        }
+        auto end = std::chrono::steady_clock::now();
+        usPerFrame[threads] = std::chrono::duration<double, std::micro>(end - start).count() / numFrames;
+
+        char name[32];
+        snprintf(name, sizeof(name), "UsPerFrame%uThreads", threads);
+        RecordProperty(name, (int)(usPerFrame[threads] + 0.5));
+        printf("%u passes of %u commands, %u recording threads: %.1f us per frame, %.2fx\n",
+            numPasses, numCommands, threads, usPerFrame[threads], usPerFrame[1] / usPerFrame[threads]);
+    }
+}
@@ -0,0 +1,300 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_dump_service_test.cpp
+//! \brief    Tests of the asynchronous dump service
+//!
+
+#include <stdio.h>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mos_utilities.h"
+#include "mos_dump_service.h"
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+
+//!
+//! \brief    Reference LZ4 frame decoder
+//! \details  Handles the frames the service writes: no checksums, independent
+//!           blocks, concatenated frames.
+//! \return   bool
+//!           true if the frame is well formed
+//!
+static bool DecodeLz4Frames(const std::vector<uint8_t> &in, std::vector<uint8_t> &out)
+{
+    size_t pos = 0;
+
+    auto readU32 = [&](uint32_t &value) {
+        if (pos + 4 > in.size())
+        {
+            return false;
+        }
+        value = in[pos] | (in[pos + 1] << 8) | (in[pos + 2] << 16) | ((uint32_t)in[pos + 3] << 24);
+        pos += 4;
+        return true;
+    };
+
+    while (pos < in.size())
+    {
+        uint32_t magic;
+        if (!readU32(magic) || magic != 0x184D2204 || pos + 3 > in.size())
+        {
+            return false;
+        }
+        // FLG: version 01, independent blocks, no checksums; BD: 64KB blocks
+        if (in[pos] != 0x60 || in[pos + 1] != 0x40)
+        {
+            return false;
+        }
+        pos += 3;
+
+        while (true)
+        {
+            uint32_t header;
+            if (!readU32(header))
+            {
+                return false;
+            }
+            if (header == 0)
+            {
+                break;
+            }
+
+            uint32_t size = header & 0x7FFFFFFF;
+            if (size > MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE || pos + size > in.size())
+            {
+                return false;
+            }
+
+            if (header & 0x80000000)
+            {
+                out.insert(out.end(), in.begin() + pos, in.begin() + pos + size);
+                pos += size;
+                continue;
+            }
+
+            size_t end        = pos + size;
+            size_t blockStart = out.size();
+            while (pos < end)
+            {
+                uint8_t  token  = in[pos++];
+                uint32_t length = token >> 4;
+                if (length == 15)
+                {
+                    uint8_t add;
+                    do
+                    {
+                        if (pos >= end)
+                        {
+                            return false;
+                        }
+                        add = in[pos++];
+                        length += add;
+                    } while (add == 255);
+                }
+                if (pos + length > end)
+                {
+                    return false;
+                }
+                out.insert(out.end(), in.begin() + pos, in.begin() + pos + length);
+                pos += length;
+
+                // The last sequence has literals only
+                if (pos == end)
+                {
+                    break;
+                }
+
+                if (pos + 2 > end)
+                {
+                    return false;
+                }
+                uint32_t offset = in[pos] | (in[pos + 1] << 8);
+                pos += 2;
+                if (offset == 0 || offset > out.size() - blockStart)
+                {
+                    return false;
+                }
+
+                uint32_t matchLength = token & 0xF;
+                if (matchLength == 15)
+                {
+                    uint8_t add;
+                    do
+                    {
+                        if (pos >= end)
+                        {
+                            return false;
+                        }
+                        add = in[pos++];
+                        matchLength += add;
+                    } while (add == 255);
+                }
+                matchLength += 4;
+
+                // Overlapping copies repeat the pattern
+                size_t from = out.size() - offset;
+                for (uint32_t i = 0; i < matchLength; i++)
+                {
+                    out.push_back(out[from + i]);
+                }
+            }
+            if (out.size() - blockStart > MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool ReadWholeFile(const std::string &name, std::vector<uint8_t> &data)
+{
+    FILE *file = fopen(name.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    uint8_t chunk[4096];
+    size_t  read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    fclose(file);
+    return true;
+}
+
+//!
+//! \brief    Dumps of mixed compressibility written and read back through LZ4
+//! \details  The environment enables compression. Sizes straddle the block size and
+//!           the write staging size, the content mixes runs, repeated patterns,
+//!           noise and long matches crossing block boundaries.
+//!
+TEST(MosDumpServiceTest, Lz4RoundTrip)
+{
+    std::mt19937                       random(0x6d6f7364);
+    std::vector<std::vector<uint8_t>>  dumps;
+    const uint32_t                     sizes[] = {
+        1, 13, 4096,
+        MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE - 1, MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE,
+        MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE + 1, 3 * MOS_DUMP_SERVICE_LZ4_BLOCK_SIZE + 777,
+        MOS_DUMP_SERVICE_WRITE_BUFFER_SIZE + 12345};
+
+    for (uint32_t size : sizes)
+    {
+        for (uint32_t kind = 0; kind < 4; kind++)
+        {
+            std::vector<uint8_t> data(size);
+            for (uint32_t i = 0; i < size; i++)
+            {
+                switch (kind)
+                {
+                case 0:     // noise, stored uncompressed
+                    data[i] = (uint8_t)random();
+                    break;
+                case 1:     // run
+                    data[i] = 0xA5;
+                    break;
+                case 2:     // short period, like surface rows
+                    data[i] = (uint8_t)(i % 37);
+                    break;
+                default:    // noise with repeated stretches
+                    data[i] = (i >= 1000 && (i / 500) % 3) ? data[i - 1000] : (uint8_t)random();
+                    break;
+                }
+            }
+            dumps.push_back(data);
+        }
+    }
+
+    for (size_t i = 0; i < dumps.size(); i++)
+    {
+        std::string name = "mos_dump_service_test_" + std::to_string(i) + ".bin";
+        ASSERT_EQ(MOS_DumpService_WriteFile(name.c_str(), dumps[i].data(), (uint32_t)dumps[i].size(), MOS_DUMP_FORMAT_BINARY),
+            MOS_STATUS_SUCCESS);
+    }
+    ASSERT_EQ(MOS_DumpService_Flush(), MOS_STATUS_SUCCESS);
+
+    MOS_DUMP_STATISTICS statistics;
+    ASSERT_EQ(MOS_DumpService_GetStatistics(&statistics), MOS_STATUS_SUCCESS);
+    EXPECT_EQ(statistics.uiDropped, 0u);
+    EXPECT_EQ(statistics.uiFailed, 0u);
+
+    for (size_t i = 0; i < dumps.size(); i++)
+    {
+        std::string          name = "mos_dump_service_test_" + std::to_string(i) + ".bin" MOS_DUMP_SERVICE_LZ4_EXTENSION;
+        std::vector<uint8_t> compressed;
+        std::vector<uint8_t> decoded;
+
+        ASSERT_TRUE(ReadWholeFile(name, compressed)) << name;
+        ASSERT_TRUE(DecodeLz4Frames(compressed, decoded)) << name;
+        EXPECT_TRUE(decoded == dumps[i]) << name;
+        remove(name.c_str());
+    }
+}
+
+//!
+//! \brief    Appended dumps are concatenated frames that decode to the whole stream
+//!
+TEST(MosDumpServiceTest, Lz4AppendedFrames)
+{
+    const char           *name = "mos_dump_service_test_append.bin";
+    std::vector<uint8_t> expected;
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        uint32_t dwords[300];
+        for (uint32_t j = 0; j < 300; j++)
+        {
+            dwords[j] = i * 1000 + (j & 7);
+        }
+
+        void *buffer = MOS_DumpService_AllocBuffer(sizeof(dwords));
+        ASSERT_NE(buffer, nullptr);
+        MOS_SecureMemcpy(buffer, sizeof(dwords), dwords, sizeof(dwords));
+        ASSERT_EQ(MOS_DumpService_Submit(name, buffer, sizeof(dwords), MOS_DUMP_FORMAT_BINARY, i > 0),
+            MOS_STATUS_SUCCESS);
+        expected.insert(expected.end(), (uint8_t *)dwords, (uint8_t *)dwords + sizeof(dwords));
+
+        // Closing the file between appends starts a new frame
+        if (i == 3)
+        {
+            ASSERT_EQ(MOS_DumpService_Flush(), MOS_STATUS_SUCCESS);
+        }
+    }
+    ASSERT_EQ(MOS_DumpService_Flush(), MOS_STATUS_SUCCESS);
+
+    std::vector<uint8_t> compressed;
+    std::vector<uint8_t> decoded;
+    std::string          file = std::string(name) + MOS_DUMP_SERVICE_LZ4_EXTENSION;
+
+    ASSERT_TRUE(ReadWholeFile(file, compressed));
+    ASSERT_TRUE(DecodeLz4Frames(compressed, decoded));
+    EXPECT_TRUE(decoded == expected);
+    remove(file.c_str());
+}
+
+#endif // _DEBUG || _RELEASE_INTERNAL
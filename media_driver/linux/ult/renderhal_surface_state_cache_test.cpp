@@ -0,0 +1,276 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     renderhal_surface_state_cache_test.cpp
+//! \brief    Tests of the encoded surface state cache of RenderHal
+//! \details  A composition binding trace is replayed through the cache and through
+//!           MHW directly. Both must produce the same surface states and patch locations.
+//!
+
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_ult_os_interface.h"
+#include "renderhal.h"
+
+#ifdef IGFX_GEN9_SUPPORTED
+
+#include "mhw_state_heap_g9.h"
+
+//!
+//! \brief    One layer of a composition frame
+//!
+struct CompositionLayer
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    bool     avs;
+};
+
+class RenderHalSurfaceStateCacheTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_osInterface = new MediaUltOsInterface(IGFX_SKYLAKE, IGFX_GEN9_CORE);
+
+        m_mhwStateHeap = MOS_New(MHW_STATE_HEAP_INTERFACE_G9_X, m_osInterface, false);
+        ASSERT_NE(m_mhwStateHeap, nullptr);
+
+        m_cache.assign(RENDERHAL_SSH_SURFACE_STATES, RENDERHAL_SURFACE_STATE_CACHE_ENTRY());
+        MOS_ZeroMemory(m_cache.data(), m_cache.size() * sizeof(RENDERHAL_SURFACE_STATE_CACHE_ENTRY));
+        MOS_ZeroMemory(&m_stateHeap, sizeof(m_stateHeap));
+        m_stateHeap.pSurfaceStateCache = m_cache.data();
+
+        MOS_ZeroMemory(&m_renderHal, sizeof(m_renderHal));
+        m_renderHal.pOsInterface                     = m_osInterface;
+        m_renderHal.pMhwStateHeap                    = m_mhwStateHeap;
+        m_renderHal.pHwSizes                         = m_mhwStateHeap->GetHwSizesPointer();
+        m_renderHal.pStateHeap                       = &m_stateHeap;
+        m_renderHal.StateHeapSettings.iSurfaceStates = RENDERHAL_SSH_SURFACE_STATES;
+
+        m_surfaceStateSize = m_renderHal.pHwSizes->dwSizeSurfaceState;
+        m_cachedSsh.assign(RENDERHAL_SSH_SURFACE_STATES * m_surfaceStateSize, 0);
+        m_directSsh.assign(RENDERHAL_SSH_SURFACE_STATES * m_surfaceStateSize, 0);
+    }
+
+    void TearDown() override
+    {
+        MOS_Delete(m_mhwStateHeap);
+        delete m_osInterface;
+    }
+
+    //!
+    //! \brief    Composition frame: an AVS scaled primary, sampled sub layers, the target
+    //!
+    void RandomFrame(std::vector<CompositionLayer> &layers)
+    {
+        static const uint32_t sizes[][2] = {{1920, 1080}, {1280, 720}, {720, 480}, {640, 360}, {256, 64}};
+        static const uint32_t formats[]  = {MHW_GFX3DSTATE_SURFACEFORMAT_PLANAR_420_8,
+                                            MHW_GFX3DSTATE_SURFACEFORMAT_B8G8R8A8_UNORM,
+                                            MHW_GFX3DSTATE_SURFACEFORMAT_R8_UNORM};
+
+        uint32_t numLayers = 2 + m_random() % 6;
+        layers.resize(numLayers);
+        for (uint32_t i = 0; i < numLayers; i++)
+        {
+            uint32_t size    = m_random() % (sizeof(sizes) / sizeof(sizes[0]));
+            layers[i].width  = sizes[size][0];
+            layers[i].height = sizes[size][1];
+            layers[i].format = (i == numLayers - 1) ? MHW_GFX3DSTATE_SURFACEFORMAT_B8G8R8A8_UNORM : formats[m_random() % 3];
+            layers[i].avs    = (i == 0);
+        }
+    }
+
+    //!
+    //! \brief    Surface state params of a plane, filled the way the Gen9 RenderHal does
+    //!
+    static void LayerParams(const CompositionLayer &layer, uint32_t plane, MHW_SURFACE_STATE_PARAMS &params)
+    {
+        params.bUseAdvState          = layer.avs;
+        params.dwWidth               = plane ? layer.width / 2 : layer.width;
+        params.dwHeight              = plane ? layer.height / 2 : layer.height;
+        params.dwFormat              = plane ? MHW_GFX3DSTATE_SURFACEFORMAT_R8G8_UNORM : layer.format;
+        params.dwPitch               = MOS_ALIGN_CEIL(layer.width * 4, 128);
+        params.dwDepth               = 1;
+        params.SurfaceType3D         = GFX3DSTATE_SURFACETYPE_2D;
+        params.bTiledSurface         = true;
+        params.bTileWalk             = true;
+        params.dwCacheabilityControl = layer.avs ? 1 : 2;
+        params.bInterleaveChroma     = layer.avs && plane;
+        params.dwYOffsetForU         = plane ? 0 : layer.height;
+    }
+
+    //!
+    //! \brief    Bind every plane of the frame to consecutive slots, through the cache and MHW
+    //! \details  Only the command is compared, the tail of a slot past an AVS surface state
+    //!           is not read by HW and is left stale by MHW while the cache clears it.
+    //!
+    void BindFrame(const std::vector<CompositionLayer> &layers, uint32_t frameIdx)
+    {
+        int32_t slot = 0;
+        for (const CompositionLayer &layer : layers)
+        {
+            uint32_t numPlanes = (layer.format == MHW_GFX3DSTATE_SURFACEFORMAT_PLANAR_420_8) ? 2 : 1;
+            for (uint32_t plane = 0; plane < numPlanes; plane++, slot++)
+            {
+                MHW_SURFACE_STATE_PARAMS cached;
+                MHW_SURFACE_STATE_PARAMS direct;
+                MOS_ZeroMemory(&cached, sizeof(cached));
+                LayerParams(layer, plane, cached);
+                direct = cached;
+
+                cached.pSurfaceState = m_cachedSsh.data() + slot * m_surfaceStateSize;
+                direct.pSurfaceState = m_directSsh.data() + slot * m_surfaceStateSize;
+                ASSERT_EQ(RenderHal_SetSurfaceStateEntry(&m_renderHal, slot, &cached), MOS_STATUS_SUCCESS);
+                ASSERT_EQ(m_mhwStateHeap->SetSurfaceStateEntry(&direct), MOS_STATUS_SUCCESS);
+
+                uint32_t cmdSize = layer.avs ? mhw_state_heap_g9_X::MEDIA_SURFACE_STATE_CMD::byteSize :
+                                               mhw_state_heap_g9_X::RENDER_SURFACE_STATE_CMD::byteSize;
+                ASSERT_EQ(memcmp(cached.pSurfaceState, direct.pSurfaceState, cmdSize), 0)
+                    << "Frame " << frameIdx << " slot " << slot;
+                ASSERT_EQ((uint8_t *)cached.pdwCmd - cached.pSurfaceState, (uint8_t *)direct.pdwCmd - direct.pSurfaceState)
+                    << "Frame " << frameIdx << " slot " << slot;
+                ASSERT_EQ(cached.dwLocationInCmd, direct.dwLocationInCmd) << "Frame " << frameIdx << " slot " << slot;
+            }
+        }
+    }
+
+    MediaUltOsInterface                              *m_osInterface  = nullptr;
+    MHW_STATE_HEAP_INTERFACE_G9_X                    *m_mhwStateHeap = nullptr;
+    RENDERHAL_INTERFACE                              m_renderHal;
+    RENDERHAL_STATE_HEAP                             m_stateHeap;
+    std::vector<RENDERHAL_SURFACE_STATE_CACHE_ENTRY> m_cache;
+    std::vector<uint8_t>                             m_cachedSsh;
+    std::vector<uint8_t>                             m_directSsh;
+    uint32_t                                         m_surfaceStateSize = 0;
+    std::mt19937                                     m_random{0x53534348};
+};
+
+//!
+//! \brief    Random composition frames, repeated, resized and reordered
+//! \details  Most frames repeat a recent one, like playback where the layers only change
+//!           on a resize or when a layer is added or removed.
+//!
+TEST_F(RenderHalSurfaceStateCacheTest, MatchesDirectEncode)
+{
+    std::vector<std::vector<CompositionLayer>> recentFrames;
+
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        std::vector<CompositionLayer> layers;
+
+        if (!recentFrames.empty() && (m_random() % 8))
+        {
+            layers = recentFrames[m_random() % recentFrames.size()];
+            if ((m_random() % 8) == 0)
+            {
+                layers[m_random() % layers.size()].width &= ~0xff;
+            }
+        }
+        else
+        {
+            RandomFrame(layers);
+        }
+
+        BindFrame(layers, i);
+        if (HasFatalFailure())
+        {
+            return;
+        }
+
+        recentFrames.push_back(layers);
+        if (recentFrames.size() > 4)
+        {
+            recentFrames.erase(recentFrames.begin());
+        }
+    }
+
+    EXPECT_GT(m_stateHeap.dwSurfaceStateCacheHits, 0u);
+    EXPECT_GT(m_stateHeap.dwSurfaceStateCacheMisses, 0u);
+}
+
+//!
+//! \brief    Cost of a binding through the cache and MHW for a steady composition
+//! \details  Reports the hit rate and the time per binding, the cache must hit on
+//!           every frame after the first.
+//!
+TEST_F(RenderHalSurfaceStateCacheTest, SteadyCompositionBenchmark)
+{
+    const uint32_t numFrames = 100000;
+
+    std::vector<CompositionLayer> layers;
+    RandomFrame(layers);
+
+    uint32_t numBindings = 0;
+    for (const CompositionLayer &layer : layers)
+    {
+        numBindings += (layer.format == MHW_GFX3DSTATE_SURFACEFORMAT_PLANAR_420_8) ? 2 : 1;
+    }
+
+    double nsPerBinding[2];
+    for (uint32_t useCache = 0; useCache < 2; useCache++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < numFrames; frame++)
+        {
+            int32_t slot = 0;
+            for (const CompositionLayer &layer : layers)
+            {
+                uint32_t numPlanes = (layer.format == MHW_GFX3DSTATE_SURFACEFORMAT_PLANAR_420_8) ? 2 : 1;
+                for (uint32_t plane = 0; plane < numPlanes; plane++, slot++)
+                {
+                    MHW_SURFACE_STATE_PARAMS params;
+                    MOS_ZeroMemory(&params, sizeof(params));
+                    LayerParams(layer, plane, params);
+                    if (useCache)
+                    {
+                        params.pSurfaceState = m_cachedSsh.data() + slot * m_surfaceStateSize;
+                        RenderHal_SetSurfaceStateEntry(&m_renderHal, slot, &params);
+                    }
+                    else
+                    {
+                        params.pSurfaceState = m_directSsh.data() + slot * m_surfaceStateSize;
+                        m_mhwStateHeap->SetSurfaceStateEntry(&params);
+                    }
+                }
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        nsPerBinding[useCache] = std::chrono::duration<double, std::nano>(end - start).count() / ((double)numFrames * numBindings);
+    }
+
+    uint32_t hits   = m_stateHeap.dwSurfaceStateCacheHits;
+    uint32_t misses = m_stateHeap.dwSurfaceStateCacheMisses;
+    EXPECT_EQ(misses, numBindings);
+    EXPECT_EQ(hits, (numFrames - 1) * numBindings);
+
+    RecordProperty("EncodeNsPerBinding", (int)(nsPerBinding[0] + 0.5));
+    RecordProperty("CachedNsPerBinding", (int)(nsPerBinding[1] + 0.5));
+    printf("%u bindings per frame: MHW encode %.1f ns, cache %.1f ns per binding, hit rate %.2f%%\n",
+        numBindings, nsPerBinding[0], nsPerBinding[1], 100.0 * hits / (hits + misses));
+}
+
+#endif // IGFX_GEN9_SUPPORTED
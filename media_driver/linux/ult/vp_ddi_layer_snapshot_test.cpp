@@ -0,0 +1,397 @@
+/*
+* Copyright (c) 2017, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     vp_ddi_layer_snapshot_test.cpp
+//! \brief    Tests of the per layer filter snapshots of the VP DDI
+//! \details  The pipeline params of a composition are set like vaRenderPicture does it.
+//!           Layers whose filter buffers did not change must end up with the filter
+//!           params a full derivation produces, after VPHAL adjusted them in place.
+//!
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_ult_os_interface.h"
+#include "media_libva.h"
+#include "media_libva_vp.h"
+#include "media_libva_util.h"
+
+// Internal to the VP DDI, the tests drive them directly
+VAStatus DdiVp_SetProcPipelineParams(VADriverContextP, PDDI_VP_CONTEXT, VAProcPipelineParameterBuffer*);
+VAStatus DdiVp_DestroyVpHal(PDDI_VP_CONTEXT);
+
+#ifdef IGFX_GEN9_SUPPORTED
+
+#include "vphal_g9.h"
+
+//!
+//! \brief    Filter params derived for one layer
+//!
+struct LayerFilterParams
+{
+    bool                   bIEF;
+    VPHAL_DENOISE_PARAMS   denoise;
+    VPHAL_IEF_PARAMS       ief;
+    VPHAL_PROCAMP_PARAMS   procamp;
+    VPHAL_COLORPIPE_PARAMS colorPipe;
+};
+
+class VpDdiLayerSnapshotTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_osInterface = new MediaUltOsInterface(IGFX_SKYLAKE, IGFX_GEN9_CORE);
+        m_osInterface->osCpInterface = MOS_New(MosCpInterface, m_osInterface);
+        ASSERT_NE(m_osInterface->osCpInterface, nullptr);
+
+        m_mediaCtx = (PDDI_MEDIA_CONTEXT)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_CONTEXT));
+        ASSERT_NE(m_mediaCtx, nullptr);
+        m_mediaCtx->pSurfaceHeap = (DDI_MEDIA_HEAP *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_HEAP));
+        m_mediaCtx->pBufferHeap  = (DDI_MEDIA_HEAP *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_HEAP));
+        ASSERT_NE(m_mediaCtx->pSurfaceHeap, nullptr);
+        ASSERT_NE(m_mediaCtx->pBufferHeap, nullptr);
+        m_mediaCtx->pSurfaceHeap->uiHeapElementSize = sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT);
+        m_mediaCtx->pBufferHeap->uiHeapElementSize  = sizeof(DDI_MEDIA_BUFFER_HEAP_ELEMENT);
+
+        MOS_ZeroMemory(&m_vaDrvCtx, sizeof(m_vaDrvCtx));
+        m_vaDrvCtx.pDriverData = m_mediaCtx;
+
+        // Same state DdiVp_InitCtx leaves, on the emulated OS interface
+        MOS_STATUS eStatus = MOS_STATUS_UNKNOWN;
+        m_vpCtx = (PDDI_VP_CONTEXT)MOS_AllocAndZeroMemory(sizeof(DDI_VP_CONTEXT));
+        ASSERT_NE(m_vpCtx, nullptr);
+        m_vpCtx->pVpHal = MOS_New(VphalStateG9, m_osInterface, nullptr, &eStatus);
+        ASSERT_NE(m_vpCtx->pVpHal, nullptr);
+        ASSERT_EQ(eStatus, MOS_STATUS_SUCCESS);
+
+        PVPHAL_RENDER_PARAMS renderParams = (PVPHAL_RENDER_PARAMS)MOS_AllocAndZeroMemory(sizeof(VPHAL_RENDER_PARAMS));
+        ASSERT_NE(renderParams, nullptr);
+        m_vpCtx->pVpHalRenderParams = renderParams;
+        for (uint32_t i = 0; i < VPHAL_MAX_SOURCES; i++)
+        {
+            renderParams->pSrc[i] = (PVPHAL_SURFACE)MOS_AllocAndZeroMemory(sizeof(VPHAL_SURFACE));
+            ASSERT_NE(renderParams->pSrc[i], nullptr);
+        }
+        for (uint32_t i = 0; i < VPHAL_MAX_TARGETS; i++)
+        {
+            renderParams->pTarget[i] = (PVPHAL_SURFACE)MOS_AllocAndZeroMemory(sizeof(VPHAL_SURFACE));
+            ASSERT_NE(renderParams->pTarget[i], nullptr);
+        }
+        renderParams->pColorFillParams = (PVPHAL_COLORFILL_PARAMS)MOS_AllocAndZeroMemory(sizeof(VPHAL_COLORFILL_PARAMS));
+        ASSERT_NE(renderParams->pColorFillParams, nullptr);
+        renderParams->bDisableDemoMode = true;
+
+        // Render target as DdiVp_BeginPicture sets it
+        PVPHAL_SURFACE target = renderParams->pTarget[0];
+        target->Format        = Format_NV12;
+        target->SurfType      = SURF_OUT_RENDERTARGET;
+        target->rcSrc         = {0, 0, 1920, 1080};
+        target->rcDst         = {0, 0, 1920, 1080};
+        renderParams->uDstCount = 1;
+
+        ASSERT_NO_FATAL_FAILURE(CreateSurface(Media_Format_NV12, 1920, 1080, m_primarySurface));
+        ASSERT_NO_FATAL_FAILURE(CreateSurface(Media_Format_A8R8G8B8, 640, 360, m_subSurface));
+
+        // Primary: the full HSBC, sharpening and color pipe set. Sub layer: denoise only.
+        VAProcFilterParameterBuffer denoise = {};
+        denoise.type  = VAProcFilterNoiseReduction;
+        denoise.value = 32.0f;
+        ASSERT_NO_FATAL_FAILURE(CreateFilter(&denoise, sizeof(denoise), 1, m_denoiseFilter));
+
+        VAProcFilterParameterBuffer sharpening = {};
+        sharpening.type  = VAProcFilterSharpening;
+        sharpening.value = 44.0f;
+        ASSERT_NO_FATAL_FAILURE(CreateFilter(&sharpening, sizeof(sharpening), 1, m_sharpeningFilter));
+
+        VAProcFilterParameterBufferColorBalance colorBalance[5] = {};
+        VAProcColorBalanceType attribs[5] = {VAProcColorBalanceHue, VAProcColorBalanceSaturation, VAProcColorBalanceBrightness,
+                                             VAProcColorBalanceContrast, VAProcColorBalanceAutoContrast};
+        float values[5] = {10.0f, 1.5f, 5.0f, 1.2f, 0.0f};
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            colorBalance[i].type   = VAProcFilterColorBalance;
+            colorBalance[i].attrib = attribs[i];
+            colorBalance[i].value  = values[i];
+        }
+        ASSERT_NO_FATAL_FAILURE(CreateFilter(colorBalance, sizeof(colorBalance[0]), 5, m_colorBalanceFilter));
+
+        VAProcFilterParameterBuffer skinTone = {};
+        skinTone.type  = VAProcFilterSkinToneEnhancement;
+        skinTone.value = 6.0f;
+        ASSERT_NO_FATAL_FAILURE(CreateFilter(&skinTone, sizeof(skinTone), 1, m_skinToneFilter));
+
+        m_primaryFilters = {m_denoiseFilter, m_sharpeningFilter, m_colorBalanceFilter, m_skinToneFilter};
+        m_subFilters     = {m_denoiseFilter};
+    }
+
+    void TearDown() override
+    {
+        if (m_vpCtx)
+        {
+            DdiVp_DestroyVpHal(m_vpCtx);
+            MOS_FreeMemory(m_vpCtx);
+        }
+        if (m_mediaCtx)
+        {
+            for (PDDI_MEDIA_BUFFER buffer : m_buffers)
+            {
+                MOS_FreeMemory(buffer->pData);
+                MOS_FreeMemory(buffer);
+            }
+            for (PDDI_MEDIA_SURFACE surface : m_surfaces)
+            {
+                MOS_FreeMemory(surface);
+            }
+            DdiMediaUtil_DestroyHeap(m_mediaCtx->pSurfaceHeap);
+            DdiMediaUtil_DestroyHeap(m_mediaCtx->pBufferHeap);
+            MOS_FreeMemory(m_mediaCtx->pSurfaceHeap);
+            MOS_FreeMemory(m_mediaCtx->pBufferHeap);
+            MOS_FreeMemory(m_mediaCtx);
+        }
+        MOS_Delete(m_osInterface->osCpInterface);
+        delete m_osInterface;
+    }
+
+    void CreateSurface(DDI_MEDIA_FORMAT format, int32_t width, int32_t height, VASurfaceID &surfaceId)
+    {
+        PDDI_MEDIA_SURFACE surface = (PDDI_MEDIA_SURFACE)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_SURFACE));
+        ASSERT_NE(surface, nullptr);
+        m_surfaces.push_back(surface);
+        surface->format      = format;
+        surface->iWidth      = width;
+        surface->iHeight     = MOS_ALIGN_CEIL(height, 16);
+        surface->iRealHeight = height;
+        surface->iPitch      = MOS_ALIGN_CEIL(width * 4, 128);
+        surface->pMediaCtx   = m_mediaCtx;
+
+        PDDI_MEDIA_SURFACE_HEAP_ELEMENT element = DdiMediaUtil_AllocPMediaSurfaceFromHeap(m_mediaCtx->pSurfaceHeap);
+        ASSERT_NE(element, nullptr);
+        element->pSurface = surface;
+        surfaceId         = element->uiVaSurfaceID;
+    }
+
+    void CreateFilter(void *data, uint32_t size, uint32_t numElements, VABufferID &bufferId)
+    {
+        ASSERT_EQ(DdiVp_CreateBuffer(&m_vaDrvCtx, m_vpCtx, VAProcFilterParameterBufferType, size, numElements, data, &bufferId),
+            VA_STATUS_SUCCESS);
+        m_buffers.push_back(DdiMedia_GetBufferFromVABufferID(m_mediaCtx, bufferId));
+    }
+
+    //!
+    //! \brief    Set the layers of one frame, like vaBeginPicture and vaRenderPicture
+    //!
+    VAStatus RenderFrame()
+    {
+        VARectangle subRegion = {64, 64, 640, 360};
+        VAStatus    vaStatus;
+
+        m_vpCtx->pVpHalRenderParams->uSrcCount = 0;
+        m_vpCtx->iPriSurfs                     = 0;
+
+        VAProcPipelineParameterBuffer primary = {};
+        primary.surface                = m_primarySurface;
+        primary.surface_color_standard = VAProcColorStandardBT709;
+        primary.output_color_standard  = VAProcColorStandardBT709;
+        primary.filters                = m_primaryFilters.data();
+        primary.num_filters            = m_primaryFilters.size();
+        vaStatus = DdiVp_SetProcPipelineParams(&m_vaDrvCtx, m_vpCtx, &primary);
+        if (vaStatus != VA_STATUS_SUCCESS)
+        {
+            return vaStatus;
+        }
+
+        VAProcPipelineParameterBuffer sub = {};
+        sub.surface                = m_subSurface;
+        sub.surface_color_standard = VAProcColorStandardBT709;
+        sub.output_color_standard  = VAProcColorStandardBT709;
+        sub.output_region          = &subRegion;
+        sub.pipeline_flags         = VA_PROC_PIPELINE_FAST;
+        sub.filters                = m_subFilters.data();
+        sub.num_filters            = m_subFilters.size();
+        return DdiVp_SetProcPipelineParams(&m_vaDrvCtx, m_vpCtx, &sub);
+    }
+
+    //!
+    //! \brief    Adjust the layer params in place, like VphalRenderer::Render does for 4K or RGB
+    //!
+    void AdjustLikeVphal()
+    {
+        for (uint32_t i = 0; i < m_vpCtx->pVpHalRenderParams->uSrcCount; i++)
+        {
+            PVPHAL_SURFACE src = m_vpCtx->pVpHalRenderParams->pSrc[i];
+            src->bIEF = false;
+            if (src->pDenoiseParams)
+            {
+                src->pDenoiseParams->bEnableLuma   = false;
+                src->pDenoiseParams->bEnableChroma = false;
+            }
+            if (src->pIEFParams)
+            {
+                src->pIEFParams->bEnabled   = false;
+                src->pIEFParams->fIEFFactor = 0.0f;
+            }
+            if (src->pProcampParams)
+            {
+                src->pProcampParams->fContrast = 0.0f;
+            }
+            if (src->pColorPipeParams)
+            {
+                src->pColorPipeParams->bEnableSTE = false;
+            }
+        }
+    }
+
+    void GetLayerParams(uint32_t layer, LayerFilterParams &params)
+    {
+        PVPHAL_SURFACE src = m_vpCtx->pVpHalRenderParams->pSrc[layer];
+        MOS_ZeroMemory(&params, sizeof(params));
+        params.bIEF = src->bIEF;
+        if (src->pDenoiseParams)
+        {
+            params.denoise = *src->pDenoiseParams;
+        }
+        if (src->pIEFParams)
+        {
+            params.ief = *src->pIEFParams;
+        }
+        if (src->pProcampParams)
+        {
+            params.procamp = *src->pProcampParams;
+        }
+        if (src->pColorPipeParams)
+        {
+            params.colorPipe = *src->pColorPipeParams;
+        }
+    }
+
+    void ExpectLayerParams(uint32_t layer, const LayerFilterParams &expected, uint32_t frameIdx)
+    {
+        LayerFilterParams params;
+        GetLayerParams(layer, params);
+        EXPECT_EQ(params.bIEF, expected.bIEF) << "Frame " << frameIdx << " layer " << layer;
+        EXPECT_EQ(memcmp(&params.denoise, &expected.denoise, sizeof(params.denoise)), 0) << "Frame " << frameIdx << " layer " << layer;
+        EXPECT_EQ(memcmp(&params.ief, &expected.ief, sizeof(params.ief)), 0) << "Frame " << frameIdx << " layer " << layer;
+        EXPECT_EQ(memcmp(&params.procamp, &expected.procamp, sizeof(params.procamp)), 0) << "Frame " << frameIdx << " layer " << layer;
+        EXPECT_EQ(memcmp(&params.colorPipe, &expected.colorPipe, sizeof(params.colorPipe)), 0) << "Frame " << frameIdx << " layer " << layer;
+    }
+
+    float *DenoiseValue()
+    {
+        PDDI_MEDIA_BUFFER buffer = DdiMedia_GetBufferFromVABufferID(m_mediaCtx, m_denoiseFilter);
+        return &((VAProcFilterParameterBuffer *)(buffer->pData + buffer->uiOffset))->value;
+    }
+
+    MediaUltOsInterface            *m_osInterface = nullptr;
+    PDDI_MEDIA_CONTEXT              m_mediaCtx    = nullptr;
+    VADriverContext                 m_vaDrvCtx;
+    PDDI_VP_CONTEXT                 m_vpCtx       = nullptr;
+    VASurfaceID                     m_primarySurface;
+    VASurfaceID                     m_subSurface;
+    VABufferID                      m_denoiseFilter;
+    VABufferID                      m_sharpeningFilter;
+    VABufferID                      m_colorBalanceFilter;
+    VABufferID                      m_skinToneFilter;
+    std::vector<VABufferID>         m_primaryFilters;
+    std::vector<VABufferID>         m_subFilters;
+    std::vector<PDDI_MEDIA_SURFACE> m_surfaces;
+    std::vector<PDDI_MEDIA_BUFFER>  m_buffers;
+};
+
+//!
+//! \brief    Unchanged layers get their derived params back, changed filters are derived again
+//!
+TEST_F(VpDdiLayerSnapshotTest, RestoresParamsVphalAdjusted)
+{
+    LayerFilterParams derived[2];
+
+    ASSERT_EQ(RenderFrame(), VA_STATUS_SUCCESS);
+    GetLayerParams(0, derived[0]);
+    GetLayerParams(1, derived[1]);
+    ASSERT_NE(m_vpCtx->pVpHalRenderParams->pSrc[0]->pColorPipeParams, nullptr);
+    EXPECT_TRUE(derived[0].bIEF);
+    EXPECT_TRUE(derived[0].colorPipe.bEnableSTE);
+    EXPECT_TRUE(derived[0].colorPipe.bEnableACE);
+    EXPECT_TRUE(derived[1].denoise.bEnableLuma);
+
+    for (uint32_t frame = 1; frame < 8; frame++)
+    {
+        AdjustLikeVphal();
+        ASSERT_EQ(RenderFrame(), VA_STATUS_SUCCESS);
+        ExpectLayerParams(0, derived[0], frame);
+        ExpectLayerParams(1, derived[1], frame);
+    }
+
+    // The denoise buffer is shared by both layers, both pick up the new value
+    *DenoiseValue() = 12.0f;
+    AdjustLikeVphal();
+    ASSERT_EQ(RenderFrame(), VA_STATUS_SUCCESS);
+    derived[0].denoise.fDenoiseFactor = 12.0f;
+    derived[1].denoise.fDenoiseFactor = 12.0f;
+    ExpectLayerParams(0, derived[0], 8);
+    ExpectLayerParams(1, derived[1], 8);
+
+    // Dropping a filter frees its params, as on every frame without snapshots
+    m_primaryFilters = {m_denoiseFilter, m_colorBalanceFilter, m_skinToneFilter};
+    AdjustLikeVphal();
+    ASSERT_EQ(RenderFrame(), VA_STATUS_SUCCESS);
+    EXPECT_EQ(m_vpCtx->pVpHalRenderParams->pSrc[0]->pIEFParams, nullptr);
+
+    // Out of range values are still rejected
+    *DenoiseValue() = 1000.0f;
+    EXPECT_EQ(RenderFrame(), VA_STATUS_ERROR_INVALID_PARAMETER);
+}
+
+//!
+//! \brief    Cost of setting the layers of a static composition, with and without snapshots
+//! \details  The filter buffers change every frame in the first run so that every layer
+//!           is derived, and stay the same in the second run.
+//!
+TEST_F(VpDdiLayerSnapshotTest, StaticPipelineBenchmark)
+{
+    const uint32_t numFrames = 100000;
+    double         nsPerFrame[2];
+
+    for (uint32_t staticFilters = 0; staticFilters < 2; staticFilters++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < numFrames; frame++)
+        {
+            if (!staticFilters)
+            {
+                *DenoiseValue() = (frame & 1) ? 32.0f : 33.0f;
+            }
+            ASSERT_EQ(RenderFrame(), VA_STATUS_SUCCESS);
+            AdjustLikeVphal();
+        }
+        auto end = std::chrono::steady_clock::now();
+        nsPerFrame[staticFilters] = std::chrono::duration<double, std::nano>(end - start).count() / numFrames;
+    }
+
+    RecordProperty("DerivedNsPerFrame", (int)(nsPerFrame[0] + 0.5));
+    RecordProperty("SnapshotNsPerFrame", (int)(nsPerFrame[1] + 0.5));
+    printf("2 layers, %zu filters: derived %.1f ns, from snapshots %.1f ns per frame\n",
+        m_primaryFilters.size() + m_subFilters.size(), nsPerFrame[0], nsPerFrame[1]);
+}
+
+#endif // IGFX_GEN9_SUPPORTED
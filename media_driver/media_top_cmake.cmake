@@ -84,3 +84,17 @@ endif(NOT DEFINED INCLUDED_LIBS OR "${INCLUDED_LIBS}" STREQUAL "")
 
 # post target attributes
 bs_set_post_target()
+
+# unit tests, "-DMEDIA_BUILD_ULT=ON" to build them and run with ctest
+if (MEDIA_BUILD_ULT)
+    # The driver library only exports its entry points, the tests link the driver objects
+    add_library(${LIB_NAME}_ult_objs OBJECT ${SOURCES_})
+    MediaAddCommonTargetDefines(${LIB_NAME}_ult_objs)
+    set(MEDIA_ULT_USER_FEATURE_FILE "${CMAKE_CURRENT_BINARY_DIR}/linux/ult/igfx_user_feature.txt")
+    set_property(TARGET ${LIB_NAME}_ult_objs APPEND PROPERTY COMPILE_DEFINITIONS
+        USER_FEATURE_FILE="${MEDIA_ULT_USER_FEATURE_FILE}"
+    )
+
+    enable_testing()
+    add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/linux/ult ${CMAKE_CURRENT_BINARY_DIR}/linux/ult)
+endif()